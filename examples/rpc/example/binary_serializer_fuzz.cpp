@@ -0,0 +1,162 @@
+#include <iostream>
+#include <cstdlib>
+#include <random>
+#include "../src/binary_serializer.h"
+
+/**
+ * @brief 二进制序列化器随机测试
+ *
+ * 1. 随机生成嵌套结构体并进行序列化/反序列化往返,校验结果一致
+ * 2. 对每个编码结果的所有截断前缀以及随机篡改的数据进行反序列化,
+ *    要求只能成功或抛出RpcException,不能越界访问
+ * 3. 校验定长布局的编译期大小
+ */
+
+namespace {
+
+using omnirt::rpc::BinaryArrayView;
+using omnirt::rpc::BinarySerializer;
+using omnirt::rpc::RpcException;
+
+struct Point {
+    double x;
+    double y;
+    int32_t id;
+};
+
+struct Tagged {
+    std::string name;
+    std::vector<Point> points;
+    std::optional<int64_t> stamp;
+    std::vector<std::string> labels;
+
+    OMNIRT_RPC_FIELDS(name, points, stamp, labels)
+};
+
+struct Packed {
+    int32_t a;
+    uint8_t b;
+    double c;
+
+    OMNIRT_RPC_FIELDS(a, b, c)
+};
+
+static_assert(BinarySerializer::is_fixed_layout<int, double, Point>(), "平凡类型应为定长布局");
+static_assert(BinarySerializer::fixed_size<int, double>() == sizeof(int) + sizeof(double), "定长大小错误");
+static_assert(BinarySerializer::fixed_size<Packed>() == 13, "声明字段的结构体应按字段紧凑编码");
+static_assert(!BinarySerializer::is_fixed_layout<int, std::string>(), "string不是定长布局");
+
+bool operator==(const Point& l, const Point& r) {
+    return l.x == r.x && l.y == r.y && l.id == r.id;
+}
+
+bool operator==(const Tagged& l, const Tagged& r) {
+    return l.name == r.name && l.points == r.points && l.stamp == r.stamp && l.labels == r.labels;
+}
+
+std::string RandomString(std::mt19937& rng) {
+    std::string s(rng() % 24, '\0');
+    for (auto& c : s) {
+        c = static_cast<char>(rng() % 256);
+    }
+    return s;
+}
+
+Tagged RandomTagged(std::mt19937& rng) {
+    Tagged t;
+    t.name = RandomString(rng);
+    t.points.resize(rng() % 8);
+    for (auto& p : t.points) {
+        p = Point{static_cast<double>(rng()), static_cast<double>(rng()) / 7.0, static_cast<int32_t>(rng())};
+    }
+    if (rng() % 2 != 0) {
+        t.stamp = static_cast<int64_t>(rng()) << 20;
+    }
+    t.labels.resize(rng() % 4);
+    for (auto& label : t.labels) {
+        label = RandomString(rng);
+    }
+    return t;
+}
+
+/**
+ * @brief 反序列化任意数据,只允许成功或抛出RpcException
+ */
+template<typename... Args>
+bool DeserializeIsSafe(const uint8_t* data, size_t size) {
+    BinarySerializer serializer;
+    try {
+        serializer.DeserializeAsTuple<Args...>(data, size);
+    } catch (const RpcException&) {
+    } catch (const std::exception& e) {
+        std::cerr << "非预期异常: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::mt19937 rng(12345);
+    BinarySerializer serializer;
+    int failures = 0;
+
+    for (int i = 0; i < iterations; ++i) {
+        const Tagged value = RandomTagged(rng);
+        const int64_t scalar = static_cast<int64_t>(rng());
+
+        // 往返校验
+        std::vector<uint8_t> data = serializer.Serialize(value, scalar);
+        if (data.size() != BinarySerializer::SerializedSize(value, scalar)) {
+            std::cerr << "序列化大小与SerializedSize不一致" << std::endl;
+            ++failures;
+        }
+        auto decoded = serializer.DeserializeAsTuple<Tagged, int64_t>(data);
+        if (!(std::get<0>(decoded) == value) || std::get<1>(decoded) != scalar) {
+            std::cerr << "往返结果不一致, 迭代 " << i << std::endl;
+            ++failures;
+        }
+
+        // 零拷贝视图校验
+        std::vector<uint8_t> view_data = serializer.Serialize(value.name, value.points);
+        auto views = serializer.DeserializeAsTuple<std::string_view, BinaryArrayView<Point>>(view_data.data(),
+                                                                                            view_data.size());
+        if (std::get<0>(views) != value.name || std::get<1>(views).ToVector() != value.points) {
+            std::cerr << "视图反序列化结果不一致, 迭代 " << i << std::endl;
+            ++failures;
+        }
+
+        // 截断前缀必须全部被拒绝
+        for (size_t len = 0; len < data.size(); ++len) {
+            try {
+                serializer.DeserializeAsTuple<Tagged, int64_t>(data.data(), len);
+                std::cerr << "截断数据未被拒绝, 长度 " << len << "/" << data.size() << std::endl;
+                ++failures;
+            } catch (const RpcException&) {
+            }
+        }
+
+        // 随机篡改后的数据不能导致越界
+        for (int j = 0; j < 8; ++j) {
+            std::vector<uint8_t> corrupted = data;
+            corrupted[rng() % corrupted.size()] = static_cast<uint8_t>(rng());
+            if (!DeserializeIsSafe<Tagged, int64_t>(corrupted.data(), corrupted.size())) {
+                ++failures;
+            }
+        }
+    }
+
+    // 缓冲区空间不足时必须抛出异常
+    uint8_t small[4];
+    try {
+        serializer.SerializeTo(small, sizeof(small), 1.0);
+        std::cerr << "缓冲区不足未被检测" << std::endl;
+        ++failures;
+    } catch (const RpcException&) {
+    }
+
+    std::cout << "迭代次数: " << iterations << ", 失败: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -77,10 +77,20 @@ void performanceTest(omnirt::rpc::Client& client, int iterations) {
     std::cout << "每秒调用次数: " << calls_per_second << std::endl;
 }
 
-int main() {
+int main(int argc, char *argv[]) {
     try {
+        // 可选参数指定传输方式(shm/uds)，需与服务端一致
+        omnirt::rpc::RpcConfig config;
+        if (argc > 1 && !omnirt::rpc::ParseTransportType(argv[1], &config.transport)) {
+            std::cerr << "用法: " << argv[0] << " [shm|uds]" << std::endl;
+            return 1;
+        }
+        // 服务端可能稍后启动，连接失败时重试
+        config.connect_retry_count = 50;
+        config.connect_retry_interval = std::chrono::milliseconds(100);
+        
         // 创建一个连接到指定通道的RPC客户端
-        omnirt::rpc::Client client("rpc_demo_channel");
+        omnirt::rpc::Client client("rpc_demo_channel", config);
         
         // 等待连接到服务端
         std::cout << "连接到RPC服务器..." << std::endl;
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include "../src/future.h"
+
+/**
+ * @brief RPC调用结果性能对比测试
+ *
+ * 模拟客户端"调用线程创建结果 -> 响应线程完成结果 -> 调用线程等待并读取"的流程,
+ * 对比基于互斥锁+条件变量的旧实现与基于单原子状态机+futex的新实现的每秒调用数。
+ */
+
+namespace {
+
+/**
+ * @brief 旧版RpcResult实现(互斥锁+条件变量),仅用于对比
+ */
+template<typename R>
+class LegacyRpcResult {
+public:
+    void SetResult(const R& result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result_ = result;
+        ready_ = true;
+        cv_.notify_all();
+    }
+
+    bool Wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return ready_; });
+        return true;
+    }
+
+    bool IsReady() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ready_;
+    }
+
+    bool HasError() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return ready_ && (error_ != omnirt::rpc::ErrorCode::SUCCESS);
+    }
+
+    R GetResult() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return result_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool ready_ = false;
+    R result_{};
+    omnirt::rpc::ErrorCode error_ = omnirt::rpc::ErrorCode::SUCCESS;
+};
+
+/**
+ * @brief 单槽位交接: 调用线程放入结果对象,完成线程取出并设置结果
+ */
+template<typename Result>
+double RunBenchmark(const char* name, int iterations,
+                    std::shared_ptr<Result> (*make)(), void (*complete)(Result*, int)) {
+    std::atomic<Result*> slot{nullptr};
+    std::atomic<bool> stop{false};
+
+    std::thread completer([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            Result* result = slot.exchange(nullptr, std::memory_order_acq_rel);
+            if (result != nullptr) {
+                complete(result, 1);
+            }
+        }
+    });
+
+    long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        auto result = make();
+        slot.store(result.get(), std::memory_order_release);
+        result->Wait();
+        if (!result->HasError() && result->IsReady()) {
+            sum += result->GetResult();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    stop.store(true);
+    completer.join();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double calls_per_second = iterations / seconds;
+    std::cout << name << ": " << static_cast<long>(calls_per_second) << " 次/秒"
+              << ", 平均 " << (seconds * 1e9 / iterations) << " 纳秒/次"
+              << (sum == iterations ? "" : " (结果校验失败)") << std::endl;
+    return calls_per_second;
+}
+
+std::shared_ptr<LegacyRpcResult<int>> MakeLegacy() {
+    return std::make_shared<LegacyRpcResult<int>>();
+}
+
+void CompleteLegacy(LegacyRpcResult<int>* result, int value) {
+    result->SetResult(value);
+}
+
+std::shared_ptr<omnirt::rpc::RpcResult<int>> MakeFuture() {
+    return omnirt::rpc::MakeRpcResult<int>();
+}
+
+void CompleteFuture(omnirt::rpc::RpcResult<int>* result, int value) {
+    result->SetResult(value);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    std::cout << "===== RPC调用结果性能对比 (" << iterations << " 次) =====" << std::endl;
+    double legacy = RunBenchmark("互斥锁+条件变量", iterations, &MakeLegacy, &CompleteLegacy);
+    double future = RunBenchmark("单原子状态机+futex", iterations, &MakeFuture, &CompleteFuture);
+    std::cout << "加速比: " << (future / legacy) << "x" << std::endl;
+    return 0;
+}
@@ -35,8 +35,15 @@ int calc(int a, int b, DATA_B data_b) {
 
 int main(int argc, char *argv[]) {
     try {
-        // 创建一个RPC服务器，使用默认配置
-        omnirt::rpc::Server srv("rpc_demo_channel");
+        // 可选参数指定传输方式(shm/uds/inproc)，默认使用共享内存
+        omnirt::rpc::RpcConfig config;
+        if (argc > 1 && !omnirt::rpc::ParseTransportType(argv[1], &config.transport)) {
+            std::cerr << "用法: " << argv[0] << " [shm|uds]" << std::endl;
+            return 1;
+        }
+        
+        // 创建一个RPC服务器
+        omnirt::rpc::Server srv("rpc_demo_channel", config);
         
         // 绑定一个普通函数到名称"foo"
         srv.Bind("foo", &foo);
@@ -53,7 +60,8 @@ int main(int argc, char *argv[]) {
         // 绑定带结构体参数的函数
         srv.Bind("calc", &calc);
         
-        std::cout << "RPC服务器已启动，使用高性能二进制序列化方式.." << std::endl;
+        std::cout << "RPC服务器已启动，传输方式: " << omnirt::rpc::TransportTypeName(config.transport)
+                  << "，使用高性能二进制序列化方式.." << std::endl;
         std::cout << "等待客户端连接..." << std::endl;
         
         // 运行服务器循环（阻塞）
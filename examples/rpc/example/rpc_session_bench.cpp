@@ -0,0 +1,135 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+#include "../src/client.h"
+#include "../src/server.h"
+
+/**
+ * @brief 多客户端会话扩展性测试
+ *
+ * 服务端运行在当前进程中，按1~32个客户端进程依次测试，
+ * 每个客户端进程连续进行同步调用，统计总吞吐量。
+ */
+
+namespace {
+
+const char* kChannelName = "rpc_session_bench";
+
+/**
+ * @brief 客户端进程主体
+ *
+ * @param start_fd 启动信号管道的读端
+ * @param iterations 调用次数
+ * @return int 进程退出码
+ */
+int RunClient(int start_fd, int iterations) {
+    // 客户端内部带有调试输出，测试时丢弃
+    if (std::freopen("/dev/null", "w", stdout) == nullptr) {
+        return 1;
+    }
+
+    try {
+        omnirt::rpc::RpcConfig config;
+        config.request_queue_size = 64;
+        config.response_queue_size = 64;
+        omnirt::rpc::Client client(kChannelName, config);
+
+        // 等待所有客户端就绪后同时开始
+        char start = 0;
+        if (read(start_fd, &start, 1) != 1) {
+            return 1;
+        }
+
+        for (int i = 0; i < iterations; i++) {
+            if (client.Call<int>("add", i, i) != i + i) {
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "客户端错误: " << e.what() << std::endl;
+        return 3;
+    }
+    return 0;
+}
+
+/**
+ * @brief 运行一轮测试
+ *
+ * @param num_clients 客户端进程数
+ * @param iterations 每个客户端的调用次数
+ * @return bool 所有客户端是否成功
+ */
+bool RunRound(int num_clients, int iterations) {
+    omnirt::rpc::Server srv(kChannelName);
+    std::function<int(int, int)> add_func = [](int a, int b) -> int { return a + b; };
+    srv.Bind("add", add_func);
+
+    int start_pipe[2];
+    if (pipe(start_pipe) != 0) {
+        return false;
+    }
+
+    // 在启动服务端线程之前fork，避免子进程继承其他线程持有的锁
+    std::vector<pid_t> children;
+    for (int i = 0; i < num_clients; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(start_pipe[1]);
+            _exit(RunClient(start_pipe[0], iterations));
+        }
+        children.push_back(pid);
+    }
+    close(start_pipe[0]);
+
+    srv.RunInBackground();
+
+    // 等待所有客户端完成注册
+    auto wait_start = std::chrono::steady_clock::now();
+    while (srv.SessionCount() < static_cast<size_t>(num_clients) &&
+           std::chrono::steady_clock::now() - wait_start < std::chrono::seconds(5)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<char> go(num_clients, 1);
+    if (write(start_pipe[1], go.data(), go.size()) != static_cast<ssize_t>(go.size())) {
+        return false;
+    }
+    close(start_pipe[1]);
+
+    bool ok = true;
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    srv.Stop();
+    srv.WaitForStop();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double total_calls = static_cast<double>(num_clients) * iterations;
+    std::cout << "客户端数: " << num_clients
+              << ", 总调用: " << static_cast<long>(total_calls)
+              << ", 耗时: " << seconds << " 秒"
+              << ", 吞吐量: " << static_cast<long>(total_calls / seconds) << " 次/秒"
+              << (ok ? "" : " (存在失败的客户端)") << std::endl;
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    std::cout << "===== 多客户端会话扩展性测试 =====" << std::endl;
+    bool ok = true;
+    for (int num_clients : {1, 2, 4, 8, 16, 32}) {
+        ok = RunRound(num_clients, iterations) && ok;
+    }
+    return ok ? 0 : 1;
+}
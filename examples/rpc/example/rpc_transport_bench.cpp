@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/client.h"
+#include "../src/server.h"
+
+/**
+ * @brief 传输方式对比测试
+ *
+ * 对共享内存、Unix域套接字和进程内队列三种传输使用相同的负载:
+ * 1. 单客户端同步调用，统计往返延迟分位数
+ * 2. 多客户端线程并发同步调用，统计总吞吐量
+ * 负载分为小消息(add两个整数)和大消息(回显指定大小的字符串)。
+ * 服务端与客户端运行在同一进程中，以便进程内传输参与对比。
+ */
+
+namespace {
+
+const char* kChannelName = "rpc_transport_bench";
+
+struct LatencyResult {
+    double p50_us = 0;
+    double p99_us = 0;
+    double avg_us = 0;
+};
+
+/**
+ * @brief 单客户端同步调用延迟测试
+ */
+bool MeasureLatency(const omnirt::rpc::RpcConfig& config, const std::string& payload, int iterations,
+                    LatencyResult* result) {
+    omnirt::rpc::Client client(kChannelName, config);
+    std::vector<double> samples;
+    samples.reserve(iterations);
+
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        if (payload.empty()) {
+            if (client.Call<int>("add", i, i) != i + i) {
+                return false;
+            }
+        } else if (client.Call<std::string>("echo", payload).size() != payload.size()) {
+            return false;
+        }
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result->p50_us = samples[samples.size() / 2];
+    result->p99_us = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+    result->avg_us = sum / samples.size();
+    return true;
+}
+
+/**
+ * @brief 多客户端线程吞吐量测试
+ *
+ * @return double 每秒调用次数，失败时返回0
+ */
+double MeasureThroughput(const omnirt::rpc::RpcConfig& config, const std::string& payload,
+                         int num_clients, int iterations) {
+    std::vector<std::unique_ptr<omnirt::rpc::Client>> clients;
+    for (int i = 0; i < num_clients; i++) {
+        clients.push_back(std::make_unique<omnirt::rpc::Client>(kChannelName, config));
+    }
+
+    std::atomic<bool> ok{true};
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& client : clients) {
+        threads.emplace_back([&ok, &payload, iterations, client = client.get()]() {
+            try {
+                for (int i = 0; i < iterations; i++) {
+                    if (payload.empty()) {
+                        if (client->Call<int>("add", i, i) != i + i) {
+                            ok = false;
+                        }
+                    } else if (client->Call<std::string>("echo", payload).size() != payload.size()) {
+                        ok = false;
+                    }
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "客户端错误: " << e.what() << std::endl;
+                ok = false;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return ok ? static_cast<double>(num_clients) * iterations / seconds : 0;
+}
+
+/**
+ * @brief 测试一种传输方式
+ */
+bool RunTransport(omnirt::rpc::TransportType transport, int iterations, int num_clients) {
+    omnirt::rpc::RpcConfig config;
+    config.transport = transport;
+    config.request_queue_size = 64;
+    config.response_queue_size = 64;
+
+    omnirt::rpc::Server srv(kChannelName, config);
+    std::function<int(int, int)> add_func = [](int a, int b) -> int { return a + b; };
+    std::function<std::string(std::string)> echo_func = [](std::string s) -> std::string { return s; };
+    srv.Bind("add", add_func);
+    srv.Bind("echo", echo_func);
+    srv.RunInBackground();
+
+    bool ok = true;
+    for (size_t payload_size : {size_t(0), size_t(1024), size_t(3072)}) {
+        const std::string payload(payload_size, 'x');
+
+        LatencyResult latency;
+        if (!MeasureLatency(config, payload, iterations, &latency)) {
+            ok = false;
+            continue;
+        }
+        const double throughput = MeasureThroughput(config, payload, num_clients, iterations);
+        ok = ok && throughput > 0;
+
+        std::cout << "传输: " << omnirt::rpc::TransportTypeName(transport)
+                  << ", 负载: " << (payload_size == 0 ? std::string("add(int,int)") : std::to_string(payload_size) + "B")
+                  << ", 延迟p50/p99/平均: " << latency.p50_us << "/" << latency.p99_us << "/" << latency.avg_us << " 微秒"
+                  << ", " << num_clients << "客户端吞吐量: " << static_cast<long>(throughput) << " 次/秒" << std::endl;
+    }
+
+    srv.Stop();
+    srv.WaitForStop();
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int num_clients = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    std::cout << "===== 传输方式对比测试 =====" << std::endl;
+    bool ok = true;
+    for (auto transport : {omnirt::rpc::TransportType::SHM, omnirt::rpc::TransportType::UDS,
+                           omnirt::rpc::TransportType::INPROC}) {
+        try {
+            ok = RunTransport(transport, iterations, num_clients) && ok;
+        } catch (const std::exception& e) {
+            std::cerr << TransportTypeName(transport) << "传输测试失败: " << e.what() << std::endl;
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
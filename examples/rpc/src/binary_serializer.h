@@ -2,84 +2,438 @@
 //
 // 二进制序列化器实现
 // 用于RPC通信的序列化和反序列化，使用二进制格式而非msgpack
+//
+// 特性:
+// 1. 零分配: 参数直接序列化到调用方提供的缓冲区(例如共享内存队列槽位)
+// 2. 编译期布局: 参数全部为平凡类型时,总大小在编译期计算,只做一次边界检查
+// 3. 可扩展类型: 内置支持std::string、std::vector、std::optional,
+//    结构体可通过OMNIRT_RPC_FIELDS声明字段,或特化BinaryCodec自定义编码
+// 4. 零拷贝反序列化: 所有读取都带边界检查,std::string_view和BinaryArrayView
+//    直接引用缓冲区中的数据
+//
+// 编码格式(小端,本机字节序):
+// - 平凡可复制类型: 原样内存拷贝
+// - std::string / std::string_view: uint32长度 + 字节
+// - std::vector<T> / BinaryArrayView<T>: uint32元素个数 + 元素
+// - std::optional<T>: uint8标志 + (T)
+// - 声明了字段的结构体: 按声明顺序依次编码各字段
 
 #pragma once
 
 #include "common.h"
 #include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
-#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 为结构体声明参与序列化的字段
+ *
+ * 示例:
+ * @code
+ *   struct Pose {
+ *       std::string frame;
+ *       std::vector<double> values;
+ *       OMNIRT_RPC_FIELDS(frame, values)
+ *   };
+ * @endcode
+ */
+#define OMNIRT_RPC_FIELDS(...)                                          \
+    auto RpcFields() { return std::tie(__VA_ARGS__); }                  \
+    auto RpcFields() const { return std::tie(__VA_ARGS__); }
 
 namespace omnirt {
 namespace rpc {
 
-// 定义辅助命名空间，用于C++11实现参数包展开和元组操作
+/**
+ * @brief 缓冲区中平凡类型数组的只读视图
+ *
+ * 缓冲区中的数据不保证按T对齐,因此元素按值读取(内部使用memcpy)。
+ *
+ * @tparam T 元素类型,必须是平凡可复制类型
+ */
+template<typename T>
+class BinaryArrayView {
+    static_assert(std::is_trivially_copyable<T>::value, "BinaryArrayView只支持平凡可复制类型");
+
+public:
+    BinaryArrayView() = default;
+    BinaryArrayView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const uint8_t* bytes() const { return data_; }
+
+    T operator[](size_t index) const {
+        T value;
+        std::memcpy(&value, data_ + index * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    std::vector<T> ToVector() const {
+        std::vector<T> result(size_);
+        if (size_ != 0) {
+            std::memcpy(result.data(), data_, size_ * sizeof(T));
+        }
+        return result;
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief 带边界检查的顺序写入器
+ */
+class BinaryWriter {
+public:
+    BinaryWriter(uint8_t* data, size_t capacity) : data_(data), capacity_(capacity) {}
+
+    void WriteBytes(const void* src, size_t size) {
+        if (size > capacity_ - offset_) {
+            throw RpcException("序列化错误：缓冲区空间不足", ErrorCode::SERIALIZATION_ERROR);
+        }
+        WriteBytesUnchecked(src, size);
+    }
+
+    /**
+     * @brief 不做边界检查的写入,仅用于已预先检查过总大小的定长布局
+     */
+    void WriteBytesUnchecked(const void* src, size_t size) {
+        if (size != 0) {
+            std::memcpy(data_ + offset_, src, size);
+            offset_ += size;
+        }
+    }
+
+    void WriteLength(size_t length) {
+        if (length > std::numeric_limits<uint32_t>::max()) {
+            throw RpcException("序列化错误：长度超出范围", ErrorCode::SERIALIZATION_ERROR);
+        }
+        const uint32_t value = static_cast<uint32_t>(length);
+        WriteBytes(&value, sizeof(value));
+    }
+
+    size_t Offset() const { return offset_; }
+
+private:
+    uint8_t* data_;
+    size_t capacity_;
+    size_t offset_ = 0;
+};
+
+/**
+ * @brief 带边界检查的顺序读取器
+ */
+class BinaryReader {
+public:
+    BinaryReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+    void ReadBytes(void* dst, size_t size) {
+        std::memcpy(dst, Consume(size), size);
+    }
+
+    /**
+     * @brief 消费指定字节数并返回其起始地址,用于构造视图
+     */
+    const uint8_t* Consume(size_t size) {
+        if (size > size_ - offset_) {
+            throw RpcException("反序列化错误：数据大小不足", ErrorCode::SERIALIZATION_ERROR);
+        }
+        const uint8_t* ptr = data_ + offset_;
+        offset_ += size;
+        return ptr;
+    }
+
+    /**
+     * @brief 读取元素个数,并校验剩余数据至少能容纳count * min_element_size字节
+     */
+    size_t ReadLength(size_t min_element_size) {
+        uint32_t length = 0;
+        ReadBytes(&length, sizeof(length));
+        if (min_element_size != 0 && length > (size_ - offset_) / min_element_size) {
+            throw RpcException("反序列化错误：长度字段超出数据范围", ErrorCode::SERIALIZATION_ERROR);
+        }
+        return length;
+    }
+
+    size_t Offset() const { return offset_; }
+    size_t Remaining() const { return size_ - offset_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+/**
+ * @brief 类型编码定制点
+ *
+ * 用户可以为自定义类型特化该模板,需提供:
+ * - static size_t Size(const T&)
+ * - static void Write(BinaryWriter&, const T&)
+ * - static void Read(BinaryReader&, T&)
+ */
+template<typename T, typename Enable = void>
+struct BinaryCodec {};
+
 namespace detail {
 
-// 检查所有类型是否可序列化
+template<typename T, typename = void>
+struct HasCustomCodec : std::false_type {};
+
+template<typename T>
+struct HasCustomCodec<T, std::void_t<decltype(BinaryCodec<T>::Write(std::declval<BinaryWriter&>(),
+                                                                     std::declval<const T&>()))>>
+    : std::true_type {};
+
+template<typename T, typename = void>
+struct HasRpcFields : std::false_type {};
+
+template<typename T>
+struct HasRpcFields<T, std::void_t<decltype(std::declval<const T&>().RpcFields())>> : std::true_type {};
+
+template<typename T>
+struct IsString : std::is_same<T, std::string> {};
+
+template<typename T>
+struct IsStringView : std::is_same<T, std::string_view> {};
 
 template<typename T>
-constexpr bool is_binary_serializable() {
-    return std::is_trivially_copyable<T>::value;
+struct IsVector : std::false_type {};
+
+template<typename T, typename A>
+struct IsVector<std::vector<T, A>> : std::true_type {};
+
+template<typename T>
+struct IsArrayView : std::false_type {};
+
+template<typename T>
+struct IsArrayView<BinaryArrayView<T>> : std::true_type {};
+
+template<typename T>
+struct IsOptional : std::false_type {};
+
+template<typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+/**
+ * @brief 是否按原始内存拷贝编码
+ *
+ * 视图类型虽然平凡可复制,但其内容指向外部缓冲区,需按变长类型编码。
+ */
+template<typename T>
+constexpr bool IsRawCopyable() {
+    return std::is_trivially_copyable<T>::value && !HasCustomCodec<T>::value && !HasRpcFields<T>::value &&
+           !IsStringView<T>::value && !IsArrayView<T>::value && !IsOptional<T>::value;
 }
 
-template<typename... Args>
-struct AllBinarySerializable;
+/**
+ * @brief 是否包含指向外部缓冲区的视图(反序列化结果的生命周期受缓冲区约束)
+ */
+template<typename T>
+constexpr bool IsViewType() {
+    return IsStringView<T>::value || IsArrayView<T>::value;
+}
 
-template<>
-struct AllBinarySerializable<> {
-    static constexpr bool value = true;
+template<typename T>
+struct FieldsTuple {
+    using type = std::decay_t<decltype(std::declval<const T&>().RpcFields())>;
 };
 
-template<typename T, typename... Rest>
-struct AllBinarySerializable<T, Rest...> {
-    static constexpr bool value = is_binary_serializable<T>() && AllBinarySerializable<Rest...>::value;
-};
+template<typename Tuple>
+struct TupleFixedLayout;
 
-// 计算多个类型的总大小
-template<typename... Args>
-struct SumSizes;
+template<typename T>
+constexpr bool IsFixedSize();
 
-template<>
-struct SumSizes<> {
-    static constexpr size_t value = 0;
-};
+template<typename T>
+constexpr size_t FixedSizeOf();
 
-template<typename T, typename... Rest>
-struct SumSizes<T, Rest...> {
-    static constexpr size_t value = sizeof(T) + SumSizes<Rest...>::value;
+template<typename... Fields>
+struct TupleFixedLayout<std::tuple<Fields...>> {
+    static constexpr bool value = (IsFixedSize<std::decay_t<Fields>>() && ...);
+    static constexpr size_t size = (FixedSizeOf<std::decay_t<Fields>>() + ... + 0);
 };
 
-// 递归序列化剩余参数
-template<size_t I, typename... Args>
-struct SerializeRestImpl;
+/**
+ * @brief 编码后的大小是否与值无关(可在编译期确定)
+ */
+template<typename T>
+constexpr bool IsFixedSize() {
+    if constexpr (IsRawCopyable<T>()) {
+        return true;
+    } else if constexpr (!HasCustomCodec<T>::value && HasRpcFields<T>::value) {
+        return TupleFixedLayout<typename FieldsTuple<T>::type>::value;
+    } else {
+        return false;
+    }
+}
 
-template<size_t I>
-struct SerializeRestImpl<I> {
-    static void apply(uint8_t* /*buffer*/, size_t& /*offset*/) {
-        // 终止条件，无需处理
+/**
+ * @brief 定长类型编码后的大小
+ */
+template<typename T>
+constexpr size_t FixedSizeOf() {
+    if constexpr (IsRawCopyable<T>()) {
+        return sizeof(T);
+    } else if constexpr (!HasCustomCodec<T>::value && HasRpcFields<T>::value) {
+        return TupleFixedLayout<typename FieldsTuple<T>::type>::size;
+    } else {
+        return 0;
     }
-};
+}
+
+template<typename T>
+size_t SizeOf(const T& value);
 
-template<size_t I, typename T, typename... Rest>
-struct SerializeRestImpl<I, T, Rest...> {
-    static void apply(uint8_t* buffer, size_t& offset, const T& value, const Rest&... rest) {
-        // 序列化当前参数
-        std::memcpy(buffer + offset, &value, sizeof(T));
-        offset += sizeof(T);
-        
-        // 递归处理剩余参数
-        SerializeRestImpl<I + 1, Rest...>::apply(buffer, offset, rest...);
+template<typename T>
+void Write(BinaryWriter& writer, const T& value);
+
+template<typename T>
+void Read(BinaryReader& reader, T& value);
+
+template<typename T>
+size_t SizeOf(const T& value) {
+    if constexpr (HasCustomCodec<T>::value) {
+        return BinaryCodec<T>::Size(value);
+    } else if constexpr (IsFixedSize<T>()) {
+        return FixedSizeOf<T>();
+    } else if constexpr (HasRpcFields<T>::value) {
+        return std::apply([](const auto&... fields) { return (SizeOf(fields) + ... + size_t(0)); },
+                          value.RpcFields());
+    } else if constexpr (IsString<T>::value || IsStringView<T>::value) {
+        return sizeof(uint32_t) + value.size();
+    } else if constexpr (IsArrayView<T>::value) {
+        return sizeof(uint32_t) + value.size() * FixedSizeOf<std::decay_t<decltype(value[0])>>();
+    } else if constexpr (IsVector<T>::value) {
+        using E = typename T::value_type;
+        if constexpr (IsFixedSize<E>()) {
+            return sizeof(uint32_t) + value.size() * FixedSizeOf<E>();
+        } else {
+            size_t size = sizeof(uint32_t);
+            for (const auto& element : value) {
+                size += SizeOf(element);
+            }
+            return size;
+        }
+    } else if constexpr (IsOptional<T>::value) {
+        return sizeof(uint8_t) + (value.has_value() ? SizeOf(*value) : 0);
+    } else {
+        static_assert(sizeof(T) == 0, "类型不支持二进制序列化，请使用OMNIRT_RPC_FIELDS声明字段或特化BinaryCodec");
+        return 0;
+    }
+}
+
+template<typename T>
+void Write(BinaryWriter& writer, const T& value) {
+    if constexpr (HasCustomCodec<T>::value) {
+        BinaryCodec<T>::Write(writer, value);
+    } else if constexpr (IsRawCopyable<T>()) {
+        writer.WriteBytes(&value, sizeof(T));
+    } else if constexpr (HasRpcFields<T>::value) {
+        std::apply([&writer](const auto&... fields) { (Write(writer, fields), ...); }, value.RpcFields());
+    } else if constexpr (IsString<T>::value || IsStringView<T>::value) {
+        writer.WriteLength(value.size());
+        writer.WriteBytes(value.data(), value.size());
+    } else if constexpr (IsArrayView<T>::value) {
+        writer.WriteLength(value.size());
+        writer.WriteBytes(value.bytes(), value.size() * FixedSizeOf<std::decay_t<decltype(value[0])>>());
+    } else if constexpr (IsVector<T>::value) {
+        using E = typename T::value_type;
+        writer.WriteLength(value.size());
+        if constexpr (IsRawCopyable<E>() && !std::is_same<E, bool>::value) {
+            writer.WriteBytes(value.data(), value.size() * sizeof(E));
+        } else {
+            for (const auto& element : value) {
+                Write(writer, static_cast<const E&>(element));
+            }
+        }
+    } else if constexpr (IsOptional<T>::value) {
+        const uint8_t has_value = value.has_value() ? 1 : 0;
+        writer.WriteBytes(&has_value, sizeof(has_value));
+        if (has_value) {
+            Write(writer, *value);
+        }
+    } else {
+        static_assert(sizeof(T) == 0, "类型不支持二进制序列化，请使用OMNIRT_RPC_FIELDS声明字段或特化BinaryCodec");
     }
+}
+
+template<typename T>
+void Read(BinaryReader& reader, T& value) {
+    if constexpr (HasCustomCodec<T>::value) {
+        BinaryCodec<T>::Read(reader, value);
+    } else if constexpr (IsRawCopyable<T>()) {
+        reader.ReadBytes(&value, sizeof(T));
+    } else if constexpr (HasRpcFields<T>::value) {
+        std::apply([&reader](auto&... fields) { (Read(reader, fields), ...); }, value.RpcFields());
+    } else if constexpr (IsString<T>::value) {
+        const size_t size = reader.ReadLength(1);
+        const uint8_t* data = reader.Consume(size);
+        value.assign(reinterpret_cast<const char*>(data), size);
+    } else if constexpr (IsStringView<T>::value) {
+        const size_t size = reader.ReadLength(1);
+        value = std::string_view(reinterpret_cast<const char*>(reader.Consume(size)), size);
+    } else if constexpr (IsArrayView<T>::value) {
+        using E = std::decay_t<decltype(value[0])>;
+        const size_t count = reader.ReadLength(sizeof(E));
+        value = T(reader.Consume(count * sizeof(E)), count);
+    } else if constexpr (IsVector<T>::value) {
+        using E = typename T::value_type;
+        const size_t count = reader.ReadLength(IsFixedSize<E>() ? FixedSizeOf<E>() : 1);
+        if constexpr (IsRawCopyable<E>() && !std::is_same<E, bool>::value) {
+            value.resize(count);
+            reader.ReadBytes(value.data(), count * sizeof(E));
+        } else {
+            value.clear();
+            value.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                E element{};
+                Read(reader, element);
+                value.push_back(std::move(element));
+            }
+        }
+    } else if constexpr (IsOptional<T>::value) {
+        uint8_t has_value = 0;
+        reader.ReadBytes(&has_value, sizeof(has_value));
+        if (has_value > 1) {
+            throw RpcException("反序列化错误：optional标志无效", ErrorCode::SERIALIZATION_ERROR);
+        }
+        if (has_value) {
+            typename T::value_type inner{};
+            Read(reader, inner);
+            value = std::move(inner);
+        } else {
+            value.reset();
+        }
+    } else {
+        static_assert(sizeof(T) == 0, "类型不支持二进制序列化，请使用OMNIRT_RPC_FIELDS声明字段或特化BinaryCodec");
+    }
+}
+
+/**
+ * @brief 参数包的编译期布局信息
+ */
+template<typename... Args>
+struct FixedLayout {
+    static constexpr bool value = (IsFixedSize<std::decay_t<Args>>() && ...);
+    static constexpr size_t size = (FixedSizeOf<std::decay_t<Args>>() + ... + 0);
 };
 
 } // namespace detail
 
 /**
  * @brief 二进制序列化器
- * 
+ *
  * 使用直接内存复制实现的高性能二进制序列化器，
- * 适用于POD（Plain Old Data）类型和简单结构体。
+ * 适用于POD（Plain Old Data）类型、字符串、容器和声明了字段的结构体。
  * 与msgpack相比，具有更高的性能和更低的开销。
  */
 class BinarySerializer : public Serializer {
@@ -88,230 +442,166 @@ public:
      * @brief 默认构造函数
      */
     BinarySerializer() = default;
-    
+
     /**
      * @brief 析构函数
      */
     ~BinarySerializer() override = default;
-    
+
     /**
-     * @brief 检查类型是否可通过内存复制安全序列化
-     * 
+     * @brief 检查类型是否可以直接通过内存复制序列化
+     *
      * @tparam T 要检查的类型
      */
     template<typename T>
     static constexpr bool is_binary_serializable() {
-        return std::is_trivially_copyable<T>::value;
+        return detail::IsRawCopyable<std::decay_t<T>>();
+    }
+
+    /**
+     * @brief 参数包是否为定长布局
+     *
+     * @tparam Args 参数类型列表
+     */
+    template<typename... Args>
+    static constexpr bool is_fixed_layout() {
+        return detail::FixedLayout<Args...>::value;
     }
-    
-    // 注意：单参数版本已在下面实现，这里删除以避免函数重载冲突
-    
+
     /**
-     * @brief 序列化多个POD类型为一个二进制数据块
-     * 
-     * @tparam Args POD类型参数包
-     * @param args 要序列化的参数列表
-     * @return std::vector<uint8_t> 序列化后的二进制数据
+     * @brief 定长参数包编码后的大小(编译期常量)
+     *
+     * @tparam Args 参数类型列表
      */
-    
-    // 空参数列表的序列化
-    std::vector<uint8_t> Serialize() {
-        // 返回空序列
-        return std::vector<uint8_t>();
+    template<typename... Args>
+    static constexpr size_t fixed_size() {
+        static_assert(detail::FixedLayout<Args...>::value, "参数包不是定长布局");
+        return detail::FixedLayout<Args...>::size;
     }
-    
-    // 单参数序列化（可减少模板实例化个数）
-    template<typename T>
-    typename std::enable_if<
-        is_binary_serializable<T>(), 
-        std::vector<uint8_t>>::type
-    Serialize(const T& value) {
-        // 特殊情况处理：如果类型为0字节，返回空序列
-        if (sizeof(T) == 0) {
-            return std::vector<uint8_t>();
+
+    /**
+     * @brief 计算参数序列化后的大小
+     *
+     * @tparam Args 参数类型列表
+     * @param args 参数列表
+     * @return size_t 序列化后的字节数
+     */
+    template<typename... Args>
+    static size_t SerializedSize(const Args&... args) {
+        if constexpr (detail::FixedLayout<Args...>::value) {
+            return detail::FixedLayout<Args...>::size;
+        } else {
+            return (detail::SizeOf(args) + ... + size_t(0));
         }
-        
-        std::vector<uint8_t> buffer(sizeof(T));
-        std::memcpy(buffer.data(), &value, sizeof(T));
-        return buffer;
     }
-    
-    // 多参数的序列化
-    template<typename T, typename... Args>
-    typename std::enable_if<
-        is_binary_serializable<T>() && 
-        detail::AllBinarySerializable<Args...>::value && 
-        (sizeof...(Args) > 0), // 确保这是多参数版本
-        std::vector<uint8_t>>::type
-    Serialize(const T& first, const Args&... rest) {
-        // 计算总大小
-        const size_t total_size = sizeof(T) + detail::SumSizes<Args...>::value;
-        
-        // 特殊情况处理：如果总大小为0，返回空序列
-        if (total_size == 0) {
-            return std::vector<uint8_t>();
+
+    /**
+     * @brief 将参数直接序列化到调用方提供的缓冲区
+     *
+     * 定长布局只在开始时检查一次容量,变长布局在每次写入时检查。
+     *
+     * @tparam Args 参数类型列表
+     * @param buffer 目标缓冲区
+     * @param capacity 缓冲区容量
+     * @param args 参数列表
+     * @return size_t 实际写入的字节数
+     * @throws RpcException 缓冲区空间不足
+     */
+    template<typename... Args>
+    size_t SerializeTo(uint8_t* buffer, size_t capacity, const Args&... args) {
+        BinaryWriter writer(buffer, capacity);
+        if constexpr (detail::FixedLayout<Args...>::value && (is_binary_serializable<Args>() && ...)) {
+            if (capacity < detail::FixedLayout<Args...>::size) {
+                throw RpcException("序列化错误：缓冲区空间不足", ErrorCode::SERIALIZATION_ERROR);
+            }
+            (writer.WriteBytesUnchecked(&args, sizeof(Args)), ...);
+        } else {
+            (detail::Write(writer, args), ...);
         }
-        
-        std::vector<uint8_t> buffer(total_size);
-        
-        // 先序列化第一个参数
-        size_t offset = 0;
-        if (sizeof(T) > 0) { // 防止0字节类型
-            SerializeToBuffer(buffer.data(), offset, first);
+        return writer.Offset();
+    }
+
+    /**
+     * @brief 序列化参数为一个新分配的二进制数据块
+     *
+     * @tparam Args 参数类型列表
+     * @param args 要序列化的参数列表
+     * @return std::vector<uint8_t> 序列化后的二进制数据
+     */
+    template<typename... Args>
+    std::vector<uint8_t> Serialize(const Args&... args) {
+        std::vector<uint8_t> buffer(SerializedSize(args...));
+        if (!buffer.empty()) {
+            SerializeTo(buffer.data(), buffer.size(), args...);
         }
-        
-        // 递归序列化剩余参数
-        detail::SerializeRestImpl<0, Args...>::apply(buffer.data(), offset, rest...);
-        
         return buffer;
     }
-    
+
     /**
-     * @brief 反序列化二进制数据为指定POD类型
-     * 
-     * @tparam T 目标POD类型
-     * @param data 二进制数据
+     * @brief 从缓冲区反序列化单个值
+     *
+     * 目标类型为std::string_view或BinaryArrayView时,结果直接引用缓冲区数据。
+     *
+     * @tparam T 目标类型
+     * @param data 缓冲区
+     * @param size 缓冲区大小
      * @return T 反序列化后的对象
+     * @throws RpcException 数据不足或格式错误
      */
     template<typename T>
-    typename std::enable_if<is_binary_serializable<T>(), T>::type
-    Deserialize(const std::vector<uint8_t>& data) {
-        std::cout << "DEBUG: Deserialize<T> - 数据大小: " << data.size() << ", 类型大小: " << sizeof(T) << std::endl;
-        
-        // 特殊情况处理：如果类型大小为0字节
-        if (sizeof(T) == 0) {
-            std::cout << "DEBUG: Deserialize<T> - 类型大小为0，直接返回空值" << std::endl;
-            return T();
-        }
-        
-        // 验证数据大小
-        if (data.size() < sizeof(T)) {
-            std::cout << "DEBUG: Deserialize<T> - 数据大小不足" << std::endl;
-            throw RpcException("反序列化错误：数据大小不足", ErrorCode::SERIALIZATION_ERROR);
-        }
-        
-        // 特殊情况处理：如果数据项为空
-        if (data.empty()) {
-            std::cout << "DEBUG: Deserialize<T> - 数据为空，返回默认值" << std::endl;
-            return T();
-        }
-        
-        // 正常反序列化
-        T result;
-        std::memcpy(&result, data.data(), sizeof(T));
-        std::cout << "DEBUG: Deserialize<T> - 反序列化成功" << std::endl;
+    T Deserialize(const uint8_t* data, size_t size) {
+        BinaryReader reader(data, size);
+        T result{};
+        detail::Read(reader, result);
         return result;
     }
-    
+
     /**
-     * @brief 反序列化二进制数据为指定类型的元组
-     * 
-     * @tparam Args 元组中的类型列表
+     * @brief 反序列化二进制数据为指定类型
+     *
+     * @tparam T 目标类型
      * @param data 二进制数据
-     * @return std::tuple<Args...> 反序列化后的元组
-     */
-    /**
-     * @brief 反序列化二进制数据为元组
-     * 
-     * 特化空参数版本
-     * 
-     * @return std::tuple<> 空元组
+     * @return T 反序列化后的对象
      */
-    template<typename... Args>
-    typename std::enable_if<sizeof...(Args) == 0, std::tuple<>>::type
-    DeserializeAsTuple(const std::vector<uint8_t>& /*data*/) {
-        return std::tuple<>();
+    template<typename T>
+    T Deserialize(const std::vector<uint8_t>& data) {
+        return Deserialize<T>(data.data(), data.size());
     }
-    
+
     /**
-     * @brief 反序列化二进制数据为元组
-     * 
-     * 非空参数版本
-     * 
+     * @brief 从缓冲区反序列化为元组
+     *
+     * @tparam Args 元组中的类型列表
+     * @param data 缓冲区
+     * @param size 缓冲区大小
      * @return std::tuple<Args...> 反序列化后的元组
+     * @throws RpcException 数据不足或格式错误
      */
     template<typename... Args>
-    typename std::enable_if<
-        sizeof...(Args) != 0 && 
-        detail::AllBinarySerializable<Args...>::value, 
-        std::tuple<Args...>>::type
-    DeserializeAsTuple(const std::vector<uint8_t>& data) {
-        const size_t expected_size = detail::SumSizes<Args...>::value;
-        
-        // 特殊情况处理：如果预期大小为0，直接返回空元组
-        if (expected_size == 0) {
-            return std::tuple<Args...>();
-        }
-        
-        // 验证数据大小
-        if (data.size() < expected_size) {
-            throw RpcException("反序列化元组错误：数据大小不足", ErrorCode::SERIALIZATION_ERROR);
-        }
-        
-        // 创建结果元组
+    std::tuple<Args...> DeserializeAsTuple(const uint8_t* data, size_t size) {
         std::tuple<Args...> result;
-        
-        // 如果数据不为空，进行反序列化
-        if (!data.empty()) {
-            size_t offset = 0;
-            DeserializeTuple<0, Args...>(result, data.data(), offset);
+        if constexpr (sizeof...(Args) != 0) {
+            if constexpr (detail::FixedLayout<Args...>::value) {
+                if (size < detail::FixedLayout<Args...>::size) {
+                    throw RpcException("反序列化元组错误：数据大小不足", ErrorCode::SERIALIZATION_ERROR);
+                }
+            }
+            BinaryReader reader(data, size);
+            std::apply([&reader](auto&... elements) { (detail::Read(reader, elements), ...); }, result);
         }
-        
         return result;
     }
-    
-private:
-    /**
-     * @brief 将单个值序列化到缓冲区的指定位置
-     * 
-     * @tparam T 值类型
-     * @param buffer 目标缓冲区
-     * @param offset 当前偏移量，会更新为序列化后的新偏移量
-     * @param value 要序列化的值
-     */
-    template<typename T>
-    void SerializeToBuffer(uint8_t* buffer, size_t& offset, const T& value) {
-        std::memcpy(buffer + offset, &value, sizeof(T));
-        offset += sizeof(T);
-    }
-    
-    /**
-     * @brief 递归反序列化元组的辅助函数
-     * 
-     * @tparam I 当前元组索引
-     * @tparam Args 元组类型列表
-     * @param tuple 目标元组
-     * @param data 二进制数据
-     * @param offset 当前偏移量，会更新为反序列化后的新偏移量
-     */
-    template<size_t I, typename... Args>
-    typename std::enable_if<I == sizeof...(Args), void>::type
-    DeserializeTuple(std::tuple<Args...>& /*tuple*/, const uint8_t* /*data*/, size_t& /*offset*/) {
-        // 基本情况：所有元素都已处理完毕
-    }
-    
+
     /**
-     * @brief 递归反序列化元组的辅助函数
-     * 
-     * @tparam I 当前元组索引
-     * @tparam Args 元组类型列表
-     * @param tuple 目标元组
+     * @brief 反序列化二进制数据为指定类型的元组
+     *
+     * @tparam Args 元组中的类型列表
      * @param data 二进制数据
-     * @param offset 当前偏移量，会更新为反序列化后的新偏移量
+     * @return std::tuple<Args...> 反序列化后的元组
      */
-    template<size_t I, typename... Args>
-    typename std::enable_if<I < sizeof...(Args), void>::type
-    DeserializeTuple(std::tuple<Args...>& tuple, const uint8_t* data, size_t& offset) {
-        using ElementType = typename std::tuple_element<I, std::tuple<Args...>>::type;
-        
-        // 安全检查：只有当类型大小大于0时才进行复制
-        if (sizeof(ElementType) > 0) {
-            std::memcpy(&std::get<I>(tuple), data + offset, sizeof(ElementType));
-            offset += sizeof(ElementType);
-        }
-        
-        // 继续递归处理下一个元素
-        DeserializeTuple<I + 1, Args...>(tuple, data, offset);
+    template<typename... Args>
+    std::tuple<Args...> DeserializeAsTuple(const std::vector<uint8_t>& data) {
+        return DeserializeAsTuple<Args...>(data.data(), data.size());
     }
 };
 
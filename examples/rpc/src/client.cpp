@@ -11,6 +11,13 @@
 namespace omnirt {
 namespace rpc {
 
+namespace {
+
+/// 响应线程单次等待的最长时间
+constexpr std::chrono::milliseconds kResponseWaitTimeout{100};
+
+} // namespace
+
 /**
  * @brief 构造函数
  * 
@@ -21,10 +28,16 @@ Client::Client(const std::string& channel_name, const RpcConfig& config)
     : channel_name_(channel_name),
       config_(config),
       rng_(std::random_device{}()) {
-    // 初始化共享内存队列
-    if (!InitSharedMemoryQueues()) {
-        throw RpcException("无法初始化共享内存队列", ErrorCode::CONNECTION_ERROR);
+    // 初始化传输层
+    if (!InitTransport()) {
+        throw RpcException("无法连接RPC服务端", ErrorCode::CONNECTION_ERROR);
     }
+    
+    // 启动响应处理线程
+    running_.store(true);
+    response_thread_ = std::thread([this]() {
+        ResponseHandler();
+    });
 }
 
 /**
@@ -33,10 +46,23 @@ Client::Client(const std::string& channel_name, const RpcConfig& config)
 Client::~Client() {
     // 停止响应处理线程
     running_.store(false);
+    if (session_) {
+        session_->Wake();
+    }
     
     if (response_thread_.joinable()) {
         response_thread_.join();
     }
+    
+    // 客户端销毁后不会再收到响应，以连接错误完成所有挂起的调用
+    std::unordered_map<uint64_t, PendingCall> pending_calls;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        pending_calls.swap(pending_calls_);
+    }
+    for (auto& item : pending_calls) {
+        item.second.result->SetError(ErrorCode::CONNECTION_ERROR, "RPC客户端已关闭");
+    }
 }
 
 /**
@@ -83,8 +109,7 @@ bool Client::WaitForConnection(std::chrono::milliseconds timeout) {
  * @return false 未连接
  */
 bool Client::IsConnected() const {
-    return (request_queue_ && request_queue_->GetShmState() != omnirt::common::util::ShmBoundedSpscLockfreeQueue<RpcMessage>::ShmState::NOT_INITIALIZED) &&
-           (response_queue_ && response_queue_->GetShmState() != omnirt::common::util::ShmBoundedSpscLockfreeQueue<RpcMessage>::ShmState::NOT_INITIALIZED);
+    return session_ && session_->IsOpen();
 }
 
 /**
@@ -108,109 +133,136 @@ uint64_t Client::GenerateMessageId() {
  * @return false 发送失败
  */
 bool Client::SendRequest(const RpcMessage& request) {
-    if (!request_queue_) {
+    if (!session_) {
         return false;
     }
     
-    // 尝试将请求放入请求队列
-    return request_queue_->Enqueue(request);
+    // 尝试将请求写入会话请求队列
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    RpcFrame* frame = session_->ReserveRequest();
+    if (frame == nullptr || !EncodeFrame(request, frame)) {
+        return false;
+    }
+    return session_->CommitRequest();
 }
 
 /**
- * @brief 等待RPC响应
+ * @brief 登记挂起的调用
  * 
  * @param message_id 消息ID
- * @param timeout 超时时间
- * @param response 用于存储响应的引用
- * @return true 接收到响应
- * @return false 等待超时
+ * @param result 调用结果
+ * @param complete 收到响应后完成结果的函数
  */
-bool Client::WaitForResponse(uint64_t message_id, std::chrono::milliseconds timeout, RpcMessage& response) {
-    std::unique_lock<std::mutex> lock(pending_mutex_);
-    
-    // 检查是否已经收到响应
-    auto it = pending_responses_.find(message_id);
-    if (it != pending_responses_.end()) {
-        response = it->second;
-        pending_responses_.erase(it);
-        return true;
-    }
-    
-    // 等待响应
-    auto pred = [this, message_id]() {
-        return pending_responses_.find(message_id) != pending_responses_.end();
-    };
-    
-    bool result;
-    if (timeout.count() > 0) {
-        result = pending_cv_.wait_for(lock, timeout, pred);
-    } else {
-        pending_cv_.wait(lock, pred);
-        result = true;
-    }
+void Client::AddPendingCall(uint64_t message_id, std::shared_ptr<RpcResultBase> result,
+                            void (*complete)(RpcResultBase*, const RpcFrame&)) {
+    PendingCall call;
+    call.deadline = std::chrono::steady_clock::now() + config_.default_timeout;
+    call.result = std::move(result);
+    call.complete = complete;
     
-    if (result) {
-        // 获取响应
-        auto it = pending_responses_.find(message_id);
-        if (it != pending_responses_.end()) {
-            response = it->second;
-            pending_responses_.erase(it);
-            return true;
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_calls_[message_id] = std::move(call);
+}
+
+/**
+ * @brief 移除挂起的调用
+ * 
+ * @param message_id 消息ID
+ */
+void Client::RemovePendingCall(uint64_t message_id) {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_calls_.erase(message_id);
+}
+
+/**
+ * @brief 以超时错误完成所有已过期的挂起调用
+ */
+void Client::ExpirePendingCalls() {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<RpcResultBase>> expired;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        for (auto it = pending_calls_.begin(); it != pending_calls_.end();) {
+            if (it->second.deadline <= now) {
+                expired.push_back(std::move(it->second.result));
+                it = pending_calls_.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
     
-    return false;
+    // 在锁外完成结果，避免延续回调中再次调用客户端导致死锁
+    for (auto& result : expired) {
+        result->SetError(ErrorCode::TIMEOUT, "RPC调用超时");
+    }
 }
 
 /**
  * @brief 响应处理线程
  */
 void Client::ResponseHandler() {
-    RpcMessage response;
+    auto next_expire_check = std::chrono::steady_clock::now() + kResponseWaitTimeout;
     
     while (running_.load()) {
-        // 尝试从响应队列中取出响应
-        if (response_queue_->Dequeue(&response)) {
-            // 处理响应
-            std::lock_guard<std::mutex> lock(pending_mutex_);
+        // 等待会话响应队列中的响应，无响应时阻塞在futex上
+        const RpcFrame* frame = session_->PeekResponse(kResponseWaitTimeout);
+        if (frame != nullptr) {
+            PendingCall call;
+            bool found = false;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                auto it = pending_calls_.find(frame->header.message_id);
+                // 找不到说明调用已超时或为心跳等无需响应的消息
+                if (it != pending_calls_.end()) {
+                    call = std::move(it->second);
+                    pending_calls_.erase(it);
+                    found = true;
+                }
+            }
             
-            // 保存响应并通知等待线程
-            pending_responses_[response.header.message_id] = response;
-            pending_cv_.notify_all();
-        } else {
-            // 没有响应，短暂休眠避免CPU占用过高
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            // 直接在响应线程中从响应帧完成结果，完成后再释放槽位
+            if (found) {
+                call.complete(call.result.get(), *frame);
+            }
+            session_->ReleaseResponse();
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_expire_check) {
+            ExpirePendingCalls();
+            next_expire_check = now + kResponseWaitTimeout;
         }
     }
 }
 
 /**
- * @brief 初始化共享内存队列
+ * @brief 按配置创建传输层并连接服务端，连接失败时按配置重试
  * 
  * @return true 初始化成功
  * @return false 初始化失败
  */
-bool Client::InitSharedMemoryQueues() {
+bool Client::InitTransport() {
     try {
-        // 初始化请求队列（客户端为生产者）
-        request_queue_ = std::make_unique<RequestQueue>();
-        std::string request_queue_name = "/omnirt_rpc_req_" + channel_name_;
-        if (!request_queue_->Init(request_queue_name, config_.request_queue_size, true, false)) {
-            std::cerr << "错误: 无法初始化请求队列" << std::endl;
+        session_ = CreateClientTransport(channel_name_, config_);
+        if (!session_) {
             return false;
         }
         
-        // 初始化响应队列（客户端为消费者）
-        response_queue_ = std::make_unique<ResponseQueue>();
-        std::string response_queue_name = "/omnirt_rpc_resp_" + channel_name_;
-        if (!response_queue_->Init(response_queue_name, config_.response_queue_size, true, false)) {
-            std::cerr << "错误: 无法初始化响应队列" << std::endl;
-            return false;
+        // 服务端可能晚于客户端启动，按配置的次数和间隔重试
+        for (uint32_t attempt = 0; !session_->Open(); ++attempt) {
+            if (attempt >= config_.connect_retry_count) {
+                std::cerr << "错误: 无法通过" << TransportTypeName(config_.transport)
+                          << "传输连接服务端" << std::endl;
+                session_.reset();
+                return false;
+            }
+            std::this_thread::sleep_for(config_.connect_retry_interval);
         }
         
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "初始化共享内存队列时发生异常: " << e.what() << std::endl;
+        std::cerr << "初始化传输层时发生异常: " << e.what() << std::endl;
         return false;
     }
 }
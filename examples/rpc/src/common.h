@@ -69,6 +69,15 @@ namespace std {
 namespace omnirt {
 namespace rpc {
 
+/**
+ * @brief RPC传输方式
+ */
+enum class TransportType : uint8_t {
+    SHM = 0,     ///< 共享内存SPSC队列，每个客户端一对队列，跨进程
+    UDS = 1,     ///< Unix域套接字，按帧头分帧，跨进程
+    INPROC = 2   ///< 进程内队列，用于测试和同进程通信
+};
+
 /**
  * @brief RPC通信配置参数
  * 
@@ -80,6 +89,13 @@ struct RpcConfig {
     uint32_t max_message_size = 4096;     ///< 最大消息大小(字节)
     std::chrono::milliseconds default_timeout{5000};  ///< 默认调用超时时间
     bool auto_reconnect = true;           ///< 是否自动重连
+
+    TransportType transport = TransportType::SHM;  ///< 传输方式，服务端和客户端必须一致
+    uint32_t connect_retry_count = 0;              ///< 客户端建立连接失败时的重试次数
+    std::chrono::milliseconds connect_retry_interval{100};  ///< 连接重试间隔
+
+    std::string uds_socket_dir = "/tmp";  ///< UDS传输的套接字文件所在目录
+    uint32_t uds_socket_buffer_size = 0;  ///< UDS套接字收发缓冲区大小(字节)，0表示使用系统默认值
 };
 
 /**
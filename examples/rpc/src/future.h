@@ -0,0 +1,497 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC调用结果(future/promise)实现
+// 1. 单原子状态机: 完成、等待者、回调等状态全部编码在一个32位原子变量中,查询无需加锁
+// 2. futex等待: 只有存在等待者时完成方才进行系统调用
+// 3. 延续回调: 结果就绪后在完成线程内联执行,或投递到指定执行器
+// 4. 组合器: WhenAll/WhenAny用于扇出调用
+// 5. 池化共享状态: 结果对象及shared_ptr控制块从线程本地空闲链表分配
+
+#pragma once
+
+#include "common.h"
+#include "../../../src/common/util/futex_atomic.h"
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace omnirt {
+namespace rpc {
+
+/**
+ * @brief 执行器接口
+ *
+ * 用于执行RPC结果的延续回调,可由用户适配到自己的线程池。
+ */
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    /**
+     * @brief 投递一个任务
+     *
+     * @param task 待执行的任务
+     */
+    virtual void Execute(std::function<void()> task) = 0;
+};
+
+namespace detail {
+
+/**
+ * @brief 固定大小内存块的线程本地空闲链表
+ *
+ * 内存块在哪个线程释放就缓存在哪个线程,每个线程最多缓存kMaxCachedBlocks个。
+ * 线程退出后的释放直接归还给全局堆。
+ *
+ * @tparam BlockSize 内存块大小
+ */
+template<std::size_t BlockSize>
+class SharedStateFreeList {
+public:
+    static void* Allocate() {
+        Cache* cache = LocalCache();
+        if (cache != nullptr && cache->head != nullptr) {
+            Node* node = cache->head;
+            cache->head = node->next;
+            --cache->count;
+            return node;
+        }
+        return ::operator new(BlockSize < sizeof(Node) ? sizeof(Node) : BlockSize);
+    }
+
+    static void Deallocate(void* ptr) {
+        Cache* cache = LocalCache();
+        if (cache == nullptr || cache->count >= kMaxCachedBlocks) {
+            ::operator delete(ptr);
+            return;
+        }
+        Node* node = static_cast<Node*>(ptr);
+        node->next = cache->head;
+        cache->head = node;
+        ++cache->count;
+    }
+
+private:
+    static constexpr std::size_t kMaxCachedBlocks = 1024;
+
+    struct Node {
+        Node* next;
+    };
+
+    struct Cache {
+        Node* head = nullptr;
+        std::size_t count = 0;
+
+        ~Cache() {
+            Destroyed() = true;
+            while (head != nullptr) {
+                Node* next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+        }
+    };
+
+    // 平凡类型的thread_local在线程退出期间始终可访问,用于标记缓存已析构
+    static bool& Destroyed() {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static Cache* LocalCache() {
+        if (Destroyed()) {
+            return nullptr;
+        }
+        static thread_local Cache cache;
+        return &cache;
+    }
+};
+
+/**
+ * @brief 基于SharedStateFreeList的分配器,配合std::allocate_shared使用
+ *
+ * @tparam T 分配的对象类型(通常为shared_ptr内部的控制块类型)
+ */
+template<typename T>
+class SharedStatePoolAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = SharedStatePoolAllocator<U>;
+    };
+
+    SharedStatePoolAllocator() noexcept = default;
+
+    template<typename U>
+    SharedStatePoolAllocator(const SharedStatePoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "不支持过度对齐的类型");
+        if (n == 1) {
+            return static_cast<T*>(SharedStateFreeList<sizeof(T)>::Allocate());
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept {
+        if (n == 1) {
+            SharedStateFreeList<sizeof(T)>::Deallocate(ptr);
+            return;
+        }
+        ::operator delete(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const SharedStatePoolAllocator<U>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const SharedStatePoolAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace detail
+
+/**
+ * @brief RPC调用结果的公共状态
+ *
+ * 状态字各位含义:
+ * - kClaimed: 已有完成方占用,后续SetResult/SetError将被忽略
+ * - kDone: 结果已发布,可以安全读取
+ * - kWaiter: 有线程阻塞在futex上,发布时需要唤醒
+ * - kCallbackClaimed/kCallback: 延续回调已占用/已写入
+ */
+class RpcResultBase {
+public:
+    RpcResultBase() = default;
+    virtual ~RpcResultBase() = default;
+
+    RpcResultBase(const RpcResultBase&) = delete;
+    RpcResultBase& operator=(const RpcResultBase&) = delete;
+
+    /**
+     * @brief 设置错误
+     *
+     * @param error 错误码
+     * @param error_message 错误消息
+     * @return true 设置成功
+     * @return false 结果已被设置过
+     */
+    bool SetError(ErrorCode error, const std::string& error_message) {
+        if (!TryClaim()) {
+            return false;
+        }
+        error_ = error;
+        error_message_ = error_message;
+        Publish();
+        return true;
+    }
+
+    /**
+     * @brief 等待结果
+     *
+     * 先短暂自旋,仍未就绪时在状态字上进行futex等待。
+     *
+     * @param timeout 超时时间,0表示无限等待
+     * @return true 结果已就绪
+     * @return false 等待超时
+     */
+    bool Wait(std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+        uint32_t state = state_.load(std::memory_order_acquire);
+        if (state & kDone) {
+            return true;
+        }
+
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (state_.load(std::memory_order_acquire) & kDone) {
+                return true;
+            }
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        state = state_.fetch_or(kWaiter, std::memory_order_acq_rel) | kWaiter;
+        while (!(state & kDone)) {
+            if (timeout.count() == 0) {
+                aimrt::common::util::futex(StateWord(), FUTEX_WAIT_PRIVATE, state);
+            } else {
+                const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                if (remaining.count() <= 0) {
+                    return false;
+                }
+                struct timespec ts;
+                ts.tv_sec = static_cast<time_t>(remaining.count() / 1000000000);
+                ts.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+                aimrt::common::util::futex(StateWord(), FUTEX_WAIT_PRIVATE, state, &ts);
+            }
+            state = state_.load(std::memory_order_acquire);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 注册延续回调
+     *
+     * 结果就绪后执行回调: executor为空时在完成线程内联执行,否则投递到executor。
+     * 如果注册时结果已就绪,则立即执行。每个结果只能注册一个回调。
+     *
+     * @param callback 回调函数
+     * @param executor 执行回调的执行器,可为空
+     * @return true 注册成功
+     * @return false 已注册过回调
+     */
+    bool Then(std::function<void()> callback, Executor* executor = nullptr) {
+        if (state_.fetch_or(kCallbackClaimed, std::memory_order_acq_rel) & kCallbackClaimed) {
+            return false;
+        }
+        callback_ = std::move(callback);
+        executor_ = executor;
+        if (state_.fetch_or(kCallback, std::memory_order_acq_rel) & kDone) {
+            RunCallback();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 检查是否就绪
+     */
+    bool IsReady() const {
+        return (state_.load(std::memory_order_acquire) & kDone) != 0;
+    }
+
+    /**
+     * @brief 检查是否有错误
+     */
+    bool HasError() const {
+        return IsReady() && (error_ != ErrorCode::SUCCESS);
+    }
+
+    /**
+     * @brief 获取错误码,未就绪时返回SUCCESS
+     */
+    ErrorCode GetError() const {
+        return IsReady() ? error_ : ErrorCode::SUCCESS;
+    }
+
+    /**
+     * @brief 获取错误消息,未就绪时返回空字符串
+     */
+    std::string GetErrorMessage() const {
+        return IsReady() ? error_message_ : std::string();
+    }
+
+protected:
+    /**
+     * @brief 抢占完成权,只有第一个完成方能写入结果
+     */
+    bool TryClaim() {
+        return (state_.fetch_or(kClaimed, std::memory_order_acq_rel) & kClaimed) == 0;
+    }
+
+    /**
+     * @brief 发布结果,唤醒等待者并执行回调
+     */
+    void Publish() {
+        const uint32_t prev = state_.fetch_or(kDone, std::memory_order_acq_rel);
+        if (prev & kWaiter) {
+            aimrt::common::util::futex(StateWord(), FUTEX_WAKE_PRIVATE, INT_MAX);
+        }
+        if (prev & kCallback) {
+            RunCallback();
+        }
+    }
+
+    /**
+     * @brief 在读取结果前检查状态,未就绪或出错时抛出异常
+     */
+    void CheckReady() const {
+        if (!IsReady()) {
+            throw RpcException("结果未就绪", ErrorCode::TIMEOUT);
+        }
+        if (error_ != ErrorCode::SUCCESS) {
+            throw RpcException(error_message_, error_);
+        }
+    }
+
+private:
+    static constexpr uint32_t kClaimed = 1u << 0;
+    static constexpr uint32_t kDone = 1u << 1;
+    static constexpr uint32_t kWaiter = 1u << 2;
+    static constexpr uint32_t kCallbackClaimed = 1u << 3;
+    static constexpr uint32_t kCallback = 1u << 4;
+    static constexpr int kSpinCount = 128;
+
+    uint32_t* StateWord() {
+        return reinterpret_cast<uint32_t*>(&state_);
+    }
+
+    void RunCallback() {
+        // 回调通常捕获了结果自身的shared_ptr,执行后释放以打破引用环
+        std::function<void()> callback = std::move(callback_);
+        callback_ = nullptr;
+        if (executor_ != nullptr) {
+            executor_->Execute(std::move(callback));
+        } else {
+            callback();
+        }
+    }
+
+    std::atomic<uint32_t> state_{0};                ///< 状态字
+    ErrorCode error_ = ErrorCode::SUCCESS;          ///< 错误码
+    std::string error_message_;                     ///< 错误消息
+    std::function<void()> callback_;                ///< 延续回调
+    Executor* executor_ = nullptr;                  ///< 执行回调的执行器
+};
+
+/**
+ * @brief RPC调用结果类
+ *
+ * 用于存储异步RPC调用的结果
+ *
+ * @tparam R 返回值类型
+ */
+template<typename R>
+class RpcResult : public RpcResultBase {
+public:
+    /**
+     * @brief 设置结果
+     *
+     * @param result 结果值
+     * @return true 设置成功
+     * @return false 结果已被设置过
+     */
+    bool SetResult(const R& result) {
+        if (!TryClaim()) {
+            return false;
+        }
+        result_ = result;
+        Publish();
+        return true;
+    }
+
+    /**
+     * @brief 获取结果
+     *
+     * @return R 结果值
+     * @throws RpcException 如果发生错误或结果未就绪
+     */
+    R GetResult() {
+        CheckReady();
+        return result_;
+    }
+
+private:
+    R result_{};  ///< 结果值
+};
+
+/**
+ * @brief void类型的RPC调用结果特化
+ */
+template<>
+class RpcResult<void> : public RpcResultBase {
+public:
+    /**
+     * @brief 设置结果
+     *
+     * @return true 设置成功
+     * @return false 结果已被设置过
+     */
+    bool SetResult() {
+        if (!TryClaim()) {
+            return false;
+        }
+        Publish();
+        return true;
+    }
+
+    /**
+     * @brief 获取结果
+     *
+     * @throws RpcException 如果发生错误或结果未就绪
+     */
+    void GetResult() {
+        CheckReady();
+    }
+};
+
+/**
+ * @brief 从池中创建一个RPC调用结果
+ *
+ * @tparam R 返回值类型
+ * @return std::shared_ptr<RpcResult<R>> 结果对象
+ */
+template<typename R>
+std::shared_ptr<RpcResult<R>> MakeRpcResult() {
+    return std::allocate_shared<RpcResult<R>>(detail::SharedStatePoolAllocator<RpcResult<R>>());
+}
+
+/**
+ * @brief 等待所有结果完成
+ *
+ * 所有输入成功时返回的结果成功;任一输入失败时立即以该错误完成。
+ * 该函数会占用每个输入结果的延续回调。
+ *
+ * @param results 输入结果列表
+ * @param executor 执行内部回调的执行器,可为空
+ * @return std::shared_ptr<RpcResult<void>> 聚合结果
+ */
+template<typename R>
+std::shared_ptr<RpcResult<void>> WhenAll(const std::vector<std::shared_ptr<RpcResult<R>>>& results,
+                                         Executor* executor = nullptr) {
+    auto all = MakeRpcResult<void>();
+    if (results.empty()) {
+        all->SetResult();
+        return all;
+    }
+
+    auto remaining = std::make_shared<std::atomic<std::size_t>>(results.size());
+    for (const auto& result : results) {
+        // 回调在result自身的Publish中执行,此时result必然存活,捕获裸指针即可
+        RpcResult<R>* input = result.get();
+        input->Then([all, remaining, input]() {
+            if (input->HasError()) {
+                all->SetError(input->GetError(), input->GetErrorMessage());
+            }
+            if (remaining->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                all->SetResult();
+            }
+        }, executor);
+    }
+    return all;
+}
+
+/**
+ * @brief 等待任一结果完成
+ *
+ * 返回的结果值为最先完成(成功或失败)的输入下标。
+ * 该函数会占用每个输入结果的延续回调。
+ *
+ * @param results 输入结果列表
+ * @param executor 执行内部回调的执行器,可为空
+ * @return std::shared_ptr<RpcResult<std::size_t>> 最先完成的输入下标
+ */
+template<typename R>
+std::shared_ptr<RpcResult<std::size_t>> WhenAny(const std::vector<std::shared_ptr<RpcResult<R>>>& results,
+                                                Executor* executor = nullptr) {
+    auto any = MakeRpcResult<std::size_t>();
+    if (results.empty()) {
+        any->SetError(ErrorCode::INVALID_ARGS, "WhenAny输入为空");
+        return any;
+    }
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        results[i]->Then([any, i]() { any->SetResult(i); }, executor);
+    }
+    return any;
+}
+
+} // namespace rpc
+} // namespace omnirt
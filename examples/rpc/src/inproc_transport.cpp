@@ -0,0 +1,375 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC进程内传输实现文件
+
+#include "inproc_transport.h"
+#include "../../../src/common/util/futex_atomic.h"
+
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+namespace omnirt {
+namespace rpc {
+
+using InprocFrameQueue = omnirt::common::util::BoundedSpscLockfreeQueue<RpcFrame>;
+
+struct InprocConnection {
+    InprocFrameQueue request_queue;
+    InprocFrameQueue response_queue;
+    std::atomic<uint32_t> response_seq{0};    ///< 响应序号,客户端在其上进行futex等待
+    std::atomic<uint32_t> client_waiting{0};  ///< 客户端是否正在futex等待响应
+    std::atomic<bool> closed{false};          ///< 客户端已断开
+};
+
+struct InprocChannel {
+    std::mutex mutex;                                                    ///< 保护connections
+    std::array<std::shared_ptr<InprocConnection>, kMaxSessions> connections;
+    std::atomic<bool> closed{false};                                     ///< 服务端已关闭
+
+    alignas(64) std::atomic<uint64_t> ready_bitmap{0};  ///< 就绪位图,第i位表示会话i有待处理请求
+    std::atomic<uint32_t> ready_seq{0};                 ///< 就绪序号,服务端在其上进行futex等待
+    std::atomic<uint32_t> server_waiting{0};            ///< 服务端是否正在futex等待
+};
+
+namespace {
+
+using aimrt::common::util::futex;
+
+/**
+ * @brief 进程内futex等待，只在本进程内同步，可以使用PRIVATE操作
+ */
+void FutexWaitPrivate(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::nanoseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    futex(reinterpret_cast<uint32_t*>(word), FUTEX_WAIT_PRIVATE, expected, &ts);
+}
+
+void FutexWakePrivate(std::atomic<uint32_t>* word, int count) {
+    futex(reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE, static_cast<uint32_t>(count));
+}
+
+/**
+ * @brief 进程内通道注册表
+ */
+class InprocRegistry {
+public:
+    static InprocRegistry& Instance() {
+        static InprocRegistry instance;
+        return instance;
+    }
+
+    std::shared_ptr<InprocChannel> Create(const std::string& channel_name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& weak = channels_[channel_name];
+        auto existing = weak.lock();
+        if (existing && !existing->closed.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        auto channel = std::make_shared<InprocChannel>();
+        weak = channel;
+        return channel;
+    }
+
+    std::shared_ptr<InprocChannel> Find(const std::string& channel_name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = channels_.find(channel_name);
+        if (it == channels_.end()) {
+            return nullptr;
+        }
+        auto channel = it->second.lock();
+        if (!channel || channel->closed.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return channel;
+    }
+
+    void Remove(const std::string& channel_name, const InprocChannel* channel) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = channels_.find(channel_name);
+        if (it != channels_.end()) {
+            auto current = it->second.lock();
+            if (!current || current.get() == channel) {
+                channels_.erase(it);
+            }
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<InprocChannel>> channels_;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// InprocServerTransport
+// ---------------------------------------------------------------------------
+
+InprocServerTransport::InprocServerTransport(const std::string& channel_name, const RpcConfig& config)
+    : channel_name_(channel_name),
+      config_(config) {}
+
+InprocServerTransport::~InprocServerTransport() {
+    Close();
+}
+
+bool InprocServerTransport::Init() {
+    if (channel_) {
+        return false;
+    }
+
+    channel_ = InprocRegistry::Instance().Create(channel_name_);
+    if (!channel_) {
+        std::cerr << "错误: 进程内通道 " << channel_name_ << " 已有服务端运行" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void InprocServerTransport::Close() {
+    if (!channel_) {
+        return;
+    }
+
+    channel_->closed.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(channel_->mutex);
+        for (auto& connection : channel_->connections) {
+            connection.reset();
+        }
+    }
+    for (auto& session : sessions_) {
+        session.reset();
+    }
+
+    InprocRegistry::Instance().Remove(channel_name_, channel_.get());
+    channel_.reset();
+}
+
+uint64_t InprocServerTransport::WaitReady(std::chrono::milliseconds timeout) {
+    if (!channel_) {
+        return 0;
+    }
+
+    uint64_t ready = channel_->ready_bitmap.exchange(0, std::memory_order_acq_rel);
+    if (ready != 0) {
+        return ready;
+    }
+
+    // 与共享内存传输相同: 先声明等待再复查位图,避免丢失唤醒
+    channel_->server_waiting.store(1, std::memory_order_seq_cst);
+    const uint32_t seq = channel_->ready_seq.load(std::memory_order_seq_cst);
+    ready = channel_->ready_bitmap.exchange(0, std::memory_order_seq_cst);
+    if (ready == 0) {
+        FutexWaitPrivate(&channel_->ready_seq, seq, timeout);
+        ready = channel_->ready_bitmap.exchange(0, std::memory_order_acq_rel);
+    }
+    channel_->server_waiting.store(0, std::memory_order_relaxed);
+
+    return ready;
+}
+
+const RpcFrame* InprocServerTransport::PeekRequest(uint32_t session_id) {
+    if (!channel_ || session_id >= kMaxSessions) {
+        return nullptr;
+    }
+
+    // 首次收到该会话的请求时从通道中取出连接并缓存，之后无需加锁
+    auto& session = sessions_[session_id];
+    if (!session) {
+        std::lock_guard<std::mutex> lock(channel_->mutex);
+        session = channel_->connections[session_id];
+        if (!session) {
+            return nullptr;
+        }
+    }
+
+    return session->request_queue.Front();
+}
+
+void InprocServerTransport::ReleaseRequest(uint32_t session_id) {
+    sessions_[session_id]->request_queue.PopFront();
+}
+
+RpcFrame* InprocServerTransport::ReserveResponse(uint32_t session_id) {
+    if (!channel_ || session_id >= kMaxSessions || !sessions_[session_id]) {
+        return nullptr;
+    }
+    return sessions_[session_id]->response_queue.Reserve();
+}
+
+void InprocServerTransport::CommitResponse(uint32_t session_id) {
+    InprocConnection& connection = *sessions_[session_id];
+    connection.response_queue.CommitReserved();
+
+    connection.response_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (connection.client_waiting.load(std::memory_order_seq_cst) != 0) {
+        FutexWakePrivate(&connection.response_seq, 1);
+    }
+}
+
+void InprocServerTransport::MarkReady(uint32_t session_id) {
+    if (channel_ && session_id < kMaxSessions) {
+        channel_->ready_bitmap.fetch_or(1ULL << session_id, std::memory_order_release);
+    }
+}
+
+size_t InprocServerTransport::ReapSessions() {
+    if (!channel_) {
+        return 0;
+    }
+
+    size_t reaped = 0;
+    std::lock_guard<std::mutex> lock(channel_->mutex);
+    for (uint32_t i = 0; i < kMaxSessions; ++i) {
+        auto& connection = channel_->connections[i];
+        if (connection && connection->closed.load(std::memory_order_acquire)) {
+            connection.reset();
+            sessions_[i].reset();
+            ++reaped;
+        }
+    }
+    return reaped;
+}
+
+size_t InprocServerTransport::ActiveSessionCount() const {
+    if (!channel_) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(channel_->mutex);
+    return static_cast<size_t>(std::count_if(channel_->connections.begin(), channel_->connections.end(),
+                                             [](const auto& c) { return c != nullptr; }));
+}
+
+void InprocServerTransport::Wake() {
+    if (channel_) {
+        channel_->ready_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWakePrivate(&channel_->ready_seq, INT_MAX);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// InprocClientTransport
+// ---------------------------------------------------------------------------
+
+InprocClientTransport::InprocClientTransport(const std::string& channel_name, const RpcConfig& config)
+    : channel_name_(channel_name),
+      config_(config) {}
+
+InprocClientTransport::~InprocClientTransport() {
+    Close();
+}
+
+bool InprocClientTransport::Open() {
+    if (IsOpen()) {
+        return true;
+    }
+
+    channel_ = InprocRegistry::Instance().Find(channel_name_);
+    if (!channel_) {
+        return false;
+    }
+
+    auto connection = std::make_shared<InprocConnection>();
+    if (!connection->request_queue.Init(config_.request_queue_size) ||
+        !connection->response_queue.Init(config_.response_queue_size)) {
+        std::cerr << "错误: 无法创建进程内队列" << std::endl;
+        channel_.reset();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(channel_->mutex);
+    auto it = std::find(channel_->connections.begin(), channel_->connections.end(), nullptr);
+    if (it == channel_->connections.end()) {
+        std::cerr << "错误: 会话槽位已满" << std::endl;
+        channel_.reset();
+        return false;
+    }
+
+    *it = connection;
+    session_id_ = static_cast<uint32_t>(it - channel_->connections.begin());
+    connection_ = std::move(connection);
+    return true;
+}
+
+void InprocClientTransport::Close() {
+    if (connection_) {
+        connection_->closed.store(true, std::memory_order_release);
+        connection_.reset();
+    }
+    channel_.reset();
+}
+
+RpcFrame* InprocClientTransport::ReserveRequest() {
+    if (!IsOpen() || channel_->closed.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return connection_->request_queue.Reserve();
+}
+
+bool InprocClientTransport::CommitRequest() {
+    connection_->request_queue.CommitReserved();
+
+    // 位已置位说明服务端尚未取走上一次通知,无需重复唤醒
+    const uint64_t bit = 1ULL << session_id_;
+    const uint64_t prev = channel_->ready_bitmap.fetch_or(bit, std::memory_order_seq_cst);
+    if ((prev & bit) == 0 && channel_->server_waiting.load(std::memory_order_seq_cst) != 0) {
+        channel_->ready_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWakePrivate(&channel_->ready_seq, 1);
+    }
+    return true;
+}
+
+const RpcFrame* InprocClientTransport::PeekResponse(std::chrono::milliseconds timeout) {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+
+    const RpcFrame* frame = connection_->response_queue.Front();
+    if (frame != nullptr) {
+        return frame;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    connection_->client_waiting.store(1, std::memory_order_seq_cst);
+    while (true) {
+        const uint32_t seq = connection_->response_seq.load(std::memory_order_seq_cst);
+        frame = connection_->response_queue.Front();
+        if (frame != nullptr) {
+            break;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            break;
+        }
+        FutexWaitPrivate(&connection_->response_seq, seq,
+                         std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+    }
+    connection_->client_waiting.store(0, std::memory_order_relaxed);
+
+    return frame;
+}
+
+void InprocClientTransport::ReleaseResponse() {
+    connection_->response_queue.PopFront();
+}
+
+void InprocClientTransport::Wake() {
+    if (IsOpen()) {
+        connection_->response_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWakePrivate(&connection_->response_seq, INT_MAX);
+    }
+}
+
+} // namespace rpc
+} // namespace omnirt
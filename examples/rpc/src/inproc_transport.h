@@ -0,0 +1,92 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC进程内传输
+// 与共享内存传输结构相同: 每个客户端一对SPSC队列，客户端置位就绪位图后通过futex唤醒服务端。
+// 区别在于队列位于进程堆上、通道通过进程内注册表查找，因此只能在同一进程内通信，
+// 适合单元测试和不希望创建共享内存对象的场景。
+
+#pragma once
+
+#include "transport.h"
+#include "../../../src/common/util/bounded_spsc_lockfree_queue.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace omnirt {
+namespace rpc {
+
+/**
+ * @brief 进程内通道(内部结构)
+ */
+struct InprocChannel;
+
+/**
+ * @brief 进程内连接(内部结构)
+ */
+struct InprocConnection;
+
+/**
+ * @brief 进程内服务端传输
+ *
+ * 同一进程中同一通道名称只能有一个服务端。
+ */
+class InprocServerTransport : public ServerTransport {
+public:
+    InprocServerTransport(const std::string& channel_name, const RpcConfig& config);
+    ~InprocServerTransport() override;
+
+    InprocServerTransport(const InprocServerTransport&) = delete;
+    InprocServerTransport& operator=(const InprocServerTransport&) = delete;
+
+    bool Init() override;
+    void Close() override;
+    uint64_t WaitReady(std::chrono::milliseconds timeout) override;
+    const RpcFrame* PeekRequest(uint32_t session_id) override;
+    void ReleaseRequest(uint32_t session_id) override;
+    RpcFrame* ReserveResponse(uint32_t session_id) override;
+    void CommitResponse(uint32_t session_id) override;
+    void MarkReady(uint32_t session_id) override;
+    size_t ReapSessions() override;
+    size_t ActiveSessionCount() const override;
+    void Wake() override;
+
+private:
+    std::string channel_name_;
+    RpcConfig config_;
+    std::shared_ptr<InprocChannel> channel_;
+    std::array<std::shared_ptr<InprocConnection>, kMaxSessions> sessions_;  ///< 服务端线程本地缓存的连接
+};
+
+/**
+ * @brief 进程内客户端传输
+ */
+class InprocClientTransport : public ClientTransport {
+public:
+    InprocClientTransport(const std::string& channel_name, const RpcConfig& config);
+    ~InprocClientTransport() override;
+
+    InprocClientTransport(const InprocClientTransport&) = delete;
+    InprocClientTransport& operator=(const InprocClientTransport&) = delete;
+
+    bool Open() override;
+    void Close() override;
+    bool IsOpen() const override { return connection_ != nullptr; }
+    RpcFrame* ReserveRequest() override;
+    bool CommitRequest() override;
+    const RpcFrame* PeekResponse(std::chrono::milliseconds timeout) override;
+    void ReleaseResponse() override;
+    void Wake() override;
+
+private:
+    std::string channel_name_;
+    RpcConfig config_;
+    std::shared_ptr<InprocChannel> channel_;
+    std::shared_ptr<InprocConnection> connection_;
+    uint32_t session_id_ = 0;
+};
+
+} // namespace rpc
+} // namespace omnirt
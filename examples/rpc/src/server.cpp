@@ -3,12 +3,35 @@
 // RPC服务端实现文件
 
 #include "server.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 namespace omnirt {
 namespace rpc {
 
+namespace {
+
+/// 服务端无请求时的最长等待时间
+constexpr std::chrono::milliseconds kWaitReadyTimeout{100};
+/// 检测客户端存活状态的周期
+constexpr std::chrono::milliseconds kReapInterval{200};
+/// 单个会话每轮最多处理的请求数,避免单个繁忙客户端饿死其他会话
+constexpr uint32_t kMaxRequestsPerRound = 64;
+
+/**
+ * @brief 将错误信息写入响应帧，超出负载容量的部分被截断
+ */
+void WriteErrorFrame(RpcFrame* response, ErrorCode error_code, const std::string& error_msg) {
+    const size_t size = std::min<size_t>(error_msg.size(), kMaxFramePayloadSize);
+    std::memcpy(response->payload, error_msg.data(), size);
+    response->header.error_code = error_code;
+    response->header.payload_size = static_cast<uint32_t>(size);
+}
+
+} // namespace
+
 /**
  * @brief 构造函数
  * 
@@ -18,9 +41,9 @@ namespace rpc {
 Server::Server(const std::string& channel_name, const RpcConfig& config)
     : channel_name_(channel_name),
       config_(config) {
-    // 初始化共享内存队列
-    if (!InitSharedMemoryQueues()) {
-        throw RpcException("无法初始化共享内存队列", ErrorCode::CONNECTION_ERROR);
+    // 初始化传输层
+    if (!InitTransport()) {
+        throw RpcException("无法初始化RPC传输层", ErrorCode::CONNECTION_ERROR);
     }
 }
 
@@ -63,6 +86,9 @@ void Server::RunInBackground() {
  */
 void Server::Stop() {
     running_.store(false);
+    if (sessions_) {
+        sessions_->Wake();
+    }
 }
 
 /**
@@ -74,109 +100,140 @@ void Server::WaitForStop() {
     }
 }
 
+/**
+ * @brief 获取当前已连接的客户端会话数量
+ */
+size_t Server::SessionCount() const {
+    return session_count_.load(std::memory_order_relaxed);
+}
+
 /**
  * @brief 处理RPC请求
  * 
- * @param request 请求消息
- * @return RpcMessage 响应消息
+ * @param request 请求帧
+ * @param[out] response 响应帧
  */
-RpcMessage Server::ProcessRequest(const RpcMessage& request) {
-    RpcMessage response;
-    response.header.message_id = request.header.message_id;
-    response.header.message_type = MessageType::RESPONSE;
-    response.method_name = request.method_name;
+void Server::ProcessRequest(const RpcFrame& request, RpcFrame* response) {
+    const uint32_t name_len = std::min<uint32_t>(request.header.method_name_len, kMaxFrameMethodNameLen - 1);
+    const uint32_t payload_size = std::min<uint32_t>(request.header.payload_size, kMaxFramePayloadSize);
     
+    response->header = request.header;
+    response->header.message_type = MessageType::RESPONSE;
+    response->header.method_name_len = name_len;
+    std::memcpy(response->method_name, request.method_name, name_len);
+    response->method_name[name_len] = '\0';
+    
+    const std::string method_name(request.method_name, name_len);
     try {
         // 查找方法处理器
         std::lock_guard<std::mutex> lock(handlers_mutex_);
-        auto it = method_handlers_.find(request.method_name);
+        auto it = method_handlers_.find(method_name);
         
         if (it == method_handlers_.end()) {
             // 方法未找到
-            response.header.error_code = ErrorCode::METHOD_NOT_FOUND;
-            std::string error_msg = "未找到方法: " + request.method_name;
-            response.payload.resize(error_msg.size());
-            std::memcpy(response.payload.data(), error_msg.data(), error_msg.size());
+            WriteErrorFrame(response, ErrorCode::METHOD_NOT_FOUND, "未找到方法: " + method_name);
         } else {
-            // 调用方法处理器
-            response.payload = it->second->Invoke(request.payload);
-            response.header.error_code = ErrorCode::SUCCESS;
+            // 调用方法处理器，参数和返回值都直接在传输层提供的帧中读写
+            const size_t size = it->second->Invoke(request.payload, payload_size,
+                                                   response->payload, kMaxFramePayloadSize);
+            response->header.error_code = ErrorCode::SUCCESS;
+            response->header.payload_size = static_cast<uint32_t>(size);
         }
     } catch (const RpcException& e) {
         // RPC异常
-        response.header.error_code = e.GetErrorCode();
-        std::string error_msg = e.what();
-        response.payload.resize(error_msg.size());
-        std::memcpy(response.payload.data(), error_msg.data(), error_msg.size());
+        WriteErrorFrame(response, e.GetErrorCode(), e.what());
     } catch (const std::exception& e) {
         // 其他异常
-        response.header.error_code = ErrorCode::EXECUTION_ERROR;
-        std::string error_msg = e.what();
-        response.payload.resize(error_msg.size());
-        std::memcpy(response.payload.data(), error_msg.data(), error_msg.size());
+        WriteErrorFrame(response, ErrorCode::EXECUTION_ERROR, e.what());
     } catch (...) {
         // 未知异常
-        response.header.error_code = ErrorCode::UNKNOWN_ERROR;
-        std::string error_msg = "未知错误";
-        response.payload.resize(error_msg.size());
-        std::memcpy(response.payload.data(), error_msg.data(), error_msg.size());
+        WriteErrorFrame(response, ErrorCode::UNKNOWN_ERROR, "未知错误");
     }
-    
-    response.header.payload_size = static_cast<uint32_t>(response.payload.size());
-    
-    return response;
 }
 
 /**
  * @brief 处理请求循环
  */
 void Server::ProcessLoop() {
-    RpcMessage request;
+    auto last_reap = std::chrono::steady_clock::now();
     
     while (running_.load()) {
-        // 尝试从请求队列中取出请求
-        if (request_queue_->Dequeue(&request)) {
-            // 处理请求
-            RpcMessage response = ProcessRequest(request);
-            
-            // 将响应发送到响应队列
-            if (!response_queue_->Enqueue(response)) {
-                std::cerr << "警告: 无法将响应入队，响应队列可能已满" << std::endl;
-            }
-        } else {
-            // 没有请求，短暂休眠避免CPU占用过高
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        // 等待任意会话就绪，只处理位图中标记的会话
+        uint64_t ready = sessions_->WaitReady(kWaitReadyTimeout);
+        while (ready != 0) {
+            const uint32_t session_id = static_cast<uint32_t>(__builtin_ctzll(ready));
+            ready &= ready - 1;
+            ProcessSession(session_id);
+        }
+        
+        // 定期回收已关闭或已崩溃的客户端会话
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_reap >= kReapInterval) {
+            sessions_->ReapSessions();
+            session_count_.store(sessions_->ActiveSessionCount(), std::memory_order_relaxed);
+            last_reap = now;
         }
     }
 }
 
 /**
- * @brief 初始化共享内存队列
+ * @brief 处理单个会话中的待处理请求
+ * 
+ * @param session_id 会话ID
+ */
+void Server::ProcessSession(uint32_t session_id) {
+    uint32_t processed = 0;
+    
+    while (processed < kMaxRequestsPerRound) {
+        const RpcFrame* request = sessions_->PeekRequest(session_id);
+        if (request == nullptr) {
+            break;
+        }
+        
+        // 心跳仅用于确认连接，无需响应
+        if (request->header.message_type == MessageType::HEARTBEAT) {
+            sessions_->ReleaseRequest(session_id);
+            ++processed;
+            continue;
+        }
+        
+        // 响应队列已满时保留请求并重新标记就绪，等待客户端取走响应后再处理
+        RpcFrame* response = sessions_->ReserveResponse(session_id);
+        if (response == nullptr) {
+            sessions_->MarkReady(session_id);
+            return;
+        }
+        
+        ProcessRequest(*request, response);
+        sessions_->ReleaseRequest(session_id);
+        sessions_->CommitResponse(session_id);
+        ++processed;
+    }
+    
+    // 本轮未处理完，重新标记就绪，下一轮继续处理
+    if (processed == kMaxRequestsPerRound) {
+        sessions_->MarkReady(session_id);
+    }
+}
+
+/**
+ * @brief 按配置创建并初始化传输层
  * 
  * @return true 初始化成功
  * @return false 初始化失败
  */
-bool Server::InitSharedMemoryQueues() {
+bool Server::InitTransport() {
     try {
-        // 初始化请求队列（服务端为消费者）
-        request_queue_ = std::make_unique<RequestQueue>();
-        std::string request_queue_name = "/omnirt_rpc_req_" + channel_name_;
-        if (!request_queue_->Init(request_queue_name, config_.request_queue_size, true, true)) {
-            std::cerr << "错误: 无法初始化请求队列" << std::endl;
-            return false;
-        }
-        
-        // 初始化响应队列（服务端为生产者）
-        response_queue_ = std::make_unique<ResponseQueue>();
-        std::string response_queue_name = "/omnirt_rpc_resp_" + channel_name_;
-        if (!response_queue_->Init(response_queue_name, config_.response_queue_size, true, true)) {
-            std::cerr << "错误: 无法初始化响应队列" << std::endl;
+        sessions_ = CreateServerTransport(channel_name_, config_);
+        if (!sessions_ || !sessions_->Init()) {
+            std::cerr << "错误: 无法初始化" << TransportTypeName(config_.transport) << "传输" << std::endl;
+            sessions_.reset();
             return false;
         }
         
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "初始化共享内存队列时发生异常: " << e.what() << std::endl;
+        std::cerr << "初始化传输层时发生异常: " << e.what() << std::endl;
         return false;
     }
 }
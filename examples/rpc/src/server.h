@@ -7,7 +7,7 @@
 
 #include "common.h"
 #include "binary_serializer.h"
-#include "../../../src/common/util/shm_bounded_spsc_lockfree_queue.h"
+#include "transport.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -22,14 +22,16 @@ namespace rpc {
 /**
  * @brief RPC服务端类
  * 
- * 基于共享内存的RPC服务器实现，负责管理RPC方法并处理客户端请求
+ * RPC服务器实现，负责管理RPC方法并处理客户端请求。
+ * 每个客户端连接对应一个会话，服务端按就绪位图在会话间分发请求。
+ * 底层传输由RpcConfig::transport选择(共享内存、Unix域套接字或进程内队列)。
  */
 class Server {
 public:
     /**
      * @brief 构造函数
      * 
-     * @param channel_name RPC通道名称，用于标识共享内存
+     * @param channel_name RPC通道名称，用于标识传输通道
      * @param config RPC配置参数
      */
     explicit Server(const std::string& channel_name, const RpcConfig& config = RpcConfig());
@@ -104,6 +106,13 @@ public:
      */
     void WaitForStop();
     
+    /**
+     * @brief 获取当前已连接的客户端会话数量
+     * 
+     * @return size_t 会话数量
+     */
+    size_t SessionCount() const;
+    
 private:
     /**
      * @brief 方法处理器基类
@@ -115,10 +124,15 @@ private:
         /**
          * @brief 调用方法
          * 
+         * 参数直接从请求帧中反序列化，返回值直接序列化到响应帧中。
+         * 
          * @param payload 参数数据
-         * @return std::vector<uint8_t> 返回值数据
+         * @param size 参数数据大小
+         * @param out 返回值缓冲区
+         * @param capacity 返回值缓冲区容量
+         * @return size_t 返回值数据大小
          */
-        virtual std::vector<uint8_t> Invoke(const std::vector<uint8_t>& payload) = 0;
+        virtual size_t Invoke(const uint8_t* payload, size_t size, uint8_t* out, size_t capacity) = 0;
     };
     
     /**
@@ -142,19 +156,22 @@ private:
          * @brief 调用方法
          * 
          * @param payload 参数数据
-         * @return std::vector<uint8_t> 返回值数据
+         * @param size 参数数据大小
+         * @param out 返回值缓冲区
+         * @param capacity 返回值缓冲区容量
+         * @return size_t 返回值数据大小
          */
-        std::vector<uint8_t> Invoke(const std::vector<uint8_t>& payload) override {
+        size_t Invoke(const uint8_t* payload, size_t size, uint8_t* out, size_t capacity) override {
             BinarySerializer serializer;
             
             // 反序列化参数
-            auto args = serializer.DeserializeAsTuple<Args...>(payload);
+            auto args = serializer.DeserializeAsTuple<std::decay_t<Args>...>(payload, size);
             
             // 调用函数
             R result = tuple_invoke(func_, args);
             
             // 序列化返回值
-            return serializer.Serialize(result);
+            return serializer.SerializeTo(out, capacity, result);
         }
         
     private:
@@ -181,19 +198,20 @@ private:
          * @brief 调用方法
          * 
          * @param payload 参数数据
-         * @return std::vector<uint8_t> 空数据
+         * @param size 参数数据大小
+         * @return size_t 始终为0
          */
-        std::vector<uint8_t> Invoke(const std::vector<uint8_t>& payload) override {
+        size_t Invoke(const uint8_t* payload, size_t size, uint8_t* /*out*/, size_t /*capacity*/) override {
             BinarySerializer serializer;
             
             // 反序列化参数
-            auto args = serializer.DeserializeAsTuple<Args...>(payload);
+            auto args = serializer.DeserializeAsTuple<std::decay_t<Args>...>(payload, size);
             
             // 调用函数
             tuple_invoke(func_, args);
             
-            // 返回空数据
-            return {};
+            // 无返回数据
+            return 0;
         }
         
     private:
@@ -203,10 +221,10 @@ private:
     /**
      * @brief 处理RPC请求
      * 
-     * @param request 请求消息
-     * @return RpcMessage 响应消息
+     * @param request 请求帧
+     * @param[out] response 响应帧，直接位于会话响应队列的槽位中
      */
-    RpcMessage ProcessRequest(const RpcMessage& request);
+    void ProcessRequest(const RpcFrame& request, RpcFrame* response);
     
     /**
      * @brief 处理请求循环
@@ -214,12 +232,19 @@ private:
     void ProcessLoop();
     
     /**
-     * @brief 初始化共享内存队列
+     * @brief 处理单个会话中的待处理请求
+     * 
+     * @param session_id 会话ID
+     */
+    void ProcessSession(uint32_t session_id);
+    
+    /**
+     * @brief 按配置创建并初始化传输层
      * 
      * @return true 初始化成功
      * @return false 初始化失败
      */
-    bool InitSharedMemoryQueues();
+    bool InitTransport();
     
 private:
     std::string channel_name_;    ///< RPC通道名称
@@ -228,11 +253,8 @@ private:
     std::unordered_map<std::string, std::unique_ptr<MethodHandlerBase>> method_handlers_; ///< 方法处理器映射
     std::mutex handlers_mutex_;   ///< 方法处理器映射的互斥锁
     
-    using RequestQueue = omnirt::common::util::ShmBoundedSpscLockfreeQueue<RpcMessage>;
-    using ResponseQueue = omnirt::common::util::ShmBoundedSpscLockfreeQueue<RpcMessage>;
-    
-    std::unique_ptr<RequestQueue> request_queue_;  ///< 请求队列
-    std::unique_ptr<ResponseQueue> response_queue_; ///< 响应队列
+    std::unique_ptr<ServerTransport> sessions_; ///< 服务端传输(客户端会话管理)
+    std::atomic<size_t> session_count_{0};   ///< 当前会话数量(供其他线程查询)
     
     std::atomic<bool> running_{false}; ///< 运行标志
     std::thread worker_thread_;       ///< 工作线程
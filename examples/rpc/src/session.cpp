@@ -0,0 +1,523 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC多客户端会话管理实现文件
+
+#include "session.h"
+#include "../../../src/common/util/futex_atomic.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+namespace omnirt {
+namespace rpc {
+
+namespace {
+
+using aimrt::common::util::futex;
+
+/**
+ * @brief 在共享内存中的32位原子变量上进行futex等待
+ *
+ * 控制块位于进程间共享的映射中,因此不能使用FUTEX_*_PRIVATE操作。
+ */
+void FutexWait(std::atomic<uint32_t>* word, uint32_t expected, std::chrono::nanoseconds timeout) {
+    if (timeout.count() <= 0) {
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+    futex(reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &ts);
+}
+
+void FutexWake(std::atomic<uint32_t>* word, int count) {
+    futex(reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, static_cast<uint32_t>(count));
+}
+
+/**
+ * @brief 检查进程是否存活
+ *
+ * kill(pid, 0)返回EPERM时进程存在但属于其他用户,同样视为存活。
+ */
+bool IsProcessAlive(int32_t pid) {
+    if (pid <= 0) {
+        return false;
+    }
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+/**
+ * @brief 映射会话控制块
+ */
+SessionControlBlock* MapControlBlock(int fd) {
+    void* addr = mmap(nullptr, sizeof(SessionControlBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+    return static_cast<SessionControlBlock*>(addr);
+}
+
+void UnlinkSessionQueues(const std::string& channel_name, uint32_t session_id, uint32_t generation) {
+    shm_unlink(SessionQueueName(channel_name, "req", session_id, generation).c_str());
+    shm_unlink(SessionQueueName(channel_name, "resp", session_id, generation).c_str());
+}
+
+} // namespace
+
+std::string SessionControlName(const std::string& channel_name) {
+    return "/omnirt_rpc_ctl_" + channel_name;
+}
+
+std::string SessionQueueName(const std::string& channel_name, const char* kind,
+                             uint32_t session_id, uint32_t generation) {
+    return "/omnirt_rpc_" + std::string(kind) + "_" + channel_name + "_" +
+           std::to_string(session_id) + "_" + std::to_string(generation);
+}
+
+// ---------------------------------------------------------------------------
+// SessionServer
+// ---------------------------------------------------------------------------
+
+SessionServer::SessionServer(const std::string& channel_name, const RpcConfig& config)
+    : channel_name_(channel_name),
+      config_(config),
+      control_name_(SessionControlName(channel_name)) {}
+
+SessionServer::~SessionServer() {
+    Close();
+}
+
+bool SessionServer::Init() {
+    if (control_ != nullptr) {
+        return false;
+    }
+
+    bool fresh = true;
+    control_fd_ = shm_open(control_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+    if (control_fd_ == -1) {
+        if (errno != EEXIST) {
+            std::cerr << "错误: 无法创建会话控制块: " << strerror(errno) << std::endl;
+            return false;
+        }
+        control_fd_ = shm_open(control_name_.c_str(), O_RDWR, 0666);
+        if (control_fd_ == -1) {
+            std::cerr << "错误: 无法打开会话控制块: " << strerror(errno) << std::endl;
+            return false;
+        }
+        fresh = false;
+    }
+
+    if (ftruncate(control_fd_, sizeof(SessionControlBlock)) == -1) {
+        std::cerr << "错误: 无法设置会话控制块大小: " << strerror(errno) << std::endl;
+        close(control_fd_);
+        control_fd_ = -1;
+        if (fresh) {
+            shm_unlink(control_name_.c_str());
+        }
+        return false;
+    }
+
+    control_ = MapControlBlock(control_fd_);
+    if (control_ == nullptr) {
+        std::cerr << "错误: 无法映射会话控制块: " << strerror(errno) << std::endl;
+        close(control_fd_);
+        control_fd_ = -1;
+        if (fresh) {
+            shm_unlink(control_name_.c_str());
+        }
+        return false;
+    }
+
+    // 控制块已存在: 若前一个服务端仍存活则拒绝启动,否则接管并清理其遗留的会话队列
+    if (!fresh && control_->magic == SessionControlBlock::kMagic &&
+        control_->version == SessionControlBlock::kVersion) {
+        const int32_t old_pid = control_->server_pid.load(std::memory_order_acquire);
+        if (old_pid != getpid() && IsProcessAlive(old_pid)) {
+            std::cerr << "错误: 通道 " << channel_name_ << " 已有服务端运行, pid=" << old_pid << std::endl;
+            munmap(control_, sizeof(SessionControlBlock));
+            control_ = nullptr;
+            close(control_fd_);
+            control_fd_ = -1;
+            return false;
+        }
+
+        for (uint32_t i = 0; i < kMaxSessions; ++i) {
+            SessionSlot& slot = control_->slots[i];
+            if (slot.state.load(std::memory_order_acquire) != static_cast<uint32_t>(SessionState::FREE)) {
+                UnlinkSessionQueues(channel_name_, i, slot.generation.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    new (control_) SessionControlBlock();
+    control_->version = SessionControlBlock::kVersion;
+    control_->max_sessions = kMaxSessions;
+    control_->server_pid.store(getpid(), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    control_->magic = SessionControlBlock::kMagic;
+
+    return true;
+}
+
+void SessionServer::Close() {
+    for (uint32_t i = 0; i < kMaxSessions; ++i) {
+        ReleaseSession(i, false);
+    }
+
+    if (control_ != nullptr) {
+        control_->server_pid.store(0, std::memory_order_release);
+        munmap(control_, sizeof(SessionControlBlock));
+        control_ = nullptr;
+        shm_unlink(control_name_.c_str());
+    }
+
+    if (control_fd_ != -1) {
+        close(control_fd_);
+        control_fd_ = -1;
+    }
+}
+
+uint64_t SessionServer::WaitReady(std::chrono::milliseconds timeout) {
+    if (control_ == nullptr) {
+        return 0;
+    }
+
+    uint64_t ready = control_->ready_bitmap.exchange(0, std::memory_order_acq_rel);
+    if (ready != 0) {
+        return ready;
+    }
+
+    // 先声明等待再复查位图,与客户端"置位后检查等待标志"配对,避免丢失唤醒
+    control_->server_waiting.store(1, std::memory_order_seq_cst);
+    const uint32_t seq = control_->ready_seq.load(std::memory_order_seq_cst);
+    ready = control_->ready_bitmap.exchange(0, std::memory_order_seq_cst);
+    if (ready == 0) {
+        FutexWait(&control_->ready_seq, seq, timeout);
+        ready = control_->ready_bitmap.exchange(0, std::memory_order_acq_rel);
+    }
+    control_->server_waiting.store(0, std::memory_order_relaxed);
+
+    return ready;
+}
+
+const RpcFrame* SessionServer::PeekRequest(uint32_t session_id) {
+    if (control_ == nullptr || session_id >= kMaxSessions) {
+        return nullptr;
+    }
+
+    SessionSlot& slot = control_->slots[session_id];
+    if (slot.state.load(std::memory_order_acquire) != static_cast<uint32_t>(SessionState::ACTIVE)) {
+        return nullptr;
+    }
+
+    // 槽位被新客户端重新注册后,需要按新代数重新附加队列
+    LocalSession& session = sessions_[session_id];
+    const uint32_t generation = slot.generation.load(std::memory_order_acquire);
+    if (!session.request_queue || session.generation != generation) {
+        ReleaseSession(session_id, false);
+        if (!AttachSession(session_id)) {
+            return nullptr;
+        }
+    }
+
+    return session.request_queue->Front();
+}
+
+void SessionServer::ReleaseRequest(uint32_t session_id) {
+    sessions_[session_id].request_queue->PopFront();
+}
+
+RpcFrame* SessionServer::ReserveResponse(uint32_t session_id) {
+    if (control_ == nullptr || session_id >= kMaxSessions) {
+        return nullptr;
+    }
+
+    LocalSession& session = sessions_[session_id];
+    if (!session.response_queue) {
+        return nullptr;
+    }
+    return session.response_queue->Reserve();
+}
+
+void SessionServer::CommitResponse(uint32_t session_id) {
+    sessions_[session_id].response_queue->CommitReserved();
+
+    SessionSlot& slot = control_->slots[session_id];
+    slot.response_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (slot.client_waiting.load(std::memory_order_seq_cst) != 0) {
+        FutexWake(&slot.response_seq, 1);
+    }
+}
+
+void SessionServer::MarkReady(uint32_t session_id) {
+    if (control_ != nullptr && session_id < kMaxSessions) {
+        control_->ready_bitmap.fetch_or(1ULL << session_id, std::memory_order_release);
+    }
+}
+
+size_t SessionServer::ReapSessions() {
+    if (control_ == nullptr) {
+        return 0;
+    }
+
+    size_t reaped = 0;
+    for (uint32_t i = 0; i < kMaxSessions; ++i) {
+        SessionSlot& slot = control_->slots[i];
+        const uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == static_cast<uint32_t>(SessionState::FREE)) {
+            continue;
+        }
+
+        bool reclaim = false;
+        if (state == static_cast<uint32_t>(SessionState::CLOSING)) {
+            reclaim = true;
+        } else {
+            const int32_t pid = slot.pid.load(std::memory_order_acquire);
+            reclaim = pid > 0 && !IsProcessAlive(pid);
+            if (reclaim) {
+                std::cerr << "警告: 客户端进程 " << pid << " 已退出, 回收会话 " << i << std::endl;
+            }
+        }
+
+        if (reclaim) {
+            ReleaseSession(i, false);
+            UnlinkSessionQueues(channel_name_, i, slot.generation.load(std::memory_order_relaxed));
+            slot.pid.store(0, std::memory_order_relaxed);
+            slot.state.store(static_cast<uint32_t>(SessionState::FREE), std::memory_order_release);
+            ++reaped;
+        }
+    }
+    return reaped;
+}
+
+size_t SessionServer::ActiveSessionCount() const {
+    return static_cast<size_t>(std::count_if(sessions_.begin(), sessions_.end(),
+                                             [](const LocalSession& s) { return s.request_queue != nullptr; }));
+}
+
+void SessionServer::Wake() {
+    if (control_ != nullptr) {
+        control_->ready_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWake(&control_->ready_seq, INT_MAX);
+    }
+}
+
+bool SessionServer::AttachSession(uint32_t session_id) {
+    SessionSlot& slot = control_->slots[session_id];
+    LocalSession& session = sessions_[session_id];
+    const uint32_t generation = slot.generation.load(std::memory_order_acquire);
+
+    auto request_queue = std::make_unique<FrameQueue>();
+    if (!request_queue->Init(SessionQueueName(channel_name_, "req", session_id, generation),
+                             slot.request_queue_size, true, false)) {
+        return false;
+    }
+
+    auto response_queue = std::make_unique<FrameQueue>();
+    if (!response_queue->Init(SessionQueueName(channel_name_, "resp", session_id, generation),
+                              slot.response_queue_size, true, false)) {
+        return false;
+    }
+
+    session.generation = generation;
+    session.request_queue = std::move(request_queue);
+    session.response_queue = std::move(response_queue);
+    return true;
+}
+
+void SessionServer::ReleaseSession(uint32_t session_id, bool unlink_queues) {
+    LocalSession& session = sessions_[session_id];
+    if (!session.request_queue && !session.response_queue) {
+        return;
+    }
+
+    session.request_queue.reset();
+    session.response_queue.reset();
+    if (unlink_queues) {
+        UnlinkSessionQueues(channel_name_, session_id, session.generation);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SessionClient
+// ---------------------------------------------------------------------------
+
+SessionClient::SessionClient(const std::string& channel_name, const RpcConfig& config)
+    : channel_name_(channel_name),
+      config_(config) {}
+
+SessionClient::~SessionClient() {
+    Close();
+}
+
+bool SessionClient::Open() {
+    if (IsOpen()) {
+        return true;
+    }
+
+    if (control_ == nullptr) {
+        control_fd_ = shm_open(SessionControlName(channel_name_).c_str(), O_RDWR, 0666);
+        if (control_fd_ == -1) {
+            return false;
+        }
+
+        struct stat sb;
+        if (fstat(control_fd_, &sb) == -1 || static_cast<size_t>(sb.st_size) < sizeof(SessionControlBlock)) {
+            close(control_fd_);
+            control_fd_ = -1;
+            return false;
+        }
+
+        control_ = MapControlBlock(control_fd_);
+        if (control_ == nullptr) {
+            close(control_fd_);
+            control_fd_ = -1;
+            return false;
+        }
+    }
+
+    if (control_->magic != SessionControlBlock::kMagic || control_->version != SessionControlBlock::kVersion) {
+        std::cerr << "错误: 会话控制块版本不匹配" << std::endl;
+        return false;
+    }
+
+    // 抢占空闲槽位
+    uint32_t session_id = kInvalidSession;
+    for (uint32_t i = 0; i < control_->max_sessions && i < kMaxSessions; ++i) {
+        uint32_t expected = static_cast<uint32_t>(SessionState::FREE);
+        if (control_->slots[i].state.compare_exchange_strong(expected, static_cast<uint32_t>(SessionState::CLAIMED),
+                                                             std::memory_order_acq_rel)) {
+            session_id = i;
+            break;
+        }
+    }
+    if (session_id == kInvalidSession) {
+        std::cerr << "错误: 会话槽位已满" << std::endl;
+        return false;
+    }
+
+    SessionSlot& slot = control_->slots[session_id];
+    slot.pid.store(getpid(), std::memory_order_release);
+    const uint32_t generation = slot.generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    slot.request_queue_size = config_.request_queue_size;
+    slot.response_queue_size = config_.response_queue_size;
+    slot.response_seq.store(0, std::memory_order_relaxed);
+    slot.client_waiting.store(0, std::memory_order_relaxed);
+
+    const std::string request_name = SessionQueueName(channel_name_, "req", session_id, generation);
+    const std::string response_name = SessionQueueName(channel_name_, "resp", session_id, generation);
+    shm_unlink(request_name.c_str());
+    shm_unlink(response_name.c_str());
+
+    request_queue_ = std::make_unique<FrameQueue>();
+    response_queue_ = std::make_unique<FrameQueue>();
+    if (!request_queue_->Init(request_name, config_.request_queue_size, true, true) ||
+        !response_queue_->Init(response_name, config_.response_queue_size, true, true)) {
+        std::cerr << "错误: 无法创建会话队列" << std::endl;
+        request_queue_.reset();
+        response_queue_.reset();
+        slot.pid.store(0, std::memory_order_relaxed);
+        slot.state.store(static_cast<uint32_t>(SessionState::FREE), std::memory_order_release);
+        return false;
+    }
+
+    slot.state.store(static_cast<uint32_t>(SessionState::ACTIVE), std::memory_order_release);
+    session_id_ = session_id;
+    return true;
+}
+
+void SessionClient::Close() {
+    if (IsOpen()) {
+        // 队列由客户端创建,析构时会自动删除共享内存对象
+        request_queue_.reset();
+        response_queue_.reset();
+        control_->slots[session_id_].state.store(static_cast<uint32_t>(SessionState::CLOSING),
+                                                 std::memory_order_release);
+        session_id_ = kInvalidSession;
+    }
+
+    if (control_ != nullptr) {
+        munmap(control_, sizeof(SessionControlBlock));
+        control_ = nullptr;
+    }
+
+    if (control_fd_ != -1) {
+        close(control_fd_);
+        control_fd_ = -1;
+    }
+}
+
+RpcFrame* SessionClient::ReserveRequest() {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+    return request_queue_->Reserve();
+}
+
+bool SessionClient::CommitRequest() {
+    request_queue_->CommitReserved();
+
+    // 位已置位说明服务端尚未取走上一次通知,无需重复唤醒
+    const uint64_t bit = 1ULL << session_id_;
+    const uint64_t prev = control_->ready_bitmap.fetch_or(bit, std::memory_order_seq_cst);
+    if ((prev & bit) == 0 && control_->server_waiting.load(std::memory_order_seq_cst) != 0) {
+        control_->ready_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWake(&control_->ready_seq, 1);
+    }
+    return true;
+}
+
+const RpcFrame* SessionClient::PeekResponse(std::chrono::milliseconds timeout) {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+
+    const RpcFrame* frame = response_queue_->Front();
+    if (frame != nullptr) {
+        return frame;
+    }
+
+    SessionSlot& slot = control_->slots[session_id_];
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    slot.client_waiting.store(1, std::memory_order_seq_cst);
+    while (true) {
+        const uint32_t seq = slot.response_seq.load(std::memory_order_seq_cst);
+        frame = response_queue_->Front();
+        if (frame != nullptr) {
+            break;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero()) {
+            break;
+        }
+        FutexWait(&slot.response_seq, seq, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+    }
+    slot.client_waiting.store(0, std::memory_order_relaxed);
+
+    return frame;
+}
+
+void SessionClient::ReleaseResponse() {
+    response_queue_->PopFront();
+}
+
+void SessionClient::Wake() {
+    if (IsOpen()) {
+        SessionSlot& slot = control_->slots[session_id_];
+        slot.response_seq.fetch_add(1, std::memory_order_seq_cst);
+        FutexWake(&slot.response_seq, INT_MAX);
+    }
+}
+
+} // namespace rpc
+} // namespace omnirt
@@ -0,0 +1,275 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC多客户端会话管理(共享内存传输)
+// 服务端通过一块共享内存控制块管理多个客户端会话:
+// 1. 客户端在控制块中抢占一个空闲槽位完成注册
+// 2. 每个会话拥有独立的SPSC请求/响应队列对,由客户端创建、服务端附加
+// 3. 客户端入队请求后在就绪位图中置位,服务端通过futex等待位图变化,无需轮询所有会话
+// 4. 服务端定期检测客户端PID存活状态,回收崩溃客户端遗留的会话和共享内存
+// 5. 请求和响应直接在队列槽位中原地读写,避免整帧拷贝
+
+#pragma once
+
+#include "transport.h"
+#include "../../../src/common/util/shm_bounded_spsc_lockfree_queue.h"
+
+#include <sys/types.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace omnirt {
+namespace rpc {
+
+/**
+ * @brief 会话槽位状态
+ */
+enum class SessionState : uint32_t {
+    FREE = 0,     ///< 空闲,可被客户端抢占
+    CLAIMED = 1,  ///< 已被客户端抢占,正在创建队列
+    ACTIVE = 2,   ///< 队列已就绪,可以通信
+    CLOSING = 3   ///< 客户端已主动关闭,等待服务端回收
+};
+
+/**
+ * @brief 控制块中的会话槽位
+ */
+struct alignas(64) SessionSlot {
+    std::atomic<uint32_t> state;             ///< 槽位状态(SessionState)
+    std::atomic<int32_t> pid;                ///< 持有该槽位的客户端PID
+    std::atomic<uint32_t> generation;        ///< 槽位代数,每次重新注册递增,用于区分队列名称
+    std::atomic<uint32_t> response_seq;      ///< 响应序号,客户端在其上进行futex等待
+    std::atomic<uint32_t> client_waiting;    ///< 客户端是否正在futex等待响应
+    uint32_t request_queue_size;             ///< 请求队列容量
+    uint32_t response_queue_size;            ///< 响应队列容量
+};
+
+/**
+ * @brief 会话控制块,位于共享内存中,由服务端创建
+ */
+struct SessionControlBlock {
+    static constexpr uint64_t kMagic = 0x4F4D4E4952504353ULL;  ///< "OMNIRPCS"
+    static constexpr uint32_t kVersion = 1;
+
+    uint64_t magic;                          ///< 魔数
+    uint32_t version;                        ///< 布局版本
+    uint32_t max_sessions;                   ///< 槽位数量
+    std::atomic<int32_t> server_pid;         ///< 服务端PID
+
+    alignas(64) std::atomic<uint64_t> ready_bitmap;  ///< 就绪位图,第i位表示会话i有待处理请求
+    std::atomic<uint32_t> ready_seq;                 ///< 就绪序号,服务端在其上进行futex等待
+    std::atomic<uint32_t> server_waiting;            ///< 服务端是否正在futex等待
+
+    SessionSlot slots[kMaxSessions];         ///< 会话槽位
+};
+
+using FrameQueue = omnirt::common::util::ShmBoundedSpscLockfreeQueue<RpcFrame>;
+
+/**
+ * @brief 生成会话控制块的共享内存名称
+ */
+std::string SessionControlName(const std::string& channel_name);
+
+/**
+ * @brief 生成会话请求/响应队列的共享内存名称
+ */
+std::string SessionQueueName(const std::string& channel_name, const char* kind,
+                             uint32_t session_id, uint32_t generation);
+
+/**
+ * @brief 服务端会话管理器
+ *
+ * 创建会话控制块,附加客户端创建的队列,按就绪位图分发请求,
+ * 并回收主动关闭或已崩溃的客户端会话。
+ * 除Wake外,所有方法只能在服务端处理线程中调用。
+ */
+class SessionServer : public ServerTransport {
+public:
+    SessionServer(const std::string& channel_name, const RpcConfig& config);
+    ~SessionServer() override;
+
+    SessionServer(const SessionServer&) = delete;
+    SessionServer& operator=(const SessionServer&) = delete;
+
+    /**
+     * @brief 创建(或在前一个服务端崩溃后接管)会话控制块
+     *
+     * @return true 初始化成功
+     * @return false 共享内存访问失败或已有存活的服务端
+     */
+    bool Init() override;
+
+    /**
+     * @brief 关闭所有会话并删除控制块
+     */
+    void Close() override;
+
+    /**
+     * @brief 等待至少一个会话就绪
+     *
+     * @param timeout 最长等待时间
+     * @return uint64_t 就绪会话位图,超时返回0
+     */
+    uint64_t WaitReady(std::chrono::milliseconds timeout) override;
+
+    /**
+     * @brief 获取指定会话队首的请求帧,供服务端原地读取
+     *
+     * 帧在调用ReleaseRequest之前保持有效。
+     *
+     * @param session_id 会话ID
+     * @return const RpcFrame* 请求帧,会话无效或请求队列为空时返回nullptr
+     */
+    const RpcFrame* PeekRequest(uint32_t session_id) override;
+
+    /**
+     * @brief 释放通过PeekRequest读取的请求帧
+     *
+     * @param session_id 会话ID
+     */
+    void ReleaseRequest(uint32_t session_id) override;
+
+    /**
+     * @brief 获取指定会话响应队列的空闲槽位,供服务端原地写入响应
+     *
+     * @param session_id 会话ID
+     * @return RpcFrame* 响应帧槽位,会话无效或响应队列已满时返回nullptr
+     */
+    RpcFrame* ReserveResponse(uint32_t session_id) override;
+
+    /**
+     * @brief 发布通过ReserveResponse写入的响应,并在客户端等待时唤醒它
+     *
+     * @param session_id 会话ID
+     */
+    void CommitResponse(uint32_t session_id) override;
+
+    /**
+     * @brief 重新标记会话就绪(用于单轮处理未取完请求的会话)
+     */
+    void MarkReady(uint32_t session_id) override;
+
+    /**
+     * @brief 检测客户端存活状态,回收已关闭或已崩溃的会话
+     *
+     * @return size_t 本次回收的会话数量
+     */
+    size_t ReapSessions() override;
+
+    /**
+     * @brief 当前已附加的会话数量
+     */
+    size_t ActiveSessionCount() const override;
+
+    /**
+     * @brief 唤醒阻塞在WaitReady中的服务端线程,可在任意线程调用
+     */
+    void Wake() override;
+
+private:
+    struct LocalSession {
+        uint32_t generation = 0;
+        std::unique_ptr<FrameQueue> request_queue;
+        std::unique_ptr<FrameQueue> response_queue;
+    };
+
+    bool AttachSession(uint32_t session_id);
+    void ReleaseSession(uint32_t session_id, bool unlink_queues);
+
+    std::string channel_name_;
+    RpcConfig config_;
+    std::string control_name_;
+    int control_fd_ = -1;
+    SessionControlBlock* control_ = nullptr;
+    std::array<LocalSession, kMaxSessions> sessions_;
+};
+
+/**
+ * @brief 客户端会话
+ *
+ * 在服务端控制块中注册一个会话,并创建该会话专用的请求/响应队列。
+ * ReserveRequest/CommitRequest只能在单个生产线程中调用,
+ * PeekResponse/ReleaseResponse只能在单个消费线程中调用。
+ */
+class SessionClient : public ClientTransport {
+public:
+    SessionClient(const std::string& channel_name, const RpcConfig& config);
+    ~SessionClient() override;
+
+    SessionClient(const SessionClient&) = delete;
+    SessionClient& operator=(const SessionClient&) = delete;
+
+    /**
+     * @brief 注册会话
+     *
+     * @return true 注册成功
+     * @return false 服务端不存在、槽位已满或队列创建失败
+     */
+    bool Open() override;
+
+    /**
+     * @brief 注销会话,服务端会在下一次回收时释放槽位
+     */
+    void Close() override;
+
+    /**
+     * @brief 会话是否已注册
+     */
+    bool IsOpen() const override { return session_id_ != kInvalidSession; }
+
+    /**
+     * @brief 会话ID
+     */
+    uint32_t SessionId() const { return session_id_; }
+
+    /**
+     * @brief 获取请求队列的空闲槽位,供调用方原地写入请求
+     *
+     * @return RpcFrame* 请求帧槽位,会话未注册或请求队列已满时返回nullptr
+     */
+    RpcFrame* ReserveRequest() override;
+
+    /**
+     * @brief 发布通过ReserveRequest写入的请求并通知服务端
+     *
+     * @return true 始终成功
+     */
+    bool CommitRequest() override;
+
+    /**
+     * @brief 等待并获取队首的响应帧,供调用方原地读取
+     *
+     * 帧在调用ReleaseResponse之前保持有效。
+     *
+     * @param timeout 最长等待时间
+     * @return const RpcFrame* 响应帧,超时或会话未注册时返回nullptr
+     */
+    const RpcFrame* PeekResponse(std::chrono::milliseconds timeout) override;
+
+    /**
+     * @brief 释放通过PeekResponse读取的响应帧
+     */
+    void ReleaseResponse() override;
+
+    /**
+     * @brief 唤醒阻塞在PeekResponse中的线程,可在任意线程调用
+     */
+    void Wake() override;
+
+private:
+    static constexpr uint32_t kInvalidSession = UINT32_MAX;
+
+    std::string channel_name_;
+    RpcConfig config_;
+    int control_fd_ = -1;
+    SessionControlBlock* control_ = nullptr;
+    uint32_t session_id_ = kInvalidSession;
+    std::unique_ptr<FrameQueue> request_queue_;
+    std::unique_ptr<FrameQueue> response_queue_;
+};
+
+} // namespace rpc
+} // namespace omnirt
@@ -0,0 +1,88 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC传输层公共实现文件
+
+#include "transport.h"
+#include "inproc_transport.h"
+#include "session.h"
+#include "uds_transport.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace omnirt {
+namespace rpc {
+
+bool EncodeFrame(const RpcMessage& message, RpcFrame* frame) {
+    if (message.method_name.size() >= kMaxFrameMethodNameLen || message.payload.size() > kMaxFramePayloadSize) {
+        return false;
+    }
+
+    frame->header = message.header;
+    frame->header.method_name_len = static_cast<uint32_t>(message.method_name.size());
+    frame->header.payload_size = static_cast<uint32_t>(message.payload.size());
+    std::memcpy(frame->method_name, message.method_name.data(), message.method_name.size());
+    frame->method_name[message.method_name.size()] = '\0';
+    if (!message.payload.empty()) {
+        std::memcpy(frame->payload, message.payload.data(), message.payload.size());
+    }
+    return true;
+}
+
+void DecodeFrame(const RpcFrame& frame, RpcMessage* message) {
+    const uint32_t name_len = std::min<uint32_t>(frame.header.method_name_len, kMaxFrameMethodNameLen - 1);
+    const uint32_t payload_size = std::min<uint32_t>(frame.header.payload_size, kMaxFramePayloadSize);
+
+    message->header = frame.header;
+    message->method_name.assign(frame.method_name, name_len);
+    message->payload.assign(frame.payload, frame.payload + payload_size);
+}
+
+const char* TransportTypeName(TransportType type) {
+    switch (type) {
+        case TransportType::SHM:
+            return "shm";
+        case TransportType::UDS:
+            return "uds";
+        case TransportType::INPROC:
+            return "inproc";
+    }
+    return "unknown";
+}
+
+bool ParseTransportType(const std::string& name, TransportType* type) {
+    for (TransportType item : {TransportType::SHM, TransportType::UDS, TransportType::INPROC}) {
+        if (name == TransportTypeName(item)) {
+            *type = item;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<ServerTransport> CreateServerTransport(const std::string& channel_name, const RpcConfig& config) {
+    switch (config.transport) {
+        case TransportType::SHM:
+            return std::make_unique<SessionServer>(channel_name, config);
+        case TransportType::UDS:
+            return std::make_unique<UdsServerTransport>(channel_name, config);
+        case TransportType::INPROC:
+            return std::make_unique<InprocServerTransport>(channel_name, config);
+    }
+    return nullptr;
+}
+
+std::unique_ptr<ClientTransport> CreateClientTransport(const std::string& channel_name, const RpcConfig& config) {
+    switch (config.transport) {
+        case TransportType::SHM:
+            return std::make_unique<SessionClient>(channel_name, config);
+        case TransportType::UDS:
+            return std::make_unique<UdsClientTransport>(channel_name, config);
+        case TransportType::INPROC:
+            return std::make_unique<InprocClientTransport>(channel_name, config);
+    }
+    return nullptr;
+}
+
+} // namespace rpc
+} // namespace omnirt
@@ -0,0 +1,231 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC传输层接口
+// 服务端与客户端只依赖这里定义的帧格式和传输接口，具体的传输方式可替换:
+// 1. SHM: 共享内存SPSC队列，帧在队列槽位中原地读写(session.h)
+// 2. UDS: Unix域套接字，按帧头中的长度分帧(uds_transport.h)
+// 3. INPROC: 进程内SPSC队列，用于测试和同进程通信(inproc_transport.h)
+
+#pragma once
+
+#include "common.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace omnirt {
+namespace rpc {
+
+/// 最大连接数量,受就绪位图宽度限制
+constexpr uint32_t kMaxSessions = 64;
+/// 帧中方法名的最大长度(含结尾'\0')
+constexpr uint32_t kMaxFrameMethodNameLen = 64;
+/// 帧的总大小
+constexpr uint32_t kFrameSize = 4096;
+/// 帧可承载的最大负载
+constexpr uint32_t kMaxFramePayloadSize = kFrameSize - sizeof(RpcHeader) - kMaxFrameMethodNameLen;
+
+/**
+ * @brief 定长RPC帧
+ *
+ * RpcMessage内部持有std::string和std::vector,其堆指针在其他进程中无效,
+ * 因此传输时统一使用该定长、平凡可复制的帧结构。
+ * 共享内存和进程内传输直接在队列槽位中读写该结构，套接字传输只发送其中的有效部分。
+ */
+struct RpcFrame {
+    RpcHeader header;                          ///< 消息头部
+    char method_name[kMaxFrameMethodNameLen];  ///< 方法名
+    uint8_t payload[kMaxFramePayloadSize];     ///< 负载数据
+};
+
+static_assert(std::is_trivially_copyable<RpcFrame>::value, "RpcFrame必须是平凡可复制类型");
+static_assert(sizeof(RpcFrame) == kFrameSize, "RpcFrame大小不符合预期");
+
+/**
+ * @brief 将RpcMessage编码为帧
+ *
+ * @param message 源消息
+ * @param[out] frame 目标帧
+ * @return true 编码成功
+ * @return false 方法名或负载超出帧容量
+ */
+bool EncodeFrame(const RpcMessage& message, RpcFrame* frame);
+
+/**
+ * @brief 将帧解码为RpcMessage
+ *
+ * @param frame 源帧
+ * @param[out] message 目标消息
+ */
+void DecodeFrame(const RpcFrame& frame, RpcMessage* message);
+
+/**
+ * @brief 传输方式名称
+ */
+const char* TransportTypeName(TransportType type);
+
+/**
+ * @brief 按名称解析传输方式(shm/uds/inproc)
+ *
+ * @param name 名称
+ * @param[out] type 传输方式
+ * @return true 解析成功
+ * @return false 名称无效
+ */
+bool ParseTransportType(const std::string& name, TransportType* type);
+
+/**
+ * @brief 服务端传输接口
+ *
+ * 每个客户端连接对应一个会话ID(小于kMaxSessions)，服务端按就绪位图在会话间分发请求。
+ * 请求帧和响应帧都由传输层提供，服务端原地读写。
+ * 除Wake外,所有方法只能在服务端处理线程中调用。
+ */
+class ServerTransport {
+public:
+    virtual ~ServerTransport() = default;
+
+    /**
+     * @brief 开始监听客户端连接
+     *
+     * @return true 初始化成功
+     * @return false 资源创建失败或同一通道已有存活的服务端
+     */
+    virtual bool Init() = 0;
+
+    /**
+     * @brief 关闭所有会话并释放监听资源
+     */
+    virtual void Close() = 0;
+
+    /**
+     * @brief 等待至少一个会话就绪
+     *
+     * @param timeout 最长等待时间
+     * @return uint64_t 就绪会话位图,超时返回0
+     */
+    virtual uint64_t WaitReady(std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * @brief 获取指定会话的下一个请求帧，帧在调用ReleaseRequest之前保持有效
+     *
+     * @return const RpcFrame* 请求帧,会话无效或没有完整请求时返回nullptr
+     */
+    virtual const RpcFrame* PeekRequest(uint32_t session_id) = 0;
+
+    /**
+     * @brief 释放通过PeekRequest读取的请求帧
+     */
+    virtual void ReleaseRequest(uint32_t session_id) = 0;
+
+    /**
+     * @brief 获取指定会话的响应帧，供服务端原地写入响应
+     *
+     * @return RpcFrame* 响应帧,会话无效或暂时无法发送时返回nullptr
+     */
+    virtual RpcFrame* ReserveResponse(uint32_t session_id) = 0;
+
+    /**
+     * @brief 发送通过ReserveResponse写入的响应
+     */
+    virtual void CommitResponse(uint32_t session_id) = 0;
+
+    /**
+     * @brief 重新标记会话就绪(用于单轮处理未取完请求的会话)
+     */
+    virtual void MarkReady(uint32_t session_id) = 0;
+
+    /**
+     * @brief 回收已关闭或已崩溃的客户端会话
+     *
+     * @return size_t 本次回收的会话数量
+     */
+    virtual size_t ReapSessions() = 0;
+
+    /**
+     * @brief 当前已建立的会话数量
+     */
+    virtual size_t ActiveSessionCount() const = 0;
+
+    /**
+     * @brief 唤醒阻塞在WaitReady中的服务端线程,可在任意线程调用
+     */
+    virtual void Wake() = 0;
+};
+
+/**
+ * @brief 客户端传输接口
+ *
+ * ReserveRequest/CommitRequest只能在单个生产线程中调用,
+ * PeekResponse/ReleaseResponse只能在单个消费线程中调用。
+ */
+class ClientTransport {
+public:
+    virtual ~ClientTransport() = default;
+
+    /**
+     * @brief 连接服务端
+     *
+     * @return true 连接成功
+     * @return false 服务端不存在或连接数已满
+     */
+    virtual bool Open() = 0;
+
+    /**
+     * @brief 断开连接,服务端会在下一次回收时释放会话
+     */
+    virtual void Close() = 0;
+
+    /**
+     * @brief 是否已连接
+     */
+    virtual bool IsOpen() const = 0;
+
+    /**
+     * @brief 获取请求帧，供调用方原地写入请求
+     *
+     * @return RpcFrame* 请求帧,未连接或请求队列已满时返回nullptr
+     */
+    virtual RpcFrame* ReserveRequest() = 0;
+
+    /**
+     * @brief 发送通过ReserveRequest写入的请求并通知服务端
+     *
+     * @return true 发送成功
+     * @return false 连接已断开
+     */
+    virtual bool CommitRequest() = 0;
+
+    /**
+     * @brief 等待并获取下一个响应帧，帧在调用ReleaseResponse之前保持有效
+     *
+     * @param timeout 最长等待时间
+     * @return const RpcFrame* 响应帧,超时或未连接时返回nullptr
+     */
+    virtual const RpcFrame* PeekResponse(std::chrono::milliseconds timeout) = 0;
+
+    /**
+     * @brief 释放通过PeekResponse读取的响应帧
+     */
+    virtual void ReleaseResponse() = 0;
+
+    /**
+     * @brief 唤醒阻塞在PeekResponse中的线程,可在任意线程调用
+     */
+    virtual void Wake() = 0;
+};
+
+/**
+ * @brief 按配置创建服务端传输
+ */
+std::unique_ptr<ServerTransport> CreateServerTransport(const std::string& channel_name, const RpcConfig& config);
+
+/**
+ * @brief 按配置创建客户端传输
+ */
+std::unique_ptr<ClientTransport> CreateClientTransport(const std::string& channel_name, const RpcConfig& config);
+
+} // namespace rpc
+} // namespace omnirt
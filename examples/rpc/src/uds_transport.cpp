@@ -0,0 +1,566 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC Unix域套接字传输实现文件
+
+#include "uds_transport.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace omnirt {
+namespace rpc {
+
+namespace {
+
+/// 单次从套接字读取的最大字节数
+constexpr size_t kReadChunkSize = 64 * 1024;
+/// 已消费数据超过该值时压缩接收缓冲区
+constexpr size_t kCompactThreshold = 64 * 1024;
+
+/**
+ * @brief 帧在线路上的长度
+ */
+size_t WireSize(const RpcHeader& header) {
+    return sizeof(RpcHeader) + header.method_name_len + header.payload_size;
+}
+
+bool FillAddress(const std::string& path, sockaddr_un* addr) {
+    if (path.size() >= sizeof(addr->sun_path)) {
+        return false;
+    }
+    std::memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    std::memcpy(addr->sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+/**
+ * @brief 按配置设置套接字收发缓冲区大小
+ */
+void ApplySocketBuffers(int fd, const RpcConfig& config) {
+    if (config.uds_socket_buffer_size == 0) {
+        return;
+    }
+    const int size = static_cast<int>(config.uds_socket_buffer_size);
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+/**
+ * @brief 发送一个帧的有效部分(帧头、方法名、负载)，处理部分写入
+ *
+ * @return true 发送成功
+ * @return false 连接已断开或发送超时
+ */
+bool SendFrame(int fd, const RpcFrame& frame) {
+    if (frame.header.method_name_len >= kMaxFrameMethodNameLen ||
+        frame.header.payload_size > kMaxFramePayloadSize) {
+        return false;
+    }
+
+    iovec iov[3];
+    iov[0].iov_base = const_cast<RpcHeader*>(&frame.header);
+    iov[0].iov_len = sizeof(RpcHeader);
+    iov[1].iov_base = const_cast<char*>(frame.method_name);
+    iov[1].iov_len = frame.header.method_name_len;
+    iov[2].iov_base = const_cast<uint8_t*>(frame.payload);
+    iov[2].iov_len = frame.header.payload_size;
+
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 3;
+
+    size_t remaining = WireSize(frame.header);
+    while (remaining > 0) {
+        const ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        remaining -= static_cast<size_t>(sent);
+        size_t consumed = static_cast<size_t>(sent);
+        while (consumed > 0 && msg.msg_iovlen > 0) {
+            if (consumed >= msg.msg_iov[0].iov_len) {
+                consumed -= msg.msg_iov[0].iov_len;
+                ++msg.msg_iov;
+                --msg.msg_iovlen;
+            } else {
+                msg.msg_iov[0].iov_base = static_cast<char*>(msg.msg_iov[0].iov_base) + consumed;
+                msg.msg_iov[0].iov_len -= consumed;
+                consumed = 0;
+            }
+        }
+    }
+    return true;
+}
+
+void SignalEventFd(int fd) {
+    if (fd >= 0) {
+        const uint64_t value = 1;
+        ssize_t ret = write(fd, &value, sizeof(value));
+        (void)ret;
+    }
+}
+
+void DrainEventFd(int fd) {
+    uint64_t value = 0;
+    ssize_t ret = read(fd, &value, sizeof(value));
+    (void)ret;
+}
+
+void CloseFd(int* fd) {
+    if (*fd >= 0) {
+        close(*fd);
+        *fd = -1;
+    }
+}
+
+} // namespace
+
+std::string UdsSocketPath(const std::string& channel_name, const RpcConfig& config) {
+    return config.uds_socket_dir + "/omnirt_rpc_" + channel_name + ".sock";
+}
+
+// ---------------------------------------------------------------------------
+// UdsFrameBuffer
+// ---------------------------------------------------------------------------
+
+bool UdsFrameBuffer::ReadFrom(int fd) {
+    // 压缩已消费的数据，避免缓冲区无限增长
+    if (offset_ == data_.size()) {
+        data_.clear();
+        offset_ = 0;
+    } else if (offset_ >= kCompactThreshold) {
+        data_.erase(data_.begin(), data_.begin() + static_cast<std::ptrdiff_t>(offset_));
+        offset_ = 0;
+    }
+
+    while (true) {
+        const size_t old_size = data_.size();
+        data_.resize(old_size + kReadChunkSize);
+        const ssize_t received = recv(fd, data_.data() + old_size, kReadChunkSize, MSG_DONTWAIT);
+        if (received > 0) {
+            data_.resize(old_size + static_cast<size_t>(received));
+            if (static_cast<size_t>(received) < kReadChunkSize) {
+                return true;
+            }
+            continue;
+        }
+
+        data_.resize(old_size);
+        if (received == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+bool UdsFrameBuffer::HasFrame() const {
+    const size_t available = data_.size() - offset_;
+    if (available < sizeof(RpcHeader)) {
+        return false;
+    }
+    RpcHeader header;
+    std::memcpy(&header, data_.data() + offset_, sizeof(RpcHeader));
+    // 无效帧也视为"有帧"，交给Extract报告错误
+    if (header.method_name_len >= kMaxFrameMethodNameLen || header.payload_size > kMaxFramePayloadSize) {
+        return true;
+    }
+    return available >= WireSize(header);
+}
+
+bool UdsFrameBuffer::Extract(RpcFrame* frame, bool* invalid) {
+    *invalid = false;
+    const size_t available = data_.size() - offset_;
+    if (available < sizeof(RpcHeader)) {
+        return false;
+    }
+
+    RpcHeader header;
+    std::memcpy(&header, data_.data() + offset_, sizeof(RpcHeader));
+    if (header.method_name_len >= kMaxFrameMethodNameLen || header.payload_size > kMaxFramePayloadSize) {
+        *invalid = true;
+        return false;
+    }
+    if (available < WireSize(header)) {
+        return false;
+    }
+
+    const uint8_t* cursor = data_.data() + offset_ + sizeof(RpcHeader);
+    frame->header = header;
+    std::memcpy(frame->method_name, cursor, header.method_name_len);
+    frame->method_name[header.method_name_len] = '\0';
+    cursor += header.method_name_len;
+    std::memcpy(frame->payload, cursor, header.payload_size);
+
+    offset_ += WireSize(header);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// UdsServerTransport
+// ---------------------------------------------------------------------------
+
+UdsServerTransport::UdsServerTransport(const std::string& channel_name, const RpcConfig& config)
+    : channel_name_(channel_name),
+      config_(config),
+      socket_path_(UdsSocketPath(channel_name, config)) {}
+
+UdsServerTransport::~UdsServerTransport() {
+    Close();
+}
+
+bool UdsServerTransport::Init() {
+    if (listen_fd_ >= 0) {
+        return false;
+    }
+
+    sockaddr_un addr;
+    if (!FillAddress(socket_path_, &addr)) {
+        std::cerr << "错误: 套接字路径过长: " << socket_path_ << std::endl;
+        return false;
+    }
+
+    // 套接字文件已存在时先尝试连接: 能连上说明已有存活的服务端，否则是崩溃遗留的文件
+    int probe_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe_fd >= 0) {
+        const bool alive = connect(probe_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        close(probe_fd);
+        if (alive) {
+            std::cerr << "错误: 通道 " << channel_name_ << " 已有服务端运行" << std::endl;
+            return false;
+        }
+    }
+    unlink(socket_path_.c_str());
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, static_cast<int>(kMaxSessions)) != 0) {
+        std::cerr << "错误: 无法监听套接字 " << socket_path_ << ": " << std::strerror(errno) << std::endl;
+        CloseFd(&listen_fd_);
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void UdsServerTransport::Close() {
+    for (auto& connection : connections_) {
+        CloseFd(&connection.fd);
+        connection = Connection();
+    }
+    pending_ = 0;
+
+    if (listen_fd_ >= 0) {
+        CloseFd(&listen_fd_);
+        unlink(socket_path_.c_str());
+    }
+    CloseFd(&wake_fd_);
+}
+
+void UdsServerTransport::AcceptConnections() {
+    while (true) {
+        const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+
+        auto it = std::find_if(connections_.begin(), connections_.end(),
+                               [](const Connection& c) { return c.fd < 0; });
+        if (it == connections_.end()) {
+            std::cerr << "错误: 会话槽位已满，拒绝新连接" << std::endl;
+            close(fd);
+            continue;
+        }
+
+        // 响应以阻塞方式发送，设置发送超时，避免不读取响应的客户端卡住服务端
+        const auto timeout_us = std::chrono::duration_cast<std::chrono::microseconds>(config_.default_timeout);
+        timeval send_timeout;
+        send_timeout.tv_sec = static_cast<time_t>(timeout_us.count() / 1000000);
+        send_timeout.tv_usec = static_cast<suseconds_t>(timeout_us.count() % 1000000);
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+        ApplySocketBuffers(fd, config_);
+
+        it->fd = fd;
+        it->closed = false;
+        it->has_request = false;
+        it->buffer.Clear();
+        if (!it->request) {
+            it->request = std::make_unique<RpcFrame>();
+        }
+    }
+}
+
+void UdsServerTransport::ReadConnection(uint32_t session_id) {
+    Connection& connection = connections_[session_id];
+    if (!connection.buffer.ReadFrom(connection.fd)) {
+        connection.closed = true;
+    }
+}
+
+uint64_t UdsServerTransport::WaitReady(std::chrono::milliseconds timeout) {
+    if (listen_fd_ < 0) {
+        return 0;
+    }
+
+    uint64_t ready = pending_;
+    pending_ = 0;
+
+    pollfd fds[kMaxSessions + 2];
+    uint32_t session_ids[kMaxSessions];
+    nfds_t count = 0;
+    fds[count++] = {listen_fd_, POLLIN, 0};
+    fds[count++] = {wake_fd_, POLLIN, 0};
+    for (uint32_t i = 0; i < kMaxSessions; ++i) {
+        if (connections_[i].fd >= 0 && !connections_[i].closed) {
+            session_ids[count - 2] = i;
+            fds[count++] = {connections_[i].fd, POLLIN, 0};
+        }
+    }
+
+    const int wait_ms = ready != 0 ? 0 : static_cast<int>(timeout.count());
+    const int ret = poll(fds, count, wait_ms);
+    if (ret <= 0) {
+        return ready;
+    }
+
+    if (fds[1].revents & POLLIN) {
+        DrainEventFd(wake_fd_);
+    }
+    for (nfds_t i = 2; i < count; ++i) {
+        if (fds[i].revents == 0) {
+            continue;
+        }
+        const uint32_t session_id = session_ids[i - 2];
+        ReadConnection(session_id);
+        if (connections_[session_id].buffer.HasFrame()) {
+            ready |= 1ULL << session_id;
+        }
+    }
+    if (fds[0].revents & POLLIN) {
+        AcceptConnections();
+    }
+
+    return ready;
+}
+
+const RpcFrame* UdsServerTransport::PeekRequest(uint32_t session_id) {
+    if (session_id >= kMaxSessions) {
+        return nullptr;
+    }
+
+    Connection& connection = connections_[session_id];
+    if (connection.fd < 0 || connection.closed) {
+        return nullptr;
+    }
+    if (connection.has_request) {
+        return connection.request.get();
+    }
+
+    bool invalid = false;
+    if (connection.buffer.Extract(connection.request.get(), &invalid)) {
+        connection.has_request = true;
+        return connection.request.get();
+    }
+    if (invalid) {
+        // 帧长度非法说明字节流已错位，无法恢复，断开该连接
+        std::cerr << "错误: 会话 " << session_id << " 收到无效帧，断开连接" << std::endl;
+        connection.closed = true;
+    }
+    return nullptr;
+}
+
+void UdsServerTransport::ReleaseRequest(uint32_t session_id) {
+    connections_[session_id].has_request = false;
+}
+
+RpcFrame* UdsServerTransport::ReserveResponse(uint32_t session_id) {
+    if (session_id >= kMaxSessions || connections_[session_id].fd < 0 || connections_[session_id].closed) {
+        return nullptr;
+    }
+    return &response_frame_;
+}
+
+void UdsServerTransport::CommitResponse(uint32_t session_id) {
+    Connection& connection = connections_[session_id];
+    if (!SendFrame(connection.fd, response_frame_)) {
+        connection.closed = true;
+    }
+}
+
+void UdsServerTransport::MarkReady(uint32_t session_id) {
+    if (session_id < kMaxSessions) {
+        pending_ |= 1ULL << session_id;
+    }
+}
+
+size_t UdsServerTransport::ReapSessions() {
+    size_t reaped = 0;
+    for (auto& connection : connections_) {
+        if (connection.fd >= 0 && connection.closed) {
+            CloseFd(&connection.fd);
+            connection.has_request = false;
+            connection.buffer.Clear();
+            ++reaped;
+        }
+    }
+    return reaped;
+}
+
+size_t UdsServerTransport::ActiveSessionCount() const {
+    return static_cast<size_t>(std::count_if(connections_.begin(), connections_.end(),
+                                             [](const Connection& c) { return c.fd >= 0; }));
+}
+
+void UdsServerTransport::Wake() {
+    SignalEventFd(wake_fd_);
+}
+
+// ---------------------------------------------------------------------------
+// UdsClientTransport
+// ---------------------------------------------------------------------------
+
+UdsClientTransport::UdsClientTransport(const std::string& channel_name, const RpcConfig& config)
+    : channel_name_(channel_name),
+      config_(config) {}
+
+UdsClientTransport::~UdsClientTransport() {
+    Close();
+}
+
+bool UdsClientTransport::Open() {
+    if (IsOpen()) {
+        return true;
+    }
+    Close();
+
+    sockaddr_un addr;
+    if (!FillAddress(UdsSocketPath(channel_name_, config_), &addr)) {
+        return false;
+    }
+
+    fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) {
+        return false;
+    }
+    ApplySocketBuffers(fd_, config_);
+    if (connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        CloseFd(&fd_);
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        CloseFd(&fd_);
+        return false;
+    }
+
+    broken_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void UdsClientTransport::Close() {
+    CloseFd(&fd_);
+    CloseFd(&wake_fd_);
+    buffer_.Clear();
+    has_response_ = false;
+}
+
+RpcFrame* UdsClientTransport::ReserveRequest() {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+    return &request_frame_;
+}
+
+bool UdsClientTransport::CommitRequest() {
+    if (!SendFrame(fd_, request_frame_)) {
+        broken_.store(true, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+const RpcFrame* UdsClientTransport::PeekResponse(std::chrono::milliseconds timeout) {
+    if (!IsOpen()) {
+        return nullptr;
+    }
+    if (has_response_) {
+        return &response_frame_;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        bool invalid = false;
+        if (buffer_.Extract(&response_frame_, &invalid)) {
+            has_response_ = true;
+            return &response_frame_;
+        }
+        if (invalid) {
+            std::cerr << "错误: 收到无效响应帧，连接已断开" << std::endl;
+            broken_.store(true, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() < 0) {
+            return nullptr;
+        }
+
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        const int ret = poll(fds, 2, static_cast<int>(remaining.count()));
+        if (ret < 0 && errno != EINTR) {
+            return nullptr;
+        }
+        if (ret == 0) {
+            return nullptr;
+        }
+        if (fds[1].revents & POLLIN) {
+            DrainEventFd(wake_fd_);
+            return nullptr;
+        }
+        if (fds[0].revents != 0 && !buffer_.ReadFrom(fd_)) {
+            broken_.store(true, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+}
+
+void UdsClientTransport::ReleaseResponse() {
+    has_response_ = false;
+}
+
+void UdsClientTransport::Wake() {
+    SignalEventFd(wake_fd_);
+}
+
+} // namespace rpc
+} // namespace omnirt
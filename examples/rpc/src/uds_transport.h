@@ -0,0 +1,145 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// RPC Unix域套接字传输
+// 1. 服务端监听 <uds_socket_dir>/omnirt_rpc_<channel>.sock，每个连接对应一个会话
+// 2. 线路格式为 RpcHeader + 方法名 + 负载，按帧头中的长度分帧，只发送有效部分
+// 3. 服务端通过poll同时等待监听套接字、所有连接和唤醒用的eventfd
+// 4. 接收到的字节先进入每个连接的接收缓冲区，凑齐完整帧后再拷贝到定长帧中供上层读取
+
+#pragma once
+
+#include "transport.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace omnirt {
+namespace rpc {
+
+/**
+ * @brief 生成UDS传输的套接字路径
+ */
+std::string UdsSocketPath(const std::string& channel_name, const RpcConfig& config);
+
+/**
+ * @brief 流式接收缓冲区，负责从字节流中切分帧
+ */
+class UdsFrameBuffer {
+public:
+    /**
+     * @brief 从非阻塞套接字读取所有可读数据
+     *
+     * @param fd 套接字
+     * @return true 连接正常
+     * @return false 对端已关闭或读取出错
+     */
+    bool ReadFrom(int fd);
+
+    /**
+     * @brief 尝试从缓冲区中取出一个完整帧
+     *
+     * @param[out] frame 目标帧
+     * @param[out] invalid 帧头中的长度超出帧容量时置为true
+     * @return true 取出了完整帧
+     * @return false 数据不足或帧无效
+     */
+    bool Extract(RpcFrame* frame, bool* invalid);
+
+    /**
+     * @brief 缓冲区中是否已有完整帧
+     */
+    bool HasFrame() const;
+
+    void Clear() {
+        data_.clear();
+        offset_ = 0;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+    size_t offset_ = 0;  ///< 已消费的字节数
+};
+
+/**
+ * @brief UDS服务端传输
+ */
+class UdsServerTransport : public ServerTransport {
+public:
+    UdsServerTransport(const std::string& channel_name, const RpcConfig& config);
+    ~UdsServerTransport() override;
+
+    UdsServerTransport(const UdsServerTransport&) = delete;
+    UdsServerTransport& operator=(const UdsServerTransport&) = delete;
+
+    bool Init() override;
+    void Close() override;
+    uint64_t WaitReady(std::chrono::milliseconds timeout) override;
+    const RpcFrame* PeekRequest(uint32_t session_id) override;
+    void ReleaseRequest(uint32_t session_id) override;
+    RpcFrame* ReserveResponse(uint32_t session_id) override;
+    void CommitResponse(uint32_t session_id) override;
+    void MarkReady(uint32_t session_id) override;
+    size_t ReapSessions() override;
+    size_t ActiveSessionCount() const override;
+    void Wake() override;
+
+private:
+    struct Connection {
+        int fd = -1;
+        bool closed = false;          ///< 对端已关闭或读写出错,等待回收
+        bool has_request = false;     ///< request中有尚未释放的请求
+        UdsFrameBuffer buffer;
+        std::unique_ptr<RpcFrame> request;  ///< 当前请求帧,连接建立时分配
+    };
+
+    void AcceptConnections();
+    void ReadConnection(uint32_t session_id);
+
+    std::string channel_name_;
+    RpcConfig config_;
+    std::string socket_path_;
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;
+    std::array<Connection, kMaxSessions> connections_;
+    uint64_t pending_ = 0;  ///< 通过MarkReady标记的就绪会话
+    RpcFrame response_frame_;
+};
+
+/**
+ * @brief UDS客户端传输
+ */
+class UdsClientTransport : public ClientTransport {
+public:
+    UdsClientTransport(const std::string& channel_name, const RpcConfig& config);
+    ~UdsClientTransport() override;
+
+    UdsClientTransport(const UdsClientTransport&) = delete;
+    UdsClientTransport& operator=(const UdsClientTransport&) = delete;
+
+    bool Open() override;
+    void Close() override;
+    bool IsOpen() const override { return fd_ >= 0 && !broken_.load(std::memory_order_relaxed); }
+    RpcFrame* ReserveRequest() override;
+    bool CommitRequest() override;
+    const RpcFrame* PeekResponse(std::chrono::milliseconds timeout) override;
+    void ReleaseResponse() override;
+    void Wake() override;
+
+private:
+    std::string channel_name_;
+    RpcConfig config_;
+    int fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> broken_{false};  ///< 连接已断开
+    UdsFrameBuffer buffer_;
+    bool has_response_ = false;
+    RpcFrame request_frame_;
+    RpcFrame response_frame_;
+};
+
+} // namespace rpc
+} // namespace omnirt
@@ -4,6 +4,8 @@
  * 
  * 此程序测试共享内存无锁队列在不同场景下的性能表现。
  * 测试项目包括：吞吐量、延迟分布、不同大小数据的性能表现等。
+ * 扇出测试对比一个生产者向1~16个消费者分发同一消息流时，
+ * 广播环(一次写入、多个读游标)与每个消费者一个SPSC队列(写入N份)的表现。
  */
 
 #include <iostream>
@@ -14,7 +16,9 @@
 #include <iomanip>
 #include <algorithm>
 #include <cstring>
+#include <memory>
 #include "common/util/shm_bounded_spsc_lockfree_queue.h"
+#include "common/util/shm_broadcast_ring.h"
 #include "common/util/bounded_spsc_lockfree_queue.h"
 
 // 用于性能测试的不同大小的数据结构
@@ -249,6 +253,184 @@ PerfStats runPerfTest(const std::string& shm_name,
   return calculateStats(latencies, total_time_ms, latencies.size(), sizeof(T));
 }
 
+// 扇出测试结果
+struct FanOutStats {
+  PerfStats perf;             // 所有消费者合并后的吞吐量与延迟
+  uint64_t dropped = 0;       // 所有消费者因溢出丢失的消息总数
+};
+
+// 广播环消费者线程：一直读取到收到或丢弃全部消息
+template<typename T>
+void broadcastConsumerThread(omnirt::common::util::ShmBroadcastConsumer<T>* consumer,
+                             uint64_t message_count,
+                             std::vector<double>* latencies,
+                             std::atomic<bool>* producer_done) {
+  using Consumer = omnirt::common::util::ShmBroadcastConsumer<T>;
+  T msg;
+  uint64_t received = 0;
+  while (received + consumer->Dropped() < message_count) {
+    const bool finished = producer_done->load(std::memory_order_acquire);
+    auto status = consumer->Read(&msg, std::chrono::milliseconds(100));
+    if (status == Consumer::ReadStatus::kOk) {
+      latencies->push_back((getCurrentTimeNs() - msg.timestamp_ns) / 1000.0);
+      received++;
+    } else if (status == Consumer::ReadStatus::kEmpty && finished) {
+      break;
+    }
+  }
+}
+
+// 广播环扇出测试：生产者每条消息只写一次
+// paced为false时生产者从不等待消费者，慢速消费者会丢失消息；
+// paced为true时生产者在最慢消费者即将溢出时让出CPU，用于测量无丢失时的扇出吞吐量
+template<typename T>
+FanOutStats runBroadcastFanOut(int num_consumers, uint64_t queue_size, uint64_t message_count, bool paced) {
+  using namespace omnirt::common::util;
+  const std::string shm_name = "/perf_test_broadcast";
+  FanOutStats result;
+
+  ShmBroadcastProducer<T> producer;
+  if (!producer.Init(shm_name, queue_size)) {
+    std::cerr << "错误：无法初始化广播环" << std::endl;
+    return result;
+  }
+
+  std::vector<std::unique_ptr<ShmBroadcastConsumer<T>>> consumers;
+  std::vector<std::vector<double>> latencies(num_consumers);
+  for (int i = 0; i < num_consumers; ++i) {
+    consumers.push_back(std::make_unique<ShmBroadcastConsumer<T>>());
+    if (!consumers.back()->Init(shm_name, queue_size)) {
+      std::cerr << "错误：消费者无法附加到广播环" << std::endl;
+      return result;
+    }
+    latencies[i].reserve(message_count);
+  }
+
+  std::atomic<bool> producer_done(false);
+  auto test_start = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_consumers; ++i) {
+    threads.emplace_back(broadcastConsumerThread<T>, consumers[i].get(), message_count,
+                         &latencies[i], &producer_done);
+  }
+
+  T msg;
+  for (uint32_t i = 0; i < message_count; ++i) {
+    msg.seq_id = i;
+    if (paced && (i % 64) == 0) {
+      while (producer.MaxConsumerLag() + 64 >= queue_size) {
+        std::this_thread::yield();
+      }
+    }
+    msg.timestamp_ns = getCurrentTimeNs();
+    producer.Publish(msg);
+  }
+  producer_done.store(true, std::memory_order_release);
+  producer.WakeAll();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double total_time_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::high_resolution_clock::now() - test_start).count();
+
+  std::vector<double> merged;
+  for (int i = 0; i < num_consumers; ++i) {
+    merged.insert(merged.end(), latencies[i].begin(), latencies[i].end());
+    result.dropped += consumers[i]->Dropped();
+  }
+  result.perf = calculateStats(merged, total_time_ms, merged.size(), sizeof(T));
+  return result;
+}
+
+// SPSC队列扇出测试：每个消费者一个队列，生产者把每条消息写入N次，队列满时等待
+template<typename T>
+FanOutStats runSpscFanOut(int num_consumers, uint64_t queue_size, uint64_t message_count) {
+  using namespace omnirt::common::util;
+  FanOutStats result;
+
+  std::vector<std::unique_ptr<ShmBoundedSpscLockfreeQueue<T>>> queues;
+  std::vector<std::vector<double>> latencies(num_consumers);
+  for (int i = 0; i < num_consumers; ++i) {
+    queues.push_back(std::make_unique<ShmBoundedSpscLockfreeQueue<T>>());
+    if (!queues.back()->Init("/perf_test_fanout_" + std::to_string(i), queue_size, true, true)) {
+      std::cerr << "错误：无法初始化共享内存队列" << std::endl;
+      return result;
+    }
+    latencies[i].reserve(message_count);
+  }
+
+  auto test_start = std::chrono::high_resolution_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_consumers; ++i) {
+    threads.emplace_back([queue = queues[i].get(), message_count, latency = &latencies[i]]() {
+      T msg;
+      uint64_t received = 0;
+      while (received < message_count) {
+        if (queue->Dequeue(&msg)) {
+          latency->push_back((getCurrentTimeNs() - msg.timestamp_ns) / 1000.0);
+          received++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  T msg;
+  for (uint32_t i = 0; i < message_count; ++i) {
+    msg.seq_id = i;
+    msg.timestamp_ns = getCurrentTimeNs();
+    for (auto& queue : queues) {
+      while (!queue->Enqueue(msg)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double total_time_ms = std::chrono::duration<double, std::milli>(
+      std::chrono::high_resolution_clock::now() - test_start).count();
+
+  std::vector<double> merged;
+  for (const auto& latency : latencies) {
+    merged.insert(merged.end(), latency.begin(), latency.end());
+  }
+  result.perf = calculateStats(merged, total_time_ms, merged.size(), sizeof(T));
+  return result;
+}
+
+// 打印一行扇出测试结果
+void printFanOutStats(const std::string& mode, int num_consumers, const FanOutStats& stats) {
+  std::cout << std::left << std::setw(12) << mode << std::right
+            << std::setw(6) << num_consumers
+            << std::setw(14) << std::fixed << std::setprecision(0) << stats.perf.msgs_per_sec
+            << std::setw(10) << std::setprecision(2) << stats.perf.p50_latency_us
+            << std::setw(10) << stats.perf.p99_latency_us
+            << std::setw(12) << stats.dropped << std::endl;
+}
+
+// 运行扇出对比测试
+void runFanOutTests(const std::vector<int>& consumer_counts, uint64_t queue_size, uint64_t message_count) {
+  using FanOutData = PerfTestData<64>;
+  std::cout << "====== 扇出测试(64字节, 每个消费者 " << message_count << " 条消息) ======" << std::endl;
+  std::cout << std::left << std::setw(12) << "模式" << std::right
+            << std::setw(6) << "消费者" << std::setw(14) << "投递/秒"
+            << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)"
+            << std::setw(12) << "丢失" << std::endl;
+  for (int num_consumers : consumer_counts) {
+    printFanOutStats("broadcast", num_consumers,
+                     runBroadcastFanOut<FanOutData>(num_consumers, queue_size, message_count, false));
+    printFanOutStats("bcast-pace", num_consumers,
+                     runBroadcastFanOut<FanOutData>(num_consumers, queue_size, message_count, true));
+    printFanOutStats("spsc x N", num_consumers,
+                     runSpscFanOut<FanOutData>(num_consumers, queue_size, message_count));
+  }
+  std::cout << std::endl;
+}
+
 int main(int argc, char* argv[]) {
   // 解析命令行参数
   uint64_t queue_size = 1024;
@@ -256,6 +438,8 @@ int main(int argc, char* argv[]) {
   bool run_small_test = true;
   bool run_medium_test = true;
   bool run_large_test = true;
+  bool run_fanout_test = true;
+  std::vector<int> consumer_counts = {1, 2, 4, 8, 16};
   
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
@@ -272,6 +456,14 @@ int main(int argc, char* argv[]) {
     } else if (arg == "--large-only") {
       run_small_test = false;
       run_medium_test = false;
+    } else if (arg == "--fanout-only") {
+      run_small_test = false;
+      run_medium_test = false;
+      run_large_test = false;
+    } else if (arg == "--no-fanout") {
+      run_fanout_test = false;
+    } else if (arg == "--consumers" && i + 1 < argc) {
+      consumer_counts = {std::stoi(argv[++i])};
     } else if (arg == "--help") {
       std::cout << "用法: " << argv[0] << " [选项]" << std::endl
                 << "选项:" << std::endl
@@ -280,6 +472,9 @@ int main(int argc, char* argv[]) {
                 << "  --small-only        只运行小型数据测试" << std::endl
                 << "  --medium-only       只运行中型数据测试" << std::endl
                 << "  --large-only        只运行大型数据测试" << std::endl
+                << "  --fanout-only       只运行扇出测试" << std::endl
+                << "  --no-fanout         不运行扇出测试" << std::endl
+                << "  --consumers N       扇出测试的消费者数量 (默认: 1,2,4,8,16)" << std::endl
                 << "  --help              显示此帮助信息" << std::endl;
       return 0;
     }
@@ -313,6 +508,10 @@ int main(int argc, char* argv[]) {
         "/perf_test_large", queue_size, message_count / 10, true);
     printStats("大型数据(4KB)", large_stats);
   }
+
+  if (run_fanout_test) {
+    runFanOutTests(consumer_counts, queue_size, message_count / 10);
+  }
   
   std::cout << "性能测试完成" << std::endl;
   return 0;
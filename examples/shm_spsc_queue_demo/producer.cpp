@@ -79,17 +79,9 @@ int main(int argc, char* argv[]) {
   // 创建共享内存队列
   std::cout << "DEBUG: 开始初始化队列..." << std::endl;
   
-  // 首先清理可能存在的同名共享内存
-  std::cout << "DEBUG: 尝试删除已存在的共享内存: " << shm_name << std::endl;
-  if (shm_unlink(shm_name.c_str()) == 0) {
-    std::cout << "DEBUG: 成功删除已存在的共享内存" << std::endl;
-  } else {
-    if (errno == ENOENT) {
-      std::cout << "DEBUG: 没有找到要删除的共享内存，可能不存在" << std::endl;
-    } else {
-      std::cerr << "DEBUG: 删除共享内存失败: " << strerror(errno) << " (errno=" << errno << ")" << std::endl;
-      perror("shm_unlink");
-    }
+  // 清理上次崩溃遗留的同名共享内存，仍有存活的生产者时保留
+  if (!omnirt::common::util::ShmBoundedSpscLockfreeQueue<Message>::RemoveIfOrphaned(shm_name)) {
+    std::cerr << "共享内存 " << shm_name << " 仍被存活的生产者持有" << std::endl;
   }
   
   // 查看共享内存目录
@@ -0,0 +1,447 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(_WIN32)
+  #include <execinfo.h>
+#endif
+
+#include "util/macros.h"
+
+namespace aimrt::common::util {
+
+/**
+ * @brief 内存分配统计与泄漏追踪
+ *
+ * 1. 分配域: 按子系统(channel序列化、rpc、日志、模块等)注册的统计维度,最多kMaxDomains个,超出后计入"other"
+ * 2. 线程计数: 每个线程有自己的计数记录,只由本线程写入,无锁无共享写;读取时汇总所有线程
+ * 3. 采样调用栈: 设置采样间隔后,平均每间隔次分配记录一次调用栈,释放时移除,剩余的即为疑似泄漏
+ * 4. 报告: GenReport输出各分配域的统计和按调用栈聚合的存活采样
+ *
+ * 两种接入方式:
+ * 1. Allocate/Free: 由追踪器分配内存,前置一个头部记录分配域和大小,释放时自动归属,支持采样
+ * 2. RecordAlloc/RecordFree: 只计数,用于内存由其它组件分配的场景,调用方自行保证配对
+ *
+ * 未启用时不应走追踪路径(参见Enabled),追踪路径本身始终计数,保证运行中开关不会造成计数不配对
+ */
+class AllocTracker {
+ public:
+  static constexpr uint32_t kMaxDomains = 256;
+  static constexpr uint32_t kOtherDomain = 0;
+  static constexpr size_t kMaxFrames = 32;
+
+  struct DomainStats {
+    std::string name;
+    uint64_t alloc_count = 0;
+    uint64_t free_count = 0;
+    uint64_t alloc_bytes = 0;
+    uint64_t free_bytes = 0;
+
+    int64_t LiveCount() const { return static_cast<int64_t>(alloc_count - free_count); }
+    int64_t LiveBytes() const { return static_cast<int64_t>(alloc_bytes - free_bytes); }
+  };
+
+  struct LiveSample {
+    uint32_t domain = kOtherDomain;
+    size_t size = 0;
+    std::chrono::steady_clock::time_point time;
+    std::vector<void*> frames;
+  };
+
+  /**
+   * @brief 进程级实例,故意不析构,保证线程退出和静态对象析构期间仍可使用
+   */
+  static AllocTracker& Instance() {
+    static AllocTracker* const tracker = new AllocTracker();
+    return *tracker;
+  }
+
+  AllocTracker(const AllocTracker&) = delete;
+  AllocTracker& operator=(const AllocTracker&) = delete;
+
+  /**
+   * @brief 注册分配域,同名重复注册返回同一id
+   *
+   * @param name 分配域名称
+   * @return uint32_t 分配域id,分配域已满时返回kOtherDomain
+   */
+  uint32_t RegisterDomain(std::string_view name) {
+    std::lock_guard<std::mutex> lck(domain_mutex_);
+    for (uint32_t ii = 0; ii < domain_num_; ++ii) {
+      if (domain_names_[ii] == name) return ii;
+    }
+    if (domain_num_ >= kMaxDomains) return kOtherDomain;
+    domain_names_[domain_num_] = std::string(name);
+    return domain_num_++;
+  }
+
+  std::string DomainName(uint32_t domain) const {
+    std::lock_guard<std::mutex> lck(domain_mutex_);
+    return (domain < domain_num_) ? domain_names_[domain] : domain_names_[kOtherDomain];
+  }
+
+  void SetEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+  bool Enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 设置调用栈采样间隔
+   *
+   * @param interval 平均每多少次分配采样一次,0表示不采样
+   */
+  void SetSampleInterval(uint32_t interval) { sample_interval_.store(interval, std::memory_order_relaxed); }
+  uint32_t SampleInterval() const { return sample_interval_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 分配内存并计入分配域,必须使用Free释放
+   *
+   * @return void* 内存地址,按max_align_t对齐,申请失败时返回nullptr
+   */
+  void* Allocate(uint32_t domain, size_t size) {
+    if (omnirt_unlikely(domain >= kMaxDomains)) domain = kOtherDomain;
+
+    auto* header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+    if (omnirt_unlikely(header == nullptr)) return nullptr;
+
+    header->domain = domain;
+    header->sampled = 0;
+    header->size = size;
+    void* ptr = header + 1;
+
+    Record* rec = LocalRecord();
+    Add(rec->counters[domain].alloc_count, 1);
+    Add(rec->counters[domain].alloc_bytes, size);
+
+    // 采样间隔变化后立即按新间隔重新计数
+    const uint32_t interval = SampleInterval();
+    if (omnirt_unlikely(interval != rec->sample_interval)) {
+      rec->sample_interval = interval;
+      rec->sample_countdown = NextSampleCountdown(rec, interval);
+    }
+
+    if (omnirt_unlikely(interval != 0 && --rec->sample_countdown == 0)) {
+      rec->sample_countdown = NextSampleCountdown(rec, interval);
+      header->sampled = 1;
+      CaptureSample(ptr, domain, size);
+    }
+
+    return ptr;
+  }
+
+  /**
+   * @brief 释放Allocate分配的内存,可在任意线程调用
+   */
+  void Free(void* ptr) {
+    if (ptr == nullptr) return;
+
+    auto* header = static_cast<Header*>(ptr) - 1;
+    Record* rec = LocalRecord();
+    Add(rec->counters[header->domain].free_count, 1);
+    Add(rec->counters[header->domain].free_bytes, header->size);
+
+    if (omnirt_unlikely(header->sampled)) {
+      std::lock_guard<std::mutex> lck(sample_mutex_);
+      live_samples_.erase(ptr);
+    }
+
+    std::free(header);
+  }
+
+  /**
+   * @brief 只计数,不分配
+   */
+  void RecordAlloc(uint32_t domain, size_t size) {
+    if (omnirt_unlikely(domain >= kMaxDomains)) domain = kOtherDomain;
+    Record* rec = LocalRecord();
+    Add(rec->counters[domain].alloc_count, 1);
+    Add(rec->counters[domain].alloc_bytes, size);
+  }
+
+  void RecordFree(uint32_t domain, size_t size) {
+    if (omnirt_unlikely(domain >= kMaxDomains)) domain = kOtherDomain;
+    Record* rec = LocalRecord();
+    Add(rec->counters[domain].free_count, 1);
+    Add(rec->counters[domain].free_bytes, size);
+  }
+
+  /**
+   * @brief 汇总所有线程的计数,只返回已注册的分配域
+   */
+  std::vector<DomainStats> GetDomainStats() const {
+    std::vector<DomainStats> result;
+    {
+      std::lock_guard<std::mutex> lck(domain_mutex_);
+      result.resize(domain_num_);
+      for (uint32_t ii = 0; ii < domain_num_; ++ii) result[ii].name = domain_names_[ii];
+    }
+
+    for (Record* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      for (size_t ii = 0; ii < result.size(); ++ii) {
+        const Counters& c = rec->counters[ii];
+        result[ii].alloc_count += c.alloc_count.load(std::memory_order_relaxed);
+        result[ii].free_count += c.free_count.load(std::memory_order_relaxed);
+        result[ii].alloc_bytes += c.alloc_bytes.load(std::memory_order_relaxed);
+        result[ii].free_bytes += c.free_bytes.load(std::memory_order_relaxed);
+      }
+    }
+    return result;
+  }
+
+  DomainStats GetDomainStats(uint32_t domain) const {
+    auto stats = GetDomainStats();
+    return (domain < stats.size()) ? stats[domain] : DomainStats{};
+  }
+
+  /**
+   * @brief 当前仍存活的采样分配
+   */
+  std::vector<LiveSample> GetLiveSamples() const {
+    std::lock_guard<std::mutex> lck(sample_mutex_);
+    std::vector<LiveSample> result;
+    result.reserve(live_samples_.size());
+    for (const auto& itr : live_samples_) result.emplace_back(itr.second);
+    return result;
+  }
+
+  /**
+   * @brief 生成文本报告,包括各分配域的计数和存活采样的调用栈
+   *
+   * @param max_stacks 最多输出的调用栈个数,按存活字节数降序
+   * @param min_age 只统计存活时间不短于该值的采样,用于过滤正常在途的分配
+   */
+  std::string GenReport(
+      size_t max_stacks = 10,
+      std::chrono::steady_clock::duration min_age = std::chrono::steady_clock::duration::zero()) const {
+    std::stringstream ss;
+    ss << "domain | alloc count | free count | live count | live bytes | total alloc bytes\n";
+    for (const auto& stats : GetDomainStats()) {
+      if (stats.alloc_count == 0 && stats.free_count == 0) continue;
+      ss << stats.name << " | " << stats.alloc_count << " | " << stats.free_count << " | "
+         << stats.LiveCount() << " | " << stats.LiveBytes() << " | " << stats.alloc_bytes << "\n";
+    }
+    ss << GenSampleReport(max_stacks, min_age);
+    return ss.str();
+  }
+
+  /**
+   * @brief 生成存活采样的报告,按(分配域,调用栈)聚合,未开启采样时返回空
+   */
+  std::string GenSampleReport(
+      size_t max_stacks = 10,
+      std::chrono::steady_clock::duration min_age = std::chrono::steady_clock::duration::zero()) const {
+    const uint32_t interval = SampleInterval();
+    if (interval == 0) return {};
+
+    std::stringstream ss;
+
+    struct StackStats {
+      uint32_t domain;
+      const std::vector<void*>* frames;
+      size_t count = 0;
+      size_t bytes = 0;
+    };
+    const auto now = std::chrono::steady_clock::now();
+    const auto samples = GetLiveSamples();
+    std::map<std::pair<uint32_t, std::vector<void*>>, StackStats> stacks;
+    for (const auto& sample : samples) {
+      if (now - sample.time < min_age) continue;
+      auto& item = stacks.try_emplace({sample.domain, sample.frames}, StackStats{sample.domain, &sample.frames}).first->second;
+      ++item.count;
+      item.bytes += sample.size;
+    }
+
+    std::vector<const StackStats*> sorted;
+    sorted.reserve(stacks.size());
+    for (const auto& itr : stacks) sorted.emplace_back(&itr.second);
+    std::sort(sorted.begin(), sorted.end(), [](const StackStats* a, const StackStats* b) { return a->bytes > b->bytes; });
+    if (sorted.size() > max_stacks) sorted.resize(max_stacks);
+
+    ss << "live sampled allocations (1 in " << interval << "): " << samples.size() << ", top stacks:\n";
+    for (size_t ii = 0; ii < sorted.size(); ++ii) {
+      const auto& item = *sorted[ii];
+      ss << "#" << ii << " domain: " << DomainName(item.domain) << ", samples: " << item.count
+         << ", sampled bytes: " << item.bytes << "\n";
+      for (const auto& symbol : Symbolize(*item.frames)) ss << "    " << symbol << "\n";
+    }
+    return ss.str();
+  }
+
+ private:
+  struct Header {
+    uint32_t domain;
+    uint32_t sampled;
+    uint64_t size;
+  };
+  static_assert(sizeof(Header) == 16);
+
+  struct Counters {
+    std::atomic<uint64_t> alloc_count{0};
+    std::atomic<uint64_t> free_count{0};
+    std::atomic<uint64_t> alloc_bytes{0};
+    std::atomic<uint64_t> free_bytes{0};
+  };
+
+  /**
+   * @brief 线程记录,线程退出后归还,可被其它线程复用,永不释放,计数持续累加
+   */
+  struct alignas(64) Record {
+    std::atomic<bool> in_use{false};
+    Record* next = nullptr;
+
+    // 以下成员只由持有该记录的线程访问
+    uint32_t sample_interval = 0;
+    uint32_t sample_countdown = 0;
+    uint64_t rand_state = 0;
+
+    Counters counters[kMaxDomains];
+  };
+
+  struct ThreadHandle {
+    Record* rec = nullptr;
+    ~ThreadHandle() {
+      if (rec != nullptr) rec->in_use.store(false, std::memory_order_release);
+    }
+  };
+
+  AllocTracker() {
+    domain_names_[kOtherDomain] = "other";
+    domain_num_ = 1;
+  }
+
+  // 计数只由本线程写入,读改写不需要原子指令
+  static void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  Record* LocalRecord() {
+    static thread_local ThreadHandle handle;
+    if (omnirt_unlikely(handle.rec == nullptr)) handle.rec = AcquireRecord();
+    return handle.rec;
+  }
+
+  Record* AcquireRecord() {
+    for (Record* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      bool expected = false;
+      if (!rec->in_use.load(std::memory_order_relaxed) &&
+          rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return rec;
+      }
+    }
+
+    auto* rec = new Record();
+    rec->in_use.store(true, std::memory_order_relaxed);
+    rec->rand_state = reinterpret_cast<uintptr_t>(rec) | 1;
+    rec->next = records_.load(std::memory_order_relaxed);
+    while (!records_.compare_exchange_weak(rec->next, rec, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return rec;
+  }
+
+  /**
+   * @brief 下一次采样前的分配次数,在[1, 2*interval-1]内均匀随机,避免与周期性的分配模式同步
+   */
+  static uint32_t NextSampleCountdown(Record* rec, uint32_t interval) {
+    if (interval <= 1) return interval;
+
+    uint64_t x = rec->rand_state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    rec->rand_state = x;
+    return static_cast<uint32_t>(x % (2 * uint64_t(interval) - 1)) + 1;
+  }
+
+  void CaptureSample(void* ptr, uint32_t domain, size_t size) {
+    LiveSample sample{.domain = domain, .size = size, .time = std::chrono::steady_clock::now(), .frames = {}};
+#if !defined(_WIN32)
+    void* frames[kMaxFrames];
+    const int n = backtrace(frames, kMaxFrames);
+    // 跳过CaptureSample和Allocate两层
+    if (n > 2) sample.frames.assign(frames + 2, frames + n);
+#endif
+
+    std::lock_guard<std::mutex> lck(sample_mutex_);
+    live_samples_.insert_or_assign(ptr, std::move(sample));
+  }
+
+  static std::vector<std::string> Symbolize(const std::vector<void*>& frames) {
+    std::vector<std::string> result;
+#if !defined(_WIN32)
+    if (frames.empty()) return result;
+    char** symbols = backtrace_symbols(frames.data(), static_cast<int>(frames.size()));
+    if (symbols == nullptr) return result;
+    result.assign(symbols, symbols + frames.size());
+    std::free(symbols);
+#endif
+    return result;
+  }
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<uint32_t> sample_interval_{0};
+
+  mutable std::mutex domain_mutex_;
+  std::string domain_names_[kMaxDomains];
+  uint32_t domain_num_ = 0;
+
+  std::atomic<Record*> records_{nullptr};
+
+  mutable std::mutex sample_mutex_;
+  std::unordered_map<void*, LiveSample> live_samples_;
+};
+
+/**
+ * @brief 只计数方式的RAII记录,构造时未启用追踪则什么都不做,可移动
+ */
+class ScopedAllocRecord {
+ public:
+  ScopedAllocRecord() = default;
+  ScopedAllocRecord(uint32_t domain, size_t size) {
+    if (AllocTracker::Instance().Enabled()) {
+      AllocTracker::Instance().RecordAlloc(domain, size);
+      domain_ = domain;
+      size_ = size;
+      active_ = true;
+    }
+  }
+  ~ScopedAllocRecord() {
+    if (active_) AllocTracker::Instance().RecordFree(domain_, size_);
+  }
+
+  ScopedAllocRecord(ScopedAllocRecord&& other) noexcept
+      : domain_(other.domain_), size_(other.size_), active_(other.active_) {
+    other.active_ = false;
+  }
+  ScopedAllocRecord& operator=(ScopedAllocRecord&& other) noexcept {
+    if (this != &other) {
+      if (active_) AllocTracker::Instance().RecordFree(domain_, size_);
+      domain_ = other.domain_;
+      size_ = other.size_;
+      active_ = other.active_;
+      other.active_ = false;
+    }
+    return *this;
+  }
+
+  ScopedAllocRecord(const ScopedAllocRecord&) = delete;
+  ScopedAllocRecord& operator=(const ScopedAllocRecord&) = delete;
+
+ private:
+  uint32_t domain_ = AllocTracker::kOtherDomain;
+  size_t size_ = 0;
+  bool active_ = false;
+};
+
+}  // namespace aimrt::common::util
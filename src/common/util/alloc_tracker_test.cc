@@ -0,0 +1,178 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "util/alloc_tracker.h"
+
+namespace aimrt::common::util {
+
+TEST(ALLOC_TRACKER_TEST, RegisterDomain) {
+  auto& tracker = AllocTracker::Instance();
+  uint32_t a = tracker.RegisterDomain("test.register.a");
+  uint32_t b = tracker.RegisterDomain("test.register.b");
+  EXPECT_NE(a, b);
+  EXPECT_NE(a, AllocTracker::kOtherDomain);
+  EXPECT_EQ(tracker.RegisterDomain("test.register.a"), a);
+  EXPECT_EQ(tracker.DomainName(b), "test.register.b");
+  EXPECT_EQ(tracker.DomainName(AllocTracker::kMaxDomains), "other");
+}
+
+TEST(ALLOC_TRACKER_TEST, CountAcrossThreads) {
+  auto& tracker = AllocTracker::Instance();
+  uint32_t domain = tracker.RegisterDomain("test.count");
+
+  constexpr int kThreadNum = 4;
+  constexpr int kLoops = 1000;
+
+  // 在一组线程中分配,在另一组线程中释放,其中一部分故意不释放
+  std::vector<void*> ptrs(kThreadNum * kLoops);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&, t] {
+      for (int ii = 0; ii < kLoops; ++ii) ptrs[t * kLoops + ii] = tracker.Allocate(domain, 100);
+    });
+  }
+  for (auto& t : threads) t.join();
+  threads.clear();
+
+  for (int t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([&, t] {
+      for (int ii = 0; ii < kLoops - 10; ++ii) tracker.Free(ptrs[t * kLoops + ii]);
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  auto stats = tracker.GetDomainStats(domain);
+  EXPECT_EQ(stats.name, "test.count");
+  EXPECT_EQ(stats.alloc_count, kThreadNum * kLoops);
+  EXPECT_EQ(stats.alloc_bytes, kThreadNum * kLoops * 100);
+  EXPECT_EQ(stats.LiveCount(), kThreadNum * 10);
+  EXPECT_EQ(stats.LiveBytes(), kThreadNum * 10 * 100);
+
+  for (int t = 0; t < kThreadNum; ++t) {
+    for (int ii = kLoops - 10; ii < kLoops; ++ii) tracker.Free(ptrs[t * kLoops + ii]);
+  }
+  EXPECT_EQ(tracker.GetDomainStats(domain).LiveCount(), 0);
+}
+
+TEST(ALLOC_TRACKER_TEST, ScopedAllocRecord) {
+  auto& tracker = AllocTracker::Instance();
+  uint32_t domain = tracker.RegisterDomain("test.scoped");
+
+  tracker.SetEnabled(false);
+  {
+    ScopedAllocRecord record(domain, 64);
+    EXPECT_EQ(tracker.GetDomainStats(domain).alloc_count, 0);
+  }
+
+  tracker.SetEnabled(true);
+  {
+    ScopedAllocRecord record(domain, 64);
+    ScopedAllocRecord moved(std::move(record));
+    EXPECT_EQ(tracker.GetDomainStats(domain).LiveBytes(), 64);
+
+    // 运行中关闭不影响已有记录的配对
+    tracker.SetEnabled(false);
+  }
+  EXPECT_EQ(tracker.GetDomainStats(domain).LiveBytes(), 0);
+  EXPECT_EQ(tracker.GetDomainStats(domain).free_count, 1);
+}
+
+__attribute__((noinline)) void* LeakyFunction(uint32_t domain) {
+  return AllocTracker::Instance().Allocate(domain, 256);
+}
+
+TEST(ALLOC_TRACKER_TEST, SampledLeak) {
+  auto& tracker = AllocTracker::Instance();
+  uint32_t domain = tracker.RegisterDomain("test.leak");
+  tracker.SetSampleInterval(1);
+
+  std::vector<void*> ok_ptrs;
+  std::vector<void*> leak_ptrs;
+  for (int ii = 0; ii < 100; ++ii) {
+    ok_ptrs.emplace_back(tracker.Allocate(domain, 32));
+    leak_ptrs.emplace_back(LeakyFunction(domain));
+  }
+  for (void* ptr : ok_ptrs) tracker.Free(ptr);
+
+  // 采样间隔为1时每次分配都采样,释放后移除,剩下的都是故意泄漏的
+  size_t leak_num = 0;
+  for (const auto& sample : tracker.GetLiveSamples()) {
+    if (sample.domain != domain) continue;
+    ++leak_num;
+    EXPECT_EQ(sample.size, 256);
+#if !defined(_WIN32)
+    EXPECT_FALSE(sample.frames.empty());
+#endif
+  }
+  EXPECT_EQ(leak_num, 100);
+
+  std::string report = tracker.GenReport();
+  EXPECT_NE(report.find("test.leak"), std::string::npos);
+  EXPECT_NE(report.find("samples: 100"), std::string::npos);
+  std::cout << report;
+
+  for (void* ptr : leak_ptrs) tracker.Free(ptr);
+  for (const auto& sample : tracker.GetLiveSamples()) EXPECT_NE(sample.domain, domain);
+
+  tracker.SetSampleInterval(0);
+}
+
+TEST(ALLOC_TRACKER_TEST, SampleRate) {
+  auto& tracker = AllocTracker::Instance();
+  uint32_t domain = tracker.RegisterDomain("test.sample_rate");
+  tracker.SetSampleInterval(100);
+
+  constexpr int kLoops = 100000;
+  std::vector<void*> ptrs;
+  ptrs.reserve(kLoops);
+  for (int ii = 0; ii < kLoops; ++ii) ptrs.emplace_back(tracker.Allocate(domain, 8));
+
+  size_t sampled = 0;
+  for (const auto& sample : tracker.GetLiveSamples()) {
+    if (sample.domain == domain) ++sampled;
+  }
+  EXPECT_GT(sampled, kLoops / 100 / 2);
+  EXPECT_LT(sampled, kLoops / 100 * 2);
+
+  for (void* ptr : ptrs) tracker.Free(ptr);
+  tracker.SetSampleInterval(0);
+}
+
+TEST(ALLOC_TRACKER_TEST, Benchmark) {
+  auto& tracker = AllocTracker::Instance();
+  uint32_t domain = tracker.RegisterDomain("test.benchmark");
+
+  constexpr int kLoops = 1000000;
+  constexpr size_t kSize = 256;
+
+  auto run = [&](auto&& alloc, auto&& free) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int ii = 0; ii < kLoops; ++ii) {
+      void* ptr = alloc();
+      static_cast<volatile char*>(ptr)[0] = 1;
+      free(ptr);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / kLoops;
+  };
+
+  const double malloc_ns = run([&] { return std::malloc(kSize); }, [](void* ptr) { std::free(ptr); });
+
+  tracker.SetSampleInterval(0);
+  const double tracked_ns = run([&] { return tracker.Allocate(domain, kSize); }, [&](void* ptr) { tracker.Free(ptr); });
+
+  tracker.SetSampleInterval(1000);
+  const double sampled_ns = run([&] { return tracker.Allocate(domain, kSize); }, [&](void* ptr) { tracker.Free(ptr); });
+  tracker.SetSampleInterval(0);
+
+  std::cout << "malloc/free " << malloc_ns << " ns, tracked " << tracked_ns
+            << " ns, tracked with 1/1000 sampling " << sampled_ns << " ns" << std::endl;
+}
+
+}  // namespace aimrt::common::util
@@ -5,6 +5,8 @@
 #include <type_traits>
 #include <utility>
 
+#include "util/epoch_reclamation.h"
+
 namespace aimrt::common::util {
 /**
  * @brief A implementation of lock-free fixed size hash map
@@ -29,6 +31,10 @@ class AtomicHashMap {
     return table_[index].Has(key);
   }
 
+  /**
+   * @brief Get pointer of value, caller must hold an EpochGuard while using it,
+   * since a concurrent Set may replace and retire the value
+   */
   bool Get(K key, V **value) {
     uint64_t index = key & mode_num_;
     return table_[index].Get(key, value);
@@ -36,6 +42,7 @@ class AtomicHashMap {
 
   bool Get(K key, V *value) {
     uint64_t index = key & mode_num_;
+    EpochGuard guard;
     V *val = nullptr;
     bool res = table_[index].Get(key, &val);
     if (res) {
@@ -140,7 +147,8 @@ class AtomicHashMap {
           if (target->value_ptr.compare_exchange_strong(
                   old_val_ptr, new_value, std::memory_order_acq_rel,
                   std::memory_order_relaxed)) {
-            delete old_val_ptr;
+            // readers may still hold the old value, free it after they leave
+            EpochManager::Instance().Retire(old_val_ptr);
             if (new_entry) {
               delete new_entry;
               new_entry = nullptr;
@@ -183,7 +191,8 @@ class AtomicHashMap {
           if (target->value_ptr.compare_exchange_strong(
                   old_val_ptr, new_value, std::memory_order_acq_rel,
                   std::memory_order_relaxed)) {
-            delete old_val_ptr;
+            // readers may still hold the old value, free it after they leave
+            EpochManager::Instance().Retire(old_val_ptr);
             if (new_entry) {
               delete new_entry;
               new_entry = nullptr;
@@ -226,7 +235,8 @@ class AtomicHashMap {
           if (target->value_ptr.compare_exchange_strong(
                   old_val_ptr, new_value, std::memory_order_acq_rel,
                   std::memory_order_relaxed)) {
-            delete old_val_ptr;
+            // readers may still hold the old value, free it after they leave
+            EpochManager::Instance().Retire(old_val_ptr);
             if (new_entry) {
               delete new_entry;
               new_entry = nullptr;
@@ -3,40 +3,63 @@
 
 #pragma once
 
-#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
 #include <mutex>
 #include <optional>
-#include <queue>
-#include <stdexcept>
+#include <vector>
 #include "util/macros.h"
+#include "util/sync_primitives.h"
 
 namespace aimrt::common::util {
 
 /**
- * @brief 阻塞队列停止异常类
- * 
- * 当阻塞队列被停止后，继续进行入队或出队操作时抛出该异常
+ * @brief 阻塞队列操作结果
  */
-class BlockQueueStoppedException : public std::runtime_error {
- public:
-  BlockQueueStoppedException() : std::runtime_error("BlockQueue is stopped") {}
+enum class BlockQueueStatus : uint32_t {
+  kOk,       ///< 操作成功
+  kEmpty,    ///< 非阻塞出队时队列为空
+  kFull,     ///< 有界队列已满且不允许等待
+  kTimeout,  ///< 限时等待超时
+  kStopped,  ///< 队列已停止(出队时表示停止且已取空)
+};
+
+/**
+ * @brief 有界队列已满时的入队策略
+ */
+enum class BlockQueueFullPolicy : uint32_t {
+  kBlock,  ///< 阻塞直到有空位或队列停止
+  kFail,   ///< 立即返回kFull
 };
 
 /**
  * @brief 线程安全的阻塞队列实现
- * 
+ *
  * @tparam T 队列中存储的元素类型
- * 
+ *
  * 该队列具有以下特点：
- * 1. 支持多线程安全的入队和出队操作
- * 2. 提供阻塞和非阻塞的出队方式
- * 3. 支持优雅停止队列操作
- * 4. 支持左值和右值入队
+ * 1. 支持多线程安全的入队和出队操作,所有操作通过BlockQueueStatus返回结果,不抛出异常
+ * 2. 可选容量上限,满时按BlockQueueFullPolicy阻塞或失败
+ * 3. 提供阻塞、限时(EnqueueFor/DequeueFor)、非阻塞和批量(DrainTo)出队方式
+ * 4. 停止后拒绝新元素,但消费者仍可取完剩余元素,取空后返回kStopped
+ * 5. 入队只在确有消费者睡眠等待时才执行唤醒系统调用;元素数量由原子变量维护,
+ *    空队列的非阻塞出队以及等待前的条件检查都不需要加锁
  */
 template <class T>
 class BlockQueue {
  public:
-  BlockQueue() = default;
+  /**
+   * @brief 构造队列
+   *
+   * @param capacity 容量上限,0表示无上限
+   * @param full_policy 有界队列已满时Enqueue的行为
+   */
+  explicit BlockQueue(size_t capacity = 0, BlockQueueFullPolicy full_policy = BlockQueueFullPolicy::kBlock)
+      : capacity_(capacity), full_policy_(full_policy) {}
   ~BlockQueue() { Stop(); }
 
   // 禁用拷贝构造和赋值操作，保证队列的唯一性
@@ -45,103 +68,256 @@ class BlockQueue {
 
   /**
    * @brief 将元素入队（左值版本）
-   * 
+   *
    * @param item 待入队的元素
-   * @throw BlockQueueStoppedException 如果队列已停止则抛出异常
+   * @return BlockQueueStatus kOk、kFull(kFail策略下队列已满)或kStopped
    */
-  void Enqueue(const T &item) {
-    std::unique_lock<std::mutex> lck(mutex_);
-    if (!running_flag_) throw BlockQueueStoppedException();
-    queue_.emplace(item);
-    cond_.notify_one();
-  }
+  BlockQueueStatus Enqueue(const T &item) { return EnqueueImpl(item, nullptr); }
 
   /**
    * @brief 将元素入队（右值版本）
-   * 
+   *
+   * 仅在返回kOk时item才被移走,失败时调用方仍持有该元素
+   *
    * @param item 待入队的元素
-   * @throw BlockQueueStoppedException 如果队列已停止则抛出异常
+   * @return BlockQueueStatus kOk、kFull(kFail策略下队列已满)或kStopped
+   */
+  BlockQueueStatus Enqueue(T &&item) { return EnqueueImpl(std::move(item), nullptr); }
+
+  /**
+   * @brief 非阻塞入队,队列已满时立即返回kFull(与满队列策略无关)
    */
-  void Enqueue(T &&item) {
-    std::unique_lock<std::mutex> lck(mutex_);
-    if (!running_flag_) throw BlockQueueStoppedException();
-    queue_.emplace(std::move(item));
-    cond_.notify_one();
+  BlockQueueStatus TryEnqueue(const T &item) { return TryPush(item); }
+  BlockQueueStatus TryEnqueue(T &&item) { return TryPush(std::move(item)); }
+
+  /**
+   * @brief 限时入队,有界队列已满时最多等待timeout
+   *
+   * @return BlockQueueStatus kOk、kTimeout或kStopped
+   */
+  template <class Rep, class Period>
+  BlockQueueStatus EnqueueFor(const T &item, std::chrono::duration<Rep, Period> timeout) {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    return EnqueueImpl(item, &deadline);
+  }
+
+  template <class Rep, class Period>
+  BlockQueueStatus EnqueueFor(T &&item, std::chrono::duration<Rep, Period> timeout) {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    return EnqueueImpl(std::move(item), &deadline);
   }
 
   /**
    * @brief 阻塞式出队操作
-   * 
-   * @return T 队首元素
-   * @throw BlockQueueStoppedException 如果队列已停止则抛出异常
-   * 
+   *
+   * @param item 输出参数,接收队首元素
+   * @return BlockQueueStatus kOk,或队列已停止且已取空时返回kStopped
+   *
    * 当队列为空时，调用线程将被阻塞，直到：
    * 1. 有新元素入队
    * 2. 队列被停止
    */
-  T Dequeue() {
-    std::unique_lock<std::mutex> lck(mutex_);
-    cond_.wait(lck, [this] { return !queue_.empty() || !running_flag_; });
-    if (!running_flag_) throw BlockQueueStoppedException();
-    T item = std::move(queue_.front());
-    queue_.pop();
-    return item;
+  BlockQueueStatus Dequeue(T *item) { return DequeueImpl(item, nullptr); }
+
+  /**
+   * @brief 限时出队操作
+   *
+   * @param item 输出参数,接收队首元素
+   * @param timeout 最长等待时间
+   * @return BlockQueueStatus kOk、kTimeout或kStopped
+   */
+  template <class Rep, class Period>
+  BlockQueueStatus DequeueFor(T *item, std::chrono::duration<Rep, Period> timeout) {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    return DequeueImpl(item, &deadline);
   }
 
   /**
    * @brief 非阻塞式出队操作
-   * 
+   *
    * @return std::optional<T> 如果队列非空，返回队首元素；否则返回std::nullopt
-   * 
-   * 该方法不会阻塞调用线程，适用于无需等待的场景
+   *
+   * 该方法不会阻塞调用线程，适用于无需等待的场景。队列为空时不加锁
    */
   std::optional<T> TryDequeue() {
-    std::lock_guard<std::mutex> lck(mutex_);
-    if (omnirt_unlikely(queue_.empty() || !running_flag_))
-      return std::nullopt;
+    std::optional<T> item;
+    if (size_.load(std::memory_order_acquire) == 0) return item;
 
-    T item = std::move(queue_.front());
-    queue_.pop();
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      if (omnirt_unlikely(queue_.empty())) return item;
+      item.emplace(std::move(queue_.front()));
+      queue_.pop_front();
+      size_.store(queue_.size(), std::memory_order_release);
+    }
+    if (capacity_ != 0) not_full_.NotifyOne();
     return item;
   }
 
+  /**
+   * @brief 非阻塞式出队操作(状态码版本)
+   *
+   * @param item 输出参数,接收队首元素
+   * @return BlockQueueStatus kOk、kEmpty,或队列已停止且已取空时返回kStopped
+   */
+  BlockQueueStatus TryDequeue(T *item) {
+    if (std::optional<T> result = TryDequeue()) {
+      *item = std::move(*result);
+      return BlockQueueStatus::kOk;
+    }
+    return IsRunning() || Size() != 0 ? BlockQueueStatus::kEmpty : BlockQueueStatus::kStopped;
+  }
+
+  /**
+   * @brief 非阻塞批量出队,一次加锁取出最多max_items个元素追加到out
+   *
+   * @param out 输出迭代器
+   * @param max_items 最多取出的元素个数
+   * @return size_t 实际取出的元素个数
+   */
+  template <class OutputIt>
+  size_t DrainTo(OutputIt out, size_t max_items = SIZE_MAX) {
+    if (max_items == 0 || size_.load(std::memory_order_acquire) == 0) return 0;
+
+    size_t count = 0;
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      while (count < max_items && !queue_.empty()) {
+        *out = std::move(queue_.front());
+        ++out;
+        queue_.pop_front();
+        ++count;
+      }
+      size_.store(queue_.size(), std::memory_order_release);
+    }
+    if (count > 0 && capacity_ != 0) not_full_.NotifyAll();
+    return count;
+  }
+
+  size_t DrainTo(std::vector<T> &out, size_t max_items = SIZE_MAX) {
+    return DrainTo(std::back_inserter(out), max_items);
+  }
+
   /**
    * @brief 停止队列操作
-   * 
+   *
    * 停止后的效果：
    * 1. 所有阻塞的线程被唤醒
-   * 2. 后续的入队和出队操作将抛出异常
+   * 2. 后续的入队操作返回kStopped
+   * 3. 出队操作继续取出剩余元素,取空后返回kStopped
    */
   void Stop() {
-    std::unique_lock<std::mutex> lck(mutex_);
-    running_flag_ = false;
-    cond_.notify_all();
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      running_flag_.store(false, std::memory_order_release);
+    }
+    not_empty_.NotifyAll();
+    not_full_.NotifyAll();
   }
 
   /**
    * @brief 获取队列当前大小
-   * 
+   *
    * @return size_t 队列中的元素个数
    */
-  size_t Size() const {
-    std::lock_guard<std::mutex> lck(mutex_);
-    return queue_.size();
-  }
+  size_t Size() const { return size_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 获取队列容量上限,0表示无上限
+   */
+  size_t Capacity() const { return capacity_; }
 
   /**
    * @brief 检查队列是否在运行状态
-   * 
+   *
    * @return bool 如果队列正在运行返回true，否则返回false
    */
-  bool IsRunning() const {
-    std::lock_guard<std::mutex> lck(mutex_);
-    return running_flag_;
-  }
+  bool IsRunning() const { return running_flag_.load(std::memory_order_acquire); }
 
  protected:
-  mutable std::mutex mutex_;          ///< 互斥锁，保护队列的并发访问
-  std::condition_variable cond_;      ///< 条件变量，用于线程同步
-  std::queue<T> queue_;              ///< 底层队列容器
-  bool running_flag_ = true;         ///< 队列运行状态标志
+  bool Full() const { return capacity_ != 0 && queue_.size() >= capacity_; }
+
+  /**
+   * @brief 加锁尝试入队一次,成功后按需唤醒消费者
+   */
+  template <class U>
+  BlockQueueStatus TryPush(U &&item) {
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      if (omnirt_unlikely(!running_flag_.load(std::memory_order_relaxed))) return BlockQueueStatus::kStopped;
+      if (Full()) return BlockQueueStatus::kFull;
+      queue_.emplace_back(std::forward<U>(item));
+      size_.store(queue_.size(), std::memory_order_release);
+    }
+    // 只有消费者已登记睡眠时才会产生系统调用
+    not_empty_.NotifyOne();
+    return BlockQueueStatus::kOk;
+  }
+
+  template <class U>
+  BlockQueueStatus EnqueueImpl(U &&item, const sync_detail::Clock::time_point *deadline) {
+    while (true) {
+      const BlockQueueStatus status = TryPush(std::forward<U>(item));
+      if (status != BlockQueueStatus::kFull) return status;
+      if (deadline == nullptr && full_policy_ == BlockQueueFullPolicy::kFail) return status;
+
+      const auto key = not_full_.PrepareWait();
+      if (size_.load(std::memory_order_acquire) < capacity_ || !IsRunning()) {
+        not_full_.CancelWait();
+        continue;
+      }
+      if (!Wait(not_full_, key, deadline)) return BlockQueueStatus::kTimeout;
+    }
+  }
+
+  BlockQueueStatus DequeueImpl(T *item, const sync_detail::Clock::time_point *deadline) {
+    while (true) {
+      if (std::optional<T> result = TryDequeue()) {
+        *item = std::move(*result);
+        return BlockQueueStatus::kOk;
+      }
+      if (!IsRunning()) {
+        // 停止标志与元素数量在同一把锁内修改,此处重新检查可保证停止前入队的元素都被取走
+        if (size_.load(std::memory_order_acquire) == 0) return BlockQueueStatus::kStopped;
+        continue;
+      }
+
+      // 突发流量下元素往往很快到达,先短暂自旋避免睡眠
+      if (sync_detail::SpinFor([this] { return size_.load(std::memory_order_acquire) != 0 || !IsRunning(); })) {
+        continue;
+      }
+
+      const auto key = not_empty_.PrepareWait();
+      if (size_.load(std::memory_order_acquire) != 0 || !IsRunning()) {
+        not_empty_.CancelWait();
+        continue;
+      }
+      if (!Wait(not_empty_, key, deadline)) return BlockQueueStatus::kTimeout;
+    }
+  }
+
+  static bool Wait(EventCount &event, EventCount::Key key, const sync_detail::Clock::time_point *deadline) {
+    if (deadline == nullptr) {
+      event.Wait(key);
+      return true;
+    }
+    const auto now = sync_detail::Clock::now();
+    if (now >= *deadline) {
+      event.CancelWait();
+      return false;
+    }
+    event.WaitFor(key, *deadline - now);
+    // 被唤醒或超时都回到循环重新检查,超时与否由下一轮的截止时间判断
+    return true;
+  }
+
+  mutable std::mutex mutex_;                  ///< 互斥锁，保护队列的并发访问
+  std::deque<T> queue_;                       ///< 底层队列容器
+  std::atomic<size_t> size_{0};               ///< 元素个数,在锁内更新,允许无锁读取
+  std::atomic<bool> running_flag_{true};      ///< 队列运行状态标志,在锁内修改
+  const size_t capacity_;                     ///< 容量上限,0表示无上限
+  const BlockQueueFullPolicy full_policy_;    ///< 已满时的入队策略
+  EventCount not_empty_;                      ///< 消费者等待元素到达
+  EventCount not_full_;                       ///< 生产者等待空位
 };
 }  // namespace aimrt::common::util
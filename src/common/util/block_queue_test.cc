@@ -2,6 +2,10 @@
 // All rights reserved.
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
 #include <thread>
 #include "util/block_queue.h"
 
@@ -17,8 +21,10 @@ namespace aimrt::common::util {
  */
 TEST(BlockQueueTest, EnqueueDequeue) {
   BlockQueue<int> queue;
-  queue.Enqueue(1);
-  ASSERT_EQ(1, queue.Dequeue());
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.Enqueue(1));
+  int item = 0;
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.Dequeue(&item));
+  ASSERT_EQ(1, item);
 }
 
 /**
@@ -76,7 +82,8 @@ TEST(BlockQueueTest, MultipleThreads) {
 
   threads.emplace_back([&]() {
     for (int i = 0; i < 5; ++i) {
-      auto item = queue.Dequeue();
+      int item = -1;
+      ASSERT_EQ(BlockQueueStatus::kOk, queue.Dequeue(&item));
       ASSERT_GE(item, 0);
     }
   });
@@ -88,23 +95,220 @@ TEST(BlockQueueTest, MultipleThreads) {
 
 /**
  * @brief 测试BlockQueue的停止功能
- * 
+ *
  * 测试要点：
- * - 验证队列停止后的异常处理机制
- * - 测试入队操作抛出预期异常
- * - 测试出队操作抛出预期异常
- * 
- * 异常验证：
- * - 入队操作应抛出BlockQueueStoppedException
- * - 出队操作应抛出BlockQueueStoppedException
+ * - 停止后入队返回kStopped,不抛出异常
+ * - 停止前已入队的元素仍可被取出
+ * - 取空后出队返回kStopped
  */
 TEST(BlockQueueTest, Stop) {
   BlockQueue<int> queue;
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.Enqueue(1));
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.Enqueue(2));
+
+  queue.Stop();
+  ASSERT_FALSE(queue.IsRunning());
+  ASSERT_EQ(BlockQueueStatus::kStopped, queue.Enqueue(3));
+
+  int item = 0;
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.Dequeue(&item));
+  ASSERT_EQ(1, item);
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.TryDequeue(&item));
+  ASSERT_EQ(2, item);
+  ASSERT_EQ(BlockQueueStatus::kStopped, queue.Dequeue(&item));
+  ASSERT_EQ(BlockQueueStatus::kStopped, queue.TryDequeue(&item));
+}
+
+/**
+ * @brief 测试Stop唤醒阻塞中的消费者
+ */
+TEST(BlockQueueTest, StopWakesConsumer) {
+  BlockQueue<int> queue;
+  std::thread consumer([&]() {
+    int item = 0;
+    EXPECT_EQ(BlockQueueStatus::kStopped, queue.Dequeue(&item));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  queue.Stop();
+  consumer.join();
+}
+
+/**
+ * @brief 测试有界队列的满队列策略
+ *
+ * 测试要点：
+ * - kFail策略下Enqueue立即返回kFull,右值元素不被移走
+ * - TryEnqueue总是非阻塞
+ * - kBlock策略下Enqueue阻塞直到消费者腾出空位
+ */
+TEST(BlockQueueTest, Capacity) {
+  BlockQueue<std::string> failing(2, BlockQueueFullPolicy::kFail);
+  ASSERT_EQ(2u, failing.Capacity());
+  ASSERT_EQ(BlockQueueStatus::kOk, failing.Enqueue(std::string("a")));
+  ASSERT_EQ(BlockQueueStatus::kOk, failing.Enqueue(std::string("b")));
+  std::string rejected = "c";
+  ASSERT_EQ(BlockQueueStatus::kFull, failing.Enqueue(std::move(rejected)));
+  ASSERT_EQ("c", rejected);
+  ASSERT_EQ(BlockQueueStatus::kFull, failing.TryEnqueue(rejected));
+  ASSERT_EQ(2u, failing.Size());
+
+  BlockQueue<int> blocking(1);
+  ASSERT_EQ(BlockQueueStatus::kOk, blocking.Enqueue(1));
+  ASSERT_EQ(BlockQueueStatus::kFull, blocking.TryEnqueue(2));
+
+  std::atomic<bool> pushed{false};
+  std::thread producer([&]() {
+    EXPECT_EQ(BlockQueueStatus::kOk, blocking.Enqueue(2));
+    pushed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_FALSE(pushed.load());
+
+  int item = 0;
+  ASSERT_EQ(BlockQueueStatus::kOk, blocking.Dequeue(&item));
+  ASSERT_EQ(1, item);
+  producer.join();
+  ASSERT_TRUE(pushed.load());
+  ASSERT_EQ(BlockQueueStatus::kOk, blocking.Dequeue(&item));
+  ASSERT_EQ(2, item);
+}
+
+/**
+ * @brief 测试限时入队和出队
+ */
+TEST(BlockQueueTest, Timeout) {
+  BlockQueue<int> queue(1);
+  int item = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_EQ(BlockQueueStatus::kTimeout, queue.DequeueFor(&item, std::chrono::milliseconds(20)));
+  ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+  ASSERT_EQ(BlockQueueStatus::kTimeout, queue.DequeueFor(&item, std::chrono::milliseconds(0)));
+
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.EnqueueFor(1, std::chrono::milliseconds(20)));
+  start = std::chrono::steady_clock::now();
+  ASSERT_EQ(BlockQueueStatus::kTimeout, queue.EnqueueFor(2, std::chrono::milliseconds(20)));
+  ASSERT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+  std::thread producer([&]() {
+    int value = 0;
+    EXPECT_EQ(BlockQueueStatus::kOk, queue.Dequeue(&value));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(BlockQueueStatus::kOk, queue.Enqueue(3));
+  });
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.EnqueueFor(2, std::chrono::seconds(5)));
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.DequeueFor(&item, std::chrono::seconds(5)));
+  ASSERT_EQ(2, item);
+  ASSERT_EQ(BlockQueueStatus::kOk, queue.DequeueFor(&item, std::chrono::seconds(5)));
+  ASSERT_EQ(3, item);
+  producer.join();
+
+  queue.Stop();
+  ASSERT_EQ(BlockQueueStatus::kStopped, queue.DequeueFor(&item, std::chrono::seconds(5)));
+}
+
+/**
+ * @brief 测试批量出队
+ */
+TEST(BlockQueueTest, DrainTo) {
+  BlockQueue<int> queue;
+  std::vector<int> out;
+  ASSERT_EQ(0u, queue.DrainTo(out));
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(BlockQueueStatus::kOk, queue.Enqueue(i));
+  }
+  ASSERT_EQ(4u, queue.DrainTo(out, 4));
+  ASSERT_EQ(6u, queue.Size());
+  ASSERT_EQ(6u, queue.DrainTo(out));
+  ASSERT_EQ(0u, queue.Size());
+  ASSERT_EQ(10u, out.size());
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(i, out[i]);
+  }
+}
 
+/**
+ * @brief 多生产者多消费者压力测试
+ *
+ * 有界阻塞队列,停止前所有元素都必须被取出,且每个生产者的元素保持先后顺序
+ */
+TEST(BlockQueueTest, MultiProducerMultiConsumer) {
+  constexpr int kProducers = 4;
+  constexpr int kConsumers = 4;
+  constexpr int kItemsPerProducer = 20000;
+  BlockQueue<int> queue(64);
+
+  std::atomic<int64_t> sum{0};
+  std::atomic<int> count{0};
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < kConsumers; ++c) {
+    consumers.emplace_back([&]() {
+      std::vector<int> last(kProducers, -1);
+      std::vector<int> batch;
+      int item = 0;
+      while (queue.Dequeue(&item) == BlockQueueStatus::kOk) {
+        batch.clear();
+        batch.push_back(item);
+        queue.DrainTo(batch, 16);
+        for (int value : batch) {
+          const int producer = value / kItemsPerProducer;
+          EXPECT_GT(value, last[producer]);
+          last[producer] = value;
+          sum += value;
+          ++count;
+        }
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p]() {
+      for (int i = 0; i < kItemsPerProducer; ++i) {
+        EXPECT_EQ(BlockQueueStatus::kOk, queue.Enqueue(p * kItemsPerProducer + i));
+      }
+    });
+  }
+  for (auto& t : producers) t.join();
   queue.Stop();
+  for (auto& t : consumers) t.join();
 
-  ASSERT_THROW(queue.Enqueue(1), BlockQueueStoppedException);
-  ASSERT_THROW(queue.Dequeue(), BlockQueueStoppedException);
+  constexpr int64_t kTotal = static_cast<int64_t>(kProducers) * kItemsPerProducer;
+  ASSERT_EQ(kTotal, count.load());
+  ASSERT_EQ(kTotal * (kTotal - 1) / 2, sum.load());
+}
+
+/**
+ * @brief 单生产者单消费者吞吐基准
+ *
+ * 消费者保持忙碌时生产者不产生唤醒系统调用;批量出队进一步减少加锁次数
+ */
+TEST(BlockQueueTest, Benchmark) {
+  constexpr int kItems = 1000000;
+  for (bool batch : {false, true}) {
+    BlockQueue<int> queue;
+    const auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+      int item = 0;
+      std::vector<int> items;
+      items.reserve(256);
+      while (queue.Dequeue(&item) == BlockQueueStatus::kOk) {
+        if (batch) {
+          items.clear();
+          queue.DrainTo(items, 256);
+        }
+      }
+    });
+    for (int i = 0; i < kItems; ++i) {
+      queue.Enqueue(i);
+    }
+    queue.Stop();
+    consumer.join();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "BlockQueue " << (batch ? "Dequeue+DrainTo" : "Dequeue") << ": " << kItems << " items, "
+              << static_cast<double>(ns) / kItems << " ns/item" << std::endl;
+  }
 }
 
 }  // namespace aimrt::common::util
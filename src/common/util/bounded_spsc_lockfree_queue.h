@@ -28,6 +28,8 @@
 #include <cassert>
 #include <cstring>
 
+#include "memory_backing.h"
+
 // C++11 兼容的对齐内存分配函数
 #if !defined(_MSC_VER)
 inline void* aligned_malloc(size_t alignment, size_t size) {
@@ -98,7 +100,23 @@ class BoundedSpscLockfreeQueue {
    * @return true 初始化成功
    * @return false 初始化失败(size无效或内存分配失败)
    */
-  bool Init(uint64_t size, bool force_power_of_two = false);
+  bool Init(uint64_t size, bool force_power_of_two = false) {
+    return Init(size, force_power_of_two, MemoryBackingOptions());
+  }
+
+  /**
+   * @brief 按指定的页面策略初始化队列
+   *
+   * 元素存储区域改为独立映射,可使用大页、预缺页、mlock和NUMA绑定,
+   * 适用于点云等大元素的长队列。不支持的策略会回退到普通页面,见Backing()。
+   *
+   * @param size 队列大小
+   * @param force_power_of_two 是否强制size为2的幂
+   * @param backing 元素存储区域的页面策略
+   * @return true 初始化成功
+   * @return false 初始化失败(size无效或内存分配失败)
+   */
+  bool Init(uint64_t size, bool force_power_of_two, const MemoryBackingOptions& backing);
 
   /**
    * @brief 将元素入队
@@ -150,6 +168,42 @@ class BoundedSpscLockfreeQueue {
    */
   bool DequeueLatest(T* element);
 
+  /**
+   * @brief 获取队尾的空闲槽位,供生产者原地写入
+   * 
+   * 生产者直接在槽位中构造数据,写入完成后调用CommitReserved发布,
+   * 避免先构造临时对象再整体拷贝入队。只能由生产者线程调用。
+   * 
+   * @return T* 队尾槽位
+   * @return nullptr 队列已满或未初始化
+   */
+  T* Reserve();
+
+  /**
+   * @brief 发布通过Reserve写入的槽位
+   * 
+   * 必须在Reserve返回非空之后调用,且两次调用之间不能有其他入队操作。
+   */
+  void CommitReserved();
+
+  /**
+   * @brief 获取队首元素,供消费者原地读取
+   * 
+   * 元素在调用PopFront之前保持有效,生产者不会覆盖该槽位
+   * (覆盖式入队除外)。只能由消费者线程调用。
+   * 
+   * @return T* 队首元素
+   * @return nullptr 队列为空或未初始化
+   */
+  T* Front();
+
+  /**
+   * @brief 弹出通过Front读取的队首元素
+   * 
+   * 必须在Front返回非空之后调用。
+   */
+  void PopFront();
+
   // 状态查询
   /**
    * @brief 返回队列当前元素数量
@@ -179,6 +233,11 @@ class BoundedSpscLockfreeQueue {
    */
   uint64_t Capacity() const { return pool_size_; }
 
+  /**
+   * @brief 元素存储区域实际生效的页面策略
+   */
+  const MemoryBackingResult& Backing() const { return pool_region_.Backing(); }
+
  protected:
   // 存储在共享内存中的队列头部结构
   struct alignas(CACHELINE_SIZE) QueueHeader {
@@ -195,6 +254,7 @@ class BoundedSpscLockfreeQueue {
   QueueHeader* header_{nullptr};  // 指向共享内存中的队列头部结构
   uint64_t pool_size_{0};            // 队列容量(本地缓存)
   T* pool_{nullptr};             // 元素存储区域 
+  MemoryRegion pool_region_;     // 指定页面策略时元素存储区域所在的映射
 
  protected:
   // 受保护的辅助方法
@@ -240,7 +300,9 @@ BoundedSpscLockfreeQueue<T>::~BoundedSpscLockfreeQueue() {
     for (uint64_t i = 0; i < header_->pool_size_; ++i) {
       pool_[i].~T();
     }
-    aligned_free(pool_);
+    if (pool_region_.Data() == nullptr) {
+      aligned_free(pool_);
+    }
   }
   
   // 释放队列头部结构内存
@@ -251,7 +313,7 @@ BoundedSpscLockfreeQueue<T>::~BoundedSpscLockfreeQueue() {
 }
 
 template <typename T>
-bool BoundedSpscLockfreeQueue<T>::Init(uint64_t size, bool force_power_of_two) {
+bool BoundedSpscLockfreeQueue<T>::Init(uint64_t size, bool force_power_of_two, const MemoryBackingOptions& backing) {
   if (header_ != nullptr || pool_ != nullptr || size == 0 || size > QUEUE_MAX_SIZE) {
     return false;
   }
@@ -275,9 +337,17 @@ bool BoundedSpscLockfreeQueue<T>::Init(uint64_t size, bool force_power_of_two) {
   header_->pool_size_ = size;
   header_->use_mask_ = force_power_of_two;
   header_->pool_size_mask_ = header_->pool_size_ - 1;
+  pool_size_ = size;
 
   // C++11兼容的分配方式，替换std::aligned_alloc
-  pool_ = static_cast<T*>(aligned_malloc(alignof(T), header_->pool_size_ * sizeof(T)));
+  // posix_memalign要求对齐值至少为sizeof(void*)，统一按缓存行对齐
+  if (backing.IsDefault()) {
+    pool_ = static_cast<T*>(aligned_malloc(alignof(T) > CACHELINE_SIZE ? alignof(T) : CACHELINE_SIZE,
+                                           header_->pool_size_ * sizeof(T)));
+  } else if (pool_region_.Allocate(header_->pool_size_ * sizeof(T), backing)) {
+    // 映射按页对齐,满足缓存行对齐要求
+    pool_ = static_cast<T*>(pool_region_.Data());
+  }
   if (pool_ == nullptr) {
     return false;
   }
@@ -355,6 +425,46 @@ bool BoundedSpscLockfreeQueue<T>::DequeueLatest(T* element) {
   return true;
 }
 
+template <typename T>
+T* BoundedSpscLockfreeQueue<T>::Reserve() {
+  if (header_ == nullptr || pool_ == nullptr) {
+    return nullptr;
+  }
+
+  const uint64_t cur_tail = header_->tail_.load(std::memory_order_relaxed);
+  const uint64_t cur_head = header_->head_.load(std::memory_order_acquire);
+  if (cur_tail - cur_head >= header_->pool_size_) {
+    return nullptr;  // 队列已满
+  }
+  return &pool_[GetIndex(cur_tail)];
+}
+
+template <typename T>
+void BoundedSpscLockfreeQueue<T>::CommitReserved() {
+  const uint64_t cur_tail = header_->tail_.load(std::memory_order_relaxed);
+  header_->tail_.store(cur_tail + 1, std::memory_order_release);
+}
+
+template <typename T>
+T* BoundedSpscLockfreeQueue<T>::Front() {
+  if (header_ == nullptr || pool_ == nullptr) {
+    return nullptr;
+  }
+
+  const uint64_t cur_head = header_->head_.load(std::memory_order_relaxed);
+  const uint64_t cur_tail = header_->tail_.load(std::memory_order_acquire);
+  if (cur_head == cur_tail) {
+    return nullptr;  // 队列为空
+  }
+  return &pool_[GetIndex(cur_head)];
+}
+
+template <typename T>
+void BoundedSpscLockfreeQueue<T>::PopFront() {
+  const uint64_t cur_head = header_->head_.load(std::memory_order_relaxed);
+  header_->head_.store(cur_head + 1, std::memory_order_release);
+}
+
 template <typename T>
 uint64_t BoundedSpscLockfreeQueue<T>::Size() const {
   if (header_ == nullptr || pool_ == nullptr) {
@@ -132,6 +132,46 @@ TEST_F(BoundedSpscLockfreeQueueTest, DequeueLatest) {
   EXPECT_TRUE(queue_.Empty());  // Queue should be empty after DequeueLatest
 }
 
+/**
+ * @brief 测试原地写入/读取功能
+ * 
+ * 测试要点：
+ * - Reserve返回的槽位在CommitReserved之前对消费者不可见
+ * - 队列满时Reserve返回nullptr
+ * - Front返回的元素在PopFront之后才被移出
+ */
+TEST_F(BoundedSpscLockfreeQueueTest, ReserveAndFront) {
+  ASSERT_TRUE(queue_.Init(2));
+
+  EXPECT_EQ(queue_.Front(), nullptr);
+
+  int* slot = queue_.Reserve();
+  ASSERT_NE(slot, nullptr);
+  *slot = 7;
+  EXPECT_TRUE(queue_.Empty());  // Not visible before commit
+  queue_.CommitReserved();
+  EXPECT_EQ(queue_.Size(), 1);
+
+  slot = queue_.Reserve();
+  ASSERT_NE(slot, nullptr);
+  *slot = 8;
+  queue_.CommitReserved();
+  EXPECT_EQ(queue_.Reserve(), nullptr);  // Queue is full
+
+  int* front = queue_.Front();
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(*front, 7);
+  EXPECT_EQ(queue_.Size(), 2);  // Still in queue before pop
+  queue_.PopFront();
+
+  front = queue_.Front();
+  ASSERT_NE(front, nullptr);
+  EXPECT_EQ(*front, 8);
+  queue_.PopFront();
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(queue_.Front(), nullptr);
+}
+
 /**
  * @brief 测试并发生产者-消费者场景
  * 
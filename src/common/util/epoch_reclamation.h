@@ -0,0 +1,292 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "util/macros.h"
+
+namespace aimrt::common::util {
+
+/**
+ * @brief 基于epoch的内存回收(EBR)
+ *
+ * 用于无锁结构中被摘除节点的延迟释放:
+ * 1. 读者在访问共享指针前进入临界区(EpochGuard),进入/退出只涉及本线程记录,无共享写
+ * 2. 写者摘除对象后调用Retire,对象挂在本线程的退休列表上,并记录当时的全局epoch
+ * 3. 所有处于临界区的线程都观察到当前epoch后,全局epoch才能前进;退休于epoch e的对象在全局epoch到达e+2后释放
+ *
+ * 不在临界区的线程(包括长期空闲的线程)不会阻碍epoch前进。
+ * 若某个线程停滞在临界区内,epoch无法前进,退休对象会累积;单个线程的退休列表超过上限后,
+ * Retire会等待停滞的读者离开(写者背压),以此保证垃圾总量有界。需要长时间持有引用的场景应使用hazard pointer。
+ */
+class EpochManager {
+ public:
+  using Deleter = void (*)(void*);
+
+  struct Retired {
+    void* ptr;
+    Deleter deleter;
+    uint64_t epoch;
+  };
+
+  /**
+   * @brief 线程记录,线程退出后归还,可被其它线程复用,永不释放
+   */
+  struct alignas(64) Record {
+    std::atomic<uint64_t> state{0};  ///< (epoch << 1) | 是否在临界区
+    std::atomic<bool> in_use{false};
+    Record* next = nullptr;
+
+    // 以下成员只由持有该记录的线程访问
+    uint32_t nesting = 0;
+    uint32_t retire_count = 0;
+    std::vector<Retired> retired;  ///< 按epoch非降序
+  };
+
+  /**
+   * @brief 进程级实例,故意不析构,保证线程退出和静态对象析构期间仍可使用
+   */
+  static EpochManager& Instance() {
+    static EpochManager* const manager = new EpochManager();
+    return *manager;
+  }
+
+  EpochManager(const EpochManager&) = delete;
+  EpochManager& operator=(const EpochManager&) = delete;
+
+  /**
+   * @brief 进入临界区,可嵌套
+   *
+   * @return Record* 本线程记录,传给Leave
+   */
+  Record* Enter() {
+    Record* rec = LocalRecord();
+    if (rec->nesting++ == 0) {
+      rec->state.store((global_epoch_.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_release);
+      // 公告必须先于之后对共享指针的读取对其它线程可见
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    return rec;
+  }
+
+  void Leave(Record* rec) {
+    if (--rec->nesting == 0) {
+      rec->state.store(rec->state.load(std::memory_order_relaxed) & ~uint64_t(1), std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief 当前线程是否在临界区内
+   */
+  bool InCriticalSection() { return LocalRecord()->nesting != 0; }
+
+  /**
+   * @brief 退休一个已从共享结构中摘除的对象,待所有可能持有它的读者离开后释放
+   *
+   * @param ptr 对象指针,为nullptr时忽略
+   * @param deleter 释放函数
+   */
+  void Retire(void* ptr, Deleter deleter) {
+    if (ptr == nullptr) return;
+
+    Record* rec = LocalRecord();
+    // 摘除操作必须先于读取全局epoch
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    rec->retired.emplace_back(Retired{ptr, deleter, global_epoch_.load(std::memory_order_relaxed)});
+    pending_.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t max_pending = max_pending_per_thread_.load(std::memory_order_relaxed);
+    if (++rec->retire_count < kCollectInterval && rec->retired.size() < max_pending) return;
+    rec->retire_count = 0;
+
+    TryAdvance();
+    CollectRecord(rec);
+
+    // 背压: 在临界区内等待会与自身死锁,此时只能放任累积
+    if (omnirt_unlikely(rec->retired.size() >= max_pending) && rec->nesting == 0) {
+      while (rec->retired.size() >= max_pending / 2) {
+        if (!TryAdvance()) std::this_thread::yield();
+        CollectRecord(rec);
+      }
+    }
+  }
+
+  template <class T>
+  void Retire(T* ptr) {
+    Retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  /**
+   * @brief 尝试推进全局epoch
+   *
+   * @return true 全局epoch已前进(可能由其它线程推进)
+   * @return false 有临界区内的线程尚未观察到当前epoch
+   */
+  bool TryAdvance() {
+    uint64_t epoch = global_epoch_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (Record* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      const uint64_t state = rec->state.load(std::memory_order_acquire);
+      if ((state & 1) && (state >> 1) != epoch) return false;
+    }
+    global_epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel, std::memory_order_acquire);
+    return true;
+  }
+
+  /**
+   * @brief 释放当前线程和已退出线程遗留的、可以安全释放的对象
+   *
+   * @return size_t 本次释放的对象个数
+   */
+  size_t Collect() {
+    TryAdvance();
+    return CollectRecord(LocalRecord()) + CollectOrphans();
+  }
+
+  /**
+   * @brief 等待调用前退休的全部对象可以释放并释放之,不能在临界区内调用
+   *
+   * 若有线程停滞在临界区内,会一直等待
+   */
+  void Synchronize() {
+    const uint64_t target = global_epoch_.load(std::memory_order_acquire) + 2;
+    while (global_epoch_.load(std::memory_order_acquire) < target) {
+      if (!TryAdvance()) std::this_thread::yield();
+    }
+    CollectRecord(LocalRecord());
+    CollectOrphans();
+  }
+
+  /**
+   * @brief 当前全局epoch
+   */
+  uint64_t Epoch() const { return global_epoch_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 已退休但尚未释放的对象个数
+   */
+  size_t PendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 设置单个线程退休列表的上限,超过后Retire进入背压等待
+   */
+  void SetMaxPendingPerThread(size_t max_pending) {
+    max_pending_per_thread_.store(std::max<size_t>(max_pending, 2 * kCollectInterval), std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t kCollectInterval = 64;
+
+  EpochManager() = default;
+
+  struct ThreadHandle {
+    Record* rec = nullptr;
+    ~ThreadHandle() {
+      if (rec != nullptr) EpochManager::Instance().ReleaseRecord(rec);
+    }
+  };
+
+  Record* LocalRecord() {
+    static thread_local ThreadHandle handle;
+    if (omnirt_unlikely(handle.rec == nullptr)) handle.rec = AcquireRecord();
+    return handle.rec;
+  }
+
+  Record* AcquireRecord() {
+    for (Record* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      bool expected = false;
+      if (!rec->in_use.load(std::memory_order_relaxed) &&
+          rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return rec;
+      }
+    }
+
+    auto* rec = new Record();
+    rec->in_use.store(true, std::memory_order_relaxed);
+    rec->next = records_.load(std::memory_order_relaxed);
+    while (!records_.compare_exchange_weak(rec->next, rec, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return rec;
+  }
+
+  void ReleaseRecord(Record* rec) {
+    CollectRecord(rec);
+    if (!rec->retired.empty()) {
+      std::lock_guard<std::mutex> lck(orphan_mutex_);
+      orphans_.insert(orphans_.end(), rec->retired.begin(), rec->retired.end());
+    }
+    rec->retired.clear();
+    rec->retired.shrink_to_fit();
+    rec->nesting = 0;
+    rec->retire_count = 0;
+    rec->state.store(0, std::memory_order_release);
+    rec->in_use.store(false, std::memory_order_release);
+  }
+
+  size_t CollectRecord(Record* rec) {
+    const uint64_t epoch = global_epoch_.load(std::memory_order_acquire);
+    auto itr = rec->retired.begin();
+    while (itr != rec->retired.end() && itr->epoch + 2 <= epoch) ++itr;
+    if (itr == rec->retired.begin()) return 0;
+
+    // 先从列表中摘出再释放,释放函数中可以再次Retire
+    std::vector<Retired> reclaimable(rec->retired.begin(), itr);
+    rec->retired.erase(rec->retired.begin(), itr);
+    return Free(reclaimable);
+  }
+
+  size_t CollectOrphans() {
+    std::vector<Retired> reclaimable;
+    {
+      std::unique_lock<std::mutex> lck(orphan_mutex_, std::try_to_lock);
+      if (!lck.owns_lock() || orphans_.empty()) return 0;
+
+      const uint64_t epoch = global_epoch_.load(std::memory_order_acquire);
+      auto itr = std::partition(orphans_.begin(), orphans_.end(),
+                                [epoch](const Retired& r) { return r.epoch + 2 > epoch; });
+      reclaimable.assign(itr, orphans_.end());
+      orphans_.erase(itr, orphans_.end());
+    }
+    return Free(reclaimable);
+  }
+
+  size_t Free(const std::vector<Retired>& reclaimable) {
+    for (const auto& r : reclaimable) r.deleter(r.ptr);
+    pending_.fetch_sub(reclaimable.size(), std::memory_order_relaxed);
+    return reclaimable.size();
+  }
+
+  std::atomic<uint64_t> global_epoch_{2};
+  std::atomic<Record*> records_{nullptr};
+  std::atomic<size_t> pending_{0};
+  std::atomic<size_t> max_pending_per_thread_{16 * 1024};
+
+  std::mutex orphan_mutex_;  ///< 保护已退出线程遗留的退休对象
+  std::vector<Retired> orphans_;
+};
+
+/**
+ * @brief EBR临界区守卫,在其生命周期内读到的共享指针不会被释放
+ */
+class EpochGuard {
+ public:
+  EpochGuard() : rec_(EpochManager::Instance().Enter()) {}
+  ~EpochGuard() { EpochManager::Instance().Leave(rec_); }
+
+  EpochGuard(const EpochGuard&) = delete;
+  EpochGuard& operator=(const EpochGuard&) = delete;
+
+ private:
+  EpochManager::Record* rec_;
+};
+
+}  // namespace aimrt::common::util
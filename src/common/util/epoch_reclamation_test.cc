@@ -0,0 +1,196 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "util/epoch_reclamation.h"
+
+namespace aimrt::common::util {
+
+namespace {
+
+std::atomic<int> g_live_nodes{0};
+
+struct Node {
+  explicit Node(uint64_t v) : value(v), check(~v) { g_live_nodes.fetch_add(1); }
+  ~Node() {
+    check = 0;
+    g_live_nodes.fetch_sub(1);
+  }
+
+  uint64_t value;
+  uint64_t check;
+};
+
+}  // namespace
+
+TEST(EPOCH_RECLAMATION_TEST, RetireAfterReaderLeaves) {
+  auto& manager = EpochManager::Instance();
+  manager.Synchronize();
+  const int live_before = g_live_nodes.load();
+
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+  std::thread reader([&] {
+    EpochGuard guard;
+    entered.store(true);
+    while (!release.load()) std::this_thread::yield();
+  });
+  while (!entered.load()) std::this_thread::yield();
+
+  manager.Retire(new Node(1));
+  EXPECT_EQ(g_live_nodes.load(), live_before + 1);
+
+  // 读者停在临界区内,epoch最多前进一次,对象不能释放
+  for (int i = 0; i < 10; ++i) manager.Collect();
+  EXPECT_EQ(g_live_nodes.load(), live_before + 1);
+
+  release.store(true);
+  reader.join();
+  manager.Synchronize();
+  EXPECT_EQ(g_live_nodes.load(), live_before);
+}
+
+TEST(EPOCH_RECLAMATION_TEST, Nested) {
+  auto& manager = EpochManager::Instance();
+  EXPECT_FALSE(manager.InCriticalSection());
+  {
+    EpochGuard outer;
+    {
+      EpochGuard inner;
+      EXPECT_TRUE(manager.InCriticalSection());
+    }
+    EXPECT_TRUE(manager.InCriticalSection());
+
+    // 在临界区内退休不会释放也不会阻塞
+    manager.Retire(new Node(2));
+  }
+  EXPECT_FALSE(manager.InCriticalSection());
+  manager.Synchronize();
+}
+
+TEST(EPOCH_RECLAMATION_TEST, IdleThreadDoesNotBlock) {
+  auto& manager = EpochManager::Instance();
+
+  std::atomic<bool> release{false};
+  std::thread idle([&] {
+    // 注册过但不在临界区的线程
+    { EpochGuard guard; }
+    while (!release.load()) std::this_thread::yield();
+  });
+
+  const uint64_t epoch = manager.Epoch();
+  manager.Retire(new Node(3));
+  manager.Synchronize();
+  EXPECT_GE(manager.Epoch(), epoch + 2);
+
+  release.store(true);
+  idle.join();
+}
+
+TEST(EPOCH_RECLAMATION_TEST, ExitedThreadGarbage) {
+  auto& manager = EpochManager::Instance();
+  manager.Synchronize();
+  const int live_before = g_live_nodes.load();
+
+  std::thread worker([&] {
+    for (int i = 0; i < 10; ++i) manager.Retire(new Node(i));
+  });
+  worker.join();
+
+  // 已退出线程遗留的对象由其它线程回收
+  manager.Synchronize();
+  EXPECT_EQ(g_live_nodes.load(), live_before);
+}
+
+TEST(EPOCH_RECLAMATION_TEST, BoundedUnderStalledReader) {
+  auto& manager = EpochManager::Instance();
+  manager.Synchronize();
+  constexpr size_t kMaxPending = 1024;
+  manager.SetMaxPendingPerThread(kMaxPending);
+
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+  std::thread reader([&] {
+    EpochGuard guard;
+    entered.store(true);
+    while (!release.load()) std::this_thread::yield();
+  });
+  while (!entered.load()) std::this_thread::yield();
+
+  std::atomic<size_t> retired{0};
+  std::atomic<size_t> max_pending{0};
+  std::thread writer([&] {
+    for (int i = 0; i < 4096; ++i) {
+      manager.Retire(new Node(i));
+      retired.fetch_add(1);
+      size_t pending = manager.PendingCount();
+      size_t cur_max = max_pending.load();
+      while (pending > cur_max && !max_pending.compare_exchange_weak(cur_max, pending)) {
+      }
+    }
+  });
+
+  // 写者在达到上限后等待停滞的读者
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_LT(retired.load(), 4096);
+  EXPECT_LE(manager.PendingCount(), kMaxPending);
+
+  release.store(true);
+  reader.join();
+  writer.join();
+  EXPECT_LE(max_pending.load(), kMaxPending);
+
+  manager.SetMaxPendingPerThread(16 * 1024);
+  manager.Synchronize();
+}
+
+TEST(EPOCH_RECLAMATION_TEST, Stress) {
+  constexpr int kReaders = 8;
+  constexpr int kWriters = 4;
+  constexpr int kUpdates = 20000;
+
+  std::atomic<Node*> shared{new Node(0)};
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> reads{0};
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < kReaders; ++r) {
+    threads.emplace_back([&] {
+      uint64_t count = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        EpochGuard guard;
+        const Node* node = shared.load(std::memory_order_acquire);
+        // 节点在临界区内一定未被释放
+        ASSERT_EQ(node->check, ~node->value);
+        ++count;
+      }
+      reads.fetch_add(count);
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; ++w) {
+    writers.emplace_back([&, w] {
+      for (int i = 0; i < kUpdates; ++i) {
+        Node* old = shared.exchange(new Node(w * kUpdates + i), std::memory_order_acq_rel);
+        EpochManager::Instance().Retire(old);
+      }
+    });
+  }
+  for (auto& t : writers) t.join();
+  stop.store(true);
+  for (auto& t : threads) t.join();
+
+  EXPECT_GT(reads.load(), 0);
+  delete shared.load();
+  EpochManager::Instance().Synchronize();
+  EXPECT_EQ(g_live_nodes.load(), 0);
+}
+
+}  // namespace aimrt::common::util
@@ -0,0 +1,904 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+//
+// 开放寻址(Swiss table)哈希表
+// 每个槽位对应1字节控制字,按组(SSE2/NEON为16个,其它平台为8个)一次比较哈希值的低7位,
+// 绝大多数查找只访问一个控制字组和一个槽位,元素连续存储,没有逐节点的内存分配。
+//
+// 提供:
+// - FlatHashMap / FlatHashSet: 元素直接存放在槽位中,扩容时会移动,不保证引用稳定
+// - NodeHashMap / NodeHashSet: 元素单独分配,槽位中只存指针,扩容和其它插入不影响元素地址
+// - FrozenHashMap / FrozenHashSet: 一次构建后只读,以较低负载因子存放,多个线程可同时无锁查询
+//
+// 哈希与比较函数同时声明is_transparent时支持异构查找,例如以std::string_view查找std::string键。
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "util/macros.h"
+#include "util/string_simd.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define AIMRT_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define AIMRT_FLAT_HASH_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace aimrt::common::util {
+
+/**
+ * @brief 字符串透明哈希,std::string、std::string_view与const char*键可以互相查找
+ */
+struct FlatStringHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view str) const noexcept { return static_cast<size_t>(Hash64Wy(str)); }
+};
+
+struct FlatStringEqual {
+  using is_transparent = void;
+  bool operator()(std::string_view lhs, std::string_view rhs) const noexcept { return lhs == rhs; }
+};
+
+/**
+ * @brief 默认哈希函数,字符串类型使用透明的wyhash,其余类型使用std::hash
+ */
+template <class T>
+struct FlatHash : std::hash<T> {};
+template <>
+struct FlatHash<std::string> : FlatStringHash {};
+template <>
+struct FlatHash<std::string_view> : FlatStringHash {};
+
+template <class T>
+struct FlatEqual : std::equal_to<T> {};
+template <>
+struct FlatEqual<std::string> : FlatStringEqual {};
+template <>
+struct FlatEqual<std::string_view> : FlatStringEqual {};
+
+namespace flat_hash_detail {
+
+using ctrl_t = int8_t;
+
+// 控制字: 0~127表示已占用并记录哈希值低7位,负数表示空槽、已删除或结尾哨兵
+inline constexpr ctrl_t kEmpty = -128;
+inline constexpr ctrl_t kDeleted = -2;
+inline constexpr ctrl_t kSentinel = -1;
+
+/**
+ * @brief 组内匹配结果,每个命中的槽位对应一个置位的比特
+ */
+template <uint32_t kShift>
+class BitMask {
+ public:
+  explicit BitMask(uint64_t mask) : mask_(mask) {}
+
+  explicit operator bool() const { return mask_ != 0; }
+  uint32_t Lowest() const { return static_cast<uint32_t>(__builtin_ctzll(mask_)) >> kShift; }
+
+  // 支持 for (uint32_t i : mask) 遍历命中的槽位
+  BitMask begin() const { return *this; }
+  BitMask end() const { return BitMask(0); }
+  uint32_t operator*() const { return Lowest(); }
+  BitMask& operator++() {
+    mask_ &= mask_ - 1;
+    return *this;
+  }
+  bool operator!=(const BitMask& rhs) const { return mask_ != rhs.mask_; }
+
+ private:
+  uint64_t mask_;
+};
+
+#if defined(AIMRT_FLAT_HASH_SSE2)
+
+struct Group {
+  static constexpr size_t kWidth = 16;
+  using Mask = BitMask<0>;
+
+  explicit Group(const ctrl_t* pos) : ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+  Mask Match(ctrl_t h2) const {
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+  }
+  Mask MatchEmpty() const { return Match(kEmpty); }
+  Mask MatchEmptyOrDeleted() const {
+    return Mask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(kSentinel), ctrl))));
+  }
+
+  __m128i ctrl;
+};
+
+#elif defined(AIMRT_FLAT_HASH_NEON)
+
+struct Group {
+  static constexpr size_t kWidth = 16;
+  // 每个字节压缩为4个比特,只保留其中最高位
+  using Mask = BitMask<2>;
+
+  explicit Group(const ctrl_t* pos) : ctrl(vld1q_s8(pos)) {}
+
+  static Mask ToMask(uint8x16_t cmp) {
+    const uint64_t bits = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+    return Mask(bits & 0x8888888888888888ULL);
+  }
+
+  Mask Match(ctrl_t h2) const { return ToMask(vceqq_s8(vdupq_n_s8(h2), ctrl)); }
+  Mask MatchEmpty() const { return Match(kEmpty); }
+  Mask MatchEmptyOrDeleted() const { return ToMask(vcltq_s8(ctrl, vdupq_n_s8(kSentinel))); }
+
+  int8x16_t ctrl;
+};
+
+#else
+
+/**
+ * @brief 无SIMD时用64位整数并行处理8个控制字
+ */
+struct Group {
+  static constexpr size_t kWidth = 8;
+  using Mask = BitMask<3>;
+
+  static constexpr uint64_t kLsbs = 0x0101010101010101ULL;
+  static constexpr uint64_t kMsbs = 0x8080808080808080ULL;
+
+  explicit Group(const ctrl_t* pos) {
+    memcpy(&ctrl, pos, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    ctrl = __builtin_bswap64(ctrl);
+#endif
+  }
+
+  // 可能出现假阳性(紧跟在真实命中之后的字节),调用方总会再比较键,因此不影响正确性
+  Mask Match(ctrl_t h2) const {
+    const uint64_t x = ctrl ^ (kLsbs * static_cast<uint8_t>(h2));
+    return Mask((x - kLsbs) & ~x & kMsbs);
+  }
+  Mask MatchEmpty() const { return Mask(ctrl & (~ctrl << 6) & kMsbs); }
+  Mask MatchEmptyOrDeleted() const { return Mask(ctrl & (~ctrl << 7) & kMsbs); }
+
+  uint64_t ctrl;
+};
+
+#endif
+
+/**
+ * @brief 对用户哈希值再做一次混合,使std::hash<int>等恒等哈希的高低位也足够分散
+ */
+inline size_t MixHash(size_t hash) {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(hash) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<size_t>(static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64));
+#else
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  return hash ^ (hash >> 33);
+#endif
+}
+
+inline size_t H1(size_t hash) { return hash >> 7; }
+inline ctrl_t H2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+/**
+ * @brief 当is_transparent同时存在于哈希与比较函数时,查找接口接受任意键类型
+ */
+template <bool kTransparent>
+struct KeyArgImpl {
+  template <class K, class Key>
+  using type = Key;
+};
+
+template <>
+struct KeyArgImpl<true> {
+  template <class K, class Key>
+  using type = K;
+};
+
+template <class T, class = void>
+struct IsTransparent : std::false_type {};
+template <class T>
+struct IsTransparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+// 元素直接存放在槽位中
+template <class K, class V>
+struct FlatMapPolicy {
+  using key_type = K;
+  using value_type = std::pair<K, V>;
+  using slot_type = value_type;
+
+  template <class... Args>
+  static void Construct(slot_type* slot, Args&&... args) { new (slot) value_type(std::forward<Args>(args)...); }
+  static void Destroy(slot_type* slot) { slot->~value_type(); }
+  static void Transfer(slot_type* dst, slot_type* src) {
+    new (dst) value_type(std::move(*src));
+    src->~value_type();
+  }
+  static value_type& Element(slot_type* slot) { return *slot; }
+  static const K& Key(const value_type& value) { return value.first; }
+};
+
+template <class K>
+struct FlatSetPolicy {
+  using key_type = K;
+  using value_type = K;
+  using slot_type = K;
+
+  template <class... Args>
+  static void Construct(slot_type* slot, Args&&... args) { new (slot) K(std::forward<Args>(args)...); }
+  static void Destroy(slot_type* slot) { slot->~K(); }
+  static void Transfer(slot_type* dst, slot_type* src) {
+    new (dst) K(std::move(*src));
+    src->~K();
+  }
+  static value_type& Element(slot_type* slot) { return *slot; }
+  static const K& Key(const value_type& value) { return value; }
+};
+
+// 元素单独分配,槽位中只存指针
+template <class K, class V>
+struct NodeMapPolicy {
+  using key_type = K;
+  using value_type = std::pair<const K, V>;
+  using slot_type = value_type*;
+
+  template <class... Args>
+  static void Construct(slot_type* slot, Args&&... args) { *slot = new value_type(std::forward<Args>(args)...); }
+  static void Destroy(slot_type* slot) { delete *slot; }
+  static void Transfer(slot_type* dst, slot_type* src) { *dst = *src; }
+  static value_type& Element(slot_type* slot) { return **slot; }
+  static const K& Key(const value_type& value) { return value.first; }
+};
+
+template <class K>
+struct NodeSetPolicy {
+  using key_type = K;
+  using value_type = K;
+  using slot_type = K*;
+
+  template <class... Args>
+  static void Construct(slot_type* slot, Args&&... args) { *slot = new K(std::forward<Args>(args)...); }
+  static void Destroy(slot_type* slot) { delete *slot; }
+  static void Transfer(slot_type* dst, slot_type* src) { *dst = *src; }
+  static value_type& Element(slot_type* slot) { return **slot; }
+  static const K& Key(const value_type& value) { return value; }
+};
+
+/**
+ * @brief 哈希表主体,具体的元素存储方式由Policy决定
+ *
+ * 容量为2的幂且不小于一组的宽度,控制字数组按组对齐,探测以组为单位按三角数序列前进,
+ * 最大负载因子为7/8。删除时若所在组内仍有空槽则直接置空,否则留下删除标记,标记在下次重建时清除。
+ */
+template <class Policy, class Hash, class Eq>
+class RawHashTable {
+ public:
+  using key_type = typename Policy::key_type;
+  using value_type = typename Policy::value_type;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = Eq;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+
+ protected:
+  using slot_type = typename Policy::slot_type;
+
+  static constexpr bool kTransparent = IsTransparent<Hash>::value && IsTransparent<Eq>::value;
+
+  template <class K>
+  using key_arg = typename KeyArgImpl<kTransparent>::template type<K, key_type>;
+
+ public:
+  template <bool kConst>
+  class Iterator {
+    friend class RawHashTable;
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename RawHashTable::value_type;
+    using difference_type = ptrdiff_t;
+    using reference = std::conditional_t<kConst, const value_type&, value_type&>;
+    using pointer = std::conditional_t<kConst, const value_type*, value_type*>;
+
+    Iterator() = default;
+
+    // 允许iterator隐式转换为const_iterator
+    template <bool kOtherConst, class = std::enable_if_t<kConst && !kOtherConst>>
+    Iterator(const Iterator<kOtherConst>& other) : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+    reference operator*() const { return Policy::Element(slot_); }
+    pointer operator->() const { return &Policy::Element(slot_); }
+
+    Iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      SkipEmptyOrDeleted();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) { return lhs.ctrl_ == rhs.ctrl_; }
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) { return lhs.ctrl_ != rhs.ctrl_; }
+
+   private:
+    Iterator(const ctrl_t* ctrl, slot_type* slot) : ctrl_(ctrl), slot_(slot) {}
+
+    // 控制字数组末尾有哨兵,遍历不需要记录结束位置
+    void SkipEmptyOrDeleted() {
+      while (*ctrl_ < kSentinel) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    template <bool>
+    friend class Iterator;
+
+    const ctrl_t* ctrl_ = nullptr;
+    slot_type* slot_ = nullptr;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  explicit RawHashTable(size_t bucket_count = 0, const Hash& hash = Hash(), const Eq& eq = Eq())
+      : hash_(hash), eq_(eq) {
+    if (bucket_count != 0) Resize(NormalizeCapacity(bucket_count));
+  }
+
+  RawHashTable(const RawHashTable& other) : RawHashTable(0, other.hash_, other.eq_) {
+    reserve(other.size());
+    for (const auto& value : other) EmplaceUnique(value);
+  }
+
+  RawHashTable(RawHashTable&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        growth_left_(std::exchange(other.growth_left_, 0)),
+        hash_(other.hash_),
+        eq_(other.eq_) {}
+
+  RawHashTable& operator=(const RawHashTable& other) {
+    if (this != &other) {
+      RawHashTable tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  RawHashTable& operator=(RawHashTable&& other) noexcept {
+    if (this != &other) {
+      RawHashTable tmp(std::move(other));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  ~RawHashTable() {
+    DestroySlots();
+    Deallocate(ctrl_, capacity_);
+  }
+
+  iterator begin() {
+    if (size_ == 0) return end();
+    iterator it(ctrl_, slots_);
+    it.SkipEmptyOrDeleted();
+    return it;
+  }
+  iterator end() { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+  const_iterator begin() const { return const_cast<RawHashTable*>(this)->begin(); }
+  const_iterator end() const { return const_cast<RawHashTable*>(this)->end(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  float load_factor() const { return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / capacity_; }
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return eq_; }
+
+  void clear() {
+    if (capacity_ == 0) return;
+    DestroySlots();
+    ResetCtrl();
+    size_ = 0;
+    growth_left_ = MaxLoad(capacity_);
+  }
+
+  /**
+   * @brief 预留空间,保证插入n个元素前不再扩容
+   */
+  void reserve(size_t n) {
+    if (n <= size_ + growth_left_) return;
+    // 容量足够但删除标记占用了配额时原容量重建
+    const size_t cap = CapacityFor(n);
+    Resize(cap > capacity_ ? cap : capacity_);
+  }
+
+  /**
+   * @brief 重建哈希表,容量不小于bucket_count且能容纳现有元素,也可用于缩容和清除删除标记
+   */
+  void rehash(size_t bucket_count) {
+    size_t cap = NormalizeCapacity(bucket_count);
+    const size_t need = CapacityFor(size_);
+    if (cap < need) cap = need;
+    if (size_ == 0 && bucket_count == 0) cap = 0;
+    Resize(cap);
+  }
+
+  template <class K = key_type>
+  iterator find(const key_arg<K>& key) {
+    if (size_ == 0) return end();
+    const size_t hash = MixHash(hash_(key));
+    return FindWithHash(key, hash);
+  }
+
+  template <class K = key_type>
+  const_iterator find(const key_arg<K>& key) const {
+    return const_cast<RawHashTable*>(this)->find(key);
+  }
+
+  template <class K = key_type>
+  bool contains(const key_arg<K>& key) const { return find(key) != end(); }
+
+  template <class K = key_type>
+  size_t count(const key_arg<K>& key) const { return contains(key) ? 1 : 0; }
+
+  template <class K = key_type>
+  size_t erase(const key_arg<K>& key) {
+    auto it = find(key);
+    if (it == end()) return 0;
+    EraseSlot(it.ctrl_, it.slot_);
+    return 1;
+  }
+
+  iterator erase(const_iterator pos) {
+    iterator it(pos.ctrl_, pos.slot_);
+    EraseSlot(it.ctrl_, it.slot_);
+    ++it;
+    return it;
+  }
+
+  iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    while (first != last) first = erase(first);
+    return iterator(last.ctrl_, last.slot_);
+  }
+
+  void swap(RawHashTable& other) noexcept {
+    using std::swap;
+    swap(ctrl_, other.ctrl_);
+    swap(slots_, other.slots_);
+    swap(capacity_, other.capacity_);
+    swap(size_, other.size_);
+    swap(growth_left_, other.growth_left_);
+    swap(hash_, other.hash_);
+    swap(eq_, other.eq_);
+  }
+
+  friend bool operator==(const RawHashTable& lhs, const RawHashTable& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (const auto& value : lhs) {
+      auto it = rhs.find(Policy::Key(value));
+      if (it == rhs.end() || !(*it == value)) return false;
+    }
+    return true;
+  }
+  friend bool operator!=(const RawHashTable& lhs, const RawHashTable& rhs) { return !(lhs == rhs); }
+
+ protected:
+  /**
+   * @brief 查找key,不存在时在合适位置调用construct(slot)构造新元素
+   *
+   * @return std::pair<iterator, bool> 元素位置以及是否为新插入
+   */
+  template <class K, class F>
+  std::pair<iterator, bool> FindOrInsert(const K& key, F&& construct) {
+    const size_t hash = MixHash(hash_(key));
+    if (size_ != 0) {
+      auto it = FindWithHash(key, hash);
+      if (it != end()) return {it, false};
+    }
+    const size_t index = PrepareInsert(hash);
+    construct(slots_ + index);
+    SetCtrl(index, H2(hash));
+    ++size_;
+    return {iterator(ctrl_ + index, slots_ + index), true};
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> EmplaceUnique(Args&&... args) {
+    // 先在栈上构造以取得键,插入时再移动到槽位
+    alignas(slot_type) unsigned char buf[sizeof(slot_type)];
+    auto* tmp = reinterpret_cast<slot_type*>(buf);
+    Policy::Construct(tmp, std::forward<Args>(args)...);
+    auto result = FindOrInsert(Policy::Key(Policy::Element(tmp)),
+                               [tmp](slot_type* slot) { Policy::Transfer(slot, tmp); });
+    if (!result.second) Policy::Destroy(tmp);
+    return result;
+  }
+
+ private:
+  static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+
+  static size_t NormalizeCapacity(size_t n) {
+    size_t cap = Group::kWidth;
+    while (cap < n) cap <<= 1;
+    return cap;
+  }
+
+  static size_t CapacityFor(size_t n) {
+    size_t cap = Group::kWidth;
+    while (MaxLoad(cap) < n) cap <<= 1;
+    return cap;
+  }
+
+  template <class K>
+  iterator FindWithHash(const K& key, size_t hash) {
+    const size_t group_mask = capacity_ / Group::kWidth - 1;
+    const ctrl_t h2 = H2(hash);
+    size_t group = H1(hash) & group_mask;
+    for (size_t step = 1;; ++step) {
+      const size_t base = group * Group::kWidth;
+      const Group g(ctrl_ + base);
+      for (uint32_t i : g.Match(h2)) {
+        slot_type* slot = slots_ + base + i;
+        if (omnirt_likely(eq_(Policy::Key(Policy::Element(slot)), key))) return iterator(ctrl_ + base + i, slot);
+      }
+      if (omnirt_likely(static_cast<bool>(g.MatchEmpty()))) return end();
+      group = (group + step) & group_mask;
+    }
+  }
+
+  size_t FindFirstNonFull(size_t hash) const {
+    const size_t group_mask = capacity_ / Group::kWidth - 1;
+    size_t group = H1(hash) & group_mask;
+    for (size_t step = 1;; ++step) {
+      const size_t base = group * Group::kWidth;
+      if (auto mask = Group(ctrl_ + base).MatchEmptyOrDeleted()) return base + mask.Lowest();
+      group = (group + step) & group_mask;
+    }
+  }
+
+  size_t PrepareInsert(size_t hash) {
+    if (capacity_ == 0) Resize(Group::kWidth);
+    size_t index = FindFirstNonFull(hash);
+    // 复用删除标记不消耗空槽配额
+    if (omnirt_unlikely(growth_left_ == 0 && ctrl_[index] != kDeleted)) {
+      // 删除标记较多时原容量重建即可,否则扩容一倍
+      Resize(size_ * 16 <= capacity_ * 7 ? capacity_ : capacity_ * 2);
+      index = FindFirstNonFull(hash);
+    }
+    if (ctrl_[index] == kEmpty) --growth_left_;
+    return index;
+  }
+
+  void EraseSlot(const ctrl_t* ctrl, slot_type* slot) {
+    const size_t index = static_cast<size_t>(ctrl - ctrl_);
+    Policy::Destroy(slot);
+    --size_;
+    if (Group(ctrl_ + (index & ~(Group::kWidth - 1))).MatchEmpty()) {
+      SetCtrl(index, kEmpty);
+      ++growth_left_;
+    } else {
+      SetCtrl(index, kDeleted);
+    }
+  }
+
+  void SetCtrl(size_t index, ctrl_t value) { ctrl_[index] = value; }
+
+  void ResetCtrl() {
+    memset(ctrl_, static_cast<uint8_t>(kEmpty), capacity_);
+    ctrl_[capacity_] = kSentinel;
+  }
+
+  void DestroySlots() {
+    if (size_ == 0) return;
+    for (size_t i = 0; i < capacity_; ++i) {
+      if (ctrl_[i] >= 0) Policy::Destroy(slots_ + i);
+    }
+  }
+
+  // 控制字与槽位共用一块内存: [控制字 capacity+1 字节,按组对齐][槽位]
+  static size_t CtrlBytes(size_t capacity) {
+    constexpr size_t kAlign = alignof(slot_type) > Group::kWidth ? alignof(slot_type) : Group::kWidth;
+    return (capacity + 1 + kAlign - 1) / kAlign * kAlign;
+  }
+
+  static constexpr std::align_val_t Alignment() {
+    return std::align_val_t(alignof(slot_type) > 16 ? alignof(slot_type) : 16);
+  }
+
+  static void Deallocate(ctrl_t* ctrl, size_t capacity) {
+    if (ctrl == nullptr) return;
+    ::operator delete(ctrl, CtrlBytes(capacity) + capacity * sizeof(slot_type), Alignment());
+  }
+
+  void Resize(size_t new_capacity) {
+    ctrl_t* old_ctrl = ctrl_;
+    slot_type* old_slots = slots_;
+    const size_t old_capacity = capacity_;
+
+    if (new_capacity == 0) {
+      ctrl_ = nullptr;
+      slots_ = nullptr;
+      capacity_ = growth_left_ = 0;
+    } else {
+      void* mem = ::operator new(CtrlBytes(new_capacity) + new_capacity * sizeof(slot_type), Alignment());
+      ctrl_ = static_cast<ctrl_t*>(mem);
+      slots_ = reinterpret_cast<slot_type*>(static_cast<char*>(mem) + CtrlBytes(new_capacity));
+      capacity_ = new_capacity;
+      ResetCtrl();
+      growth_left_ = MaxLoad(capacity_) - size_;
+
+      for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_ctrl[i] < 0) continue;
+        const size_t hash = MixHash(hash_(Policy::Key(Policy::Element(old_slots + i))));
+        const size_t index = FindFirstNonFull(hash);
+        SetCtrl(index, H2(hash));
+        Policy::Transfer(slots_ + index, old_slots + i);
+      }
+    }
+    Deallocate(old_ctrl, old_capacity);
+  }
+
+  ctrl_t* ctrl_ = nullptr;
+  slot_type* slots_ = nullptr;
+  size_t capacity_ = 0;
+  size_t size_ = 0;
+  size_t growth_left_ = 0;
+  Hash hash_;
+  Eq eq_;
+};
+
+/**
+ * @brief 键值表,在RawHashTable之上提供operator[]、try_emplace等接口
+ */
+template <class Policy, class Hash, class Eq>
+class RawHashMap : public RawHashTable<Policy, Hash, Eq> {
+  using Base = RawHashTable<Policy, Hash, Eq>;
+  using slot_type = typename Base::slot_type;
+
+  template <class K>
+  using key_arg = typename Base::template key_arg<K>;
+
+ public:
+  using mapped_type = typename Policy::value_type::second_type;
+  using typename Base::const_iterator;
+  using typename Base::iterator;
+  using typename Base::key_type;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  RawHashMap(std::initializer_list<value_type> init, size_t bucket_count = 0, const Hash& hash = Hash(),
+             const Eq& eq = Eq())
+      : Base(bucket_count, hash, eq) {
+    insert(init.begin(), init.end());
+  }
+
+  template <class InputIt>
+  RawHashMap(InputIt first, InputIt last, size_t bucket_count = 0, const Hash& hash = Hash(), const Eq& eq = Eq())
+      : Base(bucket_count, hash, eq) {
+    insert(first, last);
+  }
+
+  template <class K = key_type, class... Args>
+  std::pair<iterator, bool> try_emplace(const key_arg<K>& key, Args&&... args) {
+    return this->FindOrInsert(key, [&](slot_type* slot) {
+      Policy::Construct(slot, std::piecewise_construct, std::forward_as_tuple(key_type(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+    return this->FindOrInsert(key, [&](slot_type* slot) {
+      Policy::Construct(slot, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) { return this->EmplaceUnique(std::forward<Args>(args)...); }
+
+  std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return this->EmplaceUnique(std::move(value));
+  }
+
+  template <class InputIt>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) emplace(*first);
+  }
+
+  void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+  template <class K = key_type, class M>
+  std::pair<iterator, bool> insert_or_assign(const key_arg<K>& key, M&& obj) {
+    auto result = try_emplace(key, std::forward<M>(obj));
+    if (!result.second) result.first->second = std::forward<M>(obj);
+    return result;
+  }
+
+  template <class K = key_type>
+  mapped_type& operator[](const key_arg<K>& key) { return try_emplace(key).first->second; }
+  mapped_type& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+
+  template <class K = key_type>
+  mapped_type& at(const key_arg<K>& key) {
+    auto it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("FlatHashMap::at: key not found");
+    return it->second;
+  }
+
+  template <class K = key_type>
+  const mapped_type& at(const key_arg<K>& key) const {
+    auto it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("FlatHashMap::at: key not found");
+    return it->second;
+  }
+};
+
+/**
+ * @brief 集合,在RawHashTable之上提供insert/emplace接口
+ */
+template <class Policy, class Hash, class Eq>
+class RawHashSet : public RawHashTable<Policy, Hash, Eq> {
+  using Base = RawHashTable<Policy, Hash, Eq>;
+  using slot_type = typename Base::slot_type;
+
+ public:
+  using typename Base::iterator;
+  using typename Base::key_type;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  RawHashSet(std::initializer_list<value_type> init, size_t bucket_count = 0, const Hash& hash = Hash(),
+             const Eq& eq = Eq())
+      : Base(bucket_count, hash, eq) {
+    insert(init.begin(), init.end());
+  }
+
+  template <class InputIt>
+  RawHashSet(InputIt first, InputIt last, size_t bucket_count = 0, const Hash& hash = Hash(), const Eq& eq = Eq())
+      : Base(bucket_count, hash, eq) {
+    insert(first, last);
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return this->FindOrInsert(value, [&](slot_type* slot) { Policy::Construct(slot, value); });
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return this->FindOrInsert(value, [&](slot_type* slot) { Policy::Construct(slot, std::move(value)); });
+  }
+
+  template <class InputIt>
+  void insert(InputIt first, InputIt last) {
+    for (; first != last; ++first) insert(*first);
+  }
+
+  void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) { return this->EmplaceUnique(std::forward<Args>(args)...); }
+};
+
+}  // namespace flat_hash_detail
+
+/**
+ * @brief 元素直接存放在槽位中的哈希表,插入可能使已有元素的引用和迭代器失效
+ *
+ * 元素类型为std::pair<K, V>,不要修改通过迭代器拿到的键
+ */
+template <class K, class V, class Hash = FlatHash<K>, class Eq = FlatEqual<K>>
+using FlatHashMap = flat_hash_detail::RawHashMap<flat_hash_detail::FlatMapPolicy<K, V>, Hash, Eq>;
+
+template <class K, class Hash = FlatHash<K>, class Eq = FlatEqual<K>>
+using FlatHashSet = flat_hash_detail::RawHashSet<flat_hash_detail::FlatSetPolicy<K>, Hash, Eq>;
+
+/**
+ * @brief 元素单独分配的哈希表,元素地址在其被删除前保持不变,适合需要长期持有元素指针的场景
+ *
+ * 元素类型为std::pair<const K, V>
+ */
+template <class K, class V, class Hash = FlatHash<K>, class Eq = FlatEqual<K>>
+using NodeHashMap = flat_hash_detail::RawHashMap<flat_hash_detail::NodeMapPolicy<K, V>, Hash, Eq>;
+
+template <class K, class Hash = FlatHash<K>, class Eq = FlatEqual<K>>
+using NodeHashSet = flat_hash_detail::RawHashSet<flat_hash_detail::NodeSetPolicy<K>, Hash, Eq>;
+
+/**
+ * @brief 只读哈希表
+ *
+ * 构建后不可修改,只提供const查询接口,多个线程可同时无锁查询。
+ * 构建时把负载因子降到1/2以下,缩短探测长度,适合启动时建立、运行时只查询的注册表。
+ *
+ * @tparam Table FlatHashMap/FlatHashSet等
+ */
+template <class Table>
+class FrozenHashTable {
+ public:
+  using key_type = typename Table::key_type;
+  using value_type = typename Table::value_type;
+  using const_iterator = typename Table::const_iterator;
+  using iterator = const_iterator;
+
+  FrozenHashTable() = default;
+
+  explicit FrozenHashTable(Table table) : table_(std::move(table)) { table_.rehash(table_.size() * 2); }
+
+  FrozenHashTable(std::initializer_list<value_type> init) : FrozenHashTable(Table(init)) {}
+
+  template <class InputIt>
+  FrozenHashTable(InputIt first, InputIt last) : FrozenHashTable(Table(first, last)) {}
+
+  const_iterator begin() const { return table_.begin(); }
+  const_iterator end() const { return table_.end(); }
+  bool empty() const { return table_.empty(); }
+  size_t size() const { return table_.size(); }
+
+  template <class K>
+  const_iterator find(const K& key) const { return table_.find(key); }
+
+  template <class K>
+  bool contains(const K& key) const { return table_.contains(key); }
+
+  template <class K>
+  size_t count(const K& key) const { return table_.count(key); }
+
+  template <class K>
+  decltype(auto) at(const K& key) const { return table_.at(key); }
+
+  /**
+   * @brief 查找值,不存在时返回nullptr(仅键值表)
+   */
+  template <class K, class T = Table>
+  auto Find(const K& key) const -> const typename T::mapped_type* {
+    auto it = table_.find(key);
+    return it == table_.end() ? nullptr : &it->second;
+  }
+
+  const Table& Get() const { return table_; }
+
+ private:
+  Table table_;
+};
+
+template <class K, class V, class Hash = FlatHash<K>, class Eq = FlatEqual<K>>
+using FrozenHashMap = FrozenHashTable<FlatHashMap<K, V, Hash, Eq>>;
+
+template <class K, class Hash = FlatHash<K>, class Eq = FlatEqual<K>>
+using FrozenHashSet = FrozenHashTable<FlatHashSet<K, Hash, Eq>>;
+
+}  // namespace aimrt::common::util
@@ -0,0 +1,421 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "util/flat_hash_map.h"
+
+namespace aimrt::common::util {
+
+namespace {
+
+// 统计存活对象个数,检查构造与析构是否配对
+struct Counted {
+  static inline int alive = 0;
+
+  explicit Counted(int v = 0) : value(v) { ++alive; }
+  Counted(const Counted& other) : value(other.value) { ++alive; }
+  Counted(Counted&& other) noexcept : value(other.value) { ++alive; }
+  Counted& operator=(const Counted&) = default;
+  Counted& operator=(Counted&&) = default;
+  ~Counted() { --alive; }
+
+  bool operator==(const Counted& rhs) const { return value == rhs.value; }
+
+  int value;
+};
+
+// 所有键哈希到同一个值,用于测试长探测链
+struct BadHash {
+  size_t operator()(int) const { return 42; }
+};
+
+template <class Map>
+void CheckSameAsStd(Map& map, const std::unordered_map<int, int>& ref) {
+  ASSERT_EQ(map.size(), ref.size());
+  size_t visited = 0;
+  for (const auto& kv : map) {
+    auto it = ref.find(kv.first);
+    ASSERT_NE(it, ref.end());
+    ASSERT_EQ(it->second, kv.second);
+    ++visited;
+  }
+  ASSERT_EQ(visited, ref.size());
+}
+
+// 与std::unordered_map做随机差分测试
+template <class Map>
+void RandomOpsTest(int key_range, int ops) {
+  Map map;
+  std::unordered_map<int, int> ref;
+  std::mt19937 rng(key_range);
+  for (int i = 0; i < ops; ++i) {
+    const int key = static_cast<int>(rng() % key_range);
+    switch (rng() % 6) {
+      case 0:
+      case 1: {
+        const bool inserted = map.try_emplace(key, i).second;
+        ASSERT_EQ(inserted, ref.try_emplace(key, i).second);
+        break;
+      }
+      case 2:
+        map[key] = i;
+        ref[key] = i;
+        break;
+      case 3:
+      case 4:
+        ASSERT_EQ(map.erase(key), ref.erase(key));
+        break;
+      default: {
+        auto it = map.find(key);
+        auto ref_it = ref.find(key);
+        ASSERT_EQ(it == map.end(), ref_it == ref.end());
+        if (it != map.end()) {
+          ASSERT_EQ(it->second, ref_it->second);
+        }
+      }
+    }
+    if (i % 1000 == 0) CheckSameAsStd(map, ref);
+  }
+  CheckSameAsStd(map, ref);
+}
+
+}  // namespace
+
+TEST(FLAT_HASH_MAP_TEST, Basic) {
+  FlatHashMap<int, std::string> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.erase(1), 0);
+
+  EXPECT_TRUE(map.emplace(1, "one").second);
+  EXPECT_FALSE(map.emplace(1, "uno").second);
+  EXPECT_TRUE(map.insert({2, "two"}).second);
+  EXPECT_TRUE(map.try_emplace(3, 3, 'x').second);
+  map[4] = "four";
+  EXPECT_EQ(map.size(), 4);
+  EXPECT_EQ(map.at(1), "one");
+  EXPECT_EQ(map[3], "xxx");
+  EXPECT_THROW(map.at(5), std::out_of_range);
+  EXPECT_TRUE(map.contains(2));
+  EXPECT_EQ(map.count(5), 0);
+
+  EXPECT_FALSE(map.insert_or_assign(2, "deux").second);
+  EXPECT_EQ(map.at(2), "deux");
+
+  EXPECT_EQ(map.erase(2), 1);
+  EXPECT_FALSE(map.contains(2));
+  auto it = map.erase(map.find(1));
+  (void)it;
+  EXPECT_EQ(map.size(), 2);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.begin(), map.end());
+  map[7] = "seven";
+  EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FLAT_HASH_MAP_TEST, HeterogeneousLookup) {
+  FlatHashMap<std::string, int> map{{"/chatter", 1}, {"/imu", 2}};
+  const std::string_view key = "/chatter";
+  EXPECT_EQ(map.find(key)->second, 1);
+  EXPECT_EQ(map.at("/imu"), 2);
+  EXPECT_TRUE(map.contains(std::string_view("/imu")));
+  EXPECT_FALSE(map.contains("/odom"));
+
+  // 不存在时才构造std::string键
+  map[std::string_view("/odom")] = 3;
+  EXPECT_TRUE(map.try_emplace(std::string_view("/tf"), 4).second);
+  EXPECT_EQ(map.size(), 4);
+  EXPECT_EQ(map.erase(std::string_view("/imu")), 1);
+
+  FlatHashSet<std::string> set{"a", "b"};
+  EXPECT_TRUE(set.contains(std::string_view("a")));
+  EXPECT_FALSE(set.contains("c"));
+
+  // 非透明哈希时只接受key_type
+  FlatHashMap<int, int> int_map{{1, 1}};
+  EXPECT_TRUE(int_map.contains(1));
+}
+
+TEST(FLAT_HASH_MAP_TEST, RandomAgainstStd) {
+  RandomOpsTest<FlatHashMap<int, int>>(100, 50000);
+  RandomOpsTest<FlatHashMap<int, int>>(5000, 200000);
+  RandomOpsTest<NodeHashMap<int, int>>(5000, 100000);
+  RandomOpsTest<FlatHashMap<int, int, BadHash>>(300, 20000);
+}
+
+TEST(FLAT_HASH_MAP_TEST, StringKeys) {
+  FlatHashMap<std::string, std::string> map;
+  std::unordered_map<std::string, std::string> ref;
+  std::mt19937 rng(7);
+  for (int i = 0; i < 50000; ++i) {
+    const std::string key = "/topic/" + std::to_string(rng() % 3000);
+    if (rng() % 3 == 0) {
+      ASSERT_EQ(map.erase(key), ref.erase(key));
+    } else {
+      map[key] = key + "_value";
+      ref[key] = key + "_value";
+    }
+  }
+  ASSERT_EQ(map.size(), ref.size());
+  for (const auto& kv : ref) ASSERT_EQ(map.at(std::string_view(kv.first)), kv.second);
+}
+
+TEST(FLAT_HASH_MAP_TEST, EraseChurn) {
+  // 反复插入删除时,删除标记会被回收,容量不会无限增长
+  FlatHashMap<int, int> map;
+  for (int i = 0; i < 100000; ++i) {
+    map[i] = i;
+    if (i >= 50) map.erase(i - 50);
+  }
+  EXPECT_EQ(map.size(), 50);
+  EXPECT_LE(map.capacity(), 128);
+
+  // 遍历中删除
+  for (auto it = map.begin(); it != map.end();) {
+    it = (it->first % 2 == 0) ? map.erase(it) : std::next(it);
+  }
+  EXPECT_EQ(map.size(), 25);
+  for (const auto& kv : map) EXPECT_EQ(kv.first % 2, 1);
+}
+
+TEST(FLAT_HASH_MAP_TEST, ReserveAndRehash) {
+  FlatHashMap<int, int> map;
+  map.reserve(1000);
+  const size_t cap = map.capacity();
+  EXPECT_GE(cap * 7 / 8, 1000);
+  for (int i = 0; i < 1000; ++i) map[i] = i;
+  EXPECT_EQ(map.capacity(), cap);
+
+  for (int i = 0; i < 990; ++i) map.erase(i);
+  map.rehash(0);
+  EXPECT_LE(map.capacity(), 16);
+  for (int i = 990; i < 1000; ++i) EXPECT_EQ(map.at(i), i);
+
+  map.clear();
+  map.rehash(0);
+  EXPECT_EQ(map.capacity(), 0);
+  map[1] = 1;
+  EXPECT_EQ(map.at(1), 1);
+}
+
+TEST(FLAT_HASH_MAP_TEST, Lifetime) {
+  ASSERT_EQ(Counted::alive, 0);
+  {
+    FlatHashMap<int, Counted> map;
+    for (int i = 0; i < 1000; ++i) map.try_emplace(i, i);
+    for (int i = 0; i < 500; ++i) map.erase(i);
+    map.emplace(1000, Counted(1000));
+    map.emplace(999, Counted(0));  // 已存在,临时对象需要被析构
+    EXPECT_EQ(Counted::alive, 501);
+
+    FlatHashMap<int, Counted> copy = map;
+    EXPECT_EQ(Counted::alive, 1002);
+    EXPECT_EQ(copy, map);
+    FlatHashMap<int, Counted> moved = std::move(copy);
+    EXPECT_EQ(Counted::alive, 1002);
+    moved.clear();
+    EXPECT_EQ(Counted::alive, 501);
+
+    NodeHashSet<int> node_set{1, 2, 3};
+    NodeHashMap<int, Counted> node_map;
+    for (int i = 0; i < 100; ++i) node_map.try_emplace(i, i);
+    EXPECT_EQ(Counted::alive, 601);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+
+  // 只能移动的值类型
+  FlatHashMap<std::string, std::unique_ptr<int>> map;
+  map.emplace("a", std::make_unique<int>(1));
+  map["b"] = std::make_unique<int>(2);
+  for (int i = 0; i < 100; ++i) map.emplace(std::to_string(i), std::make_unique<int>(i));
+  EXPECT_EQ(*map.at("a"), 1);
+  EXPECT_EQ(*map.at("b"), 2);
+}
+
+TEST(FLAT_HASH_MAP_TEST, NodeStability) {
+  NodeHashMap<std::string, int> map;
+  std::vector<std::pair<const std::string, int>*> ptrs;
+  for (int i = 0; i < 10000; ++i) {
+    auto result = map.try_emplace(std::to_string(i), i);
+    ptrs.emplace_back(&*result.first);
+  }
+  for (int i = 0; i < 10000; i += 2) map.erase(std::to_string(i));
+  for (int i = 10000; i < 20000; ++i) map.try_emplace(std::to_string(i), i);
+
+  for (int i = 1; i < 10000; i += 2) {
+    auto it = map.find(std::to_string(i));
+    ASSERT_EQ(&*it, ptrs[i]);
+    ASSERT_EQ(ptrs[i]->second, i);
+  }
+}
+
+TEST(FLAT_HASH_MAP_TEST, Set) {
+  FlatHashSet<int> set;
+  std::set<int> ref;
+  std::mt19937 rng(11);
+  for (int i = 0; i < 20000; ++i) {
+    const int v = static_cast<int>(rng() % 2000);
+    if (rng() % 2) {
+      ASSERT_EQ(set.insert(v).second, ref.insert(v).second);
+    } else {
+      ASSERT_EQ(set.erase(v), ref.erase(v));
+    }
+  }
+  EXPECT_EQ(std::set<int>(set.begin(), set.end()), ref);
+
+  FlatHashSet<std::string> strings;
+  EXPECT_TRUE(strings.emplace(3, 'a').second);
+  EXPECT_FALSE(strings.insert("aaa").second);
+  EXPECT_TRUE(strings.contains(std::string_view("aaa")));
+}
+
+TEST(FLAT_HASH_MAP_TEST, Frozen) {
+  FlatHashMap<std::string, int> builder;
+  for (int i = 0; i < 1000; ++i) builder["/topic/" + std::to_string(i)] = i;
+  const FrozenHashMap<std::string, int> frozen(std::move(builder));
+  EXPECT_EQ(frozen.size(), 1000);
+  EXPECT_LE(frozen.size() * 2, frozen.Get().capacity());
+
+  const FrozenHashSet<int> frozen_set{1, 2, 3};
+  EXPECT_TRUE(frozen_set.contains(2));
+  EXPECT_FALSE(frozen_set.contains(4));
+
+  // 多线程同时查询
+  std::vector<std::thread> threads;
+  std::atomic<int> errors{0};
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 1100; ++i) {
+          const std::string key = "/topic/" + std::to_string(i);
+          const int* value = frozen.Find(std::string_view(key));
+          if ((i < 1000) != (value != nullptr) || (value && *value != i)) ++errors;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(errors.load(), 0);
+  EXPECT_EQ(frozen.at("/topic/7"), 7);
+}
+
+TEST(FLAT_HASH_MAP_TEST, Benchmark) {
+  using Clock = std::chrono::steady_clock;
+  auto measure = [](auto&& f, size_t ops) {
+    const auto begin = Clock::now();
+    f();
+    return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / ops;
+  };
+
+  // 注册表形状: 约2000个话题名,发布时按string_view查找,10%未命中
+  constexpr int kKeys = 2000;
+  constexpr int kRounds = 200;
+  std::vector<std::string> names;
+  for (int i = 0; i < kKeys; ++i) names.emplace_back("/aimrt/robot/module_" + std::to_string(i % 50) + "/topic_" + std::to_string(i));
+  std::vector<std::string> queries;
+  std::mt19937 rng(1);
+  for (int i = 0; i < kKeys; ++i) {
+    queries.emplace_back(rng() % 10 == 0 ? "/missing/" + std::to_string(i) : names[rng() % kKeys]);
+  }
+
+  std::unordered_map<std::string, int> std_map;
+  FlatHashMap<std::string, int> flat_map;
+  FlatHashMap<std::string_view, int> view_map;
+  NodeHashMap<std::string, int> node_map;
+  const double std_build = measure([&] { for (int i = 0; i < kKeys; ++i) std_map.emplace(names[i], i); }, kKeys);
+  const double flat_build = measure([&] { for (int i = 0; i < kKeys; ++i) flat_map.emplace(names[i], i); }, kKeys);
+  for (int i = 0; i < kKeys; ++i) view_map.emplace(names[i], i);
+  for (int i = 0; i < kKeys; ++i) node_map.emplace(names[i], i);
+  const FrozenHashMap<std::string, int> frozen_map(flat_map);
+
+  uint64_t sink = 0;
+  const size_t lookups = static_cast<size_t>(kKeys) * kRounds;
+  // C++17的std::unordered_map不支持异构查找,现有代码需要先构造std::string
+  const double std_lookup = measure([&] {
+    for (int r = 0; r < kRounds; ++r)
+      for (const auto& q : queries) {
+        auto it = std_map.find(std::string(std::string_view(q)));
+        sink += it == std_map.end() ? 0 : it->second;
+      }
+  }, lookups);
+  const double flat_lookup = measure([&] {
+    for (int r = 0; r < kRounds; ++r)
+      for (const auto& q : queries) {
+        auto it = flat_map.find(std::string_view(q));
+        sink += it == flat_map.end() ? 0 : it->second;
+      }
+  }, lookups);
+  const double view_lookup = measure([&] {
+    for (int r = 0; r < kRounds; ++r)
+      for (const auto& q : queries) {
+        auto it = view_map.find(q);
+        sink += it == view_map.end() ? 0 : it->second;
+      }
+  }, lookups);
+  const double node_lookup = measure([&] {
+    for (int r = 0; r < kRounds; ++r)
+      for (const auto& q : queries) {
+        auto it = node_map.find(std::string_view(q));
+        sink += it == node_map.end() ? 0 : it->second;
+      }
+  }, lookups);
+  const double frozen_lookup = measure([&] {
+    for (int r = 0; r < kRounds; ++r)
+      for (const auto& q : queries) {
+        const int* v = frozen_map.Find(std::string_view(q));
+        sink += v ? *v : 0;
+      }
+  }, lookups);
+
+  // 整数键(如符号id)
+  constexpr int kIntKeys = 100000;
+  std::unordered_map<uint32_t, uint32_t> std_int;
+  FlatHashMap<uint32_t, uint32_t> flat_int;
+  for (uint32_t i = 0; i < kIntKeys; ++i) {
+    std_int[i * 7] = i;
+    flat_int[i * 7] = i;
+  }
+  const double std_int_lookup = measure([&] {
+    for (uint32_t i = 0; i < kIntKeys * 10; ++i) {
+      auto it = std_int.find((i * 2654435761u) % (kIntKeys * 7));
+      sink += it == std_int.end() ? 0 : it->second;
+    }
+  }, kIntKeys * 10);
+  const double flat_int_lookup = measure([&] {
+    for (uint32_t i = 0; i < kIntKeys * 10; ++i) {
+      auto it = flat_int.find((i * 2654435761u) % (kIntKeys * 7));
+      sink += it == flat_int.end() ? 0 : it->second;
+    }
+  }, kIntKeys * 10);
+
+  volatile uint64_t keep = sink;
+  (void)keep;
+  std::cout << "string keys: " << kKeys << ", 10% misses\n"
+            << "build  std::unordered_map: " << std_build << " ns/op, FlatHashMap: " << flat_build << " ns/op\n"
+            << "lookup std::unordered_map (std::string temp): " << std_lookup << " ns/op\n"
+            << "lookup FlatHashMap<std::string>:               " << flat_lookup << " ns/op\n"
+            << "lookup FlatHashMap<std::string_view>:          " << view_lookup << " ns/op\n"
+            << "lookup NodeHashMap<std::string>:               " << node_lookup << " ns/op\n"
+            << "lookup FrozenHashMap<std::string>:             " << frozen_lookup << " ns/op\n"
+            << "uint32 keys: " << kIntKeys << "\n"
+            << "lookup std::unordered_map: " << std_int_lookup << " ns/op, FlatHashMap: " << flat_int_lookup
+            << " ns/op" << std::endl;
+}
+
+}  // namespace aimrt::common::util
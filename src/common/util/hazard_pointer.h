@@ -0,0 +1,247 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "util/macros.h"
+
+namespace aimrt::common::util {
+
+/**
+ * @brief hazard pointer内存回收
+ *
+ * 与EBR相比,读者逐个公告正在访问的指针,停滞的读者只会阻止它所保护的那一个对象被释放,
+ * 每个线程未释放的退休对象不超过 max(kMinScanThreshold, 2 * 记录总数) 个,适合需要长时间持有引用的场景。
+ * 代价是每次Protect都有一次全屏障,读路径比EBR慢。
+ */
+class HazardPointerDomain {
+ public:
+  using Deleter = void (*)(void*);
+
+  /**
+   * @brief hazard记录,归还后可被复用,永不释放
+   */
+  struct alignas(64) Record {
+    std::atomic<const void*> ptr{nullptr};
+    std::atomic<bool> in_use{false};
+    Record* next = nullptr;
+  };
+
+  /**
+   * @brief 进程级实例,故意不析构,保证线程退出和静态对象析构期间仍可使用
+   */
+  static HazardPointerDomain& Instance() {
+    static HazardPointerDomain* const domain = new HazardPointerDomain();
+    return *domain;
+  }
+
+  HazardPointerDomain(const HazardPointerDomain&) = delete;
+  HazardPointerDomain& operator=(const HazardPointerDomain&) = delete;
+
+  /**
+   * @brief 取得一个hazard记录,优先使用本线程缓存
+   */
+  Record* AcquireRecord() {
+    ThreadState& state = LocalState();
+    if (!state.cache.empty()) {
+      Record* rec = state.cache.back();
+      state.cache.pop_back();
+      return rec;
+    }
+
+    for (Record* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      bool expected = false;
+      if (!rec->in_use.load(std::memory_order_relaxed) &&
+          rec->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return rec;
+      }
+    }
+
+    auto* rec = new Record();
+    rec->in_use.store(true, std::memory_order_relaxed);
+    rec->next = records_.load(std::memory_order_relaxed);
+    while (!records_.compare_exchange_weak(rec->next, rec, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    record_count_.fetch_add(1, std::memory_order_relaxed);
+    return rec;
+  }
+
+  /**
+   * @brief 归还hazard记录,调用前记录应已清空
+   */
+  void ReleaseRecord(Record* rec) {
+    ThreadState& state = LocalState();
+    if (state.cache.size() < kThreadCacheSize) {
+      state.cache.emplace_back(rec);
+      return;
+    }
+    rec->in_use.store(false, std::memory_order_release);
+  }
+
+  /**
+   * @brief 退休一个已从共享结构中摘除的对象,没有任何hazard pointer指向它时释放
+   *
+   * @param ptr 对象指针,为nullptr时忽略
+   * @param deleter 释放函数
+   */
+  void Retire(void* ptr, Deleter deleter) {
+    if (ptr == nullptr) return;
+
+    ThreadState& state = LocalState();
+    state.retired.emplace_back(Retired{ptr, deleter});
+    pending_.fetch_add(1, std::memory_order_relaxed);
+
+    const size_t threshold =
+        std::max<size_t>(kMinScanThreshold, 2 * record_count_.load(std::memory_order_relaxed));
+    if (state.retired.size() >= threshold) Scan(state.retired);
+  }
+
+  template <class T>
+  void Retire(T* ptr) {
+    Retire(static_cast<void*>(ptr), [](void* p) { delete static_cast<T*>(p); });
+  }
+
+  /**
+   * @brief 释放当前线程和已退出线程遗留的、未被保护的退休对象
+   *
+   * @return size_t 本次释放的对象个数
+   */
+  size_t Collect() {
+    size_t count = Scan(LocalState().retired);
+
+    std::vector<Retired> orphans;
+    {
+      std::unique_lock<std::mutex> lck(orphan_mutex_, std::try_to_lock);
+      if (!lck.owns_lock()) return count;
+      orphans.swap(orphans_);
+    }
+    if (orphans.empty()) return count;
+
+    count += Scan(orphans);
+    if (!orphans.empty()) {
+      std::lock_guard<std::mutex> lck(orphan_mutex_);
+      orphans_.insert(orphans_.end(), orphans.begin(), orphans.end());
+    }
+    return count;
+  }
+
+  /**
+   * @brief 已退休但尚未释放的对象个数
+   */
+  size_t PendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr size_t kMinScanThreshold = 64;
+  static constexpr size_t kThreadCacheSize = 8;
+
+  struct Retired {
+    void* ptr;
+    Deleter deleter;
+  };
+
+  struct ThreadState {
+    std::vector<Record*> cache;
+    std::vector<Retired> retired;
+
+    ~ThreadState() {
+      auto& domain = HazardPointerDomain::Instance();
+      for (Record* rec : cache) rec->in_use.store(false, std::memory_order_release);
+      cache.clear();
+
+      domain.Scan(retired);
+      if (!retired.empty()) {
+        std::lock_guard<std::mutex> lck(domain.orphan_mutex_);
+        domain.orphans_.insert(domain.orphans_.end(), retired.begin(), retired.end());
+      }
+    }
+  };
+
+  HazardPointerDomain() = default;
+
+  static ThreadState& LocalState() {
+    static thread_local ThreadState state;
+    return state;
+  }
+
+  /**
+   * @brief 收集所有hazard pointer,释放retired中未被保护的对象,被保护的留在retired中
+   */
+  size_t Scan(std::vector<Retired>& retired) {
+    // 摘除操作必须先于读取hazard pointer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    std::vector<const void*> hazards;
+    for (Record* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      const void* ptr = rec->ptr.load(std::memory_order_acquire);
+      if (ptr != nullptr) hazards.emplace_back(ptr);
+    }
+    std::sort(hazards.begin(), hazards.end());
+
+    std::vector<Retired> reclaimable;
+    auto itr = std::partition(retired.begin(), retired.end(), [&hazards](const Retired& r) {
+      return std::binary_search(hazards.begin(), hazards.end(), static_cast<const void*>(r.ptr));
+    });
+    reclaimable.assign(itr, retired.end());
+    retired.erase(itr, retired.end());
+
+    // 先从列表中摘出再释放,释放函数中可以再次Retire
+    for (const auto& r : reclaimable) r.deleter(r.ptr);
+    pending_.fetch_sub(reclaimable.size(), std::memory_order_relaxed);
+    return reclaimable.size();
+  }
+
+  std::atomic<Record*> records_{nullptr};
+  std::atomic<size_t> record_count_{0};
+  std::atomic<size_t> pending_{0};
+
+  std::mutex orphan_mutex_;  ///< 保护已退出线程遗留的退休对象
+  std::vector<Retired> orphans_;
+};
+
+/**
+ * @brief hazard pointer,RAII持有一个hazard记录
+ *
+ * 同一时刻只保护一个指针;Protect成功后直到Reset、再次Protect或析构前,该指针指向的对象不会被释放
+ */
+class HazardPointer {
+ public:
+  HazardPointer() : rec_(HazardPointerDomain::Instance().AcquireRecord()) {}
+  ~HazardPointer() {
+    Reset();
+    HazardPointerDomain::Instance().ReleaseRecord(rec_);
+  }
+
+  HazardPointer(const HazardPointer&) = delete;
+  HazardPointer& operator=(const HazardPointer&) = delete;
+
+  /**
+   * @brief 读取并保护src当前指向的对象
+   *
+   * @param src 共享指针
+   * @return T* 受保护的指针
+   */
+  template <class T>
+  T* Protect(const std::atomic<T*>& src) {
+    T* ptr = src.load(std::memory_order_relaxed);
+    while (true) {
+      rec_->ptr.store(ptr, std::memory_order_seq_cst);
+      T* cur = src.load(std::memory_order_seq_cst);
+      if (omnirt_likely(cur == ptr)) return ptr;
+      ptr = cur;
+    }
+  }
+
+  void Reset() { rec_->ptr.store(nullptr, std::memory_order_release); }
+
+ private:
+  HazardPointerDomain::Record* rec_;
+};
+
+}  // namespace aimrt::common::util
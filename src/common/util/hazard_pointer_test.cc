@@ -0,0 +1,128 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "util/hazard_pointer.h"
+
+namespace aimrt::common::util {
+
+namespace {
+
+std::atomic<int> g_live_nodes{0};
+
+struct Node {
+  explicit Node(uint64_t v) : value(v), check(~v) { g_live_nodes.fetch_add(1); }
+  ~Node() {
+    check = 0;
+    g_live_nodes.fetch_sub(1);
+  }
+
+  uint64_t value;
+  uint64_t check;
+};
+
+}  // namespace
+
+TEST(HAZARD_POINTER_TEST, ProtectedNotFreed) {
+  auto& domain = HazardPointerDomain::Instance();
+  domain.Collect();
+  const int live_before = g_live_nodes.load();
+
+  std::atomic<Node*> shared{new Node(1)};
+  Node* first = nullptr;
+  {
+    HazardPointer hp;
+    first = hp.Protect(shared);
+    EXPECT_EQ(first->value, 1);
+
+    domain.Retire(shared.exchange(new Node(2)));
+    domain.Collect();
+    EXPECT_EQ(first->check, ~uint64_t(1));
+    EXPECT_EQ(g_live_nodes.load(), live_before + 2);
+  }
+
+  // hazard pointer释放后可以回收
+  domain.Collect();
+  EXPECT_EQ(g_live_nodes.load(), live_before + 1);
+  delete shared.load();
+}
+
+TEST(HAZARD_POINTER_TEST, BoundedUnderStalledReader) {
+  auto& domain = HazardPointerDomain::Instance();
+  domain.Collect();
+
+  std::atomic<Node*> shared{new Node(0)};
+  std::atomic<bool> protected_flag{false};
+  std::atomic<bool> release{false};
+  std::thread reader([&] {
+    HazardPointer hp;
+    const Node* node = hp.Protect(shared);
+    protected_flag.store(true);
+    while (!release.load()) std::this_thread::yield();
+    EXPECT_EQ(node->check, ~node->value);
+  });
+  while (!protected_flag.load()) std::this_thread::yield();
+
+  // 停滞的读者只钉住一个对象,写者不等待,未释放对象数有界
+  size_t max_pending = 0;
+  for (int i = 1; i <= 100000; ++i) {
+    domain.Retire(shared.exchange(new Node(i)));
+    max_pending = std::max(max_pending, domain.PendingCount());
+  }
+  EXPECT_LT(max_pending, 1024);
+
+  release.store(true);
+  reader.join();
+  delete shared.load();
+  domain.Collect();
+  EXPECT_EQ(domain.PendingCount(), 0);
+}
+
+TEST(HAZARD_POINTER_TEST, Stress) {
+  constexpr int kReaders = 8;
+  constexpr int kWriters = 4;
+  constexpr int kUpdates = 20000;
+
+  std::atomic<Node*> shared{new Node(0)};
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> reads{0};
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < kReaders; ++r) {
+    threads.emplace_back([&] {
+      uint64_t count = 0;
+      HazardPointer hp;
+      while (!stop.load(std::memory_order_relaxed)) {
+        const Node* node = hp.Protect(shared);
+        ASSERT_EQ(node->check, ~node->value);
+        hp.Reset();
+        ++count;
+      }
+      reads.fetch_add(count);
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; ++w) {
+    writers.emplace_back([&, w] {
+      for (int i = 0; i < kUpdates; ++i) {
+        HazardPointerDomain::Instance().Retire(shared.exchange(new Node(w * kUpdates + i)));
+      }
+    });
+  }
+  for (auto& t : writers) t.join();
+  stop.store(true);
+  for (auto& t : threads) t.join();
+
+  EXPECT_GT(reads.load(), 0);
+  delete shared.load();
+  HazardPointerDomain::Instance().Collect();
+  EXPECT_EQ(g_live_nodes.load(), 0);
+}
+
+}  // namespace aimrt::common::util
@@ -2,41 +2,39 @@
 // All rights reserved.
 //
 // 轻量级信号量工具
-// 提供基于条件变量的线程同步机制，适用于简单的线程间通知场景。
+// 提供简单的线程间通知,基于sync_primitives.h中的手动复位事件实现。
 //
 // 主要特性:
 // 1. 轻量级设计
-//    - 基于std::condition_variable实现
-//    - 内存占用小，性能开销低
+//    - 仅包含一个32位原子状态字
+//    - 无竞争时Notify/Wait不加锁、不进入内核
 // 2. 易用性
 //    - 简单的API设计
-//    - 自动的锁管理
 // 3. 功能完备
 //    - 支持无限等待
 //    - 支持超时等待
 //    - 支持状态重置
+//    - 虚假唤醒会被自动过滤
 //
 // 使用场景:
 // - 线程间的事件通知
 // - 简单的生产者-消费者模型
 // - 异步任务完成通知
 //
-// 性能考虑:
-// - 适用于低频率的线程同步
-// - 不适合高并发场景
-// - 每次操作都需要加锁
+// 新代码可直接使用Event,需要自动复位、计数或跨进程时见sync_primitives.h。
 
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
+#include <chrono>
+
+#include "sync_primitives.h"
 
 namespace aimrt::common::util {
 
 /**
  * @brief 轻量级信号量类
  * 
- * 提供了一个基于条件变量的简单线程同步机制。
+ * 提供了一个基于futex的简单线程同步机制(手动复位事件)。
  * 可以用于线程间的事件通知，支持等待和通知操作。
  * 
  * 示例用法:
@@ -71,11 +69,7 @@ class LightSignal {
    * 线程安全: 是
    * 异常安全: 不抛出异常
    */
-  void Notify() {
-    std::lock_guard<std::mutex> lck(mutex_);
-    flag_ = true;
-    cond_.notify_all();
-  }
+  void Notify() { event_.Set(); }
 
   /**
    * @brief 等待信号
@@ -87,11 +81,7 @@ class LightSignal {
    * 线程安全: 是
    * 异常安全: 不抛出异常
    */
-  void Wait() {
-    std::unique_lock<std::mutex> lck(mutex_);
-    if (flag_) return;
-    cond_.wait(lck);
-  }
+  void Wait() { event_.Wait(); }
 
   /**
    * @brief 带超时的等待信号
@@ -108,12 +98,7 @@ class LightSignal {
    * 线程安全: 是
    * 异常安全: 不抛出异常
    */
-  bool WaitFor(std::chrono::nanoseconds timeout) {
-    std::unique_lock<std::mutex> lck(mutex_);
-    if (flag_) return true;
-    if (cond_.wait_for(lck, timeout) == std::cv_status::timeout) return false;
-    return true;
-  }
+  bool WaitFor(std::chrono::nanoseconds timeout) { return event_.WaitFor(timeout); }
 
   /**
    * @brief 重置信号状态
@@ -124,15 +109,10 @@ class LightSignal {
    * 线程安全: 是
    * 异常安全: 不抛出异常
    */
-  void Reset() {
-    std::lock_guard<std::mutex> lck(mutex_);
-    flag_ = false;
-  }
+  void Reset() { event_.Reset(); }
 
  private:
-  std::mutex mutex_;              ///< 互斥锁，保护flag_的访问
-  std::condition_variable cond_;  ///< 条件变量，用于线程等待和通知
-  bool flag_ = false;             ///< 信号状态标志
+  Event event_{EventResetMode::kManual};  ///< 信号状态
 };
 
 }  // namespace aimrt::common::util
\ No newline at end of file
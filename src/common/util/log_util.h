@@ -123,6 +123,7 @@ class src_loc {
 
 #include <string>
 #include <thread>
+#include <vector>
 #include <unistd.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
@@ -215,7 +216,7 @@ class SimpleLogger {
     thread_local size_t tid(gettid());
 #endif
 
-    auto t = std::chrono::system_clock::now();
+    auto t = GetFineTimePoint();
     std::string log_str = ::aimrt_fmt::format(
         "[{}.{:0>6}][{}][{}][{}:{}:{} @{}]{}",
         GetTimeStr(std::chrono::system_clock::to_time_t(t)),
@@ -283,7 +284,7 @@ class SimpleAsyncLogger {
     thread_local size_t tid(gettid());
 #endif
 
-    auto t = std::chrono::system_clock::now();
+    auto t = GetFineTimePoint();
     std::string log_str = ::aimrt_fmt::format(
         "[{}.{:0>6}][{}][{}][{}:{}:{} @{}]{}",
         GetTimeStr(std::chrono::system_clock::to_time_t(t)),
@@ -295,24 +296,27 @@ class SimpleAsyncLogger {
         column,
         function_name,
         std::string_view(log_data, log_data_size));
-    try {
-      queue_.Enqueue(std::move(log_str));
-    } catch (...) {
-    }
+    // 停止后的日志直接丢弃
+    queue_.Enqueue(std::move(log_str));
   }
 
  private:
   void LogThread() {
-    while (true) {
-      try {
-        auto log_str = queue_.Dequeue();
-        fprintf(stderr, "%s\n", log_str.c_str());
-      } catch (...) {
-        break;
+    // 停止后继续输出剩余日志,取空后退出;每次唤醒批量取出以减少加锁次数
+    std::string log_str;
+    std::vector<std::string> batch;
+    while (queue_.Dequeue(&log_str) == BlockQueueStatus::kOk) {
+      fprintf(stderr, "%s\n", log_str.c_str());
+      batch.clear();
+      queue_.DrainTo(batch, kDrainBatchSize);
+      for (const auto& item : batch) {
+        fprintf(stderr, "%s\n", item.c_str());
       }
     }
   }
 
+  static constexpr size_t kDrainBatchSize = 64;
+
   mutable BlockQueue<std::string> queue_;
   std::thread log_thread_;
 };
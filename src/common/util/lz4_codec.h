@@ -0,0 +1,230 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+
+#include "util/macros.h"
+
+namespace aimrt::common::util {
+
+// LZ4块格式的压缩与解压，与标准LZ4 block格式兼容，不含frame头。
+// 压缩使用单路哈希表贪心匹配，相当于LZ4的fast模式；解压对输入做完整的越界检查，可以安全地处理来自网络或录制文件的数据。
+namespace lz4_detail {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;  // 最后5个字节必须是字面量
+constexpr size_t kMfLimit = 12;      // 最后一个匹配必须在距结尾12字节之前开始
+constexpr size_t kMaxOffset = 65535;
+constexpr uint32_t kHashLog = 12;
+constexpr uint32_t kSkipTrigger = 6;  // 连续未命中时逐渐加大步长，快速跳过不可压缩的数据
+
+inline uint32_t Read32(const uint8_t* p) {
+  uint32_t val;
+  memcpy(&val, p, sizeof(val));
+  return val;
+}
+
+inline uint32_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761U) >> (32 - kHashLog);
+}
+
+/**
+ * @brief 写出变长的长度，token中的4位已经存了15
+ */
+inline uint8_t* WriteLength(uint8_t* op, size_t len) {
+  for (; len >= 255; len -= 255) *op++ = 255;
+  *op++ = static_cast<uint8_t>(len);
+  return op;
+}
+
+/**
+ * @brief 读取变长的长度，越界时返回false
+ */
+inline bool ReadLength(const uint8_t*& ip, const uint8_t* iend, size_t& len) {
+  uint8_t byte;
+  do {
+    if (omnirt_unlikely(ip >= iend)) return false;
+    byte = *ip++;
+    len += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * @brief 写出一个序列：字面量，以及可选的匹配，空间不足时返回nullptr
+ */
+inline uint8_t* WriteSequence(
+    uint8_t* op, uint8_t* oend,
+    const uint8_t* literal, size_t literal_len,
+    size_t offset, size_t match_len) {
+  // token + 字面量 + 字面量长度扩展 + offset + 匹配长度扩展
+  const size_t max_size = 1 + literal_len + (literal_len / 255 + 1) + 2 + (match_len / 255 + 1);
+  if (omnirt_unlikely(static_cast<size_t>(oend - op) < max_size)) return nullptr;
+
+  uint8_t* token = op++;
+  if (literal_len >= 15) {
+    *token = 15 << 4;
+    op = WriteLength(op, literal_len - 15);
+  } else {
+    *token = static_cast<uint8_t>(literal_len << 4);
+  }
+  memcpy(op, literal, literal_len);
+  op += literal_len;
+
+  if (match_len == 0) return op;
+
+  *op++ = static_cast<uint8_t>(offset & 0xFF);
+  *op++ = static_cast<uint8_t>(offset >> 8);
+
+  const size_t ml = match_len - kMinMatch;
+  if (ml >= 15) {
+    *token |= 15;
+    op = WriteLength(op, ml - 15);
+  } else {
+    *token |= static_cast<uint8_t>(ml);
+  }
+  return op;
+}
+
+}  // namespace lz4_detail
+
+/**
+ * @brief 最坏情况下压缩结果的长度
+ */
+inline size_t Lz4CompressBound(size_t src_size) {
+  return src_size + src_size / 255 + 16;
+}
+
+/**
+ * @brief 压缩
+ *
+ * @param src 原始数据
+ * @param src_size 原始数据长度，不能超过4GB
+ * @param dst 输出缓冲区
+ * @param dst_capacity 输出缓冲区长度，不小于Lz4CompressBound(src_size)时一定成功
+ * @return size_t 压缩后的长度，输出缓冲区不足时返回0
+ */
+inline size_t Lz4Compress(const char* src, size_t src_size, char* dst, size_t dst_capacity) {
+  using namespace lz4_detail;
+
+  const uint8_t* const base = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* const iend = base + src_size;
+  const uint8_t* anchor = base;
+  uint8_t* op = reinterpret_cast<uint8_t*>(dst);
+  uint8_t* const oend = op + dst_capacity;
+
+  if (src_size > UINT32_MAX) return 0;
+
+  if (src_size > kMfLimit) {
+    const uint8_t* const mflimit = iend - kMfLimit;
+    const uint8_t* const matchlimit = iend - kLastLiterals;
+
+    uint32_t hash_table[1 << kHashLog] = {0};
+
+    const uint8_t* ip = base + 1;
+    uint32_t search_num = 1 << kSkipTrigger;
+
+    while (ip < mflimit) {
+      const uint32_t sequence = Read32(ip);
+      const uint32_t h = Hash(sequence);
+      const uint8_t* ref = base + hash_table[h];
+      hash_table[h] = static_cast<uint32_t>(ip - base);
+
+      if (ref >= ip || static_cast<size_t>(ip - ref) > kMaxOffset || Read32(ref) != sequence) {
+        ip += (search_num++ >> kSkipTrigger);
+        continue;
+      }
+      search_num = 1 << kSkipTrigger;
+
+      // 向前扩展匹配
+      while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+
+      // 向后扩展匹配，匹配不能进入最后5个字节
+      size_t match_len = kMinMatch;
+      while (ip + match_len < matchlimit && ip[match_len] == ref[match_len]) ++match_len;
+
+      op = WriteSequence(op, oend, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - ref), match_len);
+      if (omnirt_unlikely(op == nullptr)) return 0;
+
+      ip += match_len;
+      anchor = ip;
+
+      // 补充匹配结尾处的位置，提高紧邻的下一个匹配的命中率
+      if (ip < mflimit) hash_table[Hash(Read32(ip - 2))] = static_cast<uint32_t>(ip - 2 - base);
+    }
+  }
+
+  op = WriteSequence(op, oend, anchor, static_cast<size_t>(iend - anchor), 0, 0);
+  if (omnirt_unlikely(op == nullptr)) return 0;
+
+  return static_cast<size_t>(op - reinterpret_cast<uint8_t*>(dst));
+}
+
+/**
+ * @brief 解压
+ *
+ * @param src 压缩数据
+ * @param src_size 压缩数据长度
+ * @param dst 输出缓冲区
+ * @param dst_size 原始数据长度，解压结果必须恰好为该长度
+ * @return bool 数据损坏或长度不符时返回false
+ */
+inline bool Lz4Decompress(const char* src, size_t src_size, char* dst, size_t dst_size) {
+  using namespace lz4_detail;
+
+  const uint8_t* ip = reinterpret_cast<const uint8_t*>(src);
+  const uint8_t* const iend = ip + src_size;
+  uint8_t* op = reinterpret_cast<uint8_t*>(dst);
+  uint8_t* const ostart = op;
+  uint8_t* const oend = op + dst_size;
+
+  while (true) {
+    if (omnirt_unlikely(ip >= iend)) return false;
+    const uint8_t token = *ip++;
+
+    size_t literal_len = token >> 4;
+    if (literal_len == 15 && !ReadLength(ip, iend, literal_len)) return false;
+
+    if (omnirt_unlikely(literal_len > static_cast<size_t>(iend - ip) ||
+                        literal_len > static_cast<size_t>(oend - op)))
+      return false;
+
+    memcpy(op, ip, literal_len);
+    op += literal_len;
+    ip += literal_len;
+
+    // 最后一个序列只有字面量
+    if (ip == iend) break;
+
+    if (omnirt_unlikely(iend - ip < 2)) return false;
+    const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+    ip += 2;
+    if (omnirt_unlikely(offset == 0 || offset > static_cast<size_t>(op - ostart))) return false;
+
+    size_t match_len = token & 15;
+    if (match_len == 15 && !ReadLength(ip, iend, match_len)) return false;
+    match_len += kMinMatch;
+
+    if (omnirt_unlikely(match_len > static_cast<size_t>(oend - op))) return false;
+
+    const uint8_t* match = op - offset;
+    if (offset >= match_len) {
+      memcpy(op, match, match_len);
+      op += match_len;
+    } else {
+      // 重叠的匹配(如连续重复的字节)只能逐字节拷贝
+      for (size_t ii = 0; ii < match_len; ++ii) *op++ = *match++;
+    }
+  }
+
+  return op == oend;
+}
+
+}  // namespace aimrt::common::util
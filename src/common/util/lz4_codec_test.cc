@@ -0,0 +1,122 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "util/lz4_codec.h"
+
+namespace aimrt::common::util {
+
+namespace {
+
+std::string Compress(const std::string& src) {
+  std::string dst(Lz4CompressBound(src.size()), '\0');
+  size_t dst_size = Lz4Compress(src.data(), src.size(), dst.data(), dst.size());
+  EXPECT_GT(dst_size, 0);
+  dst.resize(dst_size);
+  return dst;
+}
+
+bool Decompress(const std::string& src, size_t raw_size, std::string& dst) {
+  dst.assign(raw_size, '\0');
+  return Lz4Decompress(src.data(), src.size(), dst.data(), raw_size);
+}
+
+}  // namespace
+
+TEST(LZ4_CODEC_TEST, RoundTrip) {
+  std::mt19937 rng(42);
+
+  std::vector<std::string> inputs = {"", "a", "abcd", "hello world", std::string(12, 'x'), std::string(13, 'x')};
+
+  std::string repeated;
+  for (int ii = 0; ii < 1000; ++ii) repeated += "occupancy grid cell " + std::to_string(ii % 7) + ";";
+  inputs.emplace_back(repeated);
+
+  std::string random_data(100000, '\0');
+  for (auto& c : random_data) c = static_cast<char>(rng());
+  inputs.emplace_back(random_data);
+
+  // 长串相同字节，产生大量重叠匹配和多字节长度扩展
+  inputs.emplace_back(std::string(300000, '\0'));
+
+  for (const auto& input : inputs) {
+    std::string compressed = Compress(input);
+    std::string output;
+    ASSERT_TRUE(Decompress(compressed, input.size(), output)) << input.size();
+    EXPECT_EQ(output, input);
+  }
+
+  EXPECT_LT(Compress(repeated).size(), repeated.size() / 5);
+  EXPECT_LE(Compress(random_data).size(), Lz4CompressBound(random_data.size()));
+}
+
+TEST(LZ4_CODEC_TEST, SmallOutputBuffer) {
+  std::string input(1000, 'a');
+  std::string dst(4, '\0');
+  EXPECT_EQ(Lz4Compress(input.data(), input.size(), dst.data(), dst.size()), 0);
+}
+
+TEST(LZ4_CODEC_TEST, Malformed) {
+  std::string repeated;
+  for (int ii = 0; ii < 100; ++ii) repeated += "abcdefgh" + std::to_string(ii % 3);
+  std::string compressed = Compress(repeated);
+  std::string output;
+
+  // 长度不符
+  EXPECT_FALSE(Decompress(compressed, repeated.size() - 1, output));
+  EXPECT_FALSE(Decompress(compressed, repeated.size() + 1, output));
+
+  // 截断
+  for (size_t ii = 0; ii < compressed.size(); ++ii)
+    EXPECT_FALSE(Decompress(compressed.substr(0, ii), repeated.size(), output));
+
+  // 随机篡改，不能越界，结果不做要求
+  std::mt19937 rng(7);
+  for (int ii = 0; ii < 1000; ++ii) {
+    std::string corrupted = compressed;
+    corrupted[rng() % corrupted.size()] = static_cast<char>(rng());
+    Decompress(corrupted, repeated.size(), output);
+  }
+
+  // offset为0或超出已输出的范围
+  EXPECT_FALSE(Decompress(std::string("\x10" "a" "\x00\x00", 4), 5, output));
+  EXPECT_FALSE(Decompress(std::string("\x10" "a" "\x02\x00", 4), 5, output));
+}
+
+TEST(LZ4_CODEC_TEST, Benchmark) {
+  // 模拟占据栅格地图：大片相同的值夹杂少量障碍物
+  std::mt19937 rng(1);
+  std::string grid_map(4 * 1024 * 1024, '\0');
+  for (size_t ii = 0; ii < grid_map.size(); ++ii) {
+    if (rng() % 100 == 0) grid_map[ii] = static_cast<char>(100);
+  }
+
+  std::string random_data(4 * 1024 * 1024, '\0');
+  for (auto& c : random_data) c = static_cast<char>(rng());
+
+  for (const auto& [name, input] : {std::pair<std::string, const std::string&>{"grid map", grid_map},
+                                    std::pair<std::string, const std::string&>{"random", random_data}}) {
+    std::string compressed;
+    auto begin = std::chrono::steady_clock::now();
+    compressed = Compress(input);
+    double compress_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::string output;
+    begin = std::chrono::steady_clock::now();
+    ASSERT_TRUE(Decompress(compressed, input.size(), output));
+    double decompress_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::cout << name << ": ratio " << static_cast<double>(compressed.size()) / input.size()
+              << ", compress " << input.size() / 1024.0 / 1024.0 / compress_ms * 1000 << " MB/s"
+              << ", decompress " << input.size() / 1024.0 / 1024.0 / decompress_ms * 1000 << " MB/s" << std::endl;
+  }
+}
+
+}  // namespace aimrt::common::util
@@ -0,0 +1,310 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// 内存底座(memory backing)选项
+// 为大块、长生命周期的内存(共享内存段、环形队列、内存池)提供统一的页面策略:
+// 1. 大页: 透明大页(THP)提示或显式hugetlb大页,减少大缓冲区的TLB缺失
+// 2. 预缺页: 初始化时一次性触发所有缺页,避免运行中首次访问时出现延迟尖峰
+// 3. 锁定内存: mlock防止页面被换出
+// 4. NUMA绑定: 将页面分配到指定节点,与使用该内存的线程所在节点保持一致
+//
+// 每一项都是"尽力而为": 系统不支持或资源不足(无预留大页、RLIMIT_MEMLOCK过小、节点不存在)时
+// 回退到普通页面继续工作,实际生效的策略和回退原因记录在MemoryBackingResult中由调用方决定如何上报。
+//
+// 应用顺序: 大页提示 -> NUMA绑定 -> 预缺页 -> 锁定。NUMA策略必须在页面首次分配之前设置才能生效。
+
+#pragma once
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace omnirt::common::util {
+
+/**
+ * @brief 大页模式
+ */
+enum class HugePageMode {
+  kNone,         ///< 普通页面
+  kTransparent,  ///< 透明大页提示(madvise MADV_HUGEPAGE),由内核决定是否合并为大页
+  kExplicit,     ///< 显式hugetlb大页(需要系统预留大页),失败时回退到透明大页提示
+};
+
+/**
+ * @brief 内存底座选项
+ */
+struct MemoryBackingOptions {
+  HugePageMode huge_pages = HugePageMode::kNone;
+  bool prefault = false;  ///< 初始化时预先触发所有缺页
+  bool lock = false;      ///< mlock锁定页面,同时也会预缺页
+  int numa_node = -1;     ///< 绑定的NUMA节点,小于0表示不绑定
+
+  bool IsDefault() const { return huge_pages == HugePageMode::kNone && !prefault && !lock && numa_node < 0; }
+};
+
+/**
+ * @brief 实际生效的内存底座策略
+ */
+struct MemoryBackingResult {
+  bool explicit_huge_pages = false;     ///< 使用了显式hugetlb大页
+  bool transparent_huge_pages = false;  ///< 已设置透明大页提示
+  bool prefaulted = false;              ///< 已预缺页
+  bool locked = false;                  ///< 已锁定
+  bool numa_bound = false;              ///< 已绑定NUMA节点
+  std::string fallback;                 ///< 未能按选项生效的项及原因,全部生效时为空
+};
+
+namespace detail {
+
+// 旧内核头文件中可能缺少的常量
+#ifndef MADV_POPULATE_WRITE
+constexpr int kMadvPopulateWrite = 23;
+#else
+constexpr int kMadvPopulateWrite = MADV_POPULATE_WRITE;
+#endif
+constexpr int kMpolBind = 2;
+constexpr unsigned kMpolMfMove = 1U << 1;
+
+inline void AppendFallback(MemoryBackingResult* result, const std::string& item, int err) {
+  if (!result->fallback.empty()) {
+    result->fallback += "; ";
+  }
+  result->fallback += item;
+  if (err != 0) {
+    result->fallback += std::string(": ") + std::strerror(err);
+  }
+}
+
+/**
+ * @brief 系统默认的大页大小,读取失败时返回0
+ */
+inline size_t DefaultHugePageSize() {
+  static const size_t size = []() -> size_t {
+    FILE* file = std::fopen("/proc/meminfo", "r");
+    if (file == nullptr) {
+      return 0;
+    }
+    char line[256];
+    size_t kb = 0;
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+      if (std::sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) {
+        break;
+      }
+    }
+    std::fclose(file);
+    return kb * 1024;
+  }();
+  return size;
+}
+
+inline size_t PageSize() {
+  static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+inline size_t RoundUp(size_t size, size_t alignment) { return (size + alignment - 1) / alignment * alignment; }
+
+/**
+ * @brief 预缺页
+ *
+ * 优先使用MADV_POPULATE_WRITE(Linux 5.14+),否则逐页执行不改变内容的原子写,
+ * 对已有数据的共享内存段同样安全。
+ */
+inline void PrefaultRange(void* addr, size_t size) {
+  if (madvise(addr, size, detail::kMadvPopulateWrite) == 0) {
+    return;
+  }
+  const size_t page_size = PageSize();
+  char* begin = static_cast<char*>(addr);
+  for (size_t offset = 0; offset < size; offset += page_size) {
+    __atomic_fetch_or(begin + offset, static_cast<char>(0), __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * @brief 将映射绑定到NUMA节点(直接使用mbind系统调用,不依赖libnuma)
+ */
+inline int BindToNumaNode(void* addr, size_t size, int node) {
+  constexpr int kMaxNodes = 1024;
+  if (node >= kMaxNodes) {
+    return EINVAL;
+  }
+  unsigned long nodemask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+  nodemask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+  if (syscall(SYS_mbind, addr, size, kMpolBind, nodemask, static_cast<unsigned long>(kMaxNodes), kMpolMfMove) != 0) {
+    return errno;
+  }
+  return 0;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 对已映射的内存应用大页提示、NUMA绑定、预缺页和锁定
+ *
+ * 用于共享内存段等由调用方自行mmap的内存。显式大页只能在映射时指定,此处按透明大页提示处理。
+ *
+ * @param addr 映射起始地址,必须按页对齐
+ * @param size 映射长度
+ * @param options 选项
+ * @return MemoryBackingResult 实际生效的策略
+ */
+inline MemoryBackingResult ApplyMemoryBacking(void* addr, size_t size, const MemoryBackingOptions& options) {
+  MemoryBackingResult result;
+  if (addr == nullptr || size == 0 || options.IsDefault()) {
+    return result;
+  }
+
+  if (options.huge_pages != HugePageMode::kNone) {
+    if (madvise(addr, size, MADV_HUGEPAGE) == 0) {
+      result.transparent_huge_pages = true;
+    } else {
+      detail::AppendFallback(&result, "transparent huge pages", errno);
+    }
+  }
+
+  if (options.numa_node >= 0) {
+    const int err = detail::BindToNumaNode(addr, size, options.numa_node);
+    if (err == 0) {
+      result.numa_bound = true;
+    } else {
+      detail::AppendFallback(&result, "numa node " + std::to_string(options.numa_node), err);
+    }
+  }
+
+  if (options.prefault || options.lock) {
+    detail::PrefaultRange(addr, size);
+    result.prefaulted = true;
+  }
+
+  if (options.lock) {
+    if (mlock(addr, size) == 0) {
+      result.locked = true;
+    } else {
+      detail::AppendFallback(&result, "mlock", errno);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief 进程内私有的匿名内存区域
+ *
+ * 按MemoryBackingOptions分配页对齐的内存,显式大页不可用时回退到普通页面。
+ * 析构时解除锁定并释放。
+ */
+class MemoryRegion {
+ public:
+  MemoryRegion() = default;
+  ~MemoryRegion() { Release(); }
+
+  MemoryRegion(const MemoryRegion&) = delete;
+  MemoryRegion& operator=(const MemoryRegion&) = delete;
+
+  MemoryRegion(MemoryRegion&& other) noexcept { *this = std::move(other); }
+  MemoryRegion& operator=(MemoryRegion&& other) noexcept {
+    if (this != &other) {
+      Release();
+      data_ = other.data_;
+      size_ = other.size_;
+      mapped_size_ = other.mapped_size_;
+      result_ = std::move(other.result_);
+      other.data_ = nullptr;
+      other.size_ = 0;
+      other.mapped_size_ = 0;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief 分配内存区域
+   *
+   * @param size 字节数
+   * @param options 选项
+   * @return true 分配成功(部分选项可能已回退,见Backing())
+   * @return false 内存不足
+   */
+  bool Allocate(size_t size, const MemoryBackingOptions& options = MemoryBackingOptions()) {
+    Release();
+    if (size == 0) {
+      return false;
+    }
+
+    void* addr = MAP_FAILED;
+    std::string huge_fallback;
+    const size_t huge_page_size = detail::DefaultHugePageSize();
+    if (options.huge_pages == HugePageMode::kExplicit) {
+      if (huge_page_size == 0) {
+        huge_fallback = "explicit huge pages: huge page size unknown";
+      } else {
+        mapped_size_ = detail::RoundUp(size, huge_page_size);
+        addr = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED) {
+          huge_fallback = std::string("explicit huge pages: ") + std::strerror(errno);
+        }
+      }
+    }
+
+    const bool explicit_huge_pages = addr != MAP_FAILED;
+    if (!explicit_huge_pages) {
+      // 按大页大小取整,使透明大页能够覆盖整个区域
+      const size_t alignment =
+          options.huge_pages != HugePageMode::kNone && huge_page_size != 0 ? huge_page_size : detail::PageSize();
+      mapped_size_ = detail::RoundUp(size, alignment);
+      addr = mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (addr == MAP_FAILED) {
+        mapped_size_ = 0;
+        return false;
+      }
+    }
+
+    data_ = addr;
+    size_ = size;
+
+    MemoryBackingOptions remaining = options;
+    if (explicit_huge_pages) {
+      remaining.huge_pages = HugePageMode::kNone;
+    }
+    result_ = ApplyMemoryBacking(data_, mapped_size_, remaining);
+    result_.explicit_huge_pages = explicit_huge_pages;
+    if (!huge_fallback.empty()) {
+      result_.fallback = result_.fallback.empty() ? huge_fallback : huge_fallback + "; " + result_.fallback;
+    }
+    return true;
+  }
+
+  /**
+   * @brief 释放内存区域
+   */
+  void Release() {
+    if (data_ != nullptr) {
+      if (result_.locked) {
+        munlock(data_, mapped_size_);
+      }
+      munmap(data_, mapped_size_);
+      data_ = nullptr;
+      size_ = 0;
+      mapped_size_ = 0;
+      result_ = MemoryBackingResult();
+    }
+  }
+
+  void* Data() const { return data_; }
+  size_t Size() const { return size_; }
+  size_t MappedSize() const { return mapped_size_; }
+  const MemoryBackingResult& Backing() const { return result_; }
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+  size_t mapped_size_{0};
+  MemoryBackingResult result_;
+};
+
+}  // namespace omnirt::common::util
@@ -0,0 +1,165 @@
+#include "util/memory_backing.h"
+
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include "util/bounded_spsc_lockfree_queue.h"
+#include "util/shm_bounded_spsc_lockfree_queue.h"
+
+namespace omnirt::common::util {
+namespace {
+
+constexpr size_t kRegionSize = 32 * 1024 * 1024;
+
+/**
+ * @brief 当前线程累计的次缺页数
+ */
+long MinorFaults() {
+  struct rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  return usage.ru_minflt;
+}
+
+/**
+ * @brief 逐页写入并返回期间发生的次缺页数
+ */
+long TouchAndCountFaults(void* addr, size_t size) {
+  const long before = MinorFaults();
+  volatile char* data = static_cast<volatile char*>(addr);
+  for (size_t offset = 0; offset < size; offset += detail::PageSize()) {
+    data[offset] = 1;
+  }
+  return MinorFaults() - before;
+}
+
+/**
+ * @brief 测试预缺页后运行期访问不再产生缺页
+ *
+ * 通过getrusage统计次缺页数: 未预缺页时每个页面首次访问都会缺页,预缺页后几乎为0
+ */
+TEST(MemoryBackingTest, PrefaultAvoidsRuntimeFaults) {
+  const long pages = static_cast<long>(kRegionSize / detail::PageSize());
+
+  MemoryRegion lazy;
+  ASSERT_TRUE(lazy.Allocate(kRegionSize));
+  EXPECT_FALSE(lazy.Backing().prefaulted);
+  EXPECT_GE(TouchAndCountFaults(lazy.Data(), kRegionSize), pages / 2);
+
+  MemoryBackingOptions options;
+  options.prefault = true;
+  MemoryRegion prefaulted;
+  ASSERT_TRUE(prefaulted.Allocate(kRegionSize, options));
+  EXPECT_TRUE(prefaulted.Backing().prefaulted);
+  // 阈值留有余量: 插桩构建(如ASan)访问影子内存本身也会缺页
+  EXPECT_LT(TouchAndCountFaults(prefaulted.Data(), kRegionSize), pages / 4);
+}
+
+/**
+ * @brief 测试显式大页不可用时回退到普通页面
+ */
+TEST(MemoryBackingTest, ExplicitHugePagesFallback) {
+  MemoryBackingOptions options;
+  options.huge_pages = HugePageMode::kExplicit;
+
+  MemoryRegion region;
+  ASSERT_TRUE(region.Allocate(kRegionSize, options));
+  ASSERT_NE(region.Data(), nullptr);
+  EXPECT_GE(region.MappedSize(), kRegionSize);
+  if (!region.Backing().explicit_huge_pages) {
+    EXPECT_FALSE(region.Backing().fallback.empty());
+  }
+  memset(region.Data(), 0x5A, region.Size());
+  EXPECT_EQ(static_cast<unsigned char*>(region.Data())[kRegionSize - 1], 0x5A);
+}
+
+/**
+ * @brief 测试mlock受RLIMIT_MEMLOCK限制时回退且区域仍可用
+ */
+TEST(MemoryBackingTest, LockFallback) {
+  MemoryBackingOptions options;
+  options.lock = true;
+  MemoryRegion region;
+  ASSERT_TRUE(region.Allocate(kRegionSize, options));
+  EXPECT_TRUE(region.Backing().prefaulted);
+  if (!region.Backing().locked) {
+    EXPECT_NE(region.Backing().fallback.find("mlock"), std::string::npos);
+  }
+  memset(region.Data(), 0, region.Size());
+}
+
+/**
+ * @brief 测试NUMA绑定,节点不存在时回退
+ */
+TEST(MemoryBackingTest, NumaBinding) {
+  MemoryBackingOptions options;
+  options.numa_node = 0;
+  MemoryRegion region;
+  ASSERT_TRUE(region.Allocate(1024 * 1024, options));
+  struct stat sb;
+  if (stat("/sys/devices/system/node/node0", &sb) != 0) {
+    EXPECT_FALSE(region.Backing().numa_bound);
+  }
+
+  options.numa_node = 999;
+  MemoryRegion invalid;
+  ASSERT_TRUE(invalid.Allocate(1024 * 1024, options));
+  EXPECT_FALSE(invalid.Backing().numa_bound);
+  EXPECT_NE(invalid.Backing().fallback.find("numa node 999"), std::string::npos);
+  memset(invalid.Data(), 0, invalid.Size());
+}
+
+/**
+ * @brief 测试进程内队列使用指定页面策略的存储区域
+ */
+TEST(MemoryBackingTest, BoundedQueueBacking) {
+  struct Frame {
+    char data[4096];
+  };
+  MemoryBackingOptions options;
+  options.huge_pages = HugePageMode::kTransparent;
+  options.prefault = true;
+
+  BoundedSpscLockfreeQueue<Frame> queue;
+  ASSERT_TRUE(queue.Init(1024, true, options));
+  EXPECT_TRUE(queue.Backing().prefaulted);
+
+  Frame frame;
+  frame.data[0] = 7;
+  const long before = MinorFaults();
+  for (int i = 0; i < 1024; ++i) {
+    ASSERT_TRUE(queue.Enqueue(frame));
+  }
+  EXPECT_LT(MinorFaults() - before, 128);
+
+  Frame out;
+  ASSERT_TRUE(queue.Dequeue(&out));
+  EXPECT_EQ(out.data[0], 7);
+}
+
+/**
+ * @brief 测试共享内存队列的预缺页
+ */
+TEST(MemoryBackingTest, ShmQueuePrefault) {
+  struct Frame {
+    char data[4096];
+  };
+  shm_unlink("/test_backing");
+
+  ShmSegmentOptions options;
+  options.backing.prefault = true;
+  ShmBoundedSpscLockfreeQueue<Frame> queue;
+  ASSERT_TRUE(queue.Init("/test_backing", 2048, true, true, options));
+
+  Frame frame;
+  frame.data[0] = 3;
+  const long before = MinorFaults();
+  for (int i = 0; i < 2048; ++i) {
+    ASSERT_TRUE(queue.Enqueue(frame));
+  }
+  EXPECT_LT(MinorFaults() - before, 256);
+  queue.Close();
+}
+
+}  // namespace
+}  // namespace omnirt::common::util
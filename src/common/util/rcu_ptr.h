@@ -0,0 +1,118 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+#include "util/epoch_reclamation.h"
+#include "util/hazard_pointer.h"
+
+namespace aimrt::common::util {
+
+/**
+ * @brief RcuPtr回收策略: EBR,读路径最快,适合短临界区
+ */
+struct EpochReclaimPolicy {
+  using Guard = EpochGuard;
+
+  template <class T>
+  static T* Protect(Guard&, const std::atomic<T*>& src) { return src.load(std::memory_order_acquire); }
+
+  template <class T>
+  static void Retire(T* ptr) { EpochManager::Instance().Retire(ptr); }
+};
+
+/**
+ * @brief RcuPtr回收策略: hazard pointer,适合长时间持有快照的读者
+ */
+struct HazardReclaimPolicy {
+  using Guard = HazardPointer;
+
+  template <class T>
+  static T* Protect(Guard& guard, const std::atomic<T*>& src) { return guard.Protect(src); }
+
+  template <class T>
+  static void Retire(T* ptr) { HazardPointerDomain::Instance().Retire(ptr); }
+};
+
+/**
+ * @brief 读多写少数据的RCU式指针
+ *
+ * 读者在守卫内取得当前版本的只读快照,不加锁;写者复制当前版本、修改副本后原子地发布,
+ * 旧版本在所有读者离开后由回收策略释放。适合配置、过滤表、订阅表这类几乎只读的数据。
+ *
+ * 用法:
+ *   RcuPtr<Map> map;
+ *   { RcuPtr<Map>::Guard guard; const Map* snapshot = map.Load(guard); ... }
+ *   map.Update([](Map& m) { m.emplace(...); });
+ *
+ * @tparam T 数据类型,Update要求可拷贝
+ * @tparam Policy 回收策略
+ */
+template <class T, class Policy = EpochReclaimPolicy>
+class RcuPtr {
+ public:
+  using Guard = typename Policy::Guard;
+
+  RcuPtr() : RcuPtr(std::make_unique<T>()) {}
+  explicit RcuPtr(std::unique_ptr<T> init) : ptr_(init.release()) {}
+
+  /**
+   * @brief 析构时不能再有读者
+   */
+  ~RcuPtr() { delete ptr_.load(std::memory_order_acquire); }
+
+  RcuPtr(const RcuPtr&) = delete;
+  RcuPtr& operator=(const RcuPtr&) = delete;
+
+  /**
+   * @brief 取得当前版本,返回的指针在guard生命周期内有效
+   */
+  const T* Load(Guard& guard) const { return Policy::Protect(guard, ptr_); }
+
+  /**
+   * @brief 在守卫内对当前版本执行f,返回f的结果
+   */
+  template <class F>
+  decltype(auto) Read(F&& f) const {
+    Guard guard;
+    return std::forward<F>(f)(*Load(guard));
+  }
+
+  /**
+   * @brief 发布新版本,旧版本延迟释放
+   */
+  void Store(std::unique_ptr<T> next) {
+    T* old = ptr_.exchange(next.release(), std::memory_order_acq_rel);
+    Policy::Retire(old);
+  }
+
+  /**
+   * @brief 复制-修改-发布,与其它写者冲突时在最新版本上重试,f可能被调用多次
+   *
+   * @param f 形如void(T&)的修改函数,作用于当前版本的副本
+   */
+  template <class F>
+  void Update(F&& f) {
+    Guard guard;
+    T* cur = Policy::Protect(guard, ptr_);
+    while (true) {
+      auto next = std::make_unique<T>(*cur);
+      f(*next);
+      if (ptr_.compare_exchange_strong(cur, next.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+        next.release();
+        Policy::Retire(cur);
+        return;
+      }
+      cur = Policy::Protect(guard, ptr_);
+    }
+  }
+
+ private:
+  std::atomic<T*> ptr_;
+};
+
+}  // namespace aimrt::common::util
@@ -0,0 +1,348 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "util/macros.h"
+#include "util/memory_backing.h"
+
+namespace aimrt::common::util {
+
+/**
+ * @brief 线程内的临时内存arena
+ *
+ * 用于序列化等短生命周期的临时内存,特点:
+ * 1. 栈式作用域帧: PushFrame/PopFrame之间分配的内存在PopFrame时一次性归还,嵌套使用互不覆盖
+ * 2. 块链: 当前块不够时链接新块,已分配的内存不会移动,没有大小上限
+ * 3. 高水位收缩: 每trim_interval个最外层帧统计一次期间的最大用量,容量远超用量或块链过长时释放,
+ *    之后按高水位重新分配一个连续块,偶发的大消息不会让内存一直占着
+ * 4. 统计: 当前用量、历史高水位、容量、块数、分配次数等
+ * 5. 页面策略: 可选大页、预缺页、mlock和NUMA绑定(见memory_backing.h),指定时块改为按页映射,
+ *    最小块大小取整到页面粒度,避免收缩后反复映射;GetPersistentBuf不受影响
+ *
+ * 非线程安全,一般通过ThreadLocal()取得本线程实例
+ */
+class ScratchArena {
+ public:
+  using MemoryBackingOptions = omnirt::common::util::MemoryBackingOptions;
+
+  struct Stats {
+    size_t bytes_in_use = 0;         ///< 当前已分配字节数
+    size_t high_water = 0;           ///< 历史最大已分配字节数
+    size_t capacity = 0;             ///< 块链总容量
+    size_t chunk_count = 0;          ///< 块个数
+    size_t frame_depth = 0;          ///< 当前帧深度
+    size_t persistent_capacity = 0;  ///< GetPersistentBuf缓冲区大小
+    uint64_t alloc_count = 0;        ///< Allocate调用次数
+    uint64_t chunk_alloc_count = 0;  ///< 向系统申请块的次数
+    uint64_t trim_count = 0;         ///< 收缩次数
+  };
+
+  /**
+   * @param min_chunk_size 最小块大小
+   * @param trim_interval 每多少个最外层帧检查一次是否收缩
+   * @param backing 块的页面策略
+   */
+  explicit ScratchArena(size_t min_chunk_size = 4096, size_t trim_interval = 64,
+                        const MemoryBackingOptions& backing = MemoryBackingOptions())
+      : min_chunk_size_(std::max<size_t>(min_chunk_size, BackingGranularity(backing))),
+        trim_interval_(std::max<size_t>(trim_interval, 1)),
+        backing_(backing) {
+    frames_.reserve(16);
+  }
+
+  ~ScratchArena() {
+    ReleaseChunks(0);
+    std::free(persistent_buf_);
+  }
+
+  ScratchArena(const ScratchArena&) = delete;
+  ScratchArena& operator=(const ScratchArena&) = delete;
+
+  /**
+   * @brief 本线程的arena
+   */
+  static ScratchArena& ThreadLocal() {
+    static thread_local ScratchArena arena(4096, 64, DefaultMemoryBacking());
+    return arena;
+  }
+
+  /**
+   * @brief 设置ThreadLocal()使用的页面策略,只影响之后首次使用arena的线程
+   */
+  static void SetDefaultMemoryBacking(const MemoryBackingOptions& backing) {
+    std::lock_guard<std::mutex> lck(default_backing_mutex_);
+    default_backing_ = backing;
+  }
+
+  static MemoryBackingOptions DefaultMemoryBacking() {
+    std::lock_guard<std::mutex> lck(default_backing_mutex_);
+    return default_backing_;
+  }
+
+  /**
+   * @brief 打开一个作用域帧
+   *
+   * @return size_t 帧标识,传给PopFrame
+   */
+  size_t PushFrame() {
+    frames_.emplace_back(Mark{cur_chunk_, cur_offset_, bytes_in_use_});
+    return frames_.size() - 1;
+  }
+
+  /**
+   * @brief 关闭帧,归还该帧及其内层帧中分配的全部内存
+   *
+   * @param frame PushFrame的返回值
+   */
+  void PopFrame(size_t frame) {
+    if (omnirt_unlikely(frame >= frames_.size())) return;
+
+    const Mark mark = frames_[frame];
+    frames_.resize(frame);
+    cur_chunk_ = mark.chunk;
+    cur_offset_ = mark.offset;
+    bytes_in_use_ = mark.bytes_in_use;
+
+    if (frames_.empty() && ++window_frames_ >= trim_interval_) MaybeTrim();
+  }
+
+  /**
+   * @brief 在当前帧中分配内存
+   *
+   * @param size 字节数
+   * @param align 对齐,须为2的幂
+   * @return void* 内存地址,没有打开的帧或申请失败时返回nullptr
+   */
+  void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    if (omnirt_unlikely(frames_.empty())) return nullptr;
+    ++alloc_count_;
+
+    if (cur_chunk_ < chunks_.size()) {
+      if (void* ptr = TryBump(chunks_[cur_chunk_], size, align)) return ptr;
+    }
+
+    // 当前块不够,使用下一个足够大的块,后面的空闲块太小则释放后重新申请
+    const size_t next = (cur_chunk_ < chunks_.size()) ? cur_chunk_ + 1 : 0;
+    if (next < chunks_.size() && chunks_[next].size < size + align) ReleaseChunks(next);
+
+    if (next >= chunks_.size()) {
+      size_t chunk_size = std::max(min_chunk_size_, next_chunk_size_);
+      if (!chunks_.empty()) chunk_size = std::max(chunk_size, chunks_.back().size * 2);
+      while (chunk_size < size + align) chunk_size <<= 1;
+
+      Chunk chunk;
+      if (!AllocateChunk(chunk, chunk_size)) return nullptr;
+      capacity_ += chunk.size;
+      chunks_.emplace_back(std::move(chunk));
+      ++chunk_alloc_count_;
+      next_chunk_size_ = 0;
+    }
+
+    // 跳过当前块剩余部分,这部分不计入用量
+    cur_chunk_ = next;
+    cur_offset_ = 0;
+    return TryBump(chunks_[cur_chunk_], size, align);
+  }
+
+  /**
+   * @brief 兼容旧接口的单一线程缓冲区,内容只保证到本线程下一次调用前有效,与帧分配互不影响
+   *
+   * 按需增长;最近trim_interval次请求的最大值远小于当前大小时收缩
+   *
+   * @param size 最小字节数
+   * @return void* 缓冲区地址,申请失败时返回nullptr
+   */
+  void* GetPersistentBuf(size_t size) {
+    persistent_window_max_ = std::max(persistent_window_max_, size);
+    if (++persistent_window_calls_ >= trim_interval_) {
+      const size_t target = RoundUpPow2(std::max(persistent_window_max_, min_chunk_size_));
+      if (persistent_size_ > 2 * target) {
+        std::free(persistent_buf_);
+        persistent_buf_ = nullptr;
+        persistent_size_ = 0;
+        ++trim_count_;
+      }
+      persistent_window_max_ = 0;
+      persistent_window_calls_ = 0;
+    }
+
+    if (persistent_buf_ != nullptr && persistent_size_ >= size) return persistent_buf_;
+
+    const size_t new_size = RoundUpPow2(std::max(size, min_chunk_size_));
+    std::free(persistent_buf_);
+    persistent_buf_ = std::malloc(new_size);
+    persistent_size_ = (persistent_buf_ != nullptr) ? new_size : 0;
+    return persistent_buf_;
+  }
+
+  /**
+   * @brief 立即释放未在使用的块
+   */
+  void Trim() {
+    if (frames_.empty()) {
+      ReleaseChunks(0);
+    } else if (cur_chunk_ + 1 < chunks_.size()) {
+      ReleaseChunks(cur_chunk_ + 1);
+    }
+  }
+
+  Stats GetStats() const {
+    return Stats{
+        .bytes_in_use = bytes_in_use_,
+        .high_water = high_water_,
+        .capacity = capacity_,
+        .chunk_count = chunks_.size(),
+        .frame_depth = frames_.size(),
+        .persistent_capacity = persistent_size_,
+        .alloc_count = alloc_count_,
+        .chunk_alloc_count = chunk_alloc_count_,
+        .trim_count = trim_count_};
+  }
+
+ private:
+  struct Chunk {
+    char* data = nullptr;
+    size_t size = 0;
+    omnirt::common::util::MemoryRegion region;  ///< 指定页面策略时块所在的映射
+  };
+
+  struct Mark {
+    size_t chunk;
+    size_t offset;
+    size_t bytes_in_use;
+  };
+
+  static size_t RoundUpPow2(size_t n) {
+    size_t result = 1;
+    while (result < n) result <<= 1;
+    return result;
+  }
+
+  void* TryBump(const Chunk& chunk, size_t size, size_t align) {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data);
+    const uintptr_t begin = (base + cur_offset_ + align - 1) & ~(uintptr_t(align) - 1);
+    const size_t end = (begin - base) + size;
+    if (end > chunk.size) return nullptr;
+
+    bytes_in_use_ += end - cur_offset_;
+    high_water_ = std::max(high_water_, bytes_in_use_);
+    window_high_water_ = std::max(window_high_water_, bytes_in_use_);
+    cur_offset_ = end;
+    return reinterpret_cast<void*>(begin);
+  }
+
+  /**
+   * @brief 页面策略要求的最小块大小: 大页时为大页大小,其它策略为页大小
+   */
+  static size_t BackingGranularity(const MemoryBackingOptions& backing) {
+    if (backing.IsDefault()) return 64;
+    const size_t huge_page_size = omnirt::common::util::detail::DefaultHugePageSize();
+    if (backing.huge_pages != omnirt::common::util::HugePageMode::kNone && huge_page_size != 0)
+      return huge_page_size;
+    return omnirt::common::util::detail::PageSize();
+  }
+
+  /**
+   * @brief 申请一个块,按页映射时映射多出的部分也计入块大小
+   */
+  bool AllocateChunk(Chunk& chunk, size_t size) {
+    if (backing_.IsDefault()) {
+      chunk.data = static_cast<char*>(std::malloc(size));
+      chunk.size = size;
+      return chunk.data != nullptr;
+    }
+
+    if (omnirt_unlikely(!chunk.region.Allocate(size, backing_))) return false;
+    chunk.data = static_cast<char*>(chunk.region.Data());
+    chunk.size = chunk.region.MappedSize();
+    return true;
+  }
+
+  void ReleaseChunks(size_t from) {
+    for (size_t ii = from; ii < chunks_.size(); ++ii) {
+      capacity_ -= chunks_[ii].size;
+      // 映射的块随region析构释放
+      if (chunks_[ii].region.Data() == nullptr) std::free(chunks_[ii].data);
+    }
+    chunks_.resize(std::min(from, chunks_.size()));
+    if (cur_chunk_ >= chunks_.size()) {
+      cur_chunk_ = chunks_.size();
+      cur_offset_ = 0;
+    }
+  }
+
+  /**
+   * @brief 最外层帧结束时检查,块链过长或容量超过高水位两倍以上时全部释放,下次按高水位申请一个连续块
+   */
+  void MaybeTrim() {
+    const size_t target = RoundUpPow2(std::max(window_high_water_, min_chunk_size_));
+    if (chunks_.size() > 1 || capacity_ > 2 * target) {
+      ReleaseChunks(0);
+      next_chunk_size_ = target;
+      ++trim_count_;
+    }
+    window_frames_ = 0;
+    window_high_water_ = 0;
+  }
+
+  const size_t min_chunk_size_;
+  const size_t trim_interval_;
+  const MemoryBackingOptions backing_;
+
+  std::vector<Chunk> chunks_;
+  std::vector<Mark> frames_;
+  size_t cur_chunk_ = 0;
+  size_t cur_offset_ = 0;
+  size_t next_chunk_size_ = 0;
+
+  size_t bytes_in_use_ = 0;
+  size_t high_water_ = 0;
+  size_t capacity_ = 0;
+  size_t window_high_water_ = 0;
+  size_t window_frames_ = 0;
+
+  void* persistent_buf_ = nullptr;
+  size_t persistent_size_ = 0;
+  size_t persistent_window_max_ = 0;
+  size_t persistent_window_calls_ = 0;
+
+  uint64_t alloc_count_ = 0;
+  uint64_t chunk_alloc_count_ = 0;
+  uint64_t trim_count_ = 0;
+
+  static inline std::mutex default_backing_mutex_;
+  static inline MemoryBackingOptions default_backing_;
+};
+
+/**
+ * @brief ScratchArena作用域帧
+ */
+class ScratchFrame {
+ public:
+  explicit ScratchFrame(ScratchArena& arena = ScratchArena::ThreadLocal())
+      : arena_(arena), frame_(arena.PushFrame()) {}
+  ~ScratchFrame() { arena_.PopFrame(frame_); }
+
+  ScratchFrame(const ScratchFrame&) = delete;
+  ScratchFrame& operator=(const ScratchFrame&) = delete;
+
+  void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) { return arena_.Allocate(size, align); }
+
+  template <class T>
+  T* AllocateArray(size_t n) { return static_cast<T*>(arena_.Allocate(n * sizeof(T), alignof(T))); }
+
+ private:
+  ScratchArena& arena_;
+  const size_t frame_;
+};
+
+}  // namespace aimrt::common::util
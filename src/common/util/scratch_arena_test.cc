@@ -0,0 +1,200 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "util/scratch_arena.h"
+
+namespace aimrt::common::util {
+
+TEST(SCRATCH_ARENA_TEST, NestedFrames) {
+  ScratchArena arena(256);
+  EXPECT_EQ(arena.Allocate(16), nullptr);
+
+  {
+    ScratchFrame outer(arena);
+    auto* a = static_cast<char*>(outer.Allocate(100));
+    ASSERT_NE(a, nullptr);
+    memset(a, 'a', 100);
+
+    {
+      // 内层帧的分配不覆盖外层数据
+      ScratchFrame inner(arena);
+      auto* b = static_cast<char*>(inner.Allocate(100));
+      ASSERT_NE(b, nullptr);
+      memset(b, 'b', 100);
+      EXPECT_EQ(arena.GetStats().frame_depth, 2);
+    }
+
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(a[i], 'a');
+
+    // 内层帧归还后空间被复用
+    const size_t in_use = arena.GetStats().bytes_in_use;
+    {
+      ScratchFrame inner(arena);
+      inner.Allocate(100);
+    }
+    EXPECT_EQ(arena.GetStats().bytes_in_use, in_use);
+  }
+
+  EXPECT_EQ(arena.GetStats().bytes_in_use, 0);
+  EXPECT_EQ(arena.GetStats().frame_depth, 0);
+}
+
+TEST(SCRATCH_ARENA_TEST, Alignment) {
+  ScratchArena arena(256);
+  ScratchFrame frame(arena);
+  frame.Allocate(1);
+  auto* d = frame.AllocateArray<double>(3);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % alignof(double), 0);
+  void* p = frame.Allocate(8, 64);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0);
+}
+
+TEST(SCRATCH_ARENA_TEST, ChunkChain) {
+  ScratchArena arena(4096);
+  ScratchFrame frame(arena);
+
+  // 超过单块大小时链接新块,先前的指针不移动
+  std::vector<char*> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    auto* p = static_cast<char*>(frame.Allocate(1000));
+    ASSERT_NE(p, nullptr);
+    memset(p, i, 1000);
+    ptrs.emplace_back(p);
+  }
+  for (int i = 0; i < 64; ++i) ASSERT_EQ(ptrs[i][999], static_cast<char>(i));
+  EXPECT_GT(arena.GetStats().chunk_count, 1);
+
+  // 没有固定上限
+  auto* big = static_cast<char*>(frame.Allocate(64 * 1024 * 1024));
+  ASSERT_NE(big, nullptr);
+  big[64 * 1024 * 1024 - 1] = 1;
+  EXPECT_GE(arena.GetStats().capacity, 64 * 1024 * 1024);
+}
+
+TEST(SCRATCH_ARENA_TEST, HighWaterTrim) {
+  constexpr size_t kTrimInterval = 8;
+  ScratchArena arena(4096, kTrimInterval);
+
+  // 一次性的大消息
+  {
+    ScratchFrame frame(arena);
+    frame.Allocate(1024);
+    frame.Allocate(8 * 1024 * 1024);
+  }
+  EXPECT_GE(arena.GetStats().capacity, 8 * 1024 * 1024);
+
+  // 之后只有小消息: 第一个周期把块链合并为一块,第二个周期按小消息的高水位收缩
+  for (size_t i = 0; i < 2 * kTrimInterval; ++i) {
+    ScratchFrame frame(arena);
+    frame.Allocate(2000);
+  }
+  EXPECT_GE(arena.GetStats().trim_count, 2);
+  EXPECT_EQ(arena.GetStats().chunk_count, 1);
+  EXPECT_LE(arena.GetStats().capacity, 4096);
+  EXPECT_GE(arena.GetStats().high_water, 8 * 1024 * 1024);
+}
+
+TEST(SCRATCH_ARENA_TEST, PersistentBuf) {
+  constexpr size_t kTrimInterval = 4;
+  ScratchArena arena(4096, kTrimInterval);
+
+  void* p = arena.GetPersistentBuf(100);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(arena.GetPersistentBuf(4096), p);
+
+  // 与帧分配互不影响
+  {
+    ScratchFrame frame(arena);
+    EXPECT_NE(frame.Allocate(100), p);
+  }
+
+  ASSERT_NE(arena.GetPersistentBuf(32 * 1024 * 1024), nullptr);
+  EXPECT_GE(arena.GetStats().persistent_capacity, 32 * 1024 * 1024);
+  for (size_t i = 0; i < kTrimInterval; ++i) arena.GetPersistentBuf(100);
+  for (size_t i = 0; i < kTrimInterval; ++i) arena.GetPersistentBuf(100);
+  EXPECT_EQ(arena.GetStats().persistent_capacity, 4096);
+}
+
+TEST(SCRATCH_ARENA_TEST, MemoryBacking) {
+  ScratchArena::MemoryBackingOptions backing;
+  backing.prefault = true;
+  ScratchArena arena(256, 4, backing);
+
+  // 块按页映射,最小块大小取整到页大小
+  {
+    ScratchFrame frame(arena);
+    auto* a = static_cast<char*>(frame.Allocate(100));
+    ASSERT_NE(a, nullptr);
+    memset(a, 'a', 100);
+    EXPECT_EQ(arena.GetStats().capacity % sysconf(_SC_PAGESIZE), 0);
+
+    auto* b = static_cast<char*>(frame.Allocate(64 * 1024));
+    ASSERT_NE(b, nullptr);
+    memset(b, 'b', 64 * 1024);
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(a[i], 'a');
+  }
+
+  // 收缩后按高水位重新映射一个块,之后不再反复收缩
+  for (int i = 0; i < 8; ++i) {
+    ScratchFrame frame(arena);
+    ASSERT_NE(frame.Allocate(100), nullptr);
+  }
+  const uint64_t trim_count = arena.GetStats().trim_count;
+  for (int i = 0; i < 8; ++i) {
+    ScratchFrame frame(arena);
+    ASSERT_NE(frame.Allocate(100), nullptr);
+  }
+  EXPECT_EQ(arena.GetStats().trim_count, trim_count);
+  EXPECT_EQ(arena.GetStats().chunk_count, 1);
+}
+
+TEST(SCRATCH_ARENA_TEST, ThreadLocal) {
+  ScratchArena* main_arena = &ScratchArena::ThreadLocal();
+  ScratchArena* other_arena = nullptr;
+  std::thread t([&] {
+    other_arena = &ScratchArena::ThreadLocal();
+    ScratchFrame frame;
+    EXPECT_NE(frame.Allocate(128), nullptr);
+    EXPECT_EQ(ScratchArena::ThreadLocal().GetStats().frame_depth, 1);
+  });
+  t.join();
+  EXPECT_NE(main_arena, other_arena);
+  EXPECT_EQ(main_arena->GetStats().frame_depth, 0);
+}
+
+TEST(SCRATCH_ARENA_TEST, Benchmark) {
+  constexpr int kLoops = 1000000;
+  constexpr size_t kSizes[] = {64, 512, 4096};
+
+  for (size_t size : kSizes) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoops; ++i) {
+      void* p = std::malloc(size);
+      static_cast<volatile char*>(p)[0] = 1;
+      std::free(p);
+    }
+    const double malloc_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / kLoops;
+
+    begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kLoops; ++i) {
+      ScratchFrame frame;
+      static_cast<volatile char*>(frame.Allocate(size))[0] = 1;
+    }
+    const double arena_ns =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / kLoops;
+
+    std::cout << "size " << size << ": malloc/free " << malloc_ns << " ns, scratch frame " << arena_ns << " ns"
+              << std::endl;
+  }
+}
+
+}  // namespace aimrt::common::util
@@ -7,6 +7,8 @@
 // 3. SPSC特化: 仅支持单生产者-单消费者模式,但性能最优
 // 4. 缓存友好: 通过字节对齐减少伪共享,提升缓存命中率
 // 5. 共享内存: 支持跨进程通信,可用于不同进程间的数据交换
+// 6. 崩溃鲁棒: 段头部带版本和类型指纹校验,记录双方PID和心跳,
+//    创建者崩溃后可被新的创建者接管或回收(见shm_segment.h)
 //
 // 使用场景:
 // - 高性能进程间通信,如生产者-消费者模型
@@ -24,18 +26,14 @@
 #include <cstddef>  // for size_t
 #include <cstdint>
 #include <cstdlib>  // for std::free
-#include <sys/mman.h>  // 共享内存相关
-#include <sys/stat.h>  // 共享内存相关
-#include <fcntl.h>     // 共享内存相关
-#include <unistd.h>    // for close, ftruncate
+#include <chrono>
 #include <string>
 #include <utility>
 #include <memory>
 #include <new>         // for placement new
-#include <iostream>    // for std::cout, std::cerr
-#include <cstring>     // for strerror
 
 #include "bounded_spsc_lockfree_queue.h"  // 基类头文件
+#include "shm_segment.h"                  // 共享内存段生命周期管理
 
 namespace omnirt::common::util {
 
@@ -77,7 +75,7 @@ class ShmBoundedSpscLockfreeQueue : public BoundedSpscLockfreeQueue<T> {
   };
 
   // 构造和析构
-  ShmBoundedSpscLockfreeQueue();
+  ShmBoundedSpscLockfreeQueue() = default;
   ~ShmBoundedSpscLockfreeQueue();
   
   // 禁用拷贝和移动
@@ -90,16 +88,19 @@ class ShmBoundedSpscLockfreeQueue : public BoundedSpscLockfreeQueue<T> {
    * @brief 初始化队列
    * 
    * 创建或打开一个共享内存区域,并初始化队列。如果共享内存区域不存在,则创建;
-   * 如果已存在,则附加到现有的共享内存区域。
+   * 如果已存在且布局兼容,则附加到现有的共享内存区域(创建者已退出时接管所有权);
+   * 布局不兼容(元素类型、容量或版本不同)时失败,所有者已退出的遗留段按选项回收。
    * 
    * @param shm_name 共享内存名称,以/开头的唯一标识符,例如"/my_queue"
    * @param size 队列大小,必须大于0且不超过QUEUE_MAX_SIZE
    * @param force_power_of_two 是否强制size为2的幂
    * @param creator 是否作为创建者打开共享内存(true=创建/false=附加)
+   * @param options 权限、遗留段回收和附加等待时间等选项
    * @return true 初始化成功
-   * @return false 初始化失败(参数无效、内存分配失败或共享内存访问错误)
+   * @return false 初始化失败(参数无效、布局不兼容或共享内存访问错误)
    */
-  bool Init(const std::string& shm_name, uint64_t size, bool force_power_of_two = false, bool creator = true);
+  bool Init(const std::string& shm_name, uint64_t size, bool force_power_of_two = false, bool creator = true,
+            const ShmSegmentOptions& options = ShmSegmentOptions());
 
   /**
    * @brief 将元素入队
@@ -189,12 +190,52 @@ class ShmBoundedSpscLockfreeQueue : public BoundedSpscLockfreeQueue<T> {
    */
   ShmState GetShmState() const { return shm_state_; }
 
+  /**
+   * @brief 是否接管了已退出创建者遗留的队列(队列中保留原有数据)
+   */
+  bool Recovered() const { return segment_.Recovered(); }
+
+  /**
+   * @brief 更新本进程的心跳时间,供对端通过IsPeerAlive检测卡死
+   */
+  void Heartbeat() { segment_.Heartbeat(); }
+
+  /**
+   * @brief 对端(创建者对应附加者,反之亦然)的PID,未知时返回0
+   */
+  int32_t PeerPid() const { return segment_.PeerPid(); }
+
+  /**
+   * @brief 判断对端是否存活
+   * 
+   * @param heartbeat_timeout 大于0时还要求对端心跳在该时间内更新过
+   * @return true 对端进程存在(且心跳未超时)
+   */
+  bool IsPeerAlive(std::chrono::nanoseconds heartbeat_timeout = std::chrono::nanoseconds::zero()) const {
+    return segment_.IsPeerAlive(heartbeat_timeout);
+  }
+
   /**
    * @brief 关闭并解除映射共享内存
    * 
-   * 关闭共享内存连接并释放相关资源。如果是创建者,还会尝试删除共享内存对象。
+   * 关闭共享内存连接并释放相关资源。如果是创建者,还会删除共享内存对象。
    */
   void Close();
+
+  /**
+   * @brief 删除指定名称的共享内存对象(已映射的进程不受影响)
+   * 
+   * @return true 已删除或本就不存在
+   */
+  static bool Remove(const std::string& shm_name) { return ShmSegment::Remove(shm_name); }
+
+  /**
+   * @brief 当队列的创建者已退出或段无法识别时删除共享内存对象
+   * 
+   * @return true 已删除或本就不存在
+   * @return false 创建者仍存活或访问失败
+   */
+  static bool RemoveIfOrphaned(const std::string& shm_name) { return ShmSegment::RemoveIfOrphaned(shm_name); }
   
  protected:
   // 受保护的辅助方法
@@ -226,15 +267,18 @@ class ShmBoundedSpscLockfreeQueue : public BoundedSpscLockfreeQueue<T> {
                             : (num - (num / header_->pool_size_) * header_->pool_size_);
   }
 
+  /// 段头部中记录的数据结构种类
+  static constexpr uint32_t kShmQueueKind = 0x53505343;  // "SPSC"
+
   /**
-   * @brief 计算共享内存需要的总大小
+   * @brief 计算段头部之后的负载大小
    * 
-   * 计算包含队列头部和元素存储区域所需的共享内存总大小。
+   * 计算包含队列头部和元素存储区域所需的共享内存大小。
    * 
    * @param queue_size 队列容量(元素个数)
-   * @return 所需的共享内存总大小(字节)
+   * @return 所需的负载大小(字节)
    */
-  static size_t CalculateTotalSize(uint64_t queue_size) {
+  static size_t CalculatePayloadSize(uint64_t queue_size) {
     return sizeof(QueueHeader) + queue_size * sizeof(T);
   }
 
@@ -245,164 +289,63 @@ class ShmBoundedSpscLockfreeQueue : public BoundedSpscLockfreeQueue<T> {
   using BoundedSpscLockfreeQueue<T>::pool_;
   uint64_t pool_size_{0};            // 队列容量(本地缓存)
   
-  int shm_fd_{-1};                   // 共享内存文件描述符
   std::string shm_name_;             // 共享内存名称
-  size_t shm_size_{0};               // 共享内存大小
   ShmState shm_state_{ShmState::NOT_INITIALIZED};  // 共享内存状态
-  void* shm_addr_{nullptr};          // 共享内存映射的起始地址
-  bool is_creator_{false};           // 是否是创建者
+  ShmSegment segment_;               // 共享内存段(映射、头部校验和存活检测)
 };
 
-template <typename T>
-ShmBoundedSpscLockfreeQueue<T>::ShmBoundedSpscLockfreeQueue() : BoundedSpscLockfreeQueue<T>(),
-  pool_size_(0), shm_fd_(-1), shm_size_(0), shm_addr_(nullptr), shm_state_(ShmState::NOT_INITIALIZED), is_creator_(false) {}
-
 template <typename T>
 ShmBoundedSpscLockfreeQueue<T>::~ShmBoundedSpscLockfreeQueue() {
   Close();
 }
 
-
 template <typename T>
-bool ShmBoundedSpscLockfreeQueue<T>::Init(const std::string& shm_name, uint64_t size, 
-                                         bool force_power_of_two, bool creator) {
-  std::cout << "DEBUG: Initializing shared memory: " << shm_name << ", size: " << size 
-            << ", creator: " << (creator ? "true" : "false") << std::endl;
+bool ShmBoundedSpscLockfreeQueue<T>::Init(const std::string& shm_name, uint64_t size,
+                                         bool force_power_of_two, bool creator,
+                                         const ShmSegmentOptions& options) {
   if (shm_state_ != ShmState::NOT_INITIALIZED || size == 0 || size > QUEUE_MAX_SIZE) {
-    std::cerr << "DEBUG: 无效的初始化状态或大小, shm_state_=" << static_cast<int>(shm_state_) 
-              << ", size=" << size << ", QUEUE_MAX_SIZE=" << QUEUE_MAX_SIZE << std::endl;
-    return false;
-  }
-
-  if (shm_name.empty() || shm_name[0] != '/') {
-    // 共享内存名称必须以/开头
-    std::cerr << "Invalid shared memory name, must start with '/': " << shm_name << std::endl;
+    detail::ShmLog(ShmLogLevel::kError, "init", shm_name, 0,
+                   "invalid state or size, size=" + std::to_string(size));
     return false;
   }
-  
-  std::cout << "DEBUG: Initializing shared memory: " << shm_name << ", size: " << size 
-            << ", creator: " << (creator ? "true" : "false") << std::endl;
 
   if (force_power_of_two && !IsPowerOfTwo(size)) {
     // 如果要求2的幂但size不是2的幂，直接返回错误
-    std::cerr << "DEBUG: 非2的幂大小, size=" << size << ", force_power_of_two=" << (force_power_of_two ? "true" : "false") << std::endl;
+    detail::ShmLog(ShmLogLevel::kError, "init", shm_name, 0,
+                   "size must be a power of two, size=" + std::to_string(size));
     return false;
   }
 
-  shm_name_ = shm_name;
-  pool_size_ = size;
-  shm_size_ = CalculateTotalSize(size);
-  
-  std::cout << "DEBUG: 内存计算: pool_size_=" << pool_size_ 
-            << ", 元素大小=" << sizeof(T) 
-            << ", 总大小=" << shm_size_ << std::endl;
-
-  // 创建或打开共享内存
-  int flags = O_RDWR;
-  if (creator) {
-    flags |= O_CREAT | O_EXCL;  // 创建者模式：如果存在则失败
-    std::cout << "DEBUG: 尝试创建共享内存，标志：" << flags << ", 权限: 0666" << std::endl;
-    std::cout << "DEBUG: 共享内存名称：" << shm_name_.c_str() << std::endl;
-    shm_fd_ = shm_open(shm_name_.c_str(), flags, 0666);
-    if (shm_fd_ == -1) {
-      if (errno == EEXIST) {
-        // 共享内存已存在，切换到附加模式
-        flags = O_RDWR;
-        shm_fd_ = shm_open(shm_name_.c_str(), flags, 0666);
-        if (shm_fd_ == -1) {
-          std::cerr << "Failed to attach to existing shared memory: " << strerror(errno) << std::endl;
-          return false;
-        }
-        shm_state_ = ShmState::ATTACHED;
-      } else {
-        std::cerr << "Failed to create shared memory: " << strerror(errno) << " (errno=" << errno << ")" << std::endl;
-        perror("shm_open");
-        std::cout << "DEBUG: 创建共享内存失败，退出" << std::endl;
-        return false;
-      }
-    } else {
-      std::cout << "DEBUG: 成功创建共享内存, fd=" << shm_fd_ << std::endl;
-      // 成功创建，设置大小
-      std::cout << "DEBUG: 尝试设置共享内存大小: " << shm_size_ << std::endl;
-      if (ftruncate(shm_fd_, shm_size_) == -1) {
-        std::cerr << "Failed to set shared memory size: " << strerror(errno) << " (errno=" << errno << ")" << std::endl;
-        close(shm_fd_);
-        shm_unlink(shm_name_.c_str());
-        shm_fd_ = -1;
-        return false;
-      }
-      shm_state_ = ShmState::CREATED;
-    }
-  } else {
-    // 附加者模式：只打开已存在的共享内存
-    shm_fd_ = shm_open(shm_name_.c_str(), flags, 0666);
-    if (shm_fd_ == -1) {
-      std::cerr << "Failed to open shared memory: " << strerror(errno) << " (errno=" << errno << ")" << std::endl;
-      return false;
-    }
-    shm_state_ = ShmState::ATTACHED;
-  }
-
-  // 映射共享内存
-  std::cout << "DEBUG: Mapping shared memory, size: " << shm_size_ << ", fd: " << shm_fd_ << std::endl;
-  shm_addr_ = mmap(nullptr, shm_size_, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0);
-  if (shm_addr_ == MAP_FAILED) {
-    std::cerr << "Failed to map shared memory: " << strerror(errno) << " (errno=" << errno << ")" << std::endl;
-    perror("mmap");
-    std::cout << "DEBUG: MAP_FAILED 映射失败，检查共享内存大小和权限" << std::endl;
-    
-    // 检查共享内存文件的状态
-    struct stat sb;
-    if (fstat(shm_fd_, &sb) == 0) {
-      std::cout << "DEBUG: 共享内存文件大小 = " << sb.st_size << " 字节" << std::endl;
-    } else {
-      std::cerr << "DEBUG: 无法获取共享内存文件信息: " << strerror(errno) << std::endl;
-    }
-    
-    close(shm_fd_);
-    if (shm_state_ == ShmState::CREATED) {
-      shm_unlink(shm_name_.c_str());
-    }
-    shm_fd_ = -1;
-    shm_addr_ = nullptr;
-    shm_state_ = ShmState::NOT_INITIALIZED;
+  // 创建/附加、头部校验和崩溃遗留段的回收都由ShmSegment处理
+  const auto layout = ShmSegmentLayout::For<T>(kShmQueueKind, size, CalculatePayloadSize(size));
+  if (!segment_.Open(shm_name, layout, creator, options)) {
     return false;
   }
 
-  // 设置指针
-  std::cout << "DEBUG: Successfully mapped shared memory at: " << shm_addr_ << std::endl;
-  header_ = static_cast<QueueHeader*>(shm_addr_);
-  pool_ = reinterpret_cast<T*>(static_cast<char*>(shm_addr_) + sizeof(QueueHeader));
-  std::cout << "DEBUG: Header at: " << header_ << ", Pool at: " << (void*)pool_ << std::endl;
+  shm_name_ = shm_name;
+  pool_size_ = size;
+  header_ = static_cast<QueueHeader*>(segment_.Payload());
+  pool_ = reinterpret_cast<T*>(static_cast<char*>(segment_.Payload()) + sizeof(QueueHeader));
+  shm_state_ = segment_.GetRole() == ShmSegment::Role::kCreator ? ShmState::CREATED : ShmState::ATTACHED;
 
-  // 如果是创建者，初始化队列结构和元素
-  if (shm_state_ == ShmState::CREATED) {
-    std::cout << "DEBUG: Initializing queue as creator" << std::endl;
+  // 新建的段需要初始化队列结构和元素；接管的段保留原有数据
+  if (segment_.Created()) {
     header_->pool_size_ = pool_size_;
     header_->use_mask_ = force_power_of_two || IsPowerOfTwo(size);
     header_->pool_size_mask_ = pool_size_ - 1;
     header_->head_.store(0, std::memory_order_relaxed);
     header_->tail_.store(0, std::memory_order_relaxed);
-    std::cout << "DEBUG: Initialized header: pool_size_=" << header_->pool_size_ 
-              << ", use_mask_=" << header_->use_mask_ 
-              << ", pool_size_mask_=" << header_->pool_size_mask_ << std::endl;
 
     // 使用placement new初始化元素
     for (uint64_t i = 0; i < pool_size_; ++i) {
       new (&pool_[i]) T();
     }
-  } else {
-    // 附加者：验证元素大小匹配
-    std::cout << "DEBUG: Validating queue as attacher" << std::endl;
-    std::cout << "DEBUG: Header found: pool_size_=" << header_->pool_size_ 
-              << ", use_mask_=" << header_->use_mask_ 
-              << ", pool_size_mask_=" << header_->pool_size_mask_ << std::endl;
-    if (header_->pool_size_ != pool_size_) {
-      std::cerr << "Pool size mismatch in shared memory: expected " << pool_size_
-                << ", got " << header_->pool_size_ << std::endl;
-      Close();
-      return false;
-    }
+    segment_.MarkReady();
+  } else if (header_->pool_size_ != pool_size_) {
+    // 段头部已校验容量，这里只防御负载被意外改写的情况
+    detail::ShmLog(ShmLogLevel::kError, "validate", shm_name_, 0, "queue header corrupted");
+    Close();
+    return false;
   }
 
   return true;
@@ -410,32 +353,17 @@ bool ShmBoundedSpscLockfreeQueue<T>::Init(const std::string& shm_name, uint64_t
 
 template <typename T>
 void ShmBoundedSpscLockfreeQueue<T>::Close() {
-  if (shm_addr_ != nullptr && shm_addr_ != MAP_FAILED) {
-    // 如果是创建者，调用析构函数清理元素
-    if (shm_state_ == ShmState::CREATED && pool_ != nullptr) {
-      for (uint64_t i = 0; i < pool_size_; ++i) {
-        pool_[i].~T();
-      }
+  // 创建者负责析构元素并删除共享内存对象
+  const bool owner = shm_state_ == ShmState::CREATED;
+  if (owner && pool_ != nullptr) {
+    for (uint64_t i = 0; i < pool_size_; ++i) {
+      pool_[i].~T();
     }
-
-    // 解除映射
-    munmap(shm_addr_, shm_size_);
-    shm_addr_ = nullptr;
-    header_ = nullptr;
-    pool_ = nullptr;
-  }
-
-  // 关闭文件描述符
-  if (shm_fd_ != -1) {
-    close(shm_fd_);
-    shm_fd_ = -1;
-  }
-
-  // 如果是创建者，删除共享内存对象
-  if (shm_state_ == ShmState::CREATED && !shm_name_.empty()) {
-    shm_unlink(shm_name_.c_str());
   }
+  header_ = nullptr;
+  pool_ = nullptr;
 
+  segment_.Close(owner);
   shm_state_ = ShmState::NOT_INITIALIZED;
 }
 
@@ -1,6 +1,11 @@
 #include "util/shm_bounded_spsc_lockfree_queue.h"
 
+#include <fcntl.h>
 #include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <thread>
 #include <vector>
 #include <chrono>
@@ -229,5 +234,182 @@ TEST_F(ShmBoundedSpscLockfreeQueueTest, StructTypeTest) {
   shm_unlink("/test_struct_queue");
 }
 
+/**
+ * @brief 记录共享内存日志,用于验证结构化日志输出
+ */
+std::vector<std::string> g_shm_log_events;
+
+void RecordShmLog(const ShmLogRecord& record) {
+  g_shm_log_events.push_back(std::string(record.event) + ":" + std::to_string(static_cast<uint32_t>(record.level)));
+}
+
+/**
+ * @brief 在子进程中创建队列、写入数据后不关闭直接退出,模拟创建者崩溃
+ */
+template <typename T>
+void CrashAfterCreate(const std::string& name, uint64_t size, const T& value) {
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    auto* queue = new ShmBoundedSpscLockfreeQueue<T>();
+    if (!queue->Init(name, size) || !queue->Enqueue(value)) {
+      _exit(1);
+    }
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+}
+
+/**
+ * @brief 测试附加时的布局校验
+ *
+ * 元素类型(即使大小相同)或容量与创建者不一致时,附加必须失败,而不是误读内存
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, LayoutValidation) {
+  ASSERT_TRUE(queue_.Init("/test_queue", 16));
+
+  ShmBoundedSpscLockfreeQueue<float> wrong_type;
+  EXPECT_FALSE(wrong_type.Init("/test_queue", 16, false, false));
+
+  ShmBoundedSpscLockfreeQueue<int> wrong_capacity;
+  EXPECT_FALSE(wrong_capacity.Init("/test_queue", 8, false, false));
+
+  // 创建者存活时,不兼容的创建者也不能回收该段
+  ShmBoundedSpscLockfreeQueue<double> wrong_creator;
+  EXPECT_FALSE(wrong_creator.Init("/test_queue", 16, false, true));
+  EXPECT_TRUE(queue_.Enqueue(1));
+
+  ShmBoundedSpscLockfreeQueue<int> attacher;
+  EXPECT_TRUE(attacher.Init("/test_queue", 16, false, false));
+  EXPECT_EQ(attacher.Size(), 1);
+}
+
+/**
+ * @brief 测试创建者崩溃后的接管与回收
+ *
+ * - 布局兼容: 新创建者接管所有权并保留队列中的数据
+ * - 布局不兼容: 遗留段被回收后重新创建
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, RecoverAfterCreatorCrash) {
+  CrashAfterCreate<int>("/test_queue", 16, 7);
+
+  ASSERT_TRUE(queue_.Init("/test_queue", 16));
+  EXPECT_EQ(queue_.GetShmState(), ShmBoundedSpscLockfreeQueue<int>::ShmState::CREATED);
+  EXPECT_TRUE(queue_.Recovered());
+  int value = 0;
+  EXPECT_TRUE(queue_.Dequeue(&value));
+  EXPECT_EQ(value, 7);
+  queue_.Close();
+
+  CrashAfterCreate<int>("/test_queue", 16, 7);
+  ShmBoundedSpscLockfreeQueue<double> reclaimed;
+  ASSERT_TRUE(reclaimed.Init("/test_queue", 4));
+  EXPECT_FALSE(reclaimed.Recovered());
+  EXPECT_TRUE(reclaimed.Empty());
+}
+
+/**
+ * @brief 测试无法识别的遗留段(例如旧版本布局)的处理
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, ReclaimUnrecognizedSegment) {
+  int fd = shm_open("/test_queue", O_RDWR | O_CREAT | O_EXCL, 0600);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, 4096), 0);
+  const char garbage[] = "legacy layout without segment header";
+  ASSERT_EQ(write(fd, garbage, sizeof(garbage)), static_cast<ssize_t>(sizeof(garbage)));
+  close(fd);
+
+  ShmSegmentOptions options;
+  options.reclaim_stale = false;
+  ShmBoundedSpscLockfreeQueue<int> strict;
+  EXPECT_FALSE(strict.Init("/test_queue", 16, false, true, options));
+
+  ShmBoundedSpscLockfreeQueue<int> attacher;
+  EXPECT_FALSE(attacher.Init("/test_queue", 16, false, false));
+
+  EXPECT_TRUE(queue_.Init("/test_queue", 16));
+  EXPECT_TRUE(queue_.Enqueue(1));
+}
+
+/**
+ * @brief 测试创建权限可配置且不受umask影响
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, Permissions) {
+  ShmSegmentOptions options;
+  options.mode = 0640;
+  ASSERT_TRUE(queue_.Init("/test_queue", 16, false, true, options));
+
+  int fd = shm_open("/test_queue", O_RDONLY, 0);
+  ASSERT_GE(fd, 0);
+  struct stat sb;
+  ASSERT_EQ(fstat(fd, &sb), 0);
+  EXPECT_EQ(sb.st_mode & 0777, 0640u);
+  close(fd);
+}
+
+/**
+ * @brief 测试对端PID与心跳检测
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, PeerLiveness) {
+  ASSERT_TRUE(queue_.Init("/test_queue", 16));
+  EXPECT_FALSE(queue_.IsPeerAlive());
+
+  auto attacher = std::make_unique<ShmBoundedSpscLockfreeQueue<int>>();
+  ASSERT_TRUE(attacher->Init("/test_queue", 16, false, false));
+  EXPECT_EQ(queue_.PeerPid(), getpid());
+  EXPECT_TRUE(queue_.IsPeerAlive());
+  EXPECT_TRUE(attacher->IsPeerAlive());
+
+  // 心跳超时视为对端卡死
+  attacher->Heartbeat();
+  EXPECT_TRUE(queue_.IsPeerAlive(std::chrono::seconds(10)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(queue_.IsPeerAlive(std::chrono::milliseconds(5)));
+
+  // 附加者关闭后不再视为存活
+  attacher.reset();
+  EXPECT_EQ(queue_.PeerPid(), 0);
+  EXPECT_FALSE(queue_.IsPeerAlive());
+}
+
+/**
+ * @brief 测试显式清理接口
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, CleanupApi) {
+  ASSERT_TRUE(queue_.Init("/test_queue", 16));
+  EXPECT_FALSE(ShmBoundedSpscLockfreeQueue<int>::RemoveIfOrphaned("/test_queue"));
+
+  EXPECT_TRUE(ShmBoundedSpscLockfreeQueue<int>::Remove("/test_queue"));
+  EXPECT_LT(shm_open("/test_queue", O_RDONLY, 0), 0);
+  EXPECT_TRUE(ShmBoundedSpscLockfreeQueue<int>::Remove("/test_queue"));
+  // 已映射的队列不受删除影响
+  EXPECT_TRUE(queue_.Enqueue(1));
+
+  CrashAfterCreate<int>("/test_orphan", 16, 1);
+  EXPECT_TRUE(ShmBoundedSpscLockfreeQueue<int>::RemoveIfOrphaned("/test_orphan"));
+  EXPECT_LT(shm_open("/test_orphan", O_RDONLY, 0), 0);
+}
+
+/**
+ * @brief 测试初始化过程不写标准输出,错误通过日志处理函数上报
+ */
+TEST_F(ShmBoundedSpscLockfreeQueueTest, StructuredLogging) {
+  g_shm_log_events.clear();
+  SetShmLogHandler(&RecordShmLog);
+
+  testing::internal::CaptureStdout();
+  ASSERT_TRUE(queue_.Init("/test_queue", 16));
+  ShmBoundedSpscLockfreeQueue<float> wrong_type;
+  EXPECT_FALSE(wrong_type.Init("/test_queue", 16, false, false));
+  EXPECT_TRUE(testing::internal::GetCapturedStdout().empty());
+
+  SetShmLogHandler(&DefaultShmLogHandler);
+  ASSERT_FALSE(g_shm_log_events.empty());
+  EXPECT_EQ(g_shm_log_events.back(), "validate:" + std::to_string(static_cast<uint32_t>(ShmLogLevel::kError)));
+}
+
 }  // namespace
 }  // namespace omnirt::common::util
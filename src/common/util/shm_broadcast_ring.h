@@ -0,0 +1,521 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// 基于共享内存的单生产者多消费者广播环
+// 一个生产者写入的每条消息可被任意多个消费者各自读取一次,适用于传感器数据扇出等场景:
+// 1. 广播语义: 所有消费者共享同一块环形缓冲区,生产者每条消息只写一次
+// 2. 生产者永不阻塞: 环满时直接覆盖最旧的槽位,不等待慢速消费者
+// 3. 溢出检测: 每个槽位带序号(seqlock),落后的消费者能发现被覆盖的消息并跳到最旧的可读位置
+// 4. 事件计数唤醒: 消费者在共享内存中的ShmEventCount上等待,生产者仅在有等待者时才唤醒
+// 5. 动态附加/分离: 消费者随时附加或分离,崩溃消费者遗留的槽位可由生产者回收
+//
+// 槽位序号编码(消息序号为s):
+//   2*s+1  生产者正在写入
+//   2*s+2  写入完成
+// 消费者拷贝槽位内容前后各读一次序号,两次一致且等于2*s+2时数据有效。
+//
+// 线程安全说明:
+// - 生产者只能有一个(进程内单线程)
+// - 每个消费者对象只能在单个线程中使用,不同消费者之间互不影响
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "macros.h"
+#include "sync_primitives.h"
+#include "shm_segment.h"
+
+namespace omnirt::common::util {
+
+namespace detail {
+
+/**
+ * @brief 广播环的共享内存布局
+ */
+template <typename T>
+struct BroadcastRingLayout {
+  static constexpr size_t kCacheLineSize = 64;
+  static constexpr uint32_t kMaxConsumers = 64;
+
+  enum ConsumerState : uint32_t {
+    kFree = 0,    ///< 空闲
+    kActive = 1,  ///< 已被消费者占用
+  };
+
+  /**
+   * @brief 消费者槽位,记录消费者的PID和读取进度,供生产者监控和回收
+   */
+  struct alignas(kCacheLineSize) ConsumerSlot {
+    std::atomic<uint32_t> state;
+    std::atomic<int32_t> pid;
+    std::atomic<uint64_t> read_seq;  ///< 消费者下一条要读取的消息序号
+    std::atomic<uint64_t> dropped;   ///< 因溢出被跳过的消息数
+  };
+
+  /**
+   * @brief 环形缓冲区头部
+   */
+  struct alignas(kCacheLineSize) Header {
+    uint64_t capacity;
+    uint64_t mask;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> write_seq;  ///< 已发布的消息数量(下一条消息的序号)
+
+    alignas(kCacheLineSize) aimrt::common::util::ShmEventCount event;  ///< 消费者在其上等待新消息
+
+    ConsumerSlot consumers[kMaxConsumers];
+  };
+
+  /**
+   * @brief 消息槽位
+   */
+  struct alignas(kCacheLineSize) Slot {
+    std::atomic<uint64_t> seq;
+    T value;
+  };
+
+  static size_t PayloadSize(uint64_t capacity) { return sizeof(Header) + capacity * sizeof(Slot); }
+
+  static Header* GetHeader(void* payload) { return static_cast<Header*>(payload); }
+
+  static Slot* GetSlots(void* payload) {
+    return reinterpret_cast<Slot*>(static_cast<char*>(payload) + sizeof(Header));
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief 广播环的段种类,记录在共享内存段头部中
+ */
+constexpr uint32_t kShmBroadcastRingKind = 0x42435354;  // "BCST"
+
+/**
+ * @brief 广播环生产者
+ *
+ * 创建(或在前一个生产者崩溃后接管)广播环。接管时沿用原有的消息序号,已附加的消费者不受影响。
+ *
+ * @tparam T 消息类型,必须是平凡可复制类型
+ */
+template <typename T>
+class ShmBroadcastProducer {
+  static_assert(std::is_trivially_copyable<T>::value, "广播环中的消息类型必须是平凡可复制类型");
+
+  using Layout = detail::BroadcastRingLayout<T>;
+
+ public:
+  static constexpr uint32_t kMaxConsumers = Layout::kMaxConsumers;
+
+  ShmBroadcastProducer() = default;
+  ~ShmBroadcastProducer() { Close(); }
+
+  ShmBroadcastProducer(const ShmBroadcastProducer&) = delete;
+  ShmBroadcastProducer& operator=(const ShmBroadcastProducer&) = delete;
+
+  /**
+   * @brief 创建广播环
+   *
+   * @param shm_name 共享内存名称,以/开头
+   * @param capacity 环容量,必须是2的幂
+   * @param options 共享内存段选项
+   * @return true 创建成功
+   * @return false 参数无效、布局不兼容或已有存活的生产者
+   */
+  bool Init(const std::string& shm_name, uint64_t capacity, const ShmSegmentOptions& options = ShmSegmentOptions()) {
+    if (header_ != nullptr || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+      detail::ShmLog(ShmLogLevel::kError, "init", shm_name, 0,
+                     "invalid state or capacity (must be a power of two), capacity=" + std::to_string(capacity));
+      return false;
+    }
+
+    const auto layout = ShmSegmentLayout::For<T>(kShmBroadcastRingKind, capacity, Layout::PayloadSize(capacity));
+    if (!segment_.Open(shm_name, layout, true, options)) {
+      return false;
+    }
+    if (segment_.GetRole() != ShmSegment::Role::kCreator) {
+      // 同名广播环已有存活的生产者
+      detail::ShmLog(ShmLogLevel::kError, "init", shm_name, 0, "broadcast ring already has a live producer");
+      segment_.Close(false);
+      return false;
+    }
+
+    header_ = Layout::GetHeader(segment_.Payload());
+    slots_ = Layout::GetSlots(segment_.Payload());
+    if (segment_.Created()) {
+      header_->capacity = capacity;
+      header_->mask = capacity - 1;
+      header_->write_seq.store(0, std::memory_order_relaxed);
+      new (&header_->event) aimrt::common::util::ShmEventCount();
+      for (auto& consumer : header_->consumers) {
+        consumer.state.store(Layout::kFree, std::memory_order_relaxed);
+        consumer.pid.store(0, std::memory_order_relaxed);
+        consumer.read_seq.store(0, std::memory_order_relaxed);
+        consumer.dropped.store(0, std::memory_order_relaxed);
+      }
+      for (uint64_t i = 0; i < capacity; ++i) {
+        slots_[i].seq.store(0, std::memory_order_relaxed);
+      }
+      segment_.MarkReady();
+    }
+
+    write_seq_ = header_->write_seq.load(std::memory_order_acquire);
+    return true;
+  }
+
+  /**
+   * @brief 发布一条消息,环满时覆盖最旧的消息,永不阻塞
+   */
+  void Publish(const T& value) {
+    typename Layout::Slot& slot = slots_[write_seq_ & header_->mask];
+
+    // 先将序号置为奇数,读者据此发现槽位正在被改写
+    slot.seq.store(2 * write_seq_ + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(static_cast<void*>(&slot.value), &value, sizeof(T));
+    slot.seq.store(2 * write_seq_ + 2, std::memory_order_release);
+
+    ++write_seq_;
+    header_->write_seq.store(write_seq_, std::memory_order_release);
+
+    // 只有存在已登记的等待者时才执行唤醒系统调用
+    header_->event.NotifyAll();
+  }
+
+  /**
+   * @brief 已发布的消息数量
+   */
+  uint64_t Published() const { return write_seq_; }
+
+  /**
+   * @brief 环容量
+   */
+  uint64_t Capacity() const { return header_ == nullptr ? 0 : header_->capacity; }
+
+  /**
+   * @brief 当前已附加的消费者数量
+   */
+  size_t ConsumerCount() const {
+    size_t count = 0;
+    if (header_ != nullptr) {
+      for (const auto& consumer : header_->consumers) {
+        count += consumer.state.load(std::memory_order_acquire) == Layout::kActive ? 1 : 0;
+      }
+    }
+    return count;
+  }
+
+  /**
+   * @brief 所有消费者中最大的落后消息数,大于容量说明该消费者已经溢出
+   */
+  uint64_t MaxConsumerLag() const {
+    uint64_t lag = 0;
+    if (header_ != nullptr) {
+      for (const auto& consumer : header_->consumers) {
+        if (consumer.state.load(std::memory_order_acquire) == Layout::kActive) {
+          const uint64_t read_seq = consumer.read_seq.load(std::memory_order_relaxed);
+          lag = std::max(lag, write_seq_ > read_seq ? write_seq_ - read_seq : 0);
+        }
+      }
+    }
+    return lag;
+  }
+
+  /**
+   * @brief 回收已崩溃消费者占用的槽位
+   *
+   * @return size_t 回收的槽位数量
+   */
+  size_t ReapConsumers() {
+    size_t reaped = 0;
+    if (header_ == nullptr) {
+      return reaped;
+    }
+    for (auto& consumer : header_->consumers) {
+      if (consumer.state.load(std::memory_order_acquire) == Layout::kActive &&
+          !IsShmProcessAlive(consumer.pid.load(std::memory_order_acquire))) {
+        consumer.pid.store(0, std::memory_order_relaxed);
+        consumer.state.store(Layout::kFree, std::memory_order_release);
+        ++reaped;
+      }
+    }
+    return reaped;
+  }
+
+  /**
+   * @brief 唤醒所有等待中的消费者(例如在退出前让消费者检查停止标志)
+   */
+  void WakeAll() {
+    if (header_ != nullptr) {
+      header_->event.NotifyAll();
+    }
+  }
+
+  /**
+   * @brief 心跳,供消费者检测生产者是否卡死
+   */
+  void Heartbeat() { segment_.Heartbeat(); }
+
+  /**
+   * @brief 关闭并删除共享内存对象(已附加的消费者仍可读完剩余消息)
+   */
+  void Close() {
+    if (header_ != nullptr) {
+      WakeAll();
+    }
+    header_ = nullptr;
+    slots_ = nullptr;
+    segment_.Close(true);
+  }
+
+ private:
+  ShmSegment segment_;
+  typename Layout::Header* header_{nullptr};
+  typename Layout::Slot* slots_{nullptr};
+  uint64_t write_seq_{0};  ///< 本地缓存的写序号,只有生产者修改
+};
+
+/**
+ * @brief 广播环消费者
+ *
+ * 每个消费者拥有独立的读游标,读取不影响其他消费者。
+ *
+ * @tparam T 消息类型,必须与生产者一致
+ */
+template <typename T>
+class ShmBroadcastConsumer {
+  static_assert(std::is_trivially_copyable<T>::value, "广播环中的消息类型必须是平凡可复制类型");
+
+  using Layout = detail::BroadcastRingLayout<T>;
+
+ public:
+  /**
+   * @brief 附加后的起始读取位置
+   */
+  enum class StartPosition {
+    kLatest,  ///< 只读取附加之后发布的消息
+    kOldest,  ///< 从环中仍保留的最旧消息开始读取
+  };
+
+  /**
+   * @brief 读取结果
+   */
+  enum class ReadStatus {
+    kOk,       ///< 读到一条消息
+    kEmpty,    ///< 暂无新消息(或等待超时)
+    kOverrun,  ///< 落后过多,部分消息已被覆盖,游标已跳到最旧的可读位置,丢失数量计入Dropped()
+  };
+
+  ShmBroadcastConsumer() = default;
+  ~ShmBroadcastConsumer() { Close(); }
+
+  ShmBroadcastConsumer(const ShmBroadcastConsumer&) = delete;
+  ShmBroadcastConsumer& operator=(const ShmBroadcastConsumer&) = delete;
+
+  /**
+   * @brief 附加到广播环
+   *
+   * @param shm_name 共享内存名称
+   * @param capacity 环容量,必须与生产者一致
+   * @param start 起始读取位置
+   * @param options 共享内存段选项
+   * @return true 附加成功
+   * @return false 广播环不存在、布局不兼容或消费者数量已达上限
+   */
+  bool Init(const std::string& shm_name, uint64_t capacity, StartPosition start = StartPosition::kLatest,
+            const ShmSegmentOptions& options = ShmSegmentOptions()) {
+    if (header_ != nullptr) {
+      return false;
+    }
+
+    const auto layout = ShmSegmentLayout::For<T>(kShmBroadcastRingKind, capacity, Layout::PayloadSize(capacity));
+    if (!segment_.Open(shm_name, layout, false, options)) {
+      return false;
+    }
+
+    header_ = Layout::GetHeader(segment_.Payload());
+    slots_ = Layout::GetSlots(segment_.Payload());
+
+    const int32_t self = static_cast<int32_t>(getpid());
+    for (uint32_t i = 0; i < Layout::kMaxConsumers; ++i) {
+      uint32_t expected = Layout::kFree;
+      if (header_->consumers[i].state.compare_exchange_strong(expected, Layout::kActive,
+                                                              std::memory_order_acq_rel)) {
+        consumer_ = &header_->consumers[i];
+        break;
+      }
+    }
+    if (consumer_ == nullptr) {
+      detail::ShmLog(ShmLogLevel::kError, "attach", shm_name, 0, "too many consumers");
+      header_ = nullptr;
+      slots_ = nullptr;
+      segment_.Close(false);
+      return false;
+    }
+
+    const uint64_t write_seq = header_->write_seq.load(std::memory_order_acquire);
+    if (start == StartPosition::kLatest) {
+      read_seq_ = write_seq;
+    } else {
+      read_seq_ = write_seq > header_->capacity ? write_seq - header_->capacity : 0;
+    }
+    dropped_ = 0;
+    consumer_->pid.store(self, std::memory_order_relaxed);
+    consumer_->dropped.store(0, std::memory_order_relaxed);
+    consumer_->read_seq.store(read_seq_, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief 尝试读取下一条消息,不阻塞
+   *
+   * @param[out] value 读到的消息
+   * @return ReadStatus 读取结果
+   */
+  ReadStatus TryRead(T* value) {
+    const uint64_t write_seq = header_->write_seq.load(std::memory_order_acquire);
+    if (read_seq_ == write_seq) {
+      return ReadStatus::kEmpty;
+    }
+    if (write_seq - read_seq_ > header_->capacity) {
+      return Resync(write_seq);
+    }
+
+    const typename Layout::Slot& slot = slots_[read_seq_ & header_->mask];
+    const uint64_t expected = 2 * read_seq_ + 2;
+    const uint64_t before = slot.seq.load(std::memory_order_acquire);
+    if (before != expected) {
+      // 槽位已被更新的消息覆盖(或正在被覆盖)
+      return Resync(header_->write_seq.load(std::memory_order_acquire));
+    }
+
+    std::memcpy(static_cast<void*>(value), static_cast<const void*>(&slot.value), sizeof(T));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != expected) {
+      // 拷贝过程中被生产者覆盖,本次拷贝的数据无效
+      return Resync(header_->write_seq.load(std::memory_order_acquire));
+    }
+
+    ++read_seq_;
+    consumer_->read_seq.store(read_seq_, std::memory_order_relaxed);
+    return ReadStatus::kOk;
+  }
+
+  /**
+   * @brief 读取下一条消息,暂无消息时在事件计数上等待
+   *
+   * @param[out] value 读到的消息
+   * @param timeout 最长等待时间
+   * @return ReadStatus 读取结果,超时返回kEmpty
+   */
+  ReadStatus Read(T* value, std::chrono::nanoseconds timeout) {
+    ReadStatus status = TryRead(value);
+    if (status != ReadStatus::kEmpty) {
+      return status;
+    }
+
+    // 先短暂自旋,消息密集时避免进入内核,也让生产者不必频繁执行唤醒系统调用
+    for (uint32_t i = 0; i < kSpinCount; ++i) {
+      if (header_->write_seq.load(std::memory_order_acquire) != read_seq_) {
+        return TryRead(value);
+      }
+      ::cpu_relax();
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+      // 登记为等待者后必须重新检查,避免错过登记之前的发布
+      const auto key = header_->event.PrepareWait();
+      if (header_->write_seq.load(std::memory_order_acquire) != read_seq_) {
+        header_->event.CancelWait();
+        return TryRead(value);
+      }
+
+      const auto remaining = deadline - std::chrono::steady_clock::now();
+      if (remaining <= std::chrono::nanoseconds::zero()) {
+        header_->event.CancelWait();
+        return ReadStatus::kEmpty;
+      }
+      header_->event.WaitFor(key, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+
+      status = TryRead(value);
+      if (status != ReadStatus::kEmpty || std::chrono::steady_clock::now() >= deadline) {
+        return status;
+      }
+    }
+  }
+
+  /**
+   * @brief 当前可读的消息数量(溢出时不超过容量)
+   */
+  uint64_t Available() const {
+    const uint64_t write_seq = header_->write_seq.load(std::memory_order_acquire);
+    return std::min<uint64_t>(write_seq - read_seq_, header_->capacity);
+  }
+
+  /**
+   * @brief 因溢出被跳过的消息总数
+   */
+  uint64_t Dropped() const { return dropped_; }
+
+  /**
+   * @brief 下一条要读取的消息序号
+   */
+  uint64_t ReadSeq() const { return read_seq_; }
+
+  /**
+   * @brief 生产者是否存活
+   *
+   * @param heartbeat_timeout 大于0时还要求生产者心跳在该时间内更新过
+   */
+  bool IsProducerAlive(std::chrono::nanoseconds heartbeat_timeout = std::chrono::nanoseconds::zero()) const {
+    return segment_.IsPeerAlive(heartbeat_timeout);
+  }
+
+  /**
+   * @brief 分离消费者,释放消费者槽位
+   */
+  void Close() {
+    if (consumer_ != nullptr) {
+      consumer_->pid.store(0, std::memory_order_relaxed);
+      consumer_->state.store(Layout::kFree, std::memory_order_release);
+      consumer_ = nullptr;
+    }
+    header_ = nullptr;
+    slots_ = nullptr;
+    segment_.Close(false);
+  }
+
+ private:
+  static constexpr uint32_t kSpinCount = 256;
+
+  /**
+   * @brief 溢出后将游标跳到环中最旧的可读位置
+   */
+  ReadStatus Resync(uint64_t write_seq) {
+    // 额外跳过一个槽位,为正在写入的下一条消息留出余量,避免立即再次溢出
+    const uint64_t oldest = write_seq > header_->capacity ? write_seq - header_->capacity + 1 : 0;
+    if (oldest > read_seq_) {
+      dropped_ += oldest - read_seq_;
+      read_seq_ = oldest;
+      consumer_->dropped.store(dropped_, std::memory_order_relaxed);
+      consumer_->read_seq.store(read_seq_, std::memory_order_relaxed);
+    }
+    return ReadStatus::kOverrun;
+  }
+
+  ShmSegment segment_;
+  typename Layout::Header* header_{nullptr};
+  typename Layout::Slot* slots_{nullptr};
+  typename Layout::ConsumerSlot* consumer_{nullptr};
+  uint64_t read_seq_{0};
+  uint64_t dropped_{0};
+};
+
+}  // namespace omnirt::common::util
@@ -0,0 +1,267 @@
+#include "util/shm_broadcast_ring.h"
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace omnirt::common::util {
+namespace {
+
+using Consumer = ShmBroadcastConsumer<uint64_t>;
+using ReadStatus = Consumer::ReadStatus;
+using StartPosition = Consumer::StartPosition;
+
+/**
+ * @brief 共享内存广播环的测试类
+ *
+ * 该测试类验证ShmBroadcastProducer/ShmBroadcastConsumer的以下特性：
+ * - 每条消息被所有消费者各读取一次
+ * - 落后的消费者能检测到溢出并跳到最旧的可读位置
+ * - 消费者的动态附加/分离以及崩溃消费者的回收
+ * - 基于事件计数的阻塞读取
+ */
+class ShmBroadcastRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override { shm_unlink("/test_broadcast"); }
+  void TearDown() override { shm_unlink("/test_broadcast"); }
+
+  ShmBroadcastProducer<uint64_t> producer_;
+};
+
+/**
+ * @brief 测试每条消息被所有消费者读取
+ */
+TEST_F(ShmBroadcastRingTest, FanOut) {
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 16));
+
+  Consumer a, b;
+  ASSERT_TRUE(a.Init("/test_broadcast", 16));
+  ASSERT_TRUE(b.Init("/test_broadcast", 16));
+  EXPECT_EQ(producer_.ConsumerCount(), 2);
+
+  for (uint64_t i = 0; i < 10; ++i) {
+    producer_.Publish(i);
+  }
+  EXPECT_EQ(producer_.Published(), 10);
+  EXPECT_EQ(a.Available(), 10);
+
+  uint64_t value = 0;
+  for (uint64_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(a.TryRead(&value), ReadStatus::kOk);
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_EQ(a.TryRead(&value), ReadStatus::kEmpty);
+
+  // a读完不影响b
+  EXPECT_EQ(producer_.MaxConsumerLag(), 10);
+  for (uint64_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(b.TryRead(&value), ReadStatus::kOk);
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_EQ(producer_.MaxConsumerLag(), 0);
+}
+
+/**
+ * @brief 测试生产者不被慢速消费者阻塞,消费者能检测到溢出
+ */
+TEST_F(ShmBroadcastRingTest, Overrun) {
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 4));
+
+  Consumer consumer;
+  ASSERT_TRUE(consumer.Init("/test_broadcast", 4));
+  for (uint64_t i = 0; i < 10; ++i) {
+    producer_.Publish(i);
+  }
+
+  uint64_t value = 0;
+  EXPECT_EQ(consumer.TryRead(&value), ReadStatus::kOverrun);
+  EXPECT_EQ(consumer.Dropped(), 7);
+
+  for (uint64_t i = 7; i < 10; ++i) {
+    ASSERT_EQ(consumer.TryRead(&value), ReadStatus::kOk);
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_EQ(consumer.TryRead(&value), ReadStatus::kEmpty);
+}
+
+/**
+ * @brief 测试附加时的起始位置
+ */
+TEST_F(ShmBroadcastRingTest, StartPosition) {
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 4));
+  for (uint64_t i = 0; i < 6; ++i) {
+    producer_.Publish(i);
+  }
+
+  Consumer latest, oldest;
+  ASSERT_TRUE(latest.Init("/test_broadcast", 4, StartPosition::kLatest));
+  ASSERT_TRUE(oldest.Init("/test_broadcast", 4, StartPosition::kOldest));
+
+  uint64_t value = 0;
+  EXPECT_EQ(latest.TryRead(&value), ReadStatus::kEmpty);
+  ASSERT_EQ(oldest.TryRead(&value), ReadStatus::kOk);
+  EXPECT_EQ(value, 2);
+
+  producer_.Publish(6);
+  ASSERT_EQ(latest.TryRead(&value), ReadStatus::kOk);
+  EXPECT_EQ(value, 6);
+}
+
+/**
+ * @brief 测试消费者的动态附加/分离以及数量上限
+ */
+TEST_F(ShmBroadcastRingTest, AttachDetach) {
+  Consumer early;
+  EXPECT_FALSE(early.Init("/test_broadcast", 16));
+
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 16));
+
+  // 同名广播环只能有一个生产者
+  ShmBroadcastProducer<uint64_t> second;
+  EXPECT_FALSE(second.Init("/test_broadcast", 16));
+
+  std::vector<std::unique_ptr<Consumer>> consumers;
+  for (uint32_t i = 0; i < ShmBroadcastProducer<uint64_t>::kMaxConsumers; ++i) {
+    consumers.push_back(std::make_unique<Consumer>());
+    ASSERT_TRUE(consumers.back()->Init("/test_broadcast", 16));
+  }
+  EXPECT_EQ(producer_.ConsumerCount(), ShmBroadcastProducer<uint64_t>::kMaxConsumers);
+
+  Consumer extra;
+  EXPECT_FALSE(extra.Init("/test_broadcast", 16));
+
+  consumers.pop_back();
+  EXPECT_EQ(producer_.ConsumerCount(), ShmBroadcastProducer<uint64_t>::kMaxConsumers - 1);
+  EXPECT_TRUE(extra.Init("/test_broadcast", 16));
+}
+
+/**
+ * @brief 测试布局不一致的消费者无法附加
+ */
+TEST_F(ShmBroadcastRingTest, LayoutValidation) {
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 16));
+
+  Consumer wrong_capacity;
+  EXPECT_FALSE(wrong_capacity.Init("/test_broadcast", 8));
+
+  ShmBroadcastConsumer<double> wrong_type;
+  EXPECT_FALSE(wrong_type.Init("/test_broadcast", 16));
+
+  ShmBroadcastProducer<uint64_t> not_pow2;
+  EXPECT_FALSE(not_pow2.Init("/test_broadcast_pow2", 12));
+}
+
+/**
+ * @brief 测试阻塞读取被发布唤醒以及超时
+ */
+TEST_F(ShmBroadcastRingTest, BlockingRead) {
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 16));
+
+  Consumer consumer;
+  ASSERT_TRUE(consumer.Init("/test_broadcast", 16));
+
+  uint64_t value = 0;
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(consumer.Read(&value, std::chrono::milliseconds(20)), ReadStatus::kEmpty);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+
+  std::thread publisher([this]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    producer_.Publish(42);
+  });
+  EXPECT_EQ(consumer.Read(&value, std::chrono::seconds(5)), ReadStatus::kOk);
+  EXPECT_EQ(value, 42);
+  publisher.join();
+}
+
+/**
+ * @brief 测试回收崩溃消费者遗留的槽位
+ */
+TEST_F(ShmBroadcastRingTest, ReapCrashedConsumer) {
+  ASSERT_TRUE(producer_.Init("/test_broadcast", 16));
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    auto* consumer = new Consumer();
+    _exit(consumer->Init("/test_broadcast", 16) ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  Consumer alive;
+  ASSERT_TRUE(alive.Init("/test_broadcast", 16));
+  EXPECT_EQ(producer_.ConsumerCount(), 2);
+  EXPECT_EQ(producer_.ReapConsumers(), 1);
+  EXPECT_EQ(producer_.ConsumerCount(), 1);
+}
+
+/**
+ * @brief 多消费者并发读取的压力测试
+ *
+ * 每个消费者读到的值必须严格递增,且读取数与丢弃数之和等于发布总数
+ */
+TEST_F(ShmBroadcastRingTest, ConcurrentConsumers) {
+  constexpr uint64_t kCapacity = 64;
+  constexpr uint64_t kMessages = 200000;
+  constexpr int kConsumers = 4;
+  ASSERT_TRUE(producer_.Init("/test_broadcast", kCapacity));
+
+  std::vector<std::unique_ptr<Consumer>> consumers;
+  for (int i = 0; i < kConsumers; ++i) {
+    consumers.push_back(std::make_unique<Consumer>());
+    ASSERT_TRUE(consumers.back()->Init("/test_broadcast", kCapacity));
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<uint64_t> received(kConsumers, 0);
+  std::vector<char> ordered(kConsumers, 1);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kConsumers; ++i) {
+    threads.emplace_back([&, i]() {
+      Consumer& consumer = *consumers[i];
+      uint64_t value = 0;
+      uint64_t last = 0;
+      bool first = true;
+      while (true) {
+        // 先读停止标志: 之后读到空说明所有消息都已发布并读完
+        const bool finished = done.load();
+        const ReadStatus status = consumer.Read(&value, std::chrono::milliseconds(10));
+        if (status == ReadStatus::kOk) {
+          if (!first && value <= last) {
+            ordered[i] = 0;
+          }
+          first = false;
+          last = value;
+          ++received[i];
+        } else if (status == ReadStatus::kEmpty && finished) {
+          break;
+        }
+      }
+    });
+  }
+
+  for (uint64_t i = 0; i < kMessages; ++i) {
+    producer_.Publish(i);
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kConsumers; ++i) {
+    EXPECT_TRUE(ordered[i]);
+    EXPECT_EQ(received[i] + consumers[i]->Dropped(), kMessages);
+  }
+}
+
+}  // namespace
+}  // namespace omnirt::common::util
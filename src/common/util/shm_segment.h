@@ -0,0 +1,726 @@
+// Copyright (c) 2023 OmniRT Authors. All rights reserved.
+//
+// 共享内存段生命周期管理
+// 为基于共享内存的数据结构提供统一的创建、附加、校验和回收流程:
+// 1. 版本化布局: 段起始处为ShmSegmentHeader,记录魔数、版本、数据结构种类、
+//    元素大小/对齐、类型指纹和容量,附加时逐项校验,避免不同版本或不同T的进程误读内存
+// 2. 存活检测: 头部记录创建者/附加者PID和心跳时间,可判断对端是否已退出或卡死
+// 3. 崩溃恢复: 创建者崩溃后,新的创建者可接管布局兼容的段(保留数据),
+//    或回收布局不兼容/未初始化完成的遗留段后重新创建
+// 4. 权限控制: 创建时按配置的mode设置权限,不受进程umask影响
+// 5. 结构化日志: 通过可替换的日志处理函数输出事件,不直接写标准输出
+// 6. 内存底座: 可选透明大页提示、预缺页、mlock和NUMA绑定(见memory_backing.h)
+//
+// 段内存布局:
+//   [ShmSegmentHeader][数据结构自身的负载(payload)]
+//
+// 初始化协议:
+//   创建者 ftruncate -> 写头部各字段 -> 发布魔数 -> 初始化负载 -> MarkReady()
+//   附加者 等待魔数发布且状态为READY后再校验布局,超时视为遗留段
+
+#pragma once
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include "memory_backing.h"
+
+namespace omnirt::common::util {
+
+/**
+ * @brief 共享内存日志级别,取值与log_util.h中的kLogLevel*一致,便于转发
+ */
+enum class ShmLogLevel : uint32_t {
+  kTrace = 0,
+  kDebug = 1,
+  kInfo = 2,
+  kWarn = 3,
+  kError = 4,
+};
+
+/**
+ * @brief 共享内存日志记录
+ */
+struct ShmLogRecord {
+  ShmLogLevel level;     ///< 日志级别
+  const char* event;     ///< 事件名称,如"create"/"attach"/"validate"/"reclaim"
+  const char* shm_name;  ///< 共享内存名称
+  int sys_errno;         ///< 相关的系统错误码,无则为0
+  const char* message;   ///< 描述信息
+};
+
+/**
+ * @brief 共享内存日志处理函数
+ */
+using ShmLogHandler = void (*)(const ShmLogRecord&);
+
+/**
+ * @brief 默认日志处理函数,以key=value格式输出到标准错误
+ */
+inline void DefaultShmLogHandler(const ShmLogRecord& record) {
+  static constexpr const char* kLevelNames[] = {"TRACE", "DEBUG", "INFO", "WARN", "ERROR"};
+  const auto level = static_cast<uint32_t>(record.level);
+  std::fprintf(stderr, "[shm] level=%s event=%s name=%s errno=%d msg=\"%s\"\n",
+               level < 5 ? kLevelNames[level] : "UNKNOWN", record.event, record.shm_name,
+               record.sys_errno, record.message);
+}
+
+namespace detail {
+
+inline std::atomic<ShmLogHandler>& ShmLogHandlerStorage() {
+  static std::atomic<ShmLogHandler> handler{&DefaultShmLogHandler};
+  return handler;
+}
+
+inline std::atomic<uint32_t>& ShmLogLevelStorage() {
+  static std::atomic<uint32_t> level{static_cast<uint32_t>(ShmLogLevel::kWarn)};
+  return level;
+}
+
+inline void ShmLog(ShmLogLevel level, const char* event, const std::string& shm_name, int sys_errno,
+                   const std::string& message) {
+  if (static_cast<uint32_t>(level) < ShmLogLevelStorage().load(std::memory_order_relaxed)) {
+    return;
+  }
+  ShmLogHandler handler = ShmLogHandlerStorage().load(std::memory_order_acquire);
+  if (handler != nullptr) {
+    handler(ShmLogRecord{level, event, shm_name.c_str(), sys_errno, message.c_str()});
+  }
+}
+
+/**
+ * @brief 类型签名,依赖编译器生成的函数签名字符串(包含模板实参)
+ */
+template <typename T>
+const char* ShmTypeSignature() {
+  return __PRETTY_FUNCTION__;
+}
+
+inline uint64_t Fnv1a(const char* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<uint8_t>(data[i]);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+inline uint64_t MonotonicNowNs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+}  // namespace detail
+
+/**
+ * @brief 设置共享内存日志处理函数,传入nullptr关闭日志
+ */
+inline void SetShmLogHandler(ShmLogHandler handler) {
+  detail::ShmLogHandlerStorage().store(handler, std::memory_order_release);
+}
+
+/**
+ * @brief 设置共享内存日志的最低输出级别,默认kWarn
+ */
+inline void SetShmLogLevel(ShmLogLevel level) {
+  detail::ShmLogLevelStorage().store(static_cast<uint32_t>(level), std::memory_order_relaxed);
+}
+
+/**
+ * @brief 共享内存中元素类型的名称,可特化以获得跨编译器稳定的类型指纹
+ *
+ * @code
+ *   template <>
+ *   struct ShmTypeTraits<MyFrame> {
+ *     static const char* Name() { return "MyFrame/v2"; }
+ *   };
+ * @endcode
+ */
+template <typename T>
+struct ShmTypeTraits {
+  static const char* Name() { return detail::ShmTypeSignature<T>(); }
+};
+
+/**
+ * @brief 计算类型指纹(类型名称、大小、对齐和是否平凡可复制的哈希)
+ *
+ * 默认类型名称来自编译器生成的签名,仅保证同一工具链编译的程序间一致。
+ */
+template <typename T>
+uint64_t ShmTypeFingerprint() {
+  static const uint64_t fingerprint = [] {
+    const char* name = ShmTypeTraits<T>::Name();
+    const uint64_t traits[] = {sizeof(T), alignof(T), std::is_trivially_copyable<T>::value ? 1ULL : 0ULL};
+    uint64_t hash = detail::Fnv1a(name, std::strlen(name));
+    return detail::Fnv1a(reinterpret_cast<const char*>(traits), sizeof(traits), hash);
+  }();
+  return fingerprint;
+}
+
+/**
+ * @brief 检查进程是否存活
+ *
+ * kill(pid, 0)返回EPERM时进程存在但属于其他用户,同样视为存活。
+ * PID可能被复用,需要更严格的判断时应结合心跳。
+ */
+inline bool IsShmProcessAlive(int32_t pid) {
+  if (pid <= 0) {
+    return false;
+  }
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+
+/**
+ * @brief 共享内存段的布局描述,创建时写入头部,附加时逐项校验
+ */
+struct ShmSegmentLayout {
+  uint32_t kind = 0;              ///< 数据结构种类(如'SPSC'),区分不同数据结构
+  uint32_t element_size = 0;      ///< 元素大小
+  uint32_t element_align = 0;     ///< 元素对齐
+  uint64_t type_fingerprint = 0;  ///< 元素类型指纹
+  uint64_t capacity = 0;          ///< 容量(元素个数)
+  uint64_t payload_size = 0;      ///< 头部之后的负载字节数
+
+  /**
+   * @brief 按元素类型生成布局描述
+   */
+  template <typename T>
+  static ShmSegmentLayout For(uint32_t kind, uint64_t capacity, uint64_t payload_size) {
+    ShmSegmentLayout layout;
+    layout.kind = kind;
+    layout.element_size = static_cast<uint32_t>(sizeof(T));
+    layout.element_align = static_cast<uint32_t>(alignof(T));
+    layout.type_fingerprint = ShmTypeFingerprint<T>();
+    layout.capacity = capacity;
+    layout.payload_size = payload_size;
+    return layout;
+  }
+};
+
+/**
+ * @brief 共享内存段头部
+ */
+struct alignas(64) ShmSegmentHeader {
+  static constexpr uint64_t kMagic = 0x4F4D4E4953484D31ULL;  ///< "OMNISHM1"
+  static constexpr uint32_t kVersion = 1;
+
+  enum State : uint32_t {
+    kInitializing = 0,  ///< 创建者正在初始化负载
+    kReady = 1,         ///< 初始化完成,可以附加
+  };
+
+  std::atomic<uint64_t> magic;      ///< 魔数,头部字段写完后最后发布
+  uint32_t version;                 ///< 头部布局版本
+  uint32_t header_size;             ///< 头部大小
+  uint32_t kind;                    ///< 数据结构种类
+  uint32_t element_size;            ///< 元素大小
+  uint32_t element_align;           ///< 元素对齐
+  uint32_t reserved;
+  uint64_t type_fingerprint;        ///< 元素类型指纹
+  uint64_t capacity;                ///< 容量
+  uint64_t payload_size;            ///< 负载字节数
+  std::atomic<uint32_t> state;      ///< 初始化状态
+  std::atomic<int32_t> creator_pid;   ///< 创建者(所有者)PID
+  std::atomic<int32_t> attacher_pid;  ///< 最近一次附加的进程PID,关闭时清零
+
+  alignas(64) std::atomic<uint64_t> creator_heartbeat_ns;   ///< 创建者心跳(CLOCK_MONOTONIC)
+  alignas(64) std::atomic<uint64_t> attacher_heartbeat_ns;  ///< 附加者心跳(CLOCK_MONOTONIC)
+};
+
+static_assert(std::is_standard_layout<ShmSegmentHeader>::value, "ShmSegmentHeader必须是标准布局类型");
+static_assert(sizeof(ShmSegmentHeader) % 64 == 0, "ShmSegmentHeader大小必须是缓存行的整数倍");
+
+/**
+ * @brief 共享内存段选项
+ */
+struct ShmSegmentOptions {
+  mode_t mode = 0600;          ///< 创建时的权限,跨用户共享时需显式放宽
+  bool reclaim_stale = true;   ///< 创建时是否回收所有者已退出的不兼容或未初始化完成的遗留段
+  std::chrono::milliseconds attach_timeout{1000};  ///< 等待创建者完成初始化的最长时间
+
+  /// 映射的页面策略。命名共享内存位于tmpfs,不支持显式hugetlb大页,kExplicit按透明大页提示处理
+  MemoryBackingOptions backing;
+};
+
+/**
+ * @brief 共享内存段
+ *
+ * 负责共享内存对象的创建/附加、映射、头部校验、存活检测和清理,
+ * 上层数据结构只需描述布局并在创建后初始化负载。
+ */
+class ShmSegment {
+ public:
+  /**
+   * @brief 进程在段中的角色
+   */
+  enum class Role {
+    kNone,      ///< 未打开
+    kCreator,   ///< 创建者(所有者),关闭时删除共享内存对象
+    kAttacher,  ///< 附加者
+  };
+
+  ShmSegment() = default;
+  ~ShmSegment() { Close(false); }
+
+  ShmSegment(const ShmSegment&) = delete;
+  ShmSegment& operator=(const ShmSegment&) = delete;
+
+  /**
+   * @brief 打开共享内存段
+   *
+   * creator为true时: 段不存在则创建(之后需初始化负载并调用MarkReady);
+   * 段已存在且布局兼容时,所有者存活则以附加者身份打开,所有者已退出则接管所有权(Recovered()为true);
+   * 段不兼容或未初始化完成且所有者已退出时,按options.reclaim_stale回收后重新创建。
+   * creator为false时: 只附加到已存在且布局兼容的段。
+   *
+   * @param name 共享内存名称,以/开头
+   * @param layout 期望的布局
+   * @param creator 是否作为创建者打开
+   * @param options 选项
+   * @return true 打开成功
+   * @return false 打开失败(原因通过日志输出)
+   */
+  bool Open(const std::string& name, const ShmSegmentLayout& layout, bool creator,
+            const ShmSegmentOptions& options = ShmSegmentOptions()) {
+    if (role_ != Role::kNone || name.empty() || name[0] != '/') {
+      detail::ShmLog(ShmLogLevel::kError, "open", name, 0, "invalid state or name, name must start with '/'");
+      return false;
+    }
+
+    name_ = name;
+    options_ = options;
+    created_ = false;
+    recovered_ = false;
+
+    if (!creator) {
+      return AttachExisting(layout, false);
+    }
+
+    // 回收遗留段后最多重试一次创建
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      fd_ = shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, options_.mode);
+      if (fd_ >= 0) {
+        return CreateNew(layout);
+      }
+      if (errno != EEXIST) {
+        detail::ShmLog(ShmLogLevel::kError, "create", name_, errno, std::string("shm_open failed: ") + std::strerror(errno));
+        return false;
+      }
+
+      Probe probe = AttachExisting(layout, true) ? Probe::kOpened : last_probe_;
+      if (probe == Probe::kOpened) {
+        return true;
+      }
+      if (probe == Probe::kMissing) {
+        // 探测期间段已被删除,重新创建
+        continue;
+      }
+      if (probe != Probe::kStale || !options_.reclaim_stale) {
+        return false;
+      }
+
+      detail::ShmLog(ShmLogLevel::kWarn, "reclaim", name_, 0, "removing stale or unrecognized segment");
+      shm_unlink(name_.c_str());
+    }
+
+    detail::ShmLog(ShmLogLevel::kError, "create", name_, EEXIST, "segment re-created concurrently by another process");
+    return false;
+  }
+
+  /**
+   * @brief 创建者完成负载初始化后调用,允许其他进程附加
+   */
+  void MarkReady() {
+    if (header_ != nullptr) {
+      header_->state.store(ShmSegmentHeader::kReady, std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief 解除映射并关闭
+   *
+   * @param unlink 是否删除共享内存对象
+   */
+  void Close(bool unlink) {
+    if (header_ != nullptr) {
+      const int32_t self = static_cast<int32_t>(getpid());
+      if (role_ == Role::kAttacher) {
+        int32_t expected = self;
+        header_->attacher_pid.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+      } else if (role_ == Role::kCreator && !unlink) {
+        int32_t expected = self;
+        header_->creator_pid.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+      }
+      munmap(header_, map_size_);
+      header_ = nullptr;
+      map_size_ = 0;
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+    if (unlink && role_ != Role::kNone && !name_.empty()) {
+      shm_unlink(name_.c_str());
+    }
+    role_ = Role::kNone;
+  }
+
+  /**
+   * @brief 更新本进程角色对应的心跳时间
+   */
+  void Heartbeat() {
+    if (header_ == nullptr) {
+      return;
+    }
+    auto& heartbeat = role_ == Role::kCreator ? header_->creator_heartbeat_ns : header_->attacher_heartbeat_ns;
+    heartbeat.store(detail::MonotonicNowNs(), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 对端进程的PID,未知时返回0
+   */
+  int32_t PeerPid() const {
+    if (header_ == nullptr) {
+      return 0;
+    }
+    return role_ == Role::kCreator ? header_->attacher_pid.load(std::memory_order_acquire)
+                                   : header_->creator_pid.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 判断对端是否存活
+   *
+   * @param heartbeat_timeout 大于0时还要求对端心跳在该时间内更新过
+   * @return true 对端进程存在(且心跳未超时)
+   */
+  bool IsPeerAlive(std::chrono::nanoseconds heartbeat_timeout = std::chrono::nanoseconds::zero()) const {
+    if (!IsShmProcessAlive(PeerPid())) {
+      return false;
+    }
+    if (heartbeat_timeout.count() <= 0) {
+      return true;
+    }
+    const auto& heartbeat = role_ == Role::kCreator ? header_->attacher_heartbeat_ns : header_->creator_heartbeat_ns;
+    const uint64_t last = heartbeat.load(std::memory_order_relaxed);
+    return detail::MonotonicNowNs() - last <= static_cast<uint64_t>(heartbeat_timeout.count());
+  }
+
+  /**
+   * @brief 负载起始地址
+   */
+  void* Payload() const {
+    return header_ == nullptr ? nullptr : reinterpret_cast<char*>(header_) + sizeof(ShmSegmentHeader);
+  }
+
+  ShmSegmentHeader* Header() const { return header_; }
+  Role GetRole() const { return role_; }
+  const std::string& Name() const { return name_; }
+
+  /**
+   * @brief 本次打开是否新建了段(负载需要初始化)
+   */
+  bool Created() const { return created_; }
+
+  /**
+   * @brief 本次打开是否接管了已退出所有者遗留的兼容段(负载保留原数据)
+   */
+  bool Recovered() const { return recovered_; }
+
+  /**
+   * @brief 映射实际生效的页面策略
+   */
+  const MemoryBackingResult& Backing() const { return backing_; }
+
+  /**
+   * @brief 段的总大小
+   */
+  static size_t TotalSize(const ShmSegmentLayout& layout) {
+    return sizeof(ShmSegmentHeader) + layout.payload_size;
+  }
+
+  /**
+   * @brief 删除共享内存对象(已映射的进程不受影响)
+   *
+   * @return true 已删除或本就不存在
+   */
+  static bool Remove(const std::string& name) {
+    if (shm_unlink(name.c_str()) == 0 || errno == ENOENT) {
+      return true;
+    }
+    detail::ShmLog(ShmLogLevel::kError, "remove", name, errno, std::string("shm_unlink failed: ") + std::strerror(errno));
+    return false;
+  }
+
+  /**
+   * @brief 当段的所有者已退出或段无法识别时删除共享内存对象
+   *
+   * 用于进程启动时清理上次崩溃遗留的段。
+   *
+   * @return true 段已被删除或本就不存在
+   * @return false 所有者仍存活或访问失败
+   */
+  static bool RemoveIfOrphaned(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+      return errno == ENOENT;
+    }
+
+    bool orphaned = true;
+    struct stat sb;
+    if (fstat(fd, &sb) == 0 && static_cast<size_t>(sb.st_size) >= sizeof(ShmSegmentHeader)) {
+      void* addr = mmap(nullptr, sizeof(ShmSegmentHeader), PROT_READ, MAP_SHARED, fd, 0);
+      if (addr != MAP_FAILED) {
+        const auto* header = static_cast<const ShmSegmentHeader*>(addr);
+        if (header->magic.load(std::memory_order_acquire) == ShmSegmentHeader::kMagic &&
+            IsShmProcessAlive(header->creator_pid.load(std::memory_order_acquire))) {
+          orphaned = false;
+        }
+        munmap(addr, sizeof(ShmSegmentHeader));
+      } else {
+        orphaned = false;
+      }
+    }
+    close(fd);
+
+    if (!orphaned) {
+      return false;
+    }
+    detail::ShmLog(ShmLogLevel::kInfo, "reclaim", name, 0, "removing orphaned segment");
+    return Remove(name);
+  }
+
+ private:
+  /**
+   * @brief 探测已存在段的结果
+   */
+  enum class Probe {
+    kOpened,        ///< 已打开(附加或接管)
+    kIncompatible,  ///< 布局不兼容且所有者存活,或访问失败
+    kStale,         ///< 不兼容或未初始化完成,且所有者已退出,可以回收
+    kMissing,       ///< 段不存在
+  };
+
+  bool CreateNew(const ShmSegmentLayout& layout) {
+    // shm_open受umask影响,显式设置为配置的权限
+    fchmod(fd_, options_.mode);
+
+    const size_t total_size = TotalSize(layout);
+    if (ftruncate(fd_, static_cast<off_t>(total_size)) != 0) {
+      detail::ShmLog(ShmLogLevel::kError, "create", name_, errno, std::string("ftruncate failed: ") + std::strerror(errno));
+      close(fd_);
+      fd_ = -1;
+      shm_unlink(name_.c_str());
+      return false;
+    }
+    if (!Map(total_size)) {
+      close(fd_);
+      fd_ = -1;
+      shm_unlink(name_.c_str());
+      return false;
+    }
+    // 在写入头部之前应用,保证NUMA策略作用于首次分配的页面
+    ApplyBacking();
+
+    header_->version = ShmSegmentHeader::kVersion;
+    header_->header_size = static_cast<uint32_t>(sizeof(ShmSegmentHeader));
+    header_->kind = layout.kind;
+    header_->element_size = layout.element_size;
+    header_->element_align = layout.element_align;
+    header_->reserved = 0;
+    header_->type_fingerprint = layout.type_fingerprint;
+    header_->capacity = layout.capacity;
+    header_->payload_size = layout.payload_size;
+    header_->state.store(ShmSegmentHeader::kInitializing, std::memory_order_relaxed);
+    header_->creator_pid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+    header_->attacher_pid.store(0, std::memory_order_relaxed);
+    header_->creator_heartbeat_ns.store(detail::MonotonicNowNs(), std::memory_order_relaxed);
+    header_->attacher_heartbeat_ns.store(0, std::memory_order_relaxed);
+    header_->magic.store(ShmSegmentHeader::kMagic, std::memory_order_release);
+
+    role_ = Role::kCreator;
+    created_ = true;
+    detail::ShmLog(ShmLogLevel::kDebug, "create", name_, 0,
+                   "created segment, size=" + std::to_string(total_size));
+    return true;
+  }
+
+  bool Map(size_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+      detail::ShmLog(ShmLogLevel::kError, "map", name_, errno, std::string("mmap failed: ") + std::strerror(errno));
+      return false;
+    }
+    header_ = static_cast<ShmSegmentHeader*>(addr);
+    map_size_ = size;
+    return true;
+  }
+
+  void ApplyBacking() {
+    backing_ = ApplyMemoryBacking(header_, map_size_, options_.backing);
+    if (!backing_.fallback.empty()) {
+      detail::ShmLog(ShmLogLevel::kWarn, "backing", name_, 0, "falling back to regular pages for " + backing_.fallback);
+    }
+  }
+
+  void Unmap() {
+    if (header_ != nullptr) {
+      munmap(header_, map_size_);
+      header_ = nullptr;
+      map_size_ = 0;
+    }
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+
+  std::string DescribeMismatch(const ShmSegmentLayout& layout) const {
+    std::string desc;
+    auto append = [&desc](const char* field, uint64_t expected, uint64_t actual) {
+      if (expected != actual) {
+        desc += std::string(desc.empty() ? "" : ", ") + field + " expected " + std::to_string(expected) +
+                " got " + std::to_string(actual);
+      }
+    };
+    append("version", ShmSegmentHeader::kVersion, header_->version);
+    append("header_size", sizeof(ShmSegmentHeader), header_->header_size);
+    append("kind", layout.kind, header_->kind);
+    append("element_size", layout.element_size, header_->element_size);
+    append("element_align", layout.element_align, header_->element_align);
+    append("type_fingerprint", layout.type_fingerprint, header_->type_fingerprint);
+    append("capacity", layout.capacity, header_->capacity);
+    append("payload_size", layout.payload_size, header_->payload_size);
+    return desc;
+  }
+
+  /**
+   * @brief 附加到已存在的段,结果记录在last_probe_中
+   *
+   * @param layout 期望的布局
+   * @param as_creator 是否由创建者调用(所有者已退出时接管所有权)
+   */
+  bool AttachExisting(const ShmSegmentLayout& layout, bool as_creator) {
+    last_probe_ = ProbeExisting(layout, as_creator);
+    if (last_probe_ != Probe::kOpened) {
+      Unmap();
+      return false;
+    }
+    ApplyBacking();
+    return true;
+  }
+
+  Probe ProbeExisting(const ShmSegmentLayout& layout, bool as_creator) {
+    fd_ = shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd_ < 0) {
+      const int err = errno;
+      detail::ShmLog(err == ENOENT ? ShmLogLevel::kInfo : ShmLogLevel::kError, "attach", name_, err,
+                     std::string("shm_open failed: ") + std::strerror(err));
+      return err == ENOENT ? Probe::kMissing : Probe::kIncompatible;
+    }
+
+    // 等待创建者完成ftruncate、发布魔数并完成负载初始化
+    const auto deadline = std::chrono::steady_clock::now() + options_.attach_timeout;
+    while (true) {
+      struct stat sb;
+      if (fstat(fd_, &sb) != 0) {
+        detail::ShmLog(ShmLogLevel::kError, "attach", name_, errno, std::string("fstat failed: ") + std::strerror(errno));
+        return Probe::kIncompatible;
+      }
+
+      const size_t size = static_cast<size_t>(sb.st_size);
+      if (size >= sizeof(ShmSegmentHeader)) {
+        if (header_ == nullptr || map_size_ != size) {
+          if (header_ != nullptr) {
+            munmap(header_, map_size_);
+            header_ = nullptr;
+          }
+          if (!Map(size)) {
+            return Probe::kIncompatible;
+          }
+        }
+
+        const uint64_t magic = header_->magic.load(std::memory_order_acquire);
+        if (magic != 0 && magic != ShmSegmentHeader::kMagic) {
+          // 无法识别的段(旧版本布局或其他程序的数据),无法判断所有者,只能由调用方决定是否回收
+          detail::ShmLog(ShmLogLevel::kError, "validate", name_, 0, "unrecognized segment header (bad magic)");
+          return Probe::kStale;
+        }
+        if (magic == ShmSegmentHeader::kMagic) {
+          const int32_t owner = header_->creator_pid.load(std::memory_order_acquire);
+          const bool owner_alive = IsShmProcessAlive(owner);
+          if (header_->state.load(std::memory_order_acquire) == ShmSegmentHeader::kReady) {
+            return ValidateAndOpen(layout, as_creator, owner_alive, size);
+          }
+          if (!owner_alive) {
+            detail::ShmLog(ShmLogLevel::kWarn, "validate", name_, 0,
+                           "owner pid " + std::to_string(owner) + " exited before finishing initialization");
+            return Probe::kStale;
+          }
+        }
+      }
+
+      if (std::chrono::steady_clock::now() >= deadline) {
+        detail::ShmLog(ShmLogLevel::kWarn, "attach", name_, ETIMEDOUT, "segment was not initialized in time");
+        return Probe::kStale;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+
+  Probe ValidateAndOpen(const ShmSegmentLayout& layout, bool as_creator, bool owner_alive, size_t size) {
+    std::string mismatch = DescribeMismatch(layout);
+    if (mismatch.empty() && size < TotalSize(layout)) {
+      mismatch = "segment truncated to " + std::to_string(size) + " bytes";
+    }
+    if (!mismatch.empty()) {
+      detail::ShmLog(ShmLogLevel::kError, "validate", name_, 0, "layout mismatch: " + mismatch);
+      return owner_alive ? Probe::kIncompatible : Probe::kStale;
+    }
+
+    const int32_t self = static_cast<int32_t>(getpid());
+    if (as_creator && !owner_alive) {
+      // 所有者已退出: 接管所有权,保留队列中的数据
+      const int32_t previous = header_->creator_pid.exchange(self, std::memory_order_acq_rel);
+      header_->creator_heartbeat_ns.store(detail::MonotonicNowNs(), std::memory_order_relaxed);
+      role_ = Role::kCreator;
+      recovered_ = true;
+      detail::ShmLog(ShmLogLevel::kWarn, "recover", name_, 0,
+                     "took over segment from dead owner pid " + std::to_string(previous));
+      return Probe::kOpened;
+    }
+
+    if (!owner_alive) {
+      detail::ShmLog(ShmLogLevel::kWarn, "attach", name_, 0, "attached to segment whose owner is not alive");
+    }
+    header_->attacher_pid.store(self, std::memory_order_release);
+    header_->attacher_heartbeat_ns.store(detail::MonotonicNowNs(), std::memory_order_relaxed);
+    role_ = Role::kAttacher;
+    return Probe::kOpened;
+  }
+
+  std::string name_;
+  ShmSegmentOptions options_;
+  int fd_{-1};
+  ShmSegmentHeader* header_{nullptr};
+  size_t map_size_{0};
+  Role role_{Role::kNone};
+  bool created_{false};
+  bool recovered_{false};
+  MemoryBackingResult backing_;
+  Probe last_probe_{Probe::kMissing};
+};
+
+}  // namespace omnirt::common::util
@@ -0,0 +1,297 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include "util/macros.h"
+#include "util/string_simd.h"
+
+namespace aimrt::common::util {
+
+/**
+ * @brief 符号id,0表示无效
+ */
+using SymbolId = uint32_t;
+inline constexpr SymbolId kInvalidSymbolId = 0;
+
+/**
+ * @brief 字符串驻留表
+ *
+ * 把话题名、类型名、模块名等框架名字映射为稳定的32位id,之后只比较和哈希id。
+ * 特点:
+ * 1. 查找(Find/Lookup以及命中时的Intern)不加锁,只有首次插入时加锁
+ * 2. id从1开始连续分配,一经分配永不改变,Lookup按id为O(1)
+ * 3. 字符串拷贝到内部存储并以'\0'结尾,返回的string_view在驻留表析构前一直有效
+ * 4. 不支持删除
+ *
+ * 通过Intern或Find取得的id可以直接在其它线程Lookup;若id经由无同步的方式传递,需自行保证happens-before
+ */
+class StringInterner {
+ public:
+  /**
+   * @param expected_size 预期的字符串个数,用于确定初始哈希表大小
+   */
+  explicit StringInterner(size_t expected_size = 256) {
+    size_t capacity = 16;
+    while (capacity < expected_size * 2) capacity <<= 1;
+    tables_.emplace_back(std::make_unique<Table>(capacity));
+    table_.store(tables_.back().get(), std::memory_order_release);
+  }
+
+  ~StringInterner() {
+    for (auto& chunk : chunks_) delete[] chunk.load(std::memory_order_relaxed);
+  }
+
+  StringInterner(const StringInterner&) = delete;
+  StringInterner& operator=(const StringInterner&) = delete;
+
+  /**
+   * @brief 进程级驻留表,故意不析构,保证静态对象析构期间id仍然可用
+   */
+  static StringInterner& Instance() {
+    static StringInterner* const interner = new StringInterner(4096);
+    return *interner;
+  }
+
+  /**
+   * @brief 驻留字符串,已存在时返回原id
+   *
+   * @param str 字符串
+   * @return SymbolId 符号id
+   */
+  SymbolId Intern(std::string_view str) {
+    const uint64_t hash = Hash64Wy(str);
+    if (SymbolId id = FindInTable(table_.load(std::memory_order_acquire), str, hash); id != kInvalidSymbolId) {
+      return id;
+    }
+    return InternSlow(str, hash);
+  }
+
+  /**
+   * @brief 查找字符串的id,不插入
+   *
+   * @param str 字符串
+   * @return SymbolId 符号id,不存在(或正与其它线程的插入并发)时返回kInvalidSymbolId
+   */
+  SymbolId Find(std::string_view str) const {
+    return FindInTable(table_.load(std::memory_order_acquire), str, Hash64Wy(str));
+  }
+
+  /**
+   * @brief 按id取字符串
+   *
+   * @param id 符号id
+   * @return std::string_view 对应的字符串,id无效时返回空串
+   */
+  std::string_view Lookup(SymbolId id) const {
+    if (omnirt_unlikely(id == kInvalidSymbolId || id > size_.load(std::memory_order_acquire))) return {};
+    return EntryAt(id).str;
+  }
+
+  /**
+   * @brief 已驻留的字符串个数
+   */
+  size_t Size() const { return size_.load(std::memory_order_acquire); }
+
+ private:
+  struct Entry {
+    std::string_view str;
+    uint64_t hash;
+  };
+
+  /**
+   * @brief 开放寻址哈希表,槽位为(hash高32位 << 32 | id),0表示空槽
+   */
+  struct Table {
+    explicit Table(size_t capacity) : mask(capacity - 1), slots(new std::atomic<uint64_t>[capacity]) {
+      for (size_t i = 0; i < capacity; ++i) slots[i].store(0, std::memory_order_relaxed);
+    }
+
+    const size_t mask;
+    const std::unique_ptr<std::atomic<uint64_t>[]> slots;
+  };
+
+  // 目录分块: 第k块容纳(kFirstChunkSize << k)个条目,已分配的块不会移动,24块可容纳约2^32个条目
+  static constexpr uint32_t kFirstChunkBits = 8;
+  static constexpr uint32_t kFirstChunkSize = 1u << kFirstChunkBits;
+  static constexpr uint32_t kChunkCount = 24;
+
+  static uint32_t ChunkIndex(uint32_t index) {
+    const uint32_t n = (index >> kFirstChunkBits) + 1;
+    return 31 - static_cast<uint32_t>(__builtin_clz(n));
+  }
+
+  static uint32_t ChunkBegin(uint32_t chunk) { return kFirstChunkSize * ((1u << chunk) - 1); }
+
+  const Entry& EntryAt(SymbolId id) const {
+    const uint32_t index = id - 1;
+    const uint32_t chunk = ChunkIndex(index);
+    return chunks_[chunk].load(std::memory_order_acquire)[index - ChunkBegin(chunk)];
+  }
+
+  static uint64_t MakeSlot(uint64_t hash, SymbolId id) { return (hash & 0xFFFFFFFF00000000ULL) | id; }
+
+  SymbolId FindInTable(const Table* table, std::string_view str, uint64_t hash) const {
+    for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+      const uint64_t slot = table->slots[i].load(std::memory_order_acquire);
+      if (slot == 0) return kInvalidSymbolId;
+      if ((slot ^ hash) >> 32 == 0) {
+        const auto id = static_cast<SymbolId>(slot);
+        if (EntryAt(id).str == str) return id;
+      }
+    }
+  }
+
+  static void InsertToTable(Table* table, uint64_t hash, SymbolId id) {
+    size_t i = hash & table->mask;
+    while (table->slots[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & table->mask;
+    table->slots[i].store(MakeSlot(hash, id), std::memory_order_release);
+  }
+
+  SymbolId InternSlow(std::string_view str, uint64_t hash) {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    Table* table = table_.load(std::memory_order_relaxed);
+    if (SymbolId id = FindInTable(table, str, hash); id != kInvalidSymbolId) return id;
+
+    const auto size = static_cast<uint32_t>(size_.load(std::memory_order_relaxed));
+    const SymbolId id = size + 1;
+    const uint32_t chunk = ChunkIndex(size);
+    if (chunk >= kChunkCount || id == 0) std::abort();
+
+    Entry* entries = chunks_[chunk].load(std::memory_order_relaxed);
+    if (entries == nullptr) {
+      entries = new Entry[kFirstChunkSize << chunk];
+      chunks_[chunk].store(entries, std::memory_order_release);
+    }
+    entries[size - ChunkBegin(chunk)] = Entry{CopyString(str), hash};
+    size_.store(id, std::memory_order_release);
+
+    // 负载因子不超过1/2
+    if (static_cast<size_t>(id) * 2 > table->mask + 1) table = Grow(table);
+    InsertToTable(table, hash, id);
+    return id;
+  }
+
+  /**
+   * @brief 扩容: 在新表中重建全部已有条目后再发布,旧表保留到析构,正在旧表上查找的读者不受影响
+   */
+  Table* Grow(Table* old_table) {
+    auto new_table = std::make_unique<Table>((old_table->mask + 1) * 2);
+    const auto size = static_cast<SymbolId>(size_.load(std::memory_order_relaxed));
+    // 最新的条目由调用方在发布新表后插入
+    for (SymbolId id = 1; id < size; ++id) InsertToTable(new_table.get(), EntryAt(id).hash, id);
+
+    Table* table = new_table.get();
+    tables_.emplace_back(std::move(new_table));
+    table_.store(table, std::memory_order_release);
+    return table;
+  }
+
+  std::string_view CopyString(std::string_view str) {
+    const size_t need = str.size() + 1;
+    char* dst;
+    if (need > kArenaBlockSize / 4) {
+      // 大字符串单独分配,不浪费当前块的剩余空间
+      arena_blocks_.emplace_back(new char[need]);
+      dst = arena_blocks_.back().get();
+    } else {
+      if (need > arena_left_) {
+        arena_blocks_.emplace_back(new char[kArenaBlockSize]);
+        arena_ptr_ = arena_blocks_.back().get();
+        arena_left_ = kArenaBlockSize;
+      }
+      dst = arena_ptr_;
+      arena_ptr_ += need;
+      arena_left_ -= need;
+    }
+    memcpy(dst, str.data(), str.size());
+    dst[str.size()] = '\0';
+    return std::string_view(dst, str.size());
+  }
+
+  static constexpr size_t kArenaBlockSize = 16 * 1024;
+
+  std::atomic<Table*> table_{nullptr};
+  std::atomic<size_t> size_{0};
+  std::atomic<Entry*> chunks_[kChunkCount] = {};
+
+  std::mutex mutex_;  ///< 串行化插入,保护以下成员
+  std::vector<std::unique_ptr<Table>> tables_;
+  std::vector<std::unique_ptr<char[]>> arena_blocks_;
+  char* arena_ptr_ = nullptr;
+  size_t arena_left_ = 0;
+};
+
+/**
+ * @brief 进程级驻留表中的一个符号,可作为哈希表和有序表的键,比较与哈希只涉及32位id
+ */
+class Symbol {
+ public:
+  constexpr Symbol() = default;
+
+  /**
+   * @brief 驻留字符串并构造符号
+   */
+  explicit Symbol(std::string_view str) : id_(StringInterner::Instance().Intern(str)) {}
+
+  /**
+   * @brief 查找已驻留的字符串,不插入,不存在时返回无效符号
+   */
+  static Symbol Find(std::string_view str) { return FromId(StringInterner::Instance().Find(str)); }
+
+  static constexpr Symbol FromId(SymbolId id) {
+    Symbol symbol;
+    symbol.id_ = id;
+    return symbol;
+  }
+
+  constexpr SymbolId Id() const { return id_; }
+  constexpr bool Valid() const { return id_ != kInvalidSymbolId; }
+  std::string_view Str() const { return StringInterner::Instance().Lookup(id_); }
+
+  friend constexpr bool operator==(Symbol lhs, Symbol rhs) { return lhs.id_ == rhs.id_; }
+  friend constexpr bool operator!=(Symbol lhs, Symbol rhs) { return lhs.id_ != rhs.id_; }
+  friend constexpr bool operator<(Symbol lhs, Symbol rhs) { return lhs.id_ < rhs.id_; }
+
+ private:
+  SymbolId id_ = kInvalidSymbolId;
+};
+
+struct SymbolHash {
+  std::size_t operator()(Symbol symbol) const noexcept { return symbol.Id(); }
+};
+
+/**
+ * @brief 在以Symbol为键的容器中按名字查找,名字未驻留时直接返回end(),不会插入驻留表也不会构造std::string
+ *
+ * @param map 以Symbol为键的容器
+ * @param name 名字
+ * @return 迭代器
+ */
+template <class Map>
+inline auto FindBySymbolName(Map& map, std::string_view name) -> decltype(map.find(Symbol())) {
+  const Symbol symbol = Symbol::Find(name);
+  if (!symbol.Valid()) return map.end();
+  return map.find(symbol);
+}
+
+}  // namespace aimrt::common::util
+
+namespace std {
+template <>
+struct hash<aimrt::common::util::Symbol> {
+  std::size_t operator()(aimrt::common::util::Symbol symbol) const noexcept { return symbol.Id(); }
+};
+}  // namespace std
@@ -0,0 +1,176 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "util/string_interner.h"
+
+namespace aimrt::common::util {
+
+TEST(STRING_INTERNER_TEST, Basic) {
+  StringInterner interner;
+  EXPECT_EQ(interner.Size(), 0);
+  EXPECT_EQ(interner.Find("topic"), kInvalidSymbolId);
+  EXPECT_EQ(interner.Lookup(kInvalidSymbolId), "");
+  EXPECT_EQ(interner.Lookup(1), "");
+
+  const SymbolId topic = interner.Intern("topic");
+  const SymbolId type = interner.Intern(std::string("pb:/example.Msg"));
+  const SymbolId empty = interner.Intern("");
+  EXPECT_EQ(topic, 1);
+  EXPECT_EQ(type, 2);
+  EXPECT_EQ(empty, 3);
+  EXPECT_EQ(interner.Intern("topic"), topic);
+  EXPECT_EQ(interner.Find("topic"), topic);
+  EXPECT_EQ(interner.Find(""), empty);
+  EXPECT_EQ(interner.Size(), 3);
+
+  EXPECT_EQ(interner.Lookup(type), "pb:/example.Msg");
+  EXPECT_EQ(interner.Lookup(type).data()[interner.Lookup(type).size()], '\0');
+
+  // 内嵌'\0'以及长字符串
+  const std::string with_nul("a\0b", 3);
+  const std::string long_str(100000, 'x');
+  const SymbolId nul_id = interner.Intern(with_nul);
+  const SymbolId long_id = interner.Intern(long_str);
+  EXPECT_NE(nul_id, interner.Intern("a"));
+  EXPECT_EQ(interner.Lookup(nul_id), with_nul);
+  EXPECT_EQ(interner.Lookup(long_id), long_str);
+}
+
+TEST(STRING_INTERNER_TEST, Growth) {
+  StringInterner interner(1);
+  constexpr size_t kCount = 100000;
+
+  std::vector<std::string_view> views;
+  for (size_t i = 0; i < kCount; ++i) {
+    const SymbolId id = interner.Intern("module_" + std::to_string(i));
+    ASSERT_EQ(id, i + 1);
+    views.emplace_back(interner.Lookup(id));
+  }
+  ASSERT_EQ(interner.Size(), kCount);
+
+  // 扩容不改变id,也不移动字符串
+  for (size_t i = 0; i < kCount; ++i) {
+    const std::string name = "module_" + std::to_string(i);
+    ASSERT_EQ(interner.Find(name), i + 1);
+    ASSERT_EQ(interner.Lookup(i + 1), name);
+    ASSERT_EQ(interner.Lookup(i + 1).data(), views[i].data());
+  }
+  EXPECT_EQ(interner.Find("module_" + std::to_string(kCount)), kInvalidSymbolId);
+}
+
+TEST(STRING_INTERNER_TEST, Symbol) {
+  const Symbol a("/chatter");
+  const Symbol b(std::string("/chatter"));
+  const Symbol c("/imu");
+  EXPECT_TRUE(a.Valid());
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(a.Str(), "/chatter");
+  EXPECT_EQ(Symbol::Find("/chatter"), a);
+  EXPECT_FALSE(Symbol::Find("/never_interned_name").Valid());
+  EXPECT_FALSE(Symbol().Valid());
+  EXPECT_EQ(Symbol::FromId(a.Id()), a);
+
+  std::unordered_map<Symbol, int> umap{{a, 1}, {c, 2}};
+  std::unordered_map<Symbol, int, SymbolHash> umap2{{a, 1}};
+  std::map<Symbol, int> omap{{c, 2}};
+  EXPECT_EQ(FindBySymbolName(umap, "/chatter")->second, 1);
+  EXPECT_EQ(FindBySymbolName(umap2, "/chatter")->second, 1);
+  EXPECT_EQ(FindBySymbolName(omap, "/imu")->second, 2);
+  EXPECT_EQ(FindBySymbolName(umap, "/never_interned_name"), umap.end());
+  EXPECT_EQ(FindBySymbolName(omap, "/chatter"), omap.end());
+
+  // 查找不存在的名字不会插入驻留表
+  EXPECT_FALSE(Symbol::Find("/never_interned_name").Valid());
+}
+
+TEST(STRING_INTERNER_TEST, Concurrent) {
+  StringInterner interner(1);
+  constexpr int kThreads = 32;
+  constexpr int kNames = 2000;
+
+  std::vector<std::vector<SymbolId>> ids(kThreads, std::vector<SymbolId>(kNames));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      // 每个线程以不同顺序插入同一组名字,并穿插查找
+      for (int i = 0; i < kNames; ++i) {
+        const int n = (i * 7 + t * 131) % kNames;
+        const std::string name = "/topic/" + std::to_string(n);
+        const SymbolId id = interner.Intern(name);
+        ids[t][n] = id;
+        ASSERT_EQ(interner.Lookup(id), name);
+        ASSERT_EQ(interner.Find(name), id);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  EXPECT_EQ(interner.Size(), kNames);
+  for (int t = 1; t < kThreads; ++t) ASSERT_EQ(ids[t], ids[0]);
+  for (int n = 0; n < kNames; ++n) ASSERT_EQ(interner.Lookup(ids[0][n]), "/topic/" + std::to_string(n));
+}
+
+TEST(STRING_INTERNER_TEST, Benchmark) {
+  constexpr int kThreads = 32;
+  constexpr int kNames = 4096;
+  constexpr int kRounds = 50;
+
+  std::vector<std::string> names;
+  for (int i = 0; i < kNames; ++i) names.emplace_back("/aimrt/example/module_" + std::to_string(i) + "/topic");
+
+  auto run = [&](auto&& op) {
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t] {
+        uint64_t sink = 0;
+        for (int r = 0; r < kRounds; ++r) {
+          for (int i = 0; i < kNames; ++i) sink += op(names[(i + t * 61) % kNames]);
+        }
+        volatile uint64_t keep = sink;
+        (void)keep;
+      });
+    }
+    for (auto& t : threads) t.join();
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - begin).count() / (kThreads * kRounds * kNames);
+  };
+
+  // 对照: 互斥锁保护的unordered_map
+  std::mutex mutex;
+  std::unordered_map<std::string, uint32_t> locked_map;
+  const double locked_ns = run([&](const std::string& name) -> uint64_t {
+    std::lock_guard<std::mutex> lck(mutex);
+    return locked_map.emplace(name, static_cast<uint32_t>(locked_map.size() + 1)).first->second;
+  });
+
+  StringInterner interner(1);
+  const double intern_ns = run([&](const std::string& name) -> uint64_t { return interner.Intern(name); });
+  const double find_ns = run([&](const std::string& name) -> uint64_t { return interner.Find(name); });
+
+  std::vector<SymbolId> ids;
+  for (const auto& name : names) ids.emplace_back(interner.Find(name));
+  const double lookup_ns = run([&](const std::string& name) -> uint64_t {
+    return interner.Lookup(ids[name.size() % kNames]).size();
+  });
+
+  std::cout << "threads: " << kThreads << ", names: " << kNames << "\n"
+            << "mutex + unordered_map: " << locked_ns << " ns/op\n"
+            << "Intern:                " << intern_ns << " ns/op\n"
+            << "Find:                  " << find_ns << " ns/op\n"
+            << "Lookup by id:          " << lookup_ns << " ns/op" << std::endl;
+}
+
+}  // namespace aimrt::common::util
@@ -0,0 +1,664 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+//
+// SIMD字符串基础操作
+// 为配置解析、日志过滤和话题路由提供子串查找、字符集查找、ASCII大小写转换/比较以及wyhash哈希。
+// x86上按运行时检测到的指令集(SSE4.2/AVX2)分派,aarch64上使用NEON,其余平台使用标量实现。
+// 所有实现只处理ASCII大小写,与C locale下的tolower/toupper结果一致。
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+#include "util/macros.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define AIMRT_STRING_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define AIMRT_STRING_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace aimrt::common::util {
+
+/**
+ * @brief 字符串操作使用的SIMD指令集级别
+ */
+enum class StringSimdLevel : uint32_t {
+  kScalar,
+  kSse42,
+  kAvx2,
+  kNeon,
+};
+
+namespace string_simd_detail {
+
+/**
+ * @brief 一组字符串操作的实现,按指令集级别各有一份
+ */
+struct StringSimdOps {
+  StringSimdLevel level;
+  size_t (*find)(const char* hay, size_t n, const char* needle, size_t m);
+  size_t (*find_first_of)(const char* s, size_t n, const char* set, size_t k);
+  void (*to_lower)(char* dst, const char* src, size_t n);
+  void (*to_upper)(char* dst, const char* src, size_t n);
+  bool (*iequal)(const char* a, const char* b, size_t n);
+};
+
+inline constexpr char AsciiLower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 0x20) : c; }
+inline constexpr char AsciiUpper(char c) { return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 0x20) : c; }
+
+// ---------------------------------------------------------------------------
+// 标量实现
+// ---------------------------------------------------------------------------
+
+inline size_t ScalarFind(const char* hay, size_t n, const char* needle, size_t m) {
+  const size_t pos = std::string_view(hay, n).find(std::string_view(needle, m));
+  return pos == std::string_view::npos ? n : pos;
+}
+
+inline size_t ScalarFindFirstOf(const char* s, size_t n, const char* set, size_t k) {
+  uint64_t bitmap[4] = {0, 0, 0, 0};
+  for (size_t i = 0; i < k; ++i) {
+    const auto c = static_cast<uint8_t>(set[i]);
+    bitmap[c >> 6] |= uint64_t{1} << (c & 63);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    const auto c = static_cast<uint8_t>(s[i]);
+    if (bitmap[c >> 6] & (uint64_t{1} << (c & 63))) return i;
+  }
+  return n;
+}
+
+inline void ScalarToLower(char* dst, const char* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) dst[i] = AsciiLower(src[i]);
+}
+
+inline void ScalarToUpper(char* dst, const char* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) dst[i] = AsciiUpper(src[i]);
+}
+
+inline bool ScalarIEqual(const char* a, const char* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (a[i] != b[i] && AsciiLower(a[i]) != AsciiLower(b[i])) return false;
+  }
+  return true;
+}
+
+inline constexpr StringSimdOps kScalarOps{
+    StringSimdLevel::kScalar, ScalarFind, ScalarFindFirstOf, ScalarToLower, ScalarToUpper, ScalarIEqual};
+
+#if defined(AIMRT_STRING_SIMD_X86)
+
+// ---------------------------------------------------------------------------
+// SSE4.2: 16字节一组
+// ---------------------------------------------------------------------------
+
+#define AIMRT_SIMD_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define AIMRT_SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+
+/**
+ * @brief 子串查找: 用首尾两个字符同时过滤候选位置,再逐一比较中间部分
+ */
+AIMRT_SIMD_TARGET_SSE42 inline size_t Sse42Find(const char* hay, size_t n, const char* needle, size_t m) {
+  if (m == 0) return 0;
+  if (m > n) return n;
+  if (m == 1) {
+    const void* p = memchr(hay, needle[0], n);
+    return p ? static_cast<const char*>(p) - hay : n;
+  }
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[m - 1]);
+  size_t i = 0;
+  for (; i + m - 1 + 16 <= n; i += 16) {
+    const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i));
+    const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + i + m - 1));
+    uint32_t mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+    while (mask != 0) {
+      const size_t bit = static_cast<size_t>(__builtin_ctz(mask));
+      if (memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0) return i + bit;
+      mask &= mask - 1;
+    }
+  }
+  const size_t rest = ScalarFind(hay + i, n - i, needle, m);
+  return rest == n - i ? n : i + rest;
+}
+
+/**
+ * @brief 字符集查找: 字符集不超过16个字符时使用pcmpestri
+ */
+AIMRT_SIMD_TARGET_SSE42 inline size_t Sse42FindFirstOf(const char* s, size_t n, const char* set, size_t k) {
+  if (k == 0 || k > 16) return ScalarFindFirstOf(s, n, set, k);
+  alignas(16) char set_buf[16] = {};
+  memcpy(set_buf, set, k);
+  const __m128i set_vec = _mm_load_si128(reinterpret_cast<const __m128i*>(set_buf));
+  constexpr int kMode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const int idx = _mm_cmpestri(set_vec, static_cast<int>(k), chunk, 16, kMode);
+    if (idx < 16) return i + static_cast<size_t>(idx);
+  }
+  if (i < n) {
+    alignas(16) char tail[16] = {};
+    memcpy(tail, s + i, n - i);
+    const __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(tail));
+    const int idx = _mm_cmpestri(set_vec, static_cast<int>(k), chunk, static_cast<int>(n - i), kMode);
+    if (idx < static_cast<int>(n - i)) return i + static_cast<size_t>(idx);
+  }
+  return n;
+}
+
+/**
+ * @brief 大小写转换: lo <= c <= hi的字节加上delta(有符号比较,非ASCII字节为负数不会命中)
+ */
+AIMRT_SIMD_TARGET_SSE42 inline void Sse42ShiftCase(char* dst, const char* src, size_t n, char lo, char hi,
+                                                   char delta) {
+  const __m128i below = _mm_set1_epi8(static_cast<char>(lo - 1));
+  const __m128i above = _mm_set1_epi8(static_cast<char>(hi + 1));
+  const __m128i diff = _mm_set1_epi8(delta);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, below), _mm_cmplt_epi8(v, above));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_add_epi8(v, _mm_and_si128(in_range, diff)));
+  }
+  for (; i < n; ++i) {
+    dst[i] = (src[i] >= lo && src[i] <= hi) ? static_cast<char>(src[i] + delta) : src[i];
+  }
+}
+
+AIMRT_SIMD_TARGET_SSE42 inline void Sse42ToLower(char* dst, const char* src, size_t n) {
+  Sse42ShiftCase(dst, src, n, 'A', 'Z', 0x20);
+}
+
+AIMRT_SIMD_TARGET_SSE42 inline void Sse42ToUpper(char* dst, const char* src, size_t n) {
+  Sse42ShiftCase(dst, src, n, 'a', 'z', -0x20);
+}
+
+AIMRT_SIMD_TARGET_SSE42 inline __m128i Sse42Lower(__m128i v) {
+  const __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                         _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+  return _mm_add_epi8(v, _mm_and_si128(in_range, _mm_set1_epi8(0x20)));
+}
+
+AIMRT_SIMD_TARGET_SSE42 inline bool Sse42IEqual(const char* a, const char* b, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(Sse42Lower(va), Sse42Lower(vb))) != 0xFFFF) return false;
+  }
+  return ScalarIEqual(a + i, b + i, n - i);
+}
+
+inline constexpr StringSimdOps kSse42Ops{
+    StringSimdLevel::kSse42, Sse42Find, Sse42FindFirstOf, Sse42ToLower, Sse42ToUpper, Sse42IEqual};
+
+// ---------------------------------------------------------------------------
+// AVX2: 32字节一组
+// ---------------------------------------------------------------------------
+
+AIMRT_SIMD_TARGET_AVX2 inline size_t Avx2Find(const char* hay, size_t n, const char* needle, size_t m) {
+  if (m <= 1 || m > n) return Sse42Find(hay, n, needle, m);
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+  size_t i = 0;
+  for (; i + m - 1 + 32 <= n; i += 32) {
+    const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + i));
+    const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hay + i + m - 1));
+    uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+    while (mask != 0) {
+      const size_t bit = static_cast<size_t>(__builtin_ctz(mask));
+      if (memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0) return i + bit;
+      mask &= mask - 1;
+    }
+  }
+  const size_t rest = Sse42Find(hay + i, n - i, needle, m);
+  return rest == n - i ? n : i + rest;
+}
+
+AIMRT_SIMD_TARGET_AVX2 inline void Avx2ShiftCase(char* dst, const char* src, size_t n, char lo, char hi,
+                                                 char delta) {
+  const __m256i below = _mm256_set1_epi8(static_cast<char>(lo - 1));
+  const __m256i above = _mm256_set1_epi8(static_cast<char>(hi + 1));
+  const __m256i diff = _mm256_set1_epi8(delta);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(v, below), _mm256_cmpgt_epi8(above, v));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_add_epi8(v, _mm256_and_si256(in_range, diff)));
+  }
+  Sse42ShiftCase(dst + i, src + i, n - i, lo, hi, delta);
+}
+
+AIMRT_SIMD_TARGET_AVX2 inline void Avx2ToLower(char* dst, const char* src, size_t n) {
+  Avx2ShiftCase(dst, src, n, 'A', 'Z', 0x20);
+}
+
+AIMRT_SIMD_TARGET_AVX2 inline void Avx2ToUpper(char* dst, const char* src, size_t n) {
+  Avx2ShiftCase(dst, src, n, 'a', 'z', -0x20);
+}
+
+AIMRT_SIMD_TARGET_AVX2 inline __m256i Avx2Lower(__m256i v) {
+  const __m256i in_range = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                            _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+  return _mm256_add_epi8(v, _mm256_and_si256(in_range, _mm256_set1_epi8(0x20)));
+}
+
+AIMRT_SIMD_TARGET_AVX2 inline bool Avx2IEqual(const char* a, const char* b, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(Avx2Lower(va), Avx2Lower(vb)))) != 0xFFFFFFFFu) {
+      return false;
+    }
+  }
+  return Sse42IEqual(a + i, b + i, n - i);
+}
+
+// AVX2没有更宽的pcmpestri,字符集查找沿用SSE4.2实现
+inline constexpr StringSimdOps kAvx2Ops{
+    StringSimdLevel::kAvx2, Avx2Find, Sse42FindFirstOf, Avx2ToLower, Avx2ToUpper, Avx2IEqual};
+
+#undef AIMRT_SIMD_TARGET_SSE42
+#undef AIMRT_SIMD_TARGET_AVX2
+
+#elif defined(AIMRT_STRING_SIMD_NEON)
+
+// ---------------------------------------------------------------------------
+// NEON: 16字节一组
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief 把逐字节比较结果压缩为64位掩码,每个字节对应4位
+ */
+inline uint64_t NeonMask(uint8x16_t cmp) {
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4)), 0);
+}
+
+inline size_t NeonFind(const char* hay, size_t n, const char* needle, size_t m) {
+  if (m == 0) return 0;
+  if (m > n) return n;
+  if (m == 1) {
+    const void* p = memchr(hay, needle[0], n);
+    return p ? static_cast<const char*>(p) - hay : n;
+  }
+  const uint8x16_t first = vdupq_n_u8(static_cast<uint8_t>(needle[0]));
+  const uint8x16_t last = vdupq_n_u8(static_cast<uint8_t>(needle[m - 1]));
+  size_t i = 0;
+  for (; i + m - 1 + 16 <= n; i += 16) {
+    const uint8x16_t block_first = vld1q_u8(reinterpret_cast<const uint8_t*>(hay + i));
+    const uint8x16_t block_last = vld1q_u8(reinterpret_cast<const uint8_t*>(hay + i + m - 1));
+    uint64_t mask = NeonMask(vandq_u8(vceqq_u8(first, block_first), vceqq_u8(last, block_last))) &
+                    0x8888888888888888ULL;
+    while (mask != 0) {
+      const size_t bit = static_cast<size_t>(__builtin_ctzll(mask)) >> 2;
+      if (memcmp(hay + i + bit + 1, needle + 1, m - 2) == 0) return i + bit;
+      mask &= mask - 1;
+    }
+  }
+  const size_t rest = ScalarFind(hay + i, n - i, needle, m);
+  return rest == n - i ? n : i + rest;
+}
+
+inline size_t NeonFindFirstOf(const char* s, size_t n, const char* set, size_t k) {
+  if (k == 0 || k > 16) return ScalarFindFirstOf(s, n, set, k);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(s + i));
+    uint8x16_t hit = vdupq_n_u8(0);
+    for (size_t j = 0; j < k; ++j) {
+      hit = vorrq_u8(hit, vceqq_u8(chunk, vdupq_n_u8(static_cast<uint8_t>(set[j]))));
+    }
+    const uint64_t mask = NeonMask(hit);
+    if (mask != 0) return i + (static_cast<size_t>(__builtin_ctzll(mask)) >> 2);
+  }
+  const size_t rest = ScalarFindFirstOf(s + i, n - i, set, k);
+  return rest == n - i ? n : i + rest;
+}
+
+inline uint8x16_t NeonShiftCase(uint8x16_t v, uint8_t lo, uint8_t hi, uint8_t delta) {
+  const uint8x16_t in_range = vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)));
+  return vaddq_u8(v, vandq_u8(in_range, vdupq_n_u8(delta)));
+}
+
+inline void NeonToLower(char* dst, const char* src, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), NeonShiftCase(v, 'A', 'Z', 0x20));
+  }
+  ScalarToLower(dst + i, src + i, n - i);
+}
+
+inline void NeonToUpper(char* dst, const char* src, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), NeonShiftCase(v, 'a', 'z', static_cast<uint8_t>(-0x20)));
+  }
+  ScalarToUpper(dst + i, src + i, n - i);
+}
+
+inline bool NeonIEqual(const char* a, const char* b, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const uint8x16_t va = NeonShiftCase(vld1q_u8(reinterpret_cast<const uint8_t*>(a + i)), 'A', 'Z', 0x20);
+    const uint8x16_t vb = NeonShiftCase(vld1q_u8(reinterpret_cast<const uint8_t*>(b + i)), 'A', 'Z', 0x20);
+    if (vminvq_u8(vceqq_u8(va, vb)) != 0xFF) return false;
+  }
+  return ScalarIEqual(a + i, b + i, n - i);
+}
+
+inline constexpr StringSimdOps kNeonOps{
+    StringSimdLevel::kNeon, NeonFind, NeonFindFirstOf, NeonToLower, NeonToUpper, NeonIEqual};
+
+#endif
+
+/**
+ * @brief 根据CPU支持的指令集取对应的实现,不支持时返回nullptr
+ */
+inline const StringSimdOps* OpsForLevel(StringSimdLevel level) {
+  switch (level) {
+    case StringSimdLevel::kScalar:
+      return &kScalarOps;
+#if defined(AIMRT_STRING_SIMD_X86)
+    case StringSimdLevel::kSse42:
+      return __builtin_cpu_supports("sse4.2") ? &kSse42Ops : nullptr;
+    case StringSimdLevel::kAvx2:
+      return __builtin_cpu_supports("avx2") ? &kAvx2Ops : nullptr;
+#elif defined(AIMRT_STRING_SIMD_NEON)
+    case StringSimdLevel::kNeon:
+      return &kNeonOps;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+inline const StringSimdOps* DetectBestOps() {
+  for (StringSimdLevel level : {StringSimdLevel::kAvx2, StringSimdLevel::kNeon, StringSimdLevel::kSse42}) {
+    if (const StringSimdOps* ops = OpsForLevel(level)) return ops;
+  }
+  return &kScalarOps;
+}
+
+inline std::atomic<const StringSimdOps*>& ActiveOps() {
+  static std::atomic<const StringSimdOps*> ops{DetectBestOps()};
+  return ops;
+}
+
+inline const StringSimdOps& Ops() { return *ActiveOps().load(std::memory_order_relaxed); }
+
+}  // namespace string_simd_detail
+
+/**
+ * @brief 当前使用的指令集级别
+ */
+inline StringSimdLevel GetStringSimdLevel() { return string_simd_detail::Ops().level; }
+
+/**
+ * @brief 指定使用的指令集级别,用于测试和对比
+ *
+ * @return true 切换成功
+ * @return false CPU或平台不支持该级别,保持原级别
+ */
+inline bool SetStringSimdLevel(StringSimdLevel level) {
+  const auto* ops = string_simd_detail::OpsForLevel(level);
+  if (ops == nullptr) return false;
+  string_simd_detail::ActiveOps().store(ops, std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * @brief 查找子串
+ *
+ * @param str 被查找的字符串
+ * @param pattern 子串
+ * @param pos 起始位置
+ * @return size_t 首次出现的位置,未找到返回std::string_view::npos
+ */
+inline size_t SimdFind(std::string_view str, std::string_view pattern, size_t pos = 0) {
+  if (pos > str.size()) return std::string_view::npos;
+  const size_t n = str.size() - pos;
+  const size_t idx = string_simd_detail::Ops().find(str.data() + pos, n, pattern.data(), pattern.size());
+  if (pattern.empty()) return pos;
+  return idx == n ? std::string_view::npos : pos + idx;
+}
+
+/**
+ * @brief 查找字符集中任一字符首次出现的位置,语义同std::string_view::find_first_of
+ */
+inline size_t SimdFindFirstOf(std::string_view str, std::string_view chars, size_t pos = 0) {
+  if (pos >= str.size() || chars.empty()) return std::string_view::npos;
+  const size_t n = str.size() - pos;
+  const size_t idx = string_simd_detail::Ops().find_first_of(str.data() + pos, n, chars.data(), chars.size());
+  return idx == n ? std::string_view::npos : pos + idx;
+}
+
+/**
+ * @brief ASCII转小写,dst与src可以相同,长度为n
+ */
+inline void AsciiToLower(char* dst, const char* src, size_t n) { string_simd_detail::Ops().to_lower(dst, src, n); }
+
+/**
+ * @brief ASCII转大写,dst与src可以相同,长度为n
+ */
+inline void AsciiToUpper(char* dst, const char* src, size_t n) { string_simd_detail::Ops().to_upper(dst, src, n); }
+
+/**
+ * @brief 忽略ASCII大小写比较两个字符串是否相等
+ */
+inline bool AsciiIEqual(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  if (a.data() == b.data()) return true;
+  return string_simd_detail::Ops().iequal(a.data(), b.data(), a.size());
+}
+
+/**
+ * @brief 不分配内存的字符串分割器
+ *
+ * 逐项产出string_view,指向原字符串,原字符串必须在遍历期间保持有效。
+ * 分割语义与SplitToVec一致: 源字符串或分隔符为空时没有任何项;可选去除每项两端空格以及跳过空项。
+ *
+ * 示例:
+ * @code
+ *   for (std::string_view item : StringSplitter("a, b,,c", ",")) {
+ *     // "a", "b", "c"
+ *   }
+ * @endcode
+ */
+class StringSplitter {
+ public:
+  StringSplitter(std::string_view source, std::string_view sep, bool trim = true, bool skip_empty = true)
+      : source_(source), sep_(sep), trim_(trim), skip_empty_(skip_empty) {}
+
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    Iterator() = default;
+
+    reference operator*() const { return current_; }
+    pointer operator->() const { return &current_; }
+
+    Iterator& operator++() {
+      Advance();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      Advance();
+      return tmp;
+    }
+
+    bool operator==(const Iterator& rhs) const { return done_ == rhs.done_ && (done_ || pos_ == rhs.pos_); }
+    bool operator!=(const Iterator& rhs) const { return !(*this == rhs); }
+
+   private:
+    friend class StringSplitter;
+
+    explicit Iterator(const StringSplitter* owner) : owner_(owner), done_(false) {
+      if (owner_->source_.empty() || owner_->sep_.empty()) {
+        done_ = true;
+        return;
+      }
+      Advance();
+    }
+
+    void Advance() {
+      const std::string_view source = owner_->source_;
+      const std::string_view sep = owner_->sep_;
+      while (!finished_) {
+        size_t end = sep.size() == 1 ? source.find(sep[0], pos_) : SimdFind(source, sep, pos_);
+        if (end == std::string_view::npos) end = source.size();
+
+        std::string_view item = source.substr(pos_, end - pos_);
+        pos_ = end + sep.size();
+        if (end >= source.size()) finished_ = true;
+
+        if (owner_->trim_) {
+          const size_t first = item.find_first_not_of(' ');
+          item = first == std::string_view::npos ? std::string_view() : item.substr(first, item.find_last_not_of(' ') - first + 1);
+        }
+        if (!(owner_->skip_empty_ && item.empty())) {
+          current_ = item;
+          return;
+        }
+      }
+      done_ = true;
+    }
+
+    const StringSplitter* owner_ = nullptr;
+    std::string_view current_;
+    size_t pos_ = 0;
+    bool finished_ = false;
+    bool done_ = true;
+  };
+
+  Iterator begin() const { return Iterator(this); }
+  Iterator end() const { return Iterator(); }
+
+ private:
+  std::string_view source_;
+  std::string_view sep_;
+  bool trim_;
+  bool skip_empty_;
+};
+
+namespace string_simd_detail {
+
+inline void WyMum(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(*a) * *b;
+  *a = static_cast<uint64_t>(r);
+  *b = static_cast<uint64_t>(r >> 64);
+#else
+  const uint64_t ha = *a >> 32, hb = *b >> 32, la = static_cast<uint32_t>(*a), lb = static_cast<uint32_t>(*b);
+  const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  const uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  const uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+  *a = lo;
+  *b = hi;
+#endif
+}
+
+inline uint64_t WyMix(uint64_t a, uint64_t b) {
+  WyMum(&a, &b);
+  return a ^ b;
+}
+
+inline uint64_t WyRead8(const uint8_t* p) {
+  uint64_t v;
+  memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint64_t WyRead4(const uint8_t* p) {
+  uint32_t v;
+  memcpy(&v, p, 4);
+  return v;
+}
+
+inline uint64_t WyRead3(const uint8_t* p, size_t k) {
+  return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+inline constexpr uint64_t kWySecret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+}  // namespace string_simd_detail
+
+/**
+ * @brief wyhash(final4)非加密哈希,64位
+ *
+ * 每次处理48字节,短字符串只需一两次64位乘法,适合路由表等以字符串为键的哈希表。
+ * 结果依赖字节序,不要持久化或跨平台比较。
+ *
+ * @param data 数据
+ * @param len 长度
+ * @param seed 种子
+ * @return uint64_t hash值
+ */
+inline uint64_t Hash64Wy(const char* data, size_t len, uint64_t seed = 0) {
+  using namespace string_simd_detail;
+  const auto* p = reinterpret_cast<const uint8_t*>(data);
+  seed ^= WyMix(seed ^ kWySecret[0], kWySecret[1]);
+  uint64_t a, b;
+  if (omnirt_likely(len <= 16)) {
+    if (omnirt_likely(len >= 4)) {
+      a = (WyRead4(p) << 32) | WyRead4(p + ((len >> 3) << 2));
+      b = (WyRead4(p + len - 4) << 32) | WyRead4(p + len - 4 - ((len >> 3) << 2));
+    } else if (omnirt_likely(len > 0)) {
+      a = WyRead3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (omnirt_unlikely(i > 48)) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = WyMix(WyRead8(p) ^ kWySecret[1], WyRead8(p + 8) ^ seed);
+        see1 = WyMix(WyRead8(p + 16) ^ kWySecret[2], WyRead8(p + 24) ^ see1);
+        see2 = WyMix(WyRead8(p + 32) ^ kWySecret[3], WyRead8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (omnirt_likely(i > 48));
+      seed ^= see1 ^ see2;
+    }
+    while (omnirt_unlikely(i > 16)) {
+      seed = WyMix(WyRead8(p) ^ kWySecret[1], WyRead8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = WyRead8(p + i - 16);
+    b = WyRead8(p + i - 8);
+  }
+  a ^= kWySecret[1];
+  b ^= seed;
+  WyMum(&a, &b);
+  return WyMix(a ^ kWySecret[0] ^ len, b ^ kWySecret[1]);
+}
+
+inline uint64_t Hash64Wy(std::string_view str, uint64_t seed = 0) { return Hash64Wy(str.data(), str.size(), seed); }
+
+}  // namespace aimrt::common::util
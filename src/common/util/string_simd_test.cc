@@ -0,0 +1,272 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cctype>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "util/string_simd.h"
+#include "util/string_util.h"
+
+namespace aimrt::common::util {
+
+namespace {
+
+// 原有的逐字节实现,作为各指令集版本的对照
+std::vector<std::string_view> RefSplit(std::string_view source, std::string_view sep, bool trim, bool clear) {
+  std::vector<std::string_view> result;
+  if (source.empty() || sep.empty()) return result;
+
+  size_t pos_end = 0, pos_start = 0;
+  do {
+    pos_end = source.find(sep, pos_start);
+    if (pos_end == std::string_view::npos) pos_end = source.length();
+
+    auto sub_str = source.substr(pos_start, pos_end - pos_start);
+    if (trim) Trim(sub_str);
+    if (!(clear && sub_str.empty())) result.emplace_back(sub_str);
+
+    pos_start = pos_end + sep.size();
+  } while (pos_end < source.length());
+
+  return result;
+}
+
+bool RefIEqual(std::string_view a, std::string_view b) {
+  if (a.size() != b.size()) return false;
+  return std::equal(a.begin(), a.end(), b.begin(),
+                    [](char x, char y) { return std::tolower(x) == std::tolower(y); });
+}
+
+std::vector<StringSimdLevel> SupportedLevels() {
+  std::vector<StringSimdLevel> levels;
+  const StringSimdLevel origin = GetStringSimdLevel();
+  for (auto level : {StringSimdLevel::kScalar, StringSimdLevel::kSse42, StringSimdLevel::kAvx2, StringSimdLevel::kNeon}) {
+    if (SetStringSimdLevel(level)) levels.emplace_back(level);
+  }
+  SetStringSimdLevel(origin);
+  return levels;
+}
+
+/**
+ * @brief 依次切换到每个可用的指令集级别执行f,结束后恢复
+ */
+template <class F>
+void ForEachLevel(F&& f) {
+  const StringSimdLevel origin = GetStringSimdLevel();
+  for (auto level : SupportedLevels()) {
+    ASSERT_TRUE(SetStringSimdLevel(level));
+    SCOPED_TRACE(static_cast<uint32_t>(level));
+    f();
+  }
+  SetStringSimdLevel(origin);
+}
+
+// 小字母表使随机串中出现大量部分匹配
+std::string RandomString(std::mt19937& rng, size_t len, std::string_view alphabet) {
+  std::string s(len, '\0');
+  for (auto& c : s) c = alphabet[rng() % alphabet.size()];
+  return s;
+}
+
+}  // namespace
+
+TEST(STRING_SIMD_TEST, Find) {
+  ForEachLevel([] {
+    std::mt19937 rng(1);
+    // 在更大的缓冲区里取子串,覆盖各种起始对齐
+    for (int round = 0; round < 20000; ++round) {
+      const std::string buf = RandomString(rng, 1 + rng() % 160, std::string_view("ab\0c", 4));
+      const size_t offset = rng() % buf.size();
+      const std::string_view hay = std::string_view(buf).substr(offset);
+      const std::string needle = RandomString(rng, rng() % 8, std::string_view("ab\0c", 4));
+      const size_t pos = rng() % (hay.size() + 2);
+      ASSERT_EQ(SimdFind(hay, needle, pos), hay.find(needle, pos))
+          << "hay=" << hay << " needle=" << needle << " pos=" << pos;
+    }
+
+    // 匹配位于末尾以及跨越向量块边界
+    for (size_t len = 1; len < 100; ++len) {
+      for (size_t m = 1; m <= len && m < 40; ++m) {
+        std::string hay(len, 'x');
+        std::string needle(m, 'y');
+        hay.replace(len - m, m, needle);
+        ASSERT_EQ(SimdFind(hay, needle), len - m);
+        ASSERT_EQ(SimdFind(hay.substr(0, len - 1), needle), std::string_view::npos);
+      }
+    }
+  });
+}
+
+TEST(STRING_SIMD_TEST, FindFirstOf) {
+  ForEachLevel([] {
+    std::mt19937 rng(2);
+    for (int round = 0; round < 20000; ++round) {
+      const std::string buf = RandomString(rng, rng() % 100, "abcdefghij\x80\xff");
+      const std::string chars = RandomString(rng, rng() % 20, "cdefghijklmnop\xff");
+      const size_t pos = rng() % (buf.size() + 2);
+      ASSERT_EQ(SimdFindFirstOf(buf, chars, pos), std::string_view(buf).find_first_of(chars, pos));
+    }
+  });
+}
+
+TEST(STRING_SIMD_TEST, CaseConversion) {
+  ForEachLevel([] {
+    std::string all;
+    for (int c = 0; c < 256; ++c) all.push_back(static_cast<char>(c));
+
+    // 所有字节值在各种长度和偏移下都与C locale的tolower/toupper一致
+    for (size_t offset = 0; offset < 64; ++offset) {
+      const std::string_view src = std::string_view(all).substr(offset);
+      std::string lower = StrToLower(src);
+      std::string upper = StrToUpper(src);
+      for (size_t i = 0; i < src.size(); ++i) {
+        ASSERT_EQ(lower[i], static_cast<char>(std::tolower(static_cast<unsigned char>(src[i]))));
+        ASSERT_EQ(upper[i], static_cast<char>(std::toupper(static_cast<unsigned char>(src[i]))));
+      }
+    }
+
+    std::mt19937 rng(3);
+    for (int round = 0; round < 5000; ++round) {
+      std::string s = RandomString(rng, rng() % 80, "aZ09_-@[`{");
+      std::string want = s;
+      for (auto& c : want) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      ASSERT_EQ(StrToLower(s), want);
+    }
+  });
+}
+
+TEST(STRING_SIMD_TEST, IEqual) {
+  ForEachLevel([] {
+    for (int a = 0; a < 256; ++a) {
+      for (int b = 0; b < 256; ++b) {
+        const char ca = static_cast<char>(a), cb = static_cast<char>(b);
+        std::string sa(40, 'k'), sb(40, 'K');
+        sa[37] = ca;
+        sb[37] = cb;
+        ASSERT_EQ(CheckIEqual(sa, sb), RefIEqual(sa, sb)) << a << " " << b;
+      }
+    }
+
+    std::mt19937 rng(4);
+    for (int round = 0; round < 20000; ++round) {
+      const std::string a = RandomString(rng, rng() % 70, "aAbB");
+      std::string b = a;
+      if (!b.empty() && rng() % 2) b[rng() % b.size()] = "aAbBc"[rng() % 5];
+      ASSERT_EQ(CheckIEqual(a, b), RefIEqual(a, b));
+      ASSERT_EQ(StartsWith(a, b.substr(0, b.size() / 2), true), a.size() >= 2 && RefIEqual(a.substr(0, b.size() / 2), b.substr(0, b.size() / 2)));
+      ASSERT_EQ(EndsWith(a, b.substr(b.size() / 2), true), !b.substr(b.size() / 2).empty() && RefIEqual(a.substr(b.size() / 2), b.substr(b.size() / 2)));
+    }
+  });
+}
+
+TEST(STRING_SIMD_TEST, Splitter) {
+  ForEachLevel([] {
+    std::mt19937 rng(5);
+    for (int round = 0; round < 20000; ++round) {
+      const std::string source = RandomString(rng, rng() % 60, "ab ,;");
+      const std::string sep = RandomString(rng, rng() % 3, ",; ");
+      const bool trim = rng() % 2;
+      const bool clear = rng() % 2;
+
+      const auto want = RefSplit(source, sep, trim, clear);
+
+      std::vector<std::string_view> got;
+      for (std::string_view item : StringSplitter(source, sep, trim, clear)) got.emplace_back(item);
+      ASSERT_EQ(got, want) << "source=" << source << " sep=" << sep;
+
+      const auto vec = SplitToVec<std::string>(source, sep, trim, clear);
+      ASSERT_EQ(std::vector<std::string>(want.begin(), want.end()), vec);
+    }
+  });
+
+  // 迭代器产出的是原字符串上的视图
+  const std::string_view source = "a, b,,c ";
+  std::vector<std::string_view> items(StringSplitter(source, ",").begin(), StringSplitter(source, ",").end());
+  ASSERT_EQ(items, (std::vector<std::string_view>{"a", "b", "c"}));
+  EXPECT_EQ(items[0].data(), source.data());
+}
+
+TEST(STRING_SIMD_TEST, Hash64Wy) {
+  const std::string_view key = "/aimrt/example/normal_publisher/topic";
+  EXPECT_EQ(Hash64Wy(key), Hash64Wy(std::string(key)));
+  EXPECT_NE(Hash64Wy(key), Hash64Wy(key, 1));
+
+  // 覆盖0~3、4~16、17~48以及超过48字节的各个分支: 任意前缀以及任意单比特翻转都应得到不同的值
+  std::string data(130, '\0');
+  for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<char>(i * 37 + 11);
+  std::set<uint64_t> hashes;
+  for (size_t len = 0; len <= data.size(); ++len) {
+    ASSERT_TRUE(hashes.emplace(Hash64Wy(data.data(), len)).second) << len;
+    for (size_t bit = 0; bit < len * 8; bit += 7) {
+      std::string flipped = data.substr(0, len);
+      flipped[bit / 8] = static_cast<char>(flipped[bit / 8] ^ (1 << (bit % 8)));
+      ASSERT_TRUE(hashes.emplace(Hash64Wy(flipped)).second) << len << " " << bit;
+    }
+  }
+
+  // 与地址对齐无关
+  std::string buf(200, '\0');
+  for (size_t i = 0; i < buf.size(); ++i) buf[i] = static_cast<char>(i * 131);
+  for (size_t len = 0; len < 100; ++len) {
+    const std::string copy = " " + buf.substr(0, len);
+    ASSERT_EQ(Hash64Wy(buf.data(), len), Hash64Wy(copy.data() + 1, len));
+  }
+
+  EXPECT_EQ(StringHash{}(std::string("topic")), StringHash{}(std::string_view("topic")));
+  EXPECT_EQ(StringHash{}("topic"), StringHash{}(std::string_view("topic")));
+}
+
+TEST(STRING_SIMD_TEST, Benchmark) {
+  using Clock = std::chrono::steady_clock;
+  auto measure = [](auto&& f, int iterations) {
+    const auto begin = Clock::now();
+    uint64_t sink = 0;
+    for (int i = 0; i < iterations; ++i) sink += f(i);
+    const auto end = Clock::now();
+    volatile uint64_t keep = sink;
+    (void)keep;
+    return std::chrono::duration<double, std::nano>(end - begin).count() / iterations;
+  };
+
+  std::string text;
+  for (int i = 0; i < 64; ++i) text += "module.channel.backend.ros2.topic_" + std::to_string(i) + ",";
+  const std::string upper = StrToUpper(std::string_view(text));
+  std::vector<std::string> keys;
+  for (int i = 0; i < 16; ++i) keys.emplace_back("/aimrt/example/normal_publisher/topic_" + std::to_string(i % 10));
+  constexpr int kIterations = 20000;
+
+  std::cout << "text size: " << text.size() << " bytes\n";
+  const StringSimdLevel origin = GetStringSimdLevel();
+  for (auto level : SupportedLevels()) {
+    SetStringSimdLevel(level);
+    const double find_ns = measure([&](int) { return SimdFind(text, "topic_63,"); }, kIterations);
+    const double lower_ns = measure([&](int) { return StrToLower(std::string_view(upper)).size(); }, kIterations);
+    const double iequal_ns = measure([&](int) { return static_cast<uint64_t>(CheckIEqual(text, upper)); }, kIterations);
+    const double split_ns = measure([&](int) { return SplitToVec<std::string_view>(text, ",").size(); }, kIterations);
+    std::cout << "level " << static_cast<uint32_t>(level) << ": find " << find_ns << " ns, to_lower " << lower_ns
+              << " ns, iequal " << iequal_ns << " ns, split " << split_ns << " ns\n";
+  }
+  SetStringSimdLevel(origin);
+
+  const double std_find_ns = measure([&](int) { return std::string_view(text).find("topic_63,"); }, kIterations);
+  const double ref_iequal_ns = measure([&](int) { return static_cast<uint64_t>(RefIEqual(text, upper)); }, kIterations);
+  const double ref_split_ns = measure([&](int) { return RefSplit(text, ",", true, true).size(); }, kIterations);
+  const double std_hash_ns = measure([&](int i) { return std::hash<std::string_view>{}(keys[i & 15]); }, kIterations * 50);
+  const double wy_hash_ns = measure([&](int i) { return Hash64Wy(keys[i & 15]); }, kIterations * 50);
+  const double fnv_hash_ns = measure([&](int i) { return Hash64Fnv1a(keys[i & 15].data(), keys[i & 15].size()); }, kIterations * 50);
+  std::cout << "std::string_view::find:  " << std_find_ns << " ns\n"
+            << "tolower loop iequal:     " << ref_iequal_ns << " ns\n"
+            << "legacy split:            " << ref_split_ns << " ns\n"
+            << "std::hash (39 bytes):    " << std_hash_ns << " ns\n"
+            << "Hash64Wy (39 bytes):     " << wy_hash_ns << " ns\n"
+            << "Hash64Fnv1a (39 bytes):  " << fnv_hash_ns << " ns" << std::endl;
+}
+
+}  // namespace aimrt::common::util
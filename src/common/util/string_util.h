@@ -16,6 +16,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "util/string_simd.h"
+
 namespace aimrt::common::util {
 
 /**
@@ -270,22 +272,9 @@ inline std::vector<StringType> SplitToVec(std::string_view source,
                                           bool trim = true,
                                           bool clear = true) {
   std::vector<StringType> result;
-  if (source.empty() || sep.empty()) return result;
-
-  size_t pos_end = 0, pos_start = 0;
-  do {
-    pos_end = source.find(sep, pos_start);
-    if (pos_end == std::string_view::npos) pos_end = source.length();
-
-    auto sub_str = source.substr(pos_start, pos_end - pos_start);
-
-    if (trim) Trim(sub_str);
-
-    if (!(clear && sub_str.empty())) result.emplace_back(sub_str);
-
-    pos_start = pos_end + sep.size();
-  } while (pos_end < source.length());
-
+  for (std::string_view item : StringSplitter(source, sep, trim, clear)) {
+    result.emplace_back(item);
+  }
   return result;
 }
 
@@ -333,22 +322,9 @@ inline std::set<StringType> SplitToSet(std::string_view source,
                                        bool trim = true,
                                        bool clear = true) {
   std::set<StringType> result;
-  if (source.empty() || sep.empty()) return result;
-
-  size_t pos_end = 0, pos_start = 0;
-  do {
-    pos_end = source.find(sep, pos_start);
-    if (pos_end == std::string_view::npos) pos_end = source.length();
-
-    auto sub_str = source.substr(pos_start, pos_end - pos_start);
-
-    if (trim) Trim(sub_str);
-
-    if (!(clear && sub_str.empty())) result.emplace(sub_str);
-
-    pos_start = pos_end + sep.size();
-  } while (pos_end < source.length());
-
+  for (std::string_view item : StringSplitter(source, sep, trim, clear)) {
+    result.emplace(item);
+  }
   return result;
 }
 
@@ -487,7 +463,7 @@ inline std::string& ReplaceString(std::string& str,
   if (str.empty() || ov.empty()) return str;
   std::vector<size_t> vec_pos;
   size_t pos = 0, old_len = ov.size(), new_len = nv.size();
-  while ((pos = str.find(ov, pos)) != std::string::npos) {
+  while ((pos = SimdFind(str, ov, pos)) != std::string::npos) {
     vec_pos.emplace_back(pos);
     pos += old_len;
   }
@@ -689,7 +665,7 @@ inline char CharToUpper(char c) { return static_cast<char>(toupper(c)); }
  * @return std::string& 小写字符串
  */
 inline std::string& StrToLower(std::string& str) {
-  std::transform(str.begin(), str.end(), str.begin(), CharToLower);
+  AsciiToLower(str.data(), str.data(), str.size());
   return str;
 }
 
@@ -703,7 +679,7 @@ inline std::string StrToLower(std::string_view str) {
   std::string result;
   result.resize(str.size());
 
-  std::transform(str.begin(), str.end(), result.begin(), CharToLower);
+  AsciiToLower(result.data(), str.data(), str.size());
   return result;
 }
 
@@ -714,7 +690,7 @@ inline std::string StrToLower(std::string_view str) {
  * @return std::string& 大写字符串
  */
 inline std::string& StrToUpper(std::string& str) {
-  std::transform(str.begin(), str.end(), str.begin(), CharToUpper);
+  AsciiToUpper(str.data(), str.data(), str.size());
   return str;
 }
 
@@ -728,7 +704,7 @@ inline std::string StrToUpper(std::string_view str) {
   std::string result;
   result.resize(str.size());
 
-  std::transform(str.begin(), str.end(), result.begin(), CharToUpper);
+  AsciiToUpper(result.data(), str.data(), str.size());
   return result;
 }
 
@@ -741,10 +717,7 @@ inline std::string StrToUpper(std::string_view str) {
  * @return false
  */
 inline bool CheckIEqual(std::string_view str1, std::string_view str2) {
-  if (str1.size() != str2.size()) return false;
-
-  return std::equal(str1.begin(), str1.end(), str2.begin(),
-                    [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+  return AsciiIEqual(str1, str2);
 }
 
 /**
@@ -793,12 +766,7 @@ inline bool StartsWith(std::string_view str,
   const size_t pattern_len = pattern.length();
   if (str_len < pattern_len || pattern_len == 0) return false;
 
-  if (ignore_case) {
-    for (size_t i = 0; i < pattern_len; ++i) {
-      if (tolower(pattern[i]) != tolower(str[i])) return false;
-    }
-    return true;
-  }
+  if (ignore_case) return AsciiIEqual(str.substr(0, pattern_len), pattern);
   for (size_t i = 0; i < pattern_len; ++i) {
     if (pattern[i] != str[i]) return false;
   }
@@ -822,12 +790,7 @@ inline bool EndsWith(std::string_view str,
   if (str_len < pattern_len || pattern_len == 0) return false;
 
   const size_t& begin_pos = str_len - pattern_len;
-  if (ignore_case) {
-    for (size_t i = 0; i < pattern_len; ++i) {
-      if (tolower(pattern[i]) != tolower(str[begin_pos + i])) return false;
-    }
-    return true;
-  }
+  if (ignore_case) return AsciiIEqual(str.substr(begin_pos), pattern);
   for (size_t i = 0; i < pattern_len; i++) {
     if (pattern[i] != str[begin_pos + i]) return false;
   }
@@ -873,17 +836,19 @@ inline std::string SSToString(const T& obj) {
   return ss.str();
 }
 
+/**
+ * @brief 字符串透明哈希,使用wyhash,短键只需一两次乘法
+ */
 struct StringHash {
   using is_transparent = void;
-  using hash_type = std::hash<std::string_view>;
   std::size_t operator()(const std::string& str) const noexcept {
-    return hash_type{}(std::string_view(str.data(), str.size()));
+    return static_cast<std::size_t>(Hash64Wy(str.data(), str.size()));
   }
   std::size_t operator()(const char* str) const noexcept {
-    return hash_type{}(std::string_view(str));
+    return static_cast<std::size_t>(Hash64Wy(std::string_view(str)));
   }
   std::size_t operator()(std::string_view str) const noexcept {
-    return hash_type{}(str);
+    return static_cast<std::size_t>(Hash64Wy(str));
   }
 };
 
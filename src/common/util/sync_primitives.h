@@ -0,0 +1,594 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+//
+// 基于futex的同步原语
+// 提供事件、计数信号量、闩锁、屏障和事件计数,用于替代基于互斥锁+条件变量的实现。
+//
+// 主要特性:
+// 1. 无竞争时不进入内核
+//    - 状态和等待者数量保存在原子变量中,只有确实存在等待者时通知方才执行futex唤醒
+//    - 等待方先短暂自旋,再通过futex休眠
+// 2. 正确处理虚假唤醒
+//    - 所有等待操作都在循环中重新检查条件
+// 3. 进程间共享
+//    - 每种原语都有进程间共享版本(ShmEvent、ShmSemaphore等),只包含无锁原子变量,
+//      可直接放置(placement new)在共享内存中,使用非PRIVATE的futex操作
+//
+// 原语列表:
+// - Event:      自动/手动复位事件
+// - Semaphore:  计数信号量
+// - Latch:      一次性倒计数闩锁
+// - Barrier:    可重复使用的屏障
+// - EventCount: 事件计数,为任意无锁数据结构提供"检查条件-休眠"而不丢失唤醒
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <type_traits>
+
+#include "futex_atomic.h"
+#include "macros.h"
+
+namespace aimrt::common::util {
+
+namespace sync_detail {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "futex要求32位无锁原子变量");
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kSpinCount = 128;
+
+/**
+ * @brief futex操作,kShared为true时使用进程间共享的futex
+ */
+template <bool kShared>
+struct FutexOps {
+  static constexpr int kWaitOp = kShared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+  static constexpr int kWakeOp = kShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+
+  /**
+   * @brief 当*word == expected时休眠,可能虚假返回
+   *
+   * @param deadline 截止时间,nullptr表示不限时
+   * @return false 已到截止时间
+   */
+  static bool Wait(std::atomic<uint32_t>* word, uint32_t expected, const Clock::time_point* deadline) {
+    if (deadline == nullptr) {
+      futex(reinterpret_cast<uint32_t*>(word), kWaitOp, expected);
+      return true;
+    }
+    const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - Clock::now());
+    if (remaining.count() <= 0) {
+      return false;
+    }
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(remaining.count() / 1000000000);
+    ts.tv_nsec = static_cast<long>(remaining.count() % 1000000000);
+    futex(reinterpret_cast<uint32_t*>(word), kWaitOp, expected, &ts);
+    return true;
+  }
+
+  static void Wake(std::atomic<uint32_t>* word, uint32_t count) {
+    futex(reinterpret_cast<uint32_t*>(word), kWakeOp, count > INT_MAX ? INT_MAX : count);
+  }
+};
+
+/**
+ * @brief 自旋等待pred成立,最多kSpinCount次
+ */
+template <typename Pred>
+inline bool SpinFor(Pred&& pred) {
+  for (int i = 0; i < kSpinCount; ++i) {
+    if (pred()) {
+      return true;
+    }
+    cpu_relax();
+  }
+  return false;
+}
+
+inline Clock::time_point DeadlineAfter(std::chrono::nanoseconds timeout) {
+  return timeout.count() <= 0 ? Clock::now() : Clock::now() + timeout;
+}
+
+}  // namespace sync_detail
+
+/**
+ * @brief 事件复位方式
+ */
+enum class EventResetMode : uint32_t {
+  kAuto,    ///< 自动复位: 每次Set只放行一个等待者,被放行的等待者消费该信号
+  kManual,  ///< 手动复位: Set后所有等待者都被放行,直到调用Reset
+};
+
+/**
+ * @brief 事件
+ *
+ * 状态字的最低位表示是否已触发,其余位为等待者数量,
+ * Set/Wait通过一次CAS同时读取两者,无等待者时Set不执行系统调用。
+ *
+ * 示例用法:
+ * @code
+ *   Event ready(EventResetMode::kManual);
+ *
+ *   // 线程1
+ *   ready.Wait();
+ *
+ *   // 线程2
+ *   ready.Set();
+ * @endcode
+ *
+ * @tparam kShared 是否进程间共享
+ */
+template <bool kShared>
+class BasicEvent {
+  using Ops = sync_detail::FutexOps<kShared>;
+
+ public:
+  explicit BasicEvent(EventResetMode mode = EventResetMode::kManual, bool initially_set = false) noexcept
+      : mode_(mode), state_(initially_set ? kSignaled : 0) {}
+
+  BasicEvent(const BasicEvent&) = delete;
+  BasicEvent& operator=(const BasicEvent&) = delete;
+
+  /**
+   * @brief 触发事件
+   *
+   * 已触发时不做任何事。存在等待者时,自动复位事件唤醒一个,手动复位事件唤醒全部。
+   */
+  void Set() noexcept {
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    do {
+      if (state & kSignaled) {
+        return;
+      }
+    } while (!state_.compare_exchange_weak(state, state | kSignaled, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed));
+    if ((state >> kWaiterShift) != 0) {
+      Ops::Wake(&state_, mode_ == EventResetMode::kAuto ? 1 : UINT32_MAX);
+    }
+  }
+
+  /**
+   * @brief 将事件复位为未触发
+   */
+  void Reset() noexcept { state_.fetch_and(~kSignaled, std::memory_order_relaxed); }
+
+  /**
+   * @brief 事件是否处于触发状态
+   */
+  bool IsSet() const noexcept { return (state_.load(std::memory_order_acquire) & kSignaled) != 0; }
+
+  /**
+   * @brief 不阻塞地等待事件
+   *
+   * @return true 事件已触发(自动复位事件同时被消费)
+   */
+  bool TryWait() noexcept {
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (state & kSignaled) {
+      if (TryConsume(state)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief 等待事件触发
+   */
+  void Wait() noexcept { WaitUntil(nullptr); }
+
+  /**
+   * @brief 带超时的等待
+   *
+   * @return true 事件已触发
+   * @return false 等待超时
+   */
+  bool WaitFor(std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    return WaitUntil(&deadline);
+  }
+
+ private:
+  static constexpr uint32_t kSignaled = 1;
+  static constexpr uint32_t kWaiterShift = 1;
+  static constexpr uint32_t kWaiterOne = 1U << kWaiterShift;
+
+  /**
+   * @brief 消费处于触发状态的信号,失败时state更新为最新值
+   */
+  bool TryConsume(uint32_t& state) noexcept {
+    if (mode_ == EventResetMode::kManual) {
+      return true;
+    }
+    return state_.compare_exchange_weak(state, state & ~kSignaled, std::memory_order_acquire,
+                                        std::memory_order_acquire);
+  }
+
+  bool WaitUntil(const sync_detail::Clock::time_point* deadline) noexcept {
+    if (sync_detail::SpinFor([this] { return TryWait(); })) {
+      return true;
+    }
+
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (true) {
+      if (state & kSignaled) {
+        if (TryConsume(state)) {
+          return true;
+        }
+        continue;
+      }
+
+      // 登记为等待者,之后的Set必然看到等待者数量并执行唤醒
+      if (!state_.compare_exchange_weak(state, state + kWaiterOne, std::memory_order_acquire,
+                                        std::memory_order_acquire)) {
+        continue;
+      }
+      const bool in_time = Ops::Wait(&state_, state + kWaiterOne, deadline);
+      state = state_.fetch_sub(kWaiterOne, std::memory_order_acquire) - kWaiterOne;
+      if (!in_time && !(state & kSignaled)) {
+        return false;
+      }
+    }
+  }
+
+  const EventResetMode mode_;
+  std::atomic<uint32_t> state_;
+};
+
+/**
+ * @brief 计数信号量
+ *
+ * 计数和等待者数量分开存放,计数大于0时Acquire只需一次CAS,
+ * 没有等待者时Release只需一次原子加。
+ *
+ * @tparam kShared 是否进程间共享
+ */
+template <bool kShared>
+class BasicSemaphore {
+  using Ops = sync_detail::FutexOps<kShared>;
+
+ public:
+  explicit BasicSemaphore(uint32_t initial = 0) noexcept : count_(initial), waiters_(0) {}
+
+  BasicSemaphore(const BasicSemaphore&) = delete;
+  BasicSemaphore& operator=(const BasicSemaphore&) = delete;
+
+  /**
+   * @brief 释放n个计数,并唤醒至多n个等待者
+   */
+  void Release(uint32_t n = 1) noexcept {
+    count_.fetch_add(n, std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) != 0) {
+      Ops::Wake(&count_, n);
+    }
+  }
+
+  /**
+   * @brief 不阻塞地获取一个计数
+   *
+   * @return true 获取成功
+   */
+  bool TryAcquire() noexcept {
+    uint32_t count = count_.load(std::memory_order_relaxed);
+    while (count != 0) {
+      if (count_.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief 获取一个计数,计数为0时阻塞
+   */
+  void Acquire() noexcept { AcquireUntil(nullptr); }
+
+  /**
+   * @brief 带超时的获取
+   *
+   * @return true 获取成功
+   * @return false 等待超时
+   */
+  bool AcquireFor(std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    return AcquireUntil(&deadline);
+  }
+
+  /**
+   * @brief 当前计数
+   */
+  uint32_t Value() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  bool AcquireUntil(const sync_detail::Clock::time_point* deadline) noexcept {
+    if (sync_detail::SpinFor([this] { return TryAcquire(); })) {
+      return true;
+    }
+
+    while (true) {
+      if (TryAcquire()) {
+        return true;
+      }
+      waiters_.fetch_add(1, std::memory_order_seq_cst);
+      bool in_time = true;
+      if (count_.load(std::memory_order_seq_cst) == 0) {
+        in_time = Ops::Wait(&count_, 0, deadline);
+      }
+      waiters_.fetch_sub(1, std::memory_order_relaxed);
+      if (!in_time) {
+        return TryAcquire();
+      }
+    }
+  }
+
+  std::atomic<uint32_t> count_;
+  std::atomic<uint32_t> waiters_;
+};
+
+/**
+ * @brief 一次性倒计数闩锁
+ *
+ * 计数减到0后所有等待者被放行,之后的Wait立即返回。
+ *
+ * @tparam kShared 是否进程间共享
+ */
+template <bool kShared>
+class BasicLatch {
+  using Ops = sync_detail::FutexOps<kShared>;
+
+ public:
+  explicit BasicLatch(uint32_t count) noexcept : count_(count), waiters_(0) {}
+
+  BasicLatch(const BasicLatch&) = delete;
+  BasicLatch& operator=(const BasicLatch&) = delete;
+
+  /**
+   * @brief 计数减n,减到0时唤醒所有等待者
+   */
+  void CountDown(uint32_t n = 1) noexcept {
+    const uint32_t previous = count_.fetch_sub(n, std::memory_order_seq_cst);
+    assert(previous >= n);
+    if (previous == n && waiters_.load(std::memory_order_seq_cst) != 0) {
+      Ops::Wake(&count_, UINT32_MAX);
+    }
+  }
+
+  /**
+   * @brief 计数是否已减到0
+   */
+  bool TryWait() const noexcept { return count_.load(std::memory_order_acquire) == 0; }
+
+  /**
+   * @brief 等待计数减到0
+   */
+  void Wait() noexcept { WaitUntil(nullptr); }
+
+  /**
+   * @brief 带超时的等待
+   *
+   * @return true 计数已减到0
+   * @return false 等待超时
+   */
+  bool WaitFor(std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    return WaitUntil(&deadline);
+  }
+
+  /**
+   * @brief 计数减n后等待计数减到0
+   */
+  void ArriveAndWait(uint32_t n = 1) noexcept {
+    CountDown(n);
+    Wait();
+  }
+
+ private:
+  bool WaitUntil(const sync_detail::Clock::time_point* deadline) noexcept {
+    if (sync_detail::SpinFor([this] { return TryWait(); })) {
+      return true;
+    }
+
+    while (true) {
+      if (TryWait()) {
+        return true;
+      }
+      waiters_.fetch_add(1, std::memory_order_seq_cst);
+      const uint32_t count = count_.load(std::memory_order_seq_cst);
+      const bool in_time = count == 0 || Ops::Wait(&count_, count, deadline);
+      waiters_.fetch_sub(1, std::memory_order_relaxed);
+      if (!in_time) {
+        return TryWait();
+      }
+    }
+  }
+
+  std::atomic<uint32_t> count_;
+  std::atomic<uint32_t> waiters_;
+};
+
+/**
+ * @brief 可重复使用的屏障
+ *
+ * 每一轮固定数量的参与者到达后一起放行,然后自动进入下一轮。
+ *
+ * @tparam kShared 是否进程间共享
+ */
+template <bool kShared>
+class BasicBarrier {
+  using Ops = sync_detail::FutexOps<kShared>;
+
+ public:
+  explicit BasicBarrier(uint32_t participants) noexcept
+      : participants_(participants), arrived_(0), generation_(0), waiters_(0) {
+    assert(participants > 0);
+  }
+
+  BasicBarrier(const BasicBarrier&) = delete;
+  BasicBarrier& operator=(const BasicBarrier&) = delete;
+
+  /**
+   * @brief 到达并等待本轮所有参与者到达
+   *
+   * @return true 本线程是本轮最后一个到达者(可用于执行每轮一次的收尾工作)
+   */
+  bool ArriveAndWait() noexcept {
+    const uint32_t generation = generation_.load(std::memory_order_acquire);
+    if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == participants_) {
+      // 先清零到达数再推进轮次,下一轮的到达者只有看到新轮次后才会到达
+      arrived_.store(0, std::memory_order_relaxed);
+      generation_.fetch_add(1, std::memory_order_seq_cst);
+      if (waiters_.load(std::memory_order_seq_cst) != 0) {
+        Ops::Wake(&generation_, UINT32_MAX);
+      }
+      return true;
+    }
+
+    auto passed = [this, generation] { return generation_.load(std::memory_order_acquire) != generation; };
+    if (sync_detail::SpinFor(passed)) {
+      return false;
+    }
+    while (!passed()) {
+      waiters_.fetch_add(1, std::memory_order_seq_cst);
+      if (generation_.load(std::memory_order_seq_cst) == generation) {
+        Ops::Wait(&generation_, generation, nullptr);
+      }
+      waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return false;
+  }
+
+  uint32_t Participants() const noexcept { return participants_; }
+
+ private:
+  const uint32_t participants_;
+  std::atomic<uint32_t> arrived_;
+  std::atomic<uint32_t> generation_;
+  std::atomic<uint32_t> waiters_;
+};
+
+/**
+ * @brief 事件计数
+ *
+ * 为任意无锁数据结构提供阻塞等待,不丢失唤醒。等待方:
+ * @code
+ *   while (!queue.TryPop(&item)) {
+ *     auto key = ec.PrepareWait();
+ *     if (queue.TryPop(&item)) {  // 登记后必须重新检查条件
+ *       ec.CancelWait();
+ *       break;
+ *     }
+ *     ec.Wait(key);
+ *   }
+ * @endcode
+ * 通知方在使条件成立之后调用NotifyOne/NotifyAll,没有等待者时不执行系统调用。
+ *
+ * @tparam kShared 是否进程间共享
+ */
+template <bool kShared>
+class BasicEventCount {
+  using Ops = sync_detail::FutexOps<kShared>;
+
+ public:
+  using Key = uint32_t;
+
+  BasicEventCount() noexcept : epoch_(0), waiters_(0) {}
+
+  BasicEventCount(const BasicEventCount&) = delete;
+  BasicEventCount& operator=(const BasicEventCount&) = delete;
+
+  /**
+   * @brief 登记为等待者,返回当前纪元,之后必须调用Wait/WaitFor或CancelWait之一
+   */
+  Key PrepareWait() noexcept {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    // 与Notify中的栅栏配对: 调用方随后重新检查条件时,要么看到通知方的修改,要么通知方看到本次登记
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 取消登记(重新检查时条件已成立)
+   */
+  void CancelWait() noexcept { waiters_.fetch_sub(1, std::memory_order_relaxed); }
+
+  /**
+   * @brief 等待纪元离开key(即PrepareWait之后发生过通知)
+   */
+  void Wait(Key key) noexcept {
+    while (epoch_.load(std::memory_order_acquire) == key) {
+      Ops::Wait(&epoch_, key, nullptr);
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 带超时的等待
+   *
+   * @return true 被通知
+   * @return false 等待超时
+   */
+  bool WaitFor(Key key, std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = sync_detail::DeadlineAfter(timeout);
+    bool notified = true;
+    while (epoch_.load(std::memory_order_acquire) == key) {
+      if (!Ops::Wait(&epoch_, key, &deadline)) {
+        notified = epoch_.load(std::memory_order_acquire) != key;
+        break;
+      }
+    }
+    waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return notified;
+  }
+
+  /**
+   * @brief 唤醒一个等待者
+   */
+  void NotifyOne() noexcept { Notify(1); }
+
+  /**
+   * @brief 唤醒所有等待者
+   */
+  void NotifyAll() noexcept { Notify(UINT32_MAX); }
+
+ private:
+  void Notify(uint32_t count) noexcept {
+    // 与PrepareWait中的栅栏配对
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) != 0) {
+      epoch_.fetch_add(1, std::memory_order_release);
+      Ops::Wake(&epoch_, count);
+    }
+  }
+
+  std::atomic<uint32_t> epoch_;
+  std::atomic<uint32_t> waiters_;
+};
+
+using Event = BasicEvent<false>;
+using Semaphore = BasicSemaphore<false>;
+using Latch = BasicLatch<false>;
+using Barrier = BasicBarrier<false>;
+using EventCount = BasicEventCount<false>;
+
+/// 进程间共享版本,可放置在共享内存中
+using ShmEvent = BasicEvent<true>;
+using ShmSemaphore = BasicSemaphore<true>;
+using ShmLatch = BasicLatch<true>;
+using ShmBarrier = BasicBarrier<true>;
+using ShmEventCount = BasicEventCount<true>;
+
+static_assert(std::is_standard_layout<ShmEvent>::value && std::is_standard_layout<ShmSemaphore>::value &&
+                  std::is_standard_layout<ShmLatch>::value && std::is_standard_layout<ShmBarrier>::value &&
+                  std::is_standard_layout<ShmEventCount>::value,
+              "共享内存中的同步原语必须是标准布局类型");
+
+}  // namespace aimrt::common::util
@@ -0,0 +1,592 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+//
+// 基于futex的同步原语的单元测试
+//
+// 测试内容:
+// 1. 各原语的基本语义和超时
+// 2. 多线程压力测试,验证不丢失唤醒、不死锁
+// 3. 进程间共享版本在fork出的子进程之间工作
+// 4. 性能测试,输出每次操作的耗时
+
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "util/sync_primitives.h"
+
+namespace aimrt::common::util {
+namespace {
+
+/**
+ * @brief 在MAP_SHARED匿名内存中构造对象,fork后父子进程共享
+ *
+ * 私有futex以进程地址空间为键,无法跨进程唤醒,因此这里能验证共享版本确实使用了共享futex
+ */
+template <typename T, typename... Args>
+T* NewShared(Args&&... args) {
+  void* addr = mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  EXPECT_NE(addr, MAP_FAILED);
+  return new (addr) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+void DeleteShared(T* object) {
+  object->~T();
+  munmap(object, sizeof(T));
+}
+
+/**
+ * @brief 在子进程中运行func,返回子进程是否成功退出
+ */
+template <typename Func>
+pid_t ForkChild(Func&& func) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    func();
+    _exit(0);
+  }
+  return pid;
+}
+
+bool WaitChild(pid_t pid) {
+  int status = 0;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+double NsPerOp(std::chrono::steady_clock::time_point start, uint64_t ops) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / ops;
+}
+
+// ---------------------------------------------------------------------------
+// Event
+// ---------------------------------------------------------------------------
+
+TEST(EventTest, ManualReset) {
+  Event event(EventResetMode::kManual);
+  EXPECT_FALSE(event.IsSet());
+  EXPECT_FALSE(event.TryWait());
+  EXPECT_FALSE(event.WaitFor(std::chrono::milliseconds(10)));
+
+  event.Set();
+  EXPECT_TRUE(event.TryWait());
+  EXPECT_TRUE(event.TryWait());  // 手动复位事件不会被消费
+  event.Wait();
+
+  event.Reset();
+  EXPECT_FALSE(event.IsSet());
+}
+
+TEST(EventTest, AutoReset) {
+  Event event(EventResetMode::kAuto, true);
+  EXPECT_TRUE(event.TryWait());
+  EXPECT_FALSE(event.TryWait());  // 已被上一次等待消费
+
+  event.Set();
+  event.Set();  // 未被消费前重复触发会合并
+  EXPECT_TRUE(event.WaitFor(std::chrono::milliseconds(10)));
+  EXPECT_FALSE(event.WaitFor(std::chrono::milliseconds(10)));
+}
+
+/**
+ * @brief 手动复位事件一次Set放行所有等待者
+ */
+TEST(EventTest, ManualResetReleasesAllWaiters) {
+  Event event(EventResetMode::kManual);
+  std::atomic<int> released{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&] {
+      event.Wait();
+      released++;
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(released.load(), 0);
+  event.Set();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(released.load(), 8);
+}
+
+/**
+ * @brief 两个自动复位事件之间乒乓,任何一次丢失唤醒都会导致死锁
+ */
+TEST(EventTest, PingPongStress) {
+  constexpr int kRounds = 100000;
+  Event ping(EventResetMode::kAuto);
+  Event pong(EventResetMode::kAuto);
+  int value = 0;
+
+  std::thread peer([&] {
+    for (int i = 0; i < kRounds; ++i) {
+      ping.Wait();
+      ++value;
+      pong.Set();
+    }
+  });
+  for (int i = 0; i < kRounds; ++i) {
+    ping.Set();
+    pong.Wait();
+  }
+  peer.join();
+  EXPECT_EQ(value, kRounds);
+}
+
+TEST(EventTest, ProcessShared) {
+  auto* ping = NewShared<ShmEvent>(EventResetMode::kAuto);
+  auto* pong = NewShared<ShmEvent>(EventResetMode::kAuto);
+  constexpr int kRounds = 10000;
+
+  pid_t pid = ForkChild([&] {
+    for (int i = 0; i < kRounds; ++i) {
+      if (!ping->WaitFor(std::chrono::seconds(5))) {
+        _exit(1);
+      }
+      pong->Set();
+    }
+  });
+  for (int i = 0; i < kRounds; ++i) {
+    ping->Set();
+    ASSERT_TRUE(pong->WaitFor(std::chrono::seconds(5)));
+  }
+  EXPECT_TRUE(WaitChild(pid));
+  DeleteShared(ping);
+  DeleteShared(pong);
+}
+
+// ---------------------------------------------------------------------------
+// Semaphore
+// ---------------------------------------------------------------------------
+
+TEST(SemaphoreTest, Basic) {
+  Semaphore sem(2);
+  EXPECT_TRUE(sem.TryAcquire());
+  EXPECT_TRUE(sem.TryAcquire());
+  EXPECT_FALSE(sem.TryAcquire());
+  EXPECT_FALSE(sem.AcquireFor(std::chrono::milliseconds(10)));
+
+  sem.Release(3);
+  EXPECT_EQ(sem.Value(), 3);
+  sem.Acquire();
+  EXPECT_TRUE(sem.AcquireFor(std::chrono::milliseconds(10)));
+  EXPECT_EQ(sem.Value(), 1);
+}
+
+/**
+ * @brief 多生产者多消费者压力测试: 释放和获取的总数一致,没有消费者永久阻塞
+ */
+TEST(SemaphoreTest, ProducerConsumerStress) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 50000;
+  Semaphore sem;
+  std::atomic<int> acquired{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < kPerThread; ++j) {
+        sem.Acquire();
+        acquired++;
+      }
+    });
+    threads.emplace_back([&] {
+      for (int j = 0; j < kPerThread; ++j) {
+        sem.Release();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(acquired.load(), kThreads * kPerThread);
+  EXPECT_EQ(sem.Value(), 0);
+}
+
+/**
+ * @brief 信号量限制同时持有资源的线程数
+ */
+TEST(SemaphoreTest, LimitsConcurrency) {
+  constexpr uint32_t kSlots = 3;
+  Semaphore sem(kSlots);
+  std::atomic<uint32_t> holders{0};
+  std::atomic<uint32_t> max_holders{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 2000; ++j) {
+        sem.Acquire();
+        const uint32_t now = ++holders;
+        uint32_t seen = max_holders.load();
+        while (now > seen && !max_holders.compare_exchange_weak(seen, now)) {
+        }
+        --holders;
+        sem.Release();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(max_holders.load(), kSlots);
+  EXPECT_EQ(sem.Value(), kSlots);
+}
+
+TEST(SemaphoreTest, ProcessShared) {
+  auto* sem = NewShared<ShmSemaphore>(0);
+  constexpr int kCount = 10000;
+
+  pid_t pid = ForkChild([&] {
+    for (int i = 0; i < kCount; ++i) {
+      sem->Release();
+    }
+  });
+  for (int i = 0; i < kCount; ++i) {
+    ASSERT_TRUE(sem->AcquireFor(std::chrono::seconds(5)));
+  }
+  EXPECT_TRUE(WaitChild(pid));
+  EXPECT_EQ(sem->Value(), 0);
+  DeleteShared(sem);
+}
+
+// ---------------------------------------------------------------------------
+// Latch
+// ---------------------------------------------------------------------------
+
+TEST(LatchTest, Basic) {
+  Latch latch(2);
+  EXPECT_FALSE(latch.TryWait());
+  EXPECT_FALSE(latch.WaitFor(std::chrono::milliseconds(10)));
+  latch.CountDown();
+  EXPECT_FALSE(latch.TryWait());
+  latch.CountDown();
+  EXPECT_TRUE(latch.TryWait());
+  latch.Wait();
+  EXPECT_TRUE(latch.WaitFor(std::chrono::milliseconds(10)));
+}
+
+/**
+ * @brief 多个线程倒计数、多个线程等待
+ */
+TEST(LatchTest, Stress) {
+  for (int round = 0; round < 200; ++round) {
+    constexpr int kWorkers = 8;
+    Latch latch(kWorkers);
+    std::atomic<int> done{0};
+    std::atomic<int> observed{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([&] {
+        latch.Wait();
+        observed += done.load();
+      });
+    }
+    for (int i = 0; i < kWorkers; ++i) {
+      threads.emplace_back([&] {
+        done++;
+        latch.CountDown();
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    ASSERT_EQ(observed.load(), 4 * kWorkers);
+  }
+}
+
+TEST(LatchTest, ProcessShared) {
+  auto* latch = NewShared<ShmLatch>(3);
+  std::vector<pid_t> children;
+  for (int i = 0; i < 3; ++i) {
+    children.push_back(ForkChild([&] { latch->CountDown(); }));
+  }
+  EXPECT_TRUE(latch->WaitFor(std::chrono::seconds(5)));
+  for (pid_t pid : children) {
+    EXPECT_TRUE(WaitChild(pid));
+  }
+  DeleteShared(latch);
+}
+
+// ---------------------------------------------------------------------------
+// Barrier
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief 多轮屏障: 每轮结束时所有参与者都已完成本轮工作,且每轮只有一个最后到达者
+ */
+TEST(BarrierTest, Stress) {
+  constexpr int kThreads = 6;
+  constexpr int kRounds = 5000;
+  Barrier barrier(kThreads);
+  std::atomic<int> counter{0};
+  std::atomic<int> serial{0};
+  std::atomic<bool> ok{true};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < kRounds; ++round) {
+        counter++;
+        if (barrier.ArriveAndWait()) {
+          serial++;
+        }
+        if (counter.load() < kThreads * (round + 1)) {
+          ok = false;
+        }
+        // 第二个屏障保证下一轮的计数不会被本轮的检查看到
+        barrier.ArriveAndWait();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(ok.load());
+  EXPECT_EQ(counter.load(), kThreads * kRounds);
+  EXPECT_EQ(serial.load(), kRounds);
+}
+
+TEST(BarrierTest, ProcessShared) {
+  constexpr int kRounds = 1000;
+  auto* barrier = NewShared<ShmBarrier>(2);
+  auto* counter = NewShared<std::atomic<int>>(0);
+
+  pid_t pid = ForkChild([&] {
+    for (int i = 0; i < kRounds; ++i) {
+      counter->fetch_add(1);
+      barrier->ArriveAndWait();
+      barrier->ArriveAndWait();
+    }
+  });
+  for (int i = 0; i < kRounds; ++i) {
+    counter->fetch_add(1);
+    barrier->ArriveAndWait();
+    ASSERT_EQ(counter->load(), 2 * (i + 1));
+    barrier->ArriveAndWait();
+  }
+  EXPECT_TRUE(WaitChild(pid));
+  DeleteShared(barrier);
+  DeleteShared(counter);
+}
+
+// ---------------------------------------------------------------------------
+// EventCount
+// ---------------------------------------------------------------------------
+
+TEST(EventCountTest, Timeout) {
+  EventCount ec;
+  auto key = ec.PrepareWait();
+  EXPECT_FALSE(ec.WaitFor(key, std::chrono::milliseconds(10)));
+
+  key = ec.PrepareWait();
+  ec.NotifyAll();
+  EXPECT_TRUE(ec.WaitFor(key, std::chrono::milliseconds(10)));
+}
+
+/**
+ * @brief 用事件计数为一个原子计数器提供阻塞等待,验证不丢失唤醒
+ */
+TEST(EventCountTest, NoLostWakeups) {
+  constexpr int kConsumers = 4;
+  constexpr int kItems = 200000;
+  EventCount ec;
+  std::atomic<int> available{0};
+  std::atomic<int> consumed{0};
+  std::atomic<bool> stop{false};
+
+  auto try_take = [&] {
+    int n = available.load();
+    while (n > 0) {
+      if (available.compare_exchange_weak(n, n - 1)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < kConsumers; ++i) {
+    consumers.emplace_back([&] {
+      while (true) {
+        if (try_take()) {
+          consumed++;
+          continue;
+        }
+        auto key = ec.PrepareWait();
+        if (try_take()) {
+          ec.CancelWait();
+          consumed++;
+          continue;
+        }
+        if (stop.load()) {
+          ec.CancelWait();
+          return;
+        }
+        ec.Wait(key);
+      }
+    });
+  }
+
+  for (int i = 0; i < kItems; ++i) {
+    available++;
+    ec.NotifyOne();
+  }
+  while (consumed.load() < kItems) {
+    std::this_thread::yield();
+  }
+  stop = true;
+  ec.NotifyAll();
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  EXPECT_EQ(consumed.load(), kItems);
+}
+
+TEST(EventCountTest, ProcessShared) {
+  auto* ec = NewShared<ShmEventCount>();
+  auto* value = NewShared<std::atomic<int>>(0);
+
+  pid_t pid = ForkChild([&] {
+    while (value->load() == 0) {
+      auto key = ec->PrepareWait();
+      if (value->load() != 0) {
+        ec->CancelWait();
+        break;
+      }
+      if (!ec->WaitFor(key, std::chrono::seconds(5))) {
+        _exit(1);
+      }
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  value->store(1);
+  ec->NotifyAll();
+  EXPECT_TRUE(WaitChild(pid));
+  DeleteShared(ec);
+  DeleteShared(value);
+}
+
+// ---------------------------------------------------------------------------
+// 性能测试
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief 无竞争路径的开销,应不涉及系统调用
+ */
+TEST(SyncPrimitivesBenchmark, Uncontended) {
+  constexpr uint64_t kOps = 1000000;
+
+  Event event(EventResetMode::kAuto);
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kOps; ++i) {
+    event.Set();
+    event.Wait();
+  }
+  std::cout << "Event Set+Wait (uncontended): " << NsPerOp(start, kOps) << " ns/op" << std::endl;
+
+  Semaphore sem;
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kOps; ++i) {
+    sem.Release();
+    sem.Acquire();
+  }
+  std::cout << "Semaphore Release+Acquire (uncontended): " << NsPerOp(start, kOps) << " ns/op" << std::endl;
+
+  EventCount ec;
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kOps; ++i) {
+    ec.NotifyOne();
+  }
+  std::cout << "EventCount NotifyOne (no waiters): " << NsPerOp(start, kOps) << " ns/op" << std::endl;
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool flag = false;
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kOps; ++i) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      flag = true;
+    }
+    cond.notify_all();
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [&] { return flag; });
+    flag = false;
+  }
+  std::cout << "mutex+condition_variable notify+wait (uncontended): " << NsPerOp(start, kOps) << " ns/op"
+            << std::endl;
+}
+
+/**
+ * @brief 两线程之间的唤醒往返延迟
+ */
+TEST(SyncPrimitivesBenchmark, PingPong) {
+  constexpr uint64_t kRounds = 100000;
+
+  Event ping(EventResetMode::kAuto);
+  Event pong(EventResetMode::kAuto);
+  std::thread peer([&] {
+    for (uint64_t i = 0; i < kRounds; ++i) {
+      ping.Wait();
+      pong.Set();
+    }
+  });
+  auto start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kRounds; ++i) {
+    ping.Set();
+    pong.Wait();
+  }
+  std::cout << "Event ping-pong round trip: " << NsPerOp(start, kRounds) << " ns" << std::endl;
+  peer.join();
+
+  Semaphore sem_ping;
+  Semaphore sem_pong;
+  peer = std::thread([&] {
+    for (uint64_t i = 0; i < kRounds; ++i) {
+      sem_ping.Acquire();
+      sem_pong.Release();
+    }
+  });
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kRounds; ++i) {
+    sem_ping.Release();
+    sem_pong.Acquire();
+  }
+  std::cout << "Semaphore ping-pong round trip: " << NsPerOp(start, kRounds) << " ns" << std::endl;
+  peer.join();
+
+  Barrier barrier(2);
+  peer = std::thread([&] {
+    for (uint64_t i = 0; i < kRounds; ++i) {
+      barrier.ArriveAndWait();
+    }
+  });
+  start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < kRounds; ++i) {
+    barrier.ArriveAndWait();
+  }
+  std::cout << "Barrier(2) round: " << NsPerOp(start, kRounds) << " ns" << std::endl;
+  peer.join();
+
+  Latch latch(1);
+  start = std::chrono::steady_clock::now();
+  latch.CountDown();
+  latch.Wait();
+  std::cout << "Latch CountDown+Wait: " << NsPerOp(start, 1) << " ns" << std::endl;
+}
+
+}  // namespace
+}  // namespace aimrt::common::util
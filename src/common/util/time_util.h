@@ -3,10 +3,26 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <ctime>
+#include <limits>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
+#include "util/macros.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
 
 namespace aimrt::common::util {
 
@@ -157,13 +173,31 @@ inline time_t GetCurTimeT() {
   return std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
 }
 
+namespace time_detail {
+
 /**
- * @brief localtime
- *
- * @param t
- * @return struct tm
+ * @brief 时区版本号,ReloadLocalTimeZone时递增,使各线程的本地时间缓存失效
  */
-inline struct tm TimeT2TmLocal(time_t t) {
+inline std::atomic<uint32_t>& TimeZoneGeneration() {
+  static std::atomic<uint32_t> generation{0};
+  return generation;
+}
+
+inline std::mutex& TimeZoneMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+/**
+ * @brief 每线程缓存的本地时间: 缓存当前分钟起点的分解时间,同一分钟内只需改写秒数
+ */
+struct LocalTimeCache {
+  time_t minute_start = 0;
+  uint32_t generation = std::numeric_limits<uint32_t>::max();  ///< 初始值与任何有效版本号都不同
+  struct tm minute_tm {};
+};
+
+inline struct tm LocalTimeUncached(time_t t) {
   struct tm st;
 #if defined(_WIN32)
   localtime_s(&st, &t);
@@ -173,6 +207,52 @@ inline struct tm TimeT2TmLocal(time_t t) {
   return st;
 }
 
+}  // namespace time_detail
+
+/**
+ * @brief 重新加载本地时区
+ *
+ * 修改TZ环境变量或系统时区文件后调用。加锁调用tzset并使所有线程的本地时间缓存失效,
+ * 可与其他线程的时间转换并发调用。
+ */
+inline void ReloadLocalTimeZone() {
+  std::lock_guard<std::mutex> lck(time_detail::TimeZoneMutex());
+#if defined(_WIN32)
+  _tzset();
+#else
+  tzset();
+#endif
+  time_detail::TimeZoneGeneration().fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief localtime
+ *
+ * 结果按线程缓存到分钟粒度,同一分钟内的转换不再调用localtime_r(其内部持有全局时区锁)
+ *
+ * @param t
+ * @return struct tm
+ */
+inline struct tm TimeT2TmLocal(time_t t) {
+  thread_local time_detail::LocalTimeCache cache;
+  const uint32_t generation = time_detail::TimeZoneGeneration().load(std::memory_order_acquire);
+  if (t >= cache.minute_start && t - cache.minute_start < kSecondPerMinute && generation == cache.generation) {
+    struct tm st = cache.minute_tm;
+    st.tm_sec = static_cast<int>(t - cache.minute_start);
+    return st;
+  }
+
+  struct tm st = time_detail::LocalTimeUncached(t);
+  // 闰秒(tm_sec == 60)不进入缓存
+  if (st.tm_sec < kSecondPerMinute) {
+    cache.minute_start = t - st.tm_sec;
+    cache.generation = generation;
+    cache.minute_tm = st;
+    cache.minute_tm.tm_sec = 0;
+  }
+  return st;
+}
+
 /**
  * @brief gmtime
  *
@@ -216,7 +296,19 @@ inline std::string_view GetTimeStr(tm t) {
  * @return std::string_view
  */
 inline std::string_view GetTimeStr(time_t t) {
-  return GetTimeStr(TimeT2TmLocal(t));
+  // 每线程缓存上一次的结果,同一秒内直接复用
+  thread_local time_t cached_t = std::numeric_limits<time_t>::min();
+  thread_local uint32_t cached_generation = std::numeric_limits<uint32_t>::max();
+  thread_local char buf[20];
+  const uint32_t generation = time_detail::TimeZoneGeneration().load(std::memory_order_acquire);
+  if (t != cached_t || generation != cached_generation) {
+    const std::string_view str = GetTimeStr(TimeT2TmLocal(t));
+    str.copy(buf, str.size());
+    buf[str.size()] = '\0';
+    cached_t = t;
+    cached_generation = generation;
+  }
+  return std::string_view(buf);
 }
 
 /**
@@ -496,4 +588,320 @@ inline std::string_view GetClockStr(time_t t) {
   return std::string_view(buf);
 }
 
+namespace time_detail {
+
+inline uint64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * @brief 读取CPU周期计数器(x86 TSC / aarch64 cntvct),不支持时返回0
+ */
+inline uint64_t ReadCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t value;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+#else
+  return 0;
+#endif
+}
+
+/**
+ * @brief (a * b) >> 32,中间结果不溢出
+ */
+inline uint64_t MulShr32(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 32);
+#else
+  return static_cast<uint64_t>(static_cast<long double>(a) * b / 4294967296.0L);
+#endif
+}
+
+/**
+ * @brief (a << 32) / b,中间结果不溢出
+ */
+inline uint64_t ShlDiv32(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) << 32) / b);
+#else
+  return static_cast<uint64_t>(static_cast<long double>(a) * 4294967296.0L / b);
+#endif
+}
+
+/**
+ * @brief 周期计数器是否可用于计时: 频率恒定且不随CPU休眠停止
+ */
+inline bool CycleCounterUsable() {
+#if defined(__x86_64__) || defined(__i386__)
+  // CPUID 0x80000007 EDX bit 8: invariant TSC
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007) return false;
+  __cpuid(0x80000007, eax, ebx, ecx, edx);
+  return (edx & (1U << 8)) != 0;
+#elif defined(__aarch64__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+}  // namespace time_detail
+
+/**
+ * @brief 低开销时间服务
+ *
+ * 面向日志、消息时间戳等每条消息都要取时间的热路径:
+ * 1. 粗粒度时钟: 后台线程每kCoarsePeriod刷新一次的墙上时间,读取只是一次原子load,适用于毫秒精度的需求
+ * 2. 精细时钟: 读取CPU周期计数器并换算为纳秒,以steady_clock(CLOCK_MONOTONIC)为基准校准。
+ *    后台线程每kCalibratePeriod重新采样一次,调整换算斜率使累积误差在下一个周期内被消除,
+ *    时间不会回跳。墙上时间由单调时间加上校准时采样的偏移得到,系统时间被修改后最多滞后一个校准周期。
+ *    周期计数器不可用或频率不恒定时退化为steady_clock/system_clock
+ *
+ * 后台线程在首次使用时启动;fork出的子进程在首次读取时重新启动后台线程。
+ * 实例有意泄漏,后台线程随进程退出,静态析构期间的日志等仍可读取时间,退出时也不必等待后台线程。
+ */
+class TimeService {
+ public:
+  static constexpr std::chrono::milliseconds kCoarsePeriod{1};
+  static constexpr std::chrono::milliseconds kCalibratePeriod{1000};
+
+  static TimeService& Instance() {
+    static TimeService* const instance = new TimeService();
+    return *instance;
+  }
+
+  TimeService(const TimeService&) = delete;
+  TimeService& operator=(const TimeService&) = delete;
+
+  /**
+   * @brief 粗粒度墙上时间,纳秒时间戳,精度约为kCoarsePeriod
+   */
+  uint64_t CoarseNowNs() {
+    RestartIfForked();
+    return coarse_ns_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 精细单调时间,与steady_clock同一时间基准
+   */
+  uint64_t SteadyNowNs() {
+    RestartIfForked();
+    if (!use_cycle_counter_) return time_detail::SteadyNowNs();
+    return Convert(time_detail::ReadCycleCounter(), nullptr);
+  }
+
+  /**
+   * @brief 精细墙上时间,纳秒时间戳
+   */
+  uint64_t SystemNowNs() {
+    RestartIfForked();
+    if (!use_cycle_counter_) return GetCurTimestampNs();
+    int64_t offset = 0;
+    const uint64_t steady_ns = Convert(time_detail::ReadCycleCounter(), &offset);
+    return static_cast<uint64_t>(static_cast<int64_t>(steady_ns) + offset);
+  }
+
+  /**
+   * @brief 精细时钟是否使用周期计数器
+   */
+  bool UsingCycleCounter() const { return use_cycle_counter_; }
+
+  /**
+   * @brief 立即重新校准精细时钟,通常由后台线程周期性调用
+   */
+  void Calibrate() {
+    if (!use_cycle_counter_ || calibrating_.test_and_set(std::memory_order_acquire)) return;
+
+    uint64_t cycles = 0, steady_ns = 0, system_ns = 0;
+    SamplePair(&cycles, &steady_ns, &system_ns);
+    const uint64_t estimate = Convert(cycles, nullptr);
+
+    // 以首次采样为起点的长基线斜率,随运行时间增长越来越准确
+    const uint64_t nominal_mult = MultFromDelta(steady_ns - anchor_ns_, cycles - anchor_cycles_);
+
+    // 误差过大(如进程被长时间挂起)时直接向前跳,否则通过调整斜率在一个周期内平滑消除
+    const int64_t period_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(kCalibratePeriod).count();
+    const int64_t max_correction = period_ns / 8;
+    int64_t error = static_cast<int64_t>(steady_ns - estimate);
+    uint64_t base_ns = estimate;
+    if (error > max_correction) {
+      base_ns = steady_ns;
+      error = 0;
+    }
+    const int64_t correction = error < -max_correction ? -max_correction : error;
+    const uint64_t period_cycles = time_detail::ShlDiv32(static_cast<uint64_t>(period_ns), nominal_mult);
+    const uint64_t mult = MultFromDelta(static_cast<uint64_t>(period_ns + correction), period_cycles);
+
+    StoreParams(cycles, base_ns, mult, static_cast<int64_t>(system_ns - steady_ns));
+    calibrating_.clear(std::memory_order_release);
+  }
+
+ private:
+  TimeService() : use_cycle_counter_(time_detail::CycleCounterUsable()) {
+    coarse_ns_.store(GetCurTimestampNs(), std::memory_order_relaxed);
+    if (use_cycle_counter_) InitialCalibrate();
+#if !defined(_WIN32)
+    pthread_atfork(nullptr, nullptr, [] { Instance().AfterForkInChild(); });
+#endif
+    StartThread();
+  }
+
+  static uint64_t MultFromDelta(uint64_t ns, uint64_t cycles) {
+    return time_detail::ShlDiv32(ns, cycles == 0 ? 1 : cycles);
+  }
+
+  /**
+   * @brief 采样一对(周期计数, 单调时间, 墙上时间),取多次中计数窗口最小的一次以减小误差
+   */
+  static void SamplePair(uint64_t* cycles, uint64_t* steady_ns, uint64_t* system_ns) {
+    uint64_t best_window = UINT64_MAX;
+    for (int i = 0; i < 5; ++i) {
+      const uint64_t before = time_detail::ReadCycleCounter();
+      const uint64_t ns = time_detail::SteadyNowNs();
+      const uint64_t after = time_detail::ReadCycleCounter();
+      if (after - before < best_window) {
+        best_window = after - before;
+        *cycles = before + (after - before) / 2;
+        *steady_ns = ns;
+        *system_ns = GetCurTimestampNs() - (time_detail::SteadyNowNs() - ns);
+      }
+    }
+  }
+
+  /**
+   * @brief 首次校准: 忙等kInitialCalibration估算初始斜率,之后由周期校准逐步修正
+   */
+  void InitialCalibrate() {
+    constexpr uint64_t kInitialCalibrationNs = 2000000;
+    uint64_t system_ns = 0;
+    SamplePair(&anchor_cycles_, &anchor_ns_, &system_ns);
+    while (time_detail::SteadyNowNs() - anchor_ns_ < kInitialCalibrationNs) {
+    }
+    uint64_t cycles = 0, steady_ns = 0;
+    SamplePair(&cycles, &steady_ns, &system_ns);
+    StoreParams(cycles, steady_ns, MultFromDelta(steady_ns - anchor_ns_, cycles - anchor_cycles_),
+                static_cast<int64_t>(system_ns - steady_ns));
+  }
+
+  /**
+   * @brief 按当前参数把周期计数换算为单调纳秒时间(seqlock读端)
+   */
+  uint64_t Convert(uint64_t cycles, int64_t* realtime_offset) const {
+    uint32_t seq;
+    uint64_t base_cycles, base_ns, mult;
+    int64_t offset;
+    do {
+      seq = seq_.load(std::memory_order_acquire);
+      base_cycles = base_cycles_.load(std::memory_order_relaxed);
+      base_ns = base_ns_.load(std::memory_order_relaxed);
+      mult = mult_.load(std::memory_order_relaxed);
+      offset = realtime_offset_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 || seq != seq_.load(std::memory_order_relaxed));
+
+    if (realtime_offset != nullptr) *realtime_offset = offset;
+    // 其他核心上的采样可能略晚于本次读数
+    const uint64_t delta = cycles > base_cycles ? cycles - base_cycles : 0;
+    return base_ns + time_detail::MulShr32(delta, mult);
+  }
+
+  void StoreParams(uint64_t base_cycles, uint64_t base_ns, uint64_t mult, int64_t realtime_offset) {
+    const uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_cycles_.store(base_cycles, std::memory_order_relaxed);
+    base_ns_.store(base_ns, std::memory_order_relaxed);
+    mult_.store(mult, std::memory_order_relaxed);
+    realtime_offset_.store(realtime_offset, std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  void StartThread() {
+    std::thread([this] {
+      auto next_calibrate = std::chrono::steady_clock::now() + kCalibratePeriod;
+      while (true) {
+        coarse_ns_.store(GetCurTimestampNs(), std::memory_order_relaxed);
+        std::this_thread::sleep_for(kCoarsePeriod);
+        if (std::chrono::steady_clock::now() >= next_calibrate) {
+          Calibrate();
+          next_calibrate += kCalibratePeriod;
+        }
+      }
+    }).detach();
+  }
+
+  /**
+   * @brief fork后的子进程中只有调用fork的线程存活: 修复可能处于中间状态的校准数据,延迟重启后台线程
+   */
+  void AfterForkInChild() {
+    calibrating_.clear(std::memory_order_relaxed);
+    const uint32_t seq = seq_.load(std::memory_order_relaxed);
+    if ((seq & 1) != 0) seq_.store(seq + 1, std::memory_order_relaxed);
+    restart_needed_.store(true, std::memory_order_release);
+  }
+
+  void RestartIfForked() {
+    if (omnirt_unlikely(restart_needed_.load(std::memory_order_relaxed)) &&
+        restart_needed_.exchange(false, std::memory_order_acq_rel)) {
+      Calibrate();
+      StartThread();
+    }
+  }
+
+  const bool use_cycle_counter_;
+  uint64_t anchor_cycles_ = 0;  ///< 首次校准的起点,只在构造时写入
+  uint64_t anchor_ns_ = 0;
+
+  alignas(64) std::atomic<uint32_t> seq_{0};
+  std::atomic<uint64_t> base_cycles_{0};
+  std::atomic<uint64_t> base_ns_{0};
+  std::atomic<uint64_t> mult_{0};  ///< 每周期纳秒数,32位定点
+  std::atomic<int64_t> realtime_offset_{0};
+  std::atomic<bool> restart_needed_{false};
+
+  alignas(64) std::atomic<uint64_t> coarse_ns_{0};
+
+  std::atomic_flag calibrating_ = ATOMIC_FLAG_INIT;
+};
+
+/**
+ * @brief 获取粗粒度的当前时间纳秒时间戳(精度约1ms)
+ */
+inline uint64_t GetCoarseTimestampNs() {
+  return TimeService::Instance().CoarseNowNs();
+}
+
+/**
+ * @brief 获取粗粒度的当前时间毫秒时间戳
+ */
+inline uint64_t GetCoarseTimestampMs() {
+  return GetCoarseTimestampNs() / (kUsPerMs * kUsPerMs);
+}
+
+/**
+ * @brief 获取精细的当前时间纳秒时间戳(基于周期计数器)
+ */
+inline uint64_t GetFineTimestampNs() {
+  return TimeService::Instance().SystemNowNs();
+}
+
+/**
+ * @brief 获取精细的单调时间纳秒数,与steady_clock同一基准
+ */
+inline uint64_t GetFineSteadyNs() {
+  return TimeService::Instance().SteadyNowNs();
+}
+
+/**
+ * @brief 获取精细的当前时间点,可替代热路径上的system_clock::now()
+ */
+inline std::chrono::system_clock::time_point GetFineTimePoint() {
+  return GetTimePointFromTimestampNs(GetFineTimestampNs());
+}
+
 }  // namespace aimrt::common::util
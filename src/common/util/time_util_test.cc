@@ -2,6 +2,12 @@
 // All rights reserved.
 
 #include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
 
 #include "util/time_util.h"
 #include "util/log_util.h"
@@ -61,4 +67,182 @@ TEST(TIME_UTIL_TEST, GetMonthDayCount) {
   EXPECT_EQ(GetMonthDayCount(2001, 1), 28);
 }
 
+namespace {
+
+int64_t AbsDiff(uint64_t a, uint64_t b) {
+  return a > b ? static_cast<int64_t>(a - b) : static_cast<int64_t>(b - a);
+}
+
+bool SameTm(const struct tm& a, const struct tm& b) {
+  return a.tm_year == b.tm_year && a.tm_mon == b.tm_mon && a.tm_mday == b.tm_mday && a.tm_hour == b.tm_hour &&
+         a.tm_min == b.tm_min && a.tm_sec == b.tm_sec && a.tm_wday == b.tm_wday && a.tm_yday == b.tm_yday &&
+         a.tm_isdst == b.tm_isdst;
+}
+
+/**
+ * @brief 测量fn的平均耗时(ns)
+ */
+template <typename Fn>
+double MeasureNs(Fn&& fn, int iterations) {
+  volatile uint64_t sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    sink = sink + fn(i);
+  }
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(ns) / iterations;
+}
+
+}  // namespace
+
+/**
+ * @brief 测试本地时间缓存与localtime_r结果一致,包括跨分钟、跨天以及时间倒退
+ */
+TEST(TIME_UTIL_TEST, LocalTimeCache) {
+  const time_t base = GetCurTimeT();
+  for (time_t t = base - 200; t < base + 200; ++t) {
+    ASSERT_TRUE(SameTm(TimeT2TmLocal(t), time_detail::LocalTimeUncached(t))) << t;
+    ASSERT_EQ(GetTimeStr(t), std::string(GetTimeStr(time_detail::LocalTimeUncached(t))));
+  }
+  for (time_t t = base + kSecondPerDay; t > base - kSecondPerDay; t -= 997) {
+    ASSERT_TRUE(SameTm(TimeT2TmLocal(t), time_detail::LocalTimeUncached(t))) << t;
+  }
+}
+
+/**
+ * @brief 测试重新加载时区后缓存失效,且与并发的时间转换互不影响
+ */
+TEST(TIME_UTIL_TEST, ReloadLocalTimeZone) {
+  const char* old_tz = getenv("TZ");
+  const std::string saved = old_tz ? old_tz : "";
+
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 2; ++i) {
+    readers.emplace_back([&]() {
+      while (!stop.load()) {
+        const std::string_view str = GetTimeStr(GetCurTimeT());
+        EXPECT_EQ(str.size(), 19u);
+      }
+    });
+  }
+
+  const time_t t = 1700000000;  // 2023-11-14 22:13:20 UTC
+  setenv("TZ", "UTC0", 1);
+  ReloadLocalTimeZone();
+  EXPECT_EQ(TimeT2TmLocal(t).tm_hour, 22);
+  EXPECT_EQ(GetTimeStr(t), "2023-11-14 22:13:20");
+
+  setenv("TZ", "CST-8", 1);
+  ReloadLocalTimeZone();
+  EXPECT_EQ(TimeT2TmLocal(t).tm_hour, 6);
+  EXPECT_EQ(GetTimeStr(t), "2023-11-15 06:13:20");
+
+  stop = true;
+  for (auto& reader : readers) reader.join();
+
+  if (old_tz) {
+    setenv("TZ", saved.c_str(), 1);
+  } else {
+    unsetenv("TZ");
+  }
+  ReloadLocalTimeZone();
+}
+
+/**
+ * @brief 测试粗粒度时钟与系统时钟的偏差在刷新周期附近
+ */
+TEST(TIME_UTIL_TEST, CoarseClockAccuracy) {
+  const uint64_t first = GetCoarseTimestampNs();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const uint64_t second = GetCoarseTimestampNs();
+  EXPECT_GT(second, first);
+
+  // 单核或负载较高时后台线程可能被延迟调度,留有余量
+  constexpr int64_t kBoundNs = 20 * 1000 * 1000;
+  EXPECT_LT(AbsDiff(GetCoarseTimestampNs(), GetCurTimestampNs()), kBoundNs);
+  EXPECT_LE(AbsDiff(GetCoarseTimestampMs(), GetCurTimestampMs()), 20u);
+}
+
+/**
+ * @brief 测试精细时钟与系统时钟的偏差以及单调性
+ */
+TEST(TIME_UTIL_TEST, FineClockAccuracy) {
+  std::cout << "fine clock uses cycle counter: " << TimeService::Instance().UsingCycleCounter() << std::endl;
+
+  constexpr int64_t kBoundNs = 1000 * 1000;
+  for (int round = 0; round < 3; ++round) {
+    EXPECT_LT(AbsDiff(GetFineSteadyNs(), time_detail::SteadyNowNs()), kBoundNs);
+    EXPECT_LT(AbsDiff(GetFineTimestampNs(), GetCurTimestampNs()), kBoundNs);
+
+    uint64_t last = GetFineSteadyNs();
+    for (int i = 0; i < 100000; ++i) {
+      const uint64_t now = GetFineSteadyNs();
+      ASSERT_GE(now, last);
+      last = now;
+    }
+    TimeService::Instance().Calibrate();
+    EXPECT_GE(GetFineSteadyNs(), last);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  const auto fine_tp = GetFineTimePoint();
+  EXPECT_LT(std::chrono::abs(fine_tp - std::chrono::system_clock::now()), std::chrono::milliseconds(1));
+}
+
+/**
+ * @brief 测试fork出的子进程中后台线程重新启动
+ */
+TEST(TIME_UTIL_TEST, ClockAfterFork) {
+  GetCoarseTimestampNs();
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    const uint64_t first = GetCoarseTimestampNs();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const bool advanced = GetCoarseTimestampNs() > first;
+    const bool accurate = AbsDiff(GetFineTimestampNs(), GetCurTimestampNs()) < 1000 * 1000;
+    _exit(advanced && accurate ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+/**
+ * @brief 时间获取与格式化的性能基准
+ */
+TEST(TIME_UTIL_TEST, Benchmark) {
+  constexpr int kIterations = 1000000;
+  GetCoarseTimestampNs();
+
+  const double system_ns = MeasureNs([](int) { return GetCurTimestampNs(); }, kIterations);
+  const double coarse_ns = MeasureNs([](int) { return GetCoarseTimestampNs(); }, kIterations);
+  const double fine_ns = MeasureNs([](int) { return GetFineTimestampNs(); }, kIterations);
+  const double steady_ns = MeasureNs([](int) { return GetFineSteadyNs(); }, kIterations);
+
+  const time_t base = GetCurTimeT();
+  // 每1000次调用前进一秒,模拟高频日志
+  const double localtime_ns = MeasureNs(
+      [base](int i) {
+        return static_cast<uint64_t>(time_detail::LocalTimeUncached(base + i / 1000).tm_sec);
+      },
+      kIterations);
+  const double cached_localtime_ns = MeasureNs(
+      [base](int i) { return static_cast<uint64_t>(TimeT2TmLocal(base + i / 1000).tm_sec); }, kIterations);
+  const double format_ns = MeasureNs(
+      [base](int i) { return GetTimeStr(time_detail::LocalTimeUncached(base + i / 1000)).size(); }, kIterations);
+  const double cached_format_ns = MeasureNs([base](int i) { return GetTimeStr(base + i / 1000).size(); }, kIterations);
+
+  std::cout << "system_clock::now:       " << system_ns << " ns/op\n"
+            << "GetCoarseTimestampNs:    " << coarse_ns << " ns/op\n"
+            << "GetFineTimestampNs:      " << fine_ns << " ns/op\n"
+            << "GetFineSteadyNs:         " << steady_ns << " ns/op\n"
+            << "localtime_r:             " << localtime_ns << " ns/op\n"
+            << "TimeT2TmLocal (cached):  " << cached_localtime_ns << " ns/op\n"
+            << "localtime_r + format:    " << format_ns << " ns/op\n"
+            << "GetTimeStr (cached):     " << cached_format_ns << " ns/op" << std::endl;
+}
+
 }  // namespace aimrt::common::util
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <string>
 #include <string_view>
 
@@ -102,6 +104,91 @@ inline std::string UrlDecode(std::string_view str) {
   return ret_str;
 }
 
+/**
+ * @brief URL解码视图，遍历时逐字符解码，不分配内存
+ * @details 解码规则与UrlDecode相同，末尾不完整的%XX及其后的内容被忽略
+ */
+class UrlDecodeView {
+ public:
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = char;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const char*;
+    using reference = char;
+
+    Iterator() = default;
+    Iterator(std::string_view str, size_t pos) : str_(str), pos_(pos) { Normalize(); }
+
+    char operator*() const {
+      char c = str_[pos_];
+      if (c == '+') return ' ';
+      if (c == '%') return static_cast<char>((FromHex(str_[pos_ + 1]) << 4) | FromHex(str_[pos_ + 2]));
+      return c;
+    }
+
+    Iterator& operator++() {
+      pos_ += (str_[pos_] == '%') ? 3 : 1;
+      Normalize();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      ++(*this);
+      return tmp;
+    }
+
+    bool operator==(const Iterator& rhs) const { return pos_ == rhs.pos_; }
+    bool operator!=(const Iterator& rhs) const { return pos_ != rhs.pos_; }
+
+   private:
+    // 与UrlDecode一致，遇到不完整的%XX时结束
+    void Normalize() {
+      if (pos_ < str_.size() && str_[pos_] == '%' && pos_ + 2 >= str_.size()) pos_ = str_.size();
+    }
+
+    std::string_view str_;
+    size_t pos_ = 0;
+  };
+
+  explicit UrlDecodeView(std::string_view str) : str_(str) {}
+
+  Iterator begin() const { return Iterator(str_, 0); }
+  Iterator end() const { return Iterator(str_, str_.size()); }
+
+  /**
+   * @brief 原始字符串中不含需要解码的字符时，解码结果就是原始字符串
+   */
+  bool IsIdentity() const { return str_.find_first_of("+%") == std::string_view::npos; }
+
+  size_t size() const {
+    size_t n = 0;
+    for (auto itr = begin(); itr != end(); ++itr) ++n;
+    return n;
+  }
+
+  /**
+   * @brief 与未编码的字符串比较，不分配内存
+   */
+  bool operator==(std::string_view rhs) const {
+    if (IsIdentity()) return str_ == rhs;
+
+    size_t ii = 0;
+    for (char c : *this) {
+      if (ii >= rhs.size() || rhs[ii] != c) return false;
+      ++ii;
+    }
+    return ii == rhs.size();
+  }
+
+  std::string ToString() const { return std::string(begin(), end()); }
+
+ private:
+  std::string_view str_;
+};
+
 /**
  * @brief HTTP头部编码，将字符串转换为HTTP头部安全的格式
  * 
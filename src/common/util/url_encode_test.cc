@@ -79,4 +79,30 @@ TEST(URL_ENCODE_TEST, UrlDecode_test) {
   }
 }
 
-}  // namespace aimrt::common::util
\ No newline at end of file
+TEST(URL_ENCODE_TEST, UrlDecodeView_test) {
+  std::vector<std::string> test_cases{
+      "",
+      "abc",
+      "a+b%20c",
+      "http%3A%2F%2Fabc123.com%2Faaa%3Fqa%3D1",
+      "http%3a%2f%2fabc123.com",
+      "tail%4",
+      "tail%",
+      "%41%42%43"};
+
+  for (size_t ii = 0; ii < test_cases.size(); ++ii) {
+    const auto& str = test_cases[ii];
+    UrlDecodeView view(str);
+
+    auto want_result = UrlDecode(str);
+    EXPECT_EQ(view.ToString(), want_result) << "index " << ii;
+    EXPECT_EQ(view.size(), want_result.size()) << "index " << ii;
+    EXPECT_TRUE(view == want_result) << "index " << ii;
+    EXPECT_FALSE(view == want_result + "x") << "index " << ii;
+  }
+
+  EXPECT_TRUE(UrlDecodeView("abc").IsIdentity());
+  EXPECT_FALSE(UrlDecodeView("a+b").IsIdentity());
+}
+
+}  // namespace aimrt::common::util
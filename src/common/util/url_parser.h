@@ -3,17 +3,21 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <optional>
-#include <regex>
-#include <sstream>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+
+#include "util/flat_hash_map.h"
 
 namespace aimrt::common::util {
 
 /**
  * @brief URL结构体，用于存储URL的各个组成部分
  * @details 将URL分解为协议、主机名、端口、路径、查询参数和片段等组成部分
- * 
+ *
  * @tparam StringType 字符串类型，默认为std::string
  */
 template <class StringType = std::string>
@@ -28,68 +32,170 @@ struct Url {
 
 /**
  * @brief 解析URL字符串为URL结构体
- * @details 使用正则表达式将URL字符串解析为各个组成部分，支持标准URL格式
- * 
+ * @details 单次扫描，结果与正则 ^(([^:\/?#]+)://)?(([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))? 的匹配结果一致。
+ * StringType为std::string_view时不分配内存，各组成部分指向url_str，使用期间url_str必须有效
+ *
  * @tparam StringType 字符串类型，默认为std::string
  * @param url_str 需要解析的URL字符串
  * @return std::optional<Url<StringType>> 解析成功返回URL结构体，失败返回std::nullopt
  */
 template <class StringType = std::string>
-std::optional<Url<StringType>> ParseUrl(const std::string& url_str) {
-  std::regex url_regex(
-      R"(^(([^:\/?#]+)://)?(([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)",
-      std::regex::ECMAScript);
-  std::match_results<std::string::const_iterator> url_match_result;
+std::optional<Url<StringType>> ParseUrl(std::string_view url_str) {
+  Url<StringType> url;
 
-  if (!std::regex_match(url_str.begin(), url_str.end(), url_match_result, url_regex))
-    return std::nullopt;
+  // 协议：第一个':'、'/'、'?'、'#'是"://"中的':'，且前面非空
+  size_t pos = url_str.find_first_of(":/?#");
+  if (pos != std::string_view::npos && pos > 0 && url_str.substr(pos, 3) == "://") {
+    url.protocol = StringType(url_str.substr(0, pos));
+    pos += 3;
+  } else {
+    pos = 0;
+  }
 
-  Url<StringType> url;
-  if (url_match_result[2].matched)
-    url.protocol = StringType(url_match_result[2].str());
-  if (url_match_result[4].matched) {
-    StringType auth(url_match_result[4].str());
-    size_t pos = auth.find_first_of(':');
-    if (pos != StringType::npos) {
-      url.host = auth.substr(0, pos);
-      url.service = auth.substr(pos + 1);
-    } else {
-      url.host = auth;
-    }
+  // 主机与端口，以第一个':'分隔
+  size_t end_pos = url_str.find_first_of("/?#", pos);
+  if (end_pos == std::string_view::npos) end_pos = url_str.size();
+
+  auto auth = url_str.substr(pos, end_pos - pos);
+  size_t colon_pos = auth.find(':');
+  if (colon_pos != std::string_view::npos) {
+    url.host = StringType(auth.substr(0, colon_pos));
+    url.service = StringType(auth.substr(colon_pos + 1));
+  } else {
+    url.host = StringType(auth);
   }
-  if (url_match_result[5].matched)
-    url.path = StringType(url_match_result[5].str());
-  if (url_match_result[7].matched)
-    url.query = StringType(url_match_result[7].str());
-  if (url_match_result[9].matched)
-    url.fragment = StringType(url_match_result[9].str());
-
-  return std::optional<Url<StringType>>{url};
+  pos = end_pos;
+
+  end_pos = url_str.find_first_of("?#", pos);
+  if (end_pos == std::string_view::npos) end_pos = url_str.size();
+  url.path = StringType(url_str.substr(pos, end_pos - pos));
+  pos = end_pos;
+
+  if (pos < url_str.size() && url_str[pos] == '?') {
+    end_pos = url_str.find('#', pos + 1);
+    if (end_pos == std::string_view::npos) end_pos = url_str.size();
+    url.query = StringType(url_str.substr(pos + 1, end_pos - pos - 1));
+    pos = end_pos;
+  }
+
+  if (pos < url_str.size())
+    url.fragment = StringType(url_str.substr(pos + 1));
+
+  return std::optional<Url<StringType>>{std::move(url)};
 }
 
 /**
  * @brief 将URL结构体转换为URL字符串
  * @details 根据URL结构体中的各个组成部分，按照标准URL格式拼接成完整的URL字符串
- * 
+ *
  * @tparam StringType 字符串类型，默认为std::string
  * @param url URL结构体，包含URL的各个组成部分
  * @return std::string 拼接后的完整URL字符串
  */
 template <class StringType = std::string>
 std::string JoinUrl(const Url<StringType>& url) {
-  std::stringstream ss;
+  std::string ret;
+  ret.reserve(url.protocol.size() + url.host.size() + url.service.size() +
+              url.path.size() + url.query.size() + url.fragment.size() + 8);
 
-  if (!url.protocol.empty()) ss << url.protocol << "://";
-  if (!url.host.empty()) ss << url.host;
-  if (!url.service.empty()) ss << ":" << url.service;
+  if (!url.protocol.empty()) ret.append(url.protocol).append("://");
+  if (!url.host.empty()) ret.append(url.host);
+  if (!url.service.empty()) ret.append(":").append(url.service);
   if (!url.path.empty()) {
-    if (url.path[0] != '/') ss << '/';
-    ss << url.path;
+    if (url.path[0] != '/') ret += '/';
+    ret.append(url.path);
   }
-  if (!url.query.empty()) ss << '?' << url.query;
-  if (!url.fragment.empty()) ss << '#' << url.fragment;
+  if (!url.query.empty()) ret.append("?").append(url.query);
+  if (!url.fragment.empty()) ret.append("#").append(url.fragment);
 
-  return ss.str();
+  return ret;
 }
 
-}  // namespace aimrt::common::util
\ No newline at end of file
+/**
+ * @brief 驻留的URL，持有URL字符串，各组成部分指向自身持有的字符串
+ * @details 不可拷贝、不可移动，通过Create或UrlCache获取的共享指针使用
+ */
+class InternedUrl {
+ public:
+  /**
+   * @brief 创建驻留的URL
+   * @param url_str 地址字符串
+   * @return 解析失败时返回空指针
+   */
+  static std::shared_ptr<const InternedUrl> Create(std::string_view url_str) {
+    std::shared_ptr<const InternedUrl> url_ptr(new InternedUrl(url_str));
+    if (!url_ptr->url_) return nullptr;
+    return url_ptr;
+  }
+
+  InternedUrl(const InternedUrl&) = delete;
+  InternedUrl& operator=(const InternedUrl&) = delete;
+
+  const std::string& Str() const { return str_; }
+  const Url<std::string_view>& Get() const { return *url_; }
+  const Url<std::string_view>* operator->() const { return &(*url_); }
+
+ private:
+  explicit InternedUrl(std::string_view url_str)
+      : str_(url_str), url_(ParseUrl<std::string_view>(str_)) {}
+
+  const std::string str_;
+  const std::optional<Url<std::string_view>> url_;
+};
+
+/**
+ * @brief 已解析地址的缓存
+ * @details 同一地址只解析、校验一次，之后的查询只有一次读锁下的哈希查找。
+ * 校验失败的地址不缓存；缓存条目数达到上限后不再缓存新地址，但仍返回解析结果，避免任意地址撑大缓存
+ */
+class UrlCache {
+ public:
+  using UrlPtr = std::shared_ptr<const InternedUrl>;
+  using Validator = std::function<bool(const Url<std::string_view>&)>;
+
+  explicit UrlCache(size_t max_size = 1024, Validator validator = Validator())
+      : max_size_(max_size), validator_(std::move(validator)) {}
+
+  UrlCache(const UrlCache&) = delete;
+  UrlCache& operator=(const UrlCache&) = delete;
+
+  /**
+   * @brief 获取地址的解析结果
+   * @param url_str 地址字符串
+   * @return 解析或校验失败时返回空指针
+   */
+  UrlPtr Get(std::string_view url_str) {
+    {
+      std::shared_lock<std::shared_mutex> lck(mutex_);
+      auto find_itr = url_map_.find(url_str);
+      if (find_itr != url_map_.end()) return find_itr->second;
+    }
+
+    auto url_ptr = InternedUrl::Create(url_str);
+    if (!url_ptr || (validator_ && !validator_(url_ptr->Get()))) return UrlPtr();
+
+    std::unique_lock<std::shared_mutex> lck(mutex_);
+    if (url_map_.size() >= max_size_) return url_ptr;
+
+    return url_map_.emplace(url_ptr->Str(), url_ptr).first->second;
+  }
+
+  size_t Size() const {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    return url_map_.size();
+  }
+
+  void Clear() {
+    std::unique_lock<std::shared_mutex> lck(mutex_);
+    url_map_.clear();
+  }
+
+ private:
+  const size_t max_size_;
+  const Validator validator_;
+
+  mutable std::shared_mutex mutex_;
+  FlatHashMap<std::string, UrlPtr> url_map_;
+};
+
+}  // namespace aimrt::common::util
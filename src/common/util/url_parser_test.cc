@@ -3,10 +3,53 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <thread>
+
 #include "util/url_parser.h"
 
 namespace aimrt::common::util {
 
+namespace {
+
+// 基于正则的原实现，作为模糊测试的参照
+std::optional<Url<std::string>> RegexParseUrl(const std::string& url_str) {
+  static const std::regex url_regex(
+      R"(^(([^:\/?#]+)://)?(([^\/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?)",
+      std::regex::ECMAScript);
+  std::match_results<std::string::const_iterator> url_match_result;
+
+  if (!std::regex_match(url_str.begin(), url_str.end(), url_match_result, url_regex))
+    return std::nullopt;
+
+  Url<std::string> url;
+  if (url_match_result[2].matched)
+    url.protocol = url_match_result[2].str();
+  if (url_match_result[4].matched) {
+    std::string auth(url_match_result[4].str());
+    size_t pos = auth.find_first_of(':');
+    if (pos != std::string::npos) {
+      url.host = auth.substr(0, pos);
+      url.service = auth.substr(pos + 1);
+    } else {
+      url.host = auth;
+    }
+  }
+  if (url_match_result[5].matched)
+    url.path = url_match_result[5].str();
+  if (url_match_result[7].matched)
+    url.query = url_match_result[7].str();
+  if (url_match_result[9].matched)
+    url.fragment = url_match_result[9].str();
+
+  return url;
+}
+
+}  // namespace
+
 template <class StringType>
 void TestJoinUrl() {
   struct TestCase {
@@ -168,4 +211,97 @@ TEST(URL_PARSER_TEST, ParseUrl) {
   TestParseUrl<std::string_view>();
 }
 
-}  // namespace aimrt::common::util
\ No newline at end of file
+TEST(URL_PARSER_TEST, ParseUrlFuzz) {
+  // 只使用URL中有意义的分隔符和少量普通字符，提高命中各种边界组合的概率；不含换行，正则的'.'不匹配换行
+  constexpr std::string_view kAlphabet = ":/?#&=a1.%+ ";
+
+  std::mt19937 gen(20231018);
+  std::uniform_int_distribution<size_t> len_dist(0, 24);
+  std::uniform_int_distribution<size_t> char_dist(0, kAlphabet.size() - 1);
+
+  for (int ii = 0; ii < 20000; ++ii) {
+    std::string url_str(len_dist(gen), ' ');
+    for (auto& c : url_str) c = kAlphabet[char_dist(gen)];
+
+    auto want_result = RegexParseUrl(url_str);
+    auto ret = ParseUrl<std::string_view>(url_str);
+
+    ASSERT_EQ(static_cast<bool>(ret), static_cast<bool>(want_result)) << url_str;
+    if (!ret) continue;
+
+    ASSERT_EQ(ret->protocol, want_result->protocol) << url_str;
+    ASSERT_EQ(ret->host, want_result->host) << url_str;
+    ASSERT_EQ(ret->service, want_result->service) << url_str;
+    ASSERT_EQ(ret->path, want_result->path) << url_str;
+    ASSERT_EQ(ret->query, want_result->query) << url_str;
+    ASSERT_EQ(ret->fragment, want_result->fragment) << url_str;
+
+    // string_view的结果指向原字符串
+    if (!ret->path.empty()) {
+      ASSERT_GE(ret->path.data(), url_str.data());
+      ASSERT_LE(ret->path.data() + ret->path.size(), url_str.data() + url_str.size());
+    }
+  }
+}
+
+TEST(URL_PARSER_TEST, UrlCache) {
+  UrlCache cache(2, [](const Url<std::string_view>& url) { return url.protocol == "local"; });
+
+  auto url_ptr = cache.Get("local://rpc/Foo?pkg_path=a&module_name=b");
+  ASSERT_TRUE(url_ptr);
+  EXPECT_EQ((*url_ptr)->protocol, "local");
+  EXPECT_EQ((*url_ptr)->query, "pkg_path=a&module_name=b");
+  EXPECT_EQ(url_ptr.get(), cache.Get(std::string("local://rpc/Foo?pkg_path=a&module_name=b")).get());
+
+  // 校验失败的地址不缓存
+  EXPECT_FALSE(cache.Get("http://rpc/Foo"));
+  EXPECT_EQ(cache.Size(), 1);
+
+  // 超过上限后仍返回解析结果，但不再缓存
+  EXPECT_TRUE(cache.Get("local://rpc/Bar"));
+  auto extra_ptr = cache.Get("local://rpc/Baz");
+  ASSERT_TRUE(extra_ptr);
+  EXPECT_EQ((*extra_ptr)->path, "/Baz");
+  EXPECT_EQ(cache.Size(), 2);
+
+  // 多线程并发查询
+  std::vector<std::thread> threads;
+  for (int ii = 0; ii < 4; ++ii) {
+    threads.emplace_back([&cache]() {
+      for (int jj = 0; jj < 1000; ++jj)
+        EXPECT_EQ(cache.Get("local://rpc/Bar")->Get().host, "rpc");
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(URL_PARSER_TEST, PerformanceTest) {
+  const std::string url_str = "local://rpc/pb:/aimrt.protocols.example.ExampleService/GetFooData?pkg_path=/opt/pkg/libexample.so&module_name=NormalRpcServerModule";
+  constexpr int kLoopNum = 100000;
+
+  auto measure = [&](auto&& func) {
+    auto start = std::chrono::steady_clock::now();
+    size_t sum = 0;
+    for (int ii = 0; ii < kLoopNum; ++ii) sum += func();
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_GT(sum, 0);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / kLoopNum;
+  };
+
+  auto regex_ns = measure([&]() { return RegexParseUrl(url_str)->query.size(); });
+  auto string_ns = measure([&]() { return ParseUrl<std::string>(url_str)->query.size(); });
+  auto view_ns = measure([&]() { return ParseUrl<std::string_view>(url_str)->query.size(); });
+
+  UrlCache cache;
+  auto cache_ns = measure([&]() { return cache.Get(url_str)->Get().query.size(); });
+
+  std::cout << "\nParseUrl performance (ns/op): regex " << regex_ns
+            << ", std::string " << string_ns
+            << ", std::string_view " << view_ns
+            << ", cached " << cache_ns << std::endl;
+}
+
+}  // namespace aimrt::common::util
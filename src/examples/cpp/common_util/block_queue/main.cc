@@ -19,9 +19,10 @@ void blocktest() {
   });
 
   threads.emplace_back([&]() {
+    int item = 0;
     for (int i = 0; i < 5; ++i) {
-      auto item = queue.Dequeue();
-      std::cout << "Enqueue item" << item << std::endl;
+      if (queue.Dequeue(&item) != BlockQueueStatus::kOk) break;
+      std::cout << "Dequeue item " << item << std::endl;
     }
   });
 
@@ -0,0 +1,98 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Usage statistics of the scratch arena of the calling thread
+ *
+ */
+typedef struct {
+  /// Bytes currently allocated in open frames
+  size_t bytes_in_use;
+
+  /// Maximum of bytes_in_use ever reached
+  size_t high_water;
+
+  /// Total size of all chunks
+  size_t capacity;
+
+  /// Number of chunks
+  size_t chunk_count;
+
+  /// Number of open frames
+  size_t frame_depth;
+
+  /// Size of the buffer returned by get_thread_local_buf
+  size_t persistent_capacity;
+
+  /// Number of allocate calls
+  uint64_t alloc_count;
+
+  /// Number of chunks requested from the system
+  uint64_t chunk_alloc_count;
+
+  /// Number of times memory was trimmed
+  uint64_t trim_count;
+} aimrt_scratch_arena_stats_t;
+
+/**
+ * @brief Thread local scratch arena interface
+ * @note
+ * 1. Every thread has its own arena, all functions act on the arena of the calling thread
+ * 2. Memory is allocated inside stack-like frames and is released all at once when the frame is popped
+ * 3. Memory allocated in a frame never moves, and there is no upper limit of size
+ */
+typedef struct {
+  /**
+   * @brief Function to open a frame
+   *
+   * Parameter definition:
+   * Input 1: Pointer to impl
+   * Output: Frame id, used by pop_frame
+   */
+  size_t (*push_frame)(void* impl);
+
+  /**
+   * @brief Function to close a frame and all frames opened after it
+   *
+   * Parameter definition:
+   * Input 1: Pointer to impl
+   * Input 2: Frame id returned by push_frame
+   */
+  void (*pop_frame)(void* impl, size_t frame);
+
+  /**
+   * @brief Function to allocate memory in the innermost open frame
+   *
+   * Parameter definition:
+   * Input 1: Pointer to impl
+   * Input 2: Size of memory
+   * Input 3: Alignment, must be a power of 2
+   * Output: Pointer to memory, NULL if no frame is open or allocation failed
+   */
+  void* (*allocate)(void* impl, size_t size, size_t align);
+
+  /**
+   * @brief Function to get statistics of the arena of the calling thread
+   *
+   * Parameter definition:
+   * Input 1: Pointer to impl
+   * Input 2: Pointer to statistics to fill
+   */
+  void (*get_stats)(void* impl, aimrt_scratch_arena_stats_t* stats);
+
+  /// Implement pointer
+  void* impl;
+} aimrt_scratch_arena_base_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,68 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <stddef.h>
+
+#include "aimrt_module_c_interface/util/buffer_base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Reference counting operations of a shared buffer storage
+ * @note
+ * A storage is an immutable memory block, it is freed when the last reference is released
+ */
+typedef struct {
+  /**
+   * @brief Function to add a reference to the storage
+   *
+   * Parameter definition:
+   * Input 1: Pointer to storage impl
+   */
+  void (*add_ref)(void* impl);
+
+  /**
+   * @brief Function to release a reference to the storage
+   *
+   * Parameter definition:
+   * Input 1: Pointer to storage impl
+   */
+  void (*release)(void* impl);
+} aimrt_shared_buffer_storage_ops_t;
+
+/**
+ * @brief Shared buffer slice, a range of data inside a storage
+ *
+ */
+typedef struct {
+  /// Const pointer to reference counting operations of the storage
+  const aimrt_shared_buffer_storage_ops_t* ops;
+
+  /// Pointer to storage impl
+  void* impl;
+
+  /// Data of the slice, must lie within the storage
+  aimrt_buffer_view_t view;
+} aimrt_shared_buffer_slice_t;
+
+/**
+ * @brief Shared buffer, an immutable chain of slices
+ * @note
+ * 1. The slices are borrowed for the duration of a call
+ * 2. A callee that wants to keep the data after the call must call add_ref on every slice it keeps
+ */
+typedef struct {
+  /// Const pointer to slice array
+  const aimrt_shared_buffer_slice_t* data;
+
+  /// Length of slice array
+  size_t len;
+} aimrt_shared_buffer_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+
+#include "aimrt_module_c_interface/allocator/scratch_arena_base.h"
+#include "util/exception.h"
+
+namespace aimrt::allocator {
+
+/**
+ * @brief 线程内临时内存arena的引用
+ * @note 基础组件，优先保障性能，请自行对base_ptr合法性做检验
+ *
+ */
+class ScratchArenaRef {
+ public:
+  ScratchArenaRef() = default;
+  explicit ScratchArenaRef(const aimrt_scratch_arena_base_t* base_ptr)
+      : base_ptr_(base_ptr) {}
+  ~ScratchArenaRef() = default;
+
+  explicit operator bool() const { return (base_ptr_ != nullptr); }
+
+  const aimrt_scratch_arena_base_t* NativeHandle() const { return base_ptr_; }
+
+  size_t PushFrame() const {
+    AIMRT_ASSERT(base_ptr_, "Reference is null.");
+    return base_ptr_->push_frame(base_ptr_->impl);
+  }
+
+  void PopFrame(size_t frame) const {
+    AIMRT_ASSERT(base_ptr_, "Reference is null.");
+    base_ptr_->pop_frame(base_ptr_->impl, frame);
+  }
+
+  void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) const {
+    AIMRT_ASSERT(base_ptr_, "Reference is null.");
+    return base_ptr_->allocate(base_ptr_->impl, size, align);
+  }
+
+  aimrt_scratch_arena_stats_t GetStats() const {
+    AIMRT_ASSERT(base_ptr_, "Reference is null.");
+    aimrt_scratch_arena_stats_t stats{};
+    base_ptr_->get_stats(base_ptr_->impl, &stats);
+    return stats;
+  }
+
+ private:
+  const aimrt_scratch_arena_base_t* base_ptr_ = nullptr;
+};
+
+/**
+ * @brief 作用域帧，析构时归还帧内分配的全部内存，可嵌套
+ *
+ */
+class ScratchFrame {
+ public:
+  explicit ScratchFrame(ScratchArenaRef arena)
+      : arena_(arena), frame_(arena.PushFrame()) {}
+  ~ScratchFrame() { arena_.PopFrame(frame_); }
+
+  ScratchFrame(const ScratchFrame&) = delete;
+  ScratchFrame& operator=(const ScratchFrame&) = delete;
+
+  void* Allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    return arena_.Allocate(size, align);
+  }
+
+  template <class T>
+  T* AllocateArray(size_t n) {
+    return static_cast<T*>(arena_.Allocate(n * sizeof(T), alignof(T)));
+  }
+
+ private:
+  ScratchArenaRef arena_;
+  const size_t frame_;
+};
+
+}  // namespace aimrt::allocator
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "aimrt_module_c_interface/util/buffer_base.h"
+#include "aimrt_module_cpp_interface/util/shared_buffer.h"
 #include "aimrt_module_cpp_interface/util/simple_buffer_array_allocator.h"
 
 namespace aimrt::util {
@@ -83,6 +84,13 @@ class BufferArray {
     return result;
   }
 
+  /**
+   * @brief 把全部buffer的所有权转移给SharedBuffer,不拷贝数据,调用后本对象为空
+   */
+  SharedBuffer MoveToSharedBuffer() {
+    return SharedBuffer::Adopt(&buffer_array_, allocator_ptr_);
+  }
+
   std::string JoinToString() const {
     std::string result;
     for (size_t ii = 0; ii < buffer_array_.len; ++ii) {
@@ -160,6 +168,19 @@ class BufferArrayView {
     SyncCType();
   }
 
+  /**
+   * @brief 基于SharedBuffer构造,视图持有其引用,数据在视图析构前一直有效
+   */
+  explicit BufferArrayView(SharedBuffer shared_buffer)
+      : shared_buffer_(std::move(shared_buffer)) {
+    buffer_array_view_vec_.reserve(shared_buffer_.SliceNum());
+    shared_buffer_.ForEachSlice([this](const void* data, size_t len) {
+      buffer_array_view_vec_.emplace_back(aimrt_buffer_view_t{.data = data, .len = len});
+    });
+
+    SyncCType();
+  }
+
   ~BufferArrayView() = default;
 
   BufferArrayView(const BufferArrayView&) = delete;
@@ -192,6 +213,14 @@ class BufferArrayView {
     return result;
   }
 
+  /**
+   * @brief 取得共享数据的引用,基于SharedBuffer构造的视图不拷贝,其它视图拷贝一份
+   */
+  SharedBuffer Share() const {
+    if (!shared_buffer_.Empty() || buffer_array_view_.len == 0) return shared_buffer_;
+    return SharedBuffer::Copy(buffer_array_view_);
+  }
+
   std::vector<char> JoinToCharVector() const {
     std::vector<char> result;
     result.resize(BufferSize());
@@ -211,6 +240,7 @@ class BufferArrayView {
   }
 
  private:
+  SharedBuffer shared_buffer_;
   std::vector<aimrt_buffer_view_t> buffer_array_view_vec_;
 
   aimrt_buffer_array_view_t buffer_array_view_;
@@ -0,0 +1,389 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "aimrt_module_c_interface/util/shared_buffer_base.h"
+
+namespace aimrt::util {
+
+namespace shared_buffer_detail {
+
+/**
+ * @brief 引用计数的存储块头部,具体存储由destroy负责释放
+ */
+struct Storage {
+  std::atomic<uint32_t> ref_count{1};
+  void (*destroy)(Storage*) = nullptr;
+};
+
+inline const aimrt_shared_buffer_storage_ops_t* StorageOps() {
+  static constexpr aimrt_shared_buffer_storage_ops_t kStorageOps{
+      .add_ref = [](void* impl) {
+        static_cast<Storage*>(impl)->ref_count.fetch_add(1, std::memory_order_relaxed);
+      },
+      .release = [](void* impl) {
+        auto* storage = static_cast<Storage*>(impl);
+        if (storage->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+          storage->destroy(storage);
+      }};
+
+  return &kStorageOps;
+}
+
+/**
+ * @brief 头部与数据一次分配的存储块
+ */
+struct alignas(16) HeapStorage : Storage {
+  static HeapStorage* Create(size_t size) {
+    void* mem = ::operator new(sizeof(HeapStorage) + size);
+    auto* storage = new (mem) HeapStorage();
+    storage->destroy = [](Storage* ptr) {
+      auto* heap_storage = static_cast<HeapStorage*>(ptr);
+      heap_storage->~HeapStorage();
+      ::operator delete(static_cast<void*>(heap_storage));
+    };
+    return storage;
+  }
+
+  char* Data() { return reinterpret_cast<char*>(this + 1); }
+};
+
+/**
+ * @brief 接管aimrt_buffer_array_t中全部buffer的存储块,通过其分配器释放
+ */
+struct BufferArrayStorage : Storage {
+  aimrt_buffer_array_t buffer_array;
+  const aimrt_buffer_array_allocator_t* allocator;
+
+  BufferArrayStorage(aimrt_buffer_array_t array, const aimrt_buffer_array_allocator_t* alloc)
+      : buffer_array(array), allocator(alloc) {
+    destroy = [](Storage* ptr) {
+      auto* storage = static_cast<BufferArrayStorage*>(ptr);
+      storage->allocator->release(storage->allocator->impl, &(storage->buffer_array));
+      delete storage;
+    };
+  }
+};
+
+}  // namespace shared_buffer_detail
+
+/**
+ * @brief 不可变、引用计数的共享buffer
+ * @note
+ * 1. 由若干片段(slice)串成,每个片段引用一个存储块中的一段数据,拷贝SharedBuffer只增加引用计数
+ * 2. Slice/Append只操作片段,不拷贝数据
+ * 3. 通过NativeHandle以aimrt_shared_buffer_t形式跨C接口传递,接收方可用其构造SharedBuffer以持有数据
+ * 4. 数据在创建后不可修改,可以在多个线程中同时读取;同一个SharedBuffer对象本身的修改需外部同步
+ */
+class SharedBuffer {
+ public:
+  SharedBuffer() = default;
+
+  /**
+   * @brief 从C接口类型构造,为每个片段增加一个引用
+   */
+  explicit SharedBuffer(aimrt_shared_buffer_t buffer) {
+    Reserve(buffer.len);
+    for (size_t ii = 0; ii < buffer.len; ++ii) {
+      const aimrt_shared_buffer_slice_t& slice = buffer.data[ii];
+      slice.ops->add_ref(slice.impl);
+      PushSlice(slice);
+    }
+  }
+
+  ~SharedBuffer() { Reset(); }
+
+  SharedBuffer(const SharedBuffer& other) {
+    Reserve(other.len_);
+    for (size_t ii = 0; ii < other.len_; ++ii) {
+      const aimrt_shared_buffer_slice_t& slice = other.Slices()[ii];
+      slice.ops->add_ref(slice.impl);
+      PushSlice(slice);
+    }
+  }
+
+  SharedBuffer(SharedBuffer&& other) noexcept { Swap(other); }
+
+  SharedBuffer& operator=(const SharedBuffer& other) {
+    if (this != &other) {
+      SharedBuffer tmp(other);
+      Swap(tmp);
+    }
+    return *this;
+  }
+
+  SharedBuffer& operator=(SharedBuffer&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      Swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief 分配len字节的存储并由fill填充,fill形如void(void* data),len为0时返回空buffer
+   */
+  template <class F>
+  static SharedBuffer Create(size_t len, F&& fill) {
+    if (len == 0) return SharedBuffer();
+
+    auto* storage = shared_buffer_detail::HeapStorage::Create(len);
+    fill(static_cast<void*>(storage->Data()));
+
+    SharedBuffer result;
+    result.PushSlice(aimrt_shared_buffer_slice_t{
+        .ops = shared_buffer_detail::StorageOps(),
+        .impl = static_cast<shared_buffer_detail::Storage*>(storage),
+        .view = aimrt_buffer_view_t{.data = storage->Data(), .len = len}});
+    return result;
+  }
+
+  /**
+   * @brief 拷贝一段数据
+   */
+  static SharedBuffer Copy(const void* data, size_t len) {
+    return Create(len, [data, len](void* dst) {
+      if (len) memcpy(dst, data, len);
+    });
+  }
+
+  /**
+   * @brief 把多段数据拷贝到一块连续存储中
+   */
+  static SharedBuffer Copy(aimrt_buffer_array_view_t buffer_array_view) {
+    size_t len = 0;
+    for (size_t ii = 0; ii < buffer_array_view.len; ++ii) len += buffer_array_view.data[ii].len;
+
+    return Create(len, [&buffer_array_view](void* dst) {
+      char* cur_pos = static_cast<char*>(dst);
+      for (size_t ii = 0; ii < buffer_array_view.len; ++ii) {
+        if (buffer_array_view.data[ii].len == 0) continue;
+        memcpy(cur_pos, buffer_array_view.data[ii].data, buffer_array_view.data[ii].len);
+        cur_pos += buffer_array_view.data[ii].len;
+      }
+    });
+  }
+
+  /**
+   * @brief 接管buffer array中的全部buffer,不拷贝数据
+   * @note 调用后buffer_array被置空,其中的buffer在最后一个引用释放时通过allocator释放
+   */
+  static SharedBuffer Adopt(aimrt_buffer_array_t* buffer_array, const aimrt_buffer_array_allocator_t* allocator) {
+    SharedBuffer result;
+    if (buffer_array->len == 0) {
+      allocator->release(allocator->impl, buffer_array);
+      *buffer_array = aimrt_buffer_array_t{.data = nullptr, .len = 0, .capacity = 0};
+      return result;
+    }
+
+    auto* storage = new shared_buffer_detail::BufferArrayStorage(*buffer_array, allocator);
+    *buffer_array = aimrt_buffer_array_t{.data = nullptr, .len = 0, .capacity = 0};
+
+    const aimrt_buffer_array_t& array = storage->buffer_array;
+    result.Reserve(array.len);
+    for (size_t ii = 0; ii < array.len; ++ii) {
+      if (array.data[ii].len == 0) continue;
+      if (result.len_ != 0) storage->ref_count.fetch_add(1, std::memory_order_relaxed);
+      result.PushSlice(aimrt_shared_buffer_slice_t{
+          .ops = shared_buffer_detail::StorageOps(),
+          .impl = static_cast<shared_buffer_detail::Storage*>(storage),
+          .view = aimrt_buffer_view_t{.data = array.data[ii].data, .len = array.data[ii].len}});
+    }
+
+    // 全部buffer都为空
+    if (result.len_ == 0) shared_buffer_detail::StorageOps()->release(static_cast<shared_buffer_detail::Storage*>(storage));
+    return result;
+  }
+
+  /**
+   * @brief 以C接口类型借出,有效期不超过本对象的生命周期且期间本对象不被修改
+   */
+  aimrt_shared_buffer_t NativeHandle() const {
+    return aimrt_shared_buffer_t{.data = Slices(), .len = len_};
+  }
+
+  /// 数据总字节数
+  size_t Size() const { return size_; }
+
+  bool Empty() const { return size_ == 0; }
+
+  /// 片段个数
+  size_t SliceNum() const { return len_; }
+
+  const aimrt_shared_buffer_slice_t* Slices() const {
+    return (len_ <= kInlineSliceNum) ? inline_slices_ : heap_slices_.data();
+  }
+
+  /// 数据是否连续
+  bool IsContiguous() const { return len_ <= 1; }
+
+  /// 连续数据的起始地址,不连续或为空时返回nullptr
+  const void* Data() const { return (len_ == 1) ? Slices()[0].view.data : nullptr; }
+
+  /**
+   * @brief 依次访问每个片段,f形如void(const void* data, size_t len),用于scatter-gather写出
+   */
+  template <class F>
+  void ForEachSlice(F&& f) const {
+    const aimrt_shared_buffer_slice_t* slices = Slices();
+    for (size_t ii = 0; ii < len_; ++ii) f(slices[ii].view.data, slices[ii].view.len);
+  }
+
+  /**
+   * @brief 以aimrt_buffer_view_t数组的形式导出各片段,用于反序列化接口
+   */
+  std::vector<aimrt_buffer_view_t> ToBufferViews() const {
+    std::vector<aimrt_buffer_view_t> result;
+    result.reserve(len_);
+    ForEachSlice([&result](const void* data, size_t len) {
+      result.emplace_back(aimrt_buffer_view_t{.data = data, .len = len});
+    });
+    return result;
+  }
+
+  /**
+   * @brief 取[offset, offset + len)范围,不拷贝数据,越界部分被截断
+   */
+  SharedBuffer Slice(size_t offset, size_t len = static_cast<size_t>(-1)) const {
+    SharedBuffer result;
+    if (offset >= size_) return result;
+    if (len > size_ - offset) len = size_ - offset;
+
+    const aimrt_shared_buffer_slice_t* slices = Slices();
+    for (size_t ii = 0; ii < len_ && len != 0; ++ii) {
+      const aimrt_shared_buffer_slice_t& slice = slices[ii];
+      if (offset >= slice.view.len) {
+        offset -= slice.view.len;
+        continue;
+      }
+
+      const size_t cur_len = std::min(len, slice.view.len - offset);
+      slice.ops->add_ref(slice.impl);
+      result.PushSlice(aimrt_shared_buffer_slice_t{
+          .ops = slice.ops,
+          .impl = slice.impl,
+          .view = aimrt_buffer_view_t{
+              .data = static_cast<const char*>(slice.view.data) + offset,
+              .len = cur_len}});
+      offset = 0;
+      len -= cur_len;
+    }
+    return result;
+  }
+
+  /**
+   * @brief 在末尾串接另一个SharedBuffer,不拷贝数据;与末尾片段在同一存储中相邻时合并
+   */
+  void Append(const SharedBuffer& other) {
+    const aimrt_shared_buffer_slice_t* slices = other.Slices();
+    const size_t other_len = other.len_;
+    for (size_t ii = 0; ii < other_len; ++ii) {
+      const aimrt_shared_buffer_slice_t& slice = slices[ii];
+      if (len_ != 0) {
+        aimrt_shared_buffer_slice_t& last = MutableSlices()[len_ - 1];
+        if (last.impl == slice.impl && last.ops == slice.ops &&
+            static_cast<const char*>(last.view.data) + last.view.len == slice.view.data) {
+          last.view.len += slice.view.len;
+          size_ += slice.view.len;
+          continue;
+        }
+      }
+      slice.ops->add_ref(slice.impl);
+      PushSlice(slice);
+    }
+  }
+
+  /**
+   * @brief 从offset处拷贝至多len字节到dst
+   *
+   * @return size_t 实际拷贝的字节数
+   */
+  size_t CopyTo(void* dst, size_t len, size_t offset = 0) const {
+    size_t copied = 0;
+    const aimrt_shared_buffer_slice_t* slices = Slices();
+    for (size_t ii = 0; ii < len_ && copied < len; ++ii) {
+      const aimrt_buffer_view_t& view = slices[ii].view;
+      if (offset >= view.len) {
+        offset -= view.len;
+        continue;
+      }
+      const size_t cur_len = std::min(len - copied, view.len - offset);
+      memcpy(static_cast<char*>(dst) + copied, static_cast<const char*>(view.data) + offset, cur_len);
+      copied += cur_len;
+      offset = 0;
+    }
+    return copied;
+  }
+
+  /**
+   * @brief 返回数据连续的SharedBuffer,本身已连续时不拷贝
+   */
+  SharedBuffer Flatten() const {
+    if (IsContiguous()) return *this;
+    return Create(size_, [this](void* dst) { CopyTo(dst, size_); });
+  }
+
+  std::string JoinToString() const {
+    std::string result(size_, '\0');
+    CopyTo(result.data(), size_);
+    return result;
+  }
+
+  void Reset() {
+    aimrt_shared_buffer_slice_t* slices = MutableSlices();
+    for (size_t ii = 0; ii < len_; ++ii) slices[ii].ops->release(slices[ii].impl);
+    len_ = 0;
+    size_ = 0;
+    heap_slices_.clear();
+  }
+
+  void Swap(SharedBuffer& other) noexcept {
+    std::swap(inline_slices_, other.inline_slices_);
+    heap_slices_.swap(other.heap_slices_);
+    std::swap(len_, other.len_);
+    std::swap(size_, other.size_);
+  }
+
+ private:
+  // 大多数序列化结果只有一两个片段,不额外分配
+  static constexpr size_t kInlineSliceNum = 2;
+
+  aimrt_shared_buffer_slice_t* MutableSlices() {
+    return (len_ <= kInlineSliceNum) ? inline_slices_ : heap_slices_.data();
+  }
+
+  void Reserve(size_t n) {
+    if (n > kInlineSliceNum) heap_slices_.reserve(n);
+  }
+
+  /**
+   * @brief 追加一个片段,接管其一个引用
+   */
+  void PushSlice(const aimrt_shared_buffer_slice_t& slice) {
+    if (len_ < kInlineSliceNum) {
+      inline_slices_[len_] = slice;
+    } else {
+      if (len_ == kInlineSliceNum) heap_slices_.assign(inline_slices_, inline_slices_ + kInlineSliceNum);
+      heap_slices_.emplace_back(slice);
+    }
+    ++len_;
+    size_ += slice.view.len;
+  }
+
+  aimrt_shared_buffer_slice_t inline_slices_[kInlineSliceNum] = {};
+  std::vector<aimrt_shared_buffer_slice_t> heap_slices_;
+  size_t len_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace aimrt::util
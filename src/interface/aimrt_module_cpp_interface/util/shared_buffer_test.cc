@@ -0,0 +1,189 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "aimrt_module_cpp_interface/util/buffer.h"
+#include "aimrt_module_cpp_interface/util/shared_buffer.h"
+
+namespace aimrt::util {
+
+namespace {
+
+// 通过C接口提供的外部存储,用于检查引用计数
+struct ExternalStorage {
+  std::atomic<int> ref_count{1};
+  bool released = false;
+  std::string data;
+};
+
+const aimrt_shared_buffer_storage_ops_t kExternalStorageOps{
+    .add_ref = [](void* impl) { static_cast<ExternalStorage*>(impl)->ref_count.fetch_add(1); },
+    .release = [](void* impl) {
+      auto* storage = static_cast<ExternalStorage*>(impl);
+      if (storage->ref_count.fetch_sub(1) == 1) storage->released = true;
+    }};
+
+}  // namespace
+
+TEST(SHARED_BUFFER_TEST, CopyAndShare) {
+  const std::string str = "hello shared buffer";
+  SharedBuffer buffer = SharedBuffer::Copy(str.data(), str.size());
+  EXPECT_EQ(buffer.Size(), str.size());
+  EXPECT_EQ(buffer.SliceNum(), 1);
+  EXPECT_TRUE(buffer.IsContiguous());
+  EXPECT_EQ(buffer.JoinToString(), str);
+
+  // 拷贝只共享数据
+  SharedBuffer copy = buffer;
+  EXPECT_EQ(copy.Data(), buffer.Data());
+
+  SharedBuffer moved = std::move(copy);
+  EXPECT_TRUE(copy.Empty());
+  EXPECT_EQ(moved.Data(), buffer.Data());
+
+  buffer.Reset();
+  EXPECT_EQ(moved.JoinToString(), str);
+
+  EXPECT_TRUE(SharedBuffer::Copy(nullptr, 0).Empty());
+  EXPECT_EQ(SharedBuffer::Copy(nullptr, 0).SliceNum(), 0);
+}
+
+TEST(SHARED_BUFFER_TEST, SliceAndAppend) {
+  const std::string str = "0123456789";
+  SharedBuffer buffer = SharedBuffer::Copy(str.data(), str.size());
+
+  SharedBuffer mid = buffer.Slice(2, 5);
+  EXPECT_EQ(mid.JoinToString(), "23456");
+  EXPECT_EQ(mid.Data(), static_cast<const char*>(buffer.Data()) + 2);
+  EXPECT_EQ(buffer.Slice(8).JoinToString(), "89");
+  EXPECT_EQ(buffer.Slice(8, 100).JoinToString(), "89");
+  EXPECT_TRUE(buffer.Slice(10).Empty());
+
+  // 同一存储中相邻的片段合并
+  SharedBuffer joined = buffer.Slice(0, 3);
+  joined.Append(buffer.Slice(3, 4));
+  EXPECT_EQ(joined.SliceNum(), 1);
+  EXPECT_EQ(joined.JoinToString(), "0123456");
+
+  // 不同存储串成rope
+  const std::string str2 = "abcdef";
+  SharedBuffer rope = buffer.Slice(0, 4);
+  rope.Append(SharedBuffer::Copy(str2.data(), str2.size()));
+  rope.Append(buffer.Slice(6));
+  rope.Append(SharedBuffer::Copy(str2.data(), 2));
+  EXPECT_EQ(rope.SliceNum(), 4);
+  EXPECT_FALSE(rope.IsContiguous());
+  EXPECT_EQ(rope.Data(), nullptr);
+  EXPECT_EQ(rope.JoinToString(), "0123abcdef6789ab");
+
+  // 跨片段切片
+  EXPECT_EQ(rope.Slice(2, 6).JoinToString(), "23abcd");
+  EXPECT_EQ(rope.Slice(2, 6).SliceNum(), 2);
+  EXPECT_EQ(rope.Slice(9, 5).JoinToString(), "f6789");
+
+  // scatter-gather
+  std::vector<size_t> lens;
+  rope.ForEachSlice([&lens](const void*, size_t len) { lens.emplace_back(len); });
+  EXPECT_EQ(lens, (std::vector<size_t>{4, 6, 4, 2}));
+  EXPECT_EQ(rope.ToBufferViews().size(), 4);
+
+  char dst[8];
+  EXPECT_EQ(rope.CopyTo(dst, sizeof(dst), 3), sizeof(dst));
+  EXPECT_EQ(std::string(dst, sizeof(dst)), "3abcdef6");
+
+  SharedBuffer flat = rope.Flatten();
+  EXPECT_TRUE(flat.IsContiguous());
+  EXPECT_EQ(flat.JoinToString(), rope.JoinToString());
+}
+
+TEST(SHARED_BUFFER_TEST, AdoptBufferArray) {
+  BufferArray buffer_array;
+  aimrt_buffer_t b1 = buffer_array.NewBuffer(3);
+  aimrt_buffer_t b2 = buffer_array.NewBuffer(0);
+  aimrt_buffer_t b3 = buffer_array.NewBuffer(4);
+  memcpy(b1.data, "abc", 3);
+  memcpy(b3.data, "defg", 4);
+  (void)b2;
+
+  SharedBuffer buffer = buffer_array.MoveToSharedBuffer();
+  EXPECT_EQ(buffer_array.Size(), 0);
+  EXPECT_EQ(buffer.SliceNum(), 2);
+  EXPECT_EQ(buffer.Slices()[0].view.data, b1.data);
+  EXPECT_EQ(buffer.JoinToString(), "abcdefg");
+
+  // 视图持有SharedBuffer,Share不拷贝
+  auto view_ptr = std::make_shared<BufferArrayView>(buffer);
+  buffer.Reset();
+  EXPECT_EQ(view_ptr->Size(), 2);
+  EXPECT_EQ(view_ptr->JoinToString(), "abcdefg");
+  SharedBuffer shared = view_ptr->Share();
+  EXPECT_EQ(shared.Slices()[0].view.data, b1.data);
+  view_ptr.reset();
+  EXPECT_EQ(shared.JoinToString(), "abcdefg");
+
+  // 普通视图Share时拷贝
+  const std::string str = "xyz";
+  BufferArrayView plain_view(str.data(), str.size());
+  SharedBuffer plain_shared = plain_view.Share();
+  EXPECT_NE(plain_shared.Data(), static_cast<const void*>(str.data()));
+  EXPECT_EQ(plain_shared.JoinToString(), str);
+
+  BufferArray empty_array;
+  EXPECT_TRUE(empty_array.MoveToSharedBuffer().Empty());
+}
+
+TEST(SHARED_BUFFER_TEST, NativeHandle) {
+  ExternalStorage storage;
+  storage.data = "external";
+
+  aimrt_shared_buffer_slice_t slice{
+      .ops = &kExternalStorageOps,
+      .impl = &storage,
+      .view = aimrt_buffer_view_t{.data = storage.data.data(), .len = storage.data.size()}};
+
+  {
+    // 从C接口导入时增加引用
+    SharedBuffer buffer(aimrt_shared_buffer_t{.data = &slice, .len = 1});
+    EXPECT_EQ(storage.ref_count.load(), 2);
+    EXPECT_EQ(buffer.JoinToString(), "external");
+
+    SharedBuffer part = buffer.Slice(2, 3);
+    EXPECT_EQ(storage.ref_count.load(), 3);
+
+    // 借出给C接口,再导入
+    aimrt_shared_buffer_t handle = part.NativeHandle();
+    SharedBuffer imported(handle);
+    EXPECT_EQ(storage.ref_count.load(), 4);
+    EXPECT_EQ(imported.JoinToString(), "ter");
+  }
+
+  EXPECT_EQ(storage.ref_count.load(), 1);
+  kExternalStorageOps.release(&storage);
+  EXPECT_TRUE(storage.released);
+}
+
+TEST(SHARED_BUFFER_TEST, ConcurrentShare) {
+  const std::string str(1024, 'x');
+  SharedBuffer buffer = SharedBuffer::Copy(str.data(), str.size());
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([buffer, &str] {
+      for (int i = 0; i < 10000; ++i) {
+        SharedBuffer slice = buffer.Slice(i % 512, 256);
+        SharedBuffer copy = slice;
+        ASSERT_EQ(copy.Size(), 256);
+        ASSERT_EQ(*static_cast<const char*>(copy.Data()), str[0]);
+      }
+    });
+  }
+  buffer.Reset();
+  for (auto& t : threads) t.join();
+}
+
+}  // namespace aimrt::util
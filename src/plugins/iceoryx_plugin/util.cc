@@ -68,9 +68,14 @@ std::pair<std::shared_ptr<aimrt::util::BufferArrayView>, size_t> SerializeMsgSup
 
   size_t result = 0;
 
-  auto finditr = serialization_cache.find(serialization_type);
-  if (finditr != serialization_cache.end()) {
-    return {finditr->second, finditr->second->BufferSize()};
+  if (auto buffer_array_view_ptr = serialization_cache.Find(serialization_type)) {
+    return {buffer_array_view_ptr, buffer_array_view_ptr->BufferSize()};
+  }
+
+  // 压缩序列化类型需先序列化再压缩，无法直接写入共享内存，经由缓存拷贝
+  if (!runtime::core::util::SerializationCodec::SplitSerializationType(serialization_type).second.empty()) {
+    auto buffer_array_view_ptr = SerializeMsgWithCache(msg_wrapper, serialization_type);
+    return {buffer_array_view_ptr, buffer_array_view_ptr->BufferSize()};
   }
 
   auto buffer_array_ptr = std::make_unique<aimrt::util::BufferArray>(allocator);
@@ -85,6 +85,8 @@ void AimRTCore::Initialize(const Options& options) {
   // Init allocator
   EnterState(State::kPreInitAllocator);
   allocator_manager_.SetLogger(logger_ptr_);
+  allocator_manager_.RegisterGetExecutorFunc(
+      std::bind(&AimRTCore::GetExecutor, this, std::placeholders::_1));
   allocator_manager_.Initialize(configurator_manager_.GetAimRTOptionsNode("allocator"));
   EnterState(State::kPostInitAllocator);
 
@@ -2,8 +2,40 @@
 // All rights reserved.
 
 #include "core/allocator/allocator_manager.h"
+#include "util/alloc_tracker.h"
+#include "util/string_util.h"
 
 namespace YAML {
+template <>
+struct convert<omnirt::common::util::HugePageMode> {
+  using HugePageMode = omnirt::common::util::HugePageMode;
+
+  static Node encode(const HugePageMode& rhs) {
+    switch (rhs) {
+      case HugePageMode::kTransparent:
+        return Node("transparent");
+      case HugePageMode::kExplicit:
+        return Node("explicit");
+      default:
+        return Node("none");
+    }
+  }
+
+  static bool decode(const Node& node, HugePageMode& rhs) {
+    const auto str = node.as<std::string>();
+    if (str == "none") {
+      rhs = HugePageMode::kNone;
+    } else if (str == "transparent") {
+      rhs = HugePageMode::kTransparent;
+    } else if (str == "explicit") {
+      rhs = HugePageMode::kExplicit;
+    } else {
+      return false;
+    }
+    return true;
+  }
+};
+
 template <>
 struct convert<aimrt::runtime::core::allocator::AllocatorManager::Options> {
   using Options = aimrt::runtime::core::allocator::AllocatorManager::Options;
@@ -11,14 +43,108 @@ struct convert<aimrt::runtime::core::allocator::AllocatorManager::Options> {
   // 序列化：将Options转换为YAML节点
   static Node encode(const Options& rhs) {
     Node node;
-    return node;// 目前是空实现，为将来扩展预留
+
+    node["stats"]["enable"] = rhs.stats_options.enable;
+    node["stats"]["sample_interval"] = rhs.stats_options.sample_interval;
+    node["stats"]["report_interval_ms"] = rhs.stats_options.report_interval_ms;
+    node["stats"]["report_executor"] = rhs.stats_options.report_executor;
+    node["stats"]["report_max_stacks"] = rhs.stats_options.report_max_stacks;
+    node["stats"]["report_min_age_ms"] = rhs.stats_options.report_min_age_ms;
+
+    node["message_pool"]["enable"] = rhs.message_pool_options.enable;
+    node["message_pool"]["thread_cache_num"] = rhs.message_pool_options.default_options.thread_cache_num;
+    node["message_pool"]["max_cache_num"] = rhs.message_pool_options.default_options.max_cache_num;
+    node["message_pool"]["prewarm_num"] = rhs.message_pool_options.default_options.prewarm_num;
+    for (const auto& type_options : rhs.message_pool_options.type_options) {
+      Node type_options_node;
+      type_options_node["type_name"] = type_options.first;
+      type_options_node["thread_cache_num"] = type_options.second.thread_cache_num;
+      type_options_node["max_cache_num"] = type_options.second.max_cache_num;
+      type_options_node["prewarm_num"] = type_options.second.prewarm_num;
+      node["message_pool"]["types"].push_back(type_options_node);
+    }
+
+    node["scratch_arena"]["huge_pages"] = rhs.scratch_arena_backing.huge_pages;
+    node["scratch_arena"]["prefault"] = rhs.scratch_arena_backing.prefault;
+    node["scratch_arena"]["lock"] = rhs.scratch_arena_backing.lock;
+    node["scratch_arena"]["numa_node"] = rhs.scratch_arena_backing.numa_node;
+
+    return node;
   }
 
   // 反序列化：将YAML节点转换为Options
   static bool decode(const Node& node, Options& rhs) {
     if (!node.IsMap()) return false;// 确保是Map类型的节点
 
-    return true;// 目前是空实现，为将来扩展预留
+    if (node["stats"]) {
+      const auto& stats_node = node["stats"];
+
+      if (stats_node["enable"])
+        rhs.stats_options.enable = stats_node["enable"].as<bool>();
+
+      if (stats_node["sample_interval"])
+        rhs.stats_options.sample_interval = stats_node["sample_interval"].as<uint32_t>();
+
+      if (stats_node["report_interval_ms"])
+        rhs.stats_options.report_interval_ms = stats_node["report_interval_ms"].as<uint32_t>();
+
+      if (stats_node["report_executor"])
+        rhs.stats_options.report_executor = stats_node["report_executor"].as<std::string>();
+
+      if (stats_node["report_max_stacks"])
+        rhs.stats_options.report_max_stacks = stats_node["report_max_stacks"].as<uint32_t>();
+
+      if (stats_node["report_min_age_ms"])
+        rhs.stats_options.report_min_age_ms = stats_node["report_min_age_ms"].as<uint32_t>();
+    }
+
+    if (node["message_pool"]) {
+      const auto& message_pool_node = node["message_pool"];
+
+      if (message_pool_node["enable"])
+        rhs.message_pool_options.enable = message_pool_node["enable"].as<bool>();
+
+      DecodePoolOptions(message_pool_node, rhs.message_pool_options.default_options);
+
+      if (message_pool_node["types"] && message_pool_node["types"].IsSequence()) {
+        for (const auto& type_options_node : message_pool_node["types"]) {
+          // 未配置的项继承默认配置
+          auto type_options = rhs.message_pool_options.default_options;
+          DecodePoolOptions(type_options_node, type_options);
+          rhs.message_pool_options.type_options.emplace_back(
+              type_options_node["type_name"].as<std::string>(), type_options);
+        }
+      }
+    }
+
+    if (node["scratch_arena"]) {
+      const auto& scratch_arena_node = node["scratch_arena"];
+
+      if (scratch_arena_node["huge_pages"])
+        rhs.scratch_arena_backing.huge_pages = scratch_arena_node["huge_pages"].as<omnirt::common::util::HugePageMode>();
+
+      if (scratch_arena_node["prefault"])
+        rhs.scratch_arena_backing.prefault = scratch_arena_node["prefault"].as<bool>();
+
+      if (scratch_arena_node["lock"])
+        rhs.scratch_arena_backing.lock = scratch_arena_node["lock"].as<bool>();
+
+      if (scratch_arena_node["numa_node"])
+        rhs.scratch_arena_backing.numa_node = scratch_arena_node["numa_node"].as<int>();
+    }
+
+    return true;
+  }
+
+  static void DecodePoolOptions(const Node& node, aimrt::runtime::core::allocator::MessagePool::Options& options) {
+    if (node["thread_cache_num"])
+      options.thread_cache_num = node["thread_cache_num"].as<uint32_t>();
+
+    if (node["max_cache_num"])
+      options.max_cache_num = node["max_cache_num"].as<uint32_t>();
+
+    if (node["prewarm_num"])
+      options.prewarm_num = node["prewarm_num"].as<uint32_t>();
   }
 };
 }  // namespace YAML
@@ -33,6 +159,35 @@ void AllocatorManager::Initialize(YAML::Node options_node) {
   if (options_node && !options_node.IsNull())
     options_ = options_node.as<Options>();//将节点 options_node 转换为指定类型 Options
 
+  auto& tracker = aimrt::common::util::AllocTracker::Instance();
+  tracker.SetEnabled(options_.stats_options.enable);
+  tracker.SetSampleInterval(options_.stats_options.enable ? options_.stats_options.sample_interval : 0);
+
+  // 对象池在channel/rpc注册消息类型时创建，分配器需先于它们初始化
+  const auto& message_pool_options = options_.message_pool_options;
+  auto& message_pool_registry = MessagePoolRegistry::Instance();
+  message_pool_registry.SetOptions(
+      message_pool_options.default_options,
+      std::unordered_map<std::string, MessagePool::Options>(
+          message_pool_options.type_options.begin(), message_pool_options.type_options.end()));
+  message_pool_registry.SetEnabled(message_pool_options.enable);
+
+  // 已经使用过arena的线程(包括当前线程)保持原有策略
+  aimrt::common::util::ScratchArena::SetDefaultMemoryBacking(options_.scratch_arena_backing);
+
+  if (options_.stats_options.enable && options_.stats_options.report_interval_ms > 0) {
+    AIMRT_CHECK_ERROR_THROW(
+        get_executor_func_,
+        "Get executor function is not set before initialize.");
+
+    report_executor_ = get_executor_func_(options_.stats_options.report_executor);
+
+    AIMRT_CHECK_ERROR_THROW(
+        report_executor_ && report_executor_.SupportTimerSchedule(),
+        "Invalid allocation report executor '{}', executor must support timer schedule.",
+        options_.stats_options.report_executor);
+  }
+
   options_node = options_;
 
   AIMRT_INFO("Allocator manager init complete");
@@ -43,6 +198,8 @@ void AllocatorManager::Start() {
       std::atomic_exchange(&state_, State::kStart) == State::kInit,
       "Method can only be called when state is 'Init'.");
 
+  if (report_executor_) ScheduleAllocationReport();
+
   AIMRT_INFO("Allocator manager start completed.");
 }
 
@@ -51,6 +208,25 @@ void AllocatorManager::Shutdown() {
     return;
 
   AIMRT_INFO("Allocator manager shutdown.");
+
+  if (options_.stats_options.enable || options_.message_pool_options.enable)
+    AIMRT_INFO("Allocation report at shutdown:\n{}", GenAllocationReport());
+
+  report_executor_ = aimrt::executor::ExecutorRef();
+
+  // 消息对象池缓存的消息来自模块动态库中的type support，需在模块卸载前销毁
+  MessagePoolRegistry::Instance().CloseAll();
+
+  // allocator_proxy_map_不能清，模块释放的内存可能晚于关闭
+}
+
+void AllocatorManager::RegisterGetExecutorFunc(
+    const std::function<aimrt::executor::ExecutorRef(std::string_view)>& get_executor_func) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kPreInit,
+      "Method can only be called when state is 'PreInit'.");
+
+  get_executor_func_ = get_executor_func;
 }
 
 const AllocatorProxy& AllocatorManager::GetAllocatorProxy(const util::ModuleDetailInfo& module_info) {
@@ -58,7 +234,15 @@ const AllocatorProxy& AllocatorManager::GetAllocatorProxy(const util::ModuleDeta
       state_.load() == State::kInit,
       "Method can only be called when state is 'Init'.");
 
-  return allocator_proxy_;
+  auto itr = allocator_proxy_map_.find(module_info.name);
+  if (itr != allocator_proxy_map_.end()) return *(itr->second);
+
+  uint32_t track_domain = aimrt::common::util::AllocTracker::Instance().RegisterDomain("module." + module_info.name);
+
+  auto emplace_ret = allocator_proxy_map_.emplace(
+      module_info.name, std::make_unique<AllocatorProxy>(track_domain));
+
+  return *(emplace_ret.first->second);
 }
 
 std::list<std::pair<std::string, std::string>> AllocatorManager::GenInitializationReport() const {
@@ -66,7 +250,85 @@ std::list<std::pair<std::string, std::string>> AllocatorManager::GenInitializati
       state_.load() == State::kInit,
       "Method can only be called when state is 'Init'.");
 
-  return {};
+  const auto& stats_options = options_.stats_options;
+  std::string stats_info = stats_options.enable
+                               ? ("enabled, sample interval: " + std::to_string(stats_options.sample_interval) +
+                                  ", report interval ms: " + std::to_string(stats_options.report_interval_ms))
+                               : "disabled";
+
+  const auto& message_pool_options = options_.message_pool_options;
+  std::string message_pool_info = message_pool_options.enable
+                                      ? ("enabled, thread cache num: " + std::to_string(message_pool_options.default_options.thread_cache_num) +
+                                         ", max cache num: " + std::to_string(message_pool_options.default_options.max_cache_num) +
+                                         ", prewarm num: " + std::to_string(message_pool_options.default_options.prewarm_num) +
+                                         ", type options num: " + std::to_string(message_pool_options.type_options.size()))
+                                      : "disabled";
+
+  const auto& backing = options_.scratch_arena_backing;
+  std::string scratch_arena_info = backing.IsDefault()
+                                       ? "default"
+                                       : ("huge pages: " + YAML::Node(backing.huge_pages).as<std::string>() +
+                                          ", prefault: " + (backing.prefault ? "true" : "false") +
+                                          ", lock: " + (backing.lock ? "true" : "false") +
+                                          ", numa node: " + std::to_string(backing.numa_node));
+
+  return {{"Allocation Stats", stats_info},
+          {"Message Pool", message_pool_info},
+          {"Scratch Arena Backing", scratch_arena_info}};
+}
+
+std::string AllocatorManager::GenAllocationReport() const {
+  std::vector<std::vector<std::string>> table =
+      {{"domain", "alloc count", "free count", "live count", "live bytes", "total alloc bytes"}};
+
+  for (const auto& item : aimrt::common::util::AllocTracker::Instance().GetDomainStats()) {
+    if (item.alloc_count == 0 && item.free_count == 0) continue;
+
+    table.emplace_back(std::vector<std::string>{
+        item.name,
+        std::to_string(item.alloc_count),
+        std::to_string(item.free_count),
+        std::to_string(item.LiveCount()),
+        std::to_string(item.LiveBytes()),
+        std::to_string(item.alloc_bytes)});
+  }
+
+  std::string report = aimrt::common::util::DrawTable(table) + "\n";
+
+  auto message_pool_stats = MessagePoolRegistry::Instance().GetStats();
+  if (!message_pool_stats.empty()) {
+    std::vector<std::vector<std::string>> pool_table =
+        {{"msg type", "acquire count", "hit count", "create count", "release count", "destroy count", "global cache num"}};
+
+    for (const auto& item : message_pool_stats) {
+      pool_table.emplace_back(std::vector<std::string>{
+          item.type_name,
+          std::to_string(item.acquire_count),
+          std::to_string(item.HitCount()),
+          std::to_string(item.create_count),
+          std::to_string(item.release_count),
+          std::to_string(item.destroy_count),
+          std::to_string(item.global_cache_num)});
+    }
+
+    report += aimrt::common::util::DrawTable(pool_table) + "\n";
+  }
+
+  return report +
+         aimrt::common::util::AllocTracker::Instance().GenSampleReport(
+             options_.stats_options.report_max_stacks,
+             std::chrono::milliseconds(options_.stats_options.report_min_age_ms));
+}
+
+void AllocatorManager::ScheduleAllocationReport() {
+  report_executor_.ExecuteAfter(
+      std::chrono::milliseconds(options_.stats_options.report_interval_ms),
+      [this]() {
+        if (state_.load() != State::kStart) return;
+
+        AIMRT_INFO("Allocation report:\n{}", GenAllocationReport());
+        ScheduleAllocationReport();
+      });
 }
 
 }  // namespace aimrt::runtime::core::allocator
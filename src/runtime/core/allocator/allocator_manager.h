@@ -3,7 +3,13 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+#include "aimrt_module_cpp_interface/executor/executor.h"
 #include "core/allocator/allocator_proxy.h"
+#include "core/allocator/message_pool.h"
 #include "core/util/module_detail_info.h"
 #include "util/log_util.h"
 
@@ -13,7 +19,35 @@ namespace aimrt::runtime::core::allocator {
 
 class AllocatorManager {
  public:
-  struct Options {};
+  struct Options {
+    /**
+     * @brief 分配统计配置选项，开启后channel序列化、rpc、日志与各模块的分配按分配域分别计数
+     */
+    struct StatsOptions {
+      bool enable = false;                ///< 是否开启分配统计
+      uint32_t sample_interval = 0;       ///< 调用栈采样间隔，平均每多少次分配采样一次，0表示不采样
+      uint32_t report_interval_ms = 0;    ///< 周期性打印统计日志的间隔，0表示不打印
+      std::string report_executor;        ///< 周期性打印使用的执行器，需支持定时调度
+      uint32_t report_max_stacks = 10;    ///< 报告中最多输出的调用栈个数
+      uint32_t report_min_age_ms = 1000;  ///< 报告中只统计存活时间不短于该值的采样，用于过滤正常在途的分配
+    };
+    StatsOptions stats_options;
+
+    /**
+     * @brief 消息对象池配置选项，开启后框架创建的channel订阅消息、rpc请求/响应从按类型的对象池中取出并回收复用
+     */
+    struct MessagePoolOptions {
+      bool enable = false;                       ///< 是否开启消息对象池
+      MessagePool::Options default_options;      ///< 默认的对象池配置
+      std::vector<std::pair<std::string, MessagePool::Options>> type_options;  ///< 按消息类型名覆盖的配置
+    };
+    MessagePoolOptions message_pool_options;
+
+    /**
+     * @brief 线程临时内存arena的页面策略，只影响初始化之后首次使用arena的线程
+     */
+    aimrt::common::util::ScratchArena::MemoryBackingOptions scratch_arena_backing;
+  };
 
   enum class State : uint32_t {
     kPreInit,
@@ -30,6 +64,9 @@ class AllocatorManager {
   AllocatorManager(const AllocatorManager&) = delete;
   AllocatorManager& operator=(const AllocatorManager&) = delete;
 
+  void RegisterGetExecutorFunc(
+      const std::function<aimrt::executor::ExecutorRef(std::string_view)>& get_executor_func);
+
   void Initialize(YAML::Node options_node);
   void Start();
   void Shutdown();
@@ -44,15 +81,25 @@ class AllocatorManager {
 
   std::list<std::pair<std::string, std::string>> GenInitializationReport() const;
 
+  /**
+   * @brief 生成分配统计报告，包括各分配域的计数、消息对象池的命中情况和存活采样的调用栈
+   */
+  std::string GenAllocationReport() const;
+
   void SetLogger(const std::shared_ptr<aimrt::common::util::LoggerWrapper>& logger_ptr) { logger_ptr_ = logger_ptr; }
   const aimrt::common::util::LoggerWrapper& GetLogger() const { return *logger_ptr_; }
 
  private:
+  void ScheduleAllocationReport();
+
   Options options_;
   std::atomic<State> state_ = State::kPreInit;
   std::shared_ptr<aimrt::common::util::LoggerWrapper> logger_ptr_;
 
-  AllocatorProxy allocator_proxy_;
+  std::function<aimrt::executor::ExecutorRef(std::string_view)> get_executor_func_;
+  aimrt::executor::ExecutorRef report_executor_;
+
+  std::unordered_map<std::string, std::unique_ptr<AllocatorProxy>> allocator_proxy_map_;
 };
 
 }  // namespace aimrt::runtime::core::allocator
@@ -1,6 +1,7 @@
 // Copyright (c) 2023, AgiBot Inc.
 // All rights reserved.
 
+#include "aimrt_module_cpp_interface/util/buffer.h"
 #include "core/allocator/allocator_manager.h"
 #include "gtest/gtest.h"
 
@@ -21,4 +22,111 @@ TEST(AllocatorManagerTest, AllocatorManager) {
   EXPECT_EQ(allocator_manager.GetState(), AllocatorManager::State::kShutdown);
 }
 
-}  // namespace aimrt::runtime::core::allocator
\ No newline at end of file
+TEST(AllocatorManagerTest, ScratchArena) {
+  AllocatorManager allocator_manager;
+  YAML::Node options_node_test;
+  allocator_manager.Initialize(options_node_test);
+  const auto* scratch_arena = allocator_manager.GetAllocatorProxy().ScratchArenaNativeHandle();
+
+  size_t frame = scratch_arena->push_frame(scratch_arena->impl);
+  // 帧内分配没有16M的上限
+  auto* buf_ptr = scratch_arena->allocate(scratch_arena->impl, 1024 * 1024 * 16 + 1, 8);
+  EXPECT_NE(buf_ptr, nullptr);
+
+  aimrt_scratch_arena_stats_t stats;
+  scratch_arena->get_stats(scratch_arena->impl, &stats);
+  EXPECT_EQ(stats.frame_depth, frame + 1);
+  EXPECT_GE(stats.bytes_in_use, 1024 * 1024 * 16 + 1);
+
+  scratch_arena->pop_frame(scratch_arena->impl, frame);
+  scratch_arena->get_stats(scratch_arena->impl, &stats);
+  EXPECT_EQ(stats.frame_depth, frame);
+  EXPECT_EQ(scratch_arena->allocate(scratch_arena->impl, 16, 8) == nullptr, frame == 0);
+}
+
+TEST(AllocatorManagerTest, AllocationStats) {
+  AllocatorManager allocator_manager;
+  YAML::Node options_node_test = YAML::Load(R"str(
+stats:
+  enable: true
+  sample_interval: 1
+  report_min_age_ms: 0
+)str");
+  allocator_manager.Initialize(options_node_test);
+
+  const auto& proxy_a = allocator_manager.GetAllocatorProxy("stats_test_module_a");
+  const auto& proxy_b = allocator_manager.GetAllocatorProxy("stats_test_module_b");
+  EXPECT_EQ(&allocator_manager.GetAllocatorProxy("stats_test_module_a"), &proxy_a);
+  EXPECT_NE(proxy_a.TrackDomain(), proxy_b.TrackDomain());
+
+  auto& tracker = aimrt::common::util::AllocTracker::Instance();
+
+  {
+    aimrt::util::BufferArray buffer_array(proxy_a.BufferArrayAllocatorNativeHandle());
+    buffer_array.NewBuffer(1000);
+    buffer_array.NewBuffer(24);
+    EXPECT_EQ(tracker.GetDomainStats(proxy_a.TrackDomain()).LiveBytes(), 1024);
+  }
+  EXPECT_EQ(tracker.GetDomainStats(proxy_a.TrackDomain()).LiveBytes(), 0);
+
+  // 故意泄漏，报告中应能定位到模块b
+  auto* leak_ptr = new aimrt::util::BufferArray(proxy_b.BufferArrayAllocatorNativeHandle());
+  leak_ptr->NewBuffer(4096);
+  EXPECT_EQ(tracker.GetDomainStats(proxy_b.TrackDomain()).LiveBytes(), 4096);
+
+  std::string report = allocator_manager.GenAllocationReport();
+  EXPECT_NE(report.find("module.stats_test_module_b"), std::string::npos);
+  EXPECT_NE(report.find("sampled bytes: 4096"), std::string::npos);
+
+  delete leak_ptr;
+  EXPECT_EQ(tracker.GetDomainStats(proxy_b.TrackDomain()).LiveBytes(), 0);
+
+  allocator_manager.Shutdown();
+  tracker.SetSampleInterval(0);
+  tracker.SetEnabled(false);
+}
+
+TEST(AllocatorManagerTest, MessagePoolOptions) {
+  AllocatorManager allocator_manager;
+  YAML::Node options_node_test = YAML::Load(R"str(
+message_pool:
+  enable: true
+  thread_cache_num: 32
+  types:
+    - type_name: pb:example.LargeMsg
+      max_cache_num: 8
+      prewarm_num: 8
+)str");
+  allocator_manager.Initialize(options_node_test);
+  EXPECT_TRUE(MessagePoolRegistry::Instance().Enabled());
+
+  // 类型配置中未配置的项继承默认配置
+  const auto& type_node = options_node_test["message_pool"]["types"][0];
+  EXPECT_EQ(type_node["type_name"].as<std::string>(), "pb:example.LargeMsg");
+  EXPECT_EQ(type_node["thread_cache_num"].as<uint32_t>(), 32);
+  EXPECT_EQ(type_node["max_cache_num"].as<uint32_t>(), 8);
+  EXPECT_EQ(options_node_test["message_pool"]["max_cache_num"].as<uint32_t>(), 1024);
+
+  allocator_manager.Shutdown();
+  MessagePoolRegistry::Instance().SetEnabled(false);
+}
+
+TEST(AllocatorManagerTest, ScratchArenaBacking) {
+  AllocatorManager allocator_manager;
+  YAML::Node options_node_test = YAML::Load(R"str(
+scratch_arena:
+  huge_pages: transparent
+  prefault: true
+)str");
+  allocator_manager.Initialize(options_node_test);
+
+  const auto backing = aimrt::common::util::ScratchArena::DefaultMemoryBacking();
+  EXPECT_EQ(backing.huge_pages, omnirt::common::util::HugePageMode::kTransparent);
+  EXPECT_TRUE(backing.prefault);
+  EXPECT_EQ(options_node_test["scratch_arena"]["huge_pages"].as<std::string>(), "transparent");
+
+  allocator_manager.Shutdown();
+  aimrt::common::util::ScratchArena::SetDefaultMemoryBacking({});
+}
+
+}  // namespace aimrt::runtime::core::allocator
@@ -3,16 +3,19 @@
 
 #pragma once
 
-#include <cstdlib>
-
 #include "aimrt_module_c_interface/allocator/allocator_base.h"
+#include "aimrt_module_c_interface/allocator/scratch_arena_base.h"
+#include "core/allocator/tracked_buffer_array_allocator.h"
+#include "util/scratch_arena.h"
 
 namespace aimrt::runtime::core::allocator {
 
 class AllocatorProxy {
  public:
-  explicit AllocatorProxy()
-      : base_(GenBase(this)) {}
+  explicit AllocatorProxy(uint32_t track_domain = common::util::AllocTracker::kOtherDomain)
+      : track_domain_(track_domain),
+        base_(GenBase(this)),
+        scratch_arena_base_(GenScratchArenaBase(this)) {}
   ~AllocatorProxy() = default;
 
   AllocatorProxy(const AllocatorProxy&) = delete;
@@ -20,40 +23,23 @@ class AllocatorProxy {
 
   const aimrt_allocator_base_t* NativeHandle() const { return &base_; }
 
+  const aimrt_scratch_arena_base_t* ScratchArenaNativeHandle() const { return &scratch_arena_base_; }
+
+  /// 计入本模块分配域的buffer array分配器
+  const aimrt_buffer_array_allocator_t* BufferArrayAllocatorNativeHandle() const {
+    return TrackedBufferArrayAllocator::NativeHandle(track_domain_);
+  }
+
+  uint32_t TrackDomain() const { return track_domain_; }
+
  private:
   static void* GetThreadLocalBuf(size_t buf_size) {
     constexpr size_t kMaxThreadLocalBufSize = 1024 * 1024 * 16;
-    constexpr size_t kMinThreadLocalBufSize = 1024 * 4;
 
     if (buf_size > kMaxThreadLocalBufSize) return nullptr;
 
-    struct Buf {
-      Buf() : buf(malloc(kMinThreadLocalBufSize)), size(kMinThreadLocalBufSize) {}
-      ~Buf() {
-        if (buf != nullptr) free(buf);
-      }
-      void* buf;
-      size_t size;
-    };
-
-    // thread_local 是 C++11 引入的存储类型
-    thread_local Buf thread_local_buf;
-
-    // 如果现有缓冲区够用，直接返回
-    if (thread_local_buf.size >= buf_size)
-      return thread_local_buf.buf;
-
-    // 释放旧缓冲区
-    if (thread_local_buf.buf != nullptr)
-      free(thread_local_buf.buf);
-
-    // 分配新缓冲区
-    while (thread_local_buf.size < buf_size)
-      thread_local_buf.size <<= 1;
-
-    thread_local_buf.buf = malloc(thread_local_buf.size);
-
-    return thread_local_buf.buf;
+    // 兼容旧接口，大小不定的临时内存请使用 scratch arena 的帧分配
+    return common::util::ScratchArena::ThreadLocal().GetPersistentBuf(buf_size);
   }
 
   static aimrt_allocator_base_t GenBase(void* impl) {
@@ -64,8 +50,37 @@ class AllocatorProxy {
         .impl = impl};
   }
 
+  static aimrt_scratch_arena_base_t GenScratchArenaBase(void* impl) {
+    return aimrt_scratch_arena_base_t{
+        .push_frame = [](void* impl) -> size_t {
+          return common::util::ScratchArena::ThreadLocal().PushFrame();
+        },
+        .pop_frame = [](void* impl, size_t frame) {
+          common::util::ScratchArena::ThreadLocal().PopFrame(frame);
+        },
+        .allocate = [](void* impl, size_t size, size_t align) -> void* {
+          return common::util::ScratchArena::ThreadLocal().Allocate(size, align);
+        },
+        .get_stats = [](void* impl, aimrt_scratch_arena_stats_t* stats) {
+          const auto s = common::util::ScratchArena::ThreadLocal().GetStats();
+          *stats = aimrt_scratch_arena_stats_t{
+              .bytes_in_use = s.bytes_in_use,
+              .high_water = s.high_water,
+              .capacity = s.capacity,
+              .chunk_count = s.chunk_count,
+              .frame_depth = s.frame_depth,
+              .persistent_capacity = s.persistent_capacity,
+              .alloc_count = s.alloc_count,
+              .chunk_alloc_count = s.chunk_alloc_count,
+              .trim_count = s.trim_count};
+        },
+        .impl = impl};
+  }
+
  private:
+  const uint32_t track_domain_;
   const aimrt_allocator_base_t base_;
+  const aimrt_scratch_arena_base_t scratch_arena_base_;
 };
 
 }  // namespace aimrt::runtime::core::allocator
@@ -0,0 +1,468 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aimrt_module_c_interface/util/type_support_base.h"
+#include "aimrt_module_cpp_interface/util/string.h"
+#include "util/macros.h"
+
+namespace aimrt::runtime::core::allocator {
+
+/**
+ * @brief 单个消息类型的对象池，包装任意type support，create/destroy改为从池中取出/回收到池中
+ * @note
+ * 1. 每个线程有本地缓存，热点路径无锁；本地缓存超过上限时把一半归还到全局空闲表，为空时从全局空闲表批量取回
+ * 2. 全局空闲表超过上限的消息直接销毁
+ * 3. 回收前重置消息：优先使用注册的重置函数，否则从一个空白消息拷贝，对protobuf消息等价于Clear()
+ * 4. 对象池对象本身不析构，消息可以在任意时刻、任意线程回收
+ * 5. 原始type support来自模块的动态库，卸载前必须Close：销毁池中缓存的消息，之后取出/回收直接转发给原始type support
+ * 6. 取出/回收期间持有在途计数，Close等待在途的取出/回收结束后才销毁缓存的消息和空白消息
+ */
+class MessagePool {
+ public:
+  using ResetFunc = void (*)(void* msg);
+
+  struct Options {
+    uint32_t thread_cache_num = 64;  ///< 每个线程本地缓存的消息个数上限
+    uint32_t max_cache_num = 1024;   ///< 全局空闲表缓存的消息个数上限
+    uint32_t prewarm_num = 0;        ///< 创建时预先创建并放入全局空闲表的消息个数
+  };
+
+  struct Stats {
+    std::string type_name;
+    uint64_t acquire_count = 0;  ///< 取出次数
+    uint64_t create_count = 0;   ///< 池中没有可用消息、新创建的次数，不包括预热
+    uint64_t release_count = 0;  ///< 回收次数
+    uint64_t destroy_count = 0;  ///< 超过缓存上限被销毁的次数
+    size_t global_cache_num = 0;
+
+    uint64_t HitCount() const {
+      return (acquire_count > create_count) ? (acquire_count - create_count) : 0;
+    }
+  };
+
+  MessagePool(const aimrt_type_support_base_t* base_ptr, const Options& options, ResetFunc reset_func = nullptr)
+      : base_ptr_(base_ptr),
+        options_(options),
+        reset_func_(reset_func),
+        wrapped_base_(GenWrappedBase(this)) {
+    if (reset_func_ == nullptr) blank_msg_ = base_ptr_->create(base_ptr_->impl);
+
+    free_list_.reserve(std::max(options_.prewarm_num, options_.max_cache_num));
+    for (uint32_t ii = 0; ii < options_.prewarm_num; ++ii)
+      free_list_.emplace_back(base_ptr_->create(base_ptr_->impl));
+  }
+
+  ~MessagePool() = delete;
+
+  MessagePool(const MessagePool&) = delete;
+  MessagePool& operator=(const MessagePool&) = delete;
+
+  /**
+   * @brief 包装后的type support，生命周期与对象池相同
+   */
+  const aimrt_type_support_base_t* NativeHandle() const { return &wrapped_base_; }
+
+  /**
+   * @brief 被包装的原始type support
+   */
+  const aimrt_type_support_base_t* BaseNativeHandle() const { return base_ptr_; }
+
+  static bool IsWrapped(const aimrt_type_support_base_t* base_ptr) {
+    return base_ptr->create == &CreateFunc;
+  }
+
+  void* Acquire() {
+    acquire_count_.fetch_add(1, std::memory_order_relaxed);
+
+    ActiveScope scope(this);
+    if (omnirt_unlikely(scope.Closed())) {
+      create_count_.fetch_add(1, std::memory_order_relaxed);
+      return base_ptr_->create(base_ptr_->impl);
+    }
+
+    std::vector<void*>* cache_ptr = LocalCache();
+    if (omnirt_likely(cache_ptr != nullptr && !cache_ptr->empty())) {
+      void* msg = cache_ptr->back();
+      cache_ptr->pop_back();
+      return msg;
+    }
+
+    if (void* msg = TakeFromGlobal(cache_ptr)) return msg;
+
+    create_count_.fetch_add(1, std::memory_order_relaxed);
+    return base_ptr_->create(base_ptr_->impl);
+  }
+
+  void Release(void* msg) {
+    release_count_.fetch_add(1, std::memory_order_relaxed);
+
+    ActiveScope scope(this);
+    if (omnirt_unlikely(scope.Closed())) {
+      destroy_count_.fetch_add(1, std::memory_order_relaxed);
+      base_ptr_->destroy(base_ptr_->impl, msg);
+      return;
+    }
+
+    if (reset_func_ != nullptr) {
+      reset_func_(msg);
+    } else {
+      base_ptr_->copy(base_ptr_->impl, blank_msg_, msg);
+    }
+
+    std::vector<void*>* cache_ptr = LocalCache();
+    if (omnirt_unlikely(cache_ptr == nullptr)) {
+      ReturnToGlobal(&msg, 1);
+      return;
+    }
+
+    cache_ptr->emplace_back(msg);
+    if (omnirt_likely(cache_ptr->size() <= options_.thread_cache_num)) return;
+
+    // 本地缓存满了，保留一半，其余归还到全局空闲表
+    const size_t keep_num = options_.thread_cache_num / 2;
+    ReturnToGlobal(cache_ptr->data() + keep_num, cache_ptr->size() - keep_num);
+    cache_ptr->resize(keep_num);
+  }
+
+  Stats GetStats() const {
+    Stats stats{
+        .type_name = std::string(aimrt::util::ToStdStringView(base_ptr_->type_name(base_ptr_->impl))),
+        .acquire_count = acquire_count_.load(std::memory_order_relaxed),
+        .create_count = create_count_.load(std::memory_order_relaxed),
+        .release_count = release_count_.load(std::memory_order_relaxed),
+        .destroy_count = destroy_count_.load(std::memory_order_relaxed)};
+
+    std::lock_guard<std::mutex> lck(mutex_);
+    stats.global_cache_num = free_list_.size();
+    return stats;
+  }
+
+  const Options& GetOptions() const { return options_; }
+
+  /**
+   * @brief 关闭对象池，销毁全局空闲表、当前线程本地缓存中的消息以及空白消息
+   * @note 需在原始type support所在的动态库卸载前、框架不再收发消息后调用。
+   * 其它线程本地缓存中的消息无法安全地跨线程取回，这些线程退出时直接丢弃，不再调用原始type support。
+   * 关闭前已开始的取出/回收可能仍在使用空白消息或全局空闲表，先等待它们结束
+   */
+  void Close() {
+    if (closed_.exchange(true)) return;
+
+    while (active_num_.load() != 0) std::this_thread::yield();
+
+    std::vector<void*> msgs;
+    if (!ThreadCache::destroyed) {
+      auto& caches = GetThreadCache().caches;
+      for (auto itr = caches.begin(); itr != caches.end(); ++itr) {
+        if (itr->first == this) {
+          msgs.swap(itr->second);
+          caches.erase(itr);
+          break;
+        }
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      msgs.insert(msgs.end(), free_list_.begin(), free_list_.end());
+      std::vector<void*>().swap(free_list_);
+    }
+
+    destroy_count_.fetch_add(msgs.size(), std::memory_order_relaxed);
+    for (void* msg : msgs) base_ptr_->destroy(base_ptr_->impl, msg);
+
+    if (blank_msg_ != nullptr) {
+      base_ptr_->destroy(base_ptr_->impl, blank_msg_);
+      blank_msg_ = nullptr;
+    }
+  }
+
+  bool Closed() const { return closed_.load(std::memory_order_acquire); }
+
+ private:
+  struct ThreadCache {
+    ~ThreadCache() {
+      destroyed = true;
+      for (auto& item : caches) {
+        if (item.second.empty()) continue;
+
+        // 已关闭的对象池对应的动态库可能已卸载，不能再调用原始type support，直接丢弃
+        ActiveScope scope(item.first);
+        if (!scope.Closed()) item.first->ReturnToGlobal(item.second.data(), item.second.size());
+      }
+    }
+
+    std::vector<std::pair<MessagePool*, std::vector<void*>>> caches;
+    static inline thread_local bool destroyed = false;
+  };
+
+  /**
+   * @brief 在途计数，与Close配对：计数先于关闭标志的读取生效，Close置位关闭标志后等待计数归零，
+   * 因此要么这里读到已关闭，要么Close等到这次操作结束。两边都用顺序一致的原子操作
+   */
+  class ActiveScope {
+   public:
+    explicit ActiveScope(MessagePool* pool) : pool_(pool) { pool_->active_num_.fetch_add(1); }
+    ~ActiveScope() { pool_->active_num_.fetch_sub(1, std::memory_order_release); }
+
+    ActiveScope(const ActiveScope&) = delete;
+    ActiveScope& operator=(const ActiveScope&) = delete;
+
+    bool Closed() const { return pool_->closed_.load(); }
+
+   private:
+    MessagePool* const pool_;
+  };
+
+  /**
+   * @brief 当前线程在本池的本地缓存，线程退出阶段返回空
+   */
+  std::vector<void*>* LocalCache() {
+    if (omnirt_unlikely(options_.thread_cache_num == 0 || ThreadCache::destroyed)) return nullptr;
+
+    // 一个线程接触到的消息类型很少，线性查找即可，最近使用的放在最前面
+    auto& caches = GetThreadCache().caches;
+    if (omnirt_likely(!caches.empty() && caches.front().first == this)) return &caches.front().second;
+
+    for (size_t ii = 1; ii < caches.size(); ++ii) {
+      if (caches[ii].first == this) {
+        std::swap(caches[0], caches[ii]);
+        return &caches.front().second;
+      }
+    }
+
+    caches.emplace_back(this, std::vector<void*>());
+    std::swap(caches.front(), caches.back());
+    caches.front().second.reserve(options_.thread_cache_num + 1);
+    return &caches.front().second;
+  }
+
+  static ThreadCache& GetThreadCache() {
+    thread_local ThreadCache thread_cache;
+    return thread_cache;
+  }
+
+  void* TakeFromGlobal(std::vector<void*>* cache_ptr) {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (free_list_.empty()) return nullptr;
+
+    void* msg = free_list_.back();
+    free_list_.pop_back();
+
+    // 顺带取回一批到本地缓存，减少加锁次数
+    if (cache_ptr != nullptr) {
+      const size_t batch_num = std::min<size_t>(free_list_.size(), options_.thread_cache_num / 2);
+      cache_ptr->insert(cache_ptr->end(), free_list_.end() - batch_num, free_list_.end());
+      free_list_.resize(free_list_.size() - batch_num);
+    }
+
+    return msg;
+  }
+
+  void ReturnToGlobal(void* const* msgs, size_t num) {
+    size_t keep_num = 0;
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      if (free_list_.size() < options_.max_cache_num)
+        keep_num = std::min<size_t>(num, options_.max_cache_num - free_list_.size());
+      free_list_.insert(free_list_.end(), msgs, msgs + keep_num);
+    }
+
+    if (keep_num == num) return;
+
+    destroy_count_.fetch_add(num - keep_num, std::memory_order_relaxed);
+    for (size_t ii = keep_num; ii < num; ++ii)
+      base_ptr_->destroy(base_ptr_->impl, msgs[ii]);
+  }
+
+  static void* CreateFunc(void* impl) {
+    return static_cast<MessagePool*>(impl)->Acquire();
+  }
+
+  static aimrt_type_support_base_t GenWrappedBase(MessagePool* pool) {
+    return aimrt_type_support_base_t{
+        .type_name = [](void* impl) -> aimrt_string_view_t {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          return base_ptr->type_name(base_ptr->impl);
+        },
+        .create = &CreateFunc,
+        .destroy = [](void* impl, void* msg) {
+          static_cast<MessagePool*>(impl)->Release(msg);
+        },
+        .copy = [](void* impl, const void* from, void* to) {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          base_ptr->copy(base_ptr->impl, from, to);
+        },
+        .move = [](void* impl, void* from, void* to) {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          base_ptr->move(base_ptr->impl, from, to);
+        },
+        .serialize = [](void* impl, aimrt_string_view_t serialization_type, const void* msg,
+                        const aimrt_buffer_array_allocator_t* allocator, aimrt_buffer_array_t* buffer_array) -> bool {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          return base_ptr->serialize(base_ptr->impl, serialization_type, msg, allocator, buffer_array);
+        },
+        .deserialize = [](void* impl, aimrt_string_view_t serialization_type,
+                          aimrt_buffer_array_view_t buffer_array_view, void* msg) -> bool {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          return base_ptr->deserialize(base_ptr->impl, serialization_type, buffer_array_view, msg);
+        },
+        .serialization_types_supported_num = [](void* impl) -> size_t {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          return base_ptr->serialization_types_supported_num(base_ptr->impl);
+        },
+        .serialization_types_supported_list = [](void* impl) -> const aimrt_string_view_t* {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          return base_ptr->serialization_types_supported_list(base_ptr->impl);
+        },
+        .custom_type_support_ptr = [](void* impl) -> const void* {
+          const auto* base_ptr = static_cast<MessagePool*>(impl)->base_ptr_;
+          return base_ptr->custom_type_support_ptr(base_ptr->impl);
+        },
+        .impl = pool};
+  }
+
+  const aimrt_type_support_base_t* base_ptr_;
+  const Options options_;
+  const ResetFunc reset_func_;
+  const aimrt_type_support_base_t wrapped_base_;
+  void* blank_msg_ = nullptr;
+
+  std::atomic<uint64_t> acquire_count_ = 0;
+  std::atomic<uint64_t> create_count_ = 0;
+  std::atomic<uint64_t> release_count_ = 0;
+  std::atomic<uint64_t> destroy_count_ = 0;
+
+  std::atomic<bool> closed_ = false;
+  std::atomic<uint32_t> active_num_ = 0;
+
+  mutable std::mutex mutex_;
+  std::vector<void*> free_list_;
+};
+
+/**
+ * @brief 进程级的消息对象池注册表，按原始type support为每个消息类型创建一个对象池
+ * @note 未启用时Wrap原样返回，没有额外开销；启用后对象池在CloseAll时关闭，模块动态库卸载前必须调用
+ */
+class MessagePoolRegistry {
+ public:
+  static MessagePoolRegistry& Instance() {
+    static MessagePoolRegistry* const instance = new MessagePoolRegistry();
+    return *instance;
+  }
+
+  MessagePoolRegistry(const MessagePoolRegistry&) = delete;
+  MessagePoolRegistry& operator=(const MessagePoolRegistry&) = delete;
+
+  void SetEnabled(bool enable) { enable_.store(enable, std::memory_order_relaxed); }
+  bool Enabled() const { return enable_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 设置对象池配置，只影响之后创建的对象池
+   *
+   * @param default_options 默认配置
+   * @param type_options 按消息类型名覆盖的配置
+   */
+  void SetOptions(const MessagePool::Options& default_options,
+                  const std::unordered_map<std::string, MessagePool::Options>& type_options = {}) {
+    std::lock_guard<std::mutex> lck(mutex_);
+    default_options_ = default_options;
+    type_options_ = type_options;
+  }
+
+  /**
+   * @brief 为消息类型注册重置函数，用于拷贝代价大或需要自定义回收语义的类型，只影响之后创建的对象池
+   */
+  void RegisterResetFunc(std::string_view type_name, MessagePool::ResetFunc reset_func) {
+    std::lock_guard<std::mutex> lck(mutex_);
+    reset_func_map_[std::string(type_name)] = reset_func;
+  }
+
+  /**
+   * @brief 获取带对象池的type support
+   *
+   * @param base_ptr 原始type support，需在CloseAll前有效
+   * @return 未启用时返回base_ptr本身
+   */
+  const aimrt_type_support_base_t* Wrap(const aimrt_type_support_base_t* base_ptr) {
+    if (!Enabled() || base_ptr == nullptr || MessagePool::IsWrapped(base_ptr)) return base_ptr;
+
+    std::lock_guard<std::mutex> lck(mutex_);
+    auto itr = pool_map_.find(base_ptr);
+    if (itr != pool_map_.end()) return itr->second->NativeHandle();
+
+    std::string type_name(aimrt::util::ToStdStringView(base_ptr->type_name(base_ptr->impl)));
+
+    auto options_itr = type_options_.find(type_name);
+    const auto& options = (options_itr != type_options_.end()) ? options_itr->second : default_options_;
+
+    auto reset_itr = reset_func_map_.find(type_name);
+    MessagePool::ResetFunc reset_func = (reset_itr != reset_func_map_.end()) ? reset_itr->second : nullptr;
+
+    // 对象池本身不析构，关闭后仍可能被其它线程的本地缓存或在途消息引用
+    auto* pool_ptr = new MessagePool(base_ptr, options, reset_func);
+    pool_map_.emplace(base_ptr, pool_ptr);
+    pool_vec_.emplace_back(pool_ptr);
+    return pool_ptr->NativeHandle();
+  }
+
+  /**
+   * @brief 关闭所有对象池并停止包装，之后再Wrap同一地址的type support会创建新的对象池
+   * @note 在框架不再收发消息后、模块动态库卸载前调用
+   */
+  void CloseAll() {
+    SetEnabled(false);
+
+    std::vector<MessagePool*> pool_vec;
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      for (auto& itr : pool_map_) pool_vec.emplace_back(itr.second);
+      pool_map_.clear();
+      pool_vec_.clear();
+      closed_pool_vec_.insert(closed_pool_vec_.end(), pool_vec.begin(), pool_vec.end());
+    }
+
+    for (auto* pool_ptr : pool_vec) pool_ptr->Close();
+  }
+
+  std::vector<MessagePool::Stats> GetStats() const {
+    std::vector<const MessagePool*> pool_vec;
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      pool_vec = pool_vec_;
+    }
+
+    std::vector<MessagePool::Stats> stats_vec;
+    stats_vec.reserve(pool_vec.size());
+    for (const auto* pool_ptr : pool_vec) stats_vec.emplace_back(pool_ptr->GetStats());
+    return stats_vec;
+  }
+
+ private:
+  MessagePoolRegistry() = default;
+
+  std::atomic<bool> enable_ = false;
+
+  mutable std::mutex mutex_;
+  MessagePool::Options default_options_;
+  std::unordered_map<std::string, MessagePool::Options> type_options_;
+  std::unordered_map<std::string, MessagePool::ResetFunc> reset_func_map_;
+  std::unordered_map<const aimrt_type_support_base_t*, MessagePool*> pool_map_;
+  std::vector<const MessagePool*> pool_vec_;
+  std::vector<const MessagePool*> closed_pool_vec_;
+};
+
+}  // namespace aimrt::runtime::core::allocator
@@ -0,0 +1,252 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/allocator/message_pool.h"
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aimrt::runtime::core::allocator {
+
+namespace {
+
+struct TestMsg {
+  std::string name;
+  std::vector<double> data;
+};
+
+std::atomic<uint64_t> test_msg_create_num = 0;
+std::atomic<uint64_t> test_msg_destroy_num = 0;
+
+template <int N>
+const aimrt_type_support_base_t* GetTestMsgTypeSupport() {
+  static const aimrt_type_support_base_t kTs{
+      .type_name = [](void* /*impl*/) -> aimrt_string_view_t {
+        static const std::string kName = "test_msg_" + std::to_string(N);
+        return aimrt::util::ToAimRTStringView(kName);
+      },
+      .create = [](void* /*impl*/) -> void* {
+        test_msg_create_num.fetch_add(1);
+        return new TestMsg();
+      },
+      .destroy = [](void* /*impl*/, void* msg) {
+        test_msg_destroy_num.fetch_add(1);
+        delete static_cast<TestMsg*>(msg);
+      },
+      .copy = [](void* /*impl*/, const void* from, void* to) {
+        *static_cast<TestMsg*>(to) = *static_cast<const TestMsg*>(from);
+      },
+      .move = [](void* /*impl*/, void* from, void* to) {
+        *static_cast<TestMsg*>(to) = std::move(*static_cast<TestMsg*>(from));
+      },
+      .serialize = [](void* /*impl*/, aimrt_string_view_t /*serialization_type*/, const void* /*msg*/,
+                      const aimrt_buffer_array_allocator_t* /*allocator*/, aimrt_buffer_array_t* /*buffer_array*/) -> bool {
+        return false;
+      },
+      .deserialize = [](void* /*impl*/, aimrt_string_view_t /*serialization_type*/,
+                        aimrt_buffer_array_view_t /*buffer_array_view*/, void* /*msg*/) -> bool {
+        return false;
+      },
+      .serialization_types_supported_num = [](void* /*impl*/) -> size_t { return 0; },
+      .serialization_types_supported_list = [](void* /*impl*/) -> const aimrt_string_view_t* { return nullptr; },
+      .custom_type_support_ptr = [](void* /*impl*/) -> const void* { return &kTs; },
+      .impl = nullptr};
+  return &kTs;
+}
+
+}  // namespace
+
+TEST(MessagePoolTest, Disabled) {
+  auto& registry = MessagePoolRegistry::Instance();
+  registry.SetEnabled(false);
+
+  const auto* base_ptr = GetTestMsgTypeSupport<0>();
+  EXPECT_EQ(registry.Wrap(base_ptr), base_ptr);
+}
+
+TEST(MessagePoolTest, ReuseAndReset) {
+  auto& registry = MessagePoolRegistry::Instance();
+  registry.SetEnabled(true);
+  registry.SetOptions(MessagePool::Options{.thread_cache_num = 4, .max_cache_num = 4});
+
+  const auto* base_ptr = GetTestMsgTypeSupport<1>();
+  const auto* ts = registry.Wrap(base_ptr);
+  ASSERT_NE(ts, base_ptr);
+  EXPECT_EQ(registry.Wrap(base_ptr), ts);
+  EXPECT_EQ(registry.Wrap(ts), ts);
+
+  // 其余接口原样转发
+  EXPECT_EQ(aimrt::util::ToStdStringView(ts->type_name(ts->impl)), "test_msg_1");
+  EXPECT_EQ(ts->custom_type_support_ptr(ts->impl), base_ptr);
+
+  auto* msg = static_cast<TestMsg*>(ts->create(ts->impl));
+  msg->name = "hello";
+  msg->data = {1.0, 2.0};
+  ts->destroy(ts->impl, msg);
+
+  // 回收的消息被重置后复用
+  auto* reused_msg = static_cast<TestMsg*>(ts->create(ts->impl));
+  EXPECT_EQ(reused_msg, msg);
+  EXPECT_TRUE(reused_msg->name.empty());
+  EXPECT_TRUE(reused_msg->data.empty());
+  ts->destroy(ts->impl, reused_msg);
+
+  std::vector<void*> msgs;
+  for (int ii = 0; ii < 20; ++ii) msgs.emplace_back(ts->create(ts->impl));
+  for (void* ptr : msgs) ts->destroy(ts->impl, ptr);
+
+  // 本地缓存和全局空闲表都只保留4个，其余销毁
+  auto stats = registry.GetStats();
+  auto itr = std::find_if(stats.begin(), stats.end(), [](const auto& item) { return item.type_name == "test_msg_1"; });
+  ASSERT_NE(itr, stats.end());
+  EXPECT_EQ(itr->acquire_count, 22);
+  EXPECT_EQ(itr->create_count, 20);
+  EXPECT_EQ(itr->HitCount(), 2);
+  EXPECT_EQ(itr->release_count, 22);
+  EXPECT_EQ(itr->global_cache_num, 4);
+  EXPECT_EQ(itr->destroy_count, 20 - 4 - 2);
+}
+
+TEST(MessagePoolTest, ResetFuncAndPrewarm) {
+  auto& registry = MessagePoolRegistry::Instance();
+  registry.SetEnabled(true);
+  registry.SetOptions(
+      MessagePool::Options{},
+      {{"test_msg_2", MessagePool::Options{.thread_cache_num = 8, .max_cache_num = 16, .prewarm_num = 10}}});
+  registry.RegisterResetFunc("test_msg_2", [](void* msg) {
+    // 只清空name，保留data的内容
+    static_cast<TestMsg*>(msg)->name.clear();
+  });
+
+  const uint64_t create_num = test_msg_create_num.load();
+  const auto* ts = registry.Wrap(GetTestMsgTypeSupport<2>());
+  EXPECT_EQ(test_msg_create_num.load() - create_num, 10);
+
+  auto* msg = static_cast<TestMsg*>(ts->create(ts->impl));
+  msg->name = "hello";
+  msg->data = {1.0};
+  ts->destroy(ts->impl, msg);
+
+  auto* reused_msg = static_cast<TestMsg*>(ts->create(ts->impl));
+  EXPECT_EQ(reused_msg, msg);
+  EXPECT_TRUE(reused_msg->name.empty());
+  EXPECT_EQ(reused_msg->data.size(), 1);
+  ts->destroy(ts->impl, reused_msg);
+
+  std::vector<void*> msgs;
+  for (int ii = 0; ii < 10; ++ii) msgs.emplace_back(ts->create(ts->impl));
+  for (void* ptr : msgs) ts->destroy(ts->impl, ptr);
+
+  // 预热的消息足够使用，不再新建
+  EXPECT_EQ(test_msg_create_num.load() - create_num, 10);
+}
+
+TEST(MessagePoolTest, CrossThread) {
+  auto& registry = MessagePoolRegistry::Instance();
+  registry.SetEnabled(true);
+  registry.SetOptions(MessagePool::Options{.thread_cache_num = 16, .max_cache_num = 1024});
+
+  const auto* ts = registry.Wrap(GetTestMsgTypeSupport<3>());
+
+  constexpr int kThreadNum = 4;
+  constexpr int kLoops = 10000;
+
+  // 一个线程创建，另一个线程销毁，模拟订阅回调在其它执行器中释放消息
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadNum; ++t) {
+    threads.emplace_back([ts]() {
+      std::vector<void*> msgs;
+      for (int ii = 0; ii < kLoops; ++ii) {
+        auto* msg = static_cast<TestMsg*>(ts->create(ts->impl));
+        EXPECT_TRUE(msg->name.empty());
+        msg->name = "msg";
+        msgs.emplace_back(msg);
+        if (msgs.size() == 64) {
+          std::thread([ts, msgs = std::move(msgs)]() {
+            for (void* ptr : msgs) ts->destroy(ts->impl, ptr);
+          }).join();
+          msgs.clear();
+        }
+      }
+      for (void* ptr : msgs) ts->destroy(ts->impl, ptr);
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  // 线程退出时本地缓存归还到全局空闲表
+  auto stats = registry.GetStats();
+  auto itr = std::find_if(stats.begin(), stats.end(), [](const auto& item) { return item.type_name == "test_msg_3"; });
+  ASSERT_NE(itr, stats.end());
+  EXPECT_EQ(itr->acquire_count, kThreadNum * kLoops);
+  EXPECT_EQ(itr->release_count, kThreadNum * kLoops);
+  EXPECT_EQ(itr->global_cache_num + itr->destroy_count, itr->create_count);
+  EXPECT_GT(itr->HitCount(), kThreadNum * kLoops / 2);
+}
+
+TEST(MessagePoolTest, CloseAll) {
+  auto& registry = MessagePoolRegistry::Instance();
+  registry.SetEnabled(true);
+  registry.SetOptions(MessagePool::Options{.thread_cache_num = 4, .max_cache_num = 16, .prewarm_num = 8});
+
+  const auto* base_ptr = GetTestMsgTypeSupport<5>();
+  const auto* ts = registry.Wrap(base_ptr);
+
+  void* in_use_msg = ts->create(ts->impl);
+  std::vector<void*> msgs;
+  for (int ii = 0; ii < 10; ++ii) msgs.emplace_back(ts->create(ts->impl));
+  for (void* ptr : msgs) ts->destroy(ts->impl, ptr);
+
+  // 关闭后所有对象池中的空闲消息和空白消息都被销毁，只剩使用中的消息。
+  // 之前用例中其它线程的本地缓存已在线程退出时归还到全局空闲表
+  registry.CloseAll();
+  EXPECT_FALSE(registry.Enabled());
+  EXPECT_EQ(test_msg_create_num.load() - test_msg_destroy_num.load(), 1);
+
+  // 关闭后取出/回收直接转发给原始type support
+  ts->destroy(ts->impl, in_use_msg);
+  void* msg = ts->create(ts->impl);
+  ts->destroy(ts->impl, msg);
+  EXPECT_EQ(test_msg_create_num.load(), test_msg_destroy_num.load());
+
+  // 同一地址的type support重新注册时使用新的对象池
+  registry.SetEnabled(true);
+  const auto* new_ts = registry.Wrap(base_ptr);
+  EXPECT_NE(new_ts, ts);
+  registry.CloseAll();
+  EXPECT_EQ(test_msg_create_num.load(), test_msg_destroy_num.load());
+}
+
+TEST(MessagePoolTest, Benchmark) {
+  auto& registry = MessagePoolRegistry::Instance();
+  registry.SetEnabled(true);
+  registry.SetOptions(MessagePool::Options{});
+
+  const auto* base_ptr = GetTestMsgTypeSupport<4>();
+  const auto* ts = registry.Wrap(base_ptr);
+
+  constexpr int kLoops = 1000000;
+
+  auto run = [&](const aimrt_type_support_base_t* ts) {
+    auto begin = std::chrono::steady_clock::now();
+    for (int ii = 0; ii < kLoops; ++ii) {
+      auto* msg = static_cast<TestMsg*>(ts->create(ts->impl));
+      msg->name = "a message name longer than sso";
+      msg->data.resize(16);
+      ts->destroy(ts->impl, msg);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / kLoops;
+  };
+
+  const double new_ns = run(base_ptr);
+  const double pool_ns = run(ts);
+
+  std::cout << "new/delete " << new_ns << " ns, pooled " << pool_ns << " ns" << std::endl;
+}
+
+}  // namespace aimrt::runtime::core::allocator
@@ -0,0 +1,79 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include "aimrt_module_c_interface/util/buffer_base.h"
+#include "aimrt_module_cpp_interface/util/simple_buffer_array_allocator.h"
+#include "util/alloc_tracker.h"
+
+namespace aimrt::runtime::core::allocator {
+
+/**
+ * @brief 计入AllocTracker分配域的buffer array分配器
+ * @note 分配器表在进程内常驻，使用其分配的buffer array可以安全地延迟到任意时刻释放
+ *
+ */
+class TrackedBufferArrayAllocator {
+ public:
+  /**
+   * @brief 获取分配域对应的分配器
+   * @note 未启用AllocTracker时返回SimpleBufferArrayAllocator，没有额外开销
+   *
+   * @param domain AllocTracker::RegisterDomain的返回值
+   */
+  static const aimrt_buffer_array_allocator_t* NativeHandle(uint32_t domain) {
+    if (!common::util::AllocTracker::Instance().Enabled())
+      return aimrt::util::SimpleBufferArrayAllocator::NativeHandle();
+
+    static const auto* const kAllocatorArray = GenAllocatorArray();
+    return &kAllocatorArray[(domain < common::util::AllocTracker::kMaxDomains) ? domain : common::util::AllocTracker::kOtherDomain];
+  }
+
+ private:
+  static aimrt_buffer_t Allocate(uint32_t domain, aimrt_buffer_array_t* buffer_array, size_t size) {
+    void* data = common::util::AllocTracker::Instance().Allocate(domain, size);
+
+    if (omnirt_unlikely(data == nullptr))
+      return aimrt_buffer_t{nullptr, 0};
+
+    if (buffer_array->capacity <= buffer_array->len) {
+      static constexpr size_t kInitCapacitySzie = 2;
+      size_t new_capacity = (buffer_array->capacity < kInitCapacitySzie)
+                                ? kInitCapacitySzie
+                                : (buffer_array->capacity << 1);
+      aimrt::util::SimpleBufferArrayAllocator::Reserve(buffer_array, new_capacity);
+    }
+
+    return (buffer_array->data[buffer_array->len++] = aimrt_buffer_t{data, size});
+  }
+
+  static void Release(aimrt_buffer_array_t* buffer_array) {
+    for (size_t ii = 0; ii < buffer_array->len; ++ii) {
+      common::util::AllocTracker::Instance().Free(buffer_array->data[ii].data);
+    }
+
+    if (buffer_array->data) delete[] buffer_array->data;
+  }
+
+  static const aimrt_buffer_array_allocator_t* GenAllocatorArray() {
+    // 进程级常驻，不析构
+    auto* allocator_array = new aimrt_buffer_array_allocator_t[common::util::AllocTracker::kMaxDomains];
+    for (uint32_t ii = 0; ii < common::util::AllocTracker::kMaxDomains; ++ii) {
+      allocator_array[ii] = aimrt_buffer_array_allocator_t{
+          .reserve = [](void* impl, aimrt_buffer_array_t* buffer_array, size_t new_cap) {
+            aimrt::util::SimpleBufferArrayAllocator::Reserve(buffer_array, new_cap);  //
+          },
+          .allocate = [](void* impl, aimrt_buffer_array_t* buffer_array, size_t size) -> aimrt_buffer_t {
+            return Allocate(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(impl)), buffer_array, size);
+          },
+          .release = [](void* impl, aimrt_buffer_array_t* buffer_array) {
+            Release(buffer_array);  //
+          },
+          .impl = reinterpret_cast<void*>(static_cast<uintptr_t>(ii))};
+    }
+    return allocator_array;
+  }
+};
+
+}  // namespace aimrt::runtime::core::allocator
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "aimrt_module_cpp_interface/channel/channel_handle.h"
+#include "core/allocator/message_pool.h"
 #include "core/channel/channel_backend_tools.h"
 #include "util/macros.h"
 
@@ -108,7 +109,8 @@ bool ChannelBackendManager::Subscribe(SubscribeProxyInfoWrapper&& wrapper) {
   }
 
   auto topic_name = wrapper.topic_name;
-  auto msg_type_support_ref = aimrt::util::TypeSupportRef(wrapper.msg_type_support);
+  auto msg_type_support_ref = aimrt::util::TypeSupportRef(
+      allocator::MessagePoolRegistry::Instance().Wrap(wrapper.msg_type_support));
   auto msg_type = msg_type_support_ref.TypeName();
 
   // create sub wrapper
@@ -190,7 +192,8 @@ bool ChannelBackendManager::RegisterPublishType(RegisterPublishTypeProxyInfoWrap
   }
 
   auto topic_name = wrapper.topic_name;
-  auto msg_type_support_ref = aimrt::util::TypeSupportRef(wrapper.msg_type_support);
+  auto msg_type_support_ref = aimrt::util::TypeSupportRef(
+      allocator::MessagePoolRegistry::Instance().Wrap(wrapper.msg_type_support));
   auto msg_type = msg_type_support_ref.TypeName();
 
   // create pub wrapper
@@ -5,11 +5,20 @@
 
 #include <vector>
 
+#include "core/allocator/tracked_buffer_array_allocator.h"
 #include "core/channel/channel_registry.h"
+#include "core/util/serialization_codec.h"
 #include "util/macros.h"
 
 namespace aimrt::runtime::core::channel {
 
+/// channel序列化使用的分配器，开启分配统计时计入channel.serialization分配域
+inline const aimrt_buffer_array_allocator_t* ChannelSerializationAllocator() {
+  static const uint32_t kTrackDomain =
+      aimrt::common::util::AllocTracker::Instance().RegisterDomain("channel.serialization");
+  return allocator::TrackedBufferArrayAllocator::NativeHandle(kTrackDomain);
+}
+
 class SubscribeTool {
  public:
   SubscribeTool() = default;
@@ -42,21 +51,22 @@ class SubscribeTool {
 
     if (sub_wrapper_vec_.size() == 1) return;
 
-    auto buffer_array_ptr = std::make_unique<aimrt::util::BufferArray>();
+    aimrt::util::BufferArray buffer_array(ChannelSerializationAllocator());
     auto serialization_type = msg_sub_wrapper.info.msg_type_support_ref.DefaultSerializationType();
 
     bool serialize_ret = msg_sub_wrapper.info.msg_type_support_ref.Serialize(
         serialization_type,
         msg_ptr.get(),
-        buffer_array_ptr->AllocatorNativeHandle(),
-        buffer_array_ptr->BufferArrayNativeHandle());
+        buffer_array.AllocatorNativeHandle(),
+        buffer_array.BufferArrayNativeHandle());
 
     AIMRT_ASSERT(serialize_ret, "Serialize failed.");
 
-    auto* ptr = buffer_array_ptr.get();
-    auto buffer_array_view_ptr = std::shared_ptr<aimrt::util::BufferArrayView>(
-        new aimrt::util::BufferArrayView(*ptr),
-        [buffer_array_ptr{std::move(buffer_array_ptr)}](const auto* ptr) { delete ptr; });
+    // 序列化结果转为共享buffer,所有订阅者共享同一份数据
+    auto buffer_array_view_ptr =
+        std::make_shared<aimrt::util::BufferArrayView>(buffer_array.MoveToSharedBuffer());
+
+    const uint32_t serialization_type_index = util::SerializationCache::TypeIndex(serialization_type);
 
     for (size_t ii = 1; ii < sub_wrapper_vec_.size(); ++ii) {
       const auto* sub_wrapper_ptr = sub_wrapper_vec_[ii];
@@ -65,7 +75,7 @@ class SubscribeTool {
           .msg_ptr = nullptr,
           .ctx_ref = ctx_ptr};
 
-      sub_msg_wrapper.serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+      sub_msg_wrapper.serialization_cache.EmplaceByIndex(serialization_type_index, buffer_array_view_ptr);
 
       sub_wrapper_ptr->callback(sub_msg_wrapper, [ctx_ptr]() {});
     }
@@ -81,22 +91,26 @@ class SubscribeTool {
     if (!need_cache_flag) {
       DoSubscribeCallbackWithoutCache(ctx_ptr, serialization_type, buffer_array_view);
     } else {
-      const auto* buffer_array_data = buffer_array_view.Data();
-      const size_t buffer_array_len = buffer_array_view.Size();
-      size_t msg_size = buffer_array_view.BufferSize();
-
-      std::unique_ptr<std::vector<uint8_t>> buffer_ptr = std::make_unique<std::vector<uint8_t>>(msg_size);
-      uint8_t* cur_pos = buffer_ptr->data();
-      for (size_t ii = 0; ii < buffer_array_len; ++ii) {
-        memcpy(cur_pos, buffer_array_data[ii].data, buffer_array_data[ii].len);
-        cur_pos += buffer_array_data[ii].len;
-      }
-
-      auto* ptr = buffer_ptr.get();
-      auto buffer_array_view_ptr = std::shared_ptr<aimrt::util::BufferArrayView>(
-          new aimrt::util::BufferArrayView(ptr->data(), ptr->size()),
-          [buffer_ptr{std::move(buffer_ptr)}](const auto* ptr) { delete ptr; });
+      // 视图本身由共享buffer支撑时不拷贝
+      auto buffer_array_view_ptr =
+          std::make_shared<aimrt::util::BufferArrayView>(buffer_array_view.Share());
+
+      DoSubscribeCallbackWithCache(ctx_ptr, serialization_type, buffer_array_view_ptr);
+    }
+  }
+
+  void DoSubscribeCallback(
+      const std::shared_ptr<aimrt::channel::Context>& ctx_ptr,
+      const std::string& serialization_type,
+      const aimrt::util::SharedBuffer& shared_buffer) const {
+    bool need_cache_flag =
+        (require_cache_serialization_types_.find(serialization_type) != require_cache_serialization_types_.end());
 
+    if (!need_cache_flag) {
+      aimrt::util::BufferArrayView buffer_array_view(shared_buffer);
+      DoSubscribeCallbackWithoutCache(ctx_ptr, serialization_type, buffer_array_view);
+    } else {
+      auto buffer_array_view_ptr = std::make_shared<aimrt::util::BufferArrayView>(shared_buffer);
       DoSubscribeCallbackWithCache(ctx_ptr, serialization_type, buffer_array_view_ptr);
     }
   }
@@ -112,13 +126,8 @@ class SubscribeTool {
       aimrt::util::BufferArrayView buffer_array_view(data, len);
       DoSubscribeCallbackWithoutCache(ctx_ptr, serialization_type, buffer_array_view);
     } else {
-      std::unique_ptr<std::vector<uint8_t>> buffer_ptr = std::make_unique<std::vector<uint8_t>>(len);
-      memcpy(buffer_ptr->data(), data, len);
-
-      auto* ptr = buffer_ptr.get();
-      auto buffer_array_view_ptr = std::shared_ptr<aimrt::util::BufferArrayView>(
-          new aimrt::util::BufferArrayView(ptr->data(), ptr->size()),
-          [buffer_ptr{std::move(buffer_ptr)}](const auto* ptr) { delete ptr; });
+      auto buffer_array_view_ptr =
+          std::make_shared<aimrt::util::BufferArrayView>(aimrt::util::SharedBuffer::Copy(data, len));
 
       DoSubscribeCallbackWithCache(ctx_ptr, serialization_type, buffer_array_view_ptr);
     }
@@ -134,8 +143,8 @@ class SubscribeTool {
 
       std::shared_ptr<void> msg_ptr = subscribe_type_support_ref.CreateSharedPtr();
 
-      bool deserialize_ret = subscribe_type_support_ref.Deserialize(
-          serialization_type, *(buffer_array_view.NativeHandle()), msg_ptr.get());
+      bool deserialize_ret = util::DeserializeWithCodec(
+          subscribe_type_support_ref, serialization_type, *(buffer_array_view.NativeHandle()), msg_ptr.get());
 
       AIMRT_ASSERT(deserialize_ret, "Msg deserialize failed.");
 
@@ -154,13 +163,16 @@ class SubscribeTool {
       const std::shared_ptr<aimrt::channel::Context>& ctx_ptr,
       const std::string& serialization_type,
       const std::shared_ptr<aimrt::util::BufferArrayView>& buffer_array_view_ptr) const {
+    // 所有订阅者共用同一下标，只查找一次驻留表
+    const uint32_t serialization_type_index = util::SerializationCache::TypeIndex(serialization_type);
+
     for (const auto* sub_wrapper_ptr : sub_wrapper_vec_) {
       runtime::core::channel::MsgWrapper sub_msg_wrapper{
           .info = sub_wrapper_ptr->info,
           .msg_ptr = nullptr,
           .ctx_ref = ctx_ptr};
 
-      sub_msg_wrapper.serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+      sub_msg_wrapper.serialization_cache.EmplaceByIndex(serialization_type_index, buffer_array_view_ptr);
 
       sub_wrapper_ptr->callback(sub_msg_wrapper, [ctx_ptr]() {});
     }
@@ -171,23 +183,29 @@ class SubscribeTool {
   std::unordered_set<std::string> require_cache_serialization_types_;
 };
 
-inline void CheckMsg(MsgWrapper& msg_wrapper) {
+namespace channel_detail {
+
+inline void ResolveMsg(MsgWrapper& msg_wrapper) {
   if (msg_wrapper.msg_ptr != nullptr) return;
 
   const auto& serialization_cache = msg_wrapper.serialization_cache;
   const auto& info = msg_wrapper.info;
 
-  AIMRT_ASSERT(!serialization_cache.empty(),
+  AIMRT_ASSERT(!serialization_cache.Empty(),
                "Can not get msg, msg is null and serialization cache is empty.");
 
-  if (serialization_cache.size() == 1) {
+  if (serialization_cache.Size() == 1) {
     auto msg_cache_ptr = info.msg_type_support_ref.CreateSharedPtr();
 
-    const auto& serialization_type = serialization_cache.begin()->first;
-    auto buffer_array_view_ptr = serialization_cache.begin()->second;
+    std::string_view serialization_type;
+    std::shared_ptr<aimrt::util::BufferArrayView> buffer_array_view_ptr;
+    serialization_cache.ForEach([&](std::string_view type, const auto& ptr) {
+      serialization_type = type;
+      buffer_array_view_ptr = ptr;
+    });
 
-    bool deserialize_ret = info.msg_type_support_ref.Deserialize(
-        serialization_type, *(buffer_array_view_ptr->NativeHandle()), msg_cache_ptr.get());
+    bool deserialize_ret = util::DeserializeWithCodec(
+        info.msg_type_support_ref, serialization_type, *(buffer_array_view_ptr->NativeHandle()), msg_cache_ptr.get());
 
     AIMRT_ASSERT(deserialize_ret,
                  "Can not get msg, msg is null and deserialize failed.");
@@ -203,16 +221,38 @@ inline void CheckMsg(MsgWrapper& msg_wrapper) {
   for (const auto& item : serialization_types_supported_list) {
     auto serialization_type = aimrt::util::ToStdStringView(item);
 
-    auto finditr = serialization_cache.find(std::string(serialization_type));
-    if (omnirt_unlikely(finditr == serialization_cache.end()))
+    auto buffer_array_view_ptr = serialization_cache.Find(serialization_type);
+    if (omnirt_unlikely(!buffer_array_view_ptr))
       continue;
 
     auto msg_cache_ptr = info.msg_type_support_ref.CreateSharedPtr();
 
-    auto buffer_array_view_ptr = finditr->second;
+    bool deserialize_ret = util::DeserializeWithCodec(
+        info.msg_type_support_ref, serialization_type, *(buffer_array_view_ptr->NativeHandle()), msg_cache_ptr.get());
+
+    AIMRT_ASSERT(deserialize_ret,
+                 "Can not get msg, msg is null and deserialize failed.");
+
+    msg_wrapper.msg_cache_ptr = std::move(msg_cache_ptr);
+    msg_wrapper.msg_ptr = msg_wrapper.msg_cache_ptr.get();
+    return;
+  }
+
+  // 缓存中只有压缩序列化类型(如"pb+lz4")的结果时，按其基础序列化类型反序列化
+  std::string_view serialization_type;
+  std::shared_ptr<aimrt::util::BufferArrayView> buffer_array_view_ptr;
+  serialization_cache.ForEach([&](std::string_view type, const auto& ptr) {
+    if (!buffer_array_view_ptr && !util::SerializationCodec::SplitSerializationType(type).second.empty()) {
+      serialization_type = type;
+      buffer_array_view_ptr = ptr;
+    }
+  });
 
-    bool deserialize_ret = info.msg_type_support_ref.Deserialize(
-        serialization_type, *(buffer_array_view_ptr->NativeHandle()), msg_cache_ptr.get());
+  if (buffer_array_view_ptr) {
+    auto msg_cache_ptr = info.msg_type_support_ref.CreateSharedPtr();
+
+    bool deserialize_ret = util::DeserializeWithCodec(
+        info.msg_type_support_ref, serialization_type, *(buffer_array_view_ptr->NativeHandle()), msg_cache_ptr.get());
 
     AIMRT_ASSERT(deserialize_ret,
                  "Can not get msg, msg is null and deserialize failed.");
@@ -225,6 +265,16 @@ inline void CheckMsg(MsgWrapper& msg_wrapper) {
   throw aimrt::common::util::AimRTException("Can not get msg, msg is null and can not deserialize from cache.");
 }
 
+}  // namespace channel_detail
+
+/**
+ * @brief 确保msg_ptr可用，为空时从序列化缓存反序列化
+ * @note 多个后端可能并行调用，解析只执行一次，其余调用等待其完成
+ */
+inline void CheckMsg(MsgWrapper& msg_wrapper) {
+  msg_wrapper.msg_resolve_guard.Call([&msg_wrapper]() { channel_detail::ResolveMsg(msg_wrapper); });
+}
+
 inline bool TryCheckMsg(MsgWrapper& msg_wrapper) noexcept {
   try {
     CheckMsg(msg_wrapper);
@@ -234,34 +284,60 @@ inline bool TryCheckMsg(MsgWrapper& msg_wrapper) noexcept {
   }
 }
 
-inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeMsgWithCache(
-    MsgWrapper& msg_wrapper, std::string_view serialization_type) {
+/**
+ * @brief 按序列化类型下标获取序列化结果，缓存中没有时序列化并放入缓存
+ * @note 热点路径应预先取得下标(util::SerializationCache::TypeIndex)，命中缓存时不处理序列化类型字符串
+ */
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeMsgWithCacheByIndex(
+    MsgWrapper& msg_wrapper, uint32_t serialization_type_index) {
   auto& serialization_cache = msg_wrapper.serialization_cache;
-  const auto& info = msg_wrapper.info;
-
-  auto finditr = serialization_cache.find(std::string(serialization_type));
-  if (finditr != serialization_cache.end())
-    return finditr->second;
+  if (auto buffer_array_view_ptr = serialization_cache.FindByIndex(serialization_type_index))
+    return buffer_array_view_ptr;
 
+  // 在进入任何类型的槽位之前解析消息，槽位的创建函数中只做序列化
   CheckMsg(msg_wrapper);
 
-  auto buffer_array_ptr = std::make_unique<aimrt::util::BufferArray>();
-  bool serialize_ret = info.msg_type_support_ref.Serialize(
-      serialization_type,
-      msg_wrapper.msg_ptr,
-      buffer_array_ptr->AllocatorNativeHandle(),
-      buffer_array_ptr->BufferArrayNativeHandle());
+  const std::string_view serialization_type = util::SerializationCache::TypeName(serialization_type_index);
+
+  // 压缩序列化类型：基础序列化结果同样进入缓存，与使用基础类型的后端共享，每条消息只压缩一次
+  auto [base_type, codec_name] = util::SerializationCodec::SplitSerializationType(serialization_type);
+  if (!codec_name.empty()) {
+    const uint32_t base_type_index = util::SerializationCache::TypeIndex(base_type);
+    return serialization_cache.GetOrCreateByIndex(serialization_type_index, [&, base_type_index, codec_name = codec_name]() {
+      auto base_buffer_array_view_ptr = SerializeMsgWithCacheByIndex(msg_wrapper, base_type_index);
+      return std::make_shared<aimrt::util::BufferArrayView>(
+          util::SerializationCodec::Instance().Encode(codec_name, *(base_buffer_array_view_ptr->NativeHandle())));
+    });
+  }
 
-  AIMRT_ASSERT(serialize_ret, "Serialize failed.");
+  // 多个后端并行发布同一消息时，同一序列化类型只序列化一次，其余后端等待并共享结果
+  return serialization_cache.GetOrCreateByIndex(serialization_type_index, [&]() {
+    aimrt::util::BufferArray buffer_array(ChannelSerializationAllocator());
+    bool serialize_ret = msg_wrapper.info.msg_type_support_ref.Serialize(
+        serialization_type,
+        msg_wrapper.msg_ptr,
+        buffer_array.AllocatorNativeHandle(),
+        buffer_array.BufferArrayNativeHandle());
 
-  auto* ptr = buffer_array_ptr.get();
-  auto buffer_array_view_ptr = std::shared_ptr<aimrt::util::BufferArrayView>(
-      new aimrt::util::BufferArrayView(*ptr),
-      [buffer_array_ptr{std::move(buffer_array_ptr)}](const auto* ptr) { delete ptr; });
+    AIMRT_ASSERT(serialize_ret, "Serialize failed.");
 
-  serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+    // 缓存中的视图持有共享buffer,后端、录制等消费者可通过Share()零拷贝地保留数据
+    return std::make_shared<aimrt::util::BufferArrayView>(buffer_array.MoveToSharedBuffer());
+  });
+}
 
-  return buffer_array_view_ptr;
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeMsgWithCache(
+    MsgWrapper& msg_wrapper, std::string_view serialization_type) {
+  return SerializeMsgWithCacheByIndex(msg_wrapper, util::SerializationCache::TypeIndex(serialization_type));
+}
+
+inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeMsgWithCacheByIndex(
+    MsgWrapper& msg_wrapper, uint32_t serialization_type_index) noexcept {
+  try {
+    return SerializeMsgWithCacheByIndex(msg_wrapper, serialization_type_index);
+  } catch (...) {
+    return {};
+  }
 }
 
 inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeMsgWithCache(
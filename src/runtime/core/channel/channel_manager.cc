@@ -609,12 +609,15 @@ void ChannelManager::RegisterLocalChannelBackend() {
  *          过滤器会尝试将消息序列化为JSON格式以便于调试
  */
 void ChannelManager::RegisterDebugLogFilter() {
+  // 注册时取得json的序列化类型下标，每条消息不再查找驻留表
+  const uint32_t json_type_index = util::SerializationCache::TypeIndex("json");
+
   // 注册发布消息的调试过滤器
   RegisterPublishFilter(
       "debug_log",
-      [this](MsgWrapper& msg_wrapper, FrameworkAsyncChannelHandle&& h) {
+      [this, json_type_index](MsgWrapper& msg_wrapper, FrameworkAsyncChannelHandle&& h) {
         // 尝试将消息序列化为JSON格式
-        auto buf_ptr = TrySerializeMsgWithCache(msg_wrapper, "json");
+        auto buf_ptr = TrySerializeMsgWithCacheByIndex(msg_wrapper, json_type_index);
 
         if (buf_ptr) {
           auto msg_str = buf_ptr->JoinToString();
@@ -639,9 +642,9 @@ void ChannelManager::RegisterDebugLogFilter() {
   // 注册订阅消息的调试过滤器
   RegisterSubscribeFilter(
       "debug_log",
-      [this](MsgWrapper& msg_wrapper, FrameworkAsyncChannelHandle&& h) {
+      [this, json_type_index](MsgWrapper& msg_wrapper, FrameworkAsyncChannelHandle&& h) {
         // 尝试将消息序列化为JSON格式
-        auto buf_ptr = TrySerializeMsgWithCache(msg_wrapper, "json");
+        auto buf_ptr = TrySerializeMsgWithCacheByIndex(msg_wrapper, json_type_index);
 
         if (buf_ptr) {
           auto msg_str = buf_ptr->JoinToString();
@@ -3,11 +3,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
 #include <string>
-#include <unordered_map>
 
 #include "aimrt_module_cpp_interface/channel/channel_context.h"
 #include "aimrt_module_cpp_interface/util/type_support.h"
+#include "core/util/serialization_cache.h"
 
 namespace aimrt::runtime::core::channel {
 
@@ -24,6 +26,37 @@ struct TopicInfo {
   aimrt::util::TypeSupportRef msg_type_support_ref;
 };
 
+/**
+ * @brief 消息解析的一次性保护，多个后端并行发布同一消息时只有一个从缓存反序列化出消息
+ * @note 拷贝、移动得到的是未解析状态的新保护，解析时会先检查已拷贝过来的msg_ptr
+ *
+ */
+class MsgResolveGuard {
+ public:
+  MsgResolveGuard() = default;
+  ~MsgResolveGuard() = default;
+
+  MsgResolveGuard(const MsgResolveGuard&) {}
+  MsgResolveGuard& operator=(const MsgResolveGuard&) { return *this; }
+
+  /**
+   * @brief 执行一次resolve，并发调用者等待其完成；resolve抛异常时不算完成，之后的调用会重试
+   */
+  template <typename F>
+  void Call(F&& resolve) {
+    if (done_.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (done_.load(std::memory_order_relaxed)) return;
+    resolve();
+    done_.store(true, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<bool> done_{false};
+  std::mutex mutex_;
+};
+
 /**
  * @brief Sub/Pub msg info with cache
  *
@@ -38,16 +71,14 @@ struct MsgWrapper {
   /// ref to ctx, may be empty
   aimrt::channel::ContextRef ctx_ref;
 
-  /// serialization cache
-  std::unordered_map<
-      std::string,
-      std::shared_ptr<aimrt::util::BufferArrayView>,
-      aimrt::common::util::StringHash,
-      std::equal_to<>>
-      serialization_cache;
+  /// serialization cache, shared by backends publishing in parallel
+  util::SerializationCache serialization_cache;
 
   /// msg cache
   std::shared_ptr<void> msg_cache_ptr;
+
+  /// guard msg_ptr/msg_cache_ptr resolving from serialization cache
+  MsgResolveGuard msg_resolve_guard;
 };
 
 }  // namespace aimrt::runtime::core::channel
@@ -130,6 +130,9 @@ void LocalChannelBackend::Publish(MsgWrapper& msg_wrapper) noexcept {
     if (serialization_type.empty())
       serialization_type = pub_info.msg_type_support_ref.DefaultSerializationType();
 
+    // 跨pkg订阅时才需要序列化，序列化类型下标在首次需要时取得，各pkg共用
+    uint32_t serialization_type_index = util::SerializationCache::kInvalidTypeIndex;
+
     // 遍历每个pkg
     for (const auto& subscribe_pkg_path_itr : subscribe_index_map_find_topic_itr->second) {
       std::string_view cur_sub_pkg_path = subscribe_pkg_path_itr.first;
@@ -210,7 +213,9 @@ void LocalChannelBackend::Publish(MsgWrapper& msg_wrapper) noexcept {
         ctx_ptr->SetSerializationType(serialization_type);
 
         // pub 端 msg 序列化
-        SerializeMsgWithCache(msg_wrapper, serialization_type);
+        if (serialization_type_index == util::SerializationCache::kInvalidTypeIndex)
+          serialization_type_index = util::SerializationCache::TypeIndex(serialization_type);
+        SerializeMsgWithCacheByIndex(msg_wrapper, serialization_type_index);
 
         // 调用注册的subscribe方法
         for (const auto& sub_wrapper_itr : *module_sub_wrapper_map_ptr) {
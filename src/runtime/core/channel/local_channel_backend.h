@@ -4,10 +4,10 @@
 #pragma once
 
 #include <atomic>
-#include <unordered_set>
 
 #include "aimrt_module_cpp_interface/executor/executor.h"
 #include "core/channel/channel_backend_base.h"
+#include "util/flat_hash_map.h"
 #include "util/log_util.h"
 
 namespace aimrt::runtime::core::channel {
@@ -65,14 +65,15 @@ class LocalChannelBackend : public ChannelBackendBase {
   std::function<executor::ExecutorRef(std::string_view)> get_executor_func_;
   executor::ExecutorRef subscribe_executor_ref_;
 
+  // 发布时逐条消息查找,使用开放寻址表减少指针跳转
   using SubscribeIndexMap =
-      std::unordered_map<
+      aimrt::common::util::FlatHashMap<
           std::string_view,  // msg_type
-          std::unordered_map<
+          aimrt::common::util::FlatHashMap<
               std::string_view,  // topic
-              std::unordered_map<
+              aimrt::common::util::FlatHashMap<
                   std::string_view,  // lib_path
-                  std::unordered_set<
+                  aimrt::common::util::FlatHashSet<
                       std::string_view>>>>;  // module_name
   SubscribeIndexMap subscribe_index_map_;
 };
@@ -117,7 +117,8 @@ void ExecutorManager::Initialize(YAML::Node options_node) {
   
     // 检查executor_options.name是否重复，没有则创建
     AIMRT_CHECK_ERROR_THROW(
-        (executor_proxy_map_.find(executor_options.name) == executor_proxy_map_.end()) &&
+        (aimrt::common::util::FindBySymbolName(executor_proxy_map_, executor_options.name) ==
+         executor_proxy_map_.end()) &&
             (used_executor_names_.find(executor_options.name) == used_executor_names_.end()),
         "Duplicate executor name '{}'.", executor_options.name);
 
@@ -140,7 +141,7 @@ void ExecutorManager::Initialize(YAML::Node options_node) {
 
     auto proxy_ptr = std::make_unique<ExecutorProxy>(executor_ptr.get());
 
-    executor_proxy_map_.emplace(executor_options.name, std::move(proxy_ptr));
+    executor_proxy_map_.emplace(aimrt::common::util::Symbol(executor_options.name), std::move(proxy_ptr));
 
     executor_vec_.emplace_back(std::move(executor_ptr));
   }
@@ -229,7 +230,7 @@ const ExecutorManagerProxy& ExecutorManager::GetExecutorManagerProxy(
  */
 aimrt::executor::ExecutorRef ExecutorManager::GetExecutor(
     std::string_view executor_name) {
-  auto finditr = executor_proxy_map_.find(std::string(executor_name));
+  auto finditr = aimrt::common::util::FindBySymbolName(executor_proxy_map_, executor_name);
   if (finditr != executor_proxy_map_.end())
     return aimrt::executor::ExecutorRef(finditr->second->NativeHandle());
 
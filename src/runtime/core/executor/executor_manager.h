@@ -100,12 +100,7 @@ class ExecutorManager {
 
   std::vector<std::unique_ptr<ExecutorBase>> executor_vec_;
 
-  std::unordered_map<
-      std::string,
-      std::unique_ptr<ExecutorProxy>,
-      aimrt::common::util::StringHash,
-      aimrt::common::util::StringEqual>
-      executor_proxy_map_;
+  ExecutorManagerProxy::ExecutorProxyMap executor_proxy_map_;
 
   std::unordered_map<
       std::string,
@@ -3,11 +3,11 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include "aimrt_module_c_interface/executor/executor_manager_base.h"
 #include "core/executor/executor_base.h"
+#include "util/flat_hash_map.h"
 #include "util/log_util.h"
+#include "util/string_interner.h"
 #include "util/string_util.h"
 #include "util/time_util.h"
 
@@ -64,11 +64,11 @@ class ExecutorProxy {
 
 class ExecutorManagerProxy {
  public:
-  using ExecutorProxyMap = std::unordered_map<
-      std::string,
+  // 以驻留后的executor名为键,按名字查找时不需要构造std::string
+  using ExecutorProxyMap = aimrt::common::util::FlatHashMap<
+      aimrt::common::util::Symbol,
       std::unique_ptr<ExecutorProxy>,
-      aimrt::common::util::StringHash,
-      aimrt::common::util::StringEqual>;
+      aimrt::common::util::SymbolHash>;
 
  public:
   explicit ExecutorManagerProxy(const ExecutorProxyMap& executor_proxy_map)
@@ -87,7 +87,8 @@ class ExecutorManagerProxy {
 
  private:
   const aimrt_executor_base_t* GetExecutor(aimrt_string_view_t executor_name) const {
-    auto finditr = executor_proxy_map_.find(std::string(aimrt::util::ToStdStringView(executor_name)));
+    auto finditr = aimrt::common::util::FindBySymbolName(
+        executor_proxy_map_, aimrt::util::ToStdStringView(executor_name));
     if (finditr != executor_proxy_map_.end()) return finditr->second->NativeHandle();
 
     AIMRT_WARN("Can not find executor '{}'.", aimrt::util::ToStdStringView(executor_name));
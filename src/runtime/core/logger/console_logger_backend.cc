@@ -10,6 +10,7 @@
 
 #include "core/logger/formatter.h"
 #include "core/logger/log_level_tool.h"
+#include "util/alloc_tracker.h"
 #include "util/exception.h"
 #include "util/format.h"
 #include "util/time_util.h"
@@ -159,7 +160,12 @@ void ConsoleLoggerBackend::Log(const LogDataWrapper& log_data_wrapper) noexcept
 
     std::string log_data_str = formatter_.Format(log_data_wrapper);
 
-    auto log_work = [this, lvl = log_data_wrapper.lvl, log_data_str{std::move(log_data_str)}]() {
+    // 日志在执行器队列中等待输出期间计入logger分配域
+    static const uint32_t kLoggerTrackDomain =
+        aimrt::common::util::AllocTracker::Instance().RegisterDomain("logger");
+    aimrt::common::util::ScopedAllocRecord alloc_record(kLoggerTrackDomain, log_data_str.capacity());
+
+    auto log_work = [this, lvl = log_data_wrapper.lvl, log_data_str{std::move(log_data_str)}, alloc_record{std::move(alloc_record)}]() {
       if (options_.print_color) {
 #if defined(_WIN32)
         static constexpr WORD
@@ -201,9 +207,10 @@ void ConsoleLoggerBackend::Log(const LogDataWrapper& log_data_wrapper) noexcept
 
 bool ConsoleLoggerBackend::CheckLog(const LogDataWrapper& log_data_wrapper) {
   {
-    std::shared_lock lock(module_filter_map_mutex_);
-    auto find_itr = module_filter_map_.find(std::string(log_data_wrapper.module_name));
-    if (find_itr != module_filter_map_.end()) {
+    decltype(module_filter_map_)::Guard guard;
+    const auto* module_filter_map = module_filter_map_.Load(guard);
+    auto find_itr = module_filter_map->find(log_data_wrapper.module_name);
+    if (find_itr != module_filter_map->end()) {
       return find_itr->second;
     }
   }
@@ -222,8 +229,9 @@ bool ConsoleLoggerBackend::CheckLog(const LogDataWrapper& log_data_wrapper) {
             options_.module_filter.c_str(), log_data_wrapper.module_name.data(), e.what());
   }
 
-  std::unique_lock lock(module_filter_map_mutex_);
-  module_filter_map_.emplace(log_data_wrapper.module_name, if_log);
+  module_filter_map_.Update([&](auto& module_filter_map) {
+    module_filter_map.emplace(std::string(log_data_wrapper.module_name), if_log);
+  });
 
   return if_log;
 }
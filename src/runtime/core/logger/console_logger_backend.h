@@ -3,13 +3,11 @@
 
 #pragma once
 
-#include <shared_mutex>
-#include <unordered_map>
-
 #include "aimrt_module_cpp_interface/executor/executor.h"
 #include "core/logger/formatter.h"
 #include "core/logger/logger_backend_base.h"
-#include "util/string_util.h"
+#include "util/flat_hash_map.h"
+#include "util/rcu_ptr.h"
 
 namespace aimrt::runtime::core::logger {
 
@@ -50,9 +48,8 @@ class ConsoleLoggerBackend : public LoggerBackendBase {
   aimrt::executor::ExecutorRef log_executor_;
   std::atomic_bool run_flag_ = false;
 
-  std::shared_mutex module_filter_map_mutex_;
-  std::unordered_map<
-      std::string, bool, aimrt::common::util::StringHash, std::equal_to<>>
+  // 读多写少,查找不加锁,新模块名首次出现时复制并发布新表
+  aimrt::common::util::RcuPtr<aimrt::common::util::FlatHashMap<std::string, bool>>
       module_filter_map_;
 
   LogFormatter formatter_;
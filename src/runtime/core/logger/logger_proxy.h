@@ -11,6 +11,7 @@
 
 #include "aimrt_module_c_interface/logger/logger_base.h"
 #include "core/logger/logger_backend_base.h"
+#include "util/time_util.h"
 
 #if __GLIBC__ == 2 && __GLIBC_MINOR__ < 30
   #define gettid() syscall(SYS_gettid)
@@ -62,7 +63,7 @@ class LoggerProxy {
       LogDataWrapper log_data_wrapper{
           .module_name = module_name_,
           .thread_id = tid,
-          .t = std::chrono::system_clock::now(),
+          .t = aimrt::common::util::GetFineTimePoint(),
           .lvl = lvl,
           .line = line,
           .column = column,
@@ -10,6 +10,7 @@
 #include <regex>
 
 #include "core/logger/log_level_tool.h"
+#include "util/alloc_tracker.h"
 #include "util/exception.h"
 #include "util/format.h"
 #include "util/string_util.h"
@@ -107,7 +108,12 @@ void RotateFileLoggerBackend::Log(const LogDataWrapper& log_data_wrapper) noexce
 
     std::string log_data_str = formatter_.Format(log_data_wrapper);
 
-    auto log_work = [this, log_data_str{std::move(log_data_str)}]() {
+    // 日志在执行器队列中等待输出期间计入logger分配域
+    static const uint32_t kLoggerTrackDomain =
+        aimrt::common::util::AllocTracker::Instance().RegisterDomain("logger");
+    aimrt::common::util::ScopedAllocRecord alloc_record(kLoggerTrackDomain, log_data_str.capacity());
+
+    auto log_work = [this, log_data_str{std::move(log_data_str)}, alloc_record{std::move(alloc_record)}]() {
       if (!ofs_.is_open() || ofs_.tellp() > options_.max_file_size_m * 1024 * 1024) {
         if (!OpenNewFile()) return;
       }
@@ -202,9 +208,10 @@ uint32_t RotateFileLoggerBackend::GetNextIndex() {
 
 bool RotateFileLoggerBackend::CheckLog(const LogDataWrapper& log_data_wrapper) {
   {
-    std::shared_lock lock(module_filter_map_mutex_);
-    auto find_itr = module_filter_map_.find(std::string(log_data_wrapper.module_name));
-    if (find_itr != module_filter_map_.end()) {
+    decltype(module_filter_map_)::Guard guard;
+    const auto* module_filter_map = module_filter_map_.Load(guard);
+    auto find_itr = module_filter_map->find(log_data_wrapper.module_name);
+    if (find_itr != module_filter_map->end()) {
       return find_itr->second;
     }
   }
@@ -223,8 +230,9 @@ bool RotateFileLoggerBackend::CheckLog(const LogDataWrapper& log_data_wrapper) {
             options_.module_filter.c_str(), log_data_wrapper.module_name.data(), e.what());
   }
 
-  std::unique_lock lock(module_filter_map_mutex_);
-  module_filter_map_.emplace(std::string(log_data_wrapper.module_name), if_log);
+  module_filter_map_.Update([&](auto& module_filter_map) {
+    module_filter_map.emplace(std::string(log_data_wrapper.module_name), if_log);
+  });
 
   return if_log;
 }
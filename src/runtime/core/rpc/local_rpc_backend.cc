@@ -89,6 +89,7 @@ void LocalRpcBackend::Initialize(YAML::Node options_node) {
         "Get timeout executor '{}' failed.", options_.timeout_executor);
 
     client_tool_ptr_->RegisterTimeoutExecutor(timeout_executor);
+    timeout_executor_ = timeout_executor;
     client_tool_ptr_->RegisterTimeoutHandle(
         [](std::shared_ptr<InvokeWrapper>&& client_invoke_wrapper_ptr) {
           client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT));
@@ -123,8 +124,10 @@ void LocalRpcBackend::Shutdown() {
     return;
 
   service_func_register_index_.clear();
+  stream_service_func_register_index_.clear();
 
   client_tool_ptr_.reset();
+  timeout_executor_ = executor::ExecutorRef();
 
   get_executor_func_ = std::function<executor::ExecutorRef(std::string_view)>();
 }
@@ -199,86 +202,15 @@ void LocalRpcBackend::Invoke(
 
     auto to_addr = client_invoke_wrapper_ptr->ctx_ref.GetMetaValue(AIMRT_RPC_CONTEXT_KEY_TO_ADDR);
 
-    // URL格式: local://rpc/func_name?pkg_path=xxxx&module_name=yyyy
-    if (!to_addr.empty()) {
-      namespace util = aimrt::common::util;
-      auto url = util::ParseUrl<std::string_view>(std::string(to_addr));
-      if (url) {
-        if (omnirt_unlikely(url->protocol != Name())) {
-          AIMRT_WARN("Invalid addr: {}", to_addr);
-          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR));
-          return;
-        }
-        service_pkg_path = util::GetValueFromStrKV(url->query, "pkg_path");
-        service_module_name = util::GetValueFromStrKV(url->query, "module_name");
-      }
-    }
-
     const auto& client_info = client_invoke_wrapper_ptr->info;
 
-    // 从本地服务注册表中查找符合条件的服务函数
-    auto service_func_register_index_find_func_itr = service_func_register_index_.find(client_info.func_name);
-    if (omnirt_unlikely(service_func_register_index_find_func_itr == service_func_register_index_.end())) {
-      AIMRT_ERROR("Service func '{}' is not registered in local rpc backend.", client_info.func_name);
-      client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_SVR_NOT_FOUND));
+    uint32_t find_ret = FindServiceTarget(
+        service_func_register_index_, client_info.func_name, to_addr, service_pkg_path, service_module_name);
+    if (omnirt_unlikely(find_ret != 0)) {
+      client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(find_ret));
       return;
     }
 
-    if (service_pkg_path.empty()) {
-      if (service_module_name.empty()) {
-        // 包路径和模块名都未指定，使用第一个可用的服务
-        auto service_func_register_index_find_pkg_itr =
-            service_func_register_index_find_func_itr->second.begin();
-
-        service_pkg_path = service_func_register_index_find_pkg_itr->first;
-        service_module_name = *(service_func_register_index_find_pkg_itr->second.begin());
-      } else {
-        // 包路径未指定但模块名已指定，遍历所有包查找第一个包含该模块的包
-        for (const auto& itr : service_func_register_index_find_func_itr->second) {
-          if (itr.second.find(service_module_name) != itr.second.end()) {
-            service_pkg_path = itr.first;
-            break;
-          }
-        }
-        if (service_pkg_path.empty()) {
-          AIMRT_WARN("Can not find service func '{}' in module '{}'. Addr: {}",
-                     client_info.func_name, service_module_name, to_addr);
-
-          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_INVALID_ADDR));
-          return;
-        }
-      }
-
-    } else {
-      auto service_func_register_index_find_pkg_itr =
-          service_func_register_index_find_func_itr->second.find(service_pkg_path);
-
-      if (omnirt_unlikely(service_func_register_index_find_pkg_itr ==
-          service_func_register_index_find_func_itr->second.end())) {
-        AIMRT_WARN("Can not find service func '{}' in pkg '{}'. Addr: {}",
-                   client_info.func_name, service_pkg_path, to_addr);
-
-        client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_INVALID_ADDR));
-        return;
-      }
-
-      if (service_module_name.empty()) {
-        service_module_name = *(service_func_register_index_find_pkg_itr->second.begin());
-      } else {
-        auto service_func_register_index_find_module_itr =
-            service_func_register_index_find_pkg_itr->second.find(service_module_name);
-
-        if (omnirt_unlikely(service_func_register_index_find_module_itr ==
-            service_func_register_index_find_pkg_itr->second.end())) {
-          AIMRT_WARN("Can not find service func '{}' in pkg '{}' module '{}'. Addr: {}",
-                     client_info.func_name, service_pkg_path, service_module_name, to_addr);
-
-          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_INVALID_ADDR));
-          return;
-        }
-      }
-    }
-
     AIMRT_TRACE("Invoke rpc func '{}' in pkg '{}' module '{}'.",
                 client_info.func_name, service_pkg_path, service_module_name);
 
@@ -348,7 +280,10 @@ void LocalRpcBackend::Invoke(
     // 对客户端请求进行序列化
     std::string serialization_type(client_invoke_wrapper_ptr->ctx_ref.GetSerializationType());
 
-    auto buffer_array_view_ptr = TrySerializeReqWithCache(*client_invoke_wrapper_ptr, serialization_type);
+    // 请求、响应的序列化与缓存共用同一下标，只查找一次驻留表
+    const uint32_t serialization_type_index = util::SerializationCache::TypeIndex(serialization_type);
+
+    auto buffer_array_view_ptr = TrySerializeReqWithCacheByIndex(*client_invoke_wrapper_ptr, serialization_type_index);
     if (omnirt_unlikely(!buffer_array_view_ptr)) {
       // 序列化失败
       AIMRT_ERROR(
@@ -363,7 +298,8 @@ void LocalRpcBackend::Invoke(
     std::shared_ptr<void> service_req_ptr = service_info.req_type_support_ref.CreateSharedPtr();
     service_invoke_wrapper_ptr->req_ptr = service_req_ptr.get();
 
-    bool deserialize_ret = service_info.req_type_support_ref.Deserialize(
+    bool deserialize_ret = util::DeserializeWithCodec(
+        service_info.req_type_support_ref,
         serialization_type,
         *(buffer_array_view_ptr->NativeHandle()),
         service_req_ptr.get());
@@ -379,7 +315,7 @@ void LocalRpcBackend::Invoke(
     }
 
     // 缓存服务请求反序列化使用的缓冲区，避免重复创建
-    service_invoke_wrapper_ptr->req_serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+    service_invoke_wrapper_ptr->req_serialization_cache.EmplaceByIndex(serialization_type_index, buffer_array_view_ptr);
 
     // 创建服务响应对象
     std::shared_ptr<void> service_rsp_ptr = service_info.rsp_type_support_ref.CreateSharedPtr();
@@ -393,7 +329,8 @@ void LocalRpcBackend::Invoke(
          cur_req_id,
          service_req_ptr,
          service_rsp_ptr,
-         serialization_type{std::move(serialization_type)}](aimrt::rpc::Status status) {
+         serialization_type{std::move(serialization_type)},
+         serialization_type_index](aimrt::rpc::Status status) {
           auto msg_recorder = client_tool_ptr_->GetRecord(cur_req_id);
           if (omnirt_unlikely(!msg_recorder)) {
             // 未找到请求记录，表明该请求已超时并被超时处理程序移除
@@ -408,7 +345,7 @@ void LocalRpcBackend::Invoke(
           const auto& service_info = service_invoke_wrapper_ptr->info;
 
           // 对服务响应进行序列化
-          auto buffer_array_view_ptr = TrySerializeRspWithCache(*service_invoke_wrapper_ptr, serialization_type);
+          auto buffer_array_view_ptr = TrySerializeRspWithCacheByIndex(*service_invoke_wrapper_ptr, serialization_type_index);
           if (omnirt_unlikely(!buffer_array_view_ptr)) {
             // 服务响应序列化失败，返回错误状态
             AIMRT_ERROR(
@@ -421,7 +358,8 @@ void LocalRpcBackend::Invoke(
           }
 
           // 将序列化的响应数据反序列化为客户端响应对象
-          bool deserialize_ret = client_info.rsp_type_support_ref.Deserialize(
+          bool deserialize_ret = util::DeserializeWithCodec(
+              client_info.rsp_type_support_ref,
               serialization_type,
               *(buffer_array_view_ptr->NativeHandle()),
               client_invoke_wrapper_ptr->rsp_ptr);
@@ -438,7 +376,7 @@ void LocalRpcBackend::Invoke(
           }
 
           // 缓存客户端响应反序列化使用的缓冲区
-          client_invoke_wrapper_ptr->rsp_serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+          client_invoke_wrapper_ptr->rsp_serialization_cache.EmplaceByIndex(serialization_type_index, buffer_array_view_ptr);
 
           // 调用客户端回调函数，完成RPC调用流程
           client_invoke_wrapper_ptr->callback(status);
@@ -451,6 +389,266 @@ void LocalRpcBackend::Invoke(
   }
 }
 
+/**
+ * @brief 确定调用的目标服务
+ * @param index 服务注册索引
+ * @param func_name 函数名
+ * @param to_addr 客户端指定的地址，格式: local://rpc/func_name?pkg_path=xxxx&module_name=yyyy
+ * @param service_pkg_path 输出目标服务所在的包路径
+ * @param service_module_name 输出目标服务所在的模块名
+ * @return 成功返回0，否则返回rpc状态码
+ * @details 包路径和模块名都未指定时使用第一个可用的服务
+ */
+uint32_t LocalRpcBackend::FindServiceTarget(
+    const ServiceFuncIndexMap& index,
+    std::string_view func_name,
+    std::string_view to_addr,
+    std::string_view& service_pkg_path,
+    std::string_view& service_module_name) const {
+  if (!to_addr.empty()) {
+    namespace util = aimrt::common::util;
+    auto url = util::ParseUrl<std::string_view>(to_addr);
+    if (url) {
+      if (omnirt_unlikely(url->protocol != Name())) {
+        AIMRT_WARN("Invalid addr: {}", to_addr);
+        return AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR;
+      }
+      service_pkg_path = util::GetValueFromStrKV(url->query, "pkg_path");
+      service_module_name = util::GetValueFromStrKV(url->query, "module_name");
+    }
+  }
+
+  // 从本地服务注册表中查找符合条件的服务函数
+  auto find_func_itr = index.find(func_name);
+  if (omnirt_unlikely(find_func_itr == index.end())) {
+    AIMRT_ERROR("Service func '{}' is not registered in local rpc backend.", func_name);
+    return AIMRT_RPC_STATUS_SVR_NOT_FOUND;
+  }
+
+  if (service_pkg_path.empty()) {
+    if (service_module_name.empty()) {
+      // 包路径和模块名都未指定，使用第一个可用的服务
+      auto find_pkg_itr = find_func_itr->second.begin();
+
+      service_pkg_path = find_pkg_itr->first;
+      service_module_name = *(find_pkg_itr->second.begin());
+      return 0;
+    }
+
+    // 包路径未指定但模块名已指定，遍历所有包查找第一个包含该模块的包
+    for (const auto& itr : find_func_itr->second) {
+      if (itr.second.find(service_module_name) != itr.second.end()) {
+        service_pkg_path = itr.first;
+        return 0;
+      }
+    }
+
+    AIMRT_WARN("Can not find service func '{}' in module '{}'. Addr: {}",
+               func_name, service_module_name, to_addr);
+    return AIMRT_RPC_STATUS_CLI_INVALID_ADDR;
+  }
+
+  auto find_pkg_itr = find_func_itr->second.find(service_pkg_path);
+  if (omnirt_unlikely(find_pkg_itr == find_func_itr->second.end())) {
+    AIMRT_WARN("Can not find service func '{}' in pkg '{}'. Addr: {}",
+               func_name, service_pkg_path, to_addr);
+    return AIMRT_RPC_STATUS_CLI_INVALID_ADDR;
+  }
+
+  if (service_module_name.empty()) {
+    service_module_name = *(find_pkg_itr->second.begin());
+    return 0;
+  }
+
+  if (omnirt_unlikely(find_pkg_itr->second.find(service_module_name) == find_pkg_itr->second.end())) {
+    AIMRT_WARN("Can not find service func '{}' in pkg '{}' module '{}'. Addr: {}",
+               func_name, service_pkg_path, service_module_name, to_addr);
+    return AIMRT_RPC_STATUS_CLI_INVALID_ADDR;
+  }
+
+  return 0;
+}
+
+/**
+ * @brief 注册流式服务函数到本地RPC后端
+ * @param stream_service_func_wrapper 流式服务函数包装器
+ * @return 注册是否成功
+ */
+bool LocalRpcBackend::RegisterStreamServiceFunc(
+    const StreamServiceFuncWrapper& stream_service_func_wrapper) noexcept {
+  try {
+    if (state_.load() != State::kInit) {
+      AIMRT_ERROR("Stream service func can only be registered when state is 'Init'.");
+      return false;
+    }
+
+    const auto& info = stream_service_func_wrapper.info;
+
+    stream_service_func_register_index_[info.func_name][info.pkg_path].emplace(info.module_name);
+
+    return true;
+  } catch (const std::exception& e) {
+    AIMRT_ERROR("{}", e.what());
+    return false;
+  }
+}
+
+/**
+ * @brief 注册流式客户端函数到本地RPC后端
+ * @param stream_client_func_wrapper 流式客户端函数包装器
+ * @return 注册是否成功
+ */
+bool LocalRpcBackend::RegisterStreamClientFunc(
+    const StreamClientFuncWrapper& stream_client_func_wrapper) noexcept {
+  if (state_.load() != State::kInit) {
+    AIMRT_ERROR("Stream client func can only be registered when state is 'Init'.");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * @brief 建立流式调用
+ * @param client_stream_invoke_wrapper_ptr 客户端流式调用包装器指针
+ * @details 客户端与服务端共用同一个RpcStream：
+ *   1. 同包调用时消息对象直接在两端之间传递，没有任何拷贝
+ *   2. 跨包调用时在流的两个方向上设置转换函数，按上下文中的序列化类型转换为对端的消息类型
+ *   3. 配置了超时执行器且上下文设置了超时时间时，超时后以TIMEOUT取消整个流
+ */
+void LocalRpcBackend::OpenStream(
+    const std::shared_ptr<StreamInvokeWrapper>& client_stream_invoke_wrapper_ptr) noexcept {
+  const auto& stream_ptr = client_stream_invoke_wrapper_ptr->stream_ptr;
+
+  try {
+    if (omnirt_unlikely(state_.load() != State::kStart)) {
+      AIMRT_WARN("Method can only be called when state is 'Start'.");
+      stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR));
+      return;
+    }
+
+    std::string_view service_pkg_path, service_module_name;
+
+    auto to_addr = client_stream_invoke_wrapper_ptr->ctx_ref.GetMetaValue(AIMRT_RPC_CONTEXT_KEY_TO_ADDR);
+
+    const auto& client_info = client_stream_invoke_wrapper_ptr->info;
+
+    uint32_t find_ret = FindServiceTarget(
+        stream_service_func_register_index_, client_info.func_name, to_addr, service_pkg_path, service_module_name);
+    if (omnirt_unlikely(find_ret != 0)) {
+      stream_ptr->Cancel(aimrt::rpc::Status(find_ret));
+      return;
+    }
+
+    AIMRT_TRACE("Open rpc stream '{}' in pkg '{}' module '{}'.",
+                client_info.func_name, service_pkg_path, service_module_name);
+
+    const auto* service_func_wrapper_ptr =
+        rpc_registry_ptr_->GetStreamServiceFuncWrapperPtr(client_info.func_name, service_pkg_path, service_module_name);
+
+    if (omnirt_unlikely(service_func_wrapper_ptr == nullptr)) {
+      AIMRT_WARN("Can not find stream service func '{}' in pkg '{}' module '{}'",
+                 client_info.func_name, service_pkg_path, service_module_name);
+
+      stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR));
+      return;
+    }
+
+    if (omnirt_unlikely(service_func_wrapper_ptr->mode != client_stream_invoke_wrapper_ptr->mode)) {
+      AIMRT_WARN("Stream mode of client and service func '{}' mismatch, client: {}, service: {}",
+                 client_info.func_name,
+                 static_cast<uint32_t>(client_stream_invoke_wrapper_ptr->mode),
+                 static_cast<uint32_t>(service_func_wrapper_ptr->mode));
+
+      stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR));
+      return;
+    }
+
+    // 创建服务端流式调用包装器，与客户端共用同一个流
+    auto service_invoke_wrapper_ptr = std::make_shared<StreamInvokeWrapper>(StreamInvokeWrapper{
+        .info = service_func_wrapper_ptr->info,
+        .mode = service_func_wrapper_ptr->mode,
+        .req_ptr = nullptr,
+        .stream_ptr = stream_ptr});
+    const auto& service_info = service_invoke_wrapper_ptr->info;
+
+    // 创建服务上下文
+    auto ctx_ptr = std::make_shared<aimrt::rpc::Context>(aimrt_rpc_context_type_t::AIMRT_RPC_SERVER_CONTEXT);
+    service_invoke_wrapper_ptr->ctx_ref = ctx_ptr;
+
+    ctx_ptr->SetTimeout(client_stream_invoke_wrapper_ptr->ctx_ref.Timeout());
+
+    const auto& meta_keys = client_stream_invoke_wrapper_ptr->ctx_ref.GetMetaKeys();
+    for (const auto& item : meta_keys)
+      ctx_ptr->SetMetaValue(item, client_stream_invoke_wrapper_ptr->ctx_ref.GetMetaValue(item));
+
+    ctx_ptr->SetFunctionName(service_info.func_name);
+    ctx_ptr->SetMetaValue(AIMRT_RPC_CONTEXT_KEY_BACKEND, Name());
+    ctx_ptr->SetMetaValue("aimrt-from_pkg", client_info.pkg_path);
+    ctx_ptr->SetMetaValue("aimrt-from_module", client_info.module_name);
+
+    std::shared_ptr<void> service_req_ptr;
+
+    if (service_pkg_path == client_info.pkg_path) {
+      // 同包内直接传递指针，流中的消息也直接传递
+      service_invoke_wrapper_ptr->req_ptr = client_stream_invoke_wrapper_ptr->req_ptr;
+    } else {
+      // 跨包时转换首个请求，并为两个方向设置消息转换
+      std::string serialization_type(client_stream_invoke_wrapper_ptr->ctx_ref.GetSerializationType());
+
+      if (client_stream_invoke_wrapper_ptr->req_ptr != nullptr) {
+        service_req_ptr = ConvertStreamMsg(
+            serialization_type, client_info.req_type_support_ref, service_info.req_type_support_ref,
+            client_stream_invoke_wrapper_ptr->req_ptr);
+
+        if (omnirt_unlikely(!service_req_ptr)) {
+          AIMRT_ERROR(
+              "Stream req conversion failed in local rpc backend, serialization_type {}, pkg_path: {}, module_name: {}, func_name: {}",
+              serialization_type, client_info.pkg_path, client_info.module_name, client_info.func_name);
+
+          stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_SERIALIZATION_FAILED));
+          return;
+        }
+
+        service_invoke_wrapper_ptr->req_ptr = service_req_ptr.get();
+      }
+
+      stream_ptr->SetTransform(
+          RpcStreamSide::kClient,
+          MakeStreamMsgTransform(serialization_type, client_info.req_type_support_ref, service_info.req_type_support_ref));
+      stream_ptr->SetTransform(
+          RpcStreamSide::kServer,
+          MakeStreamMsgTransform(serialization_type, service_info.rsp_type_support_ref, client_info.rsp_type_support_ref));
+    }
+
+    // 转换函数已就位，放行两端的写入
+    stream_ptr->Establish();
+
+    // 流结束时通知服务端，filter可能在服务函数调用前包装callback，因此在结束时再读取
+    stream_ptr->AddDoneHandle(
+        RpcStreamSide::kServer,
+        [service_invoke_wrapper_ptr, ctx_ptr, service_req_ptr](aimrt::rpc::Status status) {
+          if (service_invoke_wrapper_ptr->callback) service_invoke_wrapper_ptr->callback(status);
+        });
+
+    // 超时后取消整个流
+    auto timeout = client_stream_invoke_wrapper_ptr->ctx_ref.Timeout();
+    if (timeout_executor_ && timeout.count() > 0) {
+      timeout_executor_.ExecuteAfter(
+          timeout,
+          [weak_stream_ptr = std::weak_ptr<RpcStream>(stream_ptr)]() {
+            if (auto stream_ptr = weak_stream_ptr.lock())
+              stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT));
+          });
+    }
+
+    service_func_wrapper_ptr->service_func(service_invoke_wrapper_ptr);
+  } catch (const std::exception& e) {
+    AIMRT_ERROR("{}", e.what());
+    stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR));
+  }
+}
+
 /**
  * @brief 注册获取执行器的函数
  * @param get_executor_func 根据执行器名称获取执行器的函数
@@ -53,9 +53,33 @@ class LocalRpcBackend : public RpcBackendBase {
   void Invoke(
       const std::shared_ptr<InvokeWrapper>& client_invoke_wrapper_ptr) noexcept override;
 
+  bool RegisterStreamServiceFunc(
+      const StreamServiceFuncWrapper& stream_service_func_wrapper) noexcept override;
+  bool RegisterStreamClientFunc(
+      const StreamClientFuncWrapper& stream_client_func_wrapper) noexcept override;
+  void OpenStream(
+      const std::shared_ptr<StreamInvokeWrapper>& client_stream_invoke_wrapper_ptr) noexcept override;
+
   void RegisterGetExecutorFunc(
       const std::function<executor::ExecutorRef(std::string_view)>& get_executor_func);
 
+ private:
+  using ServiceFuncIndexMap =
+      std::unordered_map<
+          std::string_view,  // func_name
+          std::unordered_map<
+              std::string_view,  // lib_path
+              std::unordered_set<
+                  std::string_view>>>;  // module_name
+
+  // 根据to_addr在索引中确定目标服务所在的包和模块，成功返回0，否则返回错误码
+  uint32_t FindServiceTarget(
+      const ServiceFuncIndexMap& index,
+      std::string_view func_name,
+      std::string_view to_addr,
+      std::string_view& service_pkg_path,
+      std::string_view& service_module_name) const;
+
  private:
   Options options_;
   std::atomic<State> state_ = State::kPreInit;
@@ -69,14 +93,11 @@ class LocalRpcBackend : public RpcBackendBase {
 
   std::unique_ptr<util::RpcClientTool<std::shared_ptr<InvokeWrapper>>> client_tool_ptr_;
 
-  using ServiceFuncIndexMap =
-      std::unordered_map<
-          std::string_view,  // func_name
-          std::unordered_map<
-              std::string_view,  // lib_path
-              std::unordered_set<
-                  std::string_view>>>;  // module_name
+  // 未配置timeout_executor时为空，此时流式调用不做超时处理
+  executor::ExecutorRef timeout_executor_;
+
   ServiceFuncIndexMap service_func_register_index_;
+  ServiceFuncIndexMap stream_service_func_register_index_;
 };
 
 }  // namespace aimrt::runtime::core::rpc
@@ -65,6 +65,46 @@ class RpcBackendBase {
    */
   virtual void Invoke(
       const std::shared_ptr<InvokeWrapper>& client_invoke_wrapper_ptr) noexcept = 0;
+
+  /**
+   * @brief Register stream service func
+   * @note
+   * 1. This method will only be called after 'Initialize' and before 'Start'.
+   * 2. Backends without streaming support keep the default implementation.
+   *
+   * @param stream_service_func_wrapper
+   * @return Register result
+   */
+  virtual bool RegisterStreamServiceFunc(
+      const StreamServiceFuncWrapper& stream_service_func_wrapper) noexcept { return false; }
+
+  /**
+   * @brief Register stream client func
+   * @note
+   * 1. This method will only be called after 'Initialize' and before 'Start'.
+   * 2. Backends without streaming support keep the default implementation.
+   *
+   * @param stream_client_func_wrapper
+   * @return Register result
+   */
+  virtual bool RegisterStreamClientFunc(
+      const StreamClientFuncWrapper& stream_client_func_wrapper) noexcept { return false; }
+
+  /**
+   * @brief Open a rpc stream
+   * @note
+   * 1. This method will only be called after 'Start' and before 'Shutdown'.
+   * 2. The backend must end the stream with Finish or Cancel eventually.
+   * 3. Writes are held back until the stream is established. The backend should install msg transforms
+   *    and then call Establish; otherwise the stream is established after this method returns.
+   *
+   * @param client_stream_invoke_wrapper_ptr
+   */
+  virtual void OpenStream(
+      const std::shared_ptr<StreamInvokeWrapper>& client_stream_invoke_wrapper_ptr) noexcept {
+    client_stream_invoke_wrapper_ptr->stream_ptr->Cancel(
+        aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_NO_BACKEND_TO_HANDLE));
+  }
 };
 
 }  // namespace aimrt::runtime::core::rpc
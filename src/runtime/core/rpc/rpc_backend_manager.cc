@@ -8,6 +8,7 @@
 
 #include "aimrt_module_cpp_interface/rpc/rpc_handle.h"
 #include "aimrt_module_cpp_interface/rpc/rpc_status.h"
+#include "core/allocator/message_pool.h"
 #include "util/macros.h"
 
 namespace aimrt::runtime::core::rpc {
@@ -33,6 +34,10 @@ void RpcBackendManager::Shutdown() {
   if (std::atomic_exchange(&state_, State::kShutdown) == State::kShutdown)
     return;
 
+  // 先结束所有未结束的流，避免后端关闭后流的回调永远不被调用
+  if (rpc_registry_ptr_ != nullptr)
+    rpc_registry_ptr_->CancelAllActiveStreams(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_BACKEND_INTERNAL_ERROR));
+
   for (auto& backend : rpc_backend_index_vec_) {
     AIMRT_TRACE("Shutdown rpc backend '{}'.", backend->Name());
     backend->Shutdown();
@@ -60,6 +65,20 @@ void RpcBackendManager::SetServerFrameworkAsyncRpcFilterManager(FrameworkAsyncRp
   server_filter_manager_ptr_ = ptr;
 }
 
+void RpcBackendManager::SetClientFrameworkAsyncRpcStreamFilterManager(FrameworkAsyncRpcStreamFilterManager* ptr) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kPreInit,
+      "Method can only be called when state is 'PreInit'.");
+  client_stream_filter_manager_ptr_ = ptr;
+}
+
+void RpcBackendManager::SetServerFrameworkAsyncRpcStreamFilterManager(FrameworkAsyncRpcStreamFilterManager* ptr) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kPreInit,
+      "Method can only be called when state is 'PreInit'.");
+  server_stream_filter_manager_ptr_ = ptr;
+}
+
 void RpcBackendManager::SetClientsFiltersRules(
     const std::vector<std::pair<std::string, std::vector<std::string>>>& rules) {
   AIMRT_CHECK_ERROR_THROW(
@@ -76,6 +95,14 @@ void RpcBackendManager::SetServersFiltersRules(
   servers_filters_rules_ = rules;
 }
 
+void RpcBackendManager::SetServersDispatchRules(
+    const std::vector<std::pair<std::string, RpcServiceDispatcher::Options>>& rules) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kPreInit,
+      "Method can only be called when state is 'PreInit'.");
+  servers_dispatch_rules_ = rules;
+}
+
 void RpcBackendManager::SetClientsBackendsRules(
     const std::vector<std::pair<std::string, std::vector<std::string>>>& rules) {
   AIMRT_CHECK_ERROR_THROW(
@@ -116,8 +143,10 @@ bool RpcBackendManager::RegisterServiceFunc(RegisterServiceFuncProxyInfoWrapper&
       .pkg_path = std::string(wrapper.pkg_path),
       .module_name = std::string(wrapper.module_name),
       .custom_type_support_ptr = wrapper.custom_type_support_ptr,
-      .req_type_support_ref = aimrt::util::TypeSupportRef(wrapper.req_type_support),
-      .rsp_type_support_ref = aimrt::util::TypeSupportRef(wrapper.rsp_type_support)};
+      .req_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.req_type_support)),
+      .rsp_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.rsp_type_support))};
 
   // 创建 filter
   auto filter_name_vec = GetFilterRules(func_name, servers_filters_rules_);
@@ -128,8 +157,8 @@ bool RpcBackendManager::RegisterServiceFunc(RegisterServiceFuncProxyInfoWrapper&
 
   auto service_func_shared_ptr = std::make_shared<aimrt::rpc::ServiceFunc>(wrapper.service_func);
 
-  service_func_wrapper_ptr->service_func =
-      [this, &filter_collector, service_func_shared_ptr](
+  ServiceFunc service_func =
+      [&filter_collector, service_func_shared_ptr](
           const std::shared_ptr<InvokeWrapper>& invoke_wrapper_ptr) {
         filter_collector.InvokeRpc(
             [service_func_ptr = service_func_shared_ptr.get()](
@@ -148,6 +177,37 @@ bool RpcBackendManager::RegisterServiceFunc(RegisterServiceFuncProxyInfoWrapper&
             invoke_wrapper_ptr);
       };
 
+  // 按规则绑定执行器、限制并发，调用完成时释放并发额度
+  auto dispatcher_ptr = GetServiceDispatcher(func_name);
+  if (dispatcher_ptr) {
+    service_func =
+        [this, dispatcher_ptr, service_func{std::move(service_func)}](
+            const std::shared_ptr<InvokeWrapper>& invoke_wrapper_ptr) {
+          invoke_wrapper_ptr->dispatch_time = std::chrono::steady_clock::now();
+
+          bool dispatch_ret = dispatcher_ptr->Dispatch(
+              [&service_func, dispatcher_ptr, invoke_wrapper_ptr]() {
+                invoke_wrapper_ptr->callback =
+                    [dispatcher_ptr, callback{std::move(invoke_wrapper_ptr->callback)}](aimrt::rpc::Status status) {
+                      // 回调可能释放wrapper及本闭包，先取出分发器
+                      auto cur_dispatcher_ptr = dispatcher_ptr;
+                      callback(status);
+                      cur_dispatcher_ptr->Release();
+                    };
+
+                service_func(invoke_wrapper_ptr);
+              });
+
+          if (omnirt_unlikely(!dispatch_ret)) {
+            AIMRT_WARN("Service func '{}' is overloaded (max concurrency and queue reached), request is rejected.",
+                       invoke_wrapper_ptr->info.func_name);
+            invoke_wrapper_ptr->callback(aimrt::rpc::Status(RpcServiceDispatcher::kRejectedStatus));
+          }
+        };
+  }
+
+  service_func_wrapper_ptr->service_func = std::move(service_func);
+
   const auto& service_func_wrapper_ref = *service_func_wrapper_ptr;
 
   if (!rpc_registry_ptr_->RegisterServiceFunc(std::move(service_func_wrapper_ptr)))
@@ -183,8 +243,10 @@ bool RpcBackendManager::RegisterClientFunc(RegisterClientFuncProxyInfoWrapper&&
       .pkg_path = std::string(wrapper.pkg_path),
       .module_name = std::string(wrapper.module_name),
       .custom_type_support_ptr = wrapper.custom_type_support_ptr,
-      .req_type_support_ref = aimrt::util::TypeSupportRef(wrapper.req_type_support),
-      .rsp_type_support_ref = aimrt::util::TypeSupportRef(wrapper.rsp_type_support)};
+      .req_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.req_type_support)),
+      .rsp_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.rsp_type_support))};
 
   // 创建 filter
   auto filter_name_vec = GetFilterRules(func_name, clients_filters_rules_);
@@ -270,52 +332,252 @@ void RpcBackendManager::Invoke(InvokeProxyInfoWrapper&& wrapper) {
 
         std::string_view func_name = client_invoke_wrapper_ptr->info.func_name;
 
-        auto find_itr = clients_backend_index_map_.find(std::string(func_name));
+        uint32_t err_code = 0;
+        auto* backend_ptr = SelectClientBackend(
+            func_name, client_invoke_wrapper_ptr->ctx_ref.GetToAddr(), err_code);
 
-        if (omnirt_unlikely(find_itr == clients_backend_index_map_.end())) {
-          AIMRT_WARN("Rpc call found no backend to handle, func name '{}'.", func_name);
-          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_NO_BACKEND_TO_HANDLE));
+        if (omnirt_unlikely(backend_ptr == nullptr)) {
+          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(err_code));
           return;
         }
 
-        const auto& backend_ptr_vec = find_itr->second;
+        backend_ptr->Invoke(client_invoke_wrapper_ptr);
+      },
+      client_invoke_wrapper_ptr);
+}
 
-        if (omnirt_unlikely(backend_ptr_vec.empty())) {
-          AIMRT_WARN("Rpc call found no backend to handle, func name '{}'.", func_name);
-          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_NO_BACKEND_TO_HANDLE));
-          return;
-        }
+bool RpcBackendManager::RegisterStreamServiceFunc(RegisterStreamServiceFuncProxyInfoWrapper&& wrapper) {
+  if (state_.load() != State::kInit) {
+    AIMRT_ERROR("Stream service func can only be registered when state is 'Init'.");
+    return false;
+  }
 
-        // 如果ctx中指定了后端，则使用指定的后端
-        std::string_view to_addr(client_invoke_wrapper_ptr->ctx_ref.GetToAddr());
-        if (!to_addr.empty()) {
-          // to_addr格式：backend_name://url_str
-          AIMRT_TRACE("Rpc call use the specified address '{}', func name '{}'.", to_addr, func_name);
-          auto pos = to_addr.find("://");
-          if (pos != std::string_view::npos) {
-            auto addr_backend = to_addr.substr(0, pos);
-
-            auto backend_itr = rpc_backend_index_map_.find(addr_backend);
-            if (backend_itr != rpc_backend_index_map_.end()) {
-              auto* backend_ptr = backend_itr->second;
-
-              if (std::find(backend_ptr_vec.begin(), backend_ptr_vec.end(), backend_ptr) != backend_ptr_vec.end()) {
-                backend_ptr->Invoke(client_invoke_wrapper_ptr);
-                return;
-              }
-            }
+  auto func_name = wrapper.func_name;
+
+  // 创建 func wrapper
+  auto stream_service_func_wrapper_ptr = std::make_unique<StreamServiceFuncWrapper>();
+  stream_service_func_wrapper_ptr->info = FuncInfo{
+      .func_name = std::string(func_name),
+      .pkg_path = std::string(wrapper.pkg_path),
+      .module_name = std::string(wrapper.module_name),
+      .custom_type_support_ptr = wrapper.custom_type_support_ptr,
+      .req_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.req_type_support)),
+      .rsp_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.rsp_type_support))};
+  stream_service_func_wrapper_ptr->mode = wrapper.mode;
+
+  // 创建 filter，流式调用与普通调用共用filter规则，只使用有流式实现的filter
+  auto filter_name_vec = GetStreamFilterRules(func_name, servers_filters_rules_, *server_stream_filter_manager_ptr_);
+  server_stream_filter_manager_ptr_->CreateFilterCollectorIfNotExist(func_name, filter_name_vec);
+
+  // 注册 func wrapper
+  const auto& filter_collector = server_stream_filter_manager_ptr_->GetFilterCollector(func_name);
+
+  StreamServiceFunc stream_service_func =
+      [&filter_collector, service_func{std::move(wrapper.service_func)}](
+          const std::shared_ptr<StreamInvokeWrapper>& stream_invoke_wrapper_ptr) {
+        filter_collector.InvokeRpc(
+            [&service_func](const std::shared_ptr<StreamInvokeWrapper>& stream_invoke_wrapper_ptr) {
+              service_func(
+                  stream_invoke_wrapper_ptr->ctx_ref,
+                  stream_invoke_wrapper_ptr->req_ptr,
+                  stream_invoke_wrapper_ptr->stream_ptr);
+            },
+            stream_invoke_wrapper_ptr);
+      };
+
+  // 流式调用占用的并发额度在流结束时释放
+  auto dispatcher_ptr = GetServiceDispatcher(func_name);
+  if (dispatcher_ptr) {
+    stream_service_func =
+        [this, dispatcher_ptr, stream_service_func{std::move(stream_service_func)}](
+            const std::shared_ptr<StreamInvokeWrapper>& stream_invoke_wrapper_ptr) {
+          bool dispatch_ret = dispatcher_ptr->Dispatch(
+              [&stream_service_func, dispatcher_ptr, stream_invoke_wrapper_ptr]() {
+                stream_invoke_wrapper_ptr->stream_ptr->AddDoneHandle(
+                    RpcStreamSide::kServer,
+                    [dispatcher_ptr](aimrt::rpc::Status) { dispatcher_ptr->Release(); });
+
+                stream_service_func(stream_invoke_wrapper_ptr);
+              });
+
+          if (omnirt_unlikely(!dispatch_ret)) {
+            AIMRT_WARN("Stream service func '{}' is overloaded (max concurrency and queue reached), stream is rejected.",
+                       stream_invoke_wrapper_ptr->info.func_name);
+            stream_invoke_wrapper_ptr->stream_ptr->Cancel(
+                aimrt::rpc::Status(RpcServiceDispatcher::kRejectedStatus));
           }
-          AIMRT_ERROR("Rpc call address '{}' is invalid, func name '{}'.", to_addr, func_name);
-          client_invoke_wrapper_ptr->callback(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_INVALID_ADDR));
+        };
+  }
+
+  stream_service_func_wrapper_ptr->service_func = std::move(stream_service_func);
+
+  const auto& stream_service_func_wrapper_ref = *stream_service_func_wrapper_ptr;
+
+  if (!rpc_registry_ptr_->RegisterStreamServiceFunc(std::move(stream_service_func_wrapper_ptr)))
+    return false;
+
+  auto backend_itr = servers_backend_index_map_.find(std::string(func_name));
+  if (backend_itr == servers_backend_index_map_.end()) {
+    auto backend_ptr_vec = GetBackendsByRules(func_name, servers_backends_rules_);
+    auto emplace_ret = servers_backend_index_map_.emplace(std::string(func_name), std::move(backend_ptr_vec));
+    backend_itr = emplace_ret.first;
+  }
+
+  // 至少有一个后端支持流式调用即可
+  bool ret = false;
+  for (auto& itr : backend_itr->second) {
+    if (itr->RegisterStreamServiceFunc(stream_service_func_wrapper_ref)) {
+      AIMRT_TRACE("Register stream service func '{}' to backend '{}'.", func_name, itr->Name());
+      ret = true;
+    }
+  }
+
+  if (!ret)
+    AIMRT_ERROR("No backend supports stream service func '{}'.", func_name);
+
+  return ret;
+}
+
+bool RpcBackendManager::RegisterStreamClientFunc(RegisterStreamClientFuncProxyInfoWrapper&& wrapper) {
+  if (state_.load() != State::kInit) {
+    AIMRT_ERROR("Stream client func can only be registered when state is 'Init'.");
+    return false;
+  }
+
+  auto func_name = wrapper.func_name;
+
+  // 创建 func wrapper
+  auto stream_client_func_wrapper_ptr = std::make_unique<StreamClientFuncWrapper>();
+  stream_client_func_wrapper_ptr->info = FuncInfo{
+      .func_name = std::string(func_name),
+      .pkg_path = std::string(wrapper.pkg_path),
+      .module_name = std::string(wrapper.module_name),
+      .custom_type_support_ptr = wrapper.custom_type_support_ptr,
+      .req_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.req_type_support)),
+      .rsp_type_support_ref = aimrt::util::TypeSupportRef(
+          allocator::MessagePoolRegistry::Instance().Wrap(wrapper.rsp_type_support))};
+  stream_client_func_wrapper_ptr->mode = wrapper.mode;
+
+  // 创建 filter
+  auto filter_name_vec = GetStreamFilterRules(func_name, clients_filters_rules_, *client_stream_filter_manager_ptr_);
+  client_stream_filter_manager_ptr_->CreateFilterCollectorIfNotExist(func_name, filter_name_vec);
+
+  // 注册 func wrapper
+  const auto& stream_client_func_wrapper_ref = *stream_client_func_wrapper_ptr;
+
+  if (!rpc_registry_ptr_->RegisterStreamClientFunc(std::move(stream_client_func_wrapper_ptr)))
+    return false;
+
+  auto backend_itr = clients_backend_index_map_.find(std::string(func_name));
+  if (backend_itr == clients_backend_index_map_.end()) {
+    auto backend_ptr_vec = GetBackendsByRules(func_name, clients_backends_rules_);
+    auto emplace_ret = clients_backend_index_map_.emplace(std::string(func_name), std::move(backend_ptr_vec));
+    backend_itr = emplace_ret.first;
+  }
+
+  bool ret = false;
+  for (auto& itr : backend_itr->second) {
+    if (itr->RegisterStreamClientFunc(stream_client_func_wrapper_ref)) {
+      AIMRT_TRACE("Register stream client func '{}' to backend '{}'.", func_name, itr->Name());
+      ret = true;
+    }
+  }
+
+  if (!ret)
+    AIMRT_ERROR("No backend supports stream client func '{}'.", func_name);
+
+  return ret;
+}
+
+std::shared_ptr<RpcStream> RpcBackendManager::OpenStream(OpenStreamProxyInfoWrapper&& wrapper) {
+  auto func_name = wrapper.func_name;
+  aimrt::rpc::ContextRef ctx_ref(wrapper.ctx_ptr);
+
+  const auto* stream_client_func_wrapper_ptr = rpc_registry_ptr_->GetStreamClientFuncWrapperPtr(
+      func_name, wrapper.pkg_path, wrapper.module_name);
+
+  auto stream_ptr = std::make_shared<RpcStream>(
+      ++stream_id_counter_,
+      RpcStream::Options{
+          .mode = (stream_client_func_wrapper_ptr != nullptr) ? stream_client_func_wrapper_ptr->mode
+                                                              : RpcStreamMode::kBidiStream,
+          .window_size = (wrapper.window_size > 0) ? wrapper.window_size : RpcStream::Options().window_size,
+          .wait_establish = true});
+
+  if (omnirt_unlikely(state_.load() != State::kStart)) {
+    AIMRT_WARN("Method can only be called when state is 'Start'.");
+    stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_UNKNOWN));
+    if (wrapper.callback) wrapper.callback(stream_ptr->GetStatus());
+    return stream_ptr;
+  }
+
+  // func未注册
+  if (omnirt_unlikely(stream_client_func_wrapper_ptr == nullptr)) {
+    AIMRT_WARN("Stream func is not registered, func: {}, pkg: {}, module: {}",
+               func_name, wrapper.pkg_path, wrapper.module_name);
+
+    stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_FUNC_NOT_REGISTERED));
+    if (wrapper.callback) wrapper.callback(stream_ptr->GetStatus());
+    return stream_ptr;
+  }
+
+  // 检查ctx
+  if (ctx_ref.GetType() != aimrt_rpc_context_type_t::AIMRT_RPC_CLIENT_CONTEXT ||
+      ctx_ref.CheckUsed()) {
+    stream_ptr->Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_CLI_INVALID_CONTEXT));
+    if (wrapper.callback) wrapper.callback(stream_ptr->GetStatus());
+    return stream_ptr;
+  }
+
+  ctx_ref.SetUsed();
+
+  // 找到filter
+  const auto& filter_collector = client_stream_filter_manager_ptr_->GetFilterCollector(func_name);
+
+  // 创建wrapper
+  auto stream_invoke_wrapper_ptr = std::make_shared<StreamInvokeWrapper>(
+      StreamInvokeWrapper{
+          .info = stream_client_func_wrapper_ptr->info,
+          .mode = stream_ptr->Mode(),
+          .req_ptr = wrapper.req_ptr,
+          .ctx_ref = ctx_ref,
+          .stream_ptr = stream_ptr,
+          .callback = std::move(wrapper.callback)});
+
+  // 流结束时移出活跃流并通知调用方，filter可以包装callback
+  rpc_registry_ptr_->AddActiveStream(stream_ptr);
+  stream_ptr->AddDoneHandle(
+      RpcStreamSide::kClient,
+      [this, stream_id = stream_ptr->Id(), stream_invoke_wrapper_ptr](aimrt::rpc::Status status) {
+        rpc_registry_ptr_->RemoveActiveStream(stream_id);
+        if (stream_invoke_wrapper_ptr->callback) stream_invoke_wrapper_ptr->callback(status);
+      });
+
+  // 发起调用，流式调用没有默认超时
+  filter_collector.InvokeRpc(
+      [this](const std::shared_ptr<StreamInvokeWrapper>& stream_invoke_wrapper_ptr) {
+        std::string_view func_name = stream_invoke_wrapper_ptr->info.func_name;
+
+        uint32_t err_code = 0;
+        auto* backend_ptr = SelectClientBackend(
+            func_name, stream_invoke_wrapper_ptr->ctx_ref.GetToAddr(), err_code);
+
+        if (omnirt_unlikely(backend_ptr == nullptr)) {
+          stream_invoke_wrapper_ptr->stream_ptr->Cancel(aimrt::rpc::Status(err_code));
           return;
         }
 
-        // 使用配置的第一个backend
-        auto& backend = *(backend_ptr_vec[0]);
-        AIMRT_TRACE("Rpc call use backend '{}', func name '{}'.", backend.Name(), func_name);
-        backend.Invoke(client_invoke_wrapper_ptr);
+        backend_ptr->OpenStream(stream_invoke_wrapper_ptr);
+
+        // 后端未主动放行时，在其建流完成后放行调用方的写入
+        stream_invoke_wrapper_ptr->stream_ptr->Establish();
       },
-      client_invoke_wrapper_ptr);
+      stream_invoke_wrapper_ptr);
+
+  return stream_ptr;
 }
 
 RpcBackendManager::FuncBackendInfoMap RpcBackendManager::GetClientsBackendInfo() const {
@@ -382,6 +644,98 @@ std::vector<RpcBackendBase*> RpcBackendManager::GetBackendsByRules(
   return {};
 }
 
+std::shared_ptr<RpcServiceDispatcher> RpcBackendManager::GetServiceDispatcher(std::string_view func_name) {
+  // 同名的普通调用与流式调用共用一个分发器
+  auto find_itr = servers_dispatcher_map_.find(func_name);
+  if (find_itr != servers_dispatcher_map_.end())
+    return find_itr->second;
+
+  std::shared_ptr<RpcServiceDispatcher> dispatcher_ptr;
+
+  for (const auto& item : servers_dispatch_rules_) {
+    const auto& func_regex = item.first;
+    const auto& options = item.second;
+
+    try {
+      if (std::regex_match(func_name.begin(), func_name.end(), std::regex(func_regex, std::regex::ECMAScript))) {
+        if (options.executor || options.max_concurrency != 0) {
+          AIMRT_TRACE("Service func '{}' use executor '{}', max concurrency {}, queue policy '{}'.",
+                      func_name,
+                      options.executor ? options.executor.Name() : "<none>",
+                      options.max_concurrency,
+                      RpcServiceDispatcher::QueuePolicyToString(options.queue_policy));
+          dispatcher_ptr = std::make_shared<RpcServiceDispatcher>(options);
+        }
+        break;
+      }
+    } catch (const std::exception& e) {
+      AIMRT_WARN("Regex get exception, expr: {}, string: {}, exception info: {}",
+                 func_regex, func_name, e.what());
+    }
+  }
+
+  servers_dispatcher_map_.emplace(func_name, dispatcher_ptr);
+  return dispatcher_ptr;
+}
+
+RpcBackendBase* RpcBackendManager::SelectClientBackend(
+    std::string_view func_name, std::string_view to_addr, uint32_t& err_code) {
+  auto find_itr = clients_backend_index_map_.find(std::string(func_name));
+
+  if (omnirt_unlikely(find_itr == clients_backend_index_map_.end() || find_itr->second.empty())) {
+    AIMRT_WARN("Rpc call found no backend to handle, func name '{}'.", func_name);
+    err_code = AIMRT_RPC_STATUS_CLI_NO_BACKEND_TO_HANDLE;
+    return nullptr;
+  }
+
+  const auto& backend_ptr_vec = find_itr->second;
+
+  // 如果ctx中指定了后端，则使用指定的后端
+  if (!to_addr.empty()) {
+    // to_addr格式：backend_name://url_str
+    AIMRT_TRACE("Rpc call use the specified address '{}', func name '{}'.", to_addr, func_name);
+    auto pos = to_addr.find("://");
+    if (pos != std::string_view::npos) {
+      auto addr_backend = to_addr.substr(0, pos);
+
+      auto backend_itr = rpc_backend_index_map_.find(addr_backend);
+      if (backend_itr != rpc_backend_index_map_.end()) {
+        auto* backend_ptr = backend_itr->second;
+
+        if (std::find(backend_ptr_vec.begin(), backend_ptr_vec.end(), backend_ptr) != backend_ptr_vec.end())
+          return backend_ptr;
+      }
+    }
+    AIMRT_ERROR("Rpc call address '{}' is invalid, func name '{}'.", to_addr, func_name);
+    err_code = AIMRT_RPC_STATUS_CLI_INVALID_ADDR;
+    return nullptr;
+  }
+
+  // 使用配置的第一个backend
+  auto* backend_ptr = backend_ptr_vec[0];
+  AIMRT_TRACE("Rpc call use backend '{}', func name '{}'.", backend_ptr->Name(), func_name);
+  return backend_ptr;
+}
+
+std::vector<std::string> RpcBackendManager::GetStreamFilterRules(
+    std::string_view func_name,
+    const std::vector<std::pair<std::string, std::vector<std::string>>>& rules,
+    const FrameworkAsyncRpcStreamFilterManager& filter_manager) {
+  auto filter_name_vec = GetFilterRules(func_name, rules);
+
+  std::vector<std::string> result;
+  result.reserve(filter_name_vec.size());
+  for (auto& name : filter_name_vec) {
+    if (filter_manager.HasFilter(name)) {
+      result.emplace_back(std::move(name));
+    } else {
+      AIMRT_TRACE("Filter '{}' has no stream version, skip it for stream func '{}'.", name, func_name);
+    }
+  }
+
+  return result;
+}
+
 std::vector<std::string> RpcBackendManager::GetFilterRules(
     std::string_view func_name,
     const std::vector<std::pair<std::string, std::vector<std::string>>>& rules) {
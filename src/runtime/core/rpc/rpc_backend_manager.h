@@ -8,6 +8,7 @@
 #include "aimrt_module_c_interface/util/function_base.h"
 #include "core/rpc/rpc_backend_base.h"
 #include "core/rpc/rpc_framework_async_filter.h"
+#include "core/rpc/rpc_service_dispatcher.h"
 #include "util/log_util.h"
 
 namespace aimrt::runtime::core::rpc {
@@ -44,6 +45,40 @@ struct InvokeProxyInfoWrapper {
   aimrt_function_base_t* callback;
 };
 
+struct RegisterStreamServiceFuncProxyInfoWrapper {
+  std::string_view pkg_path;
+  std::string_view module_name;
+
+  std::string_view func_name;
+  RpcStreamMode mode;
+  const void* custom_type_support_ptr;
+  const aimrt_type_support_base_t* req_type_support;
+  const aimrt_type_support_base_t* rsp_type_support;
+  RpcStreamServiceHandle service_func;
+};
+
+struct RegisterStreamClientFuncProxyInfoWrapper {
+  std::string_view pkg_path;
+  std::string_view module_name;
+
+  std::string_view func_name;
+  RpcStreamMode mode;
+  const void* custom_type_support_ptr;
+  const aimrt_type_support_base_t* req_type_support;
+  const aimrt_type_support_base_t* rsp_type_support;
+};
+
+struct OpenStreamProxyInfoWrapper {
+  std::string_view pkg_path;
+  std::string_view module_name;
+
+  std::string_view func_name;
+  const aimrt_rpc_context_base_t* ctx_ptr;
+  const void* req_ptr;
+  uint32_t window_size;
+  std::function<void(aimrt::rpc::Status)> callback;
+};
+
 class RpcBackendManager {
  public:
   enum class State : uint32_t {
@@ -80,6 +115,12 @@ class RpcBackendManager {
   void SetClientFrameworkAsyncRpcFilterManager(FrameworkAsyncRpcFilterManager* ptr);
   void SetServerFrameworkAsyncRpcFilterManager(FrameworkAsyncRpcFilterManager* ptr);
 
+  void SetClientFrameworkAsyncRpcStreamFilterManager(FrameworkAsyncRpcStreamFilterManager* ptr);
+  void SetServerFrameworkAsyncRpcStreamFilterManager(FrameworkAsyncRpcStreamFilterManager* ptr);
+
+  void SetServersDispatchRules(
+      const std::vector<std::pair<std::string, RpcServiceDispatcher::Options>>& rules);
+
   void SetClientsBackendsRules(
       const std::vector<std::pair<std::string, std::vector<std::string>>>& rules);
   void SetServersBackendsRules(
@@ -91,6 +132,15 @@ class RpcBackendManager {
   bool RegisterClientFunc(RegisterClientFuncProxyInfoWrapper&& wrapper);
   void Invoke(InvokeProxyInfoWrapper&& wrapper);
 
+  bool RegisterStreamServiceFunc(RegisterStreamServiceFuncProxyInfoWrapper&& wrapper);
+  bool RegisterStreamClientFunc(RegisterStreamClientFuncProxyInfoWrapper&& wrapper);
+
+  /**
+   * @brief 建立流式调用
+   * @return 总是返回一个流，失败时流已以对应的错误状态取消
+   */
+  std::shared_ptr<RpcStream> OpenStream(OpenStreamProxyInfoWrapper&& wrapper);
+
   using FuncBackendInfoMap = std::unordered_map<std::string_view, std::vector<std::string_view>>;
   FuncBackendInfoMap GetClientsBackendInfo() const;
   FuncBackendInfoMap GetServersBackendInfo() const;
@@ -104,6 +154,15 @@ class RpcBackendManager {
       std::string_view func_name,
       const std::vector<std::pair<std::string, std::vector<std::string>>>& rules);
 
+  std::vector<std::string> GetStreamFilterRules(
+      std::string_view func_name,
+      const std::vector<std::pair<std::string, std::vector<std::string>>>& rules,
+      const FrameworkAsyncRpcStreamFilterManager& filter_manager);
+
+  std::shared_ptr<RpcServiceDispatcher> GetServiceDispatcher(std::string_view func_name);
+
+  RpcBackendBase* SelectClientBackend(std::string_view func_name, std::string_view to_addr, uint32_t& err_code);
+
  private:
   std::atomic<State> state_ = State::kPreInit;
   std::shared_ptr<aimrt::common::util::LoggerWrapper> logger_ptr_;
@@ -117,6 +176,22 @@ class RpcBackendManager {
   FrameworkAsyncRpcFilterManager* client_filter_manager_ptr_ = nullptr;
   FrameworkAsyncRpcFilterManager* server_filter_manager_ptr_ = nullptr;
 
+  FrameworkAsyncRpcStreamFilterManager* client_stream_filter_manager_ptr_ = nullptr;
+  FrameworkAsyncRpcStreamFilterManager* server_stream_filter_manager_ptr_ = nullptr;
+
+  // stream
+  std::atomic<uint64_t> stream_id_counter_ = 0;
+
+  // dispatch
+  std::vector<std::pair<std::string, RpcServiceDispatcher::Options>> servers_dispatch_rules_;
+
+  std::unordered_map<
+      std::string,
+      std::shared_ptr<RpcServiceDispatcher>,
+      aimrt::common::util::StringHash,
+      std::equal_to<>>
+      servers_dispatcher_map_;
+
   // backend
   std::vector<RpcBackendBase*> rpc_backend_index_vec_;
   std::unordered_map<std::string_view, RpcBackendBase*> rpc_backend_index_map_;
@@ -3,73 +3,123 @@
 
 #pragma once
 
+#include "core/allocator/tracked_buffer_array_allocator.h"
 #include "core/rpc/rpc_invoke_wrapper.h"
+#include "core/util/serialization_codec.h"
 
 namespace aimrt::runtime::core::rpc {
 
-inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeReqWithCache(
-    InvokeWrapper& invoke_wrapper, std::string_view serialization_type) {
-  const auto& info = invoke_wrapper.info;
-  auto& req_serialization_cache = invoke_wrapper.req_serialization_cache;
+/// rpc序列化使用的分配器，开启分配统计时计入rpc.serialization分配域
+inline const aimrt_buffer_array_allocator_t* RpcSerializationAllocator() {
+  static const uint32_t kTrackDomain =
+      aimrt::common::util::AllocTracker::Instance().RegisterDomain("rpc.serialization");
+  return allocator::TrackedBufferArrayAllocator::NativeHandle(kTrackDomain);
+}
 
-  auto find_itr = req_serialization_cache.find(std::string(serialization_type));
-  if (find_itr != req_serialization_cache.end())
-    return find_itr->second;
+namespace rpc_detail {
 
-  auto buffer_array_ptr = std::make_unique<aimrt::util::BufferArray>();
-  bool serialize_ret = info.req_type_support_ref.Serialize(
-      serialization_type,
-      invoke_wrapper.req_ptr,
-      buffer_array_ptr->AllocatorNativeHandle(),
-      buffer_array_ptr->BufferArrayNativeHandle());
+/**
+ * @brief 请求与响应共用的缓存序列化实现
+ * @note 压缩序列化类型在缓存的基础序列化结果上压缩，每次调用只压缩一次；序列化与压缩耗时计入serialization_ns
+ */
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeWithCacheByIndex(
+    InvokeWrapper& invoke_wrapper,
+    util::SerializationCache& serialization_cache,
+    const aimrt::util::TypeSupportRef& type_support_ref,
+    const void* msg_ptr,
+    uint32_t serialization_type_index) {
+  if (auto buffer_array_view_ptr = serialization_cache.FindByIndex(serialization_type_index))
+    return buffer_array_view_ptr;
 
-  AIMRT_ASSERT(serialize_ret, "Serialize failed.");
+  const std::string_view serialization_type = util::SerializationCache::TypeName(serialization_type_index);
 
-  auto* ptr = buffer_array_ptr.get();
-  auto buffer_array_view_ptr = std::shared_ptr<aimrt::util::BufferArrayView>(
-      new aimrt::util::BufferArrayView(*ptr),
-      [buffer_array_ptr{std::move(buffer_array_ptr)}](const auto* ptr) { delete ptr; });
+  auto [base_type, codec_name] = util::SerializationCodec::SplitSerializationType(serialization_type);
+  if (!codec_name.empty()) {
+    const uint32_t base_type_index = util::SerializationCache::TypeIndex(base_type);
+    return serialization_cache.GetOrCreateByIndex(serialization_type_index, [&, base_type_index, codec_name = codec_name]() {
+      auto base_buffer_array_view_ptr = SerializeWithCacheByIndex(
+          invoke_wrapper, serialization_cache, type_support_ref, msg_ptr, base_type_index);
 
-  req_serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+      auto begin_time = std::chrono::steady_clock::now();
 
-  return buffer_array_view_ptr;
-}
+      auto buffer_array_view_ptr = std::make_shared<aimrt::util::BufferArrayView>(
+          util::SerializationCodec::Instance().Encode(codec_name, *(base_buffer_array_view_ptr->NativeHandle())));
 
-inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeReqWithCache(
-    InvokeWrapper& invoke_wrapper, std::string_view serialization_type) noexcept {
-  try {
-    return SerializeReqWithCache(invoke_wrapper, serialization_type);
-  } catch (...) {
-    return {};
+      invoke_wrapper.serialization_ns.Add(std::chrono::steady_clock::now() - begin_time);
+
+      return buffer_array_view_ptr;
+    });
   }
+
+  return serialization_cache.GetOrCreateByIndex(serialization_type_index, [&]() {
+    auto begin_time = std::chrono::steady_clock::now();
+
+    aimrt::util::BufferArray buffer_array(RpcSerializationAllocator());
+    bool serialize_ret = type_support_ref.Serialize(
+        serialization_type,
+        msg_ptr,
+        buffer_array.AllocatorNativeHandle(),
+        buffer_array.BufferArrayNativeHandle());
+
+    invoke_wrapper.serialization_ns.Add(std::chrono::steady_clock::now() - begin_time);
+
+    AIMRT_ASSERT(serialize_ret, "Serialize failed.");
+
+    return std::make_shared<aimrt::util::BufferArrayView>(buffer_array.MoveToSharedBuffer());
+  });
 }
 
-inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeRspWithCache(
-    InvokeWrapper& invoke_wrapper, std::string_view serialization_type) {
-  const auto& info = invoke_wrapper.info;
-  auto& rsp_serialization_cache = invoke_wrapper.rsp_serialization_cache;
+}  // namespace rpc_detail
 
-  auto find_itr = rsp_serialization_cache.find(std::string(serialization_type));  // TODO: use serialization_type);
-  if (find_itr != rsp_serialization_cache.end())
-    return find_itr->second;
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeReqWithCacheByIndex(
+    InvokeWrapper& invoke_wrapper, uint32_t serialization_type_index) {
+  return rpc_detail::SerializeWithCacheByIndex(
+      invoke_wrapper, invoke_wrapper.req_serialization_cache,
+      invoke_wrapper.info.req_type_support_ref, invoke_wrapper.req_ptr, serialization_type_index);
+}
+
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeRspWithCacheByIndex(
+    InvokeWrapper& invoke_wrapper, uint32_t serialization_type_index) {
+  return rpc_detail::SerializeWithCacheByIndex(
+      invoke_wrapper, invoke_wrapper.rsp_serialization_cache,
+      invoke_wrapper.info.rsp_type_support_ref, invoke_wrapper.rsp_ptr, serialization_type_index);
+}
 
-  auto buffer_array_ptr = std::make_unique<aimrt::util::BufferArray>();
-  bool serialize_ret = info.rsp_type_support_ref.Serialize(
-      serialization_type,
-      invoke_wrapper.rsp_ptr,
-      buffer_array_ptr->AllocatorNativeHandle(),
-      buffer_array_ptr->BufferArrayNativeHandle());
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeReqWithCache(
+    InvokeWrapper& invoke_wrapper, std::string_view serialization_type) {
+  return SerializeReqWithCacheByIndex(invoke_wrapper, util::SerializationCache::TypeIndex(serialization_type));
+}
 
-  AIMRT_ASSERT(serialize_ret, "Serialize failed.");
+inline std::shared_ptr<aimrt::util::BufferArrayView> SerializeRspWithCache(
+    InvokeWrapper& invoke_wrapper, std::string_view serialization_type) {
+  return SerializeRspWithCacheByIndex(invoke_wrapper, util::SerializationCache::TypeIndex(serialization_type));
+}
 
-  auto* ptr = buffer_array_ptr.get();
-  auto buffer_array_view_ptr = std::shared_ptr<aimrt::util::BufferArrayView>(
-      new aimrt::util::BufferArrayView(*ptr),
-      [buffer_array_ptr{std::move(buffer_array_ptr)}](const auto* ptr) { delete ptr; });
+inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeReqWithCacheByIndex(
+    InvokeWrapper& invoke_wrapper, uint32_t serialization_type_index) noexcept {
+  try {
+    return SerializeReqWithCacheByIndex(invoke_wrapper, serialization_type_index);
+  } catch (...) {
+    return {};
+  }
+}
 
-  rsp_serialization_cache.emplace(serialization_type, buffer_array_view_ptr);
+inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeRspWithCacheByIndex(
+    InvokeWrapper& invoke_wrapper, uint32_t serialization_type_index) noexcept {
+  try {
+    return SerializeRspWithCacheByIndex(invoke_wrapper, serialization_type_index);
+  } catch (...) {
+    return {};
+  }
+}
 
-  return buffer_array_view_ptr;
+inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeReqWithCache(
+    InvokeWrapper& invoke_wrapper, std::string_view serialization_type) noexcept {
+  try {
+    return SerializeReqWithCache(invoke_wrapper, serialization_type);
+  } catch (...) {
+    return {};
+  }
 }
 
 inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeRspWithCache(
@@ -81,4 +131,50 @@ inline std::shared_ptr<aimrt::util::BufferArrayView> TrySerializeRspWithCache(
   }
 }
 
+/**
+ * @brief 将消息序列化后反序列化为目标类型的新对象，用于跨包传递流消息
+ * @return 失败时返回空指针
+ */
+inline std::shared_ptr<void> ConvertStreamMsg(
+    std::string_view serialization_type,
+    const aimrt::util::TypeSupportRef& from_type_support_ref,
+    const aimrt::util::TypeSupportRef& to_type_support_ref,
+    const void* msg_ptr) noexcept {
+  try {
+    // 进程内转换，压缩没有意义，只使用基础序列化类型
+    serialization_type = util::SerializationCodec::SplitSerializationType(serialization_type).first;
+
+    aimrt::util::BufferArray buffer_array;
+    if (!from_type_support_ref.Serialize(
+            serialization_type,
+            msg_ptr,
+            buffer_array.AllocatorNativeHandle(),
+            buffer_array.BufferArrayNativeHandle()))
+      return {};
+
+    std::shared_ptr<void> to_msg_ptr = to_type_support_ref.CreateSharedPtr();
+
+    aimrt::util::BufferArrayView buffer_array_view(buffer_array);
+    if (!to_type_support_ref.Deserialize(
+            serialization_type, *(buffer_array_view.NativeHandle()), to_msg_ptr.get()))
+      return {};
+
+    return to_msg_ptr;
+  } catch (...) {
+    return {};
+  }
+}
+
+inline RpcStream::MsgTransform MakeStreamMsgTransform(
+    std::string serialization_type,
+    aimrt::util::TypeSupportRef from_type_support_ref,
+    aimrt::util::TypeSupportRef to_type_support_ref) {
+  return [serialization_type{std::move(serialization_type)},
+          from_type_support_ref,
+          to_type_support_ref](const RpcStream::MsgPtr& in, RpcStream::MsgPtr& out) -> bool {
+    out = ConvertStreamMsg(serialization_type, from_type_support_ref, to_type_support_ref, in.get());
+    return static_cast<bool>(out);
+  };
+}
+
 }  // namespace aimrt::runtime::core::rpc
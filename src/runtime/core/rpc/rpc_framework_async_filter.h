@@ -11,59 +11,73 @@
 
 namespace aimrt::runtime::core::rpc {
 
-using FrameworkAsyncRpcHandle = std::function<void(const std::shared_ptr<InvokeWrapper>&)>;
-using FrameworkAsyncRpcFilter = std::function<void(const std::shared_ptr<InvokeWrapper>&, FrameworkAsyncRpcHandle&&)>;
+/**
+ * @brief 异步rpc filter链，Wrapper为InvokeWrapper（普通调用）或StreamInvokeWrapper（流式调用）
+ */
+template <typename Wrapper>
+class BasicFrameworkAsyncRpcFilterCollector {
+ public:
+  using Handle = std::function<void(const std::shared_ptr<Wrapper>&)>;
+  using Filter = std::function<void(const std::shared_ptr<Wrapper>&, Handle&&)>;
 
-class FrameworkAsyncRpcFilterCollector {
  public:
-  FrameworkAsyncRpcFilterCollector()
+  BasicFrameworkAsyncRpcFilterCollector()
       : final_filter_(
-            [](const std::shared_ptr<InvokeWrapper>& invoke_wrapper_ptr, FrameworkAsyncRpcHandle&& h) {
+            [](const std::shared_ptr<Wrapper>& invoke_wrapper_ptr, Handle&& h) {
               h(invoke_wrapper_ptr);
             }) {}
-  ~FrameworkAsyncRpcFilterCollector() = default;
+  ~BasicFrameworkAsyncRpcFilterCollector() = default;
 
-  FrameworkAsyncRpcFilterCollector(const FrameworkAsyncRpcFilterCollector&) = delete;
-  FrameworkAsyncRpcFilterCollector& operator=(const FrameworkAsyncRpcFilterCollector&) = delete;
+  BasicFrameworkAsyncRpcFilterCollector(const BasicFrameworkAsyncRpcFilterCollector&) = delete;
+  BasicFrameworkAsyncRpcFilterCollector& operator=(const BasicFrameworkAsyncRpcFilterCollector&) = delete;
 
-  void RegisterFilter(const FrameworkAsyncRpcFilter& filter) {
+  void RegisterFilter(const Filter& filter) {
     final_filter_ =
         [final_filter{std::move(final_filter_)}, &filter](
-            const std::shared_ptr<InvokeWrapper>& invoke_wrapper_ptr, FrameworkAsyncRpcHandle&& h) {
+            const std::shared_ptr<Wrapper>& invoke_wrapper_ptr, Handle&& h) {
           filter(
               invoke_wrapper_ptr,
-              [&final_filter, h{std::move(h)}](const std::shared_ptr<InvokeWrapper>& invoke_wrapper_ptr) mutable {
+              [&final_filter, h{std::move(h)}](const std::shared_ptr<Wrapper>& invoke_wrapper_ptr) mutable {
                 final_filter(invoke_wrapper_ptr, std::move(h));
               });
         };
   }
 
   void InvokeRpc(
-      FrameworkAsyncRpcHandle&& h, const std::shared_ptr<InvokeWrapper>& invoke_wrapper_ptr) const {
+      Handle&& h, const std::shared_ptr<Wrapper>& invoke_wrapper_ptr) const {
     final_filter_(invoke_wrapper_ptr, std::move(h));
   }
 
   void Clear() {
-    final_filter_ = FrameworkAsyncRpcFilter();
+    final_filter_ = Filter();
   }
 
  private:
-  FrameworkAsyncRpcFilter final_filter_;
+  Filter final_filter_;
 };
 
-class FrameworkAsyncRpcFilterManager {
+template <typename Wrapper>
+class BasicFrameworkAsyncRpcFilterManager {
+ public:
+  using Filter = typename BasicFrameworkAsyncRpcFilterCollector<Wrapper>::Filter;
+  using Collector = BasicFrameworkAsyncRpcFilterCollector<Wrapper>;
+
  public:
-  FrameworkAsyncRpcFilterManager() = default;
-  ~FrameworkAsyncRpcFilterManager() = default;
+  BasicFrameworkAsyncRpcFilterManager() = default;
+  ~BasicFrameworkAsyncRpcFilterManager() = default;
 
-  FrameworkAsyncRpcFilterManager(const FrameworkAsyncRpcFilterManager&) = delete;
-  FrameworkAsyncRpcFilterManager& operator=(const FrameworkAsyncRpcFilterManager&) = delete;
+  BasicFrameworkAsyncRpcFilterManager(const BasicFrameworkAsyncRpcFilterManager&) = delete;
+  BasicFrameworkAsyncRpcFilterManager& operator=(const BasicFrameworkAsyncRpcFilterManager&) = delete;
 
-  void RegisterFilter(std::string_view name, FrameworkAsyncRpcFilter&& filter) {
+  void RegisterFilter(std::string_view name, Filter&& filter) {
     auto emplace_ret = filter_map_.emplace(name, std::move(filter));
     AIMRT_ASSERT(emplace_ret.second, "Register filter {} failed.", name);
   }
 
+  bool HasFilter(std::string_view name) const {
+    return filter_map_.find(std::string(name)) != filter_map_.end();
+  }
+
   std::vector<std::string> GetAllFiltersName() const {
     std::vector<std::string> result;
     result.reserve(filter_map_.size());
@@ -78,7 +92,7 @@ class FrameworkAsyncRpcFilterManager {
     if (omnirt_unlikely(filter_name_vec.empty()))
       return;
 
-    auto collector_ptr = std::make_unique<FrameworkAsyncRpcFilterCollector>();
+    auto collector_ptr = std::make_unique<Collector>();
 
     for (const auto& name : filter_name_vec) {
       auto find_itr = filter_map_.find(name);
@@ -100,7 +114,7 @@ class FrameworkAsyncRpcFilterManager {
       CreateFilterCollector(topic_name, filter_name_vec);
   }
 
-  const FrameworkAsyncRpcFilterCollector& GetFilterCollector(std::string_view func_name) const {
+  const Collector& GetFilterCollector(std::string_view func_name) const {
     auto find_itr = filter_collector_map_.find(std::string(func_name));
     if (find_itr != filter_collector_map_.end()) {
       return *(find_itr->second);
@@ -125,12 +139,12 @@ class FrameworkAsyncRpcFilterManager {
 
  private:
   // filter name - filter
-  std::unordered_map<std::string, FrameworkAsyncRpcFilter> filter_map_;
+  std::unordered_map<std::string, Filter> filter_map_;
 
   // func name - filter collector
   using FilterCollectorMap = std::unordered_map<
       std::string,
-      std::unique_ptr<FrameworkAsyncRpcFilterCollector>,
+      std::unique_ptr<Collector>,
       aimrt::common::util::StringHash,
       std::equal_to<>>;
   FilterCollectorMap filter_collector_map_;
@@ -143,7 +157,17 @@ class FrameworkAsyncRpcFilterManager {
       std::equal_to<>>;
   FilterNameMap filter_names_map_;
 
-  FrameworkAsyncRpcFilterCollector default_filter_collector_;
+  Collector default_filter_collector_;
 };
 
+using FrameworkAsyncRpcFilterCollector = BasicFrameworkAsyncRpcFilterCollector<InvokeWrapper>;
+using FrameworkAsyncRpcFilterManager = BasicFrameworkAsyncRpcFilterManager<InvokeWrapper>;
+using FrameworkAsyncRpcHandle = FrameworkAsyncRpcFilterCollector::Handle;
+using FrameworkAsyncRpcFilter = FrameworkAsyncRpcFilterCollector::Filter;
+
+using FrameworkAsyncRpcStreamFilterCollector = BasicFrameworkAsyncRpcFilterCollector<StreamInvokeWrapper>;
+using FrameworkAsyncRpcStreamFilterManager = BasicFrameworkAsyncRpcFilterManager<StreamInvokeWrapper>;
+using FrameworkAsyncRpcStreamHandle = FrameworkAsyncRpcStreamFilterCollector::Handle;
+using FrameworkAsyncRpcStreamFilter = FrameworkAsyncRpcStreamFilterCollector::Filter;
+
 }  // namespace aimrt::runtime::core::rpc
\ No newline at end of file
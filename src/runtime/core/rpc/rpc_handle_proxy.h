@@ -31,6 +31,60 @@ class RpcHandleProxy {
 
   const aimrt_rpc_handle_base_t* NativeHandle() const { return &base_; }
 
+  // 流式调用接口，暂只提供给框架内C++代码使用
+  bool RegisterStreamServiceFunc(
+      std::string_view func_name,
+      RpcStreamMode mode,
+      const void* custom_type_support_ptr,
+      const aimrt_type_support_base_t* req_type_support,
+      const aimrt_type_support_base_t* rsp_type_support,
+      RpcStreamServiceHandle&& service_func) const {
+    return rpc_backend_manager_.RegisterStreamServiceFunc(
+        RegisterStreamServiceFuncProxyInfoWrapper{
+            .pkg_path = pkg_path_,
+            .module_name = module_name_,
+            .func_name = func_name,
+            .mode = mode,
+            .custom_type_support_ptr = custom_type_support_ptr,
+            .req_type_support = req_type_support,
+            .rsp_type_support = rsp_type_support,
+            .service_func = std::move(service_func)});
+  }
+
+  bool RegisterStreamClientFunc(
+      std::string_view func_name,
+      RpcStreamMode mode,
+      const void* custom_type_support_ptr,
+      const aimrt_type_support_base_t* req_type_support,
+      const aimrt_type_support_base_t* rsp_type_support) const {
+    return rpc_backend_manager_.RegisterStreamClientFunc(
+        RegisterStreamClientFuncProxyInfoWrapper{
+            .pkg_path = pkg_path_,
+            .module_name = module_name_,
+            .func_name = func_name,
+            .mode = mode,
+            .custom_type_support_ptr = custom_type_support_ptr,
+            .req_type_support = req_type_support,
+            .rsp_type_support = rsp_type_support});
+  }
+
+  std::shared_ptr<RpcStream> OpenStream(
+      std::string_view func_name,
+      const aimrt_rpc_context_base_t* ctx_ptr,
+      const void* req_ptr,
+      uint32_t window_size,
+      std::function<void(aimrt::rpc::Status)>&& callback) const {
+    return rpc_backend_manager_.OpenStream(
+        OpenStreamProxyInfoWrapper{
+            .pkg_path = pkg_path_,
+            .module_name = module_name_,
+            .func_name = func_name,
+            .ctx_ptr = ctx_ptr,
+            .req_ptr = req_ptr,
+            .window_size = window_size,
+            .callback = std::move(callback)});
+  }
+
  private:
   bool RegisterServiceFunc(
       aimrt_string_view_t func_name,
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <string>
@@ -10,6 +12,8 @@
 #include "aimrt_module_cpp_interface/rpc/rpc_context.h"
 #include "aimrt_module_cpp_interface/rpc/rpc_status.h"
 #include "aimrt_module_cpp_interface/util/type_support.h"
+#include "core/rpc/rpc_stream.h"
+#include "core/util/serialization_cache.h"
 
 namespace aimrt::runtime::core::rpc {
 
@@ -23,6 +27,29 @@ struct FuncInfo {
   aimrt::util::TypeSupportRef rsp_type_support_ref;
 };
 
+/**
+ * @brief 可并发累加的耗时计数，多个后端可能同时序列化同一调用的不同序列化类型
+ * @note 可移动只是为了InvokeWrapper能够聚合初始化，移动时不能有并发访问
+ */
+class ConcurrentNsCounter {
+ public:
+  ConcurrentNsCounter() = default;
+  ConcurrentNsCounter(ConcurrentNsCounter&& other) noexcept : ns_(other.Load()) {}
+  ConcurrentNsCounter& operator=(ConcurrentNsCounter&& other) noexcept {
+    ns_.store(other.Load(), std::memory_order_relaxed);
+    return *this;
+  }
+
+  void Add(std::chrono::steady_clock::duration duration) {
+    ns_.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+  }
+
+  uint64_t Load() const { return ns_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> ns_ = 0;
+};
+
 struct InvokeWrapper {
   const FuncInfo& info;
 
@@ -33,18 +60,35 @@ struct InvokeWrapper {
 
   std::function<void(aimrt::rpc::Status)> callback;
 
-  std::unordered_map<
-      std::string,
-      std::shared_ptr<aimrt::util::BufferArrayView>,
-      aimrt::common::util::StringHash,
-      std::equal_to<>>
-      req_serialization_cache;
-  std::unordered_map<
-      std::string,
-      std::shared_ptr<aimrt::util::BufferArrayView>,
-      aimrt::common::util::StringHash,
-      std::equal_to<>>
-      rsp_serialization_cache;
+  util::SerializationCache req_serialization_cache;
+  util::SerializationCache rsp_serialization_cache;
+
+  // 以下字段用于调用统计
+  std::chrono::steady_clock::time_point dispatch_time;  ///< 服务端调用进入执行器/并发限制排队的时刻，未排队时为空
+  ConcurrentNsCounter serialization_ns;                  ///< 通过序列化缓存完成的序列化累计耗时
 };
 
+/**
+ * @brief 流式调用包装
+ * @details req_ptr为建流时携带的首个请求，可以为空；callback在流结束时以最终状态调用一次
+ */
+struct StreamInvokeWrapper {
+  const FuncInfo& info;
+  RpcStreamMode mode;
+
+  const void* req_ptr;
+
+  aimrt::rpc::ContextRef ctx_ref;
+
+  std::shared_ptr<RpcStream> stream_ptr;
+
+  std::function<void(aimrt::rpc::Status)> callback;
+};
+
+/**
+ * @brief 服务端流处理函数，处理结束时需调用stream_ptr->Finish
+ */
+using RpcStreamServiceHandle = std::function<void(
+    aimrt::rpc::ContextRef ctx_ref, const void* req_ptr, const std::shared_ptr<RpcStream>& stream_ptr)>;
+
 }  // namespace aimrt::runtime::core::rpc
\ No newline at end of file
@@ -36,9 +36,21 @@ struct convert<aimrt::runtime::core::rpc::RpcManager::Options> {
       server_options_node["func_name"] = server_options.func_name;
       server_options_node["enable_backends"] = server_options.enable_backends;
       server_options_node["enable_filters"] = server_options.enable_filters;
+      server_options_node["executor"] = server_options.executor;
+      server_options_node["max_concurrency"] = server_options.max_concurrency;
+      server_options_node["queue_policy"] = server_options.queue_policy;
+      server_options_node["max_queue_size"] = server_options.max_queue_size;
       node["servers_options"].push_back(server_options_node);
     }
 
+    node["response_cache"]["ttl_ms"] = rhs.response_cache_options.ttl_ms;
+    node["response_cache"]["max_entry_num"] = rhs.response_cache_options.max_entry_num;
+    node["response_cache"]["shard_num"] = rhs.response_cache_options.shard_num;
+
+    node["metrics"]["shard_num"] = rhs.metrics_options.shard_num;
+    node["metrics"]["report_interval_ms"] = rhs.metrics_options.report_interval_ms;
+    node["metrics"]["report_executor"] = rhs.metrics_options.report_executor;
+
     return node;
   }
 
@@ -79,10 +91,48 @@ struct convert<aimrt::runtime::core::rpc::RpcManager::Options> {
         if (server_options_node["enable_filters"])
           server_options.enable_filters = server_options_node["enable_filters"].as<std::vector<std::string>>();
 
+        if (server_options_node["executor"])
+          server_options.executor = server_options_node["executor"].as<std::string>();
+
+        if (server_options_node["max_concurrency"])
+          server_options.max_concurrency = server_options_node["max_concurrency"].as<uint32_t>();
+
+        if (server_options_node["queue_policy"])
+          server_options.queue_policy = server_options_node["queue_policy"].as<std::string>();
+
+        if (server_options_node["max_queue_size"])
+          server_options.max_queue_size = server_options_node["max_queue_size"].as<uint32_t>();
+
         rhs.servers_options.emplace_back(std::move(server_options));
       }
     }
 
+    if (node["response_cache"]) {
+      const auto& response_cache_node = node["response_cache"];
+
+      if (response_cache_node["ttl_ms"])
+        rhs.response_cache_options.ttl_ms = response_cache_node["ttl_ms"].as<uint32_t>();
+
+      if (response_cache_node["max_entry_num"])
+        rhs.response_cache_options.max_entry_num = response_cache_node["max_entry_num"].as<uint32_t>();
+
+      if (response_cache_node["shard_num"])
+        rhs.response_cache_options.shard_num = response_cache_node["shard_num"].as<uint32_t>();
+    }
+
+    if (node["metrics"]) {
+      const auto& metrics_node = node["metrics"];
+
+      if (metrics_node["shard_num"])
+        rhs.metrics_options.shard_num = metrics_node["shard_num"].as<uint32_t>();
+
+      if (metrics_node["report_interval_ms"])
+        rhs.metrics_options.report_interval_ms = metrics_node["report_interval_ms"].as<uint32_t>();
+
+      if (metrics_node["report_executor"])
+        rhs.metrics_options.report_executor = metrics_node["report_executor"].as<std::string>();
+    }
+
     return true;
   }
 };
@@ -93,6 +143,8 @@ namespace aimrt::runtime::core::rpc {
 void RpcManager::Initialize(YAML::Node options_node) {
   RegisterLocalRpcBackend();
   RegisterDebugLogFilter();
+  RegisterResponseCacheFilter();
+  RegisterMetricsFilter();
 
   AIMRT_CHECK_ERROR_THROW(
       std::atomic_exchange(&state_, State::kInit) == State::kPreInit,
@@ -104,10 +156,36 @@ void RpcManager::Initialize(YAML::Node options_node) {
   rpc_registry_ptr_ = std::make_unique<RpcRegistry>();
   rpc_registry_ptr_->SetLogger(logger_ptr_);
 
+  RpcResponseCache::Options response_cache_options{
+      .ttl = std::chrono::milliseconds(options_.response_cache_options.ttl_ms),
+      .max_entry_num = options_.response_cache_options.max_entry_num,
+      .shard_num = options_.response_cache_options.shard_num};
+  client_response_cache_ptr_ = std::make_shared<RpcResponseCache>(response_cache_options);
+  server_response_cache_ptr_ = std::make_shared<RpcResponseCache>(response_cache_options);
+
+  RpcMetrics::Options metrics_options{.shard_num = options_.metrics_options.shard_num};
+  client_metrics_ptr_ = std::make_shared<RpcMetrics>(metrics_options);
+  server_metrics_ptr_ = std::make_shared<RpcMetrics>(metrics_options);
+
+  if (options_.metrics_options.report_interval_ms > 0) {
+    AIMRT_CHECK_ERROR_THROW(
+        get_executor_func_,
+        "Get executor function is not set before initialize.");
+
+    metrics_report_executor_ = get_executor_func_(options_.metrics_options.report_executor);
+
+    AIMRT_CHECK_ERROR_THROW(
+        metrics_report_executor_ && metrics_report_executor_.SupportTimerSchedule(),
+        "Invalid metrics report executor '{}', executor must support timer schedule.",
+        options_.metrics_options.report_executor);
+  }
+
   rpc_backend_manager_.SetLogger(logger_ptr_);
   rpc_backend_manager_.SetRpcRegistry(rpc_registry_ptr_.get());
   rpc_backend_manager_.SetClientFrameworkAsyncRpcFilterManager(&client_filter_manager_);
   rpc_backend_manager_.SetServerFrameworkAsyncRpcFilterManager(&server_filter_manager_);
+  rpc_backend_manager_.SetClientFrameworkAsyncRpcStreamFilterManager(&client_stream_filter_manager_);
+  rpc_backend_manager_.SetServerFrameworkAsyncRpcStreamFilterManager(&server_stream_filter_manager_);
 
   std::vector<std::string> rpc_backend_name_vec;
 
@@ -151,6 +229,7 @@ void RpcManager::Initialize(YAML::Node options_node) {
 
   std::vector<std::pair<std::string, std::vector<std::string>>> server_backends_rules;
   std::vector<std::pair<std::string, std::vector<std::string>>> server_filters_rules;
+  std::vector<std::pair<std::string, RpcServiceDispatcher::Options>> server_dispatch_rules;
   for (const auto& item : options_.servers_options) {
     for (const auto& backend_name : item.enable_backends) {
       AIMRT_CHECK_ERROR_THROW(
@@ -159,11 +238,36 @@ void RpcManager::Initialize(YAML::Node options_node) {
           backend_name, item.func_name);
     }
 
+    RpcServiceDispatcher::Options dispatch_options{
+        .max_concurrency = item.max_concurrency,
+        .max_queue_size = item.max_queue_size};
+
+    AIMRT_CHECK_ERROR_THROW(
+        item.queue_policy == "queue" || item.queue_policy == "reject",
+        "Invalid queue policy '{}' for func '{}'",
+        item.queue_policy, item.func_name);
+    dispatch_options.queue_policy = RpcServiceDispatcher::ParseQueuePolicy(item.queue_policy);
+
+    if (!item.executor.empty()) {
+      AIMRT_CHECK_ERROR_THROW(
+          get_executor_func_,
+          "Get executor function is not set before initialize.");
+
+      dispatch_options.executor = get_executor_func_(item.executor);
+
+      AIMRT_CHECK_ERROR_THROW(
+          dispatch_options.executor,
+          "Invalid executor '{}' for func '{}'",
+          item.executor, item.func_name);
+    }
+
     server_backends_rules.emplace_back(item.func_name, item.enable_backends);
     server_filters_rules.emplace_back(item.func_name, item.enable_filters);
+    server_dispatch_rules.emplace_back(item.func_name, std::move(dispatch_options));
   }
   rpc_backend_manager_.SetServersBackendsRules(server_backends_rules);
   rpc_backend_manager_.SetServersFiltersRules(server_filters_rules);
+  rpc_backend_manager_.SetServersDispatchRules(server_dispatch_rules);
 
   // 初始化backend manager
   rpc_backend_manager_.Initialize();
@@ -180,6 +284,8 @@ void RpcManager::Start() {
 
   rpc_backend_manager_.Start();
 
+  if (metrics_report_executor_) ScheduleMetricsReport();
+
   AIMRT_INFO("Rpc manager start completed.");
 }
 
@@ -197,8 +303,17 @@ void RpcManager::Shutdown() {
 
   rpc_registry_ptr_.reset();
 
+  client_response_cache_ptr_.reset();
+  server_response_cache_ptr_.reset();
+
+  client_metrics_ptr_.reset();
+  server_metrics_ptr_.reset();
+  metrics_report_executor_ = aimrt::executor::ExecutorRef();
+
   server_filter_manager_.Clear();
   client_filter_manager_.Clear();
+  server_stream_filter_manager_.Clear();
+  client_stream_filter_manager_.Clear();
 
   get_executor_func_ = std::function<executor::ExecutorRef(std::string_view)>();
 }
@@ -347,6 +462,56 @@ void RpcManager::RegisterServerFilter(std::string_view name, FrameworkAsyncRpcFi
   server_filter_manager_.RegisterFilter(name, std::move(filter));
 }
 
+void RpcManager::RegisterClientStreamFilter(std::string_view name, FrameworkAsyncRpcStreamFilter&& filter) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kPreInit,
+      "Method can only be called when state is 'PreInit'.");
+  client_stream_filter_manager_.RegisterFilter(name, std::move(filter));
+}
+
+void RpcManager::RegisterServerStreamFilter(std::string_view name, FrameworkAsyncRpcStreamFilter&& filter) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kPreInit,
+      "Method can only be called when state is 'PreInit'.");
+  server_stream_filter_manager_.RegisterFilter(name, std::move(filter));
+}
+
+void RpcManager::InvalidateResponseCache(std::string_view func_name) {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kInit || state_.load() == State::kStart,
+      "Method can only be called when state is 'Init' or 'Start'.");
+  client_response_cache_ptr_->Invalidate(func_name);
+  server_response_cache_ptr_->Invalidate(func_name);
+}
+
+RpcResponseCache::Stat RpcManager::GetClientResponseCacheStat() const {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kInit || state_.load() == State::kStart,
+      "Method can only be called when state is 'Init' or 'Start'.");
+  return client_response_cache_ptr_->GetStat();
+}
+
+RpcResponseCache::Stat RpcManager::GetServerResponseCacheStat() const {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kInit || state_.load() == State::kStart,
+      "Method can only be called when state is 'Init' or 'Start'.");
+  return server_response_cache_ptr_->GetStat();
+}
+
+std::vector<RpcMethodMetrics::Snapshot> RpcManager::GetClientMetrics() const {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kInit || state_.load() == State::kStart,
+      "Method can only be called when state is 'Init' or 'Start'.");
+  return client_metrics_ptr_->GetSnapshot();
+}
+
+std::vector<RpcMethodMetrics::Snapshot> RpcManager::GetServerMetrics() const {
+  AIMRT_CHECK_ERROR_THROW(
+      state_.load() == State::kInit || state_.load() == State::kStart,
+      "Method can only be called when state is 'Init' or 'Start'.");
+  return server_metrics_ptr_->GetSnapshot();
+}
+
 void RpcManager::AddPassedContextMetaKeys(const std::unordered_set<std::string>& keys) {
   AIMRT_CHECK_ERROR_THROW(
       state_.load() == State::kPreInit,
@@ -382,10 +547,13 @@ void RpcManager::RegisterLocalRpcBackend() {
 }
 
 void RpcManager::RegisterDebugLogFilter() {
+  // 注册时取得json的序列化类型下标，每次调用不再查找驻留表
+  const uint32_t json_type_index = util::SerializationCache::TypeIndex("json");
+
   RegisterClientFilter(
       "debug_log",
-      [this](const std::shared_ptr<InvokeWrapper>& ptr, FrameworkAsyncRpcHandle&& h) {
-        auto buf_ptr = TrySerializeReqWithCache(*ptr, "json");
+      [this, json_type_index](const std::shared_ptr<InvokeWrapper>& ptr, FrameworkAsyncRpcHandle&& h) {
+        auto buf_ptr = TrySerializeReqWithCacheByIndex(*ptr, json_type_index);
 
         if (buf_ptr) {
           auto req_str = buf_ptr->JoinToString();
@@ -398,12 +566,12 @@ void RpcManager::RegisterDebugLogFilter() {
         }
 
         ptr->callback =
-            [this, ptr, callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
+            [this, ptr, json_type_index, callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
               if (!status.OK()) {
                 AIMRT_WARN("RPC client get rpc error ret. func name: {}, status: {}",
                            ptr->info.func_name, status.ToString());
               } else {
-                auto buf_ptr = TrySerializeRspWithCache(*ptr, "json");
+                auto buf_ptr = TrySerializeRspWithCacheByIndex(*ptr, json_type_index);
 
                 if (buf_ptr) {
                   auto rsp_str = buf_ptr->JoinToString();
@@ -424,8 +592,8 @@ void RpcManager::RegisterDebugLogFilter() {
 
   RegisterServerFilter(
       "debug_log",
-      [this](const std::shared_ptr<InvokeWrapper>& ptr, FrameworkAsyncRpcHandle&& h) {
-        auto buf_ptr = TrySerializeReqWithCache(*ptr, "json");
+      [this, json_type_index](const std::shared_ptr<InvokeWrapper>& ptr, FrameworkAsyncRpcHandle&& h) {
+        auto buf_ptr = TrySerializeReqWithCacheByIndex(*ptr, json_type_index);
 
         if (buf_ptr) {
           auto req_str = buf_ptr->JoinToString();
@@ -438,12 +606,12 @@ void RpcManager::RegisterDebugLogFilter() {
         }
 
         ptr->callback =
-            [this, ptr, callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
+            [this, ptr, json_type_index, callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
               if (!status.OK()) {
                 AIMRT_WARN("RPC server get rpc error ret. func name: {}, status: {}",
                            ptr->info.func_name, status.ToString());
               } else {
-                auto buf_ptr = TrySerializeRspWithCache(*ptr, "json");
+                auto buf_ptr = TrySerializeRspWithCacheByIndex(*ptr, json_type_index);
 
                 if (buf_ptr) {
                   auto rsp_str = buf_ptr->JoinToString();
@@ -461,6 +629,237 @@ void RpcManager::RegisterDebugLogFilter() {
 
         h(ptr);
       });
+
+  RegisterClientStreamFilter(
+      "debug_log",
+      [this](const std::shared_ptr<StreamInvokeWrapper>& ptr, FrameworkAsyncRpcStreamHandle&& h) {
+        AIMRT_INFO("RPC client open new stream. func name: {}, stream id: {}, context: {}",
+                   ptr->info.func_name, ptr->stream_ptr->Id(), ptr->ctx_ref.ToString());
+
+        ptr->callback =
+            [this, func_name = std::string_view(ptr->info.func_name), stream_id = ptr->stream_ptr->Id(),
+             callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
+              if (!status.OK()) {
+                AIMRT_WARN("RPC client stream end with error. func name: {}, stream id: {}, status: {}",
+                           func_name, stream_id, status.ToString());
+              } else {
+                AIMRT_INFO("RPC client stream end. func name: {}, stream id: {}, status: {}",
+                           func_name, stream_id, status.ToString());
+              }
+
+              if (callback) callback(status);
+            };
+
+        h(ptr);
+      });
+
+  RegisterServerStreamFilter(
+      "debug_log",
+      [this](const std::shared_ptr<StreamInvokeWrapper>& ptr, FrameworkAsyncRpcStreamHandle&& h) {
+        AIMRT_INFO("RPC server accept new stream. func name: {}, stream id: {}, context: {}",
+                   ptr->info.func_name, ptr->stream_ptr->Id(), ptr->ctx_ref.ToString());
+
+        ptr->callback =
+            [this, func_name = std::string_view(ptr->info.func_name), stream_id = ptr->stream_ptr->Id(),
+             callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
+              if (!status.OK()) {
+                AIMRT_WARN("RPC server stream end with error. func name: {}, stream id: {}, status: {}",
+                           func_name, stream_id, status.ToString());
+              } else {
+                AIMRT_INFO("RPC server stream end. func name: {}, stream id: {}, status: {}",
+                           func_name, stream_id, status.ToString());
+              }
+
+              if (callback) callback(status);
+            };
+
+        h(ptr);
+      });
+}
+
+void RpcManager::RegisterResponseCacheFilter() {
+  // 客户端与服务端的缓存逻辑相同，只是缓存实例与反序列化失败时的状态码不同
+  auto gen_filter = [this](bool is_client) -> FrameworkAsyncRpcFilter {
+    return [this, is_client](const std::shared_ptr<InvokeWrapper>& ptr, FrameworkAsyncRpcHandle&& h) {
+      auto cache_ptr = is_client ? client_response_cache_ptr_ : server_response_cache_ptr_;
+      const auto& info = ptr->info;
+
+      std::string serialization_type(ptr->ctx_ref.GetSerializationType());
+      if (serialization_type.empty())
+        serialization_type = info.req_type_support_ref.DefaultSerializationType();
+
+      // 请求与响应共用同一下标，只查找一次驻留表
+      const uint32_t serialization_type_index = util::SerializationCache::TypeIndex(serialization_type);
+
+      auto req_buf_ptr = TrySerializeReqWithCacheByIndex(*ptr, serialization_type_index);
+      if (omnirt_unlikely(!cache_ptr || !req_buf_ptr)) {
+        h(ptr);
+        return;
+      }
+
+      // 目标地址决定由哪个后端处理，不同地址的响应不能共用
+      auto key = RpcResponseCache::MakeKey(
+          info.func_name, serialization_type, ptr->ctx_ref.GetToAddr(), *req_buf_ptr);
+
+      // 将缓存的响应反序列化到本次调用的rsp中并结束调用
+      auto finish_from_cache =
+          [is_client](const std::shared_ptr<InvokeWrapper>& ptr, const RpcResponseCache::Value& value) {
+            aimrt::util::BufferArrayView buffer_array_view(value.rsp_data.data(), value.rsp_data.size());
+            bool deserialize_ret = util::DeserializeWithCodec(
+                ptr->info.rsp_type_support_ref, value.serialization_type, *(buffer_array_view.NativeHandle()), ptr->rsp_ptr);
+
+            if (omnirt_unlikely(!deserialize_ret)) {
+              ptr->callback(aimrt::rpc::Status(
+                  is_client ? AIMRT_RPC_STATUS_CLI_DESERIALIZATION_FAILED
+                            : AIMRT_RPC_STATUS_SVR_DESERIALIZATION_FAILED));
+              return;
+            }
+
+            ptr->callback(aimrt::rpc::Status());
+          };
+
+      RpcResponseCache::ValuePtr value;
+      auto lookup_ret = cache_ptr->Lookup(
+          key, value,
+          [ptr, finish_from_cache](aimrt::rpc::Status status, const RpcResponseCache::ValuePtr& value) {
+            if (value) {
+              finish_from_cache(ptr, *value);
+            } else {
+              ptr->callback(status);
+            }
+          });
+
+      if (lookup_ret == RpcResponseCache::LookupResult::kHit) {
+        AIMRT_TRACE("Rpc response cache hit, func name: {}", info.func_name);
+        finish_from_cache(ptr, *value);
+        return;
+      }
+
+      if (lookup_ret == RpcResponseCache::LookupResult::kMissWaiter) {
+        AIMRT_TRACE("Rpc response cache coalesce identical call, func name: {}", info.func_name);
+        return;
+      }
+
+      // 领头的调用完成时写入缓存并唤醒等待者，回调由wrapper自身持有，这里不再持有wrapper
+      ptr->callback =
+          [this, cache_ptr, key{std::move(key)}, wrapper_ptr = ptr.get(),
+           serialization_type{std::move(serialization_type)}, serialization_type_index,
+           callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
+            RpcResponseCache::ValuePtr value;
+            if (status.OK()) {
+              auto rsp_buf_ptr = TrySerializeRspWithCacheByIndex(*wrapper_ptr, serialization_type_index);
+              if (rsp_buf_ptr) {
+                value = std::make_shared<const RpcResponseCache::Value>(RpcResponseCache::Value{
+                    .serialization_type = serialization_type,
+                    .rsp_data = rsp_buf_ptr->JoinToString()});
+              } else {
+                AIMRT_WARN("Rpc response cache can not serialize rsp, func name: {}",
+                           wrapper_ptr->info.func_name);
+              }
+            }
+
+            // 先写入缓存并唤醒等待者，最后调用回调：回调可能释放wrapper及本闭包，之后不能再访问捕获的成员
+            cache_ptr->Complete(key, status, value);
+            callback(status);
+          };
+
+      h(ptr);
+    };
+  };
+
+  RegisterClientFilter("response_cache", gen_filter(true));
+  RegisterServerFilter("response_cache", gen_filter(false));
+}
+
+void RpcManager::RegisterMetricsFilter() {
+  auto gen_filter = [this](bool is_client) -> FrameworkAsyncRpcFilter {
+    return [this, is_client](const std::shared_ptr<InvokeWrapper>& ptr, FrameworkAsyncRpcHandle&& h) {
+      auto metrics_ptr = is_client ? client_metrics_ptr_ : server_metrics_ptr_;
+      if (omnirt_unlikely(!metrics_ptr)) {
+        h(ptr);
+        return;
+      }
+
+      auto& method_metrics = metrics_ptr->GetMethodMetrics(ptr->info.func_name);
+      auto begin_time = std::chrono::steady_clock::now();
+
+      method_metrics.OnStart();
+
+      // 服务端经过执行器/并发限制时，从排队到进入过滤器的耗时即排队耗时
+      if (ptr->dispatch_time != std::chrono::steady_clock::time_point())
+        method_metrics.OnQueue(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(begin_time - ptr->dispatch_time).count());
+
+      // 回调由wrapper自身持有，这里只持有弱引用，避免循环引用。
+      // 耗时在调用下游回调之前截止，不包括下游回调及用户完成回调的耗时；
+      // 后端在回调中序列化响应，所以序列化耗时在回调之后读取，回调期间持有wrapper，防止其在回调中被释放
+      ptr->callback =
+          [metrics_ptr, &method_metrics, begin_time, wrapper_wptr = std::weak_ptr<InvokeWrapper>(ptr),
+           callback{std::move(ptr->callback)}](aimrt::rpc::Status status) {
+            const auto end_time = std::chrono::steady_clock::now();
+            auto wrapper_ptr = wrapper_wptr.lock();
+
+            callback(status);
+
+            method_metrics.OnFinish(RpcMethodMetrics::Sample{
+                .status_code = status.Code(),
+                .latency_ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time).count()),
+                .serialization_ns = wrapper_ptr ? wrapper_ptr->serialization_ns.Load() : 0});
+          };
+
+      h(ptr);
+    };
+  };
+
+  RegisterClientFilter("metrics", gen_filter(true));
+  RegisterServerFilter("metrics", gen_filter(false));
+}
+
+void RpcManager::ScheduleMetricsReport() {
+  metrics_report_executor_.ExecuteAfter(
+      std::chrono::milliseconds(options_.metrics_options.report_interval_ms),
+      [this]() {
+        if (state_.load() != State::kStart) return;
+
+        ReportMetrics();
+        ScheduleMetricsReport();
+      });
+}
+
+void RpcManager::ReportMetrics() const {
+  auto gen_table = [](const std::vector<RpcMethodMetrics::Snapshot>& snapshot_vec) {
+    std::vector<std::vector<std::string>> table =
+        {{"func", "calls", "inflight", "errors", "timeouts",
+          "p50(us)", "p99(us)", "p999(us)", "max(us)", "queue p99(us)", "ser p99(us)"}};
+
+    auto to_us = [](uint64_t ns) { return std::to_string(ns / 1000); };
+
+    for (const auto& item : snapshot_vec) {
+      table.emplace_back(std::vector<std::string>{
+          item.func_name,
+          std::to_string(item.call_num),
+          std::to_string(item.inflight_num),
+          std::to_string(item.error_num),
+          std::to_string(item.timeout_num),
+          to_us(item.latency.Percentile(50)),
+          to_us(item.latency.Percentile(99)),
+          to_us(item.latency.Percentile(99.9)),
+          to_us(item.latency.max_ns),
+          to_us(item.queue.Percentile(99)),
+          to_us(item.serialization.Percentile(99))});
+    }
+
+    return aimrt::common::util::DrawTable(table);
+  };
+
+  auto client_snapshot_vec = client_metrics_ptr_->GetSnapshot();
+  if (!client_snapshot_vec.empty())
+    AIMRT_INFO("Rpc client metrics:\n{}", gen_table(client_snapshot_vec));
+
+  auto server_snapshot_vec = server_metrics_ptr_->GetSnapshot();
+  if (!server_snapshot_vec.empty())
+    AIMRT_INFO("Rpc server metrics:\n{}", gen_table(server_snapshot_vec));
 }
 
 }  // namespace aimrt::runtime::core::rpc
@@ -13,6 +13,8 @@
 #include "aimrt_module_cpp_interface/executor/executor.h"
 #include "core/rpc/rpc_backend_manager.h"
 #include "core/rpc/rpc_handle_proxy.h"
+#include "core/rpc/rpc_metrics.h"
+#include "core/rpc/rpc_response_cache.h"
 #include "core/util/module_detail_info.h"
 #include "util/log_util.h"
 
@@ -59,8 +61,32 @@ class RpcManager {
       std::string func_name;                    ///< 函数名称
       std::vector<std::string> enable_backends; ///< 启用的后端列表
       std::vector<std::string> enable_filters;  ///< 启用的过滤器列表
+      std::string executor;                     ///< 执行服务的执行器，为空时在后端投递的线程上执行
+      uint32_t max_concurrency = 0;             ///< 最大并发调用数，0表示不限制
+      std::string queue_policy = "queue";       ///< 达到最大并发后的策略：queue（排队）或reject（拒绝）
+      uint32_t max_queue_size = 1024;           ///< 排队的最大调用数，0表示不限制
     };
     std::vector<ServerOptions> servers_options;  ///< 所有服务端的配置列表
+
+    /**
+     * @brief 响应缓存配置选项，通过在enable_filters中启用response_cache过滤器对指定方法生效
+     */
+    struct ResponseCacheOptions {
+      uint32_t ttl_ms = 1000;        ///< 缓存条目有效期
+      uint32_t max_entry_num = 1024; ///< 最大缓存条目数
+      uint32_t shard_num = 16;       ///< 分片数
+    };
+    ResponseCacheOptions response_cache_options;  ///< 客户端与服务端响应缓存的配置
+
+    /**
+     * @brief 调用统计配置选项，通过在enable_filters中启用metrics过滤器对指定方法生效
+     */
+    struct MetricsOptions {
+      uint32_t shard_num = 4;           ///< 每个方法的记录分片数
+      uint32_t report_interval_ms = 0;  ///< 周期性打印统计日志的间隔，0表示不打印
+      std::string report_executor;      ///< 周期性打印使用的执行器，需支持定时调度
+    };
+    MetricsOptions metrics_options;  ///< 客户端与服务端调用统计的配置
   };
 
   /**
@@ -177,6 +203,47 @@ class RpcManager {
    */
   void RegisterServerFilter(std::string_view name, FrameworkAsyncRpcFilter&& filter);
 
+  /**
+   * @brief 注册客户端流式调用过滤器
+   * @details 流式调用与普通调用共用enable_filters配置，未注册流式版本的过滤器对流式调用不生效
+   * @param name 过滤器名称
+   * @param filter 过滤器函数对象
+   */
+  void RegisterClientStreamFilter(std::string_view name, FrameworkAsyncRpcStreamFilter&& filter);
+
+  /**
+   * @brief 注册服务端流式调用过滤器
+   * @param name 过滤器名称
+   * @param filter 过滤器函数对象
+   */
+  void RegisterServerStreamFilter(std::string_view name, FrameworkAsyncRpcStreamFilter&& filter);
+
+  /**
+   * @brief 使响应缓存失效
+   * @param func_name 方法名，为空时清空所有方法的缓存
+   */
+  void InvalidateResponseCache(std::string_view func_name = {});
+
+  /**
+   * @brief 获取客户端响应缓存的统计信息
+   */
+  RpcResponseCache::Stat GetClientResponseCacheStat() const;
+
+  /**
+   * @brief 获取服务端响应缓存的统计信息
+   */
+  RpcResponseCache::Stat GetServerResponseCacheStat() const;
+
+  /**
+   * @brief 获取客户端各方法的调用统计，只包含启用了metrics过滤器的方法
+   */
+  std::vector<RpcMethodMetrics::Snapshot> GetClientMetrics() const;
+
+  /**
+   * @brief 获取服务端各方法的调用统计，只包含启用了metrics过滤器的方法
+   */
+  std::vector<RpcMethodMetrics::Snapshot> GetServerMetrics() const;
+
   /**
    * @brief 添加传递的上下文元数据键
    * @param keys 键集合
@@ -206,6 +273,26 @@ class RpcManager {
    */
   void RegisterDebugLogFilter();
 
+  /**
+   * @brief 注册响应缓存过滤器
+   */
+  void RegisterResponseCacheFilter();
+
+  /**
+   * @brief 注册调用统计过滤器
+   */
+  void RegisterMetricsFilter();
+
+  /**
+   * @brief 投递下一次统计日志的打印任务
+   */
+  void ScheduleMetricsReport();
+
+  /**
+   * @brief 打印调用统计日志
+   */
+  void ReportMetrics() const;
+
  private:
   Options options_;                                    ///< 配置选项
   std::atomic<State> state_ = State::kPreInit;        ///< 当前状态
@@ -218,8 +305,18 @@ class RpcManager {
   FrameworkAsyncRpcFilterManager client_filter_manager_;  ///< 客户端过滤器管理器
   FrameworkAsyncRpcFilterManager server_filter_manager_;  ///< 服务端过滤器管理器
 
+  FrameworkAsyncRpcStreamFilterManager client_stream_filter_manager_;  ///< 客户端流式调用过滤器管理器
+  FrameworkAsyncRpcStreamFilterManager server_stream_filter_manager_;  ///< 服务端流式调用过滤器管理器
+
   std::unique_ptr<RpcRegistry> rpc_registry_ptr_;        ///< RPC注册表指针
 
+  std::shared_ptr<RpcResponseCache> client_response_cache_ptr_;  ///< 客户端响应缓存
+  std::shared_ptr<RpcResponseCache> server_response_cache_ptr_;  ///< 服务端响应缓存
+
+  std::shared_ptr<RpcMetrics> client_metrics_ptr_;  ///< 客户端调用统计
+  std::shared_ptr<RpcMetrics> server_metrics_ptr_;  ///< 服务端调用统计
+  aimrt::executor::ExecutorRef metrics_report_executor_;  ///< 周期性打印统计日志的执行器
+
   std::vector<std::unique_ptr<RpcBackendBase>> rpc_backend_vec_;      ///< RPC后端列表
   std::vector<RpcBackendBase*> used_rpc_backend_vec_;                 ///< 使用中的RPC后端列表
 
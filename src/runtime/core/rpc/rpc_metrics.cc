@@ -0,0 +1,162 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/rpc/rpc_metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#include "aimrt_module_cpp_interface/rpc/rpc_status.h"
+
+namespace aimrt::runtime::core::rpc {
+
+namespace {
+
+// 每个线程固定使用一个分片序号，按线程首次记录的顺序分配
+uint32_t GetThreadShardSeq() {
+  static std::atomic_uint32_t next_seq = 0;
+  thread_local const uint32_t seq = next_seq.fetch_add(1, std::memory_order_relaxed);
+  return seq;
+}
+
+}  // namespace
+
+uint64_t RpcLatencySnapshot::Percentile(double percentile) const {
+  if (count == 0) return 0;
+
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  auto target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+  if (target == 0) target = 1;
+
+  uint64_t cur = 0;
+  for (uint32_t ii = 0; ii < buckets.size(); ++ii) {
+    cur += buckets[ii];
+    if (cur >= target)
+      return std::min(RpcLatencyHistogram::BucketUpperBound(ii), max_ns);
+  }
+
+  return max_ns;
+}
+
+void RpcLatencyHistogram::MergeTo(RpcLatencySnapshot& snapshot) const {
+  if (snapshot.buckets.size() != kBucketNum) snapshot.buckets.resize(kBucketNum, 0);
+
+  for (uint32_t ii = 0; ii < kBucketNum; ++ii)
+    snapshot.buckets[ii] += buckets_[ii].load(std::memory_order_relaxed);
+
+  snapshot.count += count_.load(std::memory_order_relaxed);
+  snapshot.sum_ns += sum_ns_.load(std::memory_order_relaxed);
+  snapshot.max_ns = std::max(snapshot.max_ns, max_ns_.load(std::memory_order_relaxed));
+}
+
+RpcMethodMetrics::RpcMethodMetrics(std::string_view func_name, uint32_t shard_num)
+    : func_name_(func_name),
+      shard_num_(std::max<uint32_t>(shard_num, 1)),
+      shards_(std::make_unique<Shard[]>(shard_num_)) {}
+
+RpcMethodMetrics::Shard& RpcMethodMetrics::GetCurShard() {
+  return shards_[GetThreadShardSeq() % shard_num_];
+}
+
+void RpcMethodMetrics::RecordStatus(Shard& shard, uint32_t status_code) {
+  uint32_t pos = status_code % kStatusSlotNum;
+  for (uint32_t ii = 0; ii < kStatusSlotNum; ++ii, pos = (pos + 1) % kStatusSlotNum) {
+    uint32_t cur_code = shard.status_codes[pos].load(std::memory_order_relaxed);
+
+    if (cur_code == kEmptyStatus) {
+      if (shard.status_codes[pos].compare_exchange_strong(cur_code, status_code, std::memory_order_relaxed))
+        cur_code = status_code;
+    }
+
+    if (cur_code == status_code) {
+      shard.status_nums[pos].fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  shard.other_status_num.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RpcMethodMetrics::OnFinish(const Sample& sample) {
+  auto& shard = GetCurShard();
+
+  shard.finish_num.fetch_add(1, std::memory_order_relaxed);
+  shard.inflight_num.fetch_sub(1, std::memory_order_relaxed);
+
+  RecordStatus(shard, sample.status_code);
+
+  shard.latency.Record(sample.latency_ns);
+  shard.serialization.Record(sample.serialization_ns);
+}
+
+RpcMethodMetrics::Snapshot RpcMethodMetrics::GetSnapshot() const {
+  Snapshot snapshot{.func_name = func_name_};
+
+  for (uint32_t ii = 0; ii < shard_num_; ++ii) {
+    const auto& shard = shards_[ii];
+
+    snapshot.call_num += shard.call_num.load(std::memory_order_relaxed);
+    snapshot.finish_num += shard.finish_num.load(std::memory_order_relaxed);
+    snapshot.inflight_num += shard.inflight_num.load(std::memory_order_relaxed);
+
+    for (uint32_t jj = 0; jj < kStatusSlotNum; ++jj) {
+      uint32_t code = shard.status_codes[jj].load(std::memory_order_relaxed);
+      if (code == kEmptyStatus) continue;
+
+      uint64_t num = shard.status_nums[jj].load(std::memory_order_relaxed);
+      if (num == 0) continue;
+
+      snapshot.status_num[code] += num;
+      if (code != AIMRT_RPC_STATUS_OK) snapshot.error_num += num;
+      if (code == AIMRT_RPC_STATUS_TIMEOUT) snapshot.timeout_num += num;
+    }
+
+    uint64_t other_status_num = shard.other_status_num.load(std::memory_order_relaxed);
+    snapshot.other_status_num += other_status_num;
+    snapshot.error_num += other_status_num;
+
+    shard.latency.MergeTo(snapshot.latency);
+    shard.queue.MergeTo(snapshot.queue);
+    shard.serialization.MergeTo(snapshot.serialization);
+  }
+
+  // 各分片的计数读取时刻不同，调用跨线程完成时可能短暂为负
+  snapshot.inflight_num = std::max<int64_t>(snapshot.inflight_num, 0);
+
+  return snapshot;
+}
+
+RpcMethodMetrics& RpcMetrics::GetMethodMetrics(std::string_view func_name) {
+  {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    auto find_itr = method_metrics_map_.find(func_name);
+    if (find_itr != method_metrics_map_.end()) return *(find_itr->second);
+  }
+
+  std::unique_lock<std::shared_mutex> lck(mutex_);
+  auto find_itr = method_metrics_map_.find(func_name);
+  if (find_itr != method_metrics_map_.end()) return *(find_itr->second);
+
+  auto emplace_ret = method_metrics_map_.emplace(
+      std::string(func_name), std::make_unique<RpcMethodMetrics>(func_name, options_.shard_num));
+  return *(emplace_ret.first->second);
+}
+
+std::vector<RpcMethodMetrics::Snapshot> RpcMetrics::GetSnapshot() const {
+  std::vector<RpcMethodMetrics::Snapshot> result;
+
+  {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    result.reserve(method_metrics_map_.size());
+    for (const auto& itr : method_metrics_map_)
+      result.emplace_back(itr.second->GetSnapshot());
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const auto& lhs, const auto& rhs) { return lhs.func_name < rhs.func_name; });
+
+  return result;
+}
+
+}  // namespace aimrt::runtime::core::rpc
@@ -0,0 +1,206 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "util/flat_hash_map.h"
+
+namespace aimrt::runtime::core::rpc {
+
+/**
+ * @brief 延迟直方图的快照
+ */
+struct RpcLatencySnapshot {
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t max_ns = 0;
+  std::vector<uint64_t> buckets;
+
+  /**
+   * @brief 获取分位数，返回值为所在桶的上界
+   * @param percentile 取值范围[0, 100]
+   */
+  uint64_t Percentile(double percentile) const;
+
+  uint64_t Mean() const { return count ? sum_ns / count : 0; }
+};
+
+/**
+ * @brief 对数线性分桶的延迟直方图，思路与HdrHistogram相同
+ * @details 每个2的幂区间再等分为16个子桶，相对误差不超过1/16；大于2^40ns（约18分钟）的值记入最后一个桶
+ * 记录时只有relaxed的原子加，可以在多个线程上并发记录
+ */
+class RpcLatencyHistogram {
+ public:
+  static constexpr uint32_t kSubBucketBits = 4;
+  static constexpr uint32_t kSubBucketNum = 1u << kSubBucketBits;
+  static constexpr uint32_t kMaxExponent = 40;
+  static constexpr uint32_t kBucketNum = (kMaxExponent - kSubBucketBits + 1) * kSubBucketNum;
+
+  static constexpr uint32_t BucketIndex(uint64_t value) {
+    if (value >= (uint64_t(1) << kMaxExponent)) return kBucketNum - 1;
+    if (value < kSubBucketNum) return static_cast<uint32_t>(value);
+
+    uint32_t exponent = 63 - static_cast<uint32_t>(__builtin_clzll(value));
+    uint32_t shift = exponent - kSubBucketBits;
+    return (shift + 1) * kSubBucketNum + static_cast<uint32_t>((value >> shift) & (kSubBucketNum - 1));
+  }
+
+  static constexpr uint64_t BucketUpperBound(uint32_t index) {
+    if (index < kSubBucketNum) return index;
+
+    uint32_t shift = index / kSubBucketNum - 1;
+    uint64_t lower = (uint64_t(kSubBucketNum) + index % kSubBucketNum) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+  }
+
+  void Record(uint64_t value_ns) {
+    buckets_[BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+
+    uint64_t cur_max = max_ns_.load(std::memory_order_relaxed);
+    while (value_ns > cur_max &&
+           !max_ns_.compare_exchange_weak(cur_max, value_ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief 将本直方图累加到快照中
+   */
+  void MergeTo(RpcLatencySnapshot& snapshot) const;
+
+ private:
+  std::array<std::atomic_uint64_t, kBucketNum> buckets_{};
+  std::atomic_uint64_t count_ = 0;
+  std::atomic_uint64_t sum_ns_ = 0;
+  std::atomic_uint64_t max_ns_ = 0;
+};
+
+/**
+ * @brief 单个rpc方法的统计
+ * @details 按线程分片记录，同一线程总是写同一个分片，避免多个线程争用同一条缓存行；查询时合并所有分片
+ */
+class RpcMethodMetrics {
+ public:
+  /**
+   * @brief 一次调用完成时的采样
+   */
+  struct Sample {
+    uint32_t status_code;
+    uint64_t latency_ns;        ///< 从进入过滤器到调用下游回调之前的耗时，服务端即处理耗时
+    uint64_t serialization_ns;  ///< 本次调用中序列化请求与响应的耗时
+  };
+
+  struct Snapshot {
+    std::string func_name;
+    uint64_t call_num = 0;      ///< 发起的调用数
+    uint64_t finish_num = 0;    ///< 完成的调用数
+    int64_t inflight_num = 0;   ///< 正在进行的调用数
+    uint64_t timeout_num = 0;   ///< 超时的调用数
+    uint64_t error_num = 0;     ///< 状态码非OK的调用数
+
+    std::map<uint32_t, uint64_t> status_num;  ///< 按状态码统计的完成调用数
+    uint64_t other_status_num = 0;            ///< 状态码种类过多、未能单独统计的调用数
+
+    RpcLatencySnapshot latency;
+    RpcLatencySnapshot queue;          ///< 服务端在执行器/并发限制上排队的耗时
+    RpcLatencySnapshot serialization;
+  };
+
+ public:
+  RpcMethodMetrics(std::string_view func_name, uint32_t shard_num);
+  ~RpcMethodMetrics() = default;
+
+  RpcMethodMetrics(const RpcMethodMetrics&) = delete;
+  RpcMethodMetrics& operator=(const RpcMethodMetrics&) = delete;
+
+  void OnStart() {
+    auto& shard = GetCurShard();
+    shard.call_num.fetch_add(1, std::memory_order_relaxed);
+    shard.inflight_num.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void OnQueue(uint64_t queue_ns) { GetCurShard().queue.Record(queue_ns); }
+
+  void OnFinish(const Sample& sample);
+
+  Snapshot GetSnapshot() const;
+
+  const std::string& FuncName() const { return func_name_; }
+
+ private:
+  static constexpr uint32_t kStatusSlotNum = 32;
+  static constexpr uint32_t kEmptyStatus = UINT32_MAX;
+
+  struct alignas(64) Shard {
+    std::atomic_uint64_t call_num = 0;
+    std::atomic_uint64_t finish_num = 0;
+    std::atomic_int64_t inflight_num = 0;
+
+    // 开放寻址的状态码计数表，槽位一经占用不再释放
+    std::array<std::atomic_uint32_t, kStatusSlotNum> status_codes;
+    std::array<std::atomic_uint64_t, kStatusSlotNum> status_nums{};
+    std::atomic_uint64_t other_status_num = 0;
+
+    RpcLatencyHistogram latency;
+    RpcLatencyHistogram queue;
+    RpcLatencyHistogram serialization;
+
+    Shard() {
+      for (auto& item : status_codes) item.store(kEmptyStatus, std::memory_order_relaxed);
+    }
+  };
+
+  Shard& GetCurShard();
+
+  static void RecordStatus(Shard& shard, uint32_t status_code);
+
+ private:
+  const std::string func_name_;
+  const uint32_t shard_num_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+/**
+ * @brief 一组rpc方法的统计，客户端与服务端各持有一份
+ */
+class RpcMetrics {
+ public:
+  struct Options {
+    uint32_t shard_num = 4;
+  };
+
+ public:
+  explicit RpcMetrics(const Options& options) : options_(options) {}
+  ~RpcMetrics() = default;
+
+  RpcMetrics(const RpcMetrics&) = delete;
+  RpcMetrics& operator=(const RpcMetrics&) = delete;
+
+  /**
+   * @brief 获取方法的统计对象，不存在时创建，返回的引用在本对象析构前一直有效
+   */
+  RpcMethodMetrics& GetMethodMetrics(std::string_view func_name);
+
+  /**
+   * @brief 获取所有方法的统计快照，按方法名排序
+   */
+  std::vector<RpcMethodMetrics::Snapshot> GetSnapshot() const;
+
+ private:
+  const Options options_;
+
+  mutable std::shared_mutex mutex_;
+  aimrt::common::util::FlatHashMap<std::string, std::unique_ptr<RpcMethodMetrics>> method_metrics_map_;
+};
+
+}  // namespace aimrt::runtime::core::rpc
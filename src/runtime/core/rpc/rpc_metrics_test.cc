@@ -0,0 +1,119 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "aimrt_module_cpp_interface/rpc/rpc_status.h"
+#include "core/rpc/rpc_metrics.h"
+
+namespace aimrt::runtime::core::rpc {
+
+TEST(RPC_METRICS_TEST, histogram_bucket) {
+  using H = RpcLatencyHistogram;
+
+  for (uint64_t value : {0ul, 1ul, 15ul, 16ul, 17ul, 1000ul, 123456ul, 987654321ul, (1ul << 39) + 5}) {
+    auto index = H::BucketIndex(value);
+    EXPECT_LT(index, H::kBucketNum);
+    EXPECT_GE(H::BucketUpperBound(index), value);
+
+    // 相对误差不超过1/16
+    EXPECT_LE(H::BucketUpperBound(index) - value, value / H::kSubBucketNum);
+
+    if (index > 0) EXPECT_LT(H::BucketUpperBound(index - 1), value);
+  }
+
+  EXPECT_EQ(H::BucketIndex(UINT64_MAX), H::kBucketNum - 1);
+}
+
+TEST(RPC_METRICS_TEST, percentile) {
+  RpcLatencyHistogram histogram;
+  for (uint64_t ii = 1; ii <= 1000; ++ii) histogram.Record(ii * 1000);
+
+  RpcLatencySnapshot snapshot;
+  histogram.MergeTo(snapshot);
+
+  EXPECT_EQ(snapshot.count, 1000);
+  EXPECT_EQ(snapshot.max_ns, 1000000);
+  EXPECT_EQ(snapshot.Mean(), 500500);
+
+  auto p50 = snapshot.Percentile(50);
+  EXPECT_GE(p50, 500000);
+  EXPECT_LE(p50, 500000 + 500000 / 16);
+
+  auto p99 = snapshot.Percentile(99);
+  EXPECT_GE(p99, 990000);
+  EXPECT_LE(p99, 1000000);
+
+  EXPECT_EQ(snapshot.Percentile(100), 1000000);
+  EXPECT_EQ(RpcLatencySnapshot().Percentile(99), 0);
+}
+
+TEST(RPC_METRICS_TEST, method_metrics) {
+  RpcMetrics metrics(RpcMetrics::Options{.shard_num = 2});
+
+  auto& method_metrics = metrics.GetMethodMetrics("GetFoo");
+  EXPECT_EQ(&method_metrics, &metrics.GetMethodMetrics("GetFoo"));
+
+  for (int ii = 0; ii < 3; ++ii) method_metrics.OnStart();
+  method_metrics.OnQueue(2000);
+
+  method_metrics.OnFinish({.status_code = AIMRT_RPC_STATUS_OK, .latency_ns = 1000, .serialization_ns = 100});
+  method_metrics.OnFinish({.status_code = AIMRT_RPC_STATUS_TIMEOUT, .latency_ns = 50000, .serialization_ns = 100});
+
+  auto snapshot_vec = metrics.GetSnapshot();
+  ASSERT_EQ(snapshot_vec.size(), 1);
+
+  const auto& snapshot = snapshot_vec[0];
+  EXPECT_EQ(snapshot.func_name, "GetFoo");
+  EXPECT_EQ(snapshot.call_num, 3);
+  EXPECT_EQ(snapshot.finish_num, 2);
+  EXPECT_EQ(snapshot.inflight_num, 1);
+  EXPECT_EQ(snapshot.timeout_num, 1);
+  EXPECT_EQ(snapshot.error_num, 1);
+  EXPECT_EQ(snapshot.status_num.at(AIMRT_RPC_STATUS_OK), 1);
+  EXPECT_EQ(snapshot.status_num.at(AIMRT_RPC_STATUS_TIMEOUT), 1);
+  EXPECT_EQ(snapshot.latency.count, 2);
+  EXPECT_EQ(snapshot.latency.max_ns, 50000);
+  EXPECT_EQ(snapshot.queue.count, 1);
+  EXPECT_EQ(snapshot.serialization.sum_ns, 200);
+}
+
+TEST(RPC_METRICS_TEST, multi_thread) {
+  RpcMetrics metrics(RpcMetrics::Options{.shard_num = 4});
+
+  constexpr uint32_t kThreadNum = 8;
+  constexpr uint32_t kCallNum = 10000;
+
+  std::vector<std::thread> threads;
+  for (uint32_t ii = 0; ii < kThreadNum; ++ii) {
+    threads.emplace_back([&metrics, ii]() {
+      auto& method_metrics = metrics.GetMethodMetrics(ii % 2 ? "A" : "B");
+      for (uint32_t jj = 0; jj < kCallNum; ++jj) {
+        method_metrics.OnStart();
+        method_metrics.OnFinish({.status_code = jj % 100, .latency_ns = jj, .serialization_ns = 0});
+      }
+    });
+  }
+
+  for (auto& t : threads) t.join();
+
+  auto snapshot_vec = metrics.GetSnapshot();
+  ASSERT_EQ(snapshot_vec.size(), 2);
+  EXPECT_EQ(snapshot_vec[0].func_name, "A");
+
+  for (const auto& snapshot : snapshot_vec) {
+    EXPECT_EQ(snapshot.call_num, kThreadNum / 2 * kCallNum);
+    EXPECT_EQ(snapshot.inflight_num, 0);
+    EXPECT_EQ(snapshot.latency.count, kThreadNum / 2 * kCallNum);
+
+    // 超出状态码槽位数的部分计入other_status_num
+    uint64_t status_total = snapshot.other_status_num;
+    for (const auto& itr : snapshot.status_num) status_total += itr.second;
+    EXPECT_EQ(status_total, kThreadNum / 2 * kCallNum);
+    EXPECT_GT(snapshot.other_status_num, 0);
+  }
+}
+
+}  // namespace aimrt::runtime::core::rpc
@@ -79,4 +79,107 @@ const ClientFuncWrapper* RpcRegistry::GetClientFuncWrapperPtr(
   return nullptr;
 }
 
+bool RpcRegistry::RegisterStreamServiceFunc(
+    std::unique_ptr<StreamServiceFuncWrapper>&& stream_service_func_wrapper_ptr) {
+  Key key{
+      .func_name = stream_service_func_wrapper_ptr->info.func_name,
+      .pkg_path = stream_service_func_wrapper_ptr->info.pkg_path,
+      .module_name = stream_service_func_wrapper_ptr->info.module_name};
+
+  auto emplace_ret = stream_service_func_wrapper_map_.emplace(
+      key, std::move(stream_service_func_wrapper_ptr));
+
+  if (!emplace_ret.second) {
+    AIMRT_ERROR(
+        "Stream service func '{}' is registered repeatedly, module '{}', pkg path '{}'",
+        key.func_name, key.module_name, key.pkg_path);
+    return false;
+  }
+
+  AIMRT_TRACE(
+      "Stream service func '{}' is successfully registered, module '{}', pkg path '{}'",
+      key.func_name, key.module_name, key.pkg_path);
+
+  return true;
+}
+
+bool RpcRegistry::RegisterStreamClientFunc(
+    std::unique_ptr<StreamClientFuncWrapper>&& stream_client_func_wrapper_ptr) {
+  Key key{
+      .func_name = stream_client_func_wrapper_ptr->info.func_name,
+      .pkg_path = stream_client_func_wrapper_ptr->info.pkg_path,
+      .module_name = stream_client_func_wrapper_ptr->info.module_name};
+
+  auto emplace_ret = stream_client_func_wrapper_map_.emplace(
+      key, std::move(stream_client_func_wrapper_ptr));
+
+  if (!emplace_ret.second) {
+    AIMRT_ERROR(
+        "Stream client func '{}' is registered repeatedly, module '{}', pkg path '{}'",
+        key.func_name, key.module_name, key.pkg_path);
+    return false;
+  }
+
+  AIMRT_TRACE(
+      "Stream client func '{}' is successfully registered, module '{}', pkg path '{}'",
+      key.func_name, key.module_name, key.pkg_path);
+
+  return true;
+}
+
+const StreamServiceFuncWrapper* RpcRegistry::GetStreamServiceFuncWrapperPtr(
+    std::string_view func_name, std::string_view pkg_path, std::string_view module_name) const {
+  auto find_itr = stream_service_func_wrapper_map_.find(
+      Key{.func_name = func_name, .pkg_path = pkg_path, .module_name = module_name});
+
+  if (find_itr != stream_service_func_wrapper_map_.end())
+    return find_itr->second.get();
+
+  return nullptr;
+}
+
+const StreamClientFuncWrapper* RpcRegistry::GetStreamClientFuncWrapperPtr(
+    std::string_view func_name, std::string_view pkg_path, std::string_view module_name) const {
+  auto find_itr = stream_client_func_wrapper_map_.find(
+      Key{.func_name = func_name, .pkg_path = pkg_path, .module_name = module_name});
+
+  if (find_itr != stream_client_func_wrapper_map_.end())
+    return find_itr->second.get();
+
+  return nullptr;
+}
+
+void RpcRegistry::AddActiveStream(const std::shared_ptr<RpcStream>& stream_ptr) {
+  std::lock_guard<std::mutex> lck(active_stream_mutex_);
+  active_stream_map_.emplace(stream_ptr->Id(), stream_ptr);
+}
+
+void RpcRegistry::RemoveActiveStream(uint64_t stream_id) {
+  std::lock_guard<std::mutex> lck(active_stream_mutex_);
+  active_stream_map_.erase(stream_id);
+}
+
+size_t RpcRegistry::GetActiveStreamNum() const {
+  std::lock_guard<std::mutex> lck(active_stream_mutex_);
+  return active_stream_map_.size();
+}
+
+void RpcRegistry::CancelAllActiveStreams(aimrt::rpc::Status status) {
+  std::vector<std::shared_ptr<RpcStream>> stream_vec;
+  {
+    std::lock_guard<std::mutex> lck(active_stream_mutex_);
+    stream_vec.reserve(active_stream_map_.size());
+    for (auto& itr : active_stream_map_) {
+      if (auto stream_ptr = itr.second.lock()) stream_vec.emplace_back(std::move(stream_ptr));
+    }
+    active_stream_map_.clear();
+  }
+
+  // 在锁外取消，流的结束回调中会再次调用RemoveActiveStream
+  for (auto& stream_ptr : stream_vec) {
+    AIMRT_TRACE("Cancel active stream {}.", stream_ptr->Id());
+    stream_ptr->Cancel(status);
+  }
+}
+
 }  // namespace aimrt::runtime::core::rpc
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "core/rpc/rpc_invoke_wrapper.h"
@@ -22,6 +23,19 @@ struct ClientFuncWrapper {
   FuncInfo info;
 };
 
+using StreamServiceFunc = std::function<void(const std::shared_ptr<StreamInvokeWrapper>&)>;
+
+struct StreamServiceFuncWrapper {
+  FuncInfo info;
+  RpcStreamMode mode;
+  StreamServiceFunc service_func;
+};
+
+struct StreamClientFuncWrapper {
+  FuncInfo info;
+  RpcStreamMode mode;
+};
+
 class RpcRegistry {
  public:
   RpcRegistry()
@@ -46,12 +60,33 @@ class RpcRegistry {
   const ClientFuncWrapper* GetClientFuncWrapperPtr(
       std::string_view func_name, std::string_view pkg_path, std::string_view module_name) const;
 
+  bool RegisterStreamServiceFunc(
+      std::unique_ptr<StreamServiceFuncWrapper>&& stream_service_func_wrapper_ptr);
+
+  bool RegisterStreamClientFunc(
+      std::unique_ptr<StreamClientFuncWrapper>&& stream_client_func_wrapper_ptr);
+
+  const StreamServiceFuncWrapper* GetStreamServiceFuncWrapperPtr(
+      std::string_view func_name, std::string_view pkg_path, std::string_view module_name) const;
+
+  const StreamClientFuncWrapper* GetStreamClientFuncWrapperPtr(
+      std::string_view func_name, std::string_view pkg_path, std::string_view module_name) const;
+
+  // 活跃流管理，流在建立时加入、结束时移除，可在运行期任意线程调用
+  void AddActiveStream(const std::shared_ptr<RpcStream>& stream_ptr);
+  void RemoveActiveStream(uint64_t stream_id);
+  size_t GetActiveStreamNum() const;
+  void CancelAllActiveStreams(aimrt::rpc::Status status);
+
   const auto& GetServiceFuncWrapperMap() const { return service_func_wrapper_map_; }
   const auto& GetClientFuncWrapperMap() const { return client_func_wrapper_map_; }
 
   const auto& GetServiceIndexMap() const { return service_index_map_; }
   const auto& GetClientIndexMap() const { return client_index_map_; }
 
+  const auto& GetStreamServiceFuncWrapperMap() const { return stream_service_func_wrapper_map_; }
+  const auto& GetStreamClientFuncWrapperMap() const { return stream_client_func_wrapper_map_; }
+
  private:
   std::shared_ptr<aimrt::common::util::LoggerWrapper> logger_ptr_;
 
@@ -88,5 +123,15 @@ class RpcRegistry {
   // 索引表，func_name:wrapper
   std::unordered_map<std::string_view, std::vector<ClientFuncWrapper*>>
       client_index_map_;
+
+  std::unordered_map<Key, std::unique_ptr<StreamServiceFuncWrapper>, Key::Hash>
+      stream_service_func_wrapper_map_;
+
+  std::unordered_map<Key, std::unique_ptr<StreamClientFuncWrapper>, Key::Hash>
+      stream_client_func_wrapper_map_;
+
+  // 活跃流，stream id:stream
+  mutable std::mutex active_stream_mutex_;
+  std::unordered_map<uint64_t, std::weak_ptr<RpcStream>> active_stream_map_;
 };
 }  // namespace aimrt::runtime::core::rpc
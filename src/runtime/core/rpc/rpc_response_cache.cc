@@ -0,0 +1,161 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/rpc/rpc_response_cache.h"
+
+namespace aimrt::runtime::core::rpc {
+
+RpcResponseCache::RpcResponseCache(const Options& options)
+    : options_(options),
+      shard_capacity_(
+          std::max<size_t>(
+              1, (options.max_entry_num + std::max<uint32_t>(options.shard_num, 1) - 1) /
+                     std::max<uint32_t>(options.shard_num, 1))),
+      shards_(std::max<uint32_t>(options.shard_num, 1)) {}
+
+RpcResponseCache::Key RpcResponseCache::MakeKey(
+    std::string_view func_name, std::string_view serialization_type, std::string_view to_addr,
+    std::string_view req_data) {
+  aimrt::util::BufferArrayView buffer_array_view(req_data.data(), req_data.size());
+  return MakeKey(func_name, serialization_type, to_addr, buffer_array_view);
+}
+
+RpcResponseCache::Key RpcResponseCache::MakeKey(
+    std::string_view func_name, std::string_view serialization_type, std::string_view to_addr,
+    const aimrt::util::BufferArrayView& req_data) {
+  Key key;
+  key.data.reserve(func_name.size() + serialization_type.size() + to_addr.size() + req_data.BufferSize() + 3);
+  key.data.append(func_name).push_back('\0');
+  key.data.append(serialization_type).push_back('\0');
+  key.data.append(to_addr).push_back('\0');
+
+  const aimrt_buffer_view_t* data = req_data.Data();
+  for (size_t ii = 0; ii < req_data.Size(); ++ii) {
+    key.data.append(static_cast<const char*>(data[ii].data), data[ii].len);
+  }
+
+  key.hash = std::hash<std::string_view>()(key.data);
+  return key;
+}
+
+RpcResponseCache::LookupResult RpcResponseCache::Lookup(
+    const Key& key, ValuePtr& value, Waiter&& waiter) {
+  auto& shard = GetShard(key);
+
+  std::lock_guard<std::mutex> lck(shard.mutex);
+
+  auto find_itr = shard.entry_map.find(ToKeyRef(key));
+  if (find_itr != shard.entry_map.end()) {
+    auto list_itr = find_itr->second;
+    if (Clock::now() < list_itr->second.expire_time) {
+      shard.lru_list.splice(shard.lru_list.begin(), shard.lru_list, list_itr);
+      value = list_itr->second.value;
+      ++hit_num_;
+      return LookupResult::kHit;
+    }
+
+    EraseEntry(shard, list_itr);
+  }
+
+  ++miss_num_;
+
+  auto pending_itr = shard.pending_map.find(key);
+  if (pending_itr != shard.pending_map.end()) {
+    pending_itr->second.waiters.emplace_back(std::move(waiter));
+    ++coalesced_num_;
+    return LookupResult::kMissWaiter;
+  }
+
+  shard.pending_map.emplace(key, Pending{.waiters = {}, .generation = shard.generation});
+  return LookupResult::kMissLeader;
+}
+
+void RpcResponseCache::Complete(const Key& key, aimrt::rpc::Status status, const ValuePtr& value) {
+  auto& shard = GetShard(key);
+
+  std::vector<Waiter> waiters;
+  {
+    std::lock_guard<std::mutex> lck(shard.mutex);
+
+    // 调用期间缓存被失效过，响应可能是失效前的旧数据，只通知等待者，不写入缓存
+    bool up_to_date = false;
+
+    auto pending_itr = shard.pending_map.find(key);
+    if (pending_itr != shard.pending_map.end()) {
+      waiters = std::move(pending_itr->second.waiters);
+      up_to_date = (pending_itr->second.generation == shard.generation);
+      shard.pending_map.erase(pending_itr);
+    }
+
+    if (up_to_date && status.OK() && value) {
+      auto find_itr = shard.entry_map.find(ToKeyRef(key));
+      if (find_itr != shard.entry_map.end()) EraseEntry(shard, find_itr->second);
+
+      shard.lru_list.emplace_front(key, Entry{.value = value, .expire_time = Clock::now() + options_.ttl});
+      shard.entry_map.emplace(ToKeyRef(shard.lru_list.front().first), shard.lru_list.begin());
+
+      while (shard.lru_list.size() > shard_capacity_) {
+        EraseEntry(shard, std::prev(shard.lru_list.end()));
+        ++evicted_num_;
+      }
+    }
+  }
+
+  // 在锁外通知，等待者的回调中可能再次访问缓存
+  for (auto& waiter : waiters) {
+    if (waiter) waiter(status, value);
+  }
+}
+
+void RpcResponseCache::Invalidate(std::string_view func_name) {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lck(shard.mutex);
+
+    if (func_name.empty()) {
+      shard.entry_map.clear();
+      shard.lru_list.clear();
+      ++shard.generation;
+      continue;
+    }
+
+    // 该方法有正在进行的调用时递增代数，分片内其它方法正在进行的调用也只是少缓存一次
+    for (const auto& pending_itr : shard.pending_map) {
+      if (MatchFuncName(pending_itr.first.data, func_name)) {
+        ++shard.generation;
+        break;
+      }
+    }
+
+    for (auto itr = shard.lru_list.begin(); itr != shard.lru_list.end();) {
+      auto cur_itr = itr++;
+      if (MatchFuncName(cur_itr->first.data, func_name)) EraseEntry(shard, cur_itr);
+    }
+  }
+}
+
+RpcResponseCache::Stat RpcResponseCache::GetStat() const {
+  size_t entry_num = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lck(shard.mutex);
+    entry_num += shard.lru_list.size();
+  }
+
+  return Stat{
+      .hit_num = hit_num_.load(),
+      .miss_num = miss_num_.load(),
+      .coalesced_num = coalesced_num_.load(),
+      .evicted_num = evicted_num_.load(),
+      .entry_num = entry_num};
+}
+
+bool RpcResponseCache::MatchFuncName(std::string_view key, std::string_view func_name) {
+  return key.size() > func_name.size() && key[func_name.size()] == '\0' &&
+         key.substr(0, func_name.size()) == func_name;
+}
+
+void RpcResponseCache::EraseEntry(Shard& shard, LruList::iterator itr) {
+  shard.entry_map.erase(ToKeyRef(itr->first));
+  shard.lru_list.erase(itr);
+}
+
+}  // namespace aimrt::runtime::core::rpc
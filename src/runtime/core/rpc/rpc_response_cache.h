@@ -0,0 +1,173 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "aimrt_module_cpp_interface/rpc/rpc_status.h"
+#include "aimrt_module_cpp_interface/util/buffer.h"
+
+namespace aimrt::runtime::core::rpc {
+
+/**
+ * @brief 幂等rpc的响应缓存
+ *
+ * 以 方法名+序列化类型+目标地址+序列化后的请求 为键，缓存序列化后的响应：
+ * 1. 条目超过ttl后失效，条目数超过上限时按LRU淘汰
+ * 2. 相同键的调用正在进行时，后续调用不再发起，等待第一个调用完成后共享其结果
+ * 3. 按键的哈希分片，每个分片独立加锁，不同分片上的查找互不影响；哈希在生成键时只计算一次，分片选择与分片内查找共用
+ * 4. 失效时递增分片的代数，失效前发起、失效后才完成的调用不写入缓存，避免旧响应在失效后继续被使用
+ */
+class RpcResponseCache {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    std::chrono::milliseconds ttl = std::chrono::milliseconds(1000);
+    size_t max_entry_num = 1024;
+    uint32_t shard_num = 16;
+  };
+
+  struct Value {
+    std::string serialization_type;
+    std::string rsp_data;
+  };
+  using ValuePtr = std::shared_ptr<const Value>;
+
+  struct Key {
+    std::string data;
+    size_t hash = 0;
+  };
+
+  // 等待中的调用，value为空表示领头的调用失败
+  using Waiter = std::function<void(aimrt::rpc::Status, const ValuePtr&)>;
+
+  enum class LookupResult : uint32_t {
+    kHit,         ///< 命中，value有效
+    kMissLeader,  ///< 未命中，调用方需发起调用并在完成后调用Complete
+    kMissWaiter,  ///< 未命中，相同的调用正在进行，waiter会在其完成时被调用
+  };
+
+  struct Stat {
+    uint64_t hit_num;
+    uint64_t miss_num;
+    uint64_t coalesced_num;
+    uint64_t evicted_num;
+    size_t entry_num;
+  };
+
+ public:
+  explicit RpcResponseCache(const Options& options);
+  ~RpcResponseCache() = default;
+
+  RpcResponseCache(const RpcResponseCache&) = delete;
+  RpcResponseCache& operator=(const RpcResponseCache&) = delete;
+
+  /**
+   * @brief 生成缓存键
+   * @param to_addr 调用指定的目标地址，不同地址可能由不同后端处理，响应不能共用
+   */
+  static Key MakeKey(
+      std::string_view func_name, std::string_view serialization_type, std::string_view to_addr,
+      std::string_view req_data);
+
+  /**
+   * @brief 生成缓存键，序列化后的请求直接逐段写入键，不另外拼接
+   */
+  static Key MakeKey(
+      std::string_view func_name, std::string_view serialization_type, std::string_view to_addr,
+      const aimrt::util::BufferArrayView& req_data);
+
+  LookupResult Lookup(const Key& key, ValuePtr& value, Waiter&& waiter);
+
+  /**
+   * @brief 领头的调用完成
+   * @details status为OK、value非空且调用期间缓存未失效时写入缓存，然后以相同结果通知所有等待中的调用
+   */
+  void Complete(const Key& key, aimrt::rpc::Status status, const ValuePtr& value);
+
+  /**
+   * @brief 使缓存失效，func_name为空时清空所有方法的缓存
+   */
+  void Invalidate(std::string_view func_name = {});
+
+  Stat GetStat() const;
+
+  const Options& GetOptions() const { return options_; }
+
+ private:
+  struct Entry {
+    ValuePtr value;
+    Clock::time_point expire_time;
+  };
+
+  struct Pending {
+    std::vector<Waiter> waiters;
+    uint64_t generation;  ///< 领头调用发起时分片的代数
+  };
+
+  // 指向lru_list中的键，直接使用生成键时算好的哈希
+  struct KeyRef {
+    std::string_view data;
+    size_t hash;
+
+    bool operator==(const KeyRef& other) const { return hash == other.hash && data == other.data; }
+  };
+
+  struct KeyHash {
+    size_t operator()(const KeyRef& key) const { return key.hash; }
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  struct KeyEqual {
+    bool operator()(const Key& lhs, const Key& rhs) const { return lhs.hash == rhs.hash && lhs.data == rhs.data; }
+  };
+
+  using LruList = std::list<std::pair<Key, Entry>>;
+
+  struct Shard {
+    mutable std::mutex mutex;
+
+    // 表头为最近使用的条目
+    LruList lru_list;
+    std::unordered_map<KeyRef, LruList::iterator, KeyHash> entry_map;
+
+    std::unordered_map<Key, Pending, KeyHash, KeyEqual> pending_map;
+
+    uint64_t generation = 0;
+  };
+
+  static KeyRef ToKeyRef(const Key& key) { return KeyRef{key.data, key.hash}; }
+
+  // 分片内的哈希表按哈希的低位分桶，分片取高位，避免同一分片内的键集中在少数桶中
+  Shard& GetShard(const Key& key) {
+    return shards_[(key.hash >> (sizeof(size_t) * 4)) % shards_.size()];
+  }
+
+  static bool MatchFuncName(std::string_view key, std::string_view func_name);
+
+  void EraseEntry(Shard& shard, LruList::iterator itr);
+
+ private:
+  const Options options_;
+  const size_t shard_capacity_;
+
+  std::vector<Shard> shards_;
+
+  std::atomic_uint64_t hit_num_ = 0;
+  std::atomic_uint64_t miss_num_ = 0;
+  std::atomic_uint64_t coalesced_num_ = 0;
+  std::atomic_uint64_t evicted_num_ = 0;
+};
+
+}  // namespace aimrt::runtime::core::rpc
@@ -0,0 +1,191 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "core/rpc/rpc_response_cache.h"
+
+namespace aimrt::runtime::core::rpc {
+
+namespace {
+
+RpcResponseCache::ValuePtr MakeValue(std::string_view rsp_data) {
+  return std::make_shared<const RpcResponseCache::Value>(
+      RpcResponseCache::Value{.serialization_type = "pb", .rsp_data = std::string(rsp_data)});
+}
+
+}  // namespace
+
+TEST(RPC_RESPONSE_CACHE_TEST, hit_and_miss) {
+  RpcResponseCache cache(RpcResponseCache::Options{});
+
+  auto key = RpcResponseCache::MakeKey("GetMap", "pb", "", "tile-1");
+
+  RpcResponseCache::ValuePtr value;
+  EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+  cache.Complete(key, aimrt::rpc::Status(), MakeValue("rsp-1"));
+
+  EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kHit);
+  EXPECT_EQ(value->rsp_data, "rsp-1");
+
+  // 请求不同则不命中
+  auto other_key = RpcResponseCache::MakeKey("GetMap", "pb", "", "tile-2");
+  EXPECT_EQ(cache.Lookup(other_key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+
+  // 失败的调用不缓存
+  cache.Complete(other_key, aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT), nullptr);
+  EXPECT_EQ(cache.Lookup(other_key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+  cache.Complete(other_key, aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT), nullptr);
+
+  // 目标地址不同则不命中
+  auto addr_key = RpcResponseCache::MakeKey("GetMap", "pb", "http://127.0.0.1:50080", "tile-1");
+  EXPECT_EQ(cache.Lookup(addr_key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+  cache.Complete(addr_key, aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT), nullptr);
+
+  // 分段的请求与拼接后的请求生成相同的键
+  std::vector<aimrt_buffer_view_t> slices{{.data = "tile", .len = 4}, {.data = "-1", .len = 2}};
+  auto slice_key = RpcResponseCache::MakeKey("GetMap", "pb", "", aimrt::util::BufferArrayView(slices));
+  EXPECT_EQ(slice_key.data, key.data);
+  EXPECT_EQ(slice_key.hash, key.hash);
+  EXPECT_EQ(cache.Lookup(slice_key, value, nullptr), RpcResponseCache::LookupResult::kHit);
+
+  auto stat = cache.GetStat();
+  EXPECT_EQ(stat.hit_num, 2);
+  EXPECT_EQ(stat.miss_num, 4);
+  EXPECT_EQ(stat.entry_num, 1);
+}
+
+TEST(RPC_RESPONSE_CACHE_TEST, ttl) {
+  RpcResponseCache cache(RpcResponseCache::Options{.ttl = std::chrono::milliseconds(20)});
+
+  auto key = RpcResponseCache::MakeKey("GetCalib", "pb", "", "cam0");
+
+  RpcResponseCache::ValuePtr value;
+  EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+  cache.Complete(key, aimrt::rpc::Status(), MakeValue("calib"));
+  EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kHit);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+  EXPECT_EQ(cache.GetStat().entry_num, 0);
+}
+
+TEST(RPC_RESPONSE_CACHE_TEST, lru_eviction) {
+  RpcResponseCache cache(RpcResponseCache::Options{.max_entry_num = 2, .shard_num = 1});
+
+  RpcResponseCache::ValuePtr value;
+  for (const char* req : {"a", "b"}) {
+    auto key = RpcResponseCache::MakeKey("Get", "pb", "", req);
+    cache.Lookup(key, value, nullptr);
+    cache.Complete(key, aimrt::rpc::Status(), MakeValue(req));
+  }
+
+  // 访问a，使b成为最久未使用的条目
+  EXPECT_EQ(cache.Lookup(RpcResponseCache::MakeKey("Get", "pb", "", "a"), value, nullptr),
+            RpcResponseCache::LookupResult::kHit);
+
+  auto key_c = RpcResponseCache::MakeKey("Get", "pb", "", "c");
+  cache.Lookup(key_c, value, nullptr);
+  cache.Complete(key_c, aimrt::rpc::Status(), MakeValue("c"));
+
+  EXPECT_EQ(cache.Lookup(RpcResponseCache::MakeKey("Get", "pb", "", "a"), value, nullptr),
+            RpcResponseCache::LookupResult::kHit);
+  EXPECT_EQ(cache.Lookup(key_c, value, nullptr), RpcResponseCache::LookupResult::kHit);
+  EXPECT_EQ(cache.Lookup(RpcResponseCache::MakeKey("Get", "pb", "", "b"), value, nullptr),
+            RpcResponseCache::LookupResult::kMissLeader);
+  EXPECT_EQ(cache.GetStat().evicted_num, 1);
+}
+
+TEST(RPC_RESPONSE_CACHE_TEST, invalidate) {
+  RpcResponseCache cache(RpcResponseCache::Options{});
+
+  RpcResponseCache::ValuePtr value;
+  auto key_1 = RpcResponseCache::MakeKey("GetConfig", "pb", "", "x");
+  auto key_2 = RpcResponseCache::MakeKey("GetConfigV2", "pb", "", "x");
+  for (const auto& key : {key_1, key_2}) {
+    cache.Lookup(key, value, nullptr);
+    cache.Complete(key, aimrt::rpc::Status(), MakeValue("cfg"));
+  }
+
+  // 只清除完全匹配方法名的条目
+  cache.Invalidate("GetConfig");
+  EXPECT_EQ(cache.GetStat().entry_num, 1);
+  EXPECT_EQ(cache.Lookup(key_2, value, nullptr), RpcResponseCache::LookupResult::kHit);
+
+  cache.Invalidate();
+  EXPECT_EQ(cache.GetStat().entry_num, 0);
+}
+
+TEST(RPC_RESPONSE_CACHE_TEST, invalidate_during_flight) {
+  RpcResponseCache cache(RpcResponseCache::Options{.shard_num = 1});
+
+  RpcResponseCache::ValuePtr value;
+  auto key = RpcResponseCache::MakeKey("GetConfig", "pb", "", "x");
+
+  for (std::string_view func_name : {"GetConfig", ""}) {
+    EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+
+    // 调用进行中缓存被失效，完成时的旧响应仍通知等待者，但不写入缓存
+    bool notified = false;
+    cache.Lookup(key, value, [&notified](aimrt::rpc::Status, const RpcResponseCache::ValuePtr& value) {
+      notified = (value->rsp_data == "old");
+    });
+    cache.Invalidate(func_name);
+    cache.Complete(key, aimrt::rpc::Status(), MakeValue("old"));
+
+    EXPECT_TRUE(notified);
+    EXPECT_EQ(cache.GetStat().entry_num, 0);
+    EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+
+    // 失效后发起的调用正常写入缓存
+    cache.Complete(key, aimrt::rpc::Status(), MakeValue("new"));
+    EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kHit);
+    EXPECT_EQ(value->rsp_data, "new");
+
+    cache.Invalidate();
+  }
+}
+
+TEST(RPC_RESPONSE_CACHE_TEST, coalescing) {
+  RpcResponseCache cache(RpcResponseCache::Options{});
+
+  auto key = RpcResponseCache::MakeKey("GetTile", "pb", "", "z1");
+
+  RpcResponseCache::ValuePtr value;
+  EXPECT_EQ(cache.Lookup(key, value, nullptr), RpcResponseCache::LookupResult::kMissLeader);
+
+  uint32_t waiter_num = 0;
+  for (int ii = 0; ii < 3; ++ii) {
+    auto ret = cache.Lookup(
+        key, value,
+        [&waiter_num](aimrt::rpc::Status status, const RpcResponseCache::ValuePtr& value) {
+          EXPECT_TRUE(status.OK());
+          EXPECT_EQ(value->rsp_data, "tile");
+          ++waiter_num;
+        });
+    EXPECT_EQ(ret, RpcResponseCache::LookupResult::kMissWaiter);
+  }
+  EXPECT_EQ(waiter_num, 0);
+
+  cache.Complete(key, aimrt::rpc::Status(), MakeValue("tile"));
+  EXPECT_EQ(waiter_num, 3);
+  EXPECT_EQ(cache.GetStat().coalesced_num, 3);
+
+  // 领头调用失败时等待者收到相同的错误
+  auto fail_key = RpcResponseCache::MakeKey("GetTile", "pb", "", "z2");
+  cache.Lookup(fail_key, value, nullptr);
+
+  uint32_t fail_code = 0;
+  cache.Lookup(
+      fail_key, value,
+      [&fail_code](aimrt::rpc::Status status, const RpcResponseCache::ValuePtr& value) {
+        EXPECT_FALSE(value);
+        fail_code = status.Code();
+      });
+  cache.Complete(fail_key, aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT), nullptr);
+  EXPECT_EQ(fail_code, AIMRT_RPC_STATUS_TIMEOUT);
+}
+
+}  // namespace aimrt::runtime::core::rpc
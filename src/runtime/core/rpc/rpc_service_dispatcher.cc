@@ -0,0 +1,134 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/rpc/rpc_service_dispatcher.h"
+#include "util/deferred.h"
+#include "util/exception.h"
+
+namespace aimrt::runtime::core::rpc {
+
+bool RpcServiceDispatcher::Dispatch(Task&& task) {
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+
+    if (options_.max_concurrency != 0 && running_num_ >= options_.max_concurrency) {
+      if (options_.queue_policy == QueuePolicy::kReject ||
+          (options_.max_queue_size != 0 && queue_.size() >= options_.max_queue_size)) {
+        ++rejected_num_;
+        return false;
+      }
+
+      queue_.emplace_back(std::move(task));
+      return true;
+    }
+
+    ++running_num_;
+  }
+
+  Run(std::move(task));
+  return true;
+}
+
+namespace {
+
+// 当前线程上正在排空的分发器及其待执行的调用
+struct DrainFrame {
+  const RpcServiceDispatcher* dispatcher;
+  std::deque<RpcServiceDispatcher::Task> tasks;
+  DrainFrame* prev;
+};
+
+thread_local DrainFrame* cur_drain_frame = nullptr;
+
+}  // namespace
+
+void RpcServiceDispatcher::Release() {
+  Task next_task;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (queue_.empty()) {
+      --running_num_;
+      return;
+    }
+
+    // 并发额度直接转交给下一个等待中的调用
+    next_task = std::move(queue_.front());
+    queue_.pop_front();
+  }
+
+  if (!RunInline()) {
+    Post(std::move(next_task));
+    return;
+  }
+
+  // 同步完成的调用会在执行过程中再次Release，此时只记下下一个调用，由最外层的循环执行，
+  // 避免每个排队的调用都加深一层调用栈
+  if (cur_drain_frame != nullptr && cur_drain_frame->dispatcher == this) {
+    cur_drain_frame->tasks.emplace_back(std::move(next_task));
+    return;
+  }
+
+  DrainFrame frame{.dispatcher = this, .prev = cur_drain_frame};
+  frame.tasks.emplace_back(std::move(next_task));
+
+  cur_drain_frame = &frame;
+  aimrt::common::util::Deferred restore_frame([&frame]() { cur_drain_frame = frame.prev; });
+
+  while (!frame.tasks.empty()) {
+    Task task = std::move(frame.tasks.front());
+    frame.tasks.pop_front();
+    task();
+  }
+}
+
+bool RpcServiceDispatcher::RunInline() const {
+  const auto& executor = options_.executor;
+  return !executor || executor.IsInCurrentExecutor();
+}
+
+void RpcServiceDispatcher::Run(Task&& task) {
+  if (RunInline()) {
+    task();
+    return;
+  }
+
+  Post(std::move(task));
+}
+
+void RpcServiceDispatcher::Post(Task&& task) {
+  options_.executor.Execute([task{std::move(task)}]() { task(); });
+}
+
+uint32_t RpcServiceDispatcher::RunningNum() const {
+  std::lock_guard<std::mutex> lck(mutex_);
+  return running_num_;
+}
+
+size_t RpcServiceDispatcher::QueuedNum() const {
+  std::lock_guard<std::mutex> lck(mutex_);
+  return queue_.size();
+}
+
+uint64_t RpcServiceDispatcher::RejectedNum() const {
+  std::lock_guard<std::mutex> lck(mutex_);
+  return rejected_num_;
+}
+
+RpcServiceDispatcher::QueuePolicy RpcServiceDispatcher::ParseQueuePolicy(std::string_view str) {
+  if (str == "queue") return QueuePolicy::kQueue;
+  if (str == "reject") return QueuePolicy::kReject;
+
+  throw aimrt::common::util::AimRTException("Invalid queue policy '" + std::string(str) + "'.");
+}
+
+std::string_view RpcServiceDispatcher::QueuePolicyToString(QueuePolicy policy) {
+  switch (policy) {
+    case QueuePolicy::kQueue:
+      return "queue";
+    case QueuePolicy::kReject:
+      return "reject";
+  }
+  return "unknown";
+}
+
+}  // namespace aimrt::runtime::core::rpc
@@ -0,0 +1,93 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "aimrt_module_cpp_interface/executor/executor.h"
+#include "aimrt_module_cpp_interface/rpc/rpc_status.h"
+
+namespace aimrt::runtime::core::rpc {
+
+/**
+ * @brief 服务端调用分发器，为一个服务方法绑定执行器并限制并发数
+ *
+ * 每次调用通过Dispatch提交，调用完成后（回调被调用或流结束时）必须调用一次Release。
+ * 正在执行的调用数达到max_concurrency后：
+ * - kQueue策略下调用进入等待队列，队列长度超过max_queue_size时拒绝
+ * - kReject策略下直接拒绝
+ *
+ * 未绑定执行器时调用在投递线程上执行；绑定了执行器且当前线程已在该执行器上时（例如同一
+ * 执行器上的客户端调用同一执行器上的服务），同样直接执行，不再额外投递一次，调用完成后
+ * 客户端回调也就在该执行器上被调用。直接执行时，Release转交出的排队调用在最外层的Release中
+ * 依次执行，同步完成的调用不会随队列长度加深调用栈。
+ *
+ * 被拒绝的调用以kRejectedStatus结束。rpc状态码中没有单独的过载/繁忙状态，过载映射为
+ * SVR_BACKEND_INTERNAL_ERROR，调用方无法仅凭状态码区分过载与后端内部错误；拒绝次数见RejectedNum，
+ * 服务端同时输出告警日志。
+ */
+class RpcServiceDispatcher {
+ public:
+  using Task = std::function<void()>;
+
+  enum class QueuePolicy : uint32_t {
+    kQueue,
+    kReject,
+  };
+
+  static constexpr uint32_t kRejectedStatus = AIMRT_RPC_STATUS_SVR_BACKEND_INTERNAL_ERROR;
+
+  struct Options {
+    aimrt::executor::ExecutorRef executor;
+    uint32_t max_concurrency = 0;  ///< 0表示不限制
+    QueuePolicy queue_policy = QueuePolicy::kQueue;
+    uint32_t max_queue_size = 1024;  ///< 0表示不限制
+  };
+
+ public:
+  explicit RpcServiceDispatcher(const Options& options)
+      : options_(options) {}
+  ~RpcServiceDispatcher() = default;
+
+  RpcServiceDispatcher(const RpcServiceDispatcher&) = delete;
+  RpcServiceDispatcher& operator=(const RpcServiceDispatcher&) = delete;
+
+  /**
+   * @brief 提交一次调用
+   * @return 被拒绝时返回false，此时task不会被执行，也不需要调用Release
+   */
+  bool Dispatch(Task&& task);
+
+  /**
+   * @brief 一次已开始执行的调用完成，释放并发额度并执行下一个等待中的调用
+   */
+  void Release();
+
+  const Options& GetOptions() const { return options_; }
+
+  uint32_t RunningNum() const;
+  size_t QueuedNum() const;
+  uint64_t RejectedNum() const;
+
+  static QueuePolicy ParseQueuePolicy(std::string_view str);
+  static std::string_view QueuePolicyToString(QueuePolicy policy);
+
+ private:
+  bool RunInline() const;
+  void Run(Task&& task);
+  void Post(Task&& task);
+
+ private:
+  Options options_;
+
+  mutable std::mutex mutex_;
+  uint32_t running_num_ = 0;
+  uint64_t rejected_num_ = 0;
+  std::deque<Task> queue_;
+};
+
+}  // namespace aimrt::runtime::core::rpc
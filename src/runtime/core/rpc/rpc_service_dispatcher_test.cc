@@ -0,0 +1,191 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "core/executor/asio_thread_executor.h"
+#include "core/executor/executor_proxy.h"
+#include "core/rpc/rpc_service_dispatcher.h"
+#include "util/exception.h"
+
+namespace aimrt::runtime::core::rpc {
+
+TEST(RPC_SERVICE_DISPATCHER_TEST, max_concurrency_queue) {
+  RpcServiceDispatcher dispatcher(RpcServiceDispatcher::Options{
+      .max_concurrency = 2,
+      .queue_policy = RpcServiceDispatcher::QueuePolicy::kQueue,
+      .max_queue_size = 1});
+
+  uint32_t run_count = 0;
+  auto task = [&run_count]() { ++run_count; };
+
+  // 未绑定执行器时在当前线程直接执行
+  EXPECT_TRUE(dispatcher.Dispatch(task));
+  EXPECT_TRUE(dispatcher.Dispatch(task));
+  EXPECT_EQ(run_count, 2);
+  EXPECT_EQ(dispatcher.RunningNum(), 2);
+
+  EXPECT_TRUE(dispatcher.Dispatch(task));
+  EXPECT_EQ(run_count, 2);
+  EXPECT_EQ(dispatcher.QueuedNum(), 1);
+
+  EXPECT_FALSE(dispatcher.Dispatch(task));
+  EXPECT_EQ(dispatcher.RejectedNum(), 1);
+
+  // 完成一个调用后额度转交给排队的调用
+  dispatcher.Release();
+  EXPECT_EQ(run_count, 3);
+  EXPECT_EQ(dispatcher.QueuedNum(), 0);
+  EXPECT_EQ(dispatcher.RunningNum(), 2);
+
+  dispatcher.Release();
+  dispatcher.Release();
+  EXPECT_EQ(dispatcher.RunningNum(), 0);
+}
+
+TEST(RPC_SERVICE_DISPATCHER_TEST, max_concurrency_reject) {
+  RpcServiceDispatcher dispatcher(RpcServiceDispatcher::Options{
+      .max_concurrency = 1,
+      .queue_policy = RpcServiceDispatcher::QueuePolicy::kReject});
+
+  EXPECT_TRUE(dispatcher.Dispatch([]() {}));
+  EXPECT_FALSE(dispatcher.Dispatch([]() {}));
+  EXPECT_EQ(dispatcher.QueuedNum(), 0);
+
+  dispatcher.Release();
+  EXPECT_TRUE(dispatcher.Dispatch([]() {}));
+  dispatcher.Release();
+
+  EXPECT_EQ(RpcServiceDispatcher::ParseQueuePolicy("reject"), RpcServiceDispatcher::QueuePolicy::kReject);
+  EXPECT_THROW(RpcServiceDispatcher::ParseQueuePolicy("drop"), aimrt::common::util::AimRTException);
+}
+
+TEST(RPC_SERVICE_DISPATCHER_TEST, sync_release_no_recursion) {
+  RpcServiceDispatcher dispatcher(RpcServiceDispatcher::Options{
+      .max_concurrency = 1,
+      .max_queue_size = 0});
+
+  // 先占住唯一的并发额度，其余调用全部排队
+  EXPECT_TRUE(dispatcher.Dispatch([]() {}));
+
+  // 每个排队的调用都同步完成，在执行过程中Release
+  constexpr uint32_t kQueuedNum = 100000;
+  uint32_t depth = 0;
+  uint32_t max_depth = 0;
+  uint32_t run_count = 0;
+  for (uint32_t ii = 0; ii < kQueuedNum; ++ii) {
+    EXPECT_TRUE(dispatcher.Dispatch([&]() {
+      max_depth = std::max(max_depth, ++depth);
+      ++run_count;
+      dispatcher.Release();
+      --depth;
+    }));
+  }
+  EXPECT_EQ(dispatcher.QueuedNum(), kQueuedNum);
+
+  dispatcher.Release();
+
+  EXPECT_EQ(run_count, kQueuedNum);
+  EXPECT_EQ(max_depth, 1);
+  EXPECT_EQ(dispatcher.QueuedNum(), 0);
+  EXPECT_EQ(dispatcher.RunningNum(), 0);
+}
+
+TEST(RPC_SERVICE_DISPATCHER_TEST, slow_fast_isolation) {
+  YAML::Node options_node = YAML::Load(R"str(
+thread_num: 1
+)str");
+
+  executor::AsioThreadExecutor slow_executor, fast_executor;
+  slow_executor.Initialize("slow_executor", options_node);
+  fast_executor.Initialize("fast_executor", options_node);
+  slow_executor.Start();
+  fast_executor.Start();
+
+  executor::ExecutorProxy slow_executor_proxy(&slow_executor);
+  executor::ExecutorProxy fast_executor_proxy(&fast_executor);
+
+  RpcServiceDispatcher slow_dispatcher(RpcServiceDispatcher::Options{
+      .executor = aimrt::executor::ExecutorRef(slow_executor_proxy.NativeHandle()),
+      .max_concurrency = 1});
+  RpcServiceDispatcher fast_dispatcher(RpcServiceDispatcher::Options{
+      .executor = aimrt::executor::ExecutorRef(fast_executor_proxy.NativeHandle())});
+
+  // 慢服务占满自己的执行器和并发额度
+  std::atomic_bool slow_release = false;
+  std::atomic_uint32_t slow_done = 0;
+  for (int ii = 0; ii < 4; ++ii) {
+    EXPECT_TRUE(slow_dispatcher.Dispatch([&]() {
+      while (!slow_release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      ++slow_done;
+      slow_dispatcher.Release();
+    }));
+  }
+
+  // 快服务不受影响
+  constexpr uint32_t kFastNum = 100;
+  std::atomic_uint32_t fast_done = 0;
+  for (uint32_t ii = 0; ii < kFastNum; ++ii) {
+    EXPECT_TRUE(fast_dispatcher.Dispatch([&]() {
+      ++fast_done;
+      fast_dispatcher.Release();
+    }));
+  }
+
+  for (int ii = 0; ii < 1000 && fast_done.load() < kFastNum; ++ii)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  EXPECT_EQ(fast_done.load(), kFastNum);
+  EXPECT_EQ(slow_done.load(), 0);
+  EXPECT_EQ(slow_dispatcher.QueuedNum(), 3);
+
+  slow_release = true;
+  for (int ii = 0; ii < 1000 && slow_done.load() < 4; ++ii)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  EXPECT_EQ(slow_done.load(), 4);
+  EXPECT_EQ(slow_dispatcher.RunningNum(), 0);
+
+  slow_executor.Shutdown();
+  fast_executor.Shutdown();
+}
+
+TEST(RPC_SERVICE_DISPATCHER_TEST, inline_in_current_executor) {
+  YAML::Node options_node = YAML::Load(R"str(
+thread_num: 1
+)str");
+
+  executor::AsioThreadExecutor shared_executor;
+  shared_executor.Initialize("shared_executor", options_node);
+  shared_executor.Start();
+
+  executor::ExecutorProxy shared_executor_proxy(&shared_executor);
+  aimrt::executor::ExecutorRef executor_ref(shared_executor_proxy.NativeHandle());
+
+  RpcServiceDispatcher dispatcher(RpcServiceDispatcher::Options{.executor = executor_ref});
+
+  // 调用方已在服务绑定的执行器上时直接执行，不再投递
+  std::atomic_bool ran_inline = false;
+  std::atomic_bool finished = false;
+  executor_ref.Execute([&]() {
+    bool in_call = true;
+    dispatcher.Dispatch([&]() { ran_inline = in_call; });
+    in_call = false;
+    dispatcher.Release();
+    finished = true;
+  });
+
+  for (int ii = 0; ii < 1000 && !finished.load(); ++ii)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  EXPECT_TRUE(ran_inline.load());
+
+  shared_executor.Shutdown();
+}
+
+}  // namespace aimrt::runtime::core::rpc
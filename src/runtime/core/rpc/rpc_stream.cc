@@ -0,0 +1,266 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/rpc/rpc_stream.h"
+
+namespace aimrt::runtime::core::rpc {
+
+RpcStream::RpcStream(uint64_t id, const Options& options)
+    : id_(id), options_(options), established_(!options.wait_establish) {
+  // 服务端流模式下客户端只发送首个请求，客户端写方向从一开始就是关闭的
+  if (options_.mode == RpcStreamMode::kServerStream)
+    directions_[Index(RpcStreamSide::kClient)].half_closed = true;
+}
+
+void RpcStream::SetTransform(RpcStreamSide writer, MsgTransform&& transform) {
+  std::lock_guard<std::mutex> lck(mutex_);
+  directions_[Index(writer)].transform =
+      transform ? std::make_shared<const MsgTransform>(std::move(transform)) : nullptr;
+}
+
+void RpcStream::Establish() {
+  std::shared_ptr<const NotifyHandle> notify[2];
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (established_) return;
+    established_ = true;
+
+    for (size_t ii = 0; ii < 2; ++ii) {
+      auto& direction = directions_[ii];
+      if (direction.writer_blocked && direction.queue.size() < options_.window_size) {
+        direction.writer_blocked = false;
+        notify[ii] = direction.writable_handle;
+      }
+    }
+  }
+  Notify(notify[0]);
+  Notify(notify[1]);
+}
+
+void RpcStream::SetReadableHandle(RpcStreamSide reader, NotifyHandle&& handle) {
+  std::shared_ptr<const NotifyHandle> notify;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    auto& direction = directions_[Index(Peer(reader))];
+    direction.readable_handle = std::make_shared<const NotifyHandle>(std::move(handle));
+
+    if (!direction.queue.empty() || direction.half_closed || state_ != State::kOpen)
+      notify = direction.readable_handle;
+  }
+  Notify(notify);
+}
+
+void RpcStream::SetWritableHandle(RpcStreamSide writer, NotifyHandle&& handle) {
+  std::lock_guard<std::mutex> lck(mutex_);
+  directions_[Index(writer)].writable_handle = std::make_shared<const NotifyHandle>(std::move(handle));
+}
+
+void RpcStream::AddDoneHandle(RpcStreamSide side, DoneHandle&& handle) {
+  uint32_t code = 0;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (state_ == State::kOpen) {
+      done_handles_[Index(side)].emplace_back(std::move(handle));
+      return;
+    }
+    code = status_code_;
+  }
+  handle(aimrt::rpc::Status(code));
+}
+
+bool RpcStream::WriteAllowed(RpcStreamSide writer) const {
+  switch (options_.mode) {
+    case RpcStreamMode::kServerStream:
+      return writer == RpcStreamSide::kServer;
+    case RpcStreamMode::kClientStream:
+      // 客户端流模式下服务端只能返回一个响应
+      return writer == RpcStreamSide::kClient ||
+             directions_[Index(RpcStreamSide::kServer)].written == 0;
+    default:
+      return true;
+  }
+}
+
+RpcStreamResult RpcStream::CheckWritable(RpcStreamSide writer) {
+  if (state_ != State::kOpen || !WriteAllowed(writer))
+    return RpcStreamResult::kClosed;
+
+  auto& direction = directions_[Index(writer)];
+  if (direction.half_closed)
+    return RpcStreamResult::kEnd;
+
+  if (!established_ || direction.queue.size() >= options_.window_size) {
+    direction.writer_blocked = true;
+    return RpcStreamResult::kWouldBlock;
+  }
+
+  return RpcStreamResult::kOk;
+}
+
+RpcStreamResult RpcStream::Write(RpcStreamSide writer, MsgPtr msg) {
+  auto& direction = directions_[Index(writer)];
+
+  std::shared_ptr<const MsgTransform> transform;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    auto ret = CheckWritable(writer);
+    if (ret != RpcStreamResult::kOk) return ret;
+    transform = direction.transform;
+  }
+
+  // 转换可能涉及序列化，在锁内取得转换函数，在锁外调用
+  if (transform) {
+    MsgPtr converted;
+    if (!(*transform)(msg, converted)) {
+      Cancel(aimrt::rpc::Status(writer == RpcStreamSide::kClient
+                                    ? AIMRT_RPC_STATUS_CLI_SERIALIZATION_FAILED
+                                    : AIMRT_RPC_STATUS_SVR_SERIALIZATION_FAILED));
+      return RpcStreamResult::kClosed;
+    }
+    msg = std::move(converted);
+  }
+
+  std::shared_ptr<const NotifyHandle> notify;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    auto ret = CheckWritable(writer);
+    if (ret != RpcStreamResult::kOk) return ret;
+
+    if (direction.queue.empty()) notify = direction.readable_handle;
+
+    direction.queue.emplace_back(std::move(msg));
+    ++direction.written;
+  }
+  Notify(notify);
+
+  return RpcStreamResult::kOk;
+}
+
+RpcStreamResult RpcStream::Read(RpcStreamSide reader, MsgPtr& msg) {
+  auto& direction = directions_[Index(Peer(reader))];
+
+  std::shared_ptr<const NotifyHandle> notify;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (state_ == State::kCancelled ||
+        (state_ == State::kFinished && reader == RpcStreamSide::kServer))
+      return RpcStreamResult::kClosed;
+
+    if (direction.queue.empty())
+      return direction.half_closed ? RpcStreamResult::kEnd : RpcStreamResult::kWouldBlock;
+
+    msg = std::move(direction.queue.front());
+    direction.queue.pop_front();
+
+    if (direction.writer_blocked && direction.queue.size() < options_.window_size) {
+      direction.writer_blocked = false;
+      notify = direction.writable_handle;
+    }
+  }
+  Notify(notify);
+
+  return RpcStreamResult::kOk;
+}
+
+bool RpcStream::CloseSend(RpcStreamSide writer) {
+  auto& direction = directions_[Index(writer)];
+
+  std::shared_ptr<const NotifyHandle> notify;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (state_ != State::kOpen || direction.half_closed) return false;
+
+    direction.half_closed = true;
+
+    // 缓存非空时读端会在读完后读到kEnd，无需额外通知
+    if (direction.queue.empty()) notify = direction.readable_handle;
+  }
+  Notify(notify);
+
+  return true;
+}
+
+bool RpcStream::Finish(aimrt::rpc::Status status) {
+  std::vector<DoneHandle> client_done, server_done;
+  std::shared_ptr<const NotifyHandle> notify;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (state_ != State::kOpen) return false;
+
+    state_ = State::kFinished;
+    status_code_ = status.Code();
+
+    // 服务端不再读取客户端的消息，已写给客户端的消息保留供其读完
+    directions_[Index(RpcStreamSide::kClient)].queue.clear();
+
+    auto& server_direction = directions_[Index(RpcStreamSide::kServer)];
+    server_direction.half_closed = true;
+    if (server_direction.queue.empty()) notify = server_direction.readable_handle;
+
+    client_done = TakeDoneHandles(RpcStreamSide::kClient);
+    server_done = TakeDoneHandles(RpcStreamSide::kServer);
+  }
+  Notify(notify);
+  NotifyDone(server_done, status.Code());
+  NotifyDone(client_done, status.Code());
+
+  return true;
+}
+
+bool RpcStream::Cancel(aimrt::rpc::Status status) {
+  std::vector<DoneHandle> client_done, server_done;
+  std::shared_ptr<const NotifyHandle> client_notify, server_notify;
+  {
+    std::lock_guard<std::mutex> lck(mutex_);
+    if (state_ != State::kOpen) return false;
+
+    state_ = State::kCancelled;
+    status_code_ = status.Code();
+
+    for (auto& direction : directions_) {
+      direction.queue.clear();
+      direction.half_closed = true;
+    }
+
+    client_notify = directions_[Index(RpcStreamSide::kServer)].readable_handle;
+    server_notify = directions_[Index(RpcStreamSide::kClient)].readable_handle;
+
+    client_done = TakeDoneHandles(RpcStreamSide::kClient);
+    server_done = TakeDoneHandles(RpcStreamSide::kServer);
+  }
+  Notify(server_notify);
+  Notify(client_notify);
+  NotifyDone(server_done, status.Code());
+  NotifyDone(client_done, status.Code());
+
+  return true;
+}
+
+bool RpcStream::IsDone() const {
+  std::lock_guard<std::mutex> lck(mutex_);
+  return state_ != State::kOpen;
+}
+
+aimrt::rpc::Status RpcStream::GetStatus() const {
+  std::lock_guard<std::mutex> lck(mutex_);
+  return aimrt::rpc::Status(status_code_);
+}
+
+size_t RpcStream::Pending(RpcStreamSide reader) const {
+  std::lock_guard<std::mutex> lck(mutex_);
+  return directions_[Index(Peer(reader))].queue.size();
+}
+
+std::vector<RpcStream::DoneHandle> RpcStream::TakeDoneHandles(RpcStreamSide side) {
+  std::vector<DoneHandle> handles;
+  handles.swap(done_handles_[Index(side)]);
+  return handles;
+}
+
+void RpcStream::NotifyDone(std::vector<DoneHandle>& handles, uint32_t code) {
+  for (auto& handle : handles) {
+    if (handle) handle(aimrt::rpc::Status(code));
+  }
+}
+
+}  // namespace aimrt::runtime::core::rpc
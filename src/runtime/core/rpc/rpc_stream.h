@@ -0,0 +1,189 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "aimrt_module_cpp_interface/rpc/rpc_status.h"
+
+namespace aimrt::runtime::core::rpc {
+
+/**
+ * @brief 流式RPC模式
+ */
+enum class RpcStreamMode : uint32_t {
+  kServerStream,  ///< 客户端发送一个请求，服务端返回消息流
+  kClientStream,  ///< 客户端发送消息流，服务端返回一个响应
+  kBidiStream,    ///< 双向消息流
+};
+
+/**
+ * @brief 流的一端
+ */
+enum class RpcStreamSide : uint32_t {
+  kClient = 0,
+  kServer = 1,
+};
+
+/**
+ * @brief 流读写操作结果
+ */
+enum class RpcStreamResult : uint32_t {
+  kOk,          ///< 成功
+  kWouldBlock,  ///< 写：流控窗口已满；读：暂无消息
+  kEnd,         ///< 写：本端已半关闭；读：对端已半关闭且消息已读完
+  kClosed,      ///< 流已结束，或当前模式不允许该方向的写入
+};
+
+/**
+ * @brief 带流控的RPC消息流
+ *
+ * 一个流包含客户端->服务端与服务端->客户端两个方向，每个方向最多缓存window_size条
+ * 已写入未读取的消息，窗口满时写入返回kWouldBlock，读端取走消息后通过writable回调
+ * 通知写端继续写入。
+ *
+ * 消息以std::shared_ptr<void>传递：同包内读端拿到的就是写端的对象，没有任何拷贝；
+ * 跨包时由后端通过SetTransform设置转换函数（序列化/反序列化为对端的类型）。
+ * 以wait_establish创建的流在Establish之前写入返回kWouldBlock，后端设置好转换函数后再放行，
+ * 调用方在建流的filter链完成前写入的消息不会跳过转换；窗口打开时同样通过writable回调通知。
+ *
+ * 生命周期：
+ * 1. 任意一端可以调用CloseSend半关闭自己的写方向，对端读完剩余消息后读到kEnd
+ * 2. 服务端调用Finish以最终状态结束流，客户端仍可读完已缓存的消息
+ * 3. 任意一端或框架调用Cancel立即结束流并丢弃所有缓存的消息
+ * 流结束时两端的done回调各被调用一次。流必须以Finish或Cancel结束。
+ *
+ * 所有回调都在锁外调用，回调中可以继续读写该流。
+ */
+class RpcStream {
+ public:
+  using MsgPtr = std::shared_ptr<void>;
+  using MsgTransform = std::function<bool(const MsgPtr&, MsgPtr&)>;
+  using NotifyHandle = std::function<void()>;
+  using DoneHandle = std::function<void(aimrt::rpc::Status)>;
+
+  struct Options {
+    RpcStreamMode mode = RpcStreamMode::kBidiStream;
+    uint32_t window_size = 16;  ///< 每个方向上已写入未读取的最大消息数
+    bool wait_establish = false;  ///< 为true时写入在Establish之前返回kWouldBlock
+  };
+
+ public:
+  RpcStream(uint64_t id, const Options& options);
+  ~RpcStream() = default;
+
+  RpcStream(const RpcStream&) = delete;
+  RpcStream& operator=(const RpcStream&) = delete;
+
+  uint64_t Id() const { return id_; }
+  RpcStreamMode Mode() const { return options_.mode; }
+  uint32_t WindowSize() const { return options_.window_size; }
+
+  /**
+   * @brief 设置写入方向上的消息转换函数，转换失败时流以序列化错误取消
+   * @note 应在Establish之前调用，之后的写入才保证经过转换
+   */
+  void SetTransform(RpcStreamSide writer, MsgTransform&& transform);
+
+  /**
+   * @brief 放行写入，通知因未建立而被阻塞的写端，重复调用无效果
+   */
+  void Establish();
+
+  /**
+   * @brief 设置读端的可读回调
+   * @details 对端写入使缓存由空变为非空、对端半关闭或流结束时调用。
+   * 设置时已有可读消息则立即调用一次。
+   */
+  void SetReadableHandle(RpcStreamSide reader, NotifyHandle&& handle);
+
+  /**
+   * @brief 设置写端的可写回调，写入因窗口已满返回kWouldBlock后，窗口重新打开时调用
+   */
+  void SetWritableHandle(RpcStreamSide writer, NotifyHandle&& handle);
+
+  /**
+   * @brief 添加流结束回调，流已结束时立即调用
+   */
+  void AddDoneHandle(RpcStreamSide side, DoneHandle&& handle);
+
+  RpcStreamResult Write(RpcStreamSide writer, MsgPtr msg);
+  RpcStreamResult Read(RpcStreamSide reader, MsgPtr& msg);
+
+  /**
+   * @brief 半关闭写方向
+   * @return 流未结束且该方向尚未关闭时返回true
+   */
+  bool CloseSend(RpcStreamSide writer);
+
+  /**
+   * @brief 服务端以最终状态结束流
+   * @return 流未结束时返回true
+   */
+  bool Finish(aimrt::rpc::Status status);
+
+  /**
+   * @brief 立即结束流并丢弃缓存的消息
+   * @return 流未结束时返回true
+   */
+  bool Cancel(aimrt::rpc::Status status);
+
+  bool IsDone() const;
+  aimrt::rpc::Status GetStatus() const;
+
+  /**
+   * @brief 读端当前可读取的消息数
+   */
+  size_t Pending(RpcStreamSide reader) const;
+
+ private:
+  enum class State : uint32_t {
+    kOpen,
+    kFinished,
+    kCancelled,
+  };
+
+  // 以写入端区分的单个方向
+  struct Direction {
+    std::deque<MsgPtr> queue;
+    bool half_closed = false;
+    bool writer_blocked = false;
+    uint32_t written = 0;
+    std::shared_ptr<const MsgTransform> transform;
+    std::shared_ptr<const NotifyHandle> readable_handle;
+    std::shared_ptr<const NotifyHandle> writable_handle;
+  };
+
+  static constexpr size_t Index(RpcStreamSide side) { return static_cast<size_t>(side); }
+  static constexpr RpcStreamSide Peer(RpcStreamSide side) {
+    return side == RpcStreamSide::kClient ? RpcStreamSide::kServer : RpcStreamSide::kClient;
+  }
+
+  bool WriteAllowed(RpcStreamSide writer) const;
+  RpcStreamResult CheckWritable(RpcStreamSide writer);
+  std::vector<DoneHandle> TakeDoneHandles(RpcStreamSide side);
+
+  static void Notify(const std::shared_ptr<const NotifyHandle>& handle) {
+    if (handle && *handle) (*handle)();
+  }
+  static void NotifyDone(std::vector<DoneHandle>& handles, uint32_t code);
+
+ private:
+  const uint64_t id_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  State state_ = State::kOpen;
+  uint32_t status_code_ = 0;
+  bool established_;
+
+  Direction directions_[2];
+  std::vector<DoneHandle> done_handles_[2];
+};
+
+}  // namespace aimrt::runtime::core::rpc
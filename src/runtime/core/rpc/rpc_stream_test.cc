@@ -0,0 +1,222 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+#include "core/rpc/rpc_stream.h"
+
+namespace aimrt::runtime::core::rpc {
+
+TEST(RPC_STREAM_TEST, bidi_zero_copy) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kBidiStream, .window_size = 4});
+
+  auto req = std::make_shared<std::string>("req");
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, req), RpcStreamResult::kOk);
+
+  RpcStream::MsgPtr msg;
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(msg.get(), req.get());
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kWouldBlock);
+
+  auto rsp = std::make_shared<std::string>("rsp");
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, rsp), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Read(RpcStreamSide::kClient, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(*std::static_pointer_cast<std::string>(msg), "rsp");
+
+  EXPECT_TRUE(stream.Finish(aimrt::rpc::Status()));
+  EXPECT_FALSE(stream.Finish(aimrt::rpc::Status()));
+}
+
+TEST(RPC_STREAM_TEST, flow_control_stall) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kBidiStream, .window_size = 2});
+
+  uint32_t writable_count = 0;
+  stream.SetWritableHandle(RpcStreamSide::kClient, [&writable_count]() { ++writable_count; });
+
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(1)), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(2)), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(3)), RpcStreamResult::kWouldBlock);
+  EXPECT_EQ(stream.Pending(RpcStreamSide::kServer), 2);
+  EXPECT_EQ(writable_count, 0);
+
+  // 读走一条消息后窗口重新打开，写端收到一次通知
+  RpcStream::MsgPtr msg;
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(*std::static_pointer_cast<int>(msg), 1);
+  EXPECT_EQ(writable_count, 1);
+
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(writable_count, 1);
+
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(3)), RpcStreamResult::kOk);
+
+  stream.Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT));
+}
+
+TEST(RPC_STREAM_TEST, flow_control_threads) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kClientStream, .window_size = 3});
+
+  constexpr int kMsgNum = 10000;
+  std::thread writer([&stream]() {
+    for (int ii = 0; ii < kMsgNum;) {
+      auto ret = stream.Write(RpcStreamSide::kClient, std::make_shared<int>(ii));
+      if (ret == RpcStreamResult::kOk) {
+        ++ii;
+      } else {
+        ASSERT_EQ(ret, RpcStreamResult::kWouldBlock);
+        std::this_thread::yield();
+      }
+    }
+    stream.CloseSend(RpcStreamSide::kClient);
+  });
+
+  int expected = 0;
+  RpcStream::MsgPtr msg;
+  while (true) {
+    auto ret = stream.Read(RpcStreamSide::kServer, msg);
+    if (ret == RpcStreamResult::kEnd) break;
+    if (ret == RpcStreamResult::kWouldBlock) {
+      EXPECT_LE(stream.Pending(RpcStreamSide::kServer), 3);
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(ret, RpcStreamResult::kOk);
+    EXPECT_EQ(*std::static_pointer_cast<int>(msg), expected++);
+  }
+  writer.join();
+  EXPECT_EQ(expected, kMsgNum);
+
+  // 客户端流模式下服务端只能返回一个响应
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, std::make_shared<int>(0)), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, std::make_shared<int>(0)), RpcStreamResult::kClosed);
+  EXPECT_TRUE(stream.Finish(aimrt::rpc::Status()));
+}
+
+TEST(RPC_STREAM_TEST, half_close) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kBidiStream, .window_size = 4});
+
+  uint32_t readable_count = 0;
+  stream.SetReadableHandle(RpcStreamSide::kServer, [&readable_count]() { ++readable_count; });
+
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(1)), RpcStreamResult::kOk);
+  EXPECT_EQ(readable_count, 1);
+  EXPECT_TRUE(stream.CloseSend(RpcStreamSide::kClient));
+  EXPECT_FALSE(stream.CloseSend(RpcStreamSide::kClient));
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(2)), RpcStreamResult::kEnd);
+
+  // 服务端先读完剩余消息再读到kEnd
+  RpcStream::MsgPtr msg;
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kEnd);
+
+  // 客户端半关闭后服务端仍可继续写
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, std::make_shared<int>(3)), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, std::make_shared<int>(4)), RpcStreamResult::kOk);
+
+  aimrt::rpc::Status client_status(AIMRT_RPC_STATUS_TIMEOUT);
+  stream.AddDoneHandle(RpcStreamSide::kClient, [&client_status](aimrt::rpc::Status status) { client_status = status; });
+  EXPECT_TRUE(stream.Finish(aimrt::rpc::Status()));
+  EXPECT_TRUE(client_status.OK());
+
+  // Finish后客户端仍可读完已缓存的消息
+  EXPECT_EQ(stream.Read(RpcStreamSide::kClient, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(*std::static_pointer_cast<int>(msg), 3);
+  EXPECT_EQ(stream.Read(RpcStreamSide::kClient, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(stream.Read(RpcStreamSide::kClient, msg), RpcStreamResult::kEnd);
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kClosed);
+}
+
+TEST(RPC_STREAM_TEST, cancel) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kServerStream, .window_size = 4});
+
+  // 服务端流模式下客户端不能写
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(1)), RpcStreamResult::kClosed);
+  RpcStream::MsgPtr msg;
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kEnd);
+
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, std::make_shared<int>(1)), RpcStreamResult::kOk);
+
+  uint32_t client_done_count = 0, server_done_count = 0;
+  uint32_t server_code = 0;
+  stream.AddDoneHandle(RpcStreamSide::kClient, [&](aimrt::rpc::Status) { ++client_done_count; });
+  stream.AddDoneHandle(RpcStreamSide::kServer, [&](aimrt::rpc::Status status) {
+    ++server_done_count;
+    server_code = status.Code();
+  });
+
+  EXPECT_TRUE(stream.Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT)));
+  EXPECT_FALSE(stream.Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT)));
+  EXPECT_FALSE(stream.Finish(aimrt::rpc::Status()));
+  EXPECT_TRUE(stream.IsDone());
+
+  EXPECT_EQ(client_done_count, 1);
+  EXPECT_EQ(server_done_count, 1);
+  EXPECT_EQ(server_code, AIMRT_RPC_STATUS_TIMEOUT);
+  EXPECT_EQ(stream.GetStatus().Code(), AIMRT_RPC_STATUS_TIMEOUT);
+
+  // 取消后缓存的消息被丢弃，读写都返回kClosed
+  EXPECT_EQ(stream.Read(RpcStreamSide::kClient, msg), RpcStreamResult::kClosed);
+  EXPECT_EQ(stream.Write(RpcStreamSide::kServer, std::make_shared<int>(2)), RpcStreamResult::kClosed);
+
+  // 结束后添加的done回调立即调用
+  stream.AddDoneHandle(RpcStreamSide::kClient, [&](aimrt::rpc::Status) { ++client_done_count; });
+  EXPECT_EQ(client_done_count, 2);
+}
+
+TEST(RPC_STREAM_TEST, transform) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kBidiStream, .window_size = 4});
+
+  stream.SetTransform(
+      RpcStreamSide::kClient,
+      [](const RpcStream::MsgPtr& in, RpcStream::MsgPtr& out) -> bool {
+        int value = *std::static_pointer_cast<int>(in);
+        if (value < 0) return false;
+        out = std::make_shared<std::string>(std::to_string(value));
+        return true;
+      });
+
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(42)), RpcStreamResult::kOk);
+
+  RpcStream::MsgPtr msg;
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(*std::static_pointer_cast<std::string>(msg), "42");
+
+  // 转换失败时流以序列化错误取消
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(-1)), RpcStreamResult::kClosed);
+  EXPECT_TRUE(stream.IsDone());
+  EXPECT_EQ(stream.GetStatus().Code(), AIMRT_RPC_STATUS_CLI_SERIALIZATION_FAILED);
+}
+
+TEST(RPC_STREAM_TEST, wait_establish) {
+  RpcStream stream(1, RpcStream::Options{.mode = RpcStreamMode::kBidiStream, .window_size = 4, .wait_establish = true});
+
+  uint32_t writable_count = 0;
+  stream.SetWritableHandle(RpcStreamSide::kClient, [&writable_count]() { ++writable_count; });
+
+  // 后端设置转换函数之前的写入被挡住，不会跳过转换
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(42)), RpcStreamResult::kWouldBlock);
+  EXPECT_EQ(stream.Pending(RpcStreamSide::kServer), 0);
+
+  stream.SetTransform(
+      RpcStreamSide::kClient,
+      [](const RpcStream::MsgPtr& in, RpcStream::MsgPtr& out) -> bool {
+        out = std::make_shared<std::string>(std::to_string(*std::static_pointer_cast<int>(in)));
+        return true;
+      });
+  stream.Establish();
+  stream.Establish();
+  EXPECT_EQ(writable_count, 1);
+
+  EXPECT_EQ(stream.Write(RpcStreamSide::kClient, std::make_shared<int>(42)), RpcStreamResult::kOk);
+
+  RpcStream::MsgPtr msg;
+  EXPECT_EQ(stream.Read(RpcStreamSide::kServer, msg), RpcStreamResult::kOk);
+  EXPECT_EQ(*std::static_pointer_cast<std::string>(msg), "42");
+
+  stream.Cancel(aimrt::rpc::Status(AIMRT_RPC_STATUS_TIMEOUT));
+}
+
+}  // namespace aimrt::runtime::core::rpc
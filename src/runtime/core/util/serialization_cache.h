@@ -0,0 +1,328 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "aimrt_module_cpp_interface/util/buffer.h"
+#include "util/macros.h"
+#include "util/string_interner.h"
+#include "util/sync_primitives.h"
+
+namespace aimrt::runtime::core::util {
+
+/**
+ * @brief 消息序列化结果缓存，按序列化类型保存一份序列化结果，供多个后端共享
+ * @note
+ * 1. 序列化类型在进程级注册表中无锁地驻留为从0开始的小整数下标，缓存是以下标直接索引的定长数组，
+ *    热点路径可预先取得下标并使用*ByIndex接口，完全跳过字符串
+ * 2. 每个槽位只序列化一次：多个后端并发请求同一类型时，只有一个执行序列化，其余等待并共享结果；
+ *    等待方短暂自旋后在事件计数上休眠，大消息序列化期间不占用CPU
+ * 3. 序列化失败(抛异常或返回空)不缓存，槽位恢复为空，之后的请求可以重试
+ * 4. 下标超出定长数组的少见类型放在加锁的溢出表中
+ * 5. 拷贝得到的是当时已完成条目的快照；移动转移已完成的条目，移动时不能有并发访问
+ */
+class SerializationCache {
+ public:
+  using ValuePtr = std::shared_ptr<aimrt::util::BufferArrayView>;
+
+  static constexpr uint32_t kSlotNum = 8;
+  static constexpr uint32_t kInvalidTypeIndex = UINT32_MAX;
+
+  /**
+   * @brief 序列化类型对应的下标，进程内稳定，类型首次出现时驻留
+   */
+  static uint32_t TypeIndex(std::string_view serialization_type) {
+    return TypeRegistry().Intern(serialization_type) - 1;
+  }
+
+  /**
+   * @brief 查找序列化类型对应的下标，不驻留
+   * @note 序列化类型可能来自对端，查找不能让驻留表无限增长
+   *
+   * @return uint32_t 类型从未驻留过时返回kInvalidTypeIndex
+   */
+  static uint32_t FindTypeIndex(std::string_view serialization_type) {
+    const common::util::SymbolId id = TypeRegistry().Find(serialization_type);
+    return (id == common::util::kInvalidSymbolId) ? kInvalidTypeIndex : id - 1;
+  }
+
+  static std::string_view TypeName(uint32_t type_index) {
+    return TypeRegistry().Lookup(type_index + 1);
+  }
+
+  SerializationCache() = default;
+  ~SerializationCache() = default;
+
+  SerializationCache(const SerializationCache& other) { CopyFrom(other); }
+  SerializationCache& operator=(const SerializationCache& other) {
+    if (this != &other) {
+      Clear();
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  SerializationCache(SerializationCache&& other) { MoveFrom(other); }
+  SerializationCache& operator=(SerializationCache&& other) {
+    if (this != &other) {
+      Clear();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief 查找已完成的序列化结果
+   *
+   * @return ValuePtr 不存在或正在序列化时返回空
+   */
+  ValuePtr Find(std::string_view serialization_type) const {
+    // 从未驻留过的类型不可能有缓存的结果
+    const uint32_t type_index = FindTypeIndex(serialization_type);
+    if (type_index == kInvalidTypeIndex) return {};
+    return FindByIndex(type_index);
+  }
+
+  ValuePtr FindByIndex(uint32_t type_index) const {
+    if (omnirt_likely(type_index < kSlotNum)) {
+      const Slot& slot = slots_[type_index];
+      if (slot.state.load(std::memory_order_acquire) == kReady) return slot.value;
+      return {};
+    }
+
+    if (overflow_num_.load(std::memory_order_acquire) == 0) return {};
+    std::lock_guard<std::mutex> lck(overflow_mutex_);
+    for (const auto& item : overflow_) {
+      if (item.first == type_index) return item.second;
+    }
+    return {};
+  }
+
+  /**
+   * @brief 放入已有的序列化结果
+   *
+   * @return bool 该类型已有结果或正在序列化时返回false，不覆盖
+   */
+  bool Emplace(std::string_view serialization_type, ValuePtr value) {
+    if (!value) return false;
+    return EmplaceByIndex(TypeIndex(serialization_type), std::move(value));
+  }
+
+  bool EmplaceByIndex(uint32_t type_index, ValuePtr value) {
+    if (!value) return false;
+
+    if (omnirt_likely(type_index < kSlotNum)) {
+      Slot& slot = slots_[type_index];
+      uint32_t expected = kEmpty;
+      if (!slot.state.compare_exchange_strong(expected, kBusy, std::memory_order_acquire)) return false;
+      slot.value = std::move(value);
+      SetSlotState(slot, kReady);
+      return true;
+    }
+
+    return EmplaceOverflow(type_index, std::move(value)) == nullptr;
+  }
+
+  /**
+   * @brief 获取序列化结果，不存在时调用create生成，同一类型并发调用时create只执行一次
+   * @note create中不能再对同一缓存的同一类型调用GetOrCreate
+   *
+   * @param create 返回ValuePtr的可调用对象，可抛异常，异常原样抛出
+   * @return ValuePtr create返回空时返回空且不缓存
+   */
+  template <typename F>
+  ValuePtr GetOrCreate(std::string_view serialization_type, F&& create) {
+    return GetOrCreateByIndex(TypeIndex(serialization_type), std::forward<F>(create));
+  }
+
+  template <typename F>
+  ValuePtr GetOrCreateByIndex(uint32_t type_index, F&& create) {
+    if (omnirt_unlikely(type_index >= kSlotNum)) {
+      // 溢出表不持锁序列化，少见类型并发时可能重复序列化，只保留先完成的结果
+      if (ValuePtr value = FindByIndex(type_index)) return value;
+      ValuePtr value = create();
+      if (!value) return value;
+      ValuePtr existing = EmplaceOverflow(type_index, value);
+      return existing ? existing : value;
+    }
+
+    Slot& slot = slots_[type_index];
+    uint32_t state = slot.state.load(std::memory_order_acquire);
+    while (true) {
+      if (omnirt_likely(state == kReady)) return slot.value;
+
+      if (state == kEmpty) {
+        if (!slot.state.compare_exchange_weak(state, kBusy, std::memory_order_acquire, std::memory_order_acquire))
+          continue;
+
+        ValuePtr value;
+        try {
+          value = create();
+        } catch (...) {
+          SetSlotState(slot, kEmpty);
+          throw;
+        }
+
+        if (!value) {
+          SetSlotState(slot, kEmpty);
+          return value;
+        }
+
+        slot.value = std::move(value);
+        SetSlotState(slot, kReady);
+        return slot.value;
+      }
+
+      // 其它后端正在序列化，小消息一般在微秒级完成，先短暂自旋
+      if (common::util::sync_detail::SpinFor([&slot, &state] {
+            return (state = slot.state.load(std::memory_order_acquire)) != kBusy;
+          })) {
+        continue;
+      }
+
+      const auto key = slot_event_.PrepareWait();
+      state = slot.state.load(std::memory_order_acquire);
+      if (state != kBusy) {
+        slot_event_.CancelWait();
+        continue;
+      }
+      slot_event_.Wait(key);
+      state = slot.state.load(std::memory_order_acquire);
+    }
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  /**
+   * @brief 已完成的条目个数
+   */
+  size_t Size() const {
+    size_t size = 0;
+    for (const Slot& slot : slots_) {
+      if (slot.state.load(std::memory_order_acquire) == kReady) ++size;
+    }
+    return size + overflow_num_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 遍历已完成的条目
+   *
+   * @param f 形如void(std::string_view serialization_type, const ValuePtr& value)
+   */
+  template <typename F>
+  void ForEach(F&& f) const {
+    for (uint32_t ii = 0; ii < kSlotNum; ++ii) {
+      const Slot& slot = slots_[ii];
+      if (slot.state.load(std::memory_order_acquire) == kReady) f(TypeName(ii), slot.value);
+    }
+
+    if (overflow_num_.load(std::memory_order_acquire) == 0) return;
+    std::vector<std::pair<uint32_t, ValuePtr>> overflow;
+    {
+      std::lock_guard<std::mutex> lck(overflow_mutex_);
+      overflow = overflow_;
+    }
+    for (const auto& item : overflow) f(TypeName(item.first), item.second);
+  }
+
+  /**
+   * @brief 清空，调用时不能有并发访问
+   */
+  void Clear() {
+    for (Slot& slot : slots_) {
+      slot.value.reset();
+      slot.state.store(kEmpty, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lck(overflow_mutex_);
+    overflow_.clear();
+    overflow_num_.store(0, std::memory_order_release);
+  }
+
+ private:
+  enum : uint32_t {
+    kEmpty = 0,
+    kBusy = 1,
+    kReady = 2,
+  };
+
+  struct Slot {
+    std::atomic<uint32_t> state{kEmpty};
+    ValuePtr value;
+  };
+
+  /**
+   * @brief 结束槽位的Busy状态，唤醒等待该缓存的后端，没有等待者时不进入内核
+   */
+  void SetSlotState(Slot& slot, uint32_t state) {
+    slot.state.store(state, std::memory_order_release);
+    slot_event_.NotifyAll();
+  }
+
+  // 序列化类型很少，使用独立的驻留表保证下标从0开始连续
+  static common::util::StringInterner& TypeRegistry() {
+    static common::util::StringInterner* const registry = new common::util::StringInterner(16);
+    return *registry;
+  }
+
+  void CopyFrom(const SerializationCache& other) {
+    for (uint32_t ii = 0; ii < kSlotNum; ++ii) {
+      const Slot& from = other.slots_[ii];
+      if (from.state.load(std::memory_order_acquire) == kReady) {
+        slots_[ii].value = from.value;
+        slots_[ii].state.store(kReady, std::memory_order_release);
+      }
+    }
+    if (other.overflow_num_.load(std::memory_order_acquire) == 0) return;
+    std::lock_guard<std::mutex> lck(other.overflow_mutex_);
+    overflow_ = other.overflow_;
+    overflow_num_.store(static_cast<uint32_t>(overflow_.size()), std::memory_order_release);
+  }
+
+  void MoveFrom(SerializationCache& other) {
+    for (uint32_t ii = 0; ii < kSlotNum; ++ii) {
+      Slot& from = other.slots_[ii];
+      if (from.state.load(std::memory_order_acquire) == kReady) {
+        slots_[ii].value = std::move(from.value);
+        slots_[ii].state.store(kReady, std::memory_order_release);
+        from.state.store(kEmpty, std::memory_order_relaxed);
+      }
+    }
+    if (other.overflow_num_.load(std::memory_order_acquire) == 0) return;
+    std::lock_guard<std::mutex> lck(other.overflow_mutex_);
+    overflow_ = std::move(other.overflow_);
+    other.overflow_.clear();
+    other.overflow_num_.store(0, std::memory_order_release);
+    overflow_num_.store(static_cast<uint32_t>(overflow_.size()), std::memory_order_release);
+  }
+
+  /**
+   * @brief 放入溢出表，已存在时返回已有结果
+   */
+  ValuePtr EmplaceOverflow(uint32_t type_index, ValuePtr value) {
+    std::lock_guard<std::mutex> lck(overflow_mutex_);
+    for (const auto& item : overflow_) {
+      if (item.first == type_index) return item.second;
+    }
+    overflow_.emplace_back(type_index, std::move(value));
+    overflow_num_.store(static_cast<uint32_t>(overflow_.size()), std::memory_order_release);
+    return {};
+  }
+
+  Slot slots_[kSlotNum];
+
+  // 所有槽位共用，被唤醒的等待方重新检查自己的槽位
+  common::util::EventCount slot_event_;
+
+  std::atomic<uint32_t> overflow_num_{0};
+  mutable std::mutex overflow_mutex_;
+  std::vector<std::pair<uint32_t, ValuePtr>> overflow_;
+};
+
+}  // namespace aimrt::runtime::core::util
@@ -0,0 +1,191 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/util/serialization_cache.h"
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aimrt::runtime::core::util {
+
+namespace {
+
+SerializationCache::ValuePtr MakeValue(const std::string& data) {
+  auto shared_buffer = aimrt::util::SharedBuffer::Copy(data.data(), data.size());
+  return std::make_shared<aimrt::util::BufferArrayView>(std::move(shared_buffer));
+}
+
+}  // namespace
+
+TEST(SerializationCacheTest, TypeIndex) {
+  uint32_t pb_index = SerializationCache::TypeIndex("pb");
+  uint32_t json_index = SerializationCache::TypeIndex("json");
+  EXPECT_NE(pb_index, json_index);
+  EXPECT_EQ(SerializationCache::TypeIndex(std::string("pb")), pb_index);
+  EXPECT_EQ(SerializationCache::TypeName(json_index), "json");
+}
+
+TEST(SerializationCacheTest, FindNotIntern) {
+  SerializationCache cache;
+
+  // 查找未出现过的类型不驻留
+  EXPECT_FALSE(cache.Find("never_used_type"));
+  EXPECT_EQ(SerializationCache::FindTypeIndex("never_used_type"), SerializationCache::kInvalidTypeIndex);
+
+  const uint32_t index = SerializationCache::TypeIndex("never_used_type");
+  EXPECT_EQ(SerializationCache::FindTypeIndex("never_used_type"), index);
+}
+
+TEST(SerializationCacheTest, EmplaceFindCopy) {
+  SerializationCache cache;
+  EXPECT_TRUE(cache.Empty());
+  EXPECT_FALSE(cache.Find("pb"));
+
+  auto value = MakeValue("pb data");
+  EXPECT_TRUE(cache.Emplace("pb", value));
+  EXPECT_FALSE(cache.Emplace("pb", MakeValue("other")));
+  EXPECT_EQ(cache.Find("pb"), value);
+  EXPECT_EQ(cache.FindByIndex(SerializationCache::TypeIndex("pb")), value);
+  EXPECT_EQ(cache.Size(), 1);
+
+  SerializationCache copy(cache);
+  EXPECT_EQ(copy.Find("pb"), value);
+  EXPECT_TRUE(copy.Emplace("json", MakeValue("{}")));
+  EXPECT_EQ(copy.Size(), 2);
+  EXPECT_EQ(cache.Size(), 1);
+
+  std::vector<std::string> types;
+  copy.ForEach([&](std::string_view type, const SerializationCache::ValuePtr& ptr) {
+    types.emplace_back(type);
+    EXPECT_TRUE(ptr);
+  });
+  EXPECT_EQ(types.size(), 2);
+
+  SerializationCache moved(std::move(copy));
+  EXPECT_EQ(moved.Size(), 2);
+  EXPECT_EQ(moved.Find("pb"), value);
+  EXPECT_TRUE(copy.Empty());
+  EXPECT_TRUE(copy.EmplaceByIndex(SerializationCache::TypeIndex("pb"), MakeValue("pb data")));
+  EXPECT_EQ(copy.Size(), 1);
+}
+
+TEST(SerializationCacheTest, CreateFailed) {
+  SerializationCache cache;
+
+  EXPECT_THROW(cache.GetOrCreate("pb", []() -> SerializationCache::ValuePtr {
+    throw std::runtime_error("serialize failed");
+  }),
+               std::runtime_error);
+  EXPECT_FALSE(cache.GetOrCreate("pb", []() { return SerializationCache::ValuePtr(); }));
+  EXPECT_TRUE(cache.Empty());
+
+  // 失败不缓存，之后可以重试
+  auto value = cache.GetOrCreate("pb", []() { return MakeValue("retry"); });
+  ASSERT_TRUE(value);
+  EXPECT_EQ(cache.Find("pb"), value);
+}
+
+TEST(SerializationCacheTest, Overflow) {
+  SerializationCache cache;
+  std::vector<std::string> types;
+  for (uint32_t ii = 0; ii < SerializationCache::kSlotNum + 4; ++ii)
+    types.emplace_back("overflow_test_type_" + std::to_string(ii));
+
+  for (const auto& type : types) {
+    auto value = cache.GetOrCreate(type, [&]() { return MakeValue(type); });
+    EXPECT_EQ(cache.GetOrCreate(type, []() { return MakeValue("unused"); }), value);
+  }
+  EXPECT_EQ(cache.Size(), types.size());
+
+  SerializationCache copy = cache;
+  for (const auto& type : types) {
+    ASSERT_TRUE(copy.Find(type));
+    EXPECT_EQ(copy.Find(type)->JoinToString(), type);
+  }
+}
+
+TEST(SerializationCacheTest, ConcurrentBackends) {
+  constexpr int kBackendNum = 8;
+  constexpr int kMsgNum = 200;
+  const std::vector<std::string> kTypes = {"pb", "json"};
+
+  for (int msg = 0; msg < kMsgNum; ++msg) {
+    // 模拟多个后端并行发布同一条消息，每种序列化类型只应序列化一次
+    SerializationCache cache;
+    std::atomic<uint32_t> serialize_count[2] = {0, 0};
+    std::atomic<bool> start_flag = false;
+    std::vector<SerializationCache::ValuePtr> results(kBackendNum * kTypes.size());
+
+    std::vector<std::thread> backends;
+    for (int backend = 0; backend < kBackendNum; ++backend) {
+      backends.emplace_back([&, backend]() {
+        while (!start_flag.load()) std::this_thread::yield();
+
+        for (size_t ii = 0; ii < kTypes.size(); ++ii) {
+          const size_t type_idx = (backend + ii) % kTypes.size();
+          results[backend * kTypes.size() + type_idx] = cache.GetOrCreate(kTypes[type_idx], [&]() {
+            serialize_count[type_idx].fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            return MakeValue(kTypes[type_idx]);
+          });
+        }
+      });
+    }
+
+    start_flag.store(true);
+    for (auto& t : backends) t.join();
+
+    for (size_t ii = 0; ii < kTypes.size(); ++ii) {
+      ASSERT_EQ(serialize_count[ii].load(), 1);
+      auto expect = cache.Find(kTypes[ii]);
+      ASSERT_TRUE(expect);
+      for (int backend = 0; backend < kBackendNum; ++backend)
+        ASSERT_EQ(results[backend * kTypes.size() + ii], expect);
+    }
+  }
+}
+
+TEST(SerializationCacheTest, WaitersBlockOnSlowCreate) {
+  constexpr int kWaiterNum = 4;
+  constexpr auto kCreateTime = std::chrono::milliseconds(200);
+
+  SerializationCache cache;
+  std::atomic<bool> creating = false;
+
+  const std::clock_t begin_cpu = std::clock();
+
+  std::thread creator([&]() {
+    cache.GetOrCreate("pb", [&]() {
+      creating.store(true);
+      std::this_thread::sleep_for(kCreateTime);
+      return MakeValue("slow");
+    });
+  });
+  while (!creating.load()) std::this_thread::yield();
+
+  // 序列化很慢时，等待的后端休眠而不是空转
+  std::vector<std::thread> waiters;
+  std::atomic<int> done_num = 0;
+  for (int ii = 0; ii < kWaiterNum; ++ii) {
+    waiters.emplace_back([&]() {
+      auto value = cache.GetOrCreate("pb", []() { return MakeValue("unused"); });
+      if (value && value->JoinToString() == "slow") ++done_num;
+    });
+  }
+
+  creator.join();
+  for (auto& t : waiters) t.join();
+
+  EXPECT_EQ(done_num.load(), kWaiterNum);
+
+  const double cpu_ms = 1000.0 * (std::clock() - begin_cpu) / CLOCKS_PER_SEC;
+  EXPECT_LT(cpu_ms, 100.0);
+}
+
+}  // namespace aimrt::runtime::core::util
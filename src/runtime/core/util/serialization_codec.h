@@ -0,0 +1,301 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aimrt_module_cpp_interface/util/buffer.h"
+#include "aimrt_module_cpp_interface/util/shared_buffer.h"
+#include "aimrt_module_cpp_interface/util/type_support.h"
+#include "util/exception.h"
+#include "util/lz4_codec.h"
+#include "util/macros.h"
+
+namespace aimrt::runtime::core::util {
+
+/**
+ * @brief 压缩算法
+ * @note compress在输出缓冲区不足或失败时返回0；decompress要求解压结果恰好为dst_size
+ */
+struct CompressionCodec {
+  size_t (*compress_bound)(size_t src_size);
+  size_t (*compress)(const char* src, size_t src_size, char* dst, size_t dst_capacity);
+  bool (*decompress)(const char* src, size_t src_size, char* dst, size_t dst_size);
+  size_t max_expand_ratio = 0;  ///< 解压后长度与压缩数据长度之比的上限，0表示不限制
+};
+
+/**
+ * @brief 可组合的压缩序列化类型，形如"pb+lz4"、"json+lz4"，在基础序列化类型之上由框架统一处理，type support无需感知
+ * @note
+ * 1. 编码结果为5字节头(1字节存储方式+4字节小端原始长度)加数据，存储方式为原样存储或压缩
+ * 2. 小于min_compress_size的数据原样存储；大数据先试压缩开头probe_size字节，
+ *    压不动(如已压缩的图像)时原样存储，不白白消耗CPU
+ * 3. 压缩后长度超过原长度的max_ratio时原样存储
+ * 4. 内置lz4，其它压缩算法(如zstd)可通过RegisterCodec注册
+ * 5. 头中的原始长度来自对端，解码时超过max_decode_size或压缩算法的最大解压比时在分配前拒绝
+ */
+class SerializationCodec {
+ public:
+  struct Options {
+    size_t min_compress_size = 1024;  ///< 小于该长度的数据不压缩
+    size_t probe_size = 4096;         ///< 试压缩的长度，0表示不试压缩
+    double max_ratio = 0.9;           ///< 压缩率高于该值时原样存储
+    size_t max_decode_size = 256 * 1024 * 1024;  ///< 解码结果的最大长度
+  };
+
+  static constexpr size_t kHeaderSize = 5;
+
+  static SerializationCodec& Instance() {
+    static SerializationCodec* const instance = new SerializationCodec();
+    return *instance;
+  }
+
+  SerializationCodec(const SerializationCodec&) = delete;
+  SerializationCodec& operator=(const SerializationCodec&) = delete;
+
+  /**
+   * @brief 拆分序列化类型
+   *
+   * @return {基础序列化类型, 压缩算法名}，不是压缩序列化类型时压缩算法名为空
+   */
+  static std::pair<std::string_view, std::string_view> SplitSerializationType(std::string_view serialization_type) {
+    const size_t pos = serialization_type.rfind('+');
+    if (pos == std::string_view::npos) return {serialization_type, {}};
+    return {serialization_type.substr(0, pos), serialization_type.substr(pos + 1)};
+  }
+
+  void SetOptions(const Options& options) {
+    std::unique_lock<std::shared_mutex> lck(mutex_);
+    options_ = options;
+  }
+
+  Options GetOptions() const {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    return options_;
+  }
+
+  void RegisterCodec(std::string_view name, const CompressionCodec& codec) {
+    std::unique_lock<std::shared_mutex> lck(mutex_);
+    codec_map_[std::string(name)] = codec;
+  }
+
+  bool HasCodec(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    return codec_map_.find(std::string(name)) != codec_map_.end();
+  }
+
+  /**
+   * @brief 编码基础序列化结果
+   * @note 压缩算法不存在时抛异常
+   */
+  aimrt::util::SharedBuffer Encode(std::string_view codec_name, aimrt_buffer_array_view_t raw) const {
+    Options options;
+    const CompressionCodec codec = GetCodec(codec_name, &options);
+
+    size_t raw_size = 0;
+    for (size_t ii = 0; ii < raw.len; ++ii) raw_size += raw.data[ii].len;
+
+    AIMRT_ASSERT(raw_size <= UINT32_MAX, "Data is too large to compress, size: {}", raw_size);
+
+    // 压缩需要连续的输入
+    std::string joined;
+    const char* raw_data = nullptr;
+    if (raw.len == 1) {
+      raw_data = static_cast<const char*>(raw.data[0].data);
+    } else if (raw.len > 1) {
+      joined.reserve(raw_size);
+      for (size_t ii = 0; ii < raw.len; ++ii)
+        joined.append(static_cast<const char*>(raw.data[ii].data), raw.data[ii].len);
+      raw_data = joined.data();
+    }
+
+    if (raw_size >= options.min_compress_size && Compressible(codec, options, raw_data, raw_size)) {
+      thread_local std::vector<char> compress_buf;
+      compress_buf.resize(codec.compress_bound(raw_size));
+
+      const size_t compressed_size = codec.compress(raw_data, raw_size, compress_buf.data(), compress_buf.size());
+      if (compressed_size != 0 && compressed_size <= raw_size * options.max_ratio) {
+        auto result = PackFrame(kCompressed, raw_size, compress_buf.data(), compressed_size);
+        // 大消息压缩后不保留大的线程缓冲区
+        if (compress_buf.capacity() > kMaxRetainedBufSize) std::vector<char>().swap(compress_buf);
+        return result;
+      }
+
+      if (compress_buf.capacity() > kMaxRetainedBufSize) std::vector<char>().swap(compress_buf);
+    }
+
+    return PackFrame(kStored, raw_size, raw_data, raw_size);
+  }
+
+  /**
+   * @brief 原样存储的连续数据直接返回其中的基础序列化结果，不拷贝
+   *
+   * @return bool 数据不连续、被压缩或格式不对时返回false
+   */
+  static bool GetStoredPayload(aimrt_buffer_array_view_t data, aimrt_buffer_view_t& payload) {
+    if (data.len != 1 || data.data[0].len < kHeaderSize) return false;
+
+    const char* frame = static_cast<const char*>(data.data[0].data);
+    if (static_cast<uint8_t>(frame[0]) != kStored ||
+        ReadRawSize(frame) != data.data[0].len - kHeaderSize)
+      return false;
+
+    payload = aimrt_buffer_view_t{.data = frame + kHeaderSize, .len = data.data[0].len - kHeaderSize};
+    return true;
+  }
+
+  /**
+   * @brief 解码出基础序列化结果
+   * @note 压缩算法不存在或数据损坏时抛异常
+   */
+  aimrt::util::SharedBuffer Decode(std::string_view codec_name, aimrt_buffer_array_view_t data) const {
+    Options options;
+    const CompressionCodec codec = GetCodec(codec_name, &options);
+
+    aimrt::util::SharedBuffer joined_buffer;
+    std::string_view joined;
+    if (data.len == 1) {
+      joined = std::string_view(static_cast<const char*>(data.data[0].data), data.data[0].len);
+    } else if (data.len > 1) {
+      joined_buffer = aimrt::util::SharedBuffer::Copy(data);
+      joined = std::string_view(static_cast<const char*>(joined_buffer.Data()), joined_buffer.Size());
+    }
+
+    AIMRT_ASSERT(joined.size() >= kHeaderSize, "Invalid compressed data, size: {}", joined.size());
+
+    const uint8_t method = static_cast<uint8_t>(joined[0]);
+    const size_t raw_size = ReadRawSize(joined.data());
+    const std::string_view payload = joined.substr(kHeaderSize);
+
+    if (method == kStored) {
+      AIMRT_ASSERT(payload.size() == raw_size, "Invalid stored data, size mismatch.");
+      return aimrt::util::SharedBuffer::Copy(payload.data(), payload.size());
+    }
+
+    AIMRT_ASSERT(method == kCompressed, "Invalid compressed data, unknown method {}", method);
+
+    // 原始长度不可信，按上限与压缩算法的最大解压比校验后再分配
+    AIMRT_ASSERT(raw_size <= options.max_decode_size,
+                 "Invalid compressed data, raw size {} exceeds limit {}", raw_size, options.max_decode_size);
+    AIMRT_ASSERT(codec.max_expand_ratio == 0 || raw_size <= payload.size() * codec.max_expand_ratio,
+                 "Invalid compressed data, raw size {} is too large for payload size {}", raw_size, payload.size());
+
+    bool decompress_ret = false;
+    auto result = aimrt::util::SharedBuffer::Create(raw_size, [&](void* dst) {
+      decompress_ret = codec.decompress(payload.data(), payload.size(), static_cast<char*>(dst), raw_size);
+    });
+    AIMRT_ASSERT(decompress_ret || raw_size == 0, "Decompress failed, codec: {}", codec_name);
+
+    return result;
+  }
+
+ private:
+  enum : uint8_t {
+    kStored = 0,
+    kCompressed = 1,
+  };
+
+  static constexpr size_t kMaxRetainedBufSize = 1024 * 1024;
+
+  // lz4每个字节最多展开为255字节
+  static constexpr size_t kLz4MaxExpandRatio = 255;
+
+  SerializationCodec() {
+    codec_map_.emplace(
+        "lz4",
+        CompressionCodec{
+            .compress_bound = &aimrt::common::util::Lz4CompressBound,
+            .compress = &aimrt::common::util::Lz4Compress,
+            .decompress = &aimrt::common::util::Lz4Decompress,
+            .max_expand_ratio = kLz4MaxExpandRatio});
+  }
+
+  CompressionCodec GetCodec(std::string_view codec_name, Options* options = nullptr) const {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    auto itr = codec_map_.find(std::string(codec_name));
+    if (omnirt_unlikely(itr == codec_map_.end()))
+      throw aimrt::common::util::AimRTException("Unknown compression codec '" + std::string(codec_name) + "'.");
+
+    if (options != nullptr) *options = options_;
+    return itr->second;
+  }
+
+  /**
+   * @brief 试压缩开头一段数据，判断是否值得压缩
+   */
+  static bool Compressible(const CompressionCodec& codec, const Options& options, const char* data, size_t size) {
+    if (options.probe_size == 0 || size <= options.probe_size * 2) return true;
+
+    thread_local std::vector<char> probe_buf;
+    probe_buf.resize(codec.compress_bound(options.probe_size));
+
+    const size_t compressed_size = codec.compress(data, options.probe_size, probe_buf.data(), probe_buf.size());
+    return compressed_size != 0 && compressed_size <= options.probe_size * options.max_ratio;
+  }
+
+  // 原始长度位于头中偏移1处，未对齐，按字节读写
+  static uint32_t ReadRawSize(const char* frame) {
+    const auto* p = reinterpret_cast<const uint8_t*>(frame + 1);
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  static void WriteRawSize(char* frame, uint32_t raw_size) {
+    auto* p = reinterpret_cast<uint8_t*>(frame + 1);
+    p[0] = static_cast<uint8_t>(raw_size);
+    p[1] = static_cast<uint8_t>(raw_size >> 8);
+    p[2] = static_cast<uint8_t>(raw_size >> 16);
+    p[3] = static_cast<uint8_t>(raw_size >> 24);
+  }
+
+  static aimrt::util::SharedBuffer PackFrame(uint8_t method, size_t raw_size, const char* payload, size_t payload_size) {
+    return aimrt::util::SharedBuffer::Create(kHeaderSize + payload_size, [&](void* dst) {
+      char* pos = static_cast<char*>(dst);
+      pos[0] = static_cast<char>(method);
+      WriteRawSize(pos, static_cast<uint32_t>(raw_size));
+      if (payload_size) memcpy(pos + kHeaderSize, payload, payload_size);
+    });
+  }
+
+  mutable std::shared_mutex mutex_;
+  Options options_;
+  std::unordered_map<std::string, CompressionCodec> codec_map_;
+};
+
+/**
+ * @brief 反序列化，支持压缩序列化类型
+ *
+ * @return bool 失败时返回false，不抛异常
+ */
+inline bool DeserializeWithCodec(
+    const aimrt::util::TypeSupportRef& type_support_ref,
+    std::string_view serialization_type,
+    aimrt_buffer_array_view_t buffer_array_view,
+    void* msg) noexcept {
+  auto [base_type, codec_name] = SerializationCodec::SplitSerializationType(serialization_type);
+  if (codec_name.empty())
+    return type_support_ref.Deserialize(serialization_type, buffer_array_view, msg);
+
+  // 小消息和不可压缩的大消息是原样存储的，直接反序列化，不拷贝
+  aimrt_buffer_view_t payload;
+  if (SerializationCodec::GetStoredPayload(buffer_array_view, payload) &&
+      SerializationCodec::Instance().HasCodec(codec_name))
+    return type_support_ref.Deserialize(base_type, aimrt_buffer_array_view_t{.data = &payload, .len = 1}, msg);
+
+  try {
+    aimrt::util::BufferArrayView raw_view(SerializationCodec::Instance().Decode(codec_name, buffer_array_view));
+    return type_support_ref.Deserialize(base_type, *(raw_view.NativeHandle()), msg);
+  } catch (...) {
+    return false;
+  }
+}
+
+}  // namespace aimrt::runtime::core::util
@@ -0,0 +1,225 @@
+// Copyright (c) 2023, AgiBot Inc.
+// All rights reserved.
+
+#include "core/util/serialization_codec.h"
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace aimrt::runtime::core::util {
+
+namespace {
+
+aimrt::util::SharedBuffer Encode(std::string_view codec_name, const std::string& data) {
+  aimrt::util::BufferArrayView view(data.data(), data.size());
+  return SerializationCodec::Instance().Encode(codec_name, *(view.NativeHandle()));
+}
+
+std::string Decode(std::string_view codec_name, const aimrt::util::SharedBuffer& data) {
+  aimrt::util::BufferArrayView view(data);
+  return aimrt::util::BufferArrayView(SerializationCodec::Instance().Decode(codec_name, *(view.NativeHandle())))
+      .JoinToString();
+}
+
+std::string GenGridMap(size_t size) {
+  std::mt19937 rng(1);
+  std::string data(size, '\0');
+  for (auto& c : data) {
+    if (rng() % 100 == 0) c = static_cast<char>(100);
+  }
+  return data;
+}
+
+std::string GenRandom(size_t size) {
+  std::mt19937 rng(2);
+  std::string data(size, '\0');
+  for (auto& c : data) c = static_cast<char>(rng());
+  return data;
+}
+
+// 以std::string为消息、原样拷贝为"raw"序列化的type support
+const aimrt_type_support_base_t* GetStringTypeSupport() {
+  static const aimrt_type_support_base_t kTs{
+      .type_name = [](void* /*impl*/) -> aimrt_string_view_t { return aimrt::util::ToAimRTStringView("string"); },
+      .create = [](void* /*impl*/) -> void* { return new std::string(); },
+      .destroy = [](void* /*impl*/, void* msg) { delete static_cast<std::string*>(msg); },
+      .copy = [](void* /*impl*/, const void* from, void* to) {
+        *static_cast<std::string*>(to) = *static_cast<const std::string*>(from);
+      },
+      .move = [](void* /*impl*/, void* from, void* to) {
+        *static_cast<std::string*>(to) = std::move(*static_cast<std::string*>(from));
+      },
+      .serialize = [](void* /*impl*/, aimrt_string_view_t /*serialization_type*/, const void* /*msg*/,
+                      const aimrt_buffer_array_allocator_t* /*allocator*/, aimrt_buffer_array_t* /*buffer_array*/) -> bool {
+        return false;
+      },
+      .deserialize = [](void* /*impl*/, aimrt_string_view_t serialization_type,
+                        aimrt_buffer_array_view_t buffer_array_view, void* msg) -> bool {
+        if (aimrt::util::ToStdStringView(serialization_type) != "raw") return false;
+        auto& str = *static_cast<std::string*>(msg);
+        str.clear();
+        for (size_t ii = 0; ii < buffer_array_view.len; ++ii)
+          str.append(static_cast<const char*>(buffer_array_view.data[ii].data), buffer_array_view.data[ii].len);
+        return true;
+      },
+      .serialization_types_supported_num = [](void* /*impl*/) -> size_t { return 0; },
+      .serialization_types_supported_list = [](void* /*impl*/) -> const aimrt_string_view_t* { return nullptr; },
+      .custom_type_support_ptr = [](void* /*impl*/) -> const void* { return nullptr; },
+      .impl = nullptr};
+  return &kTs;
+}
+
+}  // namespace
+
+TEST(SerializationCodecTest, SplitSerializationType) {
+  EXPECT_EQ(SerializationCodec::SplitSerializationType("pb").first, "pb");
+  EXPECT_TRUE(SerializationCodec::SplitSerializationType("pb").second.empty());
+  EXPECT_EQ(SerializationCodec::SplitSerializationType("pb+lz4").first, "pb");
+  EXPECT_EQ(SerializationCodec::SplitSerializationType("pb+lz4").second, "lz4");
+}
+
+TEST(SerializationCodecTest, EncodeDecode) {
+  // 可压缩的大数据被压缩
+  std::string grid_map = GenGridMap(64 * 1024);
+  auto encoded = Encode("lz4", grid_map);
+  EXPECT_LT(encoded.Size(), grid_map.size() / 5);
+  EXPECT_EQ(Decode("lz4", encoded), grid_map);
+
+  // 小数据原样存储
+  std::string small(100, 'a');
+  encoded = Encode("lz4", small);
+  EXPECT_EQ(encoded.Size(), small.size() + SerializationCodec::kHeaderSize);
+  EXPECT_EQ(Decode("lz4", encoded), small);
+
+  // 不可压缩的大数据在试压缩后原样存储
+  std::string random_data = GenRandom(64 * 1024);
+  encoded = Encode("lz4", random_data);
+  EXPECT_EQ(encoded.Size(), random_data.size() + SerializationCodec::kHeaderSize);
+  EXPECT_EQ(Decode("lz4", encoded), random_data);
+
+  // 空数据
+  encoded = Encode("lz4", "");
+  EXPECT_EQ(Decode("lz4", encoded), "");
+
+  // 多段输入
+  std::vector<aimrt_buffer_view_t> views{
+      {.data = grid_map.data(), .len = 1000},
+      {.data = grid_map.data() + 1000, .len = grid_map.size() - 1000}};
+  aimrt::util::BufferArrayView multi_view(views);
+  encoded = SerializationCodec::Instance().Encode("lz4", *(multi_view.NativeHandle()));
+  EXPECT_EQ(Decode("lz4", encoded), grid_map);
+}
+
+TEST(SerializationCodecTest, Invalid) {
+  std::string grid_map = GenGridMap(16 * 1024);
+
+  EXPECT_THROW(Encode("unknown", grid_map), aimrt::common::util::AimRTException);
+
+  auto encoded = Encode("lz4", grid_map);
+  std::string corrupted = aimrt::util::BufferArrayView(encoded).JoinToString();
+  corrupted.resize(corrupted.size() / 2);
+  EXPECT_THROW(Decode("lz4", aimrt::util::SharedBuffer::Copy(corrupted.data(), corrupted.size())),
+               aimrt::common::util::AimRTException);
+  EXPECT_THROW(Decode("lz4", aimrt::util::SharedBuffer::Copy("abc", 3)), aimrt::common::util::AimRTException);
+
+  // 伪造的原始长度在分配前被拒绝：超出lz4的最大解压比
+  const char forged[] = {1, '\xff', '\xff', '\xff', '\xff', 0x10, 'a'};
+  EXPECT_THROW(Decode("lz4", aimrt::util::SharedBuffer::Copy(forged, sizeof(forged))),
+               aimrt::common::util::AimRTException);
+
+  // 超出解码长度上限
+  const auto options = SerializationCodec::Instance().GetOptions();
+  auto limited_options = options;
+  limited_options.max_decode_size = grid_map.size() - 1;
+  SerializationCodec::Instance().SetOptions(limited_options);
+  EXPECT_THROW(Decode("lz4", encoded), aimrt::common::util::AimRTException);
+  SerializationCodec::Instance().SetOptions(options);
+  EXPECT_EQ(Decode("lz4", encoded), grid_map);
+}
+
+TEST(SerializationCodecTest, RegisterCodec) {
+  // 注册一个不压缩的算法，验证扩展点
+  SerializationCodec::Instance().RegisterCodec(
+      "copy",
+      CompressionCodec{
+          .compress_bound = [](size_t src_size) { return src_size; },
+          .compress = [](const char* src, size_t src_size, char* dst, size_t dst_capacity) -> size_t {
+            if (dst_capacity < src_size) return 0;
+            memcpy(dst, src, src_size);
+            return src_size;
+          },
+          .decompress = [](const char* src, size_t src_size, char* dst, size_t dst_size) -> bool {
+            if (src_size != dst_size) return false;
+            memcpy(dst, src, src_size);
+            return true;
+          }});
+  EXPECT_TRUE(SerializationCodec::Instance().HasCodec("copy"));
+
+  std::string grid_map = GenGridMap(16 * 1024);
+  EXPECT_EQ(Decode("copy", Encode("copy", grid_map)), grid_map);
+}
+
+TEST(SerializationCodecTest, DeserializeWithCodec) {
+  aimrt::util::TypeSupportRef type_support_ref(GetStringTypeSupport());
+
+  for (const auto& data : {GenGridMap(64 * 1024), std::string("small msg")}) {
+    auto encoded = Encode("lz4", data);
+    aimrt::util::BufferArrayView view(encoded);
+
+    std::string msg;
+    EXPECT_TRUE(DeserializeWithCodec(type_support_ref, "raw+lz4", *(view.NativeHandle()), &msg));
+    EXPECT_EQ(msg, data);
+
+    EXPECT_FALSE(DeserializeWithCodec(type_support_ref, "pb+lz4", *(view.NativeHandle()), &msg));
+    EXPECT_FALSE(DeserializeWithCodec(type_support_ref, "raw+unknown", *(view.NativeHandle()), &msg));
+  }
+
+  aimrt::util::BufferArrayView raw_view("plain", 5);
+  std::string msg;
+  EXPECT_TRUE(DeserializeWithCodec(type_support_ref, "raw", *(raw_view.NativeHandle()), &msg));
+  EXPECT_EQ(msg, "plain");
+}
+
+TEST(SerializationCodecTest, Benchmark) {
+  constexpr size_t kSize = 4 * 1024 * 1024;
+
+  // 点云：缓慢变化的float坐标
+  std::string point_cloud(kSize, '\0');
+  auto* points = reinterpret_cast<float*>(point_cloud.data());
+  for (size_t ii = 0; ii < kSize / sizeof(float); ++ii) points[ii] = std::round(std::sin(ii * 0.001f) * 100.0f) / 100.0f;
+
+  // json文本
+  std::string json;
+  for (size_t ii = 0; json.size() < kSize; ++ii)
+    json += R"({"id":)" + std::to_string(ii) + R"(,"name":"obstacle","pose":{"x":1.5,"y":-2.25,"z":0.0}},)";
+
+  const std::vector<std::pair<std::string, std::string>> payloads = {
+      {"grid map", GenGridMap(kSize)},
+      {"point cloud", std::move(point_cloud)},
+      {"json", std::move(json)},
+      {"compressed image", GenRandom(kSize)}};
+
+  for (const auto& [name, data] : payloads) {
+    auto begin = std::chrono::steady_clock::now();
+    auto encoded = Encode("lz4", data);
+    const double encode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    begin = std::chrono::steady_clock::now();
+    auto decoded = Decode("lz4", encoded);
+    const double decode_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    ASSERT_EQ(decoded, data);
+
+    const double mb = data.size() / 1024.0 / 1024.0;
+    std::cout << name << ": ratio " << static_cast<double>(encoded.Size()) / data.size()
+              << ", encode " << mb / encode_ms * 1000 << " MB/s"
+              << ", decode " << mb / decode_ms * 1000 << " MB/s" << std::endl;
+  }
+}
+
+}  // namespace aimrt::runtime::core::util